@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <benchmark/benchmark.h>
+#include <butil/iobuf.h>
+
+#include <memory>
+#include <string>
+
+#include "proto/chunk.pb.h"
+#include "src/chunkserver/op_request.h"
+
+namespace curve {
+namespace chunkserver {
+
+namespace {
+
+void PrepareWriteRequest(size_t length, ChunkRequest* request,
+                         butil::IOBuf* data) {
+    request->set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+    request->set_logicpoolid(1);
+    request->set_copysetid(100001);
+    request->set_chunkid(12345);
+    request->set_sn(1);
+    request->set_offset(0);
+    request->set_size(length);
+    data->append(std::string(length, 'a'));
+}
+
+}  // namespace
+
+// Encode the write request into the raft log entry, done by the leader for
+// every write before it's proposed.
+static void BM_ChunkOpRequestEncode(benchmark::State& state) {  // NOLINT
+    const size_t length = state.range(0);
+    ChunkRequest request;
+    butil::IOBuf data;
+    PrepareWriteRequest(length, &request, &data);
+    for (auto _ : state) {
+        butil::IOBuf log;
+        ChunkOpRequest::Encode(&request, &data, &log);
+        benchmark::DoNotOptimize(log.length());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Decode the log entry into the op request, done by every replica when the
+// entry is applied.
+static void BM_ChunkOpRequestDecode(benchmark::State& state) {  // NOLINT
+    const size_t length = state.range(0);
+    ChunkRequest request;
+    butil::IOBuf data;
+    PrepareWriteRequest(length, &request, &data);
+    butil::IOBuf log;
+    ChunkOpRequest::Encode(&request, &data, &log);
+
+    PeerId leaderId;
+    for (auto _ : state) {
+        ChunkRequest decoded;
+        butil::IOBuf decodedData;
+        auto opRequest = ChunkOpRequest::Decode(log, &decoded, &decodedData,
+                                                1, leaderId);
+        benchmark::DoNotOptimize(opRequest.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ChunkOpRequestEncode)->Arg(4 << 10)->Arg(64 << 10)
+    ->Arg(1 << 20);
+BENCHMARK(BM_ChunkOpRequestDecode)->Arg(4 << 10)->Arg(64 << 10)
+    ->Arg(1 << 20);
+
+}  // namespace chunkserver
+}  // namespace curve
+
+BENCHMARK_MAIN();
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <benchmark/benchmark.h>
+#include <butil/iobuf.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "src/client/client_common.h"
+#include "src/client/io_tracker.h"
+#include "src/client/metacache.h"
+#include "src/client/request_context.h"
+#include "src/client/splitor.h"
+
+namespace curve {
+namespace client {
+
+namespace {
+
+constexpr uint64_t kChunkSize = 16ull * 1024 * 1024;
+constexpr uint64_t kSegmentSize = 1024ull * 1024 * 1024;
+// all chunks are in the first segment
+constexpr uint64_t kChunkNum = kSegmentSize / kChunkSize;
+
+class SplitorBench {
+ public:
+    SplitorBench(uint64_t stripeUnit, uint64_t stripeCount)
+        : tracker_(nullptr, &metaCache_, nullptr) {
+        IOSplitOption splitOption;
+        splitOption.fileIOSplitMaxSizeKB = 64;
+        Splitor::Init(splitOption);
+
+        fileInfo_.chunksize = kChunkSize;
+        fileInfo_.segmentsize = kSegmentSize;
+        fileInfo_.stripeUnit = stripeUnit;
+        fileInfo_.stripeCount = stripeCount;
+        metaCache_.UpdateFileInfo(fileInfo_);
+        for (uint64_t i = 0; i < kChunkNum; ++i) {
+            metaCache_.UpdateChunkInfoByIndex(i, ChunkIDInfo(i + 1, 1, 1));
+        }
+        tracker_.SetOpType(OpType::WRITE);
+    }
+
+    void Split(butil::IOBuf* data, off_t offset, size_t length) {
+        int ret = Splitor::IO2ChunkRequests(&tracker_, &metaCache_,
+                                            &requests_, data, offset, length,
+                                            nullptr, &fileInfo_);
+        benchmark::DoNotOptimize(ret);
+    }
+
+    // free the requests and release the segment locks taken by the split,
+    // which are released by the tracker when the io is done in production
+    void Reset(off_t offset, size_t length) {
+        for (auto* request : requests_) {
+            request->UnInit();
+            delete request;
+        }
+        requests_.clear();
+
+        uint64_t unit = fileInfo_.stripeCount > 1 ? fileInfo_.stripeUnit
+                                                  : kChunkSize;
+        uint64_t locks = (offset + length - 1) / unit - offset / unit + 1;
+        FileSegment* segment = metaCache_.GetFileSegment(0);
+        for (uint64_t i = 0; i < locks; ++i) {
+            segment->ReleaseLock();
+        }
+    }
+
+ private:
+    MetaCache metaCache_;
+    FInfo fileInfo_;
+    IOTracker tracker_;
+    std::vector<RequestContext*> requests_;
+};
+
+void RunSplit(benchmark::State& state, SplitorBench* bench) {
+    const size_t length = state.range(0);
+    std::string buf(length, 'a');
+    butil::IOBuf origin;
+    origin.append(buf);
+    std::mt19937_64 rng(0);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        // 4KB aligned random offset
+        off_t offset = (rng() % (kSegmentSize - length)) & ~4095ull;
+        butil::IOBuf data = origin;
+        state.ResumeTiming();
+
+        bench->Split(&data, offset, length);
+
+        state.PauseTiming();
+        bench->Reset(offset, length);
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+
+}  // namespace
+
+static void BM_SplitorNormal(benchmark::State& state) {  // NOLINT
+    SplitorBench bench(0, 0);
+    RunSplit(state, &bench);
+}
+
+// SplitForStripe is reached through IO2ChunkRequests for striped files.
+static void BM_SplitorStripe(benchmark::State& state) {  // NOLINT
+    SplitorBench bench(64 * 1024, 4);
+    RunSplit(state, &bench);
+}
+
+BENCHMARK(BM_SplitorNormal)->Arg(4 << 10)->Arg(64 << 10)->Arg(1 << 20)
+    ->Arg(4 << 20);
+BENCHMARK(BM_SplitorStripe)->Arg(4 << 10)->Arg(64 << 10)->Arg(1 << 20)
+    ->Arg(4 << 20);
+
+}  // namespace client
+}  // namespace curve
+
+BENCHMARK_MAIN();
@@ -0,0 +1,139 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "src/common/bitmap.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+// Bit-by-bit versions of the scans, kept here as the baseline to compare
+// against the word-at-a-time implementation.
+uint32_t NaiveNextClearBit(const Bitmap& bitmap, uint32_t index) {
+    for (; index < bitmap.Size(); ++index) {
+        if (!bitmap.Test(index))
+            return index;
+    }
+    return Bitmap::NO_POS;
+}
+
+void NaiveSet(Bitmap* bitmap, uint32_t start, uint32_t end) {
+    for (uint32_t index = start; index <= end; ++index) {
+        bitmap->Set(index);
+    }
+}
+
+// Fill the bitmap so that only the last few percent of it is free, which is
+// where an allocator spends most of its time scanning.
+void PrepareAllocBitmap(Bitmap* bitmap) {
+    bitmap->Set(0, bitmap->Size() / 100 * 97);
+}
+
+}  // namespace
+
+// Allocation: find the next free extent and mark it used.
+static void BM_BitmapAlloc(benchmark::State& state) {  // NOLINT
+    const uint32_t bits = state.range(0);
+    const uint32_t extent = 16;
+    Bitmap bitmap(bits);
+    PrepareAllocBitmap(&bitmap);
+    for (auto _ : state) {
+        uint32_t index = bitmap.NextClearBit(0);
+        if (index == Bitmap::NO_POS || index + extent > bits) {
+            state.PauseTiming();
+            bitmap.Clear();
+            PrepareAllocBitmap(&bitmap);
+            state.ResumeTiming();
+            continue;
+        }
+        bitmap.Set(index, index + extent - 1);
+    }
+}
+
+static void BM_BitmapAllocNaive(benchmark::State& state) {  // NOLINT
+    const uint32_t bits = state.range(0);
+    const uint32_t extent = 16;
+    Bitmap bitmap(bits);
+    PrepareAllocBitmap(&bitmap);
+    for (auto _ : state) {
+        uint32_t index = NaiveNextClearBit(bitmap, 0);
+        if (index == Bitmap::NO_POS || index + extent > bits) {
+            state.PauseTiming();
+            bitmap.Clear();
+            PrepareAllocBitmap(&bitmap);
+            state.ResumeTiming();
+            continue;
+        }
+        NaiveSet(&bitmap, index, index + extent - 1);
+    }
+}
+
+// Clone chunk update: copy the bitmap the way CSChunkFile does, mark the
+// written pages and split the range into copied/uncopied parts.
+static void BM_BitmapCloneUpdate(benchmark::State& state) {  // NOLINT
+    const uint32_t bits = state.range(0);
+    Bitmap origin(bits);
+    std::mt19937 rng(0);
+    for (int i = 0; i < 1000; ++i) {
+        uint32_t start = rng() % bits;
+        origin.Set(start, start + rng() % 1024);
+    }
+
+    std::vector<BitRange> clearRanges;
+    std::vector<BitRange> setRanges;
+    for (auto _ : state) {
+        Bitmap bitmap(bits, origin.GetBitmap());
+        uint32_t start = rng() % bits;
+        uint32_t end = start + 4096;
+        bitmap.Set(start, end);
+        bitmap.Divide(0, bits - 1, &clearRanges, &setRanges);
+        benchmark::DoNotOptimize(clearRanges.data());
+        benchmark::DoNotOptimize(setRanges.data());
+    }
+}
+
+static void BM_BitmapCount(benchmark::State& state) {  // NOLINT
+    const uint32_t bits = state.range(0);
+    Bitmap bitmap(bits);
+    bitmap.Set(bits / 3, bits / 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bitmap.Count(0, bits - 1));
+    }
+    state.SetBytesProcessed(state.iterations() * (bits / 8));
+}
+
+BENCHMARK(BM_BitmapAlloc)->Arg(1 << 20)->Arg(4 << 20)->Arg(16 << 20);
+BENCHMARK(BM_BitmapAllocNaive)->Arg(1 << 20)->Arg(4 << 20);
+BENCHMARK(BM_BitmapCloneUpdate)->Arg(1 << 20)->Arg(4 << 20);
+BENCHMARK(BM_BitmapCount)->Arg(1 << 20)->Arg(16 << 20);
+
+}  // namespace common
+}  // namespace curve
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+// Throughput of every codec on the kinds of chunk data seen in snapshots
+// and s3 objects: text-like data, random (already compressed or encrypted)
+// data and never written (all zero) data. `ratio` is compressed size over
+// raw size.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <string>
+
+#include "src/common/compression.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+constexpr size_t kDataSize = 4 * 1024 * 1024;
+
+enum DataKind {
+    kCompressible = 0,
+    kRandom = 1,
+    kZero = 2,
+};
+
+std::string PrepareData(DataKind kind) {
+    std::string data(kDataSize, 0);
+    unsigned int seed = 1;
+    switch (kind) {
+        case kCompressible:
+            // short random words from a small dictionary
+            for (size_t i = 0; i < data.size(); ++i) {
+                data[i] = "abcdefgh    \n"[rand_r(&seed) % 13];
+            }
+            break;
+        case kRandom:
+            for (auto& c : data) {
+                c = static_cast<char>(rand_r(&seed));
+            }
+            break;
+        case kZero:
+            break;
+    }
+    return data;
+}
+
+}  // namespace
+
+static void BM_Compress(benchmark::State& state) {  // NOLINT
+    CompressionType type = static_cast<CompressionType>(state.range(0));
+    std::string data = PrepareData(static_cast<DataKind>(state.range(1)));
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        CompressData(type, data.data(), data.size(), &out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetLabel(CompressionTypeToString(type));
+    state.counters["ratio"] = static_cast<double>(out.size()) / data.size();
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+static void BM_Decompress(benchmark::State& state) {  // NOLINT
+    CompressionType type = static_cast<CompressionType>(state.range(0));
+    std::string data = PrepareData(static_cast<DataKind>(state.range(1)));
+    std::string compressed;
+    CompressData(type, data.data(), data.size(), &compressed);
+    std::string out;
+    out.reserve(data.size());
+    for (auto _ : state) {
+        out.clear();
+        if (!DecompressData(compressed.data(), compressed.size(), &out)) {
+            state.SkipWithError("decompress failed");
+            break;
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetLabel(CompressionTypeToString(type));
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+// args: codec, data kind
+BENCHMARK(BM_Compress)->ArgsProduct({{0, 1, 2}, {0, 1, 2}});
+BENCHMARK(BM_Decompress)->ArgsProduct({{0, 1, 2}, {0, 1, 2}});
+
+}  // namespace common
+}  // namespace curve
+
+BENCHMARK_MAIN();
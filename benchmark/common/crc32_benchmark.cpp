@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "src/common/crc32.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+std::string RandomData(size_t length) {
+    std::string data(length, 0);
+    std::mt19937 rng(0);
+    for (auto& c : data) {
+        c = static_cast<char>(rng());
+    }
+    return data;
+}
+
+}  // namespace
+
+// One shot crc of a buffer, as done for a write request or a scan range.
+static void BM_CRC32(benchmark::State& state) {  // NOLINT
+    const size_t length = state.range(0);
+    std::string data = RandomData(length);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CRC32(data.data(), length));
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+
+// Incremental crc over the blocks of a buffer, the way the crc of an IOBuf
+// made of 8KB blocks is computed.
+static void BM_CRC32Incremental(benchmark::State& state) {  // NOLINT
+    const size_t length = state.range(0);
+    const size_t block = 8 * 1024;
+    std::string data = RandomData(length);
+    for (auto _ : state) {
+        uint32_t crc = 0;
+        for (size_t off = 0; off < length; off += block) {
+            crc = CRC32(crc, data.data() + off,
+                        std::min(block, length - off));
+        }
+        benchmark::DoNotOptimize(crc);
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+
+BENCHMARK(BM_CRC32)->RangeMultiplier(8)->Range(512, 4 << 20);
+BENCHMARK(BM_CRC32Incremental)->Arg(64 << 10)->Arg(1 << 20)->Arg(4 << 20);
+
+}  // namespace common
+}  // namespace curve
+
+BENCHMARK_MAIN();
@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "src/common/lru_cache.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+constexpr uint64_t kCacheCount = 65536;
+// a bit more keys than the capacity, so that some lookups miss and insert
+constexpr uint64_t kKeyRange = kCacheCount * 5 / 4;
+
+using Cache = LRUCacheInterface<std::string, std::string>;
+
+std::shared_ptr<Cache> NewCache(int type) {
+    switch (type) {
+        case 0:
+            return std::make_shared<LRUCache<std::string, std::string>>(
+                kCacheCount);
+        case 1:
+            return std::make_shared<ShardedLRUCache<std::string, std::string>>(
+                kCacheCount, 32, CacheEvictPolicy::LRU);
+        default:
+            return std::make_shared<ShardedLRUCache<std::string, std::string>>(
+                kCacheCount, 32, CacheEvictPolicy::CLOCK);
+    }
+}
+
+const char* CacheName(int type) {
+    switch (type) {
+        case 0:
+            return "lru";
+        case 1:
+            return "sharded_lru";
+        default:
+            return "sharded_clock";
+    }
+}
+
+std::shared_ptr<Cache> g_cache;
+
+}  // namespace
+
+// Simulate the dentry cache under many fuse threads: keys look like
+// "parentId:name", most lookups hit and a miss fills the cache.
+static void BM_CacheGetPut(benchmark::State& state) {  // NOLINT
+    const int type = state.range(0);
+    if (state.thread_index() == 0) {
+        g_cache = NewCache(type);
+        for (uint64_t i = 0; i < kCacheCount; ++i) {
+            g_cache->Put("1:" + std::to_string(i), std::to_string(i));
+        }
+        state.SetLabel(CacheName(type));
+    }
+
+    std::mt19937_64 rng(state.thread_index());
+    std::string value;
+    for (auto _ : state) {
+        std::string key = "1:" + std::to_string(rng() % kKeyRange);
+        if (!g_cache->Get(key, &value)) {
+            g_cache->Put(key, key);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        g_cache.reset();
+    }
+}
+
+BENCHMARK(BM_CacheGetPut)
+    ->DenseRange(0, 2)
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
+
+}  // namespace common
+}  // namespace curve
+
+BENCHMARK_MAIN();
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-17
+ * Author: curve
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/bounded_blocking_queue.h"
+#include "src/common/concurrent/mpsc_queue.h"
+#include "src/common/concurrent/task_queue.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+constexpr int kTasksPerProducer = 100000;
+constexpr size_t kQueueDepth = 1024;
+
+// Simulate what the apply path pushes: a member function bound with a
+// shared_ptr to the request, the log index and a closure pointer.
+struct FakeRequest {
+    void OnApply(uint64_t index, uint64_t* sum) {
+        *sum += index;
+    }
+};
+
+// The same producer/consumer shape on top of the BoundedBlockingDeque
+// the client RequestScheduler dispatches its requests with.
+class DequeTaskQueue {
+ public:
+    explicit DequeTaskQueue(size_t capacity) {
+        deque_.Init(capacity);
+    }
+
+    template <class F, class... Args>
+    void Push(F&& f, Args&&... args) {
+        deque_.PutBack(std::bind(std::forward<F>(f),
+                                 std::forward<Args>(args)...));
+    }
+
+    std::function<void()> Pop() {
+        return deque_.TakeFront();
+    }
+
+ private:
+    BoundedBlockingDeque<std::function<void()>> deque_;
+};
+
+template <typename Queue>
+void RunProducersConsumer(Queue* queue, int producers) {
+    auto request = std::make_shared<FakeRequest>();
+    uint64_t sum = 0;
+
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([queue, request, &sum]() {
+            for (int i = 0; i < kTasksPerProducer; ++i) {
+                queue->Push(&FakeRequest::OnApply, request,
+                            static_cast<uint64_t>(i), &sum);
+            }
+        });
+    }
+
+    for (int i = 0; i < producers * kTasksPerProducer; ++i) {
+        queue->Pop()();
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    benchmark::DoNotOptimize(sum);
+}
+
+}  // namespace
+
+static void BM_TaskQueue(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        TaskQueue queue(kQueueDepth);
+        RunProducersConsumer(&queue, producers);
+    }
+    state.SetItemsProcessed(state.iterations() * producers *
+                            kTasksPerProducer);
+}
+
+static void BM_MPSCTaskQueue(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        MPSCTaskQueue queue(kQueueDepth);
+        RunProducersConsumer(&queue, producers);
+    }
+    state.SetItemsProcessed(state.iterations() * producers *
+                            kTasksPerProducer);
+}
+
+static void BM_BoundedBlockingDeque(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        DequeTaskQueue queue(kQueueDepth);
+        RunProducersConsumer(&queue, producers);
+    }
+    state.SetItemsProcessed(state.iterations() * producers *
+                            kTasksPerProducer);
+}
+
+BENCHMARK(BM_TaskQueue)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MPSCTaskQueue)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BoundedBlockingDeque)->RangeMultiplier(2)->Range(1, 16)
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+
+}  // namespace common
+}  // namespace curve
+
+BENCHMARK_MAIN();
@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "curvefs/src/client/s3/client_s3_adaptor.h"
+#include "curvefs/src/client/s3/client_s3_cache_manager.h"
+
+namespace curvefs {
+namespace client {
+
+namespace {
+
+constexpr uint64_t kChunkSize = 64 * 1024 * 1024;
+constexpr uint64_t kBlockSize = 4 * 1024 * 1024;
+constexpr uint64_t kPageSize = 64 * 1024;
+
+// Drive the write cache of one file without s3 and the background flush,
+// so that only the DataCache write/merge path is measured.
+class DataCacheBench {
+ public:
+    DataCacheBench() {
+        S3ClientAdaptorOption option = S3ClientAdaptorOption();
+        option.blockSize = kBlockSize;
+        option.chunkSize = kChunkSize;
+        option.pageSize = kPageSize;
+        option.prefetchBlocks = 1;
+        option.intervalSec = 5000;
+        option.flushIntervalSec = 5000;
+        option.chunkFlushThreads = 1;
+        option.writeCacheMaxByte = 8ull * 1024 * 1024 * 1024;
+        option.readCacheMaxByte = 8ull * 1024 * 1024 * 1024;
+        option.diskCacheOpt.diskCacheType = DiskCacheType::Disable;
+        adaptor_.reset(new S3ClientAdaptorImpl());
+        auto fsCacheManager = std::make_shared<FsCacheManager>(
+            adaptor_.get(), option.readCacheMaxByte,
+            option.writeCacheMaxByte);
+        adaptor_->Init(option, nullptr, nullptr, nullptr, fsCacheManager,
+                       nullptr);
+        Reset();
+    }
+
+    ~DataCacheBench() {
+        fileCache_->ReleaseCache();
+    }
+
+    void Write(uint64_t offset, uint64_t length, const char* data) {
+        fileCache_->Write(offset, length, data);
+    }
+
+    void Reset() {
+        if (fileCache_ != nullptr) {
+            fileCache_->ReleaseCache();
+        }
+        fileCache_ = std::make_shared<FileCacheManager>(1, 1, adaptor_.get());
+    }
+
+ private:
+    std::unique_ptr<S3ClientAdaptorImpl> adaptor_;
+    FileCacheManagerPtr fileCache_;
+};
+
+}  // namespace
+
+// Sequential writes are merged into the DataCache ahead of them.
+static void BM_DataCacheSequentialWrite(benchmark::State& state) {  // NOLINT
+    const uint64_t length = state.range(0);
+    std::string data(length, 'a');
+    DataCacheBench bench;
+    uint64_t offset = 0;
+    for (auto _ : state) {
+        if (offset + length > kChunkSize) {
+            state.PauseTiming();
+            bench.Reset();
+            offset = 0;
+            state.ResumeTiming();
+        }
+        bench.Write(offset, length, data.data());
+        offset += length;
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+
+// Random writes inside a chunk, overlapping and adjacent writes are merged
+// with the existing DataCaches.
+static void BM_DataCacheRandomWrite(benchmark::State& state) {  // NOLINT
+    const uint64_t length = state.range(0);
+    const int kWritesPerChunk = 1024;
+    std::string data(length, 'a');
+    DataCacheBench bench;
+    std::mt19937_64 rng(0);
+    int writes = 0;
+    for (auto _ : state) {
+        if (writes++ == kWritesPerChunk) {
+            state.PauseTiming();
+            bench.Reset();
+            writes = 0;
+            state.ResumeTiming();
+        }
+        uint64_t offset = (rng() % (kChunkSize - length)) & ~4095ull;
+        bench.Write(offset, length, data.data());
+    }
+    state.SetBytesProcessed(state.iterations() * length);
+}
+
+BENCHMARK(BM_DataCacheSequentialWrite)->Arg(4 << 10)->Arg(128 << 10)
+    ->Arg(1 << 20);
+BENCHMARK(BM_DataCacheRandomWrite)->Arg(4 << 10)->Arg(128 << 10);
+
+}  // namespace client
+}  // namespace curvefs
+
+BENCHMARK_MAIN();
@@ -0,0 +1,272 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "curvefs/proto/metaserver.pb.h"
+#include "curvefs/src/metaserver/storage/converter.h"
+#include "curvefs/src/metaserver/storage/memory_storage.h"
+#include "curvefs/src/metaserver/storage/rocksdb_storage.h"
+#include "src/fs/ext4_filesystem_impl.h"
+
+namespace curvefs {
+namespace metaserver {
+namespace storage {
+
+namespace {
+
+const char kDataDir[] = "./kv_storage_benchmark";  // NOLINT
+
+Dentry MakeDentry(uint64_t index) {
+    Dentry dentry;
+    dentry.set_fsid(1);
+    dentry.set_parentinodeid(1);
+    dentry.set_name("file_" + std::to_string(index));
+    dentry.set_txid(0);
+    dentry.set_inodeid(index + 2);
+    return dentry;
+}
+
+std::string MakeKey(uint64_t index) {
+    return "1:1:file_" + std::to_string(index);
+}
+
+std::shared_ptr<KVStorage> OpenStorage(bool rocksdb) {
+    StorageOptions options = StorageOptions();
+    options.maxMemoryQuotaBytes = 32ull * 1024 * 1024 * 1024;
+    options.maxDiskQuotaBytes = 256ull * 1024 * 1024 * 1024;
+    options.dataDir = std::string(kDataDir) + "/rocksdb.db";
+    options.compression = false;
+    options.keyPrefixLength = NameGenerator::GetFixedLength();
+    options.localFileSystem =
+        curve::fs::Ext4FileSystemImpl::getInstance().get();
+
+    std::shared_ptr<KVStorage> storage;
+    if (rocksdb) {
+        options.localFileSystem->Mkdir(kDataDir);
+        storage = std::make_shared<RocksDBStorage>(options);
+    } else {
+        storage = std::make_shared<MemoryStorage>(options);
+    }
+    if (!storage->Open()) {
+        return nullptr;
+    }
+    return storage;
+}
+
+void CloseStorage(const std::shared_ptr<KVStorage>& storage, bool rocksdb) {
+    storage->Close();
+    if (rocksdb) {
+        curve::fs::Ext4FileSystemImpl::getInstance()->Delete(kDataDir);
+    }
+}
+
+// Fill the dentry table of a partition with the given number of dentries.
+bool Prepare(const std::shared_ptr<KVStorage>& storage,
+             const std::string& table,
+             uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!storage->HSet(table, MakeKey(i), MakeDentry(i)).ok()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RunHGet(benchmark::State& state, bool rocksdb) {
+    const uint64_t count = state.range(0);
+    auto storage = OpenStorage(rocksdb);
+    std::string table = NameGenerator(1).GetDentryTableName();
+    if (storage == nullptr || !Prepare(storage, table, count)) {
+        state.SkipWithError("prepare storage failed");
+        return;
+    }
+
+    std::mt19937_64 rng(0);
+    Dentry dentry;
+    for (auto _ : state) {
+        Status s = storage->HGet(table, MakeKey(rng() % count), &dentry);
+        benchmark::DoNotOptimize(s.ok());
+    }
+    state.SetItemsProcessed(state.iterations());
+    CloseStorage(storage, rocksdb);
+}
+
+void RunHSet(benchmark::State& state, bool rocksdb) {
+    const uint64_t count = state.range(0);
+    auto storage = OpenStorage(rocksdb);
+    std::string table = NameGenerator(1).GetDentryTableName();
+    if (storage == nullptr || !Prepare(storage, table, count)) {
+        state.SkipWithError("prepare storage failed");
+        return;
+    }
+
+    std::mt19937_64 rng(0);
+    for (auto _ : state) {
+        uint64_t index = rng() % count;
+        Status s = storage->HSet(table, MakeKey(index), MakeDentry(index));
+        benchmark::DoNotOptimize(s.ok());
+    }
+    state.SetItemsProcessed(state.iterations());
+    CloseStorage(storage, rocksdb);
+}
+
+// dentrys are spread over directories like a real filesystem, so that the
+// list only hits the entries of one directory
+const uint64_t kDentrysPerDir = 100;
+
+Inode MakeInode(uint64_t inodeId) {
+    Inode inode;
+    inode.set_inodeid(inodeId);
+    inode.set_fsid(1);
+    inode.set_length(4096);
+    inode.set_ctime(0);
+    inode.set_ctime_ns(0);
+    inode.set_mtime(0);
+    inode.set_mtime_ns(0);
+    inode.set_atime(0);
+    inode.set_atime_ns(0);
+    inode.set_uid(0);
+    inode.set_gid(0);
+    inode.set_mode(0644);
+    inode.set_nlink(1);
+    inode.set_type(FsFileType::TYPE_S3);
+    return inode;
+}
+
+// Fill the dentry and inode table of a partition like a filesystem with
+// the given number of files.
+bool PrepareFs(const std::shared_ptr<KVStorage>& storage,
+               const NameGenerator& nameGenerator,
+               uint64_t count) {
+    Converter conv;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t parent = i / kDentrysPerDir + 1;
+        Key4Dentry dentryKey(1, parent, "file_" + std::to_string(i));
+        Dentry dentry = MakeDentry(i);
+        dentry.set_parentinodeid(parent);
+        Key4Inode inodeKey(1, i + 2);
+        if (!storage->SSet(nameGenerator.GetDentryTableName(),
+                           conv.SerializeToString(dentryKey), dentry).ok() ||
+            !storage->HSet(nameGenerator.GetInodeTableName(),
+                           conv.SerializeToString(inodeKey),
+                           MakeInode(i + 2)).ok()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RunListDentry(benchmark::State& state, bool rocksdb) {
+    const uint64_t count = state.range(0);
+    NameGenerator nameGenerator(1);
+    auto storage = OpenStorage(rocksdb);
+    if (storage == nullptr || !PrepareFs(storage, nameGenerator, count)) {
+        state.SkipWithError("prepare storage failed");
+        return;
+    }
+
+    Converter conv;
+    std::mt19937_64 rng(0);
+    const uint64_t dirs = (count + kDentrysPerDir - 1) / kDentrysPerDir;
+    uint64_t listed = 0;
+    for (auto _ : state) {
+        Prefix4SameParentDentry prefix(1, rng() % dirs + 1);
+        auto iterator = storage->SSeek(nameGenerator.GetDentryTableName(),
+                                       conv.SerializeToString(prefix));
+        for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+            benchmark::DoNotOptimize(iterator->Value());
+            listed++;
+        }
+    }
+    state.SetItemsProcessed(listed);
+    CloseStorage(storage, rocksdb);
+}
+
+void RunGetInode(benchmark::State& state, bool rocksdb) {
+    const uint64_t count = state.range(0);
+    NameGenerator nameGenerator(1);
+    auto storage = OpenStorage(rocksdb);
+    if (storage == nullptr || !PrepareFs(storage, nameGenerator, count)) {
+        state.SkipWithError("prepare storage failed");
+        return;
+    }
+
+    Converter conv;
+    std::mt19937_64 rng(0);
+    Inode inode;
+    for (auto _ : state) {
+        Key4Inode key(1, rng() % count + 2);
+        Status s = storage->HGet(nameGenerator.GetInodeTableName(),
+                                 conv.SerializeToString(key), &inode);
+        benchmark::DoNotOptimize(s.ok());
+    }
+    state.SetItemsProcessed(state.iterations());
+    CloseStorage(storage, rocksdb);
+}
+
+}  // namespace
+
+static void BM_MemoryStorageHGet(benchmark::State& state) {  // NOLINT
+    RunHGet(state, false);
+}
+
+static void BM_MemoryStorageHSet(benchmark::State& state) {  // NOLINT
+    RunHSet(state, false);
+}
+
+static void BM_RocksDBStorageHGet(benchmark::State& state) {  // NOLINT
+    RunHGet(state, true);
+}
+
+static void BM_RocksDBStorageHSet(benchmark::State& state) {  // NOLINT
+    RunHSet(state, true);
+}
+
+static void BM_RocksDBStorageListDentry(benchmark::State& state) {  // NOLINT
+    RunListDentry(state, true);
+}
+
+static void BM_RocksDBStorageGetInode(benchmark::State& state) {  // NOLINT
+    RunGetInode(state, true);
+}
+
+BENCHMARK(BM_MemoryStorageHGet)->Arg(10000)->Arg(1000000);
+BENCHMARK(BM_MemoryStorageHSet)->Arg(10000)->Arg(1000000);
+BENCHMARK(BM_RocksDBStorageHGet)->Arg(10000)->Arg(1000000);
+BENCHMARK(BM_RocksDBStorageHSet)->Arg(10000)->Arg(1000000);
+// NOTE: it takes a long time to prepare 100M entries
+BENCHMARK(BM_RocksDBStorageListDentry)
+    ->Arg(1000000)->Arg(100000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RocksDBStorageGetInode)
+    ->Arg(1000000)->Arg(100000000)->Unit(benchmark::kMicrosecond);
+
+}  // namespace storage
+}  // namespace metaserver
+}  // namespace curvefs
+
+BENCHMARK_MAIN();
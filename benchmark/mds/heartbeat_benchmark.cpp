@@ -0,0 +1,329 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "proto/heartbeat.pb.h"
+#include "src/mds/heartbeat/heartbeat_manager.h"
+#include "src/mds/schedule/coordinator.h"
+#include "src/mds/topology/topology.h"
+#include "src/mds/topology/topology_stat.h"
+
+namespace curve {
+namespace mds {
+namespace heartbeat {
+
+using ::curve::mds::topology::ChunkServer;
+using ::curve::mds::topology::ChunkServerIdType;
+using ::curve::mds::topology::ClusterInformation;
+using ::curve::mds::topology::DefaultIdGenerator;
+using ::curve::mds::topology::DefaultTokenGenerator;
+using ::curve::mds::topology::LogicalPool;
+using ::curve::mds::topology::PhysicalPool;
+using ::curve::mds::topology::Server;
+using ::curve::mds::topology::ServerIdType;
+using ::curve::mds::topology::TopologyImpl;
+using ::curve::mds::topology::TopologyStatImpl;
+using ::curve::mds::topology::TopologyStorage;
+using ::curve::mds::topology::Zone;
+using ::curve::mds::topology::ZoneIdType;
+using TopoCopySetInfo = ::curve::mds::topology::CopySetInfo;
+
+namespace {
+
+const uint32_t kChunkServerNum = 30;
+const uint32_t kZoneNum = 3;
+const uint32_t kPort = 8200;
+const PoolIdType kPhysicalPoolId = 1;
+const PoolIdType kLogicalPoolId = 1;
+
+// keep the topology in memory only
+class MemoryTopologyStorage : public TopologyStorage {
+ public:
+    bool LoadLogicalPool(
+        std::unordered_map<PoolIdType, LogicalPool> *logicalPoolMap,
+        PoolIdType *maxLogicalPoolId) override { return true; }
+    bool LoadPhysicalPool(
+        std::unordered_map<PoolIdType, PhysicalPool> *physicalPoolMap,
+        PoolIdType *maxPhysicalPoolId) override { return true; }
+    bool LoadZone(std::unordered_map<ZoneIdType, Zone> *zoneMap,
+        ZoneIdType *maxZoneId) override { return true; }
+    bool LoadServer(std::unordered_map<ServerIdType, Server> *serverMap,
+        ServerIdType *maxServerId) override { return true; }
+    bool LoadChunkServer(
+        std::unordered_map<ChunkServerIdType, ChunkServer> *chunkServerMap,
+        ChunkServerIdType *maxChunkServerId) override { return true; }
+    bool LoadCopySet(std::map<CopySetKey, TopoCopySetInfo> *copySetMap,
+        std::map<PoolIdType, CopySetIdType> *copySetIdMaxMap) override {
+        return true;
+    }
+
+    bool StorageLogicalPool(const LogicalPool &data) override { return true; }
+    bool StoragePhysicalPool(const PhysicalPool &data) override {
+        return true;
+    }
+    bool StorageZone(const Zone &data) override { return true; }
+    bool StorageServer(const Server &data) override { return true; }
+    bool StorageChunkServer(const ChunkServer &data) override { return true; }
+    bool StorageCopySet(const TopoCopySetInfo &data) override { return true; }
+
+    bool DeleteLogicalPool(PoolIdType id) override { return true; }
+    bool DeletePhysicalPool(PoolIdType id) override { return true; }
+    bool DeleteZone(ZoneIdType id) override { return true; }
+    bool DeleteServer(ServerIdType id) override { return true; }
+    bool DeleteChunkServer(ChunkServerIdType id) override { return true; }
+    bool DeleteCopySet(CopySetKey key) override { return true; }
+
+    bool UpdateLogicalPool(const LogicalPool &data) override { return true; }
+    bool UpdatePhysicalPool(const PhysicalPool &data) override {
+        return true;
+    }
+    bool UpdateZone(const Zone &data) override { return true; }
+    bool UpdateServer(const Server &data) override { return true; }
+    bool UpdateChunkServer(const ChunkServer &data) override { return true; }
+    bool UpdateCopySet(const TopoCopySetInfo &data) override { return true; }
+
+    bool LoadClusterInfo(std::vector<ClusterInformation> *info) override {
+        return true;
+    }
+    bool StorageClusterInfo(const ClusterInformation &info) override {
+        return true;
+    }
+};
+
+// no operator to dispatch, as in the steady state of the cluster
+class IdleCoordinator : public Coordinator {
+ public:
+    ChunkServerIdType CopySetHeartbeat(
+        const ::curve::mds::topology::CopySetInfo &originInfo,
+        const ConfigChangeInfo &configChInfo,
+        CopySetConf *newConf) override {
+        return ::curve::mds::topology::UNINTIALIZE_ID;
+    }
+
+    bool ChunkserverGoingToAdd(ChunkServerIdType csId,
+                               CopySetKey key) override {
+        return false;
+    }
+
+    bool CopySetHasOperator(CopySetKey key) override {
+        return false;
+    }
+};
+
+std::string ChunkServerIp(ChunkServerIdType id) {
+    return "10.0." + std::to_string(id / 256) + "." +
+           std::to_string(id % 256);
+}
+
+std::string PeerAddress(ChunkServerIdType id) {
+    return ChunkServerIp(id) + ":" + std::to_string(kPort) + ":0";
+}
+
+// a cluster of kChunkServerNum chunkservers in kZoneNum zones, every
+// copyset has a replica in each zone
+class HeartbeatCluster {
+ public:
+    explicit HeartbeatCluster(uint32_t copysetPerChunkServer) {
+        topology_ = std::make_shared<TopologyImpl>(
+            std::make_shared<DefaultIdGenerator>(),
+            std::make_shared<DefaultTokenGenerator>(),
+            std::make_shared<MemoryTopologyStorage>());
+        HeartbeatOption option;
+        option.cleanFollowerAfterMs = 0;
+        option.mdsStartTime = steady_clock::now();
+        manager_ = std::make_shared<HeartbeatManager>(option, topology_,
+            std::make_shared<TopologyStatImpl>(topology_),
+            std::make_shared<IdleCoordinator>());
+
+        topology_->AddPhysicalPool(
+            PhysicalPool(kPhysicalPoolId, "pool", ""));
+        for (ZoneIdType zone = 1; zone <= kZoneNum; ++zone) {
+            topology_->AddZone(Zone(zone, "zone" + std::to_string(zone),
+                                    kPhysicalPoolId, ""));
+        }
+        for (ChunkServerIdType id = 1; id <= kChunkServerNum; ++id) {
+            ZoneIdType zone = (id - 1) % kZoneNum + 1;
+            topology_->AddServer(Server(id, "server" + std::to_string(id),
+                ChunkServerIp(id), 0, ChunkServerIp(id), 0, zone,
+                kPhysicalPoolId, ""));
+            topology_->AddChunkServer(ChunkServer(id, "token", "nvme", id,
+                ChunkServerIp(id), kPort, "/"));
+        }
+        topology_->AddLogicalPool(LogicalPool(kLogicalPoolId, "logicalPool",
+            kPhysicalPoolId, ::curve::mds::topology::PAGEFILE,
+            LogicalPool::RedundanceAndPlaceMentPolicy(),
+            LogicalPool::UserPolicy(), 0, true, true));
+
+        uint32_t copysetNum =
+            kChunkServerNum * copysetPerChunkServer / kZoneNum;
+        for (CopySetIdType id = 1; id <= copysetNum; ++id) {
+            // one chunkserver of each zone, the first one is the leader
+            std::set<ChunkServerIdType> members;
+            ChunkServerIdType leader = 0;
+            for (uint32_t zone = 0; zone < kZoneNum; ++zone) {
+                ChunkServerIdType cs = ((id + zone * 7) % (kChunkServerNum /
+                    kZoneNum)) * kZoneNum + zone + 1;
+                members.insert(cs);
+                if (zone == 0) {
+                    leader = cs;
+                }
+            }
+            TopoCopySetInfo copyset(kLogicalPoolId, id);
+            copyset.SetCopySetMembers(members);
+            copyset.SetLeader(leader);
+            copyset.SetEpoch(1);
+            topology_->AddCopySet(copyset);
+
+            for (auto cs : members) {
+                AddCopySetInfo(&requests_[cs], copyset);
+            }
+        }
+
+        for (auto &pair : requests_) {
+            PrepareRequest(pair.first, &pair.second);
+        }
+    }
+
+    // heartbeat request carrying all copysets of the chunkserver
+    const ChunkServerHeartbeatRequest &FullRequest(ChunkServerIdType id) {
+        return requests_[id];
+    }
+
+    // incremental heartbeat request carrying the first changed copysets
+    ChunkServerHeartbeatRequest IncrementalRequest(ChunkServerIdType id,
+                                                   int changed) {
+        ChunkServerHeartbeatRequest request = requests_[id];
+        request.set_incremental(true);
+        auto infos = request.mutable_copysetinfos();
+        if (changed < infos->size()) {
+            infos->DeleteSubrange(changed, infos->size() - changed);
+        }
+        return request;
+    }
+
+    void Heartbeat(const ChunkServerHeartbeatRequest &request) {
+        ChunkServerHeartbeatResponse response;
+        manager_->ChunkServerHeartbeat(request, &response);
+        benchmark::DoNotOptimize(response.acceptincremental());
+    }
+
+ private:
+    void AddCopySetInfo(ChunkServerHeartbeatRequest *request,
+                        const TopoCopySetInfo &copyset) {
+        auto info = request->add_copysetinfos();
+        info->set_logicalpoolid(copyset.GetLogicalPoolId());
+        info->set_copysetid(copyset.GetId());
+        info->set_epoch(copyset.GetEpoch());
+        for (auto cs : copyset.GetCopySetMembers()) {
+            info->add_peers()->set_address(PeerAddress(cs));
+        }
+        info->mutable_leaderpeer()->set_address(
+            PeerAddress(copyset.GetLeader()));
+        auto stats = info->mutable_stats();
+        stats->set_readrate(0);
+        stats->set_writerate(0);
+        stats->set_readiops(0);
+        stats->set_writeiops(0);
+    }
+
+    void PrepareRequest(ChunkServerIdType id,
+                        ChunkServerHeartbeatRequest *request) {
+        request->set_chunkserverid(id);
+        request->set_token("token");
+        request->set_ip(ChunkServerIp(id));
+        request->set_port(kPort);
+        request->mutable_diskstate()->set_errtype(0);
+        request->mutable_diskstate()->set_errmsg("");
+        request->set_diskcapacity(100);
+        request->set_diskused(10);
+        request->set_copysetcount(request->copysetinfos_size());
+        int leaders = 0;
+        for (const auto &info : request->copysetinfos()) {
+            if (info.leaderpeer().address() == PeerAddress(id)) {
+                ++leaders;
+            }
+        }
+        request->set_leadercount(leaders);
+        auto stats = request->mutable_stats();
+        stats->set_readrate(0);
+        stats->set_writerate(0);
+        stats->set_readiops(0);
+        stats->set_writeiops(0);
+        stats->set_chunksizeusedbytes(0);
+        stats->set_chunksizeleftbytes(0);
+        stats->set_chunksizetrashedbytes(0);
+    }
+
+ private:
+    std::shared_ptr<TopologyImpl> topology_;
+    std::shared_ptr<HeartbeatManager> manager_;
+    std::map<ChunkServerIdType, ChunkServerHeartbeatRequest> requests_;
+};
+
+}  // namespace
+
+// Full heartbeat of a chunkserver, the mds converts and checks every copyset
+// on it.
+static void BM_FullHeartbeat(benchmark::State& state) {  // NOLINT
+    HeartbeatCluster cluster(state.range(0));
+    ChunkServerIdType id = 0;
+    for (auto _ : state) {
+        id = id % kChunkServerNum + 1;
+        cluster.Heartbeat(cluster.FullRequest(id));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Incremental heartbeat with state.range(1) changed copysets, the others are
+// taken from the last heartbeat.
+static void BM_IncrementalHeartbeat(benchmark::State& state) {  // NOLINT
+    HeartbeatCluster cluster(state.range(0));
+    std::vector<ChunkServerHeartbeatRequest> requests;
+    for (ChunkServerIdType id = 1; id <= kChunkServerNum; ++id) {
+        cluster.Heartbeat(cluster.FullRequest(id));
+        requests.emplace_back(cluster.IncrementalRequest(id, state.range(1)));
+    }
+    ChunkServerIdType id = 0;
+    for (auto _ : state) {
+        id = id % kChunkServerNum + 1;
+        cluster.Heartbeat(requests[id - 1]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_FullHeartbeat)->Arg(100)->Arg(500);
+BENCHMARK(BM_IncrementalHeartbeat)->Args({100, 0})->Args({100, 10})
+    ->Args({500, 0})->Args({500, 50});
+
+}  // namespace heartbeat
+}  // namespace mds
+}  // namespace curve
+
+BENCHMARK_MAIN();
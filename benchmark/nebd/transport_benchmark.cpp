@@ -0,0 +1,251 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: nebd
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+// Compare the round trip of a qemu I/O between nebd part1 and part2 over
+// the brpc unix socket and over the shared memory ring. The part2 side only
+// moves the data, so the numbers are the cost of the transport itself.
+// `cpu_us_per_op` counts the cpu time of both sides.
+
+#include <benchmark/benchmark.h>
+#include <brpc/channel.h>
+#include <brpc/closure_guard.h>
+#include <brpc/controller.h>
+#include <brpc/server.h>
+#include <glog/logging.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "nebd/proto/client.pb.h"
+#include "nebd/src/common/shm_ring.h"
+
+namespace nebd {
+namespace common {
+
+namespace {
+
+constexpr char kSockFile[] = "/tmp/nebd_transport_benchmark.sock";
+constexpr uint32_t kSlotNum = 16;
+constexpr uint32_t kBufSize = 256 * 1024;
+constexpr uint32_t kPollSpinUs = 50;
+
+uint64_t CpuTimeUs() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000ULL +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+// part2 that only copies the data, like NebdFileServiceImpl does
+class EchoFileService : public nebd::client::NebdFileService {
+ public:
+    void Write(google::protobuf::RpcController* cntl_base,
+               const nebd::client::WriteRequest* request,
+               nebd::client::WriteResponse* response,
+               google::protobuf::Closure* done) override {
+        brpc::ClosureGuard doneGuard(done);
+        brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+        butil::IOBuf buf = cntl->request_attachment();
+        response->set_retcode(buf.size() == request->size()
+                                  ? nebd::client::RetCode::kOK
+                                  : nebd::client::RetCode::kNoOK);
+    }
+
+    void Read(google::protobuf::RpcController* cntl_base,
+              const nebd::client::ReadRequest* request,
+              nebd::client::ReadResponse* response,
+              google::protobuf::Closure* done) override {
+        brpc::ClosureGuard doneGuard(done);
+        brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+        std::string data(request->size(), 'r');
+        cntl->response_attachment().append(data);
+        response->set_retcode(nebd::client::RetCode::kOK);
+    }
+};
+
+struct RpcTransport {
+    EchoFileService service;
+    brpc::Server server;
+    brpc::Channel channel;
+
+    RpcTransport() {
+        unlink(kSockFile);
+        CHECK_EQ(0, server.AddService(&service,
+                                      brpc::SERVER_DOESNT_OWN_SERVICE));
+        brpc::ServerOptions option;
+        option.idle_timeout_sec = -1;
+        CHECK_EQ(0, server.StartAtSockFile(kSockFile, &option));
+        CHECK_EQ(0, channel.InitWithSockFile(kSockFile, nullptr));
+    }
+
+    ~RpcTransport() {
+        server.Stop(0);
+        server.Join();
+        unlink(kSockFile);
+    }
+};
+
+struct ShmTransport {
+    std::unique_ptr<ShmRing> client;
+    std::unique_ptr<ShmRing> server;
+    std::atomic<bool> running{true};
+    std::thread thread;
+
+    ShmTransport() {
+        std::string name =
+            "/nebd-transport-benchmark-" + std::to_string(getpid());
+        client = ShmRing::Create(name, kSlotNum, kBufSize);
+        CHECK(client != nullptr);
+        server = ShmRing::Attach(name);
+        CHECK(server != nullptr);
+        client->Unlink();
+        thread = std::thread(&ShmTransport::Serve, this);
+    }
+
+    ~ShmTransport() {
+        running = false;
+        thread.join();
+    }
+
+    // part2 that only copies the data, like NebdShmRingServer does
+    void Serve() {
+        std::vector<char> data(kBufSize, 'w');
+        while (running) {
+            uint32_t index;
+            while (server->PollSubmission(&index)) {
+                ShmSlot* slot = server->GetSlot(index);
+                if (slot->op == static_cast<uint32_t>(ShmOp::kRead)) {
+                    memcpy(server->GetBuffer(index), data.data(),
+                           slot->length);
+                }
+                slot->status = static_cast<int32_t>(ShmStatus::kOK);
+                server->Complete(index);
+            }
+            server->WaitSubmission(kPollSpinUs, 100);
+        }
+    }
+};
+
+}  // namespace
+
+static void BM_RpcWrite(benchmark::State& state) {  // NOLINT
+    const size_t size = state.range(0);
+    RpcTransport transport;
+    std::vector<char> data(size, 'w');
+
+    uint64_t cpuStart = CpuTimeUs();
+    for (auto _ : state) {
+        nebd::client::NebdFileService_Stub stub(&transport.channel);
+        nebd::client::WriteRequest request;
+        nebd::client::WriteResponse response;
+        brpc::Controller cntl;
+        request.set_fd(1);
+        request.set_offset(0);
+        request.set_size(size);
+        // part1 doesn't copy the write data into the attachment
+        cntl.request_attachment().append_user_data(
+            data.data(), size, [](void*) {});
+        stub.Write(&cntl, &request, &response, nullptr);
+        CHECK(!cntl.Failed()) << cntl.ErrorText();
+    }
+    state.counters["cpu_us_per_op"] = benchmark::Counter(
+        CpuTimeUs() - cpuStart, benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_RpcRead(benchmark::State& state) {  // NOLINT
+    const size_t size = state.range(0);
+    RpcTransport transport;
+    std::vector<char> data(size);
+
+    uint64_t cpuStart = CpuTimeUs();
+    for (auto _ : state) {
+        nebd::client::NebdFileService_Stub stub(&transport.channel);
+        nebd::client::ReadRequest request;
+        nebd::client::ReadResponse response;
+        brpc::Controller cntl;
+        request.set_fd(1);
+        request.set_offset(0);
+        request.set_size(size);
+        stub.Read(&cntl, &request, &response, nullptr);
+        CHECK(!cntl.Failed()) << cntl.ErrorText();
+        cntl.response_attachment().copy_to(data.data(), size);
+    }
+    state.counters["cpu_us_per_op"] = benchmark::Counter(
+        CpuTimeUs() - cpuStart, benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void ShmRoundTrip(benchmark::State& state, ShmOp op) {
+    const size_t size = state.range(0);
+    ShmTransport transport;
+    std::vector<char> data(size, 'w');
+    ShmRing* ring = transport.client.get();
+
+    uint64_t cpuStart = CpuTimeUs();
+    for (auto _ : state) {
+        ShmSlot* slot = ring->GetSlot(0);
+        slot->op = static_cast<uint32_t>(op);
+        slot->fd = 1;
+        slot->offset = 0;
+        slot->length = size;
+        if (op == ShmOp::kWrite) {
+            memcpy(ring->GetBuffer(0), data.data(), size);
+        }
+        ring->Submit(0);
+
+        uint32_t index;
+        while (!ring->PollCompletion(&index)) {
+            ring->WaitCompletion(kPollSpinUs, 100);
+        }
+        if (op == ShmOp::kRead) {
+            memcpy(data.data(), ring->GetBuffer(index), size);
+        }
+    }
+    state.counters["cpu_us_per_op"] = benchmark::Counter(
+        CpuTimeUs() - cpuStart, benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_ShmWrite(benchmark::State& state) {  // NOLINT
+    ShmRoundTrip(state, ShmOp::kWrite);
+}
+
+static void BM_ShmRead(benchmark::State& state) {  // NOLINT
+    ShmRoundTrip(state, ShmOp::kRead);
+}
+
+BENCHMARK(BM_RpcWrite)->Arg(4096)->Arg(65536)->Arg(262144)->UseRealTime();
+BENCHMARK(BM_ShmWrite)->Arg(4096)->Arg(65536)->Arg(262144)->UseRealTime();
+BENCHMARK(BM_RpcRead)->Arg(4096)->Arg(65536)->Arg(262144)->UseRealTime();
+BENCHMARK(BM_ShmRead)->Arg(4096)->Arg(65536)->Arg(262144)->UseRealTime();
+
+}  // namespace common
+}  // namespace nebd
+
+BENCHMARK_MAIN();
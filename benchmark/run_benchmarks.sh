@@ -0,0 +1,118 @@
+#!/usr/bin/env bash
+
+# Copyright (C) 2022 NetEase Inc.
+
+# Build the benchmarks under //benchmark in release mode, run them and save
+# the results in json, one file per benchmark under <output>/<commit>/, so
+# that the results of different commits can be compared, e.g. with
+# tools/compare.py of google benchmark.
+
+############################  GLOBAL VARIABLES
+
+g_output="./benchmark_results"
+g_filter="."
+g_min_time=""
+g_build_opts=(
+    "--compilation_mode=opt"
+    "--define=with_glog=true"
+    "--define=libunwind=true"
+    "--copt -DHAVE_ZLIB=1"
+    "--copt -DGFLAGS_NS=google"
+    "--copt -DUSE_BTHREAD_MUTEX"
+)
+
+############################  BASIC FUNCTIONS
+msg() {
+    printf '%b' "$1" >&2
+}
+
+success() {
+    msg "\33[32m[✔]\33[0m ${1}${2}"
+}
+
+die() {
+    msg "\33[31m[✘]\33[0m ${1}${2}"
+    exit 1
+}
+
+############################ FUNCTIONS
+usage () {
+    cat << _EOC_
+Usage:
+    run_benchmarks.sh [--output=dir] [--only=regex] [--min_time=seconds]
+Examples:
+    run_benchmarks.sh
+    run_benchmarks.sh --only=common --output=/tmp/results
+    run_benchmarks.sh --only=splitor --min_time=0.1
+_EOC_
+}
+
+get_options() {
+    local args=`getopt -o o:t:m:h --long output:,only:,min_time: -n "$0" -- "$@"`
+    eval set -- "${args}"
+    while true
+    do
+        case "$1" in
+            -o|--output)
+                g_output=$2
+                shift 2
+                ;;
+            -t|--only)
+                g_filter=$2
+                shift 2
+                ;;
+            -m|--min_time)
+                g_min_time=$2
+                shift 2
+                ;;
+            -h)
+                usage
+                exit 1
+                ;;
+            --)
+                shift
+                break
+                ;;
+            *)
+                exit 1
+                ;;
+        esac
+    done
+}
+
+run_benchmarks() {
+    local commit_id=$(git rev-parse --short HEAD)
+    local output="${g_output}/${commit_id}"
+    local targets=$(bazel query 'kind("cc_binary", //benchmark/...)' \
+        | grep -E "$g_filter")
+    [ -z "$targets" ] && die "no benchmark matches ${g_filter}\n"
+
+    bazel build ${g_build_opts[@]} $targets || die "build benchmarks failed\n"
+    mkdir -p "$output"
+
+    local extra_args=()
+    if [ -n "$g_min_time" ]; then
+        extra_args+=("--benchmark_min_time=${g_min_time}")
+    fi
+
+    local target
+    for target in $targets
+    do
+        # //benchmark/common:crc32_benchmark -> benchmark/common/crc32_benchmark
+        local binary="bazel-bin/${target#//}"
+        binary="${binary/://}"
+        local name=$(basename "$binary")
+        "$binary" --benchmark_out="${output}/${name}.json" \
+            --benchmark_out_format=json "${extra_args[@]}" \
+            || die "$target failed\n"
+        success "$target -> ${output}/${name}.json\n"
+    done
+}
+
+main() {
+    get_options "$@"
+    run_benchmarks
+}
+
+############################  MAIN()
+main "$@"
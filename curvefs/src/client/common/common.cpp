@@ -70,6 +70,9 @@ std::ostream &operator<<(std::ostream &os, MetaServerOpType optype) {
     case MetaServerOpType::UpdateVolumeExtent:
         os << "UpdateVolumeExtent";
         break;
+    case MetaServerOpType::GetS3ChunkInfoRange:
+        os << "GetS3ChunkInfoRange";
+        break;
     default:
         os << "Unknow opType";
     }
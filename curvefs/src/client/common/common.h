@@ -58,6 +58,7 @@ enum class MetaServerOpType {
     GetOrModifyS3ChunkInfo,
     GetVolumeExtent,
     UpdateVolumeExtent,
+    GetS3ChunkInfoRange,
 };
 
 std::ostream &operator<<(std::ostream &os, MetaServerOpType optype);
@@ -113,7 +113,6 @@ void InitExcutorOption(Configuration *conf, ExcutorOpt *opts, bool internal) {
 void InitBlockDeviceOption(Configuration *conf,
                            BlockDeviceClientOptions *bdevOpt) {
     conf->GetValueFatalIfFail("bdev.confpath", &bdevOpt->configPath);
-    conf->GetValueFatalIfFail("bdev.threadnum", &bdevOpt->threadnum);
 }
 
 void InitDiskCacheOption(Configuration *conf,
@@ -153,6 +152,16 @@ void InitDiskCacheOption(Configuration *conf,
                               &diskCacheOption->avgReadFileBytes);
     conf->GetValueFatalIfFail("diskCache.avgReadFileIops",
                               &diskCacheOption->avgReadFileIops);
+    LOG_IF(WARNING, !conf->GetUInt64Value(
+                        "diskCache.slabSegmentSize",
+                        &diskCacheOption->slabSegmentSize))
+        << "Not found `diskCache.slabSegmentSize` in conf, use default value `"
+        << diskCacheOption->slabSegmentSize << '`';
+    LOG_IF(WARNING, !conf->GetUInt32Value(
+                        "diskCache.slabCompactRatio",
+                        &diskCacheOption->slabCompactRatio))
+        << "Not found `diskCache.slabCompactRatio` in conf, use default value `"
+        << diskCacheOption->slabCompactRatio << '`';
 }
 
 void InitS3Option(Configuration *conf, S3Option *s3Opt) {
@@ -163,6 +172,11 @@ void InitS3Option(Configuration *conf, S3Option *s3Opt) {
                               &s3Opt->s3ClientAdaptorOpt.pageSize);
     conf->GetValueFatalIfFail("s3.prefetchBlocks",
                               &s3Opt->s3ClientAdaptorOpt.prefetchBlocks);
+    LOG_IF(WARNING, !conf->GetUInt32Value(
+                        "s3.prefetchMaxBlocks",
+                        &s3Opt->s3ClientAdaptorOpt.prefetchMaxBlocks))
+        << "Not found `s3.prefetchMaxBlocks` in conf, use default value `"
+        << s3Opt->s3ClientAdaptorOpt.prefetchMaxBlocks << '`';
     conf->GetValueFatalIfFail("s3.prefetchExecQueueNum",
                               &s3Opt->s3ClientAdaptorOpt.prefetchExecQueueNum);
     conf->GetValueFatalIfFail("s3.intervalSec",
@@ -184,6 +198,13 @@ void InitS3Option(Configuration *conf, S3Option *s3Opt) {
         &s3Opt->s3ClientAdaptorOpt.maxReadRetryIntervalMs);
     conf->GetValueFatalIfFail("s3.readRetryIntervalMs",
                               &s3Opt->s3ClientAdaptorOpt.readRetryIntervalMs);
+    LOG_IF(WARNING, !conf->GetUInt32Value(
+                        "s3.rangeReadS3ChunkInfoThreshold",
+                        &s3Opt->s3ClientAdaptorOpt
+                             .rangeReadS3ChunkInfoThreshold))
+        << "Not found `s3.rangeReadS3ChunkInfoThreshold` in conf, "
+        << "use default value `"
+        << s3Opt->s3ClientAdaptorOpt.rangeReadS3ChunkInfoThreshold << '`';
     ::curve::common::InitS3AdaptorOptionExceptS3InfoOption(conf,
                                                            &s3Opt->s3AdaptrOpt);
     InitDiskCacheOption(conf, &s3Opt->s3ClientAdaptorOpt.diskCacheOpt);
@@ -217,6 +238,8 @@ void InitExtentManagerOption(Configuration *conf,
                              ExtentManagerOption *extentManagerOpt) {
     conf->GetValueFatalIfFail("extentManager.preAllocSize",
                               &extentManagerOpt->preAllocSize);
+    conf->GetValueFatalIfFail("extentManager.maxPreAllocSize",
+                              &extentManagerOpt->maxPreAllocSize);
 }
 
 void InitLeaseOpt(Configuration *conf, LeaseOpt *leaseOpt) {
@@ -272,6 +295,23 @@ void InitFuseClientOption(Configuration *conf, FuseClientOption *clientOption) {
     conf->GetValueFatalIfFail("fuseClient.disableXattr",
                               &clientOption->disableXattr);
 
+    LOG_IF(WARNING, !conf->GetUInt32Value("fuseClient.dCacheShardNum",
+                                          &clientOption->dCacheShardNum))
+        << "Not found `fuseClient.dCacheShardNum` in conf, use default value `"
+        << clientOption->dCacheShardNum << '`';
+    std::string dCacheEvictPolicy;
+    if (conf->GetStringValue("fuseClient.dCacheEvictPolicy",
+                             &dCacheEvictPolicy)) {
+        if (dCacheEvictPolicy == "clock") {
+            clientOption->dCacheEvictPolicy = CacheEvictPolicy::CLOCK;
+        } else if (dCacheEvictPolicy == "lru") {
+            clientOption->dCacheEvictPolicy = CacheEvictPolicy::LRU;
+        } else {
+            LOG(WARNING) << "Unknown `fuseClient.dCacheEvictPolicy` "
+                         << dCacheEvictPolicy << ", use lru";
+        }
+    }
+
     LOG_IF(WARNING, conf->GetBoolValue("fuseClient.enableSplice",
                                        &clientOption->enableFuseSplice))
         << "Not found `fuseClient.enableSplice` in conf, use default value `"
@@ -30,8 +30,10 @@
 #include "curvefs/proto/common.pb.h"
 #include "src/client/config_info.h"
 #include "src/common/configuration.h"
+#include "src/common/lru_cache.h"
 #include "src/common/s3_adapter.h"
 
+using ::curve::common::CacheEvictPolicy;
 using ::curve::common::Configuration;
 using ::curve::common::S3AdapterOption;
 using ::curvefs::client::common::DiskCacheType;
@@ -45,7 +47,6 @@ using MdsOption = ::curve::client::MetaServerOption;
 
 struct BlockDeviceClientOptions {
     std::string configPath;
-    uint32_t threadnum;
 };
 
 struct MetaCacheOpt {
@@ -115,6 +116,12 @@ struct DiskCacheOption {
     uint64_t avgFlushIops;
     // the read throttle iops of disk cache
     uint64_t avgReadFileIops;
+    // segment size of the log-structured read cache,
+    // 0 means every object is stored in its own file
+    uint64_t slabSegmentSize = 0;
+    // compact a segment of the read cache if its live data
+    // is below the percent
+    uint32_t slabCompactRatio = 50;
 };
 
 struct S3ClientAdaptorOption {
@@ -122,7 +129,10 @@ struct S3ClientAdaptorOption {
     uint64_t chunkSize;
     uint32_t fuseMaxSize;
     uint64_t pageSize;
+    // initial readahead window in blocks
     uint32_t prefetchBlocks;
+    // readahead window grows up to this for sequential reads
+    uint32_t prefetchMaxBlocks = 16;
     uint32_t prefetchExecQueueNum;
     uint32_t intervalSec;
     uint32_t chunkFlushThreads;
@@ -133,6 +143,9 @@ struct S3ClientAdaptorOption {
     uint32_t baseSleepUs;
     uint32_t maxReadRetryIntervalMs;
     uint32_t readRetryIntervalMs;
+    // resolve the s3chunkinfos of a chunk by metaserver when its list is
+    // longer than this, 0 means never
+    uint32_t rangeReadS3ChunkInfoThreshold = 0;
     DiskCacheOption diskCacheOpt;
 };
 
@@ -165,6 +178,7 @@ struct VolumeOption {
 
 struct ExtentManagerOption {
     uint64_t preAllocSize;
+    uint64_t maxPreAllocSize;
 };
 
 struct FuseClientOption {
@@ -189,6 +203,8 @@ struct FuseClientOption {
     uint64_t dCacheLruSize;
     bool enableICacheMetrics;
     bool enableDCacheMetrics;
+    uint32_t dCacheShardNum = 1;
+    CacheEvictPolicy dCacheEvictPolicy = CacheEvictPolicy::LRU;
     uint32_t dummyServerStartPort;
     bool enableMultiMountPointRename = false;
     bool enableFuseSplice = false;
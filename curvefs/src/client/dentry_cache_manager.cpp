@@ -124,14 +124,33 @@ CURVEFS_ERROR DentryCacheManagerImpl::ListDentry(uint64_t parent,
                                                  std::list<Dentry> *dentryList,
                                                  uint32_t limit,
                                                  bool onlyDir) {
+    return ListDentryInternal(parent, dentryList, limit, onlyDir, nullptr);
+}
+
+CURVEFS_ERROR DentryCacheManagerImpl::ListDentryPlus(
+    uint64_t parent, std::list<Dentry> *dentryList, uint32_t limit,
+    std::list<InodeAttr> *attrs) {
+    attrs->clear();
+    return ListDentryInternal(parent, dentryList, limit, false, attrs);
+}
+
+CURVEFS_ERROR DentryCacheManagerImpl::ListDentryInternal(
+    uint64_t parent, std::list<Dentry> *dentryList, uint32_t limit,
+    bool onlyDir, std::list<InodeAttr> *attrs) {
     bool perceed = true;
     MetaStatusCode ret = MetaStatusCode::OK;
     dentryList->clear();
     std::string last = "";
     do {
         std::list<Dentry> part;
-        ret = metaClient_->ListDentry(fsId_, parent, last, limit, onlyDir,
-                                      &part);
+        std::list<InodeAttr> partAttrs;
+        if (attrs != nullptr) {
+            ret = metaClient_->ListDentryPlus(fsId_, parent, last, limit,
+                                              &part, &partAttrs);
+        } else {
+            ret = metaClient_->ListDentry(fsId_, parent, last, limit,
+                                          onlyDir, &part);
+        }
         VLOG(6) << "ListDentry fsId = " << fsId_ << ", parent = " << parent
                 << ", last = " << last << ", count = " << limit
                 << ", onlyDir = " << onlyDir
@@ -154,6 +173,9 @@ CURVEFS_ERROR DentryCacheManagerImpl::ListDentry(uint64_t parent,
             last = part.back().name();
             dentryList->splice(dentryList->end(), part);
         }
+        if (attrs != nullptr) {
+            attrs->splice(attrs->end(), partAttrs);
+        }
     } while (perceed);
 
     return CURVEFS_ERROR::OK;
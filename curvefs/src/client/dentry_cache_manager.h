@@ -39,7 +39,10 @@
 #include "src/common/concurrent/name_lock.h"
 
 using ::curvefs::metaserver::Dentry;
-using ::curve::common::LRUCache;
+using ::curvefs::metaserver::InodeAttr;
+using ::curve::common::LRUCacheInterface;
+using ::curve::common::ShardedLRUCache;
+using ::curve::common::CacheEvictPolicy;
 using ::curve::common::CacheMetrics;
 
 namespace curvefs {
@@ -59,7 +62,9 @@ class DentryCacheManager {
         fsId_ = fsId;
     }
 
-    virtual CURVEFS_ERROR Init(uint64_t cacheSize, bool enableCacheMetrics) = 0;
+    virtual CURVEFS_ERROR Init(uint64_t cacheSize, bool enableCacheMetrics,
+                               uint32_t shardNum,
+                               CacheEvictPolicy policy) = 0;
 
     virtual void InsertOrReplaceCache(const Dentry& dentry) = 0;
 
@@ -78,6 +83,12 @@ class DentryCacheManager {
         std::list<Dentry> *dentryList, uint32_t limit,
         bool onlyDir = false) = 0;
 
+    // list dentrys with the attrs returned together by metaserver, the attrs
+    // of the inodes not in the same partition with the parent are missing
+    virtual CURVEFS_ERROR ListDentryPlus(uint64_t parent,
+        std::list<Dentry> *dentryList, uint32_t limit,
+        std::list<InodeAttr> *attrs) = 0;
+
  protected:
     uint32_t fsId_;
 };
@@ -93,14 +104,16 @@ class DentryCacheManagerImpl : public DentryCacheManager {
       : metaClient_(metaClient),
         dCache_(nullptr) {}
 
-    CURVEFS_ERROR Init(uint64_t cacheSize, bool enableCacheMetrics) override {
+    CURVEFS_ERROR Init(uint64_t cacheSize, bool enableCacheMetrics,
+                       uint32_t shardNum, CacheEvictPolicy policy) override {
         if (enableCacheMetrics) {
             dCache_ = std::make_shared<
-                LRUCache<std::string, Dentry>>(cacheSize,
-                    std::make_shared<CacheMetrics>("dcache"));
+                ShardedLRUCache<std::string, Dentry>>(cacheSize, shardNum,
+                    policy, std::make_shared<CacheMetrics>("dcache"));
         } else {
             dCache_ = std::make_shared<
-                LRUCache<std::string, Dentry>>(cacheSize);
+                ShardedLRUCache<std::string, Dentry>>(cacheSize, shardNum,
+                    policy);
         }
         return CURVEFS_ERROR::OK;
     }
@@ -122,14 +135,23 @@ class DentryCacheManagerImpl : public DentryCacheManager {
         std::list<Dentry> *dentryList, uint32_t limit,
         bool dirOnly = false) override;
 
+    CURVEFS_ERROR ListDentryPlus(uint64_t parent,
+        std::list<Dentry> *dentryList, uint32_t limit,
+        std::list<InodeAttr> *attrs) override;
+
     std::string GetDentryCacheKey(uint64_t parent, const std::string &name) {
         return std::to_string(parent) + kDentryKeyDelimiter + name;
     }
 
+ private:
+    CURVEFS_ERROR ListDentryInternal(uint64_t parent,
+        std::list<Dentry> *dentryList, uint32_t limit,
+        bool onlyDir, std::list<InodeAttr> *attrs);
+
  private:
     std::shared_ptr<MetaServerClient> metaClient_;
     // key is parentId + name
-    std::shared_ptr<LRUCache<std::string, Dentry>> dCache_;
+    std::shared_ptr<LRUCacheInterface<std::string, Dentry>> dCache_;
     curve::common::GenericNameLock<Mutex> nameLock_;
 };
 
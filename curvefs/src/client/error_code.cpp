@@ -78,6 +78,10 @@ CURVEFS_ERROR MetaStatusCodeToCurvefsErrCode(
             ret = CURVEFS_ERROR::EXISTS;
             break;
 
+        case MetaStatusCode::RPC_NOT_SUPPORTED:
+            ret = CURVEFS_ERROR::NOTSUPPORT;
+            break;
+
         case MetaStatusCode::SYM_LINK_EMPTY:
         case MetaStatusCode::RPC_ERROR:
             ret = CURVEFS_ERROR::INTERNAL;
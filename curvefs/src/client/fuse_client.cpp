@@ -122,8 +122,10 @@ CURVEFS_ERROR FuseClient::Init(const FuseClientOption &option) {
         return ret3;
     }
 
-    ret3 =
-        dentryManager_->Init(option.dCacheLruSize, option.enableDCacheMetrics);
+    ret3 = dentryManager_->Init(option.dCacheLruSize,
+                                option.enableDCacheMetrics,
+                                option.dCacheShardNum,
+                                option.dCacheEvictPolicy);
     if (ret3 != CURVEFS_ERROR::OK) {
         return ret3;
     }
@@ -681,10 +683,18 @@ CURVEFS_ERROR FuseClient::FuseOpReadDirPlus(fuse_req_t req, fuse_ino_t ino,
     DirBufferHead *bufHead = dirBuf_->DirBufferGet(dindex);
     if (!bufHead->wasRead) {
         std::list<Dentry> dentryList;
+        std::list<InodeAttr> attrs;
         std::set<uint64_t> inodeIds;
         std::map<uint64_t, InodeAttr> inodeAttrMap;
         auto limit = option_.listDentryLimit;
-        ret = dentryManager_->ListDentry(ino, &dentryList, limit);
+        // the attrs of inodes in the same partition with the parent
+        // are returned by the metaserver together with the dentrys
+        if (cacheDir) {
+            ret = dentryManager_->ListDentryPlus(ino, &dentryList, limit,
+                                                 &attrs);
+        } else {
+            ret = dentryManager_->ListDentry(ino, &dentryList, limit);
+        }
         if (ret != CURVEFS_ERROR::OK) {
             LOG(ERROR) << "dentryManager_ ListDentry fail, ret = " << ret
                        << ", parent = " << ino;
@@ -696,16 +706,36 @@ CURVEFS_ERROR FuseClient::FuseOpReadDirPlus(fuse_req_t req, fuse_ino_t ino,
                 dirbuf_add(req, bufHead, dentry, option_, cacheDir);
             }
         } else {
+            // keep them in the attr cache of the parent like the ones got
+            // by BatchGetInodeAttrAsync, so they are not fetched again
+            RepeatedPtrField<InodeAttr> cachedAttrs;
+            for (auto &attr : attrs) {
+                uint64_t inodeId = attr.inodeid();
+                *cachedAttrs.Add() = attr;
+                inodeAttrMap.emplace(inodeId, std::move(attr));
+            }
+            if (!cachedAttrs.empty()) {
+                inodeManager_->AddInodeAttrs(ino, cachedAttrs);
+            }
             for (const auto &dentry : dentryList) {
-                inodeIds.emplace(dentry.inodeid());
+                if (inodeAttrMap.find(dentry.inodeid()) ==
+                    inodeAttrMap.end()) {
+                    inodeIds.emplace(dentry.inodeid());
+                }
             }
-            VLOG(3) << "batch get inode size = " << inodeIds.size();
-            ret = inodeManager_->BatchGetInodeAttrAsync(ino, inodeIds,
-                                                        &inodeAttrMap);
-            if (ret != CURVEFS_ERROR::OK) {
-                LOG(ERROR) << "BatchGetInodeAttr failed when FuseOpReadDir"
-                           << ", parentId = " << ino;
-                return ret;
+            VLOG(3) << "attr from list dentry size = " << inodeAttrMap.size()
+                    << ", batch get inode size = " << inodeIds.size();
+            if (!inodeIds.empty()) {
+                std::map<uint64_t, InodeAttr> batchAttrMap;
+                ret = inodeManager_->BatchGetInodeAttrAsync(ino, inodeIds,
+                                                            &batchAttrMap);
+                if (ret != CURVEFS_ERROR::OK) {
+                    LOG(ERROR) << "BatchGetInodeAttr failed when "
+                               << "FuseOpReadDir, parentId = " << ino;
+                    return ret;
+                }
+                inodeAttrMap.insert(batchAttrMap.begin(),
+                                    batchAttrMap.end());
             }
 
             for (const auto &dentry : dentryList) {
@@ -56,7 +56,6 @@ CURVEFS_ERROR FuseVolumeClient::Init(const FuseClientOption &option) {
 
     BlockDeviceClientOptions opts;
     opts.configPath = option.bdevOpt.configPath;
-    opts.threadnum = option.bdevOpt.threadnum;
 
     bool ret2 = blockDeviceClient_->Init(opts);
 
@@ -121,6 +120,8 @@ CURVEFS_ERROR FuseVolumeClient::FuseOpInit(void *userdata,
     ExtentCacheOption extentOpt;
     extentOpt.blockSize = vol.blocksize();
     extentOpt.sliceSize = vol.slicesize();
+    extentOpt.preAllocSize = option_.extentManagerOpt.preAllocSize;
+    extentOpt.maxPreAllocSize = option_.extentManagerOpt.maxPreAllocSize;
 
     ExtentCache::SetOption(extentOpt);
 
@@ -310,6 +311,20 @@ CURVEFS_ERROR FuseVolumeClient::FuseOpFlush(fuse_req_t req, fuse_ino_t ino,
     return ret ? CURVEFS_ERROR::OK : CURVEFS_ERROR::IO_ERROR;
 }
 
+CURVEFS_ERROR FuseVolumeClient::FuseOpRelease(fuse_req_t req, fuse_ino_t ino,
+                                              struct fuse_file_info *fi) {
+    auto ret = FuseClient::FuseOpRelease(req, ino, fi);
+    if (ret != CURVEFS_ERROR::OK) {
+        return ret;
+    }
+
+    // failing to release preallocated space only leaks space, so don't fail
+    // the release
+    LOG_IF(ERROR, !storage_->Release(ino))
+        << "Release unwritten space error, ino: " << ino;
+    return ret;
+}
+
 void FuseVolumeClient::FlushData() {
     // TODO(xuchaojie) : flush volume data
 }
@@ -229,6 +229,34 @@ CURVEFS_ERROR InodeWrapper::RefreshS3ChunkInfo() {
     return CURVEFS_ERROR::OK;
 }
 
+CURVEFS_ERROR InodeWrapper::GetS3ChunkInfoRangeLocked(
+    uint64_t chunkIndex, uint64_t offset, uint64_t len,
+    S3ChunkInfoSlices *slices) {
+    // the slices of metaserver miss the s3chunkinfos not synced yet
+    if (!s3ChunkInfoAdd_.empty()) {
+        return CURVEFS_ERROR::NOFLUSH;
+    }
+    {
+        std::unique_lock<::curve::common::Mutex> lock(syncingS3ChunkInfoMtx_,
+                                                      std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return CURVEFS_ERROR::NOFLUSH;
+        }
+    }
+
+    MetaStatusCode ret = metaClient_->GetS3ChunkInfoRange(
+        inode_.fsid(), inode_.inodeid(), chunkIndex, offset, len, slices);
+    if (ret != MetaStatusCode::OK) {
+        LOG(WARNING) << "metaClient_ GetS3ChunkInfoRange failed, "
+                     << "MetaStatusCode: " << ret
+                     << ", MetaStatusCode_Name: " << MetaStatusCode_Name(ret)
+                     << ", inodeid: " << inode_.inodeid()
+                     << ", chunkIndex: " << chunkIndex;
+        return MetaStatusCodeToCurvefsErrCode(ret);
+    }
+    return CURVEFS_ERROR::OK;
+}
+
 CURVEFS_ERROR InodeWrapper::LinkLocked(uint64_t parent) {
     curve::common::UniqueLock lg(mtx_);
     REFRESH_NLINK_IF_NEED;
@@ -67,6 +67,7 @@ const uint32_t kOptimalIOBlockSize = 0x10000u;
 
 using rpcclient::MetaServerClient;
 using rpcclient::MetaServerClientImpl;
+using rpcclient::S3ChunkInfoSlices;
 
 std::ostream &operator<<(std::ostream &os, const struct stat &attr);
 void AppendS3ChunkInfoToMap(uint64_t chunkIndex, const S3ChunkInfo &info,
@@ -267,6 +268,17 @@ class InodeWrapper : public std::enable_shared_from_this<InodeWrapper> {
 
     CURVEFS_ERROR RefreshS3ChunkInfo();
 
+    /**
+     * @brief get the visible s3chunkinfo slices of file range
+     *        [offset, offset + len) in the chunk from metaserver,
+     *        caller should hold the inode lock
+     * @return NOFLUSH if some s3chunkinfos are not synced to metaserver,
+     *         NOTSUPPORT if metaserver not support the rpc
+     */
+    CURVEFS_ERROR GetS3ChunkInfoRangeLocked(uint64_t chunkIndex,
+                                            uint64_t offset, uint64_t len,
+                                            S3ChunkInfoSlices *slices);
+
     CURVEFS_ERROR Open();
 
     bool IsOpen();
@@ -78,6 +78,7 @@ struct MetaServerClientMetric {
     InterfaceMetric deleteInode;
     InterfaceMetric createRootInode;
     InterfaceMetric appendS3ChunkInfo;
+    InterfaceMetric getS3ChunkInfoRange;
 
     // tnx
     InterfaceMetric prepareRenameTx;
@@ -105,6 +106,7 @@ struct MetaServerClientMetric {
           deleteInode(prefix, "deleteInode"),
           createRootInode(prefix, "createRootInode"),
           appendS3ChunkInfo(prefix, "appendS3ChunkInfo"),
+          getS3ChunkInfoRange(prefix, "getS3ChunkInfoRange"),
           prepareRenameTx(prefix, "prepareRenameTx"),
           createPartition(prefix, "createPartition"),
           updateVolumeExtent(prefix, "updateVolumeExtent"),
@@ -242,6 +244,12 @@ struct S3Metric {
     InterfaceMetric adaptorReadDiskCache;
     bvar::LatencyRecorder readSize;
     bvar::LatencyRecorder writeSize;
+    // blocks issued to prefetch into disk cache
+    bvar::Adder<uint64_t> prefetchBlocks;
+    // prefetched blocks that are read later
+    bvar::Adder<uint64_t> prefetchHit;
+    // prefetched blocks that are evicted or released before read
+    bvar::Adder<uint64_t> prefetchWaste;
 
     explicit S3Metric(const std::string &name = "")
         : fsName(!name.empty() ? name
@@ -253,7 +261,10 @@ struct S3Metric {
           adaptorReadS3(prefix, fsName + "_adaptor_read_s3"),
           adaptorReadDiskCache(prefix, fsName + "_adaptor_read_disk_cache"),
           readSize(prefix, fsName + "_adaptor_read_size"),
-          writeSize(prefix, fsName + "_adaptor_write_size") {}
+          writeSize(prefix, fsName + "_adaptor_write_size"),
+          prefetchBlocks(prefix, fsName + "_adaptor_prefetch_blocks"),
+          prefetchHit(prefix, fsName + "_adaptor_prefetch_hit"),
+          prefetchWaste(prefix, fsName + "_adaptor_prefetch_waste") {}
 };
 
 struct DiskCacheMetric {
@@ -62,6 +62,7 @@ using GetInodeExcutor = TaskExecutor;
 using BatchGetInodeAttrExcutor = TaskExecutor;
 using BatchGetXAttrExcutor = TaskExecutor;
 using GetOrModifyS3ChunkInfoExcutor = TaskExecutor;
+using GetS3ChunkInfoRangeExecutor = TaskExecutor;
 using UpdateVolumeExtentExecutor = TaskExecutor;
 using GetVolumeExtentExecutor = TaskExecutor;
 
@@ -185,6 +186,21 @@ MetaStatusCode MetaServerClientImpl::ListDentry(uint32_t fsId, uint64_t inodeid,
                                                 uint32_t count,
                                                 bool onlyDir,
                                                 std::list<Dentry> *dentryList) {
+    return ListDentryInternal(fsId, inodeid, last, count, onlyDir,
+                              dentryList, nullptr);
+}
+
+MetaStatusCode MetaServerClientImpl::ListDentryPlus(
+    uint32_t fsId, uint64_t inodeid, const std::string &last, uint32_t count,
+    std::list<Dentry> *dentryList, std::list<InodeAttr> *attrs) {
+    return ListDentryInternal(fsId, inodeid, last, count, false,
+                              dentryList, attrs);
+}
+
+MetaStatusCode MetaServerClientImpl::ListDentryInternal(
+    uint32_t fsId, uint64_t inodeid, const std::string &last, uint32_t count,
+    bool onlyDir, std::list<Dentry> *dentryList,
+    std::list<InodeAttr> *attrs) {
     auto task = RPCTask {
         metric_.listDentry.qps.count << 1;
         LatencyUpdater updater(&metric_.listDentry.latency);
@@ -200,6 +216,9 @@ MetaStatusCode MetaServerClientImpl::ListDentry(uint32_t fsId, uint64_t inodeid,
         request.set_count(count);
         request.set_onlydir(onlyDir);
         request.set_appliedindex(applyIndex);
+        if (attrs != nullptr) {
+            request.set_needattr(true);
+        }
 
         curvefs::metaserver::MetaServerService_Stub stub(channel);
         stub.ListDentry(cntl, &request, &response, nullptr);
@@ -228,6 +247,11 @@ MetaStatusCode MetaServerClientImpl::ListDentry(uint32_t fsId, uint64_t inodeid,
             auto dentrys = response.dentrys();
             for_each(dentrys.begin(), dentrys.end(),
                      [&](Dentry &d) { dentryList->push_back(d); });
+            if (attrs != nullptr) {
+                for (const auto &attr : response.attrs()) {
+                    attrs->push_back(attr);
+                }
+            }
         } else {
             LOG(WARNING)
                 << "ListDentry: fsId = " << fsId << ", inodeid = " << inodeid
@@ -1193,6 +1217,66 @@ void MetaServerClientImpl::GetOrModifyS3ChunkInfoAsync(
     excutor->DoAsyncRPCTask(taskDone);
 }
 
+MetaStatusCode MetaServerClientImpl::GetS3ChunkInfoRange(
+    uint32_t fsId, uint64_t inodeId, uint64_t chunkIndex, uint64_t offset,
+    uint64_t len, S3ChunkInfoSlices *slices) {
+    auto task = RPCTask {
+        (void)txId;
+        (void)taskExecutorDone;
+        metric_.getS3ChunkInfoRange.qps.count << 1;
+        LatencyUpdater updater(&metric_.getS3ChunkInfoRange.latency);
+        metaserver::GetS3ChunkInfoRangeRequest request;
+        metaserver::GetS3ChunkInfoRangeResponse response;
+        request.set_poolid(poolID);
+        request.set_copysetid(copysetID);
+        request.set_partitionid(partitionID);
+        request.set_fsid(fsId);
+        request.set_inodeid(inodeId);
+        request.set_chunkindex(chunkIndex);
+        request.set_offset(offset);
+        request.set_len(len);
+        request.set_appliedindex(applyIndex);
+
+        MetaServerService_Stub stub(channel);
+        stub.GetS3ChunkInfoRange(cntl, &request, &response, nullptr);
+
+        if (cntl->Failed()) {
+            metric_.getS3ChunkInfoRange.eps.count << 1;
+            LOG(WARNING) << "GetS3ChunkInfoRange failed, error: "
+                         << cntl->ErrorText() << ", log id: " << cntl->log_id();
+            // metaserver of old version, no need to retry
+            if (cntl->ErrorCode() == brpc::ENOMETHOD) {
+                return MetaStatusCode::RPC_NOT_SUPPORTED;
+            }
+            return -cntl->ErrorCode();
+        }
+
+        auto st = response.statuscode();
+        if (st != MetaStatusCode::OK) {
+            metric_.getS3ChunkInfoRange.eps.count << 1;
+            LOG(WARNING) << "GetS3ChunkInfoRange failed, inodeId: " << inodeId
+                         << ", chunkIndex: " << chunkIndex
+                         << ", error: " << MetaStatusCode_Name(st);
+            return st;
+        } else if (response.has_appliedindex()) {
+            metaCache_->UpdateApplyIndex(CopysetGroupID(poolID, copysetID),
+                                         response.appliedindex());
+        }
+
+        slices->Swap(response.mutable_slices());
+        VLOG(9) << "GetS3ChunkInfoRange success, inodeId: " << inodeId
+                << ", chunkIndex: " << chunkIndex << ", offset: " << offset
+                << ", len: " << len << ", slices: " << slices->size();
+        return st;
+    };
+
+    auto taskCtx = std::make_shared<TaskContext>(
+        MetaServerOpType::GetS3ChunkInfoRange, task, fsId, inodeId);
+    GetS3ChunkInfoRangeExecutor executor(opt_, metaCache_, channelManager_,
+                                         std::move(taskCtx));
+    return ConvertToMetaStatusCode(executor.DoRPCTask());
+}
+
 MetaStatusCode MetaServerClientImpl::CreateInode(const InodeParam &param,
                                                  Inode *out) {
     auto task = RPCTask {
@@ -57,6 +57,8 @@ namespace client {
 namespace rpcclient {
 
 using S3ChunkInfoMap = google::protobuf::Map<uint64_t, S3ChunkInfoList>;
+using S3ChunkInfoSlices =
+    google::protobuf::RepeatedPtrField<::curvefs::metaserver::S3ChunkInfoSlice>;
 using ::curvefs::metaserver::VolumeExtentList;
 
 class MetaServerClient {
@@ -81,6 +83,13 @@ class MetaServerClient {
                                       bool onlyDir,
                                       std::list<Dentry> *dentryList) = 0;
 
+    // list dentrys with the attrs of inodes in the same partition
+    virtual MetaStatusCode ListDentryPlus(uint32_t fsId, uint64_t inodeid,
+                                          const std::string &last,
+                                          uint32_t count,
+                                          std::list<Dentry> *dentryList,
+                                          std::list<InodeAttr> *attrs) = 0;
+
     virtual MetaStatusCode CreateDentry(const Dentry &dentry) = 0;
 
     virtual MetaStatusCode DeleteDentry(uint32_t fsId, uint64_t inodeid,
@@ -141,6 +150,15 @@ class MetaServerClient {
             uint64_t, S3ChunkInfoList> &s3ChunkInfos,
         MetaServerClientDone *done) = 0;
 
+    // get the visible s3chunkinfo slices of the chunk in
+    // [offset, offset + len), which are resolved by metaserver
+    virtual MetaStatusCode GetS3ChunkInfoRange(uint32_t fsId,
+                                               uint64_t inodeId,
+                                               uint64_t chunkIndex,
+                                               uint64_t offset,
+                                               uint64_t len,
+                                               S3ChunkInfoSlices *slices) = 0;
+
     virtual MetaStatusCode CreateInode(const InodeParam &param, Inode *out) = 0;
 
     virtual MetaStatusCode DeleteInode(uint32_t fsId, uint64_t inodeid) = 0;
@@ -183,6 +201,11 @@ class MetaServerClientImpl : public MetaServerClient {
                               bool onlyDir,
                               std::list<Dentry> *dentryList) override;
 
+    MetaStatusCode ListDentryPlus(uint32_t fsId, uint64_t inodeid,
+                                  const std::string &last, uint32_t count,
+                                  std::list<Dentry> *dentryList,
+                                  std::list<InodeAttr> *attrs) override;
+
     MetaStatusCode CreateDentry(const Dentry &dentry) override;
 
     MetaStatusCode DeleteDentry(uint32_t fsId, uint64_t inodeid,
@@ -242,6 +265,13 @@ class MetaServerClientImpl : public MetaServerClient {
             uint64_t, S3ChunkInfoList> &s3ChunkInfos,
         MetaServerClientDone *done) override;
 
+    MetaStatusCode GetS3ChunkInfoRange(uint32_t fsId,
+                                       uint64_t inodeId,
+                                       uint64_t chunkIndex,
+                                       uint64_t offset,
+                                       uint64_t len,
+                                       S3ChunkInfoSlices *slices) override;
+
     MetaStatusCode CreateInode(const InodeParam &param, Inode *out) override;
 
     MetaStatusCode DeleteInode(uint32_t fsId, uint64_t inodeid) override;
@@ -261,6 +291,12 @@ class MetaServerClientImpl : public MetaServerClient {
                                    VolumeExtentList *extents) override;
 
  private:
+    MetaStatusCode ListDentryInternal(uint32_t fsId, uint64_t inodeid,
+                                      const std::string &last,
+                                      uint32_t count, bool onlyDir,
+                                      std::list<Dentry> *dentryList,
+                                      std::list<InodeAttr> *attrs);
+
     MetaStatusCode UpdateInode(const UpdateInodeRequest &request,
                                bool internal = false);
 
@@ -52,6 +52,7 @@ S3ClientAdaptorImpl::Init(
     }
     fuseMaxSize_ = option.fuseMaxSize;
     prefetchBlocks_ = option.prefetchBlocks;
+    prefetchMaxBlocks_ = std::max(option.prefetchMaxBlocks, prefetchBlocks_);
     prefetchExecQueueNum_ = option.prefetchExecQueueNum;
     diskCacheType_ = option.diskCacheOpt.diskCacheType;
     memCacheNearfullRatio_ = option.nearfullRatio;
@@ -60,6 +61,7 @@ S3ClientAdaptorImpl::Init(
     chunkFlushThreads_ = option.chunkFlushThreads;
     maxReadRetryIntervalMs_ = option.maxReadRetryIntervalMs;
     readRetryIntervalMs_ = option.readRetryIntervalMs;
+    rangeReadS3ChunkInfoThreshold_ = option.rangeReadS3ChunkInfoThreshold;
     client_ = client;
     inodeManager_ = inodeManager;
     mdsClient_ = mdsClient;
@@ -91,13 +93,16 @@ S3ClientAdaptorImpl::Init(
     LOG(INFO) << "S3ClientAdaptorImpl Init. block size:" << blockSize_
               << ", chunk size: " << chunkSize_
               << ", prefetchBlocks: " << prefetchBlocks_
+              << ", prefetchMaxBlocks: " << prefetchMaxBlocks_
               << ", prefetchExecQueueNum: " << prefetchExecQueueNum_
               << ", intervalSec: " << option.intervalSec
               << ", flushIntervalSec: " << option.flushIntervalSec
               << ", writeCacheMaxByte: " << option.writeCacheMaxByte
               << ", readCacheMaxByte: " << option.readCacheMaxByte
               << ", nearfullRatio: " << option.nearfullRatio
-              << ", baseSleepUs: " << option.baseSleepUs;
+              << ", baseSleepUs: " << option.baseSleepUs
+              << ", rangeReadS3ChunkInfoThreshold: "
+              << option.rangeReadS3ChunkInfoThreshold;
     // start chunk flush threads
     taskPool_.Start(chunkFlushThreads_);
     return CURVEFS_ERROR::OK;
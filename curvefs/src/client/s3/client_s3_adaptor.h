@@ -149,6 +149,9 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
     uint32_t GetPrefetchBlocks() {
         return prefetchBlocks_;
     }
+    uint32_t GetPrefetchMaxBlocks() {
+        return prefetchMaxBlocks_;
+    }
     uint32_t GetDiskCacheType() {
         return diskCacheType_;
     }
@@ -205,6 +208,15 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
         return readRetryIntervalMs_;
     }
 
+    uint32_t GetRangeReadS3ChunkInfoThreshold() const {
+        return rangeReadS3ChunkInfoThreshold_.load(std::memory_order_relaxed);
+    }
+
+    // metaserver not support GetS3ChunkInfoRange, always walk the list
+    void DisableRangeReadS3ChunkInfo() {
+        rangeReadS3ChunkInfoThreshold_.store(0, std::memory_order_relaxed);
+    }
+
  private:
     void BackGroundFlush();
 
@@ -236,6 +248,7 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
     uint64_t chunkSize_;
     uint32_t fuseMaxSize_;
     uint32_t prefetchBlocks_;
+    uint32_t prefetchMaxBlocks_;
     uint32_t prefetchExecQueueNum_;
     std::string allocateServerEps_;
     uint32_t flushIntervalSec_;
@@ -244,6 +257,7 @@ class S3ClientAdaptorImpl : public S3ClientAdaptor {
     uint32_t throttleBaseSleepUs_;
     uint32_t maxReadRetryIntervalMs_;
     uint32_t readRetryIntervalMs_;
+    std::atomic<uint32_t> rangeReadS3ChunkInfoThreshold_{0};
     Thread bgFlushThread_;
     std::atomic<bool> toStop_;
     std::mutex mtx_;
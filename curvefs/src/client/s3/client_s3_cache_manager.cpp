@@ -23,6 +23,7 @@
 #include "curvefs/src/client/s3/client_s3_cache_manager.h"
 
 #include <bvar/bvar.h>
+#include <iterator>
 #include <utility>
 
 #include "curvefs/src/client/s3/client_s3_adaptor.h"
@@ -300,6 +301,13 @@ FileCacheManager::FindOrCreateChunkCacheManager(uint64_t index) {
     return chunkCacheManager;
 }
 
+FileCacheManager::FileCacheManager(uint32_t fsid, uint64_t inode,
+                                   S3ClientAdaptorImpl *s3ClientAdaptor)
+    : fsId_(fsid), inode_(inode), s3ClientAdaptor_(s3ClientAdaptor),
+      readahead_(s3ClientAdaptor->GetBlockSize(),
+                 s3ClientAdaptor->GetPrefetchBlocks(),
+                 s3ClientAdaptor->GetPrefetchMaxBlocks()) {}
+
 int FileCacheManager::Read(uint64_t inodeId, uint64_t offset, uint64_t length,
                            char *dataBuf) {
     uint64_t chunkSize = s3ClientAdaptor_->GetChunkSize();
@@ -309,6 +317,9 @@ int FileCacheManager::Read(uint64_t inodeId, uint64_t offset, uint64_t length,
     int ret = 0;
     uint64_t readOffset = 0;
     std::vector<ReadRequest> totalRequests;
+    const uint64_t readEnd = offset + length;
+
+    readahead_.OnRead(offset, length);
 
     //  Find offset~len in the write and read cache,
     //  and The parts that are not in the cache are placed in the totalRequests
@@ -374,9 +385,22 @@ int FileCacheManager::Read(uint64_t inodeId, uint64_t offset, uint64_t length,
                         continue;
                     }
                     std::vector<S3ReadRequest> s3Requests;
-                    GenerateS3Request(*iter, s3InfoListIter->second, dataBuf,
-                                      &s3Requests, inode->fsid(),
-                                      inode->inodeid());
+                    uint32_t threshold =
+                        s3ClientAdaptor_->GetRangeReadS3ChunkInfoThreshold();
+                    bool byRange =
+                        threshold != 0 &&
+                        static_cast<uint32_t>(
+                            s3InfoListIter->second.s3chunks_size()) >
+                            threshold &&
+                        GenerateS3RequestByRange(inodeWrapper.get(), *iter,
+                                                 dataBuf, &s3Requests,
+                                                 inode->fsid(),
+                                                 inode->inodeid());
+                    if (!byRange) {
+                        GenerateS3Request(*iter, s3InfoListIter->second,
+                                          dataBuf, &s3Requests, inode->fsid(),
+                                          inode->inodeid());
+                    }
                     totalS3Requests.insert(totalS3Requests.end(),
                                            s3Requests.begin(),
                                            s3Requests.end());
@@ -438,6 +462,12 @@ int FileCacheManager::Read(uint64_t inodeId, uint64_t offset, uint64_t length,
                 break;
             }
         }
+
+        // prefetch read
+        if (s3ClientAdaptor_->HasDiskCache()) {
+            Readahead(inodeWrapper, readEnd);
+        }
+
         auto repIter = responses.begin();
         for (; repIter != responses.end(); repIter++) {
             VLOG(6) << "readOffset:" << repIter->GetReadOffset()
@@ -496,30 +526,6 @@ int FileCacheManager::ReadFromS3(const std::vector<S3ReadRequest> &requests,
                 << ",objectOffset:" << objectOffset << ",chunkid"
                 << iter->chunkId << ",fsid" << iter->fsId
                 << ",inodeId:" << iter->inodeId;
-        // prefetch read
-        if (s3ClientAdaptor_->HasDiskCache()) {
-            uint64_t blockIndexTmp = blockIndex;
-            // the counts of blocks that need prefetch
-            uint32_t prefetchBlocks = s3ClientAdaptor_->GetPrefetchBlocks();
-            std::vector<std::string> prefetchObjs;
-            for (int count = 0; count < prefetchBlocks; count++) {
-                std::string name = curvefs::common::s3util::GenObjName(
-                    iter->chunkId, blockIndexTmp, iter->compaction, iter->fsId,
-                    iter->inodeId);
-                prefetchObjs.push_back(name);
-                blockIndexTmp++;
-                uint64_t readLen = blockIndexTmp * blockSize;
-                if ((readLen > fileLen) ||
-                    (blockIndexTmp >= chunkSize / blockSize)) {
-                    VLOG(6) << "end, redLen :" << readLen
-                            << ", fileLen: " << fileLen << ", blockIndexTmp "
-                            << blockIndexTmp;
-                    break;
-                }
-            }
-            // prefetch object from s3
-            PrefetchS3Objs(prefetchObjs);
-        }
         while (len > 0) {
             if (blockPos + len > blockSize) {
                 n = blockSize - blockPos;
@@ -547,6 +553,7 @@ int FileCacheManager::ReadFromS3(const std::vector<S3ReadRequest> &requests,
                 if (s3ClientAdaptor_->HasDiskCache() &&
                     s3ClientAdaptor_->GetDiskCacheManager()->IsCached(name)) {
                     VLOG(9) << "cached in disk: " << name;
+                    CollectPrefetchHit(name, true);
                     ret = s3ClientAdaptor_->GetDiskCacheManager()->Read(
                         name, response.GetDataBuf() + readOffset,
                         blockPos - objectOffset, n);
@@ -557,6 +564,7 @@ int FileCacheManager::ReadFromS3(const std::vector<S3ReadRequest> &requests,
                     }
                 } else {
                     VLOG(9) << "not cached in disk: " << name;
+                    CollectPrefetchHit(name, false);
                     ret = s3ClientAdaptor_->GetS3Client()->Download(
                         name, response.GetDataBuf() + readOffset,
                         blockPos - objectOffset, n);
@@ -633,6 +641,8 @@ class AsyncPrefetchCallback {
 
         if (context->retCode != 0) {
             LOG(WARNING) << "prefetch failed, key: " << context->key;
+            curve::common::LockGuard lg(fileCache->downloadMtx_);
+            fileCache->downloadingObj_.erase(context->key);
             return;
         }
 
@@ -645,6 +655,9 @@ class AsyncPrefetchCallback {
         {
             curve::common::LockGuard lg(fileCache->downloadMtx_);
             fileCache->downloadingObj_.erase(context->key);
+            if (ret >= 0) {
+                fileCache->prefetchedObj_.emplace(context->key);
+            }
         }
     }
 
@@ -671,6 +684,9 @@ void FileCacheManager::PrefetchS3Objs(std::vector<std::string> prefetchObjs) {
         VLOG(9) << "download start: " << name
                 << ", size: " << downloadingObj_.size();
         downloadingObj_.emplace(name);
+        if (s3ClientAdaptor_->s3Metric_.get() != nullptr) {
+            s3ClientAdaptor_->s3Metric_->prefetchBlocks << 1;
+        }
 
         auto inode = inode_;
         auto s3ClientAdaptor = s3ClientAdaptor_;
@@ -691,6 +707,114 @@ void FileCacheManager::PrefetchS3Objs(std::vector<std::string> prefetchObjs) {
     return;
 }
 
+void FileCacheManager::Readahead(
+    const std::shared_ptr<InodeWrapper> &inodeWrapper, uint64_t readEnd) {
+    ReadaheadRange range = readahead_.GetReadaheadRange(readEnd);
+    if (range.Empty()) {
+        return;
+    }
+
+    uint64_t chunkSize = s3ClientAdaptor_->GetChunkSize();
+    std::vector<std::string> prefetchObjs;
+    {
+        ::curve::common::UniqueLock lgGuard = inodeWrapper->GetUniqueLock();
+        Inode *inode = inodeWrapper->GetMutableInodeUnlocked();
+        uint64_t end = std::min<uint64_t>(range.end, inode->length());
+        VLOG(6) << "readahead inode: " << inode_ << ", range: ["
+                << range.start << ", " << range.end << "), window: "
+                << readahead_.GetWindowBlocks()
+                << ", fileLen: " << inode->length();
+
+        // only the objects holding the visible data of the range exist,
+        // resolve them against the s3chunkinfo list as the read does
+        uint64_t offset = range.start;
+        while (offset < end) {
+            uint64_t index = offset / chunkSize;
+            uint64_t chunkEnd = std::min((index + 1) * chunkSize, end);
+            auto s3InfoListIter = inode->s3chunkinfomap().find(index);
+            if (s3InfoListIter != inode->s3chunkinfomap().end()) {
+                GenerateReadaheadObjs(s3InfoListIter->second, offset,
+                                      chunkEnd, inode->fsid(),
+                                      inode->inodeid(), &prefetchObjs);
+            }
+            offset = chunkEnd;
+        }
+    }
+
+    // prefetch object from s3
+    PrefetchS3Objs(std::move(prefetchObjs));
+}
+
+void FileCacheManager::GenerateReadaheadObjs(
+    const S3ChunkInfoList &s3ChunkInfoList, uint64_t start, uint64_t end,
+    uint64_t fsId, uint64_t inodeId, std::vector<std::string> *objs) {
+    uint64_t chunkSize = s3ClientAdaptor_->GetChunkSize();
+    uint64_t blockSize = s3ClientAdaptor_->GetBlockSize();
+    // parts of [start, end) not covered by the newer s3chunkinfos yet,
+    // begin => end
+    std::map<uint64_t, uint64_t> holes{{start, end}};
+    for (int i = s3ChunkInfoList.s3chunks_size() - 1;
+         i >= 0 && !holes.empty(); i--) {
+        const S3ChunkInfo &s3ChunkInfo = s3ChunkInfoList.s3chunks(i);
+        if (s3ChunkInfo.len() == 0) {
+            continue;
+        }
+        uint64_t infoStart = s3ChunkInfo.offset();
+        uint64_t infoEnd = s3ChunkInfo.offset() + s3ChunkInfo.len();
+        auto iter = holes.upper_bound(infoStart);
+        if (iter != holes.begin() && std::prev(iter)->second > infoStart) {
+            --iter;
+        }
+
+        std::set<uint64_t> blocks;
+        while (iter != holes.end() && iter->first < infoEnd) {
+            uint64_t holeStart = iter->first;
+            uint64_t holeEnd = iter->second;
+            uint64_t lo = std::max(holeStart, infoStart);
+            uint64_t hi = std::min(holeEnd, infoEnd);
+            iter = holes.erase(iter);
+            if (holeStart < lo) {
+                holes.emplace(holeStart, lo);
+            }
+            if (hi < holeEnd) {
+                holes.emplace(hi, holeEnd);
+            }
+            if (s3ChunkInfo.zero()) {
+                continue;
+            }
+            for (uint64_t b = lo % chunkSize / blockSize;
+                 b <= (hi - 1) % chunkSize / blockSize; b++) {
+                blocks.emplace(b);
+            }
+        }
+
+        for (auto b : blocks) {
+            objs->emplace_back(curvefs::common::s3util::GenObjName(
+                s3ChunkInfo.chunkid(), b, s3ChunkInfo.compaction(), fsId,
+                inodeId));
+        }
+    }
+}
+
+void FileCacheManager::CollectPrefetchHit(const std::string &name,
+                                          bool cached) {
+    {
+        curve::common::LockGuard lg(downloadMtx_);
+        if (prefetchedObj_.erase(name) == 0) {
+            return;
+        }
+    }
+
+    // a prefetched obj that is evicted before read is wasted
+    if (s3ClientAdaptor_->s3Metric_.get() != nullptr) {
+        if (cached) {
+            s3ClientAdaptor_->s3Metric_->prefetchHit << 1;
+        } else {
+            s3ClientAdaptor_->s3Metric_->prefetchWaste << 1;
+        }
+    }
+}
+
 void FileCacheManager::HandleReadRequest(
     const ReadRequest &request, const S3ChunkInfo &s3ChunkInfo,
     std::vector<ReadRequest> *addReadRequests,
@@ -933,6 +1057,69 @@ void FileCacheManager::GenerateS3Request(ReadRequest request,
 }
 
 
+bool FileCacheManager::GenerateS3RequestByRange(
+    InodeWrapper *inodeWrapper, const ReadRequest &request, char *dataBuf,
+    std::vector<S3ReadRequest> *requests, uint64_t fsId, uint64_t inodeId) {
+    uint64_t chunkSize = s3ClientAdaptor_->GetChunkSize();
+    uint64_t fileOffset = request.index * chunkSize + request.chunkPos;
+    uint64_t fileEnd = fileOffset + request.len;
+
+    S3ChunkInfoSlices slices;
+    CURVEFS_ERROR rc = inodeWrapper->GetS3ChunkInfoRangeLocked(
+        request.index, fileOffset, request.len, &slices);
+    if (rc == CURVEFS_ERROR::NOTSUPPORT) {
+        LOG(WARNING) << "metaserver not support GetS3ChunkInfoRange, "
+                     << "walk the s3chunkinfo list from now on";
+        s3ClientAdaptor_->DisableRangeReadS3ChunkInfo();
+        return false;
+    } else if (rc != CURVEFS_ERROR::OK) {
+        return false;
+    }
+
+    // the slices are ordered and not overlapped, each one is covered by its
+    // s3chunkinfo, and the gaps between them are holes
+    std::vector<S3ReadRequest> s3Requests;
+    uint64_t pos = fileOffset;
+    for (const auto &slice : slices) {
+        if (slice.offset() < pos || slice.offset() + slice.len() > fileEnd) {
+            LOG(WARNING) << "invalid slice, offset: " << slice.offset()
+                         << ", len: " << slice.len() << ", read offset: "
+                         << fileOffset << ", len: " << request.len;
+            return false;
+        }
+
+        ReadRequest sliceRequest;
+        sliceRequest.index = request.index;
+        sliceRequest.chunkPos = slice.offset() - request.index * chunkSize;
+        sliceRequest.len = slice.len();
+        sliceRequest.bufOffset = request.bufOffset + slice.offset() -
+                                 fileOffset;
+        std::vector<ReadRequest> addReadRequests;
+        std::vector<uint64_t> deletingReq;
+        HandleReadRequest(sliceRequest, slice.chunkinfo(), &addReadRequests,
+                          &deletingReq, &s3Requests, dataBuf, fsId, inodeId);
+        if (!addReadRequests.empty() || deletingReq.empty()) {
+            LOG(WARNING) << "slice is not covered by its s3chunkinfo, "
+                         << "offset: " << slice.offset()
+                         << ", len: " << slice.len() << ", s3chunkinfo: "
+                         << slice.chunkinfo().ShortDebugString();
+            return false;
+        }
+
+        memset(dataBuf + request.bufOffset + pos - fileOffset, 0,
+               slice.offset() - pos);
+        pos = slice.offset() + slice.len();
+    }
+    memset(dataBuf + request.bufOffset + pos - fileOffset, 0, fileEnd - pos);
+
+    VLOG(9) << "GenerateS3RequestByRange index:" << request.index
+            << ",chunkPos:" << request.chunkPos << ",len:" << request.len
+            << ",slices:" << slices.size()
+            << ",s3Requests:" << s3Requests.size();
+    requests->insert(requests->end(), s3Requests.begin(), s3Requests.end());
+    return true;
+}
+
 void FileCacheManager::ReleaseCache() {
     WriteLockGuard writeLockGuard(rwLock_);
 
@@ -943,6 +1130,17 @@ void FileCacheManager::ReleaseCache() {
 
     chunkCacheMap_.clear();
     g_s3MultiManagerMetric->chunkManagerNum << -1 * chunNum;
+
+    // prefetched objs that are never read
+    uint64_t wasted = 0;
+    {
+        curve::common::LockGuard lg(downloadMtx_);
+        wasted = prefetchedObj_.size();
+        prefetchedObj_.clear();
+    }
+    if (wasted != 0 && s3ClientAdaptor_->s3Metric_.get() != nullptr) {
+        s3ClientAdaptor_->s3Metric_->prefetchWaste << wasted;
+    }
     return;
 }
 
@@ -36,6 +36,7 @@
 #include "curvefs/proto/metaserver.pb.h"
 #include "curvefs/src/client/error_code.h"
 #include "curvefs/src/client/s3/client_s3.h"
+#include "curvefs/src/client/s3/client_s3_readahead.h"
 #include "curvefs/src/client/common/common.h"
 #include "src/common/concurrent/concurrent.h"
 #include "src/common/timeutility.h"
@@ -54,6 +55,7 @@ class FileCacheManager;
 class FsCacheManager;
 class DataCache;
 class S3ReadRequest;
+class InodeWrapper;
 using FileCacheManagerPtr = std::shared_ptr<FileCacheManager>;
 using ChunkCacheManagerPtr = std::shared_ptr<ChunkCacheManager>;
 using DataCachePtr = std::shared_ptr<DataCache>;
@@ -284,8 +286,7 @@ class ChunkCacheManager
 class FileCacheManager {
  public:
     FileCacheManager(uint32_t fsid, uint64_t inode,
-                     S3ClientAdaptorImpl *s3ClientAdaptor)
-        : fsId_(fsid), inode_(inode), s3ClientAdaptor_(s3ClientAdaptor) {}
+                     S3ClientAdaptorImpl *s3ClientAdaptor);
     FileCacheManager() {}
     ChunkCacheManagerPtr FindOrCreateChunkCacheManager(uint64_t index);
     void ReleaseCache();
@@ -312,10 +313,27 @@ class FileCacheManager {
                            const S3ChunkInfoList &s3ChunkInfoList,
                            char *dataBuf, std::vector<S3ReadRequest> *requests,
                            uint64_t fsId, uint64_t inodeId);
+    // generate the s3 requests by the visible slices got from metaserver,
+    // return false if failed, then the s3chunkinfo list should be walked
+    bool GenerateS3RequestByRange(InodeWrapper *inodeWrapper,
+                                  const ReadRequest &request, char *dataBuf,
+                                  std::vector<S3ReadRequest> *requests,
+                                  uint64_t fsId, uint64_t inodeId);
     int ReadFromS3(const std::vector<S3ReadRequest> &requests,
                             std::vector<S3ReadResponse> *responses,
                             uint64_t fileLen);
     void PrefetchS3Objs(std::vector<std::string> prefetchObjs);
+    // prefetch the readahead window after a read ended at `readEnd`
+    void Readahead(const std::shared_ptr<InodeWrapper> &inodeWrapper,
+                   uint64_t readEnd);
+    // name the s3 objects holding the visible data of file range
+    // [start, end), which is in one chunk
+    void GenerateReadaheadObjs(const S3ChunkInfoList &s3ChunkInfoList,
+                               uint64_t start, uint64_t end, uint64_t fsId,
+                               uint64_t inodeId,
+                               std::vector<std::string> *objs);
+    // check if the block being read was prefetched, for metric
+    void CollectPrefetchHit(const std::string &name, bool cached);
     void HandleReadRequest(const ReadRequest &request,
                            const S3ChunkInfo &s3ChunkInfo,
                            std::vector<ReadRequest> *addReadRequests,
@@ -337,6 +355,9 @@ class FileCacheManager {
     S3ClientAdaptorImpl *s3ClientAdaptor_;
     curve::common::Mutex downloadMtx_;
     std::set<std::string> downloadingObj_;
+    // objs prefetched into disk cache but not read yet
+    std::set<std::string> prefetchedObj_;
+    ReadaheadTracker readahead_;
 };
 
 class FsCacheManager {
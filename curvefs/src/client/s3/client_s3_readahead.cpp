@@ -0,0 +1,82 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "curvefs/src/client/s3/client_s3_readahead.h"
+
+#include <algorithm>
+
+namespace curvefs {
+namespace client {
+
+ReadaheadTracker::ReadaheadTracker(uint64_t blockSize, uint32_t initBlocks,
+                                   uint32_t maxBlocks)
+    : blockSize_(blockSize),
+      initBlocks_(initBlocks),
+      maxBlocks_(std::max(initBlocks, maxBlocks)),
+      window_(initBlocks),
+      prevEnd_(0),
+      readaheadEnd_(0) {}
+
+void ReadaheadTracker::OnRead(uint64_t offset, uint64_t length) {
+    curve::common::LockGuard lg(mtx_);
+    // fuse may split a sequential stream into several concurrent requests
+    // which arrive out of order, so allow one block of slack on both sides
+    uint64_t low = prevEnd_ > blockSize_ ? prevEnd_ - blockSize_ : 0;
+    bool sequential = offset >= low && offset <= prevEnd_ + blockSize_;
+    if (sequential) {
+        if (window_ == 0) {
+            window_ = initBlocks_;
+        }
+    } else {
+        window_ /= 2;
+        readaheadEnd_ = 0;
+    }
+    prevEnd_ = std::max(offset + length, sequential ? prevEnd_ : 0);
+}
+
+ReadaheadRange ReadaheadTracker::GetReadaheadRange(uint64_t readEnd) {
+    ReadaheadRange range;
+    curve::common::LockGuard lg(mtx_);
+    if (window_ == 0 || blockSize_ == 0) {
+        return range;
+    }
+
+    // still have more than half a window read ahead, wait for the reader
+    uint64_t start = AlignUp(readEnd);
+    if (readaheadEnd_ > start &&
+        readaheadEnd_ - start > window_ * blockSize_ / 2) {
+        return range;
+    }
+
+    // the reader caught up with the previous window, it's sequential for
+    // sure, so read ahead more
+    if (readaheadEnd_ != 0) {
+        window_ = std::min(window_ * 2, maxBlocks_);
+    }
+    range.start = std::max(start, readaheadEnd_);
+    range.end = start + window_ * blockSize_;
+    readaheadEnd_ = std::max(readaheadEnd_, range.end);
+    return range;
+}
+
+}  // namespace client
+}  // namespace curvefs
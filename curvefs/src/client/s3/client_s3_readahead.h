@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_S3_CLIENT_S3_READAHEAD_H_
+#define CURVEFS_SRC_CLIENT_S3_CLIENT_S3_READAHEAD_H_
+
+#include <cstdint>
+
+#include "src/common/concurrent/concurrent.h"
+
+namespace curvefs {
+namespace client {
+
+// file range [start, end) that should be prefetched, block aligned
+struct ReadaheadRange {
+    uint64_t start = 0;
+    uint64_t end = 0;
+
+    bool Empty() const { return start >= end; }
+};
+
+/**
+ * Track the read pattern of a file and decide how many blocks to read ahead,
+ * similar to the kernel readahead algorithm:
+ *  - a read that starts near where the last read ended is sequential, the
+ *    first read at the beginning of the file is also treated as sequential
+ *  - the readahead window starts at `initBlocks`, and is doubled (up to
+ *    `maxBlocks`) every time the reader consumed half of the blocks read
+ *    ahead and a new window is issued
+ *  - a random read halves the window, so random workloads quickly stop
+ *    prefetching, and the next sequential read restarts from `initBlocks`
+ */
+class ReadaheadTracker {
+ public:
+    ReadaheadTracker() : ReadaheadTracker(0, 0, 0) {}
+
+    ReadaheadTracker(uint64_t blockSize, uint32_t initBlocks,
+                     uint32_t maxBlocks);
+
+    /**
+     * @brief record a user read of [offset, offset + length)
+     */
+    void OnRead(uint64_t offset, uint64_t length);
+
+    /**
+     * @brief get the range to prefetch after a read ended at `readEnd`
+     * @return empty range if the read is not sequential or the blocks
+     *         ahead have already been issued
+     */
+    ReadaheadRange GetReadaheadRange(uint64_t readEnd);
+
+    uint32_t GetWindowBlocks() {
+        curve::common::LockGuard lg(mtx_);
+        return window_;
+    }
+
+ private:
+    uint64_t AlignUp(uint64_t offset) const {
+        return (offset + blockSize_ - 1) / blockSize_ * blockSize_;
+    }
+
+ private:
+    const uint64_t blockSize_;
+    const uint32_t initBlocks_;
+    const uint32_t maxBlocks_;
+
+    curve::common::Mutex mtx_;
+    // current readahead window in blocks, 0 means no readahead
+    uint32_t window_;
+    // end of the last read
+    uint64_t prevEnd_;
+    // end of the range that has been issued to prefetch
+    uint64_t readaheadEnd_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_S3_CLIENT_S3_READAHEAD_H_
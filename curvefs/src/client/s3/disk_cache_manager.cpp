@@ -20,6 +20,7 @@
  * Author: hzwuhongsong
  */
 #include <sys/vfs.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <string>
 #include <cstdio>
@@ -52,6 +53,8 @@ DEFINE_validator(avgReadFileBytes, &pass_uint64);
 DEFINE_uint64(avgReadFileIops, 0, "the read throttle iops of disk cache");
 DEFINE_validator(avgReadFileIops, &pass_uint64);
 
+#define CACHE_SLAB_DIR "cacheslab"
+
 DiskCacheManager::DiskCacheManager(std::shared_ptr<PosixWrapper> posixWrapper,
                                    std::shared_ptr<DiskCacheWrite> cacheWrite,
                                    std::shared_ptr<DiskCacheRead> cacheRead) {
@@ -94,12 +97,20 @@ int DiskCacheManager::Init(S3Client *client,
         LOG(ERROR) << "create cache dir error, ret = " << ret;
         return ret;
     }
-    // load all cache read file
-    // the all value of cachedObjName_ is set false
-    ret = cacheRead_->LoadAllCacheReadFile(cachedObjName_);
-    if (ret < 0) {
-        LOG(ERROR) << "load all cache read file error. ret = " << ret;
-        return ret;
+    if (option.diskCacheOpt.slabSegmentSize > 0) {
+        ret = InitCacheSlab(option.diskCacheOpt);
+        if (ret < 0) {
+            LOG(ERROR) << "init cache slab error. ret = " << ret;
+            return ret;
+        }
+    } else {
+        // load all cache read file
+        // the all value of cachedObjName_ is set false
+        ret = cacheRead_->LoadAllCacheReadFile(cachedObjName_);
+        if (ret < 0) {
+            LOG(ERROR) << "load all cache read file error. ret = " << ret;
+            return ret;
+        }
     }
 
     // start aync upload thread
@@ -134,6 +145,28 @@ int DiskCacheManager::Init(S3Client *client,
     return 0;
 }
 
+int DiskCacheManager::InitCacheSlab(const DiskCacheOption &option) {
+    DiskCacheSlabOption slabOption;
+    slabOption.segmentSize = option.slabSegmentSize;
+    slabOption.compactRatio = option.slabCompactRatio;
+    cacheSlab_ = std::make_shared<DiskCacheSlab>(
+        posixWrapper_, cacheDir_ + "/" + CACHE_SLAB_DIR, slabOption);
+    int ret = cacheSlab_->Init();
+    if (ret < 0) {
+        cacheSlab_ = nullptr;
+        return ret;
+    }
+    cacheWrite_->SetCacheSlab(cacheSlab_);
+    // the all value of cachedObjName_ is set false
+    std::list<std::string> names;
+    cacheSlab_->ListObjects(&names);
+    for (const auto &name : names) {
+        cachedObjName_->Put(name, false);
+    }
+    LOG(INFO) << "load cache slab success, objects: " << names.size();
+    return 0;
+}
+
 void DiskCacheManager::InitQosParam() {
     ReadWriteThrottleParams params;
     params.iopsWrite = ThrottleParams(FLAGS_avgFlushIops, 0, 0);
@@ -154,7 +187,17 @@ int DiskCacheManager::UploadWriteCacheByInode(const std::string &inode) {
 }
 
 int DiskCacheManager::ClearReadCache(const std::list<std::string> &files) {
-    return cacheRead_->ClearReadCache(files);
+    if (cacheSlab_ == nullptr) {
+        return cacheRead_->ClearReadCache(files);
+    }
+    for (const auto &file : files) {
+        int ret = cacheSlab_->Remove(file);
+        if (ret < 0) {
+            LOG(ERROR) << "remove from cache slab error, file = " << file;
+            return ret;
+        }
+    }
+    return 0;
 }
 
 void DiskCacheManager::AddCache(const std::string name,
@@ -182,6 +225,9 @@ int DiskCacheManager::UmountDiskCache() {
     }
     TrimStop();
     cacheWrite_->AsyncUploadStop();
+    if (cacheSlab_ != nullptr) {
+        cacheSlab_->Close();
+    }
     LOG(INFO) << "umount disk cache end.";
     return 0;
 }
@@ -241,13 +287,57 @@ int DiskCacheManager::ReadDiskFile(const std::string name, char *buf,
                                    uint64_t offset, uint64_t length) {
     // read throttle
     diskCacheThrottle_.Add(true, length);
+    if (cacheSlab_ != nullptr) {
+        int ret = cacheSlab_->Get(name, buf, offset, length);
+        if (ret >= 0) {
+            return ret;
+        }
+        // not uploaded yet, so not in slab
+        ret = ReadCacheWriteFile(name, buf, offset, length);
+        if (ret != -ENOENT) {
+            return ret;
+        }
+        // uploaded just now, or failed to put into slab after uploaded
+        ret = cacheSlab_->Get(name, buf, offset, length);
+        if (ret >= 0) {
+            return ret;
+        }
+        // not cached any more, the caller reads it from s3
+        VLOG(6) << "object is not in cache, file = " << name;
+        cachedObjName_->Remove(name);
+        return -ENOENT;
+    }
     return cacheRead_->ReadDiskFile(name, buf, offset, length);
 }
 
+int DiskCacheManager::ReadCacheWriteFile(const std::string &name, char *buf,
+                                         uint64_t offset, uint64_t length) {
+    std::string cacheWriteFile = GetCacheWriteFullDir() + "/" + name;
+    int fd = posixWrapper_->open(cacheWriteFile.c_str(), O_RDONLY, MODE);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return -ENOENT;
+        }
+        LOG(ERROR) << "open write cache file error. file = " << name
+                   << ", errno = " << errno;
+        return fd;
+    }
+    ssize_t readLen = posixWrapper_->pread(fd, buf, length, offset);
+    if (readLen < 0) {
+        LOG(ERROR) << "read write cache file error. file = " << name
+                   << ", errno = " << errno;
+    }
+    posixWrapper_->close(fd);
+    return readLen;
+}
+
 int DiskCacheManager::WriteReadDirect(const std::string fileName,
                                       const char *buf, uint64_t length) {
     // write hrottle
     diskCacheThrottle_.Add(false, length);
+    if (cacheSlab_ != nullptr) {
+        return cacheSlab_->Put(fileName, buf, length);
+    }
     int ret = cacheRead_->WriteDiskFile(fileName, buf, length);
     if (ret > 0)
         AddDiskUsedBytes(ret);
@@ -257,6 +347,10 @@ int DiskCacheManager::WriteReadDirect(const std::string fileName,
 int DiskCacheManager::LinkWriteToRead(const std::string fileName,
                                       const std::string fullWriteDir,
                                       const std::string fullReadDir) {
+    // put into slab by cacheWrite_ after uploaded
+    if (cacheSlab_ != nullptr) {
+        return 0;
+    }
     return cacheRead_->LinkWriteToRead(fileName, fullWriteDir, fullReadDir);
 }
 
@@ -363,6 +457,10 @@ void DiskCacheManager::TrimCache() {
         VLOG(9) << "trim thread wake up.";
         InitQosParam();
         SetDiskFsUsedRatio();
+        if (cacheSlab_ != nullptr) {
+            TrimCacheSlab();
+            continue;
+        }
             while (!IsDiskCacheSafe()) {
                 if (!cachedObjName_->GetLast(false, &cacheKey)) {
                     VLOG(9) << "obj is empty";
@@ -411,6 +509,32 @@ void DiskCacheManager::TrimCache() {
     LOG(INFO) << "trim function end.";
 }
 
+void DiskCacheManager::TrimCacheSlab() {
+    // only the uploaded objects are put into slab, all can be evicted
+    auto canEvict = [](const std::string &) { return true; };
+
+    int64_t freed = cacheSlab_->Compact();
+    if (freed > 0) {
+        VLOG(6) << "compact cache slab success, freed bytes: " << freed;
+        SetDiskFsUsedRatio();
+    }
+    while (!IsDiskCacheSafe()) {
+        std::list<std::string> evicted;
+        freed = cacheSlab_->EvictSegment(canEvict, &evicted);
+        if (freed <= 0) {
+            VLOG(6) << "no segment of cache slab can be evicted";
+            break;
+        }
+        for (const auto &name : evicted) {
+            cachedObjName_->Remove(name);
+        }
+        SetDiskFsUsedRatio();
+        VLOG(6) << "evict segment of cache slab success, freed bytes: "
+                << freed << ", objects: " << evicted.size();
+    }
+    cacheSlab_->Checkpoint();
+}
+
 int DiskCacheManager::TrimRun() {
     if (isRunning_.exchange(true)) {
         LOG(INFO) << "DiskCacheManager trim thread is on running.";
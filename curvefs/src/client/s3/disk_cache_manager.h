@@ -40,6 +40,7 @@
 #include "curvefs/src/client/s3/client_s3.h"
 #include "curvefs/src/client/s3/disk_cache_write.h"
 #include "curvefs/src/client/s3/disk_cache_read.h"
+#include "curvefs/src/client/s3/disk_cache_slab.h"
 #include "curvefs/src/client/common/config.h"
 namespace curvefs {
 namespace client {
@@ -49,6 +50,7 @@ using curve::common::ReadWriteThrottleParams;
 using ::curve::common::SglLRUCache;
 using curve::common::Throttle;
 using curve::common::ThrottleParams;
+using curvefs::client::common::DiskCacheOption;
 using curvefs::client::common::S3ClientAdaptorOption;
 using curvefs::common::PosixWrapper;
 using curvefs::common::SysUtils;
@@ -135,14 +137,33 @@ class DiskCacheManager {
     }
     void SetDiskInitUsedBytes();
     uint64_t GetDiskUsedbytes() {
+        if (cacheSlab_ != nullptr) {
+            return cacheSlab_->GetUsedBytes();
+        }
         return usedBytes_.load(std::memory_order_seq_cst);
     }
 
+    /**
+     * @brief init the slab store of read cache and load its objects.
+     */
+    int InitCacheSlab(const DiskCacheOption &option);
+    /**
+     * @brief read the object not uploaded yet from write cache.
+     * @return -ENOENT if the write cache file is removed
+     */
+    int ReadCacheWriteFile(const std::string &name, char *buf,
+                           uint64_t offset, uint64_t length);
+
     void InitQosParam();
     /**
      * @brief trim cache func.
      */
     void TrimCache();
+    /**
+     * @brief compact the slab store and evict its oldest segments
+     *        until cache disk is lower than safeRatio_.
+     */
+    void TrimCacheSlab();
 
     /**
      * @brief whether the cache file is exceed maxFileNums_.
@@ -166,6 +187,8 @@ class DiskCacheManager {
     std::string cacheDir_;
     std::shared_ptr<DiskCacheWrite> cacheWrite_;
     std::shared_ptr<DiskCacheRead> cacheRead_;
+    // the read cache is stored in segments if not null
+    std::shared_ptr<DiskCacheSlab> cacheSlab_;
 
     std::shared_ptr<LRUCache<std::string, bool>> cachedObjName_;
 
@@ -0,0 +1,766 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "curvefs/src/client/s3/disk_cache_slab.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "src/common/crc32.h"
+#include "src/common/string_util.h"
+
+namespace curvefs {
+namespace client {
+
+namespace {
+
+const uint32_t kSlabRecordMagic = 0x534c4142;  // "SLAB"
+const uint32_t kSlabIndexMagic = 0x534c4249;   // "SLBI"
+const uint32_t kSlabIndexVersion = 1;
+const size_t kRecordHeaderSize = 16;
+const size_t kIndexHeaderSize = 16;
+const uint8_t kRecordPut = 1;
+const uint8_t kRecordDelete = 2;
+// the reserved range whose record failed to be written
+const uint8_t kRecordSkip = 3;
+const char kSegmentPrefix[] = "segment_";
+const char kIndexFile[] = "index";
+const mode_t kFileMode = 0644;
+
+template <typename T>
+void PutFixed(std::string *out, T value) {
+    out->append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+bool GetFixed(const char **pos, const char *end, T *value) {
+    if (static_cast<size_t>(end - *pos) < sizeof(T)) {
+        return false;
+    }
+    memcpy(value, *pos, sizeof(T));
+    *pos += sizeof(T);
+    return true;
+}
+
+uint64_t RecordSize(const std::string &name, uint64_t length) {
+    return kRecordHeaderSize + name.size() + length;
+}
+
+// crc of the header fields after crc, key and data
+uint32_t RecordCrc(const char *header, const char *body, size_t length) {
+    uint32_t crc = ::curve::common::CRC32(header + 8, kRecordHeaderSize - 8);
+    return ::curve::common::CRC32(crc, body, length);
+}
+
+}  // namespace
+
+struct DiskCacheSlab::Segment {
+    Segment(std::shared_ptr<PosixWrapper> wrapper, uint32_t segmentId,
+            int segmentFd)
+        : posixWrapper(wrapper), id(segmentId), fd(segmentFd),
+          writeOffset(0), liveBytes(0), pendingWrites(0),
+          sealed(false), dirty(false) {}
+
+    // the fd is kept open until the last reader releases the segment
+    ~Segment() {
+        posixWrapper->close(fd);
+    }
+
+    std::shared_ptr<PosixWrapper> posixWrapper;
+    uint32_t id;
+    int fd;
+    // end of the records, the next record is appended here
+    uint64_t writeOffset;
+    // bytes of the records of the live objects
+    uint64_t liveBytes;
+    // appending or compacting, can not be evicted or compacted
+    uint32_t pendingWrites;
+    // no more records will be appended
+    bool sealed;
+    // written since last sync
+    bool dirty;
+    std::unordered_set<std::string> objects;
+};
+
+DiskCacheSlab::DiskCacheSlab(std::shared_ptr<PosixWrapper> posixWrapper,
+                             const std::string &dir,
+                             const DiskCacheSlabOption &option)
+    : posixWrapper_(posixWrapper), dir_(dir), option_(option),
+      nextSegmentId_(0), changed_(false) {}
+
+DiskCacheSlab::~DiskCacheSlab() {}
+
+std::string DiskCacheSlab::SegmentPath(uint32_t id) const {
+    return dir_ + "/" + kSegmentPrefix + std::to_string(id);
+}
+
+std::string DiskCacheSlab::IndexPath() const {
+    return dir_ + "/" + kIndexFile;
+}
+
+int DiskCacheSlab::Init() {
+    struct stat statFile;
+    if (posixWrapper_->stat(dir_.c_str(), &statFile) < 0) {
+        int ret = posixWrapper_->mkdir(dir_.c_str(), 0755);
+        if (ret < 0 && errno != EEXIST) {
+            LOG(ERROR) << "create slab dir error. errno = " << errno
+                       << ", dir = " << dir_;
+            return -1;
+        }
+    }
+
+    std::map<uint32_t, uint64_t> segmentEnds;
+    std::unordered_map<std::string, Location> index;
+    uint32_t nextSegmentId = 0;
+    bool hasCheckpoint =
+        LoadCheckpoint(&segmentEnds, &nextSegmentId, &index) == 0;
+    std::list<uint32_t> ids;
+    if (ListSegments(&ids) != 0) {
+        return -1;
+    }
+    ids.sort();
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    for (uint32_t id : ids) {
+        auto it = segmentEnds.find(id);
+        // evicted or compacted before the checkpoint, but not removed
+        if (hasCheckpoint && id < nextSegmentId && it == segmentEnds.end()) {
+            RemoveSegmentFile(id);
+            continue;
+        }
+        auto segment = OpenSegment(id, false);
+        if (segment == nullptr) {
+            return -1;
+        }
+        segment->writeOffset = it == segmentEnds.end() ? 0 : it->second;
+        segment->sealed = true;
+        segments_[id] = segment;
+        nextSegmentId_ = std::max(nextSegmentId_, id + 1);
+    }
+    nextSegmentId_ = std::max(nextSegmentId_, nextSegmentId);
+    for (const auto &item : index) {
+        if (segments_.count(item.second.segmentId) != 0) {
+            InsertLocked(item.first, item.second);
+        }
+    }
+    // replay the records written after the checkpoint in order
+    for (const auto &item : segments_) {
+        ReplaySegment(item.second);
+    }
+    // continue to append to the last segment
+    if (!segments_.empty()) {
+        active_ = segments_.rbegin()->second;
+        active_->sealed = false;
+    }
+    LOG(INFO) << "DiskCacheSlab init success, dir = " << dir_
+              << ", checkpoint = " << (hasCheckpoint ? "yes" : "no")
+              << ", segments = " << segments_.size()
+              << ", objects = " << index_.size();
+    return 0;
+}
+
+int DiskCacheSlab::Close() {
+    int ret = Checkpoint();
+    std::lock_guard<std::mutex> lk(mtx_);
+    active_ = nullptr;
+    segments_.clear();
+    index_.clear();
+    return ret;
+}
+
+int DiskCacheSlab::LoadCheckpoint(
+    std::map<uint32_t, uint64_t> *segmentEnds, uint32_t *nextSegmentId,
+    std::unordered_map<std::string, Location> *index) {
+    std::string path = IndexPath();
+    int fd = posixWrapper_->open(path.c_str(), O_RDONLY, kFileMode);
+    if (fd < 0) {
+        LOG(INFO) << "slab index not exist, replay all segments, path = "
+                  << path;
+        return -1;
+    }
+    struct stat statFile;
+    std::string buf;
+    int ret = posixWrapper_->fstat(fd, &statFile);
+    if (ret == 0) {
+        buf.resize(statFile.st_size);
+        ssize_t n = posixWrapper_->pread(fd, &buf[0], buf.size(), 0);
+        ret = (n == static_cast<ssize_t>(buf.size())) ? 0 : -1;
+    }
+    posixWrapper_->close(fd);
+    if (ret != 0 || buf.size() < kIndexHeaderSize) {
+        LOG(WARNING) << "read slab index error, path = " << path;
+        return -1;
+    }
+
+    const char *pos = buf.data();
+    const char *end = buf.data() + buf.size();
+    uint32_t magic, version, crc, length;
+    GetFixed(&pos, end, &magic);
+    GetFixed(&pos, end, &version);
+    GetFixed(&pos, end, &crc);
+    GetFixed(&pos, end, &length);
+    if (magic != kSlabIndexMagic || version != kSlabIndexVersion ||
+        length != buf.size() - kIndexHeaderSize ||
+        ::curve::common::CRC32(pos, length) != crc) {
+        LOG(WARNING) << "invalid slab index, path = " << path
+                     << ", magic = " << magic << ", version = " << version;
+        return -1;
+    }
+
+    uint32_t segmentNum;
+    uint64_t objectNum;
+    if (!GetFixed(&pos, end, nextSegmentId) ||
+        !GetFixed(&pos, end, &segmentNum)) {
+        return -1;
+    }
+    for (uint32_t i = 0; i < segmentNum; i++) {
+        uint32_t id;
+        uint64_t writeOffset;
+        if (!GetFixed(&pos, end, &id) || !GetFixed(&pos, end, &writeOffset)) {
+            return -1;
+        }
+        (*segmentEnds)[id] = writeOffset;
+    }
+    if (!GetFixed(&pos, end, &objectNum)) {
+        return -1;
+    }
+    for (uint64_t i = 0; i < objectNum; i++) {
+        Location location;
+        uint16_t keyLength;
+        if (!GetFixed(&pos, end, &location.segmentId) ||
+            !GetFixed(&pos, end, &location.offset) ||
+            !GetFixed(&pos, end, &location.length) ||
+            !GetFixed(&pos, end, &keyLength) ||
+            end - pos < keyLength) {
+            return -1;
+        }
+        (*index)[std::string(pos, keyLength)] = location;
+        pos += keyLength;
+    }
+    return 0;
+}
+
+int DiskCacheSlab::ListSegments(std::list<uint32_t> *ids) {
+    DIR *dir = posixWrapper_->opendir(dir_.c_str());
+    if (dir == nullptr) {
+        LOG(ERROR) << "opendir slab dir error, errno = " << errno
+                   << ", dir = " << dir_;
+        return -1;
+    }
+    struct dirent *entry = nullptr;
+    size_t prefixLength = strlen(kSegmentPrefix);
+    while ((entry = posixWrapper_->readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        uint32_t id;
+        if (name.compare(0, prefixLength, kSegmentPrefix) != 0 ||
+            !::curve::common::StringToUl(name.substr(prefixLength), &id)) {
+            continue;
+        }
+        ids->push_back(id);
+    }
+    posixWrapper_->closedir(dir);
+    return 0;
+}
+
+std::shared_ptr<DiskCacheSlab::Segment> DiskCacheSlab::OpenSegment(
+    uint32_t id, bool create) {
+    std::string path = SegmentPath(id);
+    int flags = create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR;
+    int fd = posixWrapper_->open(path.c_str(), flags, kFileMode);
+    if (fd < 0) {
+        LOG(ERROR) << "open slab segment error, errno = " << errno
+                   << ", path = " << path;
+        return nullptr;
+    }
+    // allocate the whole segment at once, so that the appends
+    // don't allocate blocks and update the inode one by one
+    if (create &&
+        posixWrapper_->fallocate(fd, 0, 0, option_.segmentSize) < 0) {
+        LOG(ERROR) << "fallocate slab segment error, errno = " << errno
+                   << ", path = " << path;
+        posixWrapper_->close(fd);
+        posixWrapper_->remove(path.c_str());
+        return nullptr;
+    }
+    return std::make_shared<Segment>(posixWrapper_, id, fd);
+}
+
+void DiskCacheSlab::ReplaySegment(const std::shared_ptr<Segment> &segment) {
+    uint64_t offset = segment->writeOffset;
+    char header[kRecordHeaderSize];
+    std::string body;
+    uint32_t replayed = 0;
+    while (offset + kRecordHeaderSize <= option_.segmentSize) {
+        ssize_t n = posixWrapper_->pread(segment->fd, header,
+                                         kRecordHeaderSize, offset);
+        if (n != static_cast<ssize_t>(kRecordHeaderSize)) {
+            break;
+        }
+        uint32_t magic, crc, dataLength;
+        uint8_t type;
+        uint16_t keyLength;
+        memcpy(&magic, header, 4);
+        memcpy(&crc, header + 4, 4);
+        memcpy(&type, header + 8, 1);
+        memcpy(&keyLength, header + 10, 2);
+        memcpy(&dataLength, header + 12, 4);
+        uint64_t size = kRecordHeaderSize + keyLength + dataLength;
+        if (magic != kSlabRecordMagic || offset + size > option_.segmentSize) {
+            break;
+        }
+        // the crc of skip record only covers its header
+        if (type == kRecordSkip) {
+            if (RecordCrc(header, nullptr, 0) != crc) {
+                break;
+            }
+            offset += size;
+            continue;
+        }
+        body.resize(keyLength + dataLength);
+        n = posixWrapper_->pread(segment->fd, &body[0], body.size(),
+                                 offset + kRecordHeaderSize);
+        if (n != static_cast<ssize_t>(body.size()) ||
+            RecordCrc(header, body.data(), body.size()) != crc) {
+            break;
+        }
+        std::string name = body.substr(0, keyLength);
+        if (type == kRecordPut) {
+            InsertLocked(name, Location{segment->id,
+                                        offset + kRecordHeaderSize + keyLength,
+                                        dataLength});
+        } else if (type == kRecordDelete) {
+            EraseLocked(name);
+        } else {
+            break;
+        }
+        offset += size;
+        replayed++;
+    }
+    VLOG(3) << "replay slab segment " << segment->id << ", records = "
+            << replayed << ", from " << segment->writeOffset
+            << " to " << offset;
+    segment->writeOffset = offset;
+}
+
+int DiskCacheSlab::ReserveLocked(uint64_t size,
+                                 std::shared_ptr<Segment> *segment,
+                                 uint64_t *offset) {
+    if (active_ == nullptr ||
+        active_->writeOffset + size > option_.segmentSize) {
+        auto newSegment = OpenSegment(nextSegmentId_, true);
+        if (newSegment == nullptr) {
+            return -1;
+        }
+        nextSegmentId_++;
+        if (active_ != nullptr) {
+            active_->sealed = true;
+        }
+        segments_[newSegment->id] = newSegment;
+        active_ = newSegment;
+    }
+    *segment = active_;
+    *offset = active_->writeOffset;
+    active_->writeOffset += size;
+    active_->pendingWrites++;
+    return 0;
+}
+
+int DiskCacheSlab::Append(uint8_t type, const std::string &name,
+                          const char *buf, uint64_t length,
+                          std::shared_ptr<Segment> *segment,
+                          uint64_t *offset) {
+    uint64_t size = RecordSize(name, length);
+    if (name.size() > UINT16_MAX || length > UINT32_MAX ||
+        size > option_.segmentSize) {
+        LOG(ERROR) << "object is too large for slab, name = " << name
+                   << ", length = " << length;
+        return -1;
+    }
+
+    std::string record(kRecordHeaderSize, 0);
+    record.reserve(size);
+    record.append(name);
+    if (length > 0) {
+        record.append(buf, length);
+    }
+    uint16_t keyLength = name.size();
+    uint32_t dataLength = length;
+    memcpy(&record[0], &kSlabRecordMagic, 4);
+    memcpy(&record[8], &type, 1);
+    memcpy(&record[10], &keyLength, 2);
+    memcpy(&record[12], &dataLength, 4);
+    uint32_t crc = RecordCrc(record.data(), record.data() + kRecordHeaderSize,
+                             size - kRecordHeaderSize);
+    memcpy(&record[4], &crc, 4);
+
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (ReserveLocked(size, segment, offset) != 0) {
+            return -1;
+        }
+    }
+    ssize_t n = posixWrapper_->pwrite((*segment)->fd, record.data(), size,
+                                      *offset);
+    if (n != static_cast<ssize_t>(size)) {
+        LOG(ERROR) << "write slab segment error, ret = " << n
+                   << ", errno = " << errno << ", name = " << name;
+        // otherwise the replay stops at the reserved range and
+        // the records after it are lost
+        memcpy(&record[8], &kRecordSkip, 1);
+        crc = RecordCrc(record.data(), nullptr, 0);
+        memcpy(&record[4], &crc, 4);
+        n = posixWrapper_->pwrite((*segment)->fd, record.data(),
+                                  kRecordHeaderSize, *offset);
+        if (n != static_cast<ssize_t>(kRecordHeaderSize)) {
+            LOG(ERROR) << "write slab skip record error, ret = " << n
+                       << ", errno = " << errno << ", name = " << name;
+        }
+        std::lock_guard<std::mutex> lk(mtx_);
+        (*segment)->pendingWrites--;
+        (*segment)->dirty = true;
+        return -1;
+    }
+    return 0;
+}
+
+int DiskCacheSlab::Put(const std::string &name, const char *buf,
+                       uint64_t length) {
+    std::shared_ptr<Segment> segment;
+    uint64_t offset;
+    if (Append(kRecordPut, name, buf, length, &segment, &offset) != 0) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lk(mtx_);
+    segment->pendingWrites--;
+    segment->dirty = true;
+    InsertLocked(name, Location{segment->id,
+                                offset + kRecordHeaderSize + name.size(),
+                                static_cast<uint32_t>(length)});
+    return length;
+}
+
+int DiskCacheSlab::Get(const std::string &name, char *buf, uint64_t offset,
+                       uint64_t length) {
+    std::shared_ptr<Segment> segment;
+    Location location;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        auto it = index_.find(name);
+        if (it == index_.end()) {
+            VLOG(6) << "object is not in slab, name = " << name;
+            return -1;
+        }
+        location = it->second;
+        segment = segments_.at(location.segmentId);
+    }
+    if (offset + length > location.length) {
+        LOG(ERROR) << "read slab object out of range, name = " << name
+                   << ", offset = " << offset << ", length = " << length
+                   << ", object length = " << location.length;
+        return -1;
+    }
+    ssize_t n = posixWrapper_->pread(segment->fd, buf, length,
+                                     location.offset + offset);
+    if (n < static_cast<ssize_t>(length)) {
+        LOG(ERROR) << "read slab segment error, ret = " << n
+                   << ", errno = " << errno << ", name = " << name;
+        return -1;
+    }
+    return n;
+}
+
+int DiskCacheSlab::Remove(const std::string &name) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (index_.find(name) == index_.end()) {
+            return 0;
+        }
+        EraseLocked(name);
+    }
+    // the delete record keeps the object removed after replay
+    std::shared_ptr<Segment> segment;
+    uint64_t offset;
+    if (Append(kRecordDelete, name, nullptr, 0, &segment, &offset) != 0) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lk(mtx_);
+    segment->pendingWrites--;
+    segment->dirty = true;
+    return 0;
+}
+
+bool DiskCacheSlab::IsCached(const std::string &name) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return index_.find(name) != index_.end();
+}
+
+void DiskCacheSlab::ListObjects(std::list<std::string> *names) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    for (const auto &item : index_) {
+        names->push_back(item.first);
+    }
+}
+
+void DiskCacheSlab::InsertLocked(const std::string &name,
+                                 const Location &location) {
+    EraseLocked(name);
+    auto &segment = segments_.at(location.segmentId);
+    segment->objects.insert(name);
+    segment->liveBytes += RecordSize(name, location.length);
+    index_[name] = location;
+    changed_ = true;
+}
+
+void DiskCacheSlab::EraseLocked(const std::string &name) {
+    auto it = index_.find(name);
+    if (it == index_.end()) {
+        return;
+    }
+    auto segment = segments_.find(it->second.segmentId);
+    if (segment != segments_.end()) {
+        segment->second->objects.erase(name);
+        segment->second->liveBytes -= RecordSize(name, it->second.length);
+    }
+    index_.erase(it);
+    changed_ = true;
+}
+
+void DiskCacheSlab::RemoveSegmentFile(uint32_t id) {
+    std::string path = SegmentPath(id);
+    if (posixWrapper_->remove(path.c_str()) < 0) {
+        LOG(ERROR) << "remove slab segment error, errno = " << errno
+                   << ", path = " << path;
+        return;
+    }
+    VLOG(3) << "remove slab segment success, path = " << path;
+}
+
+int64_t DiskCacheSlab::EvictSegment(
+    const std::function<bool(const std::string &)> &canEvict,
+    std::list<std::string> *evicted) {
+    std::shared_ptr<Segment> victim;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        for (const auto &item : segments_) {
+            const auto &segment = item.second;
+            if (!segment->sealed || segment->pendingWrites > 0) {
+                continue;
+            }
+            if (std::all_of(segment->objects.begin(), segment->objects.end(),
+                            canEvict)) {
+                victim = segment;
+                break;
+            }
+        }
+        if (victim == nullptr) {
+            return 0;
+        }
+        for (const auto &name : victim->objects) {
+            index_.erase(name);
+            evicted->push_back(name);
+        }
+        victim->objects.clear();
+        victim->liveBytes = 0;
+        segments_.erase(victim->id);
+        changed_ = true;
+    }
+    // persist the index before removing the segment, otherwise the
+    // objects may be recovered from the old checkpoint without the data
+    if (Checkpoint() != 0) {
+        LOG(ERROR) << "checkpoint before evicting slab segment error"
+                   << ", segment = " << victim->id;
+        return -1;
+    }
+    RemoveSegmentFile(victim->id);
+    VLOG(3) << "evict slab segment " << victim->id
+            << ", objects = " << evicted->size();
+    return option_.segmentSize;
+}
+
+int64_t DiskCacheSlab::Compact() {
+    std::shared_ptr<Segment> victim;
+    std::vector<std::pair<std::string, Location>> objects;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        for (const auto &item : segments_) {
+            const auto &segment = item.second;
+            if (!segment->sealed || segment->pendingWrites > 0) {
+                continue;
+            }
+            if (segment->liveBytes * 100 <
+                option_.segmentSize * option_.compactRatio) {
+                victim = segment;
+                break;
+            }
+        }
+        if (victim == nullptr) {
+            return 0;
+        }
+        for (const auto &name : victim->objects) {
+            objects.emplace_back(name, index_[name]);
+        }
+        victim->pendingWrites++;
+    }
+
+    bool success = true;
+    std::string data;
+    for (const auto &object : objects) {
+        const std::string &name = object.first;
+        const Location &from = object.second;
+        data.resize(from.length);
+        ssize_t n = posixWrapper_->pread(victim->fd, &data[0], from.length,
+                                         from.offset);
+        std::shared_ptr<Segment> segment;
+        uint64_t offset;
+        if (n != static_cast<ssize_t>(from.length) ||
+            Append(kRecordPut, name, data.data(), from.length,
+                   &segment, &offset) != 0) {
+            LOG(ERROR) << "move object error when compacting slab segment "
+                       << victim->id << ", name = " << name;
+            success = false;
+            break;
+        }
+        std::lock_guard<std::mutex> lk(mtx_);
+        segment->pendingWrites--;
+        segment->dirty = true;
+        // the object may be removed or overwritten while moving
+        auto it = index_.find(name);
+        if (it != index_.end() && it->second.segmentId == from.segmentId &&
+            it->second.offset == from.offset) {
+            InsertLocked(name, Location{segment->id,
+                                        offset + kRecordHeaderSize +
+                                            name.size(),
+                                        from.length});
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        victim->pendingWrites--;
+        if (!success || !victim->objects.empty()) {
+            return 0;
+        }
+        segments_.erase(victim->id);
+        changed_ = true;
+    }
+    if (Checkpoint() != 0) {
+        LOG(ERROR) << "checkpoint after compacting slab segment error"
+                   << ", segment = " << victim->id;
+        return -1;
+    }
+    RemoveSegmentFile(victim->id);
+    VLOG(3) << "compact slab segment " << victim->id
+            << ", objects moved = " << objects.size();
+    return option_.segmentSize;
+}
+
+int DiskCacheSlab::Checkpoint() {
+    std::lock_guard<std::mutex> checkpointLk(checkpointMtx_);
+    std::string buf(kIndexHeaderSize, 0);
+    std::vector<std::shared_ptr<Segment>> toSync;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (!changed_) {
+            return 0;
+        }
+        PutFixed<uint32_t>(&buf, nextSegmentId_);
+        PutFixed<uint32_t>(&buf, segments_.size());
+        for (const auto &item : segments_) {
+            PutFixed<uint32_t>(&buf, item.first);
+            PutFixed<uint64_t>(&buf, item.second->writeOffset);
+            if (item.second->dirty) {
+                item.second->dirty = false;
+                toSync.push_back(item.second);
+            }
+        }
+        PutFixed<uint64_t>(&buf, index_.size());
+        for (const auto &item : index_) {
+            PutFixed<uint32_t>(&buf, item.second.segmentId);
+            PutFixed<uint64_t>(&buf, item.second.offset);
+            PutFixed<uint32_t>(&buf, item.second.length);
+            PutFixed<uint16_t>(&buf, item.first.size());
+            buf.append(item.first);
+        }
+        changed_ = false;
+    }
+
+    auto fail = [&]() {
+        std::lock_guard<std::mutex> lk(mtx_);
+        changed_ = true;
+        for (auto &segment : toSync) {
+            segment->dirty = true;
+        }
+        return -1;
+    };
+
+    // the data of the objects in index must be persisted first
+    for (auto &segment : toSync) {
+        if (posixWrapper_->fdatasync(segment->fd) < 0) {
+            LOG(ERROR) << "sync slab segment error, errno = " << errno
+                       << ", segment = " << segment->id;
+            return fail();
+        }
+    }
+
+    uint32_t length = buf.size() - kIndexHeaderSize;
+    uint32_t crc = ::curve::common::CRC32(buf.data() + kIndexHeaderSize,
+                                          length);
+    memcpy(&buf[0], &kSlabIndexMagic, 4);
+    memcpy(&buf[4], &kSlabIndexVersion, 4);
+    memcpy(&buf[8], &crc, 4);
+    memcpy(&buf[12], &length, 4);
+
+    std::string tmpPath = IndexPath() + ".tmp";
+    int fd = posixWrapper_->open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC,
+                                 kFileMode);
+    if (fd < 0) {
+        LOG(ERROR) << "open slab index error, errno = " << errno
+                   << ", path = " << tmpPath;
+        return fail();
+    }
+    ssize_t n = posixWrapper_->pwrite(fd, buf.data(), buf.size(), 0);
+    int ret = posixWrapper_->fsync(fd);
+    posixWrapper_->close(fd);
+    if (n != static_cast<ssize_t>(buf.size()) || ret < 0 ||
+        posixWrapper_->rename(tmpPath.c_str(), IndexPath().c_str()) < 0) {
+        LOG(ERROR) << "write slab index error, errno = " << errno
+                   << ", path = " << tmpPath;
+        return fail();
+    }
+    VLOG(6) << "checkpoint slab index success, size = " << buf.size();
+    return 0;
+}
+
+uint64_t DiskCacheSlab::GetUsedBytes() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return segments_.size() * option_.segmentSize;
+}
+
+}  // namespace client
+}  // namespace curvefs
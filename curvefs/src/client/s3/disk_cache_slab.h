@@ -0,0 +1,190 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef CURVEFS_SRC_CLIENT_S3_DISK_CACHE_SLAB_H_
+#define CURVEFS_SRC_CLIENT_S3_DISK_CACHE_SLAB_H_
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "curvefs/src/common/wrap_posix.h"
+
+namespace curvefs {
+namespace client {
+
+using curvefs::common::PosixWrapper;
+
+struct DiskCacheSlabOption {
+    // size of every segment file, which is preallocated
+    uint64_t segmentSize = 256ULL * 1024 * 1024;
+    // compact a sealed segment if the percent of live data is below it
+    uint32_t compactRatio = 50;
+};
+
+/**
+ * Log-structured store of the read cache. Objects are appended to large
+ * preallocated segment files instead of one file per object, and located
+ * by an in-memory index, which is checkpointed to the index file. Space is
+ * reclaimed by segment: the oldest segment is evicted as a whole, and a
+ * segment with little live data is compacted into the active segment.
+ *
+ * Record format in segment:
+ *   magic: 4 bytes
+ *   crc: 4 bytes, crc32c of the following fields, key and data
+ *   type: 1 byte, put, delete or skip
+ *   padding: 1 byte
+ *   key length: 2 bytes
+ *   data length: 4 bytes
+ *   key, data
+ *
+ * The segments are synced before the index is checkpointed, and on
+ * recovery the records after the checkpoint are replayed until the first
+ * broken one, which becomes the end of the segment.
+ */
+class DiskCacheSlab {
+ public:
+    DiskCacheSlab(std::shared_ptr<PosixWrapper> posixWrapper,
+                  const std::string &dir,
+                  const DiskCacheSlabOption &option);
+    virtual ~DiskCacheSlab();
+
+    /**
+     * @brief create the dir if not exist and recover the index
+     *        from the checkpoint and the segments.
+     */
+    virtual int Init();
+
+    /**
+     * @brief checkpoint the index and close all segments.
+     */
+    virtual int Close();
+
+    /**
+     * @brief append the object to the active segment.
+     * @return the length written, or < 0 if failed
+     */
+    virtual int Put(const std::string &name, const char *buf,
+                    uint64_t length);
+
+    /**
+     * @brief read the range of the object.
+     * @return the length read, or < 0 if not cached or failed
+     */
+    virtual int Get(const std::string &name, char *buf, uint64_t offset,
+                    uint64_t length);
+
+    virtual int Remove(const std::string &name);
+
+    virtual bool IsCached(const std::string &name);
+
+    virtual void ListObjects(std::list<std::string> *names);
+
+    /**
+     * @brief evict the oldest sealed segment whose objects can all be
+     *        removed from the cache.
+     * @param[in] canEvict whether the object can be removed
+     * @param[out] evicted the objects removed
+     * @return the bytes freed, 0 if no segment can be evicted
+     */
+    virtual int64_t EvictSegment(
+        const std::function<bool(const std::string &)> &canEvict,
+        std::list<std::string> *evicted);
+
+    /**
+     * @brief move the live objects of the oldest sealed segment whose
+     *        live ratio is below compactRatio to the active segment.
+     * @return the bytes freed, 0 if no segment need compact
+     */
+    virtual int64_t Compact();
+
+    /**
+     * @brief sync the segments and persist the index.
+     */
+    virtual int Checkpoint();
+
+    /**
+     * @brief bytes of all segment files.
+     */
+    virtual uint64_t GetUsedBytes();
+
+ private:
+    struct Segment;
+    struct Location {
+        uint32_t segmentId;
+        // offset of the data in segment
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    std::string SegmentPath(uint32_t id) const;
+    std::string IndexPath() const;
+
+    int LoadCheckpoint(std::map<uint32_t, uint64_t> *segmentEnds,
+                       uint32_t *nextSegmentId,
+                       std::unordered_map<std::string, Location> *index);
+    int ListSegments(std::list<uint32_t> *ids);
+    std::shared_ptr<Segment> OpenSegment(uint32_t id, bool create);
+    void ReplaySegment(const std::shared_ptr<Segment> &segment);
+
+    /**
+     * @brief append the record, the index is updated by the caller.
+     */
+    int Append(uint8_t type, const std::string &name, const char *buf,
+               uint64_t length, std::shared_ptr<Segment> *segment,
+               uint64_t *offset);
+    int ReserveLocked(uint64_t size, std::shared_ptr<Segment> *segment,
+                      uint64_t *offset);
+
+    void InsertLocked(const std::string &name, const Location &location);
+    // remove the object from index, the record is left in segment
+    void EraseLocked(const std::string &name);
+    void RemoveSegmentFile(uint32_t id);
+
+ private:
+    std::shared_ptr<PosixWrapper> posixWrapper_;
+    std::string dir_;
+    DiskCacheSlabOption option_;
+
+    // protect the index and segments
+    std::mutex mtx_;
+    std::unordered_map<std::string, Location> index_;
+    // ordered by id, the older segment has the smaller id
+    std::map<uint32_t, std::shared_ptr<Segment>> segments_;
+    std::shared_ptr<Segment> active_;
+    uint32_t nextSegmentId_;
+    // the index is changed since last checkpoint
+    bool changed_;
+
+    // serialize the checkpoints
+    std::mutex checkpointMtx_;
+};
+
+}  // namespace client
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_CLIENT_S3_DISK_CACHE_SLAB_H_
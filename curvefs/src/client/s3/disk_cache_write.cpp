@@ -26,6 +26,8 @@
 #include <errno.h>
 #include <dirent.h>
 
+#include <mutex>  // NOLINT
+#include <set>
 #include <vector>
 
 #include "curvefs/src/client/s3/disk_cache_write.h"
@@ -145,7 +147,13 @@ int DiskCacheWrite::UploadFile(const std::string &name,
                     metric_->writeS3.latency
                         << (butil::cpuwide_time_us() - context->startTime);
                 }
+                bool cached = PutCacheSlab(context->key, buffer,
+                                           context->bufferSize);
                 RemoveFile(context->key);
+                if (!cached) {
+                    // neither in slab nor in write cache, read from s3
+                    cachedObjName_->Remove(context->key);
+                }
                 VLOG(9) << " PutObjectAsyncCallBack success, "
                         << "remove file: " << context->key;
                 posixWrapper_->free(buffer);
@@ -353,6 +361,9 @@ int DiskCacheWrite::UploadAllCacheWriteFile() {
     curve::common::CountDownEvent cond(1);
     std::atomic<uint64_t> pendingReq(0);
     pendingReq.fetch_add(uploadObjs.size(), std::memory_order_seq_cst);
+    // the objects failed to put into slab, not cached after uploaded
+    std::mutex uncachedMtx;
+    std::set<std::string> uncached;
     for (auto iter = uploadObjs.begin(); iter != uploadObjs.end(); iter++) {
         uint64_t fileSize;
         char *buffer = nullptr;
@@ -367,13 +378,18 @@ int DiskCacheWrite::UploadAllCacheWriteFile() {
         PutObjectAsyncCallBack cb =
         [&, buffer](const std::shared_ptr<PutObjectAsyncContext> &context) {
             if (context->retCode == 0) {
+                VLOG(3) << "PutObjectAsyncCallBack success"
+                        << ", file: " << context->key;
+                if (!PutCacheSlab(context->key, buffer,
+                                  context->bufferSize)) {
+                    std::lock_guard<std::mutex> lk(uncachedMtx);
+                    uncached.insert(context->key);
+                }
+                posixWrapper_->free(buffer);
                 if (pendingReq.fetch_sub(1, std::memory_order_seq_cst) == 1) {
                     VLOG(3) << "pendingReq is over";
                     cond.Signal();
                 }
-                VLOG(3) << "PutObjectAsyncCallBack success"
-                        << ", file: " << context->key;
-                posixWrapper_->free(buffer);
                 return;
             }
             LOG(WARNING) << "upload object failed: " << context->key;
@@ -392,12 +408,27 @@ int DiskCacheWrite::UploadAllCacheWriteFile() {
     }
     for (auto iter = uploadObjs.begin(); iter != uploadObjs.end(); iter++) {
         RemoveFile(*iter);
-        cachedObjName_->Put(*iter, false);
+        if (uncached.count(*iter) > 0) {
+            cachedObjName_->Remove(*iter);
+        } else {
+            cachedObjName_->Put(*iter, false);
+        }
     }
     VLOG(3) << "upload all cached write file end.";
     return 0;
 }
 
+bool DiskCacheWrite::PutCacheSlab(const std::string &name, const char *buf,
+                                  uint64_t length) {
+    // appended after uploaded instead of in the write path,
+    // the object is read from write cache until then
+    if (cacheSlab_ != nullptr && cacheSlab_->Put(name, buf, length) < 0) {
+        LOG(WARNING) << "put into cache slab error, file = " << name;
+        return false;
+    }
+    return true;
+}
+
 int DiskCacheWrite::RemoveFile(const std::string fileName) {
     // del disk file
     std::string fileFullPath;
@@ -41,6 +41,7 @@
 #include "curvefs/src/client/s3/client_s3.h"
 #include "curvefs/src/client/s3/disk_cache_write.h"
 #include "curvefs/src/client/s3/disk_cache_read.h"
+#include "curvefs/src/client/s3/disk_cache_slab.h"
 #include "curvefs/src/client/common/config.h"
 #include "curvefs/src/client/s3/disk_cache_base.h"
 
@@ -133,6 +134,14 @@ class DiskCacheWrite : public DiskCacheBase {
         metric_ = metric;
     }
 
+    /**
+     * @brief the uploaded objects are appended to the slab store
+     *        of read cache if set
+     */
+    virtual void SetCacheSlab(std::shared_ptr<DiskCacheSlab> cacheSlab) {
+        cacheSlab_ = cacheSlab;
+    }
+
  private:
     int AsyncUploadFunc();
     void UploadFile(const std::list<std::string> &toUpload,
@@ -141,6 +150,10 @@ class DiskCacheWrite : public DiskCacheBase {
     int GetUploadFile(const std::string &inode,
                       std::list<std::string> *toUpload);
     int FileExist(const std::string &inode);
+    // put the uploaded object into the slab store of read cache,
+    // return false if the slab store is set but failed to put
+    bool PutCacheSlab(const std::string &name, const char *buf,
+                      uint64_t length);
 
     curve::common::Thread backEndThread_;
     curve::common::Atomic<bool> isRunning_;
@@ -154,6 +167,7 @@ class DiskCacheWrite : public DiskCacheBase {
     std::shared_ptr<DiskCacheMetric> metric_;
 
     std::shared_ptr<LRUCache<std::string, bool>> cachedObjName_;
+    std::shared_ptr<DiskCacheSlab> cacheSlab_;
 };
 
 }  // namespace client
@@ -37,6 +37,7 @@
 #include "curvefs/src/client/volume/extent_cache.h"
 #include "curvefs/src/client/volume/utils.h"
 #include "curvefs/src/common/metric_utils.h"
+#include "curvefs/src/volume/utils.h"
 
 namespace curvefs {
 namespace client {
@@ -192,6 +193,40 @@ bool DefaultVolumeStorage::Flush(uint64_t ino) {
     return ret == CURVEFS_ERROR::OK;
 }
 
+bool DefaultVolumeStorage::Release(uint64_t ino) {
+    std::shared_ptr<InodeWrapper> inodeWrapper;
+    auto ret = inodeCacheManager_->GetInode(ino, inodeWrapper);
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "Get inode error, ino: " << ino << ", ret: " << ret;
+        return false;
+    }
+
+    auto lk = inodeWrapper->GetUniqueLock();
+    if (inodeWrapper->IsOpen()) {
+        return true;
+    }
+
+    std::vector<Extent> released;
+    auto* inode = inodeWrapper->GetMutableInodeUnlocked();
+    inodeWrapper->GetMutableExtentCache()->TrimUnwritten(inode->length(),
+                                                          &released);
+    if (released.empty()) {
+        return true;
+    }
+
+    // persist extents before the space is reused by others
+    ret = inodeWrapper->Sync();
+    if (ret != CURVEFS_ERROR::OK) {
+        LOG(ERROR) << "Release sync inode error, ino: " << ino
+                   << ", ret: " << ret;
+        return false;
+    }
+
+    VLOG(9) << "release unwritten space, ino: " << ino
+            << ", extents: " << released;
+    return spaceManager_->DeAlloc(released);
+}
+
 bool DefaultVolumeStorage::Shutdown() {
     return true;
 }
@@ -67,6 +67,8 @@ class DefaultVolumeStorage final : public VolumeStorage {
 
     bool Flush(uint64_t ino) override;
 
+    bool Release(uint64_t ino) override;
+
     bool Shutdown() override;
 
  private:
@@ -58,6 +58,7 @@ bvar::LatencyRecorder g_mark_written_latency("extent_cache_mark_written");
 
 std::ostream& operator<<(std::ostream& os, const ExtentCacheOption& opt) {
     os << "prealloc size: " << opt.preAllocSize
+       << ", max prealloc size: " << opt.maxPreAllocSize
        << ", slice size: " << opt.sliceSize
        << ", block size: " << opt.blockSize;
 
@@ -103,27 +104,46 @@ void ExtentCache::DivideForWrite(uint64_t offset,
     const auto end = offset + len;
     const char* datap = data;
 
+    // grow the preallocation on sequential append, so that small appends
+    // get large and contiguous extents
+    const auto prev = appendOffset_.exchange(end);
+    const bool sequential = offset != 0 && prev == offset;
+    uint64_t preAllocSize = option_.preAllocSize;
+    if (sequential) {
+        preAllocSize = std::min(
+            std::max(preAllocSize_.load(), option_.preAllocSize) * 2,
+            option_.maxPreAllocSize);
+    }
+    const auto allocs = needAlloc->size();
+
     while (offset < end) {
         const auto length = std::min(
             end - offset, option_.sliceSize - (offset & ~option_.sliceSize));
 
         auto slice = slices_.find(align_down(offset, option_.sliceSize));
         if (slice != slices_.end()) {
-            slice->second.DivideForWrite(offset, length, datap, allocated,
-                                         needAlloc);
+            slice->second.DivideForWrite(offset, length, datap, preAllocSize,
+                                         allocated, needAlloc);
         } else {
-            DivideForWriteWithinEmptySlice(offset, length, datap, needAlloc);
+            DivideForWriteWithinEmptySlice(offset, length, datap,
+                                           preAllocSize, needAlloc);
         }
 
         datap += length;
         offset += length;
     }
+
+    // the window only moves when space is really allocated
+    if (needAlloc->size() != allocs) {
+        preAllocSize_.store(sequential ? preAllocSize : 0);
+    }
 }
 
 void ExtentCache::DivideForWriteWithinEmptySlice(
     uint64_t offset,
     uint64_t len,
     const char* data,
+    uint64_t preAllocSize,
     std::vector<AllocPart>* needAlloc) {
     AllocPart part;
     part.data = data;
@@ -134,11 +154,11 @@ void ExtentCache::DivideForWriteWithinEmptySlice(
     uint64_t alloclength = 0;
     if (offset == alignedoffset) {
         alloclength =
-            align_up(std::max(len, option_.preAllocSize), option_.blockSize);
+            align_up(std::max(len, preAllocSize), option_.blockSize);
     } else {
         auto alignedend = align_up(offset + len, option_.blockSize);
         alloclength =
-            align_up(std::max(alignedend - alignedoffset, option_.preAllocSize),
+            align_up(std::max(alignedend - alignedoffset, preAllocSize),
                      option_.blockSize);
     }
 
@@ -175,6 +195,24 @@ void ExtentCache::MarkWritten(uint64_t offset, uint64_t len) {
     }
 }
 
+void ExtentCache::TrimUnwritten(uint64_t offset,
+                                std::vector<Extent>* released) {
+    WriteLockGuard lk(lock_);
+
+    const auto trimOffset = align_up(offset, option_.blockSize);
+    for (auto& slice : slices_) {
+        if (slice.first + option_.sliceSize <= trimOffset) {
+            continue;
+        }
+
+        if (slice.second.TrimUnwritten(trimOffset, released)) {
+            dirties_.insert(&slice.second);
+        }
+    }
+
+    preAllocSize_.store(0);
+}
+
 std::unordered_map<uint64_t, std::map<uint64_t, PExtent>>
 ExtentCache::GetExtentsForTesting() const {
     std::unordered_map<uint64_t, std::map<uint64_t, PExtent>> result;
@@ -218,6 +256,11 @@ void ExtentCache::SetOption(const ExtentCacheOption& option) {
     CHECK(is_alignment(option.preAllocSize))
         << "prealloc size must be power of 2, current is "
         << option.preAllocSize;
+    CHECK(is_alignment(option.maxPreAllocSize) &&
+          option.maxPreAllocSize >= option.preAllocSize)
+        << "max prealloc size must be power of 2 and not less than prealloc "
+           "size, current is "
+        << option.maxPreAllocSize;
     CHECK(is_alignment(option.sliceSize))
         << "slice size must be power of 2, current is " << option.sliceSize;
     CHECK(is_alignment(option.blockSize))
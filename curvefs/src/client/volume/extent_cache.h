@@ -25,6 +25,7 @@
 
 #include <bvar/bvar.h>
 
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <unordered_map>
@@ -40,6 +41,7 @@
 namespace curvefs {
 namespace client {
 
+using ::curvefs::volume::Extent;
 using ::curvefs::volume::ReadPart;
 using ::curvefs::volume::WritePart;
 using ::curvefs::metaserver::VolumeExtentSlice;
@@ -49,6 +51,9 @@ struct ExtentCacheOption {
     // preallocation size if offset ~ length is not allocated
     // TODO(wuhanqing): preallocation size should take care of file size
     uint64_t preAllocSize = 64ULL * 1024;
+    // preallocation size doubles on every allocation of sequential append
+    // until this size, and is reset to preAllocSize on random write
+    uint64_t maxPreAllocSize = 4ULL * 1024 * 1024;
     // a single file's extents are split by offset, and each one called `slice`
     uint64_t sliceSize = 1ULL * 1024 * 1024 * 1024;
     // minimum allocate and read/write unit
@@ -57,7 +62,7 @@ struct ExtentCacheOption {
 
 class ExtentCache {
  public:
-    ExtentCache() = default;
+    ExtentCache() : preAllocSize_(0), appendOffset_(0) {}
 
     static void SetOption(const ExtentCacheOption& option);
 
@@ -79,6 +84,13 @@ class ExtentCache {
 
     void MarkWritten(uint64_t offset, uint64_t len);
 
+    /**
+     * @brief Remove the unwritten extents beyond offset, i.e. the space
+     *        preallocated but never written
+     * @param[out] released physical space of the removed extents
+     */
+    void TrimUnwritten(uint64_t offset, std::vector<Extent>* released);
+
     bool HasDirtyExtents() const;
 
     VolumeExtentList GetDirtyExtents();
@@ -91,6 +103,7 @@ class ExtentCache {
         uint64_t offset,
         uint64_t len,
         const char* data,
+        uint64_t preAllocSize,
         std::vector<AllocPart>* needAlloc);
 
  private:
@@ -102,6 +115,11 @@ class ExtentCache {
     // dirty slices
     std::unordered_set<ExtentSlice*> dirties_;
 
+    // current preallocation size, 0 means option_.preAllocSize
+    std::atomic<uint64_t> preAllocSize_;
+    // end offset of last write, used to detect sequential append
+    std::atomic<uint64_t> appendOffset_;
+
  private:
     friend class ExtentSlice;
 
@@ -88,6 +88,7 @@ VolumeExtentSlice ExtentSlice::ToVolumeExtentSlice() const {
 void ExtentSlice::DivideForWrite(uint64_t offset,
                                  uint64_t len,
                                  const char* data,
+                                 uint64_t preAllocSize,
                                  std::vector<WritePart>* allocated,
                                  std::vector<AllocPart>* needAlloc) const {
     uint64_t curOff = offset;
@@ -233,8 +234,7 @@ void ExtentSlice::DivideForWrite(uint64_t offset,
 
         part.allocInfo.lOffset = alignedoffset;
         part.allocInfo.len =
-            align_up(std::max(alignedend - alignedoffset,
-                              ExtentCache::option_.preAllocSize),
+            align_up(std::max(alignedend - alignedoffset, preAllocSize),
                      ExtentCache::option_.blockSize);
 
         if (upper != extents_.end()) {
@@ -388,6 +388,43 @@ void ExtentSlice::Merge(uint64_t loffset, const PExtent &extent) {
     }
 }
 
+bool ExtentSlice::TrimUnwritten(uint64_t offset,
+                                std::vector<Extent>* released) {
+    bool changed = false;
+    auto it = extents_.lower_bound(offset);
+    if (it != extents_.begin()) {
+        --it;
+    }
+
+    while (it != extents_.end()) {
+        const auto extStart = it->first;
+        const auto extEnd = it->first + it->second.len;
+
+        if (extEnd <= offset || !it->second.UnWritten) {
+            ++it;
+            continue;
+        }
+
+        changed = true;
+        if (extStart >= offset) {
+            // trim  |
+            // extent  |----|
+            released->emplace_back(it->second.pOffset, it->second.len);
+            it = extents_.erase(it);
+        } else {
+            // trim      |
+            // extent  |----|
+            const auto keep = offset - extStart;
+            released->emplace_back(it->second.pOffset + keep,
+                                   it->second.len - keep);
+            it->second.len = keep;
+            ++it;
+        }
+    }
+
+    return changed;
+}
+
 bool ExtentSlice::MarkWritten(uint64_t offset, uint64_t len) {
     bool changed = false;
     uint64_t curOff = offset;
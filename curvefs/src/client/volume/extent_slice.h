@@ -34,6 +34,7 @@ namespace curvefs {
 namespace client {
 
 using ::curvefs::metaserver::VolumeExtentSlice;
+using ::curvefs::volume::Extent;
 using ::curvefs::volume::ReadPart;
 using ::curvefs::volume::WritePart;
 
@@ -46,6 +47,7 @@ class ExtentSlice {
     void DivideForWrite(uint64_t offset,
                         uint64_t len,
                         const char* data,
+                        uint64_t preAllocSize,
                         std::vector<WritePart>* allocated,
                         std::vector<AllocPart>* needAlloc) const;
 
@@ -60,6 +62,10 @@ class ExtentSlice {
     // mark [off ~ len] written, return whether internal state is changed or not
     bool MarkWritten(uint64_t offset, uint64_t len);
 
+    // remove unwritten extents beyond offset, return whether internal state
+    // is changed or not
+    bool TrimUnwritten(uint64_t offset, std::vector<Extent>* released);
+
     VolumeExtentSlice ToVolumeExtentSlice() const;
 
     std::map<uint64_t, PExtent> GetExtentsForTesting() const;
@@ -47,6 +47,10 @@ class VolumeStorage {
 
     virtual bool Flush(uint64_t ino) = 0;
 
+    // release the preallocated but unwritten space of the file
+    // if it is not opened anymore
+    virtual bool Release(uint64_t ino) = 0;
+
     virtual bool Shutdown() = 0;
 };
 
@@ -32,7 +32,7 @@
 
 #include "include/curve_compiler_specific.h"
 #include "src/common/concurrent/count_down_event.h"
-#include "src/common/concurrent/task_queue.h"
+#include "src/common/concurrent/mpsc_queue.h"
 
 namespace curvefs {
 namespace metaserver {
@@ -74,7 +74,7 @@ class CURVE_CACHELINE_ALIGNMENT ApplyQueue {
 
         std::atomic<bool> running;
         std::thread worker;
-        curve::common::TaskQueue tasks;
+        curve::common::MPSCTaskQueue tasks;
     };
 
  private:
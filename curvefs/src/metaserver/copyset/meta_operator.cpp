@@ -150,6 +150,13 @@ bool GetVolumeExtentOperator::CanBypassPropose() const {
            node_->GetAppliedIndex() >= req->appliedindex();
 }
 
+bool GetS3ChunkInfoRangeOperator::CanBypassPropose() const {
+    const auto* req =
+        static_cast<const GetS3ChunkInfoRangeRequest*>(request_);
+    return req->has_appliedindex() &&
+           node_->GetAppliedIndex() >= req->appliedindex();
+}
+
 #define OPERATOR_ON_APPLY(TYPE)                                        \
     void TYPE##Operator::OnApply(int64_t index,                        \
                                  google::protobuf::Closure* done,      \
@@ -193,6 +200,7 @@ OPERATOR_ON_APPLY(CreatePartition);
 OPERATOR_ON_APPLY(DeletePartition);
 OPERATOR_ON_APPLY(PrepareRenameTx);
 OPERATOR_ON_APPLY(UpdateVolumeExtent);;
+OPERATOR_ON_APPLY(GetS3ChunkInfoRange);
 
 #undef OPERATOR_ON_APPLY
 
@@ -348,6 +356,7 @@ READONLY_OPERATOR_ON_APPLY_FROM_LOG(GetInode);
 READONLY_OPERATOR_ON_APPLY_FROM_LOG(BatchGetInodeAttr);
 READONLY_OPERATOR_ON_APPLY_FROM_LOG(BatchGetXAttr);
 READONLY_OPERATOR_ON_APPLY_FROM_LOG(GetVolumeExtent);
+READONLY_OPERATOR_ON_APPLY_FROM_LOG(GetS3ChunkInfoRange);
 
 #undef READONLY_OPERATOR_ON_APPLY_FROM_LOG
 
@@ -374,6 +383,7 @@ OPERATOR_REDIRECT(DeletePartition);
 OPERATOR_REDIRECT(PrepareRenameTx);
 OPERATOR_REDIRECT(GetVolumeExtent);
 OPERATOR_REDIRECT(UpdateVolumeExtent);
+OPERATOR_REDIRECT(GetS3ChunkInfoRange);
 
 #undef OPERATOR_REDIRECT
 
@@ -399,6 +409,7 @@ OPERATOR_ON_FAILED(DeletePartition);
 OPERATOR_ON_FAILED(PrepareRenameTx);
 OPERATOR_ON_FAILED(GetVolumeExtent);
 OPERATOR_ON_FAILED(UpdateVolumeExtent);
+OPERATOR_ON_FAILED(GetS3ChunkInfoRange);
 
 #undef OPERATOR_ON_FAILED
 
@@ -423,6 +434,7 @@ OPERATOR_HASH_CODE(PrepareRenameTx);
 OPERATOR_HASH_CODE(DeletePartition);
 OPERATOR_HASH_CODE(GetVolumeExtent);
 OPERATOR_HASH_CODE(UpdateVolumeExtent);
+OPERATOR_HASH_CODE(GetS3ChunkInfoRange);
 
 #undef OPERATOR_HASH_CODE
 
@@ -459,6 +471,7 @@ OPERATOR_TYPE(CreatePartition);
 OPERATOR_TYPE(DeletePartition);
 OPERATOR_TYPE(GetVolumeExtent);
 OPERATOR_TYPE(UpdateVolumeExtent);
+OPERATOR_TYPE(GetS3ChunkInfoRange);
 
 #undef OPERATOR_TYPE
 
@@ -498,6 +498,27 @@ class GetVolumeExtentOperator : public MetaOperator {
     bool CanBypassPropose() const override;
 };
 
+class GetS3ChunkInfoRangeOperator : public MetaOperator {
+ public:
+    using MetaOperator::MetaOperator;
+
+    void OnApply(int64_t index, google::protobuf::Closure* done,
+                 uint64_t startTimeUs) override;
+
+    void OnApplyFromLog(uint64_t startTimeUs) override;
+
+    uint64_t HashCode() const override;
+
+    OperatorType GetOperatorType() const override;
+
+ private:
+    void Redirect() override;
+
+    void OnFailed(MetaStatusCode code) override;
+
+    bool CanBypassPropose() const override;
+};
+
 class UpdateVolumeExtentOperator : public MetaOperator {
  public:
     using MetaOperator::MetaOperator;
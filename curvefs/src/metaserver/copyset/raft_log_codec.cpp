@@ -162,6 +162,10 @@ std::unique_ptr<MetaOperator> RaftLogCodec::Decode(CopysetNode* node,
             return ParseFromRaftLog<UpdateVolumeExtentOperator,
                                     UpdateVolumeExtentRequest>(node, type,
                                                                meta);
+        case OperatorType::GetS3ChunkInfoRange:
+            return ParseFromRaftLog<GetS3ChunkInfoRangeOperator,
+                                    GetS3ChunkInfoRangeRequest>(node, type,
+                                                                meta);
         // Add new case before `OperatorType::OperatorTypeMax`
         case OperatorType::OperatorTypeMax:
             break;
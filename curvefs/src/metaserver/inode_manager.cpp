@@ -388,6 +388,19 @@ MetaStatusCode InodeManager::PaddingInodeS3ChunkInfo(int32_t fsId,
     return inodeStorage_->PaddingInodeS3ChunkInfo(fsId, inodeId, m, limit);
 }
 
+MetaStatusCode InodeManager::GetS3ChunkInfoRange(uint32_t fsId,
+                                                 uint64_t inodeId,
+                                                 uint64_t chunkIndex,
+                                                 uint64_t offset,
+                                                 uint64_t len,
+                                                 S3ChunkInfoSlices* slices) {
+    VLOG(6) << "GetS3ChunkInfoRange, fsId: " << fsId
+            << ", inodeId: " << inodeId << ", chunkIndex: " << chunkIndex
+            << ", offset: " << offset << ", len: " << len;
+    return inodeStorage_->GetS3ChunkInfoSlices(fsId, inodeId, chunkIndex,
+                                               offset, len, slices);
+}
+
 MetaStatusCode InodeManager::UpdateInodeWhenCreateOrRemoveSubNode(
     uint32_t fsId, uint64_t inodeId, FsFileType type, bool isCreate) {
     VLOG(6) << "UpdateInodeWhenCreateOrRemoveSubNode, fsId = " << fsId
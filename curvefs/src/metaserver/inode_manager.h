@@ -90,6 +90,13 @@ class InodeManager {
                                            S3ChunkInfoMap* m,
                                            uint64_t limit = 0);
 
+    MetaStatusCode GetS3ChunkInfoRange(uint32_t fsId,
+                                       uint64_t inodeId,
+                                       uint64_t chunkIndex,
+                                       uint64_t offset,
+                                       uint64_t len,
+                                       S3ChunkInfoSlices* slices);
+
     MetaStatusCode UpdateInodeWhenCreateOrRemoveSubNode(uint32_t fsId,
         uint64_t inodeId, FsFileType type, bool isCreate);
 
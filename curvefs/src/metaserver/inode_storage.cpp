@@ -20,6 +20,8 @@
  * Author: chenwei
  */
 
+#include <gflags/gflags.h>
+
 #include <limits>
 #include <string>
 #include <memory>
@@ -52,6 +54,10 @@ using ::curvefs::metaserver::storage::Key4InodeAuxInfo;
 using Transaction = std::shared_ptr<StorageTransaction>;
 using S3ChunkInfoMap = google::protobuf::Map<uint64_t, S3ChunkInfoList>;
 
+DEFINE_uint64(s3chunkinfo_index_cache_capacity, 65536,
+              "max number of the cached s3chunkinfo interval index, "
+              "one index per chunk");
+
 InodeStorage::InodeStorage(std::shared_ptr<KVStorage> kvStorage,
                            std::shared_ptr<NameGenerator> nameGenerator,
                            uint64_t nInode)
@@ -61,7 +67,9 @@ InodeStorage::InodeStorage(std::shared_ptr<KVStorage> kvStorage,
       table4VolumeExtent_(nameGenerator->GetVolumnExtentTableName()),
       table4InodeAuxInfo_(nameGenerator->GetInodeAuxInfoTableName()),
       nInode_(nInode),
-      conv_() {}
+      conv_(),
+      s3ChunkInfoIndexCache_(new S3ChunkInfoIndexCache(
+          FLAGS_s3chunkinfo_index_cache_capacity)) {}
 
 MetaStatusCode InodeStorage::Insert(const Inode& inode) {
     WriteLockGuard lg(rwLock_);
@@ -258,6 +266,8 @@ MetaStatusCode InodeStorage::Clear() {
     nInode_ = 0;
 
     s = kvStorage_->SClear(table4S3ChunkInfo_);
+    s3ChunkInfoIndexCache_.reset(new S3ChunkInfoIndexCache(
+        FLAGS_s3chunkinfo_index_cache_capacity));
     if (!s.ok()) {
         LOG(ERROR) << "InodeStorage clear inode s3chunkinfo table failed";
         return MetaStatusCode::STORAGE_INTERNAL_ERROR;
@@ -442,6 +452,7 @@ MetaStatusCode InodeStorage::ModifyInodeS3ChunkInfoList(
     }
 
     // rc == MetaStatusCode::OK
+    UpdateS3ChunkInfoIndex(fsId, inodeId, chunkIndex, list2add, list2del);
     uint64_t size4add = (nullptr == list2add) ? 0 : list2add->s3chunks_size();
     uint64_t size4del = (nullptr == list2del) ? 0 : list2del->s3chunks_size();
     if (!UpdateInodeS3MetaSize(fsId, inodeId, size4add, size4del)) {
@@ -509,6 +520,77 @@ std::shared_ptr<Iterator> InodeStorage::GetAllS3ChunkInfoList() {
     return kvStorage_->SGetAll(table4S3ChunkInfo_);
 }
 
+void InodeStorage::UpdateS3ChunkInfoIndex(uint32_t fsId,
+                                          uint64_t inodeId,
+                                          uint64_t chunkIndex,
+                                          const S3ChunkInfoList* list2add,
+                                          const S3ChunkInfoList* list2del) {
+    Prefix4ChunkIndexS3ChunkInfoList prefix(fsId, inodeId, chunkIndex);
+    std::string sprefix = conv_.SerializeToString(prefix);
+
+    std::shared_ptr<S3ChunkInfoIndex> index;
+    if (!s3ChunkInfoIndexCache_->Get(sprefix, &index)) {
+        return;
+    }
+
+    // the deleted s3chunkinfos (by compaction) can't be removed from the
+    // index, and the lists are ordered by chunk id in storage, so we
+    // rebuild the index at next query unless the added list is the newest
+    bool deleted = nullptr != list2del && list2del->s3chunks_size() > 0;
+    bool added = nullptr != list2add && list2add->s3chunks_size() > 0;
+    if (deleted ||
+        (added && list2add->s3chunks(0).chunkid() <= index->MaxChunkId())) {
+        s3ChunkInfoIndexCache_->Remove(sprefix);
+    } else if (added) {
+        index->Add(*list2add);
+    }
+}
+
+MetaStatusCode InodeStorage::LoadS3ChunkInfoIndex(const std::string& sprefix,
+                                                  S3ChunkInfoIndex* index) {
+    auto iterator = kvStorage_->SSeek(table4S3ChunkInfo_, sprefix);
+    if (iterator->Status() != 0) {
+        LOG(ERROR) << "Get iterator failed, prefix=" << sprefix;
+        return MetaStatusCode::STORAGE_INTERNAL_ERROR;
+    }
+
+    // the lists are ordered by chunk id, that is from old to new
+    S3ChunkInfoList list;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        if (!StringStartWith(iterator->Key(), sprefix)) {
+            break;
+        } else if (!iterator->ParseFromValue(&list)) {
+            return MetaStatusCode::PARSE_FROM_STRING_FAILED;
+        }
+        index->Add(list);
+    }
+    return MetaStatusCode::OK;
+}
+
+MetaStatusCode InodeStorage::GetS3ChunkInfoSlices(uint32_t fsId,
+                                                  uint64_t inodeId,
+                                                  uint64_t chunkIndex,
+                                                  uint64_t offset,
+                                                  uint64_t len,
+                                                  S3ChunkInfoSlices* slices) {
+    ReadLockGuard lg(rwLock_);
+    Prefix4ChunkIndexS3ChunkInfoList prefix(fsId, inodeId, chunkIndex);
+    std::string sprefix = conv_.SerializeToString(prefix);
+
+    std::shared_ptr<S3ChunkInfoIndex> index;
+    if (!s3ChunkInfoIndexCache_->Get(sprefix, &index)) {
+        index = std::make_shared<S3ChunkInfoIndex>();
+        auto rc = LoadS3ChunkInfoIndex(sprefix, index.get());
+        if (rc != MetaStatusCode::OK) {
+            return rc;
+        }
+        s3ChunkInfoIndexCache_->Put(sprefix, index);
+    }
+
+    index->Query(offset, len, slices);
+    return MetaStatusCode::OK;
+}
+
 std::shared_ptr<Iterator> InodeStorage::GetAllVolumeExtentList() {
     ReadLockGuard guard(rwLock_);
     return kvStorage_->SGetAll(table4VolumeExtent_);
@@ -34,7 +34,9 @@
 #include "absl/container/btree_set.h"
 #include "absl/container/btree_map.h"
 #include "src/common/concurrent/rw_lock.h"
+#include "src/common/lru_cache.h"
 #include "curvefs/proto/metaserver.pb.h"
+#include "curvefs/src/metaserver/s3chunkinfo_index.h"
 #include "curvefs/src/metaserver/storage/converter.h"
 #include "curvefs/src/metaserver/storage/utils.h"
 #include "curvefs/src/metaserver/storage/storage.h"
@@ -43,6 +45,7 @@ namespace curvefs {
 namespace metaserver {
 
 using ::curve::common::RWLock;
+using ::curve::common::LRUCache;
 using ::curvefs::metaserver::storage::Iterator;
 using ::curvefs::metaserver::storage::KVStorage;
 using ::curvefs::metaserver::storage::StorageTransaction;
@@ -132,6 +135,18 @@ class InodeStorage {
 
     std::shared_ptr<Iterator> GetAllS3ChunkInfoList();
 
+    /**
+     * @brief get the visible s3chunkinfo slices of the chunk
+     *        in [offset, offset + len), which are resolved by the
+     *        interval index of the chunk.
+     */
+    MetaStatusCode GetS3ChunkInfoSlices(uint32_t fsId,
+                                        uint64_t inodeId,
+                                        uint64_t chunkIndex,
+                                        uint64_t offset,
+                                        uint64_t len,
+                                        S3ChunkInfoSlices* slices);
+
     // volume extent
     std::shared_ptr<Iterator> GetAllVolumeExtentList();
 
@@ -168,7 +183,19 @@ class InodeStorage {
         uint64_t chunkIndex,
         const S3ChunkInfoList* list2del);
 
+    MetaStatusCode LoadS3ChunkInfoIndex(const std::string& sprefix,
+                                        S3ChunkInfoIndex* index);
+
+    void UpdateS3ChunkInfoIndex(uint32_t fsId,
+                                uint64_t inodeId,
+                                uint64_t chunkIndex,
+                                const S3ChunkInfoList* list2add,
+                                const S3ChunkInfoList* list2del);
+
  private:
+    using S3ChunkInfoIndexCache =
+        LRUCache<std::string, std::shared_ptr<S3ChunkInfoIndex>>;
+
     // FIXME: please remove this lock, because we has locked each inode
     // in inode manager, this lock only for proetct storage, but now we
     // use rocksdb storage, it support write in parallel.
@@ -180,6 +207,9 @@ class InodeStorage {
     std::string table4InodeAuxInfo_;
     size_t nInode_;
     Converter conv_;
+    // chunk prefix => interval index, the cached index is modified under
+    // the write lock, and queried under the read lock
+    std::unique_ptr<S3ChunkInfoIndexCache> s3ChunkInfoIndexCache_;
 };
 
 }  // namespace metaserver
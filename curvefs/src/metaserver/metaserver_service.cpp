@@ -44,6 +44,7 @@ using ::curvefs::metaserver::copyset::CreateInodeOperator;
 using ::curvefs::metaserver::copyset::CreateRootInodeOperator;
 using ::curvefs::metaserver::copyset::UpdateInodeOperator;
 using ::curvefs::metaserver::copyset::GetOrModifyS3ChunkInfoOperator;
+using ::curvefs::metaserver::copyset::GetS3ChunkInfoRangeOperator;
 using ::curvefs::metaserver::copyset::DeleteInodeOperator;
 using ::curvefs::metaserver::copyset::UpdateInodeS3VersionOperator;
 using ::curvefs::metaserver::copyset::CreatePartitionOperator;
@@ -223,6 +224,17 @@ void MetaServerServiceImpl::GetOrModifyS3ChunkInfo(
                                                  request->copysetid());
 }
 
+void MetaServerServiceImpl::GetS3ChunkInfoRange(
+    ::google::protobuf::RpcController* controller,
+    const GetS3ChunkInfoRangeRequest* request,
+    GetS3ChunkInfoRangeResponse* response,
+    ::google::protobuf::Closure* done) {
+    OperatorHelper helper(copysetNodeManager_, inflightThrottle_);
+    helper.operator()<GetS3ChunkInfoRangeOperator>(
+        controller, request, response, done, request->poolid(),
+        request->copysetid());
+}
+
 void MetaServerServiceImpl::DeleteInode(
     ::google::protobuf::RpcController* controller,
     const ::curvefs::metaserver::DeleteInodeRequest* request,
@@ -88,6 +88,10 @@ class MetaServerServiceImpl : public MetaServerService {
         const ::curvefs::metaserver::GetOrModifyS3ChunkInfoRequest* request,
         ::curvefs::metaserver::GetOrModifyS3ChunkInfoResponse* response,
         ::google::protobuf::Closure* done) override;
+    void GetS3ChunkInfoRange(::google::protobuf::RpcController* controller,
+                             const GetS3ChunkInfoRangeRequest* request,
+                             GetS3ChunkInfoRangeResponse* response,
+                             ::google::protobuf::Closure* done) override;
     void DeleteInode(::google::protobuf::RpcController* controller,
                      const ::curvefs::metaserver::DeleteInodeRequest* request,
                      ::curvefs::metaserver::DeleteInodeResponse* response,
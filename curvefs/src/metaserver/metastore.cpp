@@ -394,6 +394,21 @@ MetaStatusCode MetaStoreImpl::ListDentry(const ListDentryRequest* request,
     if (rc == MetaStatusCode::OK && !dentrys.empty()) {
         *response->mutable_dentrys() = {dentrys.begin(), dentrys.end()};
     }
+
+    // readdirplus needs the attr of every dentry, the inodes in this
+    // partition are returned together to save the extra rpc
+    if (rc == MetaStatusCode::OK && request->needattr()) {
+        for (const auto& item : dentrys) {
+            if (!partition->IsInodeBelongs(fsId, item.inodeid())) {
+                continue;
+            }
+            InodeAttr attr;
+            if (partition->GetInodeAttr(fsId, item.inodeid(), &attr) ==
+                MetaStatusCode::OK) {
+                *response->add_attrs() = std::move(attr);
+            }
+        }
+    }
     return rc;
 }
 
@@ -688,6 +703,28 @@ std::shared_ptr<Partition> MetaStoreImpl::GetPartition(uint32_t partitionId) {
     return nullptr;
 }
 
+MetaStatusCode MetaStoreImpl::GetS3ChunkInfoRange(
+    const GetS3ChunkInfoRangeRequest* request,
+    GetS3ChunkInfoRangeResponse* response) {
+    ReadLockGuard guard(rwLock_);
+    auto partition = GetPartition(request->partitionid());
+    if (!partition) {
+        auto st = MetaStatusCode::PARTITION_NOT_FOUND;
+        response->set_statuscode(st);
+        return st;
+    }
+
+    auto st = partition->GetS3ChunkInfoRange(
+        request->fsid(), request->inodeid(), request->chunkindex(),
+        request->offset(), request->len(), response->mutable_slices());
+    if (st != MetaStatusCode::OK) {
+        response->clear_slices();
+    }
+
+    response->set_statuscode(st);
+    return st;
+}
+
 MetaStatusCode MetaStoreImpl::GetVolumeExtent(
     const GetVolumeExtentRequest* request,
     GetVolumeExtentResponse* response) {
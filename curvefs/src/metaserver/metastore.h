@@ -156,6 +156,10 @@ class MetaStore {
         std::shared_ptr<StreamConnection> connection,
         std::shared_ptr<Iterator> iterator) = 0;
 
+    virtual MetaStatusCode GetS3ChunkInfoRange(
+        const GetS3ChunkInfoRangeRequest* request,
+        GetS3ChunkInfoRangeResponse* response) = 0;
+
     virtual MetaStatusCode GetVolumeExtent(
         const GetVolumeExtentRequest* request,
         GetVolumeExtentResponse* response) = 0;
@@ -236,6 +240,10 @@ class MetaStoreImpl : public MetaStore {
         std::shared_ptr<StreamConnection> connection,
         std::shared_ptr<Iterator> iterator) override;
 
+    MetaStatusCode GetS3ChunkInfoRange(
+        const GetS3ChunkInfoRangeRequest* request,
+        GetS3ChunkInfoRangeResponse* response) override;
+
     MetaStatusCode GetVolumeExtent(const GetVolumeExtentRequest* request,
                                    GetVolumeExtentResponse* response) override;
 
@@ -105,6 +105,13 @@ class Partition {
                                            S3ChunkInfoMap* m,
                                            uint64_t limit = 0);
 
+    MetaStatusCode GetS3ChunkInfoRange(uint32_t fsId,
+                                       uint64_t inodeId,
+                                       uint64_t chunkIndex,
+                                       uint64_t offset,
+                                       uint64_t len,
+                                       S3ChunkInfoSlices* slices);
+
     MetaStatusCode UpdateVolumeExtent(uint32_t fsId,
                                       uint64_t inodeId,
                                       const VolumeExtentList& extents);
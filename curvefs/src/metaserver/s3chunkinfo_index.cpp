@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "curvefs/src/metaserver/s3chunkinfo_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace curvefs {
+namespace metaserver {
+
+void S3ChunkInfoIndex::Add(const S3ChunkInfo& info) {
+    maxChunkId_ = std::max(maxChunkId_, info.chunkid());
+    if (info.len() == 0) {
+        return;
+    }
+
+    uint64_t begin = info.offset();
+    uint64_t end = info.offset() + info.len();
+    auto ptr = std::make_shared<const S3ChunkInfo>(info);
+
+    // previous slice:  [      ]      or  [            ]
+    // new slice     :      [     ]          [     ]
+    auto iter = slices_.lower_bound(begin);
+    if (iter != slices_.begin()) {
+        auto prev = std::prev(iter);
+        if (prev->second.end > begin) {
+            if (prev->second.end > end) {
+                slices_.emplace(end, Slice{prev->second.end,
+                                           prev->second.info});
+            }
+            prev->second.end = begin;
+        }
+    }
+
+    // slices start in the new slice are covered, except the tail
+    while (iter != slices_.end() && iter->first < end) {
+        if (iter->second.end > end) {
+            Slice tail{iter->second.end, iter->second.info};
+            iter = slices_.erase(iter);
+            slices_.emplace_hint(iter, end, std::move(tail));
+            break;
+        }
+        iter = slices_.erase(iter);
+    }
+
+    slices_.emplace(begin, Slice{end, std::move(ptr)});
+}
+
+void S3ChunkInfoIndex::Add(const S3ChunkInfoList& list) {
+    for (const auto& info : list.s3chunks()) {
+        Add(info);
+    }
+}
+
+void S3ChunkInfoIndex::Query(uint64_t offset, uint64_t len,
+                             S3ChunkInfoSlices* slices) const {
+    if (len == 0) {
+        return;
+    }
+
+    uint64_t end = offset + len;
+    auto iter = slices_.upper_bound(offset);
+    if (iter != slices_.begin() && std::prev(iter)->second.end > offset) {
+        --iter;
+    }
+
+    for (; iter != slices_.end() && iter->first < end; ++iter) {
+        uint64_t sliceBegin = std::max(iter->first, offset);
+        uint64_t sliceEnd = std::min(iter->second.end, end);
+        auto* slice = slices->Add();
+        slice->set_offset(sliceBegin);
+        slice->set_len(sliceEnd - sliceBegin);
+        slice->mutable_chunkinfo()->CopyFrom(*iter->second.info);
+    }
+}
+
+}  // namespace metaserver
+}  // namespace curvefs
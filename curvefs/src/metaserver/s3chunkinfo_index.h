@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef CURVEFS_SRC_METASERVER_S3CHUNKINFO_INDEX_H_
+#define CURVEFS_SRC_METASERVER_S3CHUNKINFO_INDEX_H_
+
+#include <map>
+#include <memory>
+
+#include "curvefs/proto/metaserver.pb.h"
+
+namespace curvefs {
+namespace metaserver {
+
+using S3ChunkInfoSlices = google::protobuf::RepeatedPtrField<S3ChunkInfoSlice>;
+
+/**
+ * Interval index of the s3chunkinfos of one chunk. The s3chunkinfos are
+ * added from old to new, and the newer one covers the older ones where
+ * they overlap, so the index only keeps the visible and non-overlapping
+ * slices, and a range query costs O(log n + k) instead of walking the
+ * whole s3chunkinfo list.
+ */
+class S3ChunkInfoIndex {
+ public:
+    S3ChunkInfoIndex() = default;
+
+    /**
+     * @brief add the s3chunkinfo, which is newer than all added before
+     */
+    void Add(const S3ChunkInfo& info);
+
+    void Add(const S3ChunkInfoList& list);
+
+    /**
+     * @brief get the visible slices in [offset, offset + len),
+     *        the slices are clipped to the range and ordered by offset
+     */
+    void Query(uint64_t offset, uint64_t len,
+               S3ChunkInfoSlices* slices) const;
+
+    // number of the visible slices
+    size_t Size() const { return slices_.size(); }
+
+    // max chunk id of the added s3chunkinfos
+    uint64_t MaxChunkId() const { return maxChunkId_; }
+
+ private:
+    struct Slice {
+        uint64_t end;
+        std::shared_ptr<const S3ChunkInfo> info;
+    };
+
+    // begin offset => slice
+    std::map<uint64_t, Slice> slices_;
+    uint64_t maxChunkId_ = 0;
+};
+
+}  // namespace metaserver
+}  // namespace curvefs
+
+#endif  // CURVEFS_SRC_METASERVER_S3CHUNKINFO_INDEX_H_
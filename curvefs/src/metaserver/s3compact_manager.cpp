@@ -30,6 +30,7 @@
 #include "curvefs/src/metaserver/s3compact_wq_impl.h"
 
 using curve::common::Configuration;
+using curve::common::InitS3AdaptorCompressionOption;
 using curve::common::InitS3AdaptorOptionExceptS3InfoOption;
 using curve::common::ReadLockGuard;
 using curve::common::S3Adapter;
@@ -121,6 +122,7 @@ void S3CompactWorkQueueOption::Init(std::shared_ptr<Configuration> conf) {
     conf->GetValueFatalIfFail("s3.throttle.bpsTotalMB", &s3opts.bpsTotalMB);
     conf->GetValueFatalIfFail("s3.throttle.bpsReadMB", &s3opts.bpsReadMB);
     conf->GetValueFatalIfFail("s3.throttle.bpsWriteMB", &s3opts.bpsWriteMB);
+    InitS3AdaptorCompressionOption(conf.get(), &s3opts);
     conf->GetValueFatalIfFail("s3compactwq.enable", &enable);
     conf->GetValueFatalIfFail("s3compactwq.thread_num", &threadNum);
     conf->GetValueFatalIfFail("s3compactwq.queue_size", &queueSize);
@@ -133,6 +135,8 @@ void S3CompactWorkQueueOption::Init(std::shared_ptr<Configuration> conf) {
     conf->GetValueFatalIfFail("s3compactwq.s3_read_max_retry", &s3ReadMaxRetry);
     conf->GetValueFatalIfFail("s3compactwq.s3_read_retry_interval",
                               &s3ReadRetryInterval);
+    conf->GetValueFatalIfFail("s3compactwq.s3_bandwidth_limit_mb",
+                              &s3BandwidthLimitMB);
 }
 
 void S3CompactManager::Init(std::shared_ptr<Configuration> conf) {
@@ -80,6 +80,7 @@ struct S3CompactWorkQueueOption {
     uint64_t s3infocacheSize;
     uint64_t s3ReadMaxRetry;
     uint64_t s3ReadRetryInterval;
+    uint64_t s3BandwidthLimitMB;
 
     void Init(std::shared_ptr<Configuration> conf);
 };
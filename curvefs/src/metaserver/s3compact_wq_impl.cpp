@@ -28,6 +28,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -43,6 +44,7 @@ using curve::common::S3Adapter;
 using curve::common::S3AdapterOption;
 using curve::common::TaskThreadPool;
 using curvefs::metaserver::copyset::GetOrModifyS3ChunkInfoOperator;
+using curvefs::metaserver::storage::Key4S3ChunkInfoList;
 
 namespace curvefs {
 namespace metaserver {
@@ -109,35 +111,160 @@ void S3CompactWorkQueueImpl::ThreadFunc() {
     }
 }
 
-std::vector<uint64_t> S3CompactWorkQueueImpl::GetNeedCompact(
+namespace {
+
+// union of the ranges added
+class RangeSet {
+ public:
+    // add range [begin, end), return the bytes not covered before
+    uint64_t Add(uint64_t begin, uint64_t end) {
+        if (begin >= end) {
+            return 0;
+        }
+
+        uint64_t covered = 0;
+        uint64_t newBegin = begin;
+        uint64_t newEnd = end;
+        auto it = ranges_.upper_bound(begin);
+        if (it != ranges_.begin() && std::prev(it)->second >= begin) {
+            --it;
+        }
+        while (it != ranges_.end() && it->first <= end) {
+            if (it->first < end && it->second > begin) {
+                covered += std::min(it->second, end) -
+                           std::max(it->first, begin);
+            }
+            newBegin = std::min(newBegin, it->first);
+            newEnd = std::max(newEnd, it->second);
+            it = ranges_.erase(it);
+        }
+        ranges_.emplace(newBegin, newEnd);
+
+        return end - begin - covered;
+    }
+
+ private:
+    // begin -> end
+    std::map<uint64_t, uint64_t> ranges_;
+};
+
+}  // namespace
+
+std::vector<struct S3CompactWorkQueueImpl::CompactPlan>
+S3CompactWorkQueueImpl::GetNeedCompact(
     const ::google::protobuf::Map<uint64_t, S3ChunkInfoList>& s3chunkinfoMap,
     uint64_t inodeLen, uint64_t chunkSize) {
-    std::vector<uint64_t> needCompact;
+    std::vector<struct CompactPlan> plans;
     for (const auto& item : s3chunkinfoMap) {
-        if (needCompact.size() >= opts_.maxChunksPerCompact) {
-            VLOG(9) << "s3compact: reach max chunks to compact per time";
-            break;
-        }
+        const auto& l = item.second;
+        const int size = l.s3chunks_size();
+        struct CompactPlan plan {
+            item.first, size, false, 0, 0
+        };
         if (item.first * chunkSize > inodeLen - 1) {
             // we need delete this chunk
-            needCompact.push_back(item.first);
+            plan.truncated = true;
+            plans.push_back(plan);
+            continue;
+        }
+
+        // the last s3chunkinfo which overlaps the earlier ones or is partly
+        // beyond the file, the s3chunkinfos after it are all valid
+        int last = -1;
+        bool beyond = false;
+        RangeSet earlier;
+        for (int i = 0; i < size; i++) {
+            const auto& info = l.s3chunks(i);
+            const uint64_t end = info.offset() + info.len();
+            if (earlier.Add(info.offset(), end) < info.len()) {
+                plan.overlapped++;
+                last = i;
+            }
+            if (end > inodeLen) {
+                // part of chunk is useless, we need to delete them
+                beyond = true;
+                last = i;
+            }
+        }
+
+        if (static_cast<uint64_t>(size) <= opts_.fragmentThreshold &&
+            !beyond) {
             continue;
         }
-        if (static_cast<uint64_t>(item.second.s3chunks_size()) >
+
+        const uint64_t chunkBegin = item.first * chunkSize;
+        const uint64_t chunkEnd = std::min(chunkBegin + chunkSize, inodeLen);
+        RangeSet later;
+        for (int i = size - 1; i >= 0; i--) {
+            const auto& info = l.s3chunks(i);
+            const uint64_t begin = std::max(info.offset(), chunkBegin);
+            const uint64_t end =
+                std::min(info.offset() + info.len(), chunkEnd);
+            plan.deadBytes += info.len() - later.Add(begin, end);
+        }
+
+        // only merge the overlapped part, unless there are still too many
+        // fragments after it
+        plan.mergeCount = last + 1;
+        if (static_cast<uint64_t>(size - plan.mergeCount) >
             opts_.fragmentThreshold) {
-            needCompact.push_back(item.first);
-        } else {
-            const auto& l = item.second;
-            for (int i = 0; i < l.s3chunks_size(); i++) {
-                if (l.s3chunks(i).offset() + l.s3chunks(i).len() > inodeLen) {
-                    // part of chunk is useless, we need to delete them
-                    needCompact.push_back(item.first);
-                    break;
-                }
+            plan.mergeCount = size;
+        }
+        plans.push_back(plan);
+    }
+
+    // the most garbage first
+    std::sort(plans.begin(), plans.end(),
+              [](const struct CompactPlan& a, const struct CompactPlan& b) {
+                  return std::make_tuple(a.truncated, a.overlapped,
+                                         a.deadBytes) >
+                         std::make_tuple(b.truncated, b.overlapped,
+                                         b.deadBytes);
+              });
+    if (plans.size() > opts_.maxChunksPerCompact) {
+        VLOG(9) << "s3compact: reach max chunks to compact per time";
+        plans.resize(opts_.maxChunksPerCompact);
+    }
+    return plans;
+}
+
+void S3CompactWorkQueueImpl::AlignToStoredList(
+    const struct S3CompactTask& task, const Inode& inode,
+    std::vector<struct CompactPlan>* plans) {
+    // end position of every stored list in the s3chunkinfo list of chunk
+    std::unordered_map<uint64_t, std::vector<int>> listEnds;
+    std::shared_ptr<Iterator> iterator;
+    MetaStatusCode ret = task.inodeManager->GetOrModifyS3ChunkInfo(
+        inode.fsid(), inode.inodeid(), S3ChunkInfoMap(), S3ChunkInfoMap(),
+        true, &iterator);
+    if (ret == MetaStatusCode::OK) {
+        Key4S3ChunkInfoList key;
+        for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+            if (!key.ParseFromString(iterator->Key())) {
+                ret = MetaStatusCode::PARSE_FROM_STRING_FAILED;
+                break;
             }
+            auto& ends = listEnds[key.chunkIndex];
+            ends.push_back((ends.empty() ? 0 : ends.back()) + key.size);
         }
     }
-    return needCompact;
+
+    if (ret != MetaStatusCode::OK) {
+        LOG(WARNING) << "s3compact: get s3chunkinfo lists failed, merge full "
+                     << "chunks, ret = " << MetaStatusCode_Name(ret);
+    }
+
+    for (auto& plan : *plans) {
+        const int size =
+            inode.s3chunkinfomap().at(plan.index).s3chunks_size();
+        if (ret != MetaStatusCode::OK) {
+            plan.mergeCount = size;
+            continue;
+        }
+        const auto& ends = listEnds[plan.index];
+        auto it = std::lower_bound(ends.begin(), ends.end(), plan.mergeCount);
+        plan.mergeCount = it == ends.end() ? size : std::min(*it, size);
+    }
 }
 
 void S3CompactWorkQueueImpl::DeleteObjs(const std::vector<std::string>& objs,
@@ -511,14 +638,29 @@ S3Adapter* S3CompactWorkQueueImpl::SetupS3Adapter(uint64_t fsId,
 }
 
 void S3CompactWorkQueueImpl::CompactChunk(
-    const struct S3CompactCtx& compactCtx, uint64_t index, const Inode& inode,
+    const struct S3CompactCtx& compactCtx, const struct CompactPlan& plan,
+    const Inode& inode,
     std::unordered_map<uint64_t, std::vector<std::string>>* objsAddedMap,
     ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoAdd,
     ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoRemove) {
+    const uint64_t index = plan.index;
     auto cleanup = absl::MakeCleanup(
         [&]() { VLOG(6) << "s3compact: exit index " << index; });
-    VLOG(6) << "s3compact: begin to compact index " << index;
-    const auto& s3chunkinfolist = inode.s3chunkinfomap().at(index);
+    VLOG(6) << "s3compact: begin to compact index " << index
+            << ", merge count: " << plan.mergeCount
+            << ", overlapped: " << plan.overlapped
+            << ", dead bytes: " << plan.deadBytes;
+    // only merge the first mergeCount s3chunkinfos, the later ones don't
+    // overlap them, so the merged one can be put before them
+    const auto& fullList = inode.s3chunkinfomap().at(index);
+    S3ChunkInfoList s3chunkinfolist;
+    if (plan.mergeCount >= fullList.s3chunks_size()) {
+        s3chunkinfolist = fullList;
+    } else {
+        for (int i = 0; i < plan.mergeCount; i++) {
+            *s3chunkinfolist.add_s3chunks() = fullList.s3chunks(i);
+        }
+    }
     // 1.1 build valid list
     std::list<struct S3CompactWorkQueueImpl::Node> validList(BuildValidList(
         s3chunkinfolist, inode.length(), index, compactCtx.chunkSize));
@@ -536,6 +678,11 @@ void S3CompactWorkQueueImpl::CompactChunk(
         return;
     }
     // 1.2  first read full chunk
+    uint64_t validBytes = 0;
+    for (const auto& node : validList) {
+        validBytes += node.end - node.begin + 1;
+    }
+    throttle_.Add(true, validBytes);
     struct S3NewChunkInfo newChunkInfo;
     std::string fullChunk;
     int ret = ReadFullChunk(compactCtx, validList, &fullChunk, &newChunkInfo);
@@ -551,6 +698,7 @@ void S3CompactWorkQueueImpl::CompactChunk(
             << ", compaction:" << newChunkInfo.newCompaction;
     // 1.3 then write objs with newChunkid and newCompaction
     std::vector<std::string> objsAdded;
+    throttle_.Add(false, fullChunk.size());
     ret = WriteFullChunk(compactCtx, newChunkInfo, fullChunk, &objsAdded);
     if (ret != 0) {
         LOG(WARNING) << "s3compact: WriteFullChunk failed, index " << index;
@@ -629,12 +777,13 @@ void S3CompactWorkQueueImpl::CompactChunks(const struct S3CompactTask& task) {
                                           &blockSize, &chunkSize);
     if (s3adapter == nullptr) return;
     // need compact?
-    std::vector<uint64_t> needCompact =
+    std::vector<struct CompactPlan> needCompact =
         GetNeedCompact(inode.s3chunkinfomap(), inode.length(), chunkSize);
     if (needCompact.empty()) {
         VLOG(6) << "s3compact: no need to compact " << inode.inodeid();
         return;
     }
+    AlignToStoredList(task, inode, &needCompact);
 
     // 1. read full chunk & write new objs, each chunk one by one
     struct S3CompactCtx compactCtx {
@@ -647,9 +796,9 @@ void S3CompactWorkQueueImpl::CompactChunks(const struct S3CompactTask& task) {
     std::vector<uint64_t> indexToDelete;
     VLOG(6) << "s3compact: begin to compact fsId:" << fsId
             << ", inodeId:" << inodeId;
-    for (const auto& index : needCompact) {
+    for (const auto& plan : needCompact) {
         // s3chunklist order: from small chunkid to big chunkid
-        CompactChunk(compactCtx, index, inode, &objsAddedMap, &s3ChunkInfoAdd,
+        CompactChunk(compactCtx, plan, inode, &objsAddedMap, &s3ChunkInfoAdd,
                      &s3ChunkInfoRemove);
     }
     if (s3ChunkInfoAdd.empty() && s3ChunkInfoRemove.empty()) {
@@ -665,11 +814,8 @@ void S3CompactWorkQueueImpl::CompactChunks(const struct S3CompactTask& task) {
         s3adapterManager_->ReleaseS3Adapter(s3adapterIndex);
         return;
     }
-    std::vector<int> s3ChunkInfoRemoveIndex;
-    s3ChunkInfoRemoveIndex.reserve(s3ChunkInfoRemove.size());
-    for (const auto& element : s3ChunkInfoRemove) {
-        s3ChunkInfoRemoveIndex.push_back(element.first);
-    }
+    // only part of the s3chunkinfo list may be removed
+    const auto s3ChunkInfoRemoved = s3ChunkInfoRemove;
     auto ret =
         UpdateInode(task.copysetNodeWrapper->Get(), compactCtx.pinfo, inodeId,
                     std::move(s3ChunkInfoAdd), std::move(s3ChunkInfoRemove));
@@ -687,9 +833,8 @@ void S3CompactWorkQueueImpl::CompactChunks(const struct S3CompactTask& task) {
 
     // 3. delete old objs
     VLOG(6) << "s3compact: start delete old objs";
-    for (const auto& index : s3ChunkInfoRemoveIndex) {
-        const auto& l = inode.s3chunkinfomap().at(index);
-        DeleteObjsOfS3ChunkInfoList(compactCtx, l);
+    for (const auto& item : s3ChunkInfoRemoved) {
+        DeleteObjsOfS3ChunkInfoList(compactCtx, item.second);
     }
     VLOG(6) << "s3compact: finish delete objs";
     s3adapterManager_->ReleaseS3Adapter(s3adapterIndex);
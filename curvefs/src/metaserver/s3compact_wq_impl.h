@@ -41,12 +41,15 @@
 #include "src/common/concurrent/task_thread_pool.h"
 #include "src/common/configuration.h"
 #include "src/common/s3_adapter.h"
+#include "src/common/throttle.h"
 
 using curve::common::Configuration;
 using curve::common::InitS3AdaptorOptionExceptS3InfoOption;
+using curve::common::ReadWriteThrottleParams;
 using curve::common::S3Adapter;
 using curve::common::S3AdapterOption;
 using curve::common::TaskThreadPool;
+using curve::common::Throttle;
 using curvefs::metaserver::copyset::CopysetNode;
 using curvefs::metaserver::copyset::CopysetNodeManager;
 
@@ -79,13 +82,20 @@ class S3CompactWorkQueueImpl : public TaskThreadPool<> {
         : s3adapterManager_(s3adapterManager),
           s3infoCache_(s3infoCache),
           opts_(opts),
-          copysetNodeMgr_(nodeMgr) {}
+          copysetNodeMgr_(nodeMgr) {
+        // 0 means no limit
+        ReadWriteThrottleParams params;
+        params.bpsTotal.limit = opts.s3BandwidthLimitMB * 1024 * 1024;
+        throttle_.UpdateThrottleParams(params);
+    }
 
     std::shared_ptr<S3AdapterManager> s3adapterManager_;
     std::shared_ptr<S3InfoCache> s3infoCache_;
     S3CompactWorkQueueOption opts_;
     std::deque<Key4Inode> compactingInodes_;
     copyset::CopysetNodeManager* copysetNodeMgr_;
+    // limit the s3 bandwidth of all compactions
+    Throttle throttle_;
     void Enqueue(std::shared_ptr<InodeManager> inodeManager, Key4Inode inodeKey,
                  PartitionInfo pinfo);
     std::function<void()> Dequeue();
@@ -109,6 +119,21 @@ class S3CompactWorkQueueImpl : public TaskThreadPool<> {
         S3Adapter* s3adapter;
     };
 
+    // compaction plan of one chunk
+    struct CompactPlan {
+        uint64_t index;
+        // merge the first mergeCount s3chunkinfos, the later ones don't
+        // overlap any other and are kept as they are
+        int mergeCount;
+        // the chunk is beyond the file, all s3chunkinfos are useless
+        bool truncated;
+        // number of s3chunkinfos overlapping the earlier ones, i.e.
+        // the extra pieces to read
+        uint64_t overlapped;
+        // bytes overwritten by the later s3chunkinfos or beyond the file
+        uint64_t deadBytes;
+    };
+
     struct S3NewChunkInfo {
         uint64_t newChunkId;
         uint64_t newOff;
@@ -172,10 +197,17 @@ class S3CompactWorkQueueImpl : public TaskThreadPool<> {
         }
     };
 
-    std::vector<uint64_t> GetNeedCompact(
+    // the chunks need compact, the one with the most read amplification
+    // first
+    std::vector<struct CompactPlan> GetNeedCompact(
         const ::google::protobuf::Map<uint64_t, S3ChunkInfoList>&
             s3chunkinfoMap,
         uint64_t inodeLen, uint64_t chunkSize);
+    // s3chunkinfos are stored in lists and only a whole list can be removed,
+    // so merge to the end of a stored list
+    void AlignToStoredList(const struct S3CompactTask& task,
+                           const Inode& inode,
+                           std::vector<struct CompactPlan>* plans);
     bool CompactPrecheck(const struct S3CompactTask& task, Inode* inode);
     S3Adapter* SetupS3Adapter(uint64_t fsid, uint64_t* s3adapterIndex,
                               uint64_t* blockSize, uint64_t* chunkSize);
@@ -201,7 +233,7 @@ class S3CompactWorkQueueImpl : public TaskThreadPool<> {
                        const std::string& fullChunk,
                        std::vector<std::string>* objsAdded);
     void CompactChunk(
-        const struct S3CompactCtx& compactCtx, uint64_t index,
+        const struct S3CompactCtx& compactCtx, const struct CompactPlan& plan,
         const Inode& inode,
         std::unordered_map<uint64_t, std::vector<std::string>>* objsAddedMap,
         ::google::protobuf::Map<uint64_t, S3ChunkInfoList>* s3ChunkInfoAdd,
@@ -320,7 +320,8 @@ Prefix4InodeVolumeExtent::Prefix4InodeVolumeExtent(uint32_t fsId,
     : fsId_(fsId), inodeId_(inodeId) {}
 
 std::string Prefix4InodeVolumeExtent::SerializeToString() const {
-    return absl::StrCat(keyType_, kDelimiter, fsId_, kDelimiter, inodeId_);
+    return absl::StrCat(keyType_, kDelimiter, fsId_, kDelimiter, inodeId_,
+                        kDelimiter);
 }
 
 bool Prefix4InodeVolumeExtent::ParseFromString(const std::string &value) {
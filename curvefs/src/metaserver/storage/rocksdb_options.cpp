@@ -30,6 +30,7 @@
 #include "curvefs/src/metaserver/storage/rocksdb_event_listener.h"
 #include "curvefs/src/metaserver/storage/rocksdb_storage.h"
 #include "rocksdb/filter_policy.h"
+#include "rocksdb/slice_transform.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "src/common/gflags_helper.h"
@@ -78,6 +79,21 @@ DEFINE_int32(rocksdb_ordered_cf_max_write_buffer_number,
              2,
              "Number of writer buffer for ordered column family");
 
+// The metaservers not upgraded can't read the checkpoints with the separate
+// column families, enable it after all metaservers are upgraded
+DEFINE_bool(rocksdb_split_column_families,
+            false,
+            "Store dentry, s3chunkinfo and volume extent tables in separate "
+            "column families");
+
+DEFINE_int64(rocksdb_dentry_cf_write_buffer_size,
+             64 << 20,
+             "Writer buffer size for dentry column family");
+
+DEFINE_int64(rocksdb_s3chunkinfo_cf_write_buffer_size,
+             64 << 20,
+             "Writer buffer size for s3chunkinfo column family");
+
 DEFINE_int32(rocksdb_stats_dump_period_sec,
              180,
              "Dump rocksdb.stats to LOG every stats_dump_period_sec");
@@ -89,6 +105,52 @@ std::shared_ptr<rocksdb::WriteBufferManager> rocksdbWriteBufferManager;
 std::shared_ptr<MetricEventListener> metricEventListener;
 
 const char* const kOrderedColumnFamilyName = "ordered_column_family";
+const char* const kDentryColumnFamilyName = "dentry_column_family";
+const char* const kS3ChunkInfoColumnFamilyName = "s3chunkinfo_column_family";
+const char* const kVolumeExtentColumnFamilyName =
+    "volume_extent_column_family";
+
+// Extract the prefix shared by the keys of the same entity, i.e. the dentrys
+// of the same parent, or the s3chunkinfos and volume extents of the same
+// inode, so that the prefix bloom filters work per directory and per file.
+//
+// internal key: ordered:tableName:0:type:fsId:entityId:...
+//               |<- tablePrefix ->|
+class EntityPrefixTransform : public rocksdb::SliceTransform {
+ public:
+    explicit EntityPrefixTransform(size_t tablePrefixLength)
+        : tablePrefixLength_(tablePrefixLength) {}
+
+    const char* Name() const override {
+        return "curvefs.EntityPrefixTransform";
+    }
+
+    rocksdb::Slice Transform(const rocksdb::Slice& key) const override {
+        return rocksdb::Slice(key.data(), PrefixLength(key));
+    }
+
+    bool InDomain(const rocksdb::Slice& key) const override {
+        return PrefixLength(key) != 0;
+    }
+
+ private:
+    // return 0 if the key is shorter than the prefix
+    size_t PrefixLength(const rocksdb::Slice& key) const {
+        int delimiters = 0;
+        for (size_t i = tablePrefixLength_; i < key.size(); ++i) {
+            if (key[i] == ':' && ++delimiters == kPrefixDelimiters) {
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
+ private:
+    // the delimiters after tablePrefix, type, fsId and entityId
+    static constexpr int kPrefixDelimiters = 4;
+
+    size_t tablePrefixLength_;
+};
 
 void CreateBlockCacheAndWriterBufferManager() {
     static std::once_flag createBlockCache;
@@ -175,6 +237,43 @@ void InitRocksdbOptions(
         rocksdb::kDefaultColumnFamilyName, unorderedCfOptions});
     columnFamilies->push_back(rocksdb::ColumnFamilyDescriptor{
         kOrderedColumnFamilyName, orderedCfOptions});
+    if (!FLAGS_rocksdb_split_column_families) {
+        // legacy layout, all ordered tables are in the ordered column family
+        return;
+    }
+
+    // the keys of the same directory or file are seeked together
+    std::shared_ptr<const rocksdb::SliceTransform> entityPrefixExtractor =
+        std::make_shared<EntityPrefixTransform>(
+            RocksDBStorage::GetKeyPrefixLength());
+
+    // dentry: list by parent and point lookup by (parent, name)
+    rocksdb::ColumnFamilyOptions dentryCfOptions = orderedCfOptions;
+    dentryCfOptions.prefix_extractor = entityPrefixExtractor;
+    dentryCfOptions.memtable_whole_key_filtering = true;
+    dentryCfOptions.write_buffer_size =
+        FLAGS_rocksdb_dentry_cf_write_buffer_size;
+
+    // s3chunkinfo: only range scan by inode, the whole key filter is useless
+    rocksdb::BlockBasedTableOptions s3ChunkInfoTableOptions = tableOptions;
+    s3ChunkInfoTableOptions.whole_key_filtering = false;
+    rocksdb::ColumnFamilyOptions s3ChunkInfoCfOptions = orderedCfOptions;
+    s3ChunkInfoCfOptions.prefix_extractor = entityPrefixExtractor;
+    s3ChunkInfoCfOptions.write_buffer_size =
+        FLAGS_rocksdb_s3chunkinfo_cf_write_buffer_size;
+    s3ChunkInfoCfOptions.table_factory.reset(
+        rocksdb::NewBlockBasedTableFactory(s3ChunkInfoTableOptions));
+
+    // volume extent: range scan by inode and point lookup by offset
+    rocksdb::ColumnFamilyOptions volumeExtentCfOptions = orderedCfOptions;
+    volumeExtentCfOptions.prefix_extractor = entityPrefixExtractor;
+
+    columnFamilies->push_back(rocksdb::ColumnFamilyDescriptor{
+        kDentryColumnFamilyName, dentryCfOptions});
+    columnFamilies->push_back(rocksdb::ColumnFamilyDescriptor{
+        kS3ChunkInfoColumnFamilyName, s3ChunkInfoCfOptions});
+    columnFamilies->push_back(rocksdb::ColumnFamilyDescriptor{
+        kVolumeExtentColumnFamilyName, volumeExtentCfOptions});
 }
 
 void ParseRocksdbOptions(curve::common::Configuration* conf) {
@@ -212,6 +311,18 @@ void ParseRocksdbOptions(curve::common::Configuration* conf) {
                "storage.rocksdb.ordered_max_write_buffer_number",
                &FLAGS_rocksdb_ordered_cf_max_write_buffer_number,
                /*fatalIfMissing*/ false);
+    dummy.Load(conf, "rocksdb_split_column_families",
+               "storage.rocksdb.split_column_families",
+               &FLAGS_rocksdb_split_column_families,
+               /*fatalIfMissing*/ false);
+    dummy.Load(conf, "rocksdb_dentry_cf_write_buffer_size",
+               "storage.rocksdb.dentry_write_buffer_size",
+               &FLAGS_rocksdb_dentry_cf_write_buffer_size,
+               /*fatalIfMissing*/ false);
+    dummy.Load(conf, "rocksdb_s3chunkinfo_cf_write_buffer_size",
+               "storage.rocksdb.s3chunkinfo_write_buffer_size",
+               &FLAGS_rocksdb_s3chunkinfo_cf_write_buffer_size,
+               /*fatalIfMissing*/ false);
     dummy.Load(conf, "rocksdb_stats_dump_period_sec",
                "storage.rocksdb.stats_dump_period_sec",
                &FLAGS_rocksdb_stats_dump_period_sec, /*fatalIfMissing*/ false);
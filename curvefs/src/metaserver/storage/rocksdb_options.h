@@ -38,6 +38,22 @@ namespace curvefs {
 namespace metaserver {
 namespace storage {
 
+// Tables are stored in different column families by their types, so that
+// every column family can be tuned for its access pattern. Only the first
+// two exist in the legacy layout, see `rocksdb_split_column_families`.
+// NOTE: the order must be the same as the column family descriptors
+//       returned by `InitRocksdbOptions`
+enum ColumnFamilyIndex : size_t {
+    // unordered tables, e.g. inode
+    kDefaultColumnFamily = 0,
+    // ordered tables whose type is not listed below
+    kOrderedColumnFamily = 1,
+    kDentryColumnFamily = 2,
+    kS3ChunkInfoColumnFamily = 3,
+    kVolumeExtentColumnFamily = 4,
+    kColumnFamilyNum = 5,
+};
+
 // Parse rocksdb related options from conf
 void ParseRocksdbOptions(curve::common::Configuration* conf);
 
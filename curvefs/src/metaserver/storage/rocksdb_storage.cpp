@@ -22,6 +22,7 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <ostream>
 #include <iostream>
 #include <unordered_map>
@@ -34,6 +35,7 @@
 #include "curvefs/src/metaserver/storage/rocksdb_storage.h"
 #include "curvefs/src/metaserver/storage/rocksdb_options.h"
 #include "rocksdb/utilities/checkpoint.h"
+#include "rocksdb/write_batch.h"
 #include "src/fs/local_filesystem.h"
 
 namespace curvefs {
@@ -154,8 +156,32 @@ bool RocksDBStorage::Close() {
     return true;
 }
 
-inline ColumnFamilyHandle* RocksDBStorage::GetColumnFamilyHandle(bool ordered) {
-    return ordered ? handles_[1] : handles_[0];
+size_t RocksDBStorage::GetColumnFamilyIndex(const std::string& name,
+                                            bool ordered) const {
+    static const size_t tableNameLength = NameGenerator::GetFixedLength();
+    if (!ordered) {
+        return kDefaultColumnFamily;
+    } else if (name.size() != tableNameLength ||
+               dbCfDescriptors_.size() != kColumnFamilyNum) {
+        return kOrderedColumnFamily;
+    }
+
+    // the table name generated by NameGenerator starts with its type
+    switch (static_cast<KEY_TYPE>(name[0])) {
+        case kTypeDentry:
+            return kDentryColumnFamily;
+        case kTypeS3ChunkInfo:
+            return kS3ChunkInfoColumnFamily;
+        case kTypeVolumeExtent:
+            return kVolumeExtentColumnFamily;
+        default:
+            return kOrderedColumnFamily;
+    }
+}
+
+inline ColumnFamilyHandle* RocksDBStorage::GetColumnFamilyHandle(
+    const std::string& name, bool ordered) {
+    return handles_[GetColumnFamilyIndex(name, ordered)];
 }
 
 /* NOTE:
@@ -201,7 +227,7 @@ Status RocksDBStorage::Get(const std::string& name,
     ROCKSDB_NAMESPACE::Status s;
     std::string svalue;
     std::string ikey = ToInternalKey(name, key, ordered);
-    auto handle = GetColumnFamilyHandle(ordered);
+    auto handle = GetColumnFamilyHandle(name, ordered);
     {
         RocksDBPerfGuard guard(OP_GET);
         s = InTransaction_ ? txn_->Get(dbReadOptions_, handle, ikey, &svalue) :
@@ -224,7 +250,7 @@ Status RocksDBStorage::Set(const std::string& name,
         return Status::SerializedFailed();
     }
 
-    auto handle = GetColumnFamilyHandle(ordered);
+    auto handle = GetColumnFamilyHandle(name, ordered);
     std::string ikey = ToInternalKey(name, key, ordered);
     RocksDBPerfGuard guard(OP_PUT);
     ROCKSDB_NAMESPACE::Status s = InTransaction_ ?
@@ -241,7 +267,7 @@ Status RocksDBStorage::Del(const std::string& name,
     }
 
     std::string ikey = ToInternalKey(name, key, ordered);
-    auto handle = GetColumnFamilyHandle(ordered);
+    auto handle = GetColumnFamilyHandle(name, ordered);
     RocksDBPerfGuard guard(OP_DELETE);
     ROCKSDB_NAMESPACE::Status s = InTransaction_ ?
         txn_->Delete(handle, ikey) :
@@ -254,7 +280,7 @@ std::shared_ptr<Iterator> RocksDBStorage::Seek(const std::string& name,
     int status = inited_ ? 0 : -1;
     std::string ikey = ToInternalKey(name, prefix, true);
     return std::make_shared<RocksDBStorageIterator>(
-        this, ikey, 0, status, true);
+        this, ikey, 0, status, GetColumnFamilyIndex(name, true));
 }
 
 std::shared_ptr<Iterator> RocksDBStorage::GetAll(const std::string& name,
@@ -262,7 +288,7 @@ std::shared_ptr<Iterator> RocksDBStorage::GetAll(const std::string& name,
     int status = inited_ ? 0 : -1;
     std::string ikey = ToInternalKey(name, "", ordered);
     return std::make_shared<RocksDBStorageIterator>(
-        this, std::move(ikey), 0, status, ordered);
+        this, std::move(ikey), 0, status, GetColumnFamilyIndex(name, ordered));
 }
 
 size_t RocksDBStorage::Size(const std::string& name, bool ordered) {
@@ -291,7 +317,7 @@ Status RocksDBStorage::Clear(const std::string& name, bool ordered) {
     // database's checkpoint in raft snapshot
     // But, currently, many unittest cases depend it
 
-    auto handle = GetColumnFamilyHandle(ordered);
+    auto handle = GetColumnFamilyHandle(name, ordered);
     std::string lower = ToInternalName(name, ordered, true);
     std::string upper = ToInternalName(name, ordered, false);
     RocksDBPerfGuard guard(OP_DELETE_RANGE);
@@ -422,8 +448,45 @@ bool RocksDBStorage::Checkpoint(const std::string& dir,
     return true;
 }
 
+bool CheckCheckpointColumnFamilies(const std::string& dir,
+                                   std::vector<std::string>* existing,
+                                   bool* legacy) {
+    rocksdb::DBOptions dbOptions;
+    std::vector<rocksdb::ColumnFamilyDescriptor> columnFamilies;
+    InitRocksdbOptions(&dbOptions, &columnFamilies, /*createIfMissing*/ false);
+
+    auto status = rocksdb::DB::ListColumnFamilies(dbOptions, dir, existing);
+    if (!status.ok()) {
+        LOG(ERROR) << "Failed to list column families of checkpoint, error: "
+                   << status.ToString();
+        return false;
+    }
+
+    // the checkpoint created by older version or with
+    // `rocksdb_split_column_families` disabled only contains the default and
+    // ordered column families, and is migrated after recovered
+    for (const auto& name : *existing) {
+        auto iter = std::find_if(
+            columnFamilies.begin(), columnFamilies.end(),
+            [&name](const rocksdb::ColumnFamilyDescriptor& cf) {
+                return cf.name == name;
+            });
+        if (iter == columnFamilies.end()) {
+            LOG(ERROR) << "Checkpoint has unknown column family `" << name
+                       << "`, it's created with the tables stored in "
+                          "separate column families, please enable "
+                          "storage.rocksdb.split_column_families";
+            return false;
+        }
+    }
+
+    *legacy = existing->size() != columnFamilies.size();
+    return true;
+}
+
 bool DuplicateRocksdbCheckpoint(const std::string& from,
-                                const std::string& to) {
+                                const std::string& to,
+                                const std::vector<std::string>& existing) {
     LOG(INFO) << "Duplicating rocksdb storage from `" << from << "` to `" << to
               << "`";
 
@@ -433,10 +496,19 @@ bool DuplicateRocksdbCheckpoint(const std::string& from,
 
     InitRocksdbOptions(&dbOptions, &columnFamilies, /*createIfMissing*/ false);
 
+    // open the column families in the checkpoint only
+    std::vector<rocksdb::ColumnFamilyDescriptor> opened;
+    for (const auto& cf : columnFamilies) {
+        if (std::find(existing.begin(), existing.end(), cf.name) !=
+            existing.end()) {
+            opened.push_back(cf);
+        }
+    }
+
     std::vector<rocksdb::ColumnFamilyHandle*> cfHandles;
 
     auto status = rocksdb::DB::OpenForReadOnly(
-        dbOptions, from, columnFamilies, &cfHandles, &db,
+        dbOptions, from, opened, &cfHandles, &db,
         /* error_if_wal_file_exists */ true);
 
     if (!status.ok()) {
@@ -457,9 +529,77 @@ bool DuplicateRocksdbCheckpoint(const std::string& from,
     return DoCheckpoint(db, to);
 }
 
+bool RocksDBStorage::MigrateLegacyColumnFamilies() {
+    static const size_t tableNameLength = NameGenerator::GetFixedLength();
+    const size_t tableNameOffset = 1 + kDelimiter_.size();
+    const uint32_t kMigrateBatchSize = 1024;
+
+    uint64_t migrated = 0;
+    rocksdb::ReadOptions readOptions = dbReadOptions_;
+    readOptions.total_order_seek = true;
+    for (size_t index : {kDefaultColumnFamily, kOrderedColumnFamily}) {
+        // the iterator reads from an implicit snapshot, so it's safe to
+        // delete the keys while iterating
+        std::unique_ptr<rocksdb::Iterator> iter(
+            db_->NewIterator(readOptions, handles_[index]));
+        rocksdb::WriteBatch batch;
+        for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+            // internal key: ordered:tableName:0:key
+            rocksdb::Slice ikey = iter->key();
+            if (ikey.size() < tableNameOffset + tableNameLength) {
+                continue;
+            }
+
+            std::string name(ikey.data() + tableNameOffset, tableNameLength);
+            size_t target = GetColumnFamilyIndex(name, ikey[0] == '1');
+            if (target == index) {
+                continue;
+            }
+
+            batch.Put(handles_[target], ikey, iter->value());
+            batch.Delete(handles_[index], ikey);
+            migrated++;
+            if (batch.Count() >= kMigrateBatchSize) {
+                auto s = db_->Write(dbWriteOptions_, &batch);
+                if (!s.ok()) {
+                    LOG(ERROR) << "Migrate keys failed, status = "
+                               << s.ToString();
+                    return false;
+                }
+                batch.Clear();
+            }
+        }
+
+        if (!iter->status().ok()) {
+            LOG(ERROR) << "Iterate column family failed, status = "
+                       << iter->status().ToString();
+            return false;
+        }
+
+        auto s = db_->Write(dbWriteOptions_, &batch);
+        if (!s.ok()) {
+            LOG(ERROR) << "Migrate keys failed, status = " << s.ToString();
+            return false;
+        }
+    }
+
+    LOG(INFO) << "Migrated " << migrated
+              << " keys into the column families of their tables";
+    return true;
+}
+
 bool RocksDBStorage::Recover(const std::string& dir) {
     LOG(INFO) << "Recovering storage from `" << dir << "`";
 
+    // check before destroying current database
+    const std::string checkpoint = dir + "/" + kRocksdbCheckpointPath;
+    std::vector<std::string> existing;
+    bool legacy = false;
+    if (!CheckCheckpointColumnFamilies(checkpoint, &existing, &legacy)) {
+        LOG(ERROR) << "Checkpoint can't be recovered, dir: " << checkpoint;
+        return false;
+    }
+
     auto succ = Close();
     if (!succ) {
         LOG(ERROR) << "Failed to close storage before recover";
@@ -472,8 +612,7 @@ bool RocksDBStorage::Recover(const std::string& dir) {
         return false;
     }
 
-    succ = DuplicateRocksdbCheckpoint(dir + "/" + kRocksdbCheckpointPath,
-                                      options_.dataDir);
+    succ = DuplicateRocksdbCheckpoint(checkpoint, options_.dataDir, existing);
     if (!succ) {
         LOG(ERROR) << "Failed to duplicate rocksdb checkpoint";
         return false;
@@ -487,6 +626,11 @@ bool RocksDBStorage::Recover(const std::string& dir) {
         return false;
     }
 
+    if (legacy && !MigrateLegacyColumnFamilies()) {
+        LOG(ERROR) << "Failed to migrate legacy column families";
+        return false;
+    }
+
     LOG(INFO) << "Recovered rocksdb from `" << dir << "`";
     return true;
 }
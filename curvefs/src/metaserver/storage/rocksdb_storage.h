@@ -125,7 +125,11 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
     Status Rollback() override;
 
  private:
-    ColumnFamilyHandle* GetColumnFamilyHandle(bool ordered);
+    // the column family which the table belongs to
+    size_t GetColumnFamilyIndex(const std::string& name, bool ordered) const;
+
+    ColumnFamilyHandle* GetColumnFamilyHandle(const std::string& name,
+                                              bool ordered);
 
     static size_t GetKeyPrefixLength();
 
@@ -182,6 +186,11 @@ class RocksDBStorage : public KVStorage, public StorageTransaction {
 
     void InitDbOptions();
 
+    // move the data of the checkpoint created before tables are stored
+    // in separate column families into the column families they belong to,
+    // only called with `rocksdb_split_column_families` enabled
+    bool MigrateLegacyColumnFamilies();
+
  private:
     bool inited_;
     StorageOptions options_;
@@ -276,17 +285,24 @@ class RocksDBStorageIterator : public Iterator {
                            std::string prefix,
                            size_t size,
                            int status,
-                           bool ordered)
+                           size_t cfIndex)
         : storage_(storage),
           prefix_(std::move(prefix)),
           size_(size),
           status_(status),
           prefixChecking_(true),
-          ordered_(ordered),
+          cfIndex_(cfIndex),
           iter_(nullptr) {
         RocksDBPerfGuard guard(OP_GET_SNAPSHOT);
         if (status_ == 0) {
             readOptions_ = storage_->dbReadOptions_;
+            // the prefix is shorter than the column family's prefix, e.g.
+            // list all dentrys of the table, iterate in total order
+            const auto& extractor = storage_->dbCfDescriptors_[cfIndex_]
+                                        .options.prefix_extractor;
+            if (extractor != nullptr && !extractor->InDomain(prefix_)) {
+                readOptions_.total_order_seek = true;
+            }
             if (storage_->InTransaction_) {
                 readOptions_.snapshot = storage_->txn_->GetSnapshot();
             } else {
@@ -322,7 +338,7 @@ class RocksDBStorageIterator : public Iterator {
     }
 
     void SeekToFirst() {
-        auto handler = storage_->GetColumnFamilyHandle(ordered_);
+        auto handler = storage_->handles_[cfIndex_];
         {
             RocksDBPerfGuard guard(OP_GET_ITERATOR);
             if (storage_->InTransaction_) {
@@ -375,7 +391,7 @@ class RocksDBStorageIterator : public Iterator {
     std::string prefix_;
     uint64_t size_;
     int status_;
-    bool ordered_;
+    size_t cfIndex_;
     bool prefixChecking_;
     std::unique_ptr<rocksdb::Iterator> iter_;
     RocksDBStorage* storage_;
@@ -24,6 +24,8 @@
 
 #include <glog/logging.h>
 
+#include <atomic>
+#include <cstddef>
 #include <map>
 #include <string>
 #include <vector>
@@ -44,6 +46,40 @@ namespace {
 
 bvar::LatencyRecorder g_write_latency("block_device_write");
 bvar::LatencyRecorder g_read_latency("block_device_read");
+bvar::LatencyRecorder g_writev_latency("block_device_writev");
+bvar::LatencyRecorder g_readv_latency("block_device_readv");
+
+// The async ios issued at once, the waiter is woken up after all done
+struct AioTracker {
+    explicit AioTracker(int count) : counter(count), failed(false) {}
+
+    CountDownEvent counter;
+    std::atomic<bool> failed;
+};
+
+struct AioCombineContext {
+    // use pointer to keep the struct standard-layout for offsetof
+    AioTracker* tracker;
+    CurveAioContext curveCtx;
+};
+
+void AioCallback(CurveAioContext* context) {
+    auto* combineCtx = reinterpret_cast<AioCombineContext*>(
+        reinterpret_cast<char*>(context) -
+        offsetof(AioCombineContext, curveCtx));
+    AioTracker* tracker = combineCtx->tracker;
+
+    if (context->ret < 0 ||
+        static_cast<size_t>(context->ret) != context->length) {
+        LOG(ERROR) << "Aio failed, op: " << context->op
+                   << ", offset: " << context->offset
+                   << ", length: " << context->length
+                   << ", retCode = " << context->ret;
+        tracker->failed.store(true, std::memory_order_relaxed);
+    }
+
+    tracker->counter.Signal();
+}
 
 }  // namespace
 
@@ -63,17 +99,10 @@ bool BlockDeviceClientImpl::Init(const BlockDeviceClientOptions& options) {
         return false;
     }
 
-    ret = taskpool_.Start(options.threadnum);
-    if (ret != 0) {
-        LOG(ERROR) << "Start task pool failed";
-        return false;
-    }
-
     return true;
 }
 
 void BlockDeviceClientImpl::UnInit() {
-    taskpool_.Stop();
     fileClient_->UnInit();
 }
 
@@ -164,41 +193,39 @@ ssize_t BlockDeviceClientImpl::Readv(const std::vector<ReadPart>& iov) {
         return Read(iov[0].data, iov[0].offset, iov[0].length);
     }
 
-    CountDownEvent counter(iov.size());
-    std::atomic<ssize_t> res(0);
-
-    for (auto& io : iov) {
-        auto task = [this, &counter, &io, &res]() {
-            VLOG(9) << "read block offset: " << io.offset
-                    << ", length: " << io.length;
-            auto nr = this->Read(io.data, io.offset, io.length);
-            if (nr < 0) {
-                LOG(ERROR) << "IO Error, offseet: " << io.offset
-                           << ", len: " << io.length;
-                res.store(nr, std::memory_order_relaxed);
-            } else {
-                auto old = res.load(std::memory_order_release);
-                if (old < 0) {
-                    // already error
-                } else {
-                    while (!res.compare_exchange_strong(
-                        old, old + nr, std::memory_order_relaxed)) {
-                        if (old < 0) {
-                            // another request is error
-                            break;
-                        }
-                    }
-                }
-            }
-
-            counter.Signal();
-        };
-
-        taskpool_.Enqueue(std::move(task));
-    }
-
-    counter.Wait();
-    return res.load(std::memory_order_relaxed);
+    LatencyUpdater updater(&g_readv_latency);
+
+    if (fd_ < 0) {
+        return -1;
+    }
+
+    std::vector<AlignedIo> ios;
+    std::vector<PaddingIo> paddings;
+    ssize_t total = 0;
+    for (const auto& io : iov) {
+        VLOG(9) << "read block offset: " << io.offset
+                << ", length: " << io.length;
+        SplitUnaligned(LIBCURVE_OP_READ, io.data, io.offset, io.length, &ios,
+                       &paddings);
+        total += io.length;
+    }
+
+    // unaligned head and tail are read along with the aligned middle
+    for (const auto& padding : paddings) {
+        ios.push_back(padding.io);
+    }
+
+    if (!AioSubmit(ios)) {
+        return -1;
+    }
+
+    for (const auto& padding : paddings) {
+        memcpy(padding.data,
+               padding.buffer.get() + (padding.offset - padding.io.offset),
+               padding.length);
+    }
+
+    return total;
 }
 
 ssize_t BlockDeviceClientImpl::Write(const char* buf,
@@ -237,39 +264,132 @@ ssize_t BlockDeviceClientImpl::Writev(const std::vector<WritePart>& writes) {
         return Write(writes[0].data, writes[0].offset, writes[0].length);
     }
 
-    CountDownEvent counter(writes.size());
-    std::atomic<ssize_t> res(0);
+    LatencyUpdater updater(&g_writev_latency);
 
+    if (fd_ < 0) {
+        return -1;
+    }
+
+    std::vector<AlignedIo> ios;
+    std::vector<PaddingIo> paddings;
+    ssize_t total = 0;
     for (const auto& io : writes) {
-        auto task = [this, &counter, &io, &res]() {
-            auto nr = this->Write(io.data, io.offset, io.length);
-            if (nr < 0) {
-                LOG(ERROR) << "IO Error, offseet: " << io.offset
-                           << ", len: " << io.length;
-                res.store(nr, std::memory_order_relaxed);
-            } else {
-                auto old = res.load(std::memory_order_release);
-                if (old < 0) {
-                    // already error
-                } else {
-                    while (!res.compare_exchange_strong(
-                        old, old + io.length, std::memory_order_relaxed)) {
-                        if (old < 0) {
-                            // another request is error
-                            break;
-                        }
-                    }
-                }
-            }
-
-            counter.Signal();
-        };
-
-        taskpool_.Enqueue(std::move(task));
-    }
-
-    counter.Wait();
-    return res.load(std::memory_order_relaxed);
+        SplitUnaligned(LIBCURVE_OP_WRITE, const_cast<char*>(io.data),
+                       io.offset, io.length, &ios, &paddings);
+        total += io.length;
+    }
+
+    // aligned middle are written while the padding of unaligned head and
+    // tail are read
+    for (const auto& padding : paddings) {
+        AlignedIo read = padding.io;
+        read.op = LIBCURVE_OP_READ;
+        ios.push_back(read);
+    }
+
+    if (!AioSubmit(ios)) {
+        return -1;
+    }
+
+    // write back the padding merged with user data
+    ios.clear();
+    for (const auto& padding : paddings) {
+        memcpy(padding.buffer.get() + (padding.offset - padding.io.offset),
+               padding.data, padding.length);
+        ios.push_back(padding.io);
+    }
+
+    if (!AioSubmit(ios)) {
+        return -1;
+    }
+
+    return total;
+}
+
+void BlockDeviceClientImpl::SplitUnaligned(LIBCURVE_OP op,
+                                           char* data,
+                                           off_t offset,
+                                           size_t length,
+                                           std::vector<AlignedIo>* ios,
+                                           std::vector<PaddingIo>* paddings) {
+    auto addPadding = [op, paddings](char* data, off_t offset, size_t length,
+                                     const Range& range) {
+        PaddingIo padding;
+        padding.data = data;
+        padding.offset = offset;
+        padding.length = length;
+        padding.buffer.reset(new char[range.second - range.first]);
+        padding.io = {op, range.first,
+                      static_cast<size_t>(range.second - range.first),
+                      padding.buffer.get()};
+        paddings->push_back(std::move(padding));
+    };
+
+    if (length == 0) {
+        return;
+    }
+
+    off_t end = offset + length;
+    off_t alignedStart = Align(offset, IO_ALIGNED_BLOCK_SIZE);
+    off_t alignedEnd = end - end % IO_ALIGNED_BLOCK_SIZE;
+
+    // no aligned middle, the aligned range is at most two blocks
+    if (alignedStart >= alignedEnd) {
+        addPadding(data, offset, length, CalcAlignRange(offset, end));
+        return;
+    }
+
+    if (offset != alignedStart) {
+        addPadding(data, offset, alignedStart - offset,
+                   Range(alignedStart - IO_ALIGNED_BLOCK_SIZE, alignedStart));
+    }
+
+    ios->push_back({op, alignedStart,
+                    static_cast<size_t>(alignedEnd - alignedStart),
+                    data + (alignedStart - offset)});
+
+    if (end != alignedEnd) {
+        addPadding(data + (alignedEnd - offset), alignedEnd, end - alignedEnd,
+                   Range(alignedEnd, alignedEnd + IO_ALIGNED_BLOCK_SIZE));
+    }
+}
+
+bool BlockDeviceClientImpl::AioSubmit(const std::vector<AlignedIo>& ios) {
+    if (ios.empty()) {
+        return true;
+    }
+
+    AioTracker tracker(ios.size());
+    std::vector<AioCombineContext> contexts(ios.size());
+
+    for (size_t i = 0; i < ios.size(); ++i) {
+        auto& context = contexts[i];
+        context.tracker = &tracker;
+        context.curveCtx.offset = ios[i].offset;
+        context.curveCtx.length = ios[i].length;
+        context.curveCtx.buf = ios[i].buf;
+        context.curveCtx.op = ios[i].op;
+        context.curveCtx.cb = AioCallback;
+
+        int ret;
+        if (ios[i].op == LIBCURVE_OP_READ) {
+            ret = fileClient_->AioRead(fd_, &context.curveCtx);
+        } else {
+            ret = fileClient_->AioWrite(fd_, &context.curveCtx);
+        }
+
+        if (ret < 0) {
+            LOG(ERROR) << "Issue aio failed, op: " << ios[i].op
+                       << ", offset: " << ios[i].offset
+                       << ", length: " << ios[i].length
+                       << ", retCode = " << ret;
+            tracker.failed.store(true, std::memory_order_relaxed);
+            tracker.counter.Signal();
+        }
+    }
+
+    tracker.counter.Wait();
+    return !tracker.failed.load(std::memory_order_relaxed);
 }
 
 bool BlockDeviceClientImpl::WritePadding(char* writeBuffer,
@@ -31,7 +31,6 @@
 #include "curvefs/src/volume/common.h"
 #include "src/client/client_common.h"
 #include "src/client/libcurve_file.h"
-#include "src/common/concurrent/task_thread_pool.h"
 
 namespace curvefs {
 namespace volume {
@@ -43,7 +42,6 @@ using Range = std::pair<off_t, off_t>;
 struct BlockDeviceClientOptions {
     // config path
     std::string configPath;
-    uint32_t threadnum;
 };
 
 enum class BlockDeviceStatus {
@@ -158,6 +156,42 @@ class BlockDeviceClientImpl : public BlockDeviceClient {
     ssize_t Writev(const std::vector<WritePart>& writes) override;
 
  private:
+    // An aligned io issued to curve client asynchronously
+    struct AlignedIo {
+        LIBCURVE_OP op;
+        off_t offset;
+        size_t length;
+        char* buf;
+    };
+
+    // An unaligned range of user data, whose aligned range is read into
+    // a padding buffer before the data is copied out or merged in
+    struct PaddingIo {
+        char* data;
+        off_t offset;
+        size_t length;
+        AlignedIo io;
+        std::unique_ptr<char[]> buffer;
+    };
+
+    /**
+     * @brief Split the range into the aligned middle, which is issued with
+     *        the user buffer directly, and the unaligned head and tail,
+     *        which need padding
+     */
+    void SplitUnaligned(LIBCURVE_OP op,
+                        char* data,
+                        off_t offset,
+                        size_t length,
+                        std::vector<AlignedIo>* ios,
+                        std::vector<PaddingIo>* paddings);
+
+    /**
+     * @brief Issue the ios by AioRead/AioWrite and wait all of them done
+     * @return true if all ios succeeded
+     */
+    bool AioSubmit(const std::vector<AlignedIo>& ios);
+
     bool WritePadding(char* writeBuffer,
                                off_t writeStart,
                                off_t writeEnd,
@@ -184,8 +218,6 @@ class BlockDeviceClientImpl : public BlockDeviceClient {
     std::string owner_;
 
     std::shared_ptr<FileClient> fileClient_;
-
-    curve::common::TaskThreadPool<> taskpool_;
 };
 
 }  // namespace volume
@@ -24,6 +24,7 @@
 
 #include <butil/time.h>
 #include <bvar/bvar.h>
+#include <sched.h>
 
 #include <atomic>
 #include <unordered_set>
@@ -88,7 +89,7 @@ bool SpaceManagerImpl::Alloc(uint32_t size,
         left -= allocated;
     }
 
-    auto ret = UpdateBitmap(*extents);
+    auto ret = UpdateBitmap(*extents, BlockGroupBitmapUpdater::Set);
     if (!ret) {
         LOG(ERROR) << "Update bitmap failed";
         metric_.errorCount << 1;
@@ -105,8 +106,42 @@ bool SpaceManagerImpl::Alloc(uint32_t size,
 }
 
 bool SpaceManagerImpl::DeAlloc(const std::vector<Extent>& extents) {
-    // TODO(wuhanqing): fix
-    (void)extents;
+    VLOG(9) << "DeAlloc " << extents;
+
+    if (extents.empty()) {
+        return true;
+    }
+
+    ReadLockGuard lk(allocatorsLock_);
+    std::vector<Allocator*> allocators;
+    allocators.reserve(extents.size());
+    for (const auto& ext : extents) {
+        auto it = allocators_.find(align_down(ext.offset, blockGroupSize_));
+        if (it == allocators_.end()) {
+            LOG(ERROR) << "Allocator not found, ext: " << ext;
+            return false;
+        }
+
+        allocators.push_back(it->second.get());
+    }
+
+    // clear bitmap before the space can be allocated again, otherwise,
+    // the bits set by a new allocation may be cleared
+    auto ret = UpdateBitmap(extents, BlockGroupBitmapUpdater::Clear);
+    if (!ret) {
+        LOG(ERROR) << "Update bitmap failed";
+        return false;
+    }
+
+    for (size_t i = 0; i < extents.size(); ++i) {
+        if (!allocators[i]->DeAlloc(extents[i].offset, extents[i].len)) {
+            LOG(ERROR) << "DeAlloc failed, ext: " << extents[i];
+            return false;
+        }
+
+        availableBytes_.fetch_add(extents[i].len, std::memory_order_release);
+    }
+
     return true;
 }
 
@@ -128,9 +163,16 @@ SpaceManagerImpl::FindAllocator(const AllocateHint& hint) {
         }
     }
 
-    static thread_local unsigned int seed = time(nullptr);
+    // writers without hint on different cpus mostly start from different
+    // allocators, so they don't contend on the same one
+    int cpu = sched_getcpu();
+    if (cpu < 0) {
+        static thread_local unsigned int seed = time(nullptr);
+        cpu = rand_r(&seed);
+    }
+
     auto it = allocators_.begin();
-    std::advance(it, rand_r(&seed) % allocators_.size());
+    std::advance(it, cpu % allocators_.size());
 
     return it;
 }
@@ -162,13 +204,14 @@ int64_t SpaceManagerImpl::AllocInternal(int64_t size,
     return size - left;
 }
 
-bool SpaceManagerImpl::UpdateBitmap(const std::vector<Extent>& exts) {
+bool SpaceManagerImpl::UpdateBitmap(const std::vector<Extent>& exts,
+                                    BlockGroupBitmapUpdater::Op op) {
     ReadLockGuard lk(updatersLock_);
 
     std::unordered_set<BlockGroupBitmapUpdater*> dirty;
     for (const auto& ext : exts) {
         BlockGroupBitmapUpdater* updater = FindBitmapUpdater(ext);
-        updater->Update(ext, BlockGroupBitmapUpdater::Set);
+        updater->Update(ext, op);
         dirty.insert(updater);
     }
 
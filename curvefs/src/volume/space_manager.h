@@ -87,7 +87,8 @@ class SpaceManagerImpl final : public SpaceManager {
      */
     BlockGroupBitmapUpdater* FindBitmapUpdater(const Extent& ext);
 
-    bool UpdateBitmap(const std::vector<Extent>& exts);
+    bool UpdateBitmap(const std::vector<Extent>& exts,
+                      BlockGroupBitmapUpdater::Op op);
 
  private:
     bool AllocateBlockGroup(uint64_t hint);
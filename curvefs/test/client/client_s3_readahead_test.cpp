@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "curvefs/src/client/s3/client_s3_readahead.h"
+
+namespace curvefs {
+namespace client {
+
+namespace {
+
+constexpr uint64_t kBlockSize = 4 * 1024 * 1024;
+constexpr uint64_t kIoSize = 128 * 1024;
+
+}  // namespace
+
+TEST(ReadaheadTrackerTest, SequentialGrowsWindow) {
+    ReadaheadTracker tracker(kBlockSize, 1, 8);
+
+    // first read at the beginning of file is sequential
+    tracker.OnRead(0, kIoSize);
+    ReadaheadRange range = tracker.GetReadaheadRange(kIoSize);
+    ASSERT_EQ(kBlockSize, range.start);
+    ASSERT_EQ(2 * kBlockSize, range.end);
+    ASSERT_EQ(1, tracker.GetWindowBlocks());
+
+    // the rest of the first block doesn't issue more readahead
+    for (uint64_t offset = kIoSize; offset < kBlockSize; offset += kIoSize) {
+        tracker.OnRead(offset, kIoSize);
+        ASSERT_TRUE(tracker.GetReadaheadRange(offset + kIoSize).Empty());
+    }
+
+    // reading the second block, the window is doubled every time the
+    // reader catches up
+    uint64_t offset = kBlockSize;
+    uint32_t expected = 2;
+    uint64_t lastEnd = 2 * kBlockSize;
+    for (; offset < 64 * kBlockSize; offset += kIoSize) {
+        tracker.OnRead(offset, kIoSize);
+        range = tracker.GetReadaheadRange(offset + kIoSize);
+        if (range.Empty()) {
+            continue;
+        }
+        ASSERT_EQ(expected, tracker.GetWindowBlocks());
+        ASSERT_EQ(lastEnd, range.start);
+        ASSERT_EQ(0, range.end % kBlockSize);
+        lastEnd = range.end;
+        expected = std::min<uint32_t>(expected * 2, 8);
+    }
+    ASSERT_EQ(8, tracker.GetWindowBlocks());
+    // keep about a window ahead of the reader
+    ASSERT_GT(lastEnd, offset);
+    ASSERT_LE(lastEnd, offset + 9 * kBlockSize);
+}
+
+TEST(ReadaheadTrackerTest, RandomShrinksWindow) {
+    ReadaheadTracker tracker(kBlockSize, 4, 16);
+    ASSERT_EQ(4, tracker.GetWindowBlocks());
+
+    tracker.OnRead(100 * kBlockSize, kIoSize);
+    ASSERT_EQ(2, tracker.GetWindowBlocks());
+    tracker.OnRead(10 * kBlockSize, kIoSize);
+    ASSERT_EQ(1, tracker.GetWindowBlocks());
+    tracker.OnRead(50 * kBlockSize, kIoSize);
+    ASSERT_EQ(0, tracker.GetWindowBlocks());
+    ASSERT_TRUE(tracker.GetReadaheadRange(50 * kBlockSize + kIoSize).Empty());
+
+    tracker.OnRead(20 * kBlockSize, kIoSize);
+    ASSERT_EQ(0, tracker.GetWindowBlocks());
+
+    // sequential again, start from the initial window
+    tracker.OnRead(20 * kBlockSize + kIoSize, kIoSize);
+    ASSERT_EQ(4, tracker.GetWindowBlocks());
+    ReadaheadRange range =
+        tracker.GetReadaheadRange(20 * kBlockSize + 2 * kIoSize);
+    ASSERT_EQ(21 * kBlockSize, range.start);
+    ASSERT_EQ(25 * kBlockSize, range.end);
+}
+
+TEST(ReadaheadTrackerTest, OutOfOrderSequential) {
+    ReadaheadTracker tracker(kBlockSize, 2, 16);
+
+    // concurrent fuse requests of a sequential stream arrive out of order
+    tracker.OnRead(kIoSize, kIoSize);
+    tracker.OnRead(0, kIoSize);
+    tracker.OnRead(3 * kIoSize, kIoSize);
+    tracker.OnRead(2 * kIoSize, kIoSize);
+    ASSERT_EQ(2, tracker.GetWindowBlocks());
+    ASSERT_FALSE(tracker.GetReadaheadRange(4 * kIoSize).Empty());
+}
+
+TEST(ReadaheadTrackerTest, Disabled) {
+    ReadaheadTracker tracker(kBlockSize, 0, 0);
+    tracker.OnRead(0, kIoSize);
+    ASSERT_TRUE(tracker.GetReadaheadRange(kIoSize).Empty());
+    tracker.OnRead(kIoSize, kIoSize);
+    ASSERT_TRUE(tracker.GetReadaheadRange(2 * kIoSize).Empty());
+}
+
+}  // namespace client
+}  // namespace curvefs
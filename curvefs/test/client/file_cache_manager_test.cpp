@@ -28,6 +28,8 @@
 #include "curvefs/test/client/mock_client_s3_cache_manager.h"
 #include "curvefs/test/client/mock_inode_cache_manager.h"
 #include "curvefs/test/client/mock_client_s3.h"
+#include "curvefs/test/client/mock_metaserver_client.h"
+#include "curvefs/src/common/s3util.h"
 
 namespace curvefs {
 namespace client {
@@ -38,6 +40,8 @@ using ::testing::Return;
 using ::testing::SetArgPointee;
 using ::testing::SetArgReferee;
 using ::testing::WithArg;
+using rpcclient::MockMetaServerClient;
+using ::curvefs::common::s3util::GenObjName;
 
 class FileCacheManagerTest : public testing::Test {
  protected:
@@ -56,6 +60,7 @@ class FileCacheManagerTest : public testing::Test {
         option.writeCacheMaxByte = 10485760000;
         option.diskCacheOpt.diskCacheType = (DiskCacheType)0;
         option.chunkFlushThreads = 5;
+        option.rangeReadS3ChunkInfoThreshold = 1;
         s3ClientAdaptor_ = new S3ClientAdaptorImpl();
         auto fsCacheManager_ = std::make_shared<FsCacheManager>(
             s3ClientAdaptor_, option.readCacheMaxByte,
@@ -255,6 +260,81 @@ TEST_F(FileCacheManagerTest, test_read_s3) {
     delete tmpbuf;
 }
 
+TEST_F(FileCacheManagerTest, test_read_s3_by_range) {
+    uint64_t fsId = 2;
+    uint64_t inodeId = 1;
+    uint64_t offset = 0;
+    uint64_t len = 1024;
+    char buf[len] = {0};
+
+    ReadRequest request;
+    std::vector<ReadRequest> requests;
+    request.index = 0;
+    request.chunkPos = offset;
+    request.len = len;
+    request.bufOffset = 0;
+    requests.emplace_back(request);
+    EXPECT_CALL(*mockChunkCacheManager_, ReadByWriteCache(_, _, _, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<4>(requests), Return()));
+    EXPECT_CALL(*mockChunkCacheManager_, ReadByReadCache(_, _, _, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<4>(requests), Return()));
+    EXPECT_CALL(*mockChunkCacheManager_, AddReadDataCache(_))
+        .WillRepeatedly(Return());
+    fileCacheManager_->SetChunkCacheManagerForTest(0, mockChunkCacheManager_);
+
+    // the s3chunkinfo list is longer than the threshold
+    Inode inode;
+    inode.set_fsid(fsId);
+    inode.set_inodeid(inodeId);
+    inode.set_length(len);
+    S3ChunkInfoList s3ChunkInfoList;
+    for (uint64_t chunkId : {25, 26}) {
+        S3ChunkInfo *s3ChunkInfo = s3ChunkInfoList.add_s3chunks();
+        s3ChunkInfo->set_chunkid(chunkId);
+        s3ChunkInfo->set_compaction(0);
+        s3ChunkInfo->set_offset(offset);
+        s3ChunkInfo->set_len(len);
+        s3ChunkInfo->set_size(len);
+        s3ChunkInfo->set_zero(false);
+    }
+    inode.mutable_s3chunkinfomap()->insert({0, s3ChunkInfoList});
+    auto metaClient = std::make_shared<MockMetaServerClient>();
+    auto inodeWrapper = std::make_shared<InodeWrapper>(inode, metaClient);
+    EXPECT_CALL(*mockInodeManager_, GetInode(_, _))
+        .WillRepeatedly(
+            DoAll(SetArgReferee<1>(inodeWrapper), Return(CURVEFS_ERROR::OK)));
+
+    // the compacted s3chunkinfo got from metaserver
+    rpcclient::S3ChunkInfoSlices slices;
+    auto *slice = slices.Add();
+    slice->set_offset(offset);
+    slice->set_len(len);
+    *slice->mutable_chunkinfo() = s3ChunkInfoList.s3chunks(1);
+    slice->mutable_chunkinfo()->set_compaction(1);
+    EXPECT_CALL(*metaClient, GetS3ChunkInfoRange(fsId, inodeId, 0, offset,
+                                                 len, _))
+        .WillOnce(DoAll(SetArgPointee<5>(slices), Return(MetaStatusCode::OK)))
+        .WillOnce(Return(MetaStatusCode::RPC_ERROR))
+        .WillOnce(Return(MetaStatusCode::RPC_NOT_SUPPORTED));
+
+    // read by the slices
+    EXPECT_CALL(*mockS3Client_,
+                Download(GenObjName(26, 0, 1, fsId, inodeId), _, _, _))
+        .WillOnce(Return(len));
+    ASSERT_EQ(len, fileCacheManager_->Read(inodeId, offset, len, buf));
+
+    // walk the s3chunkinfo list if the rpc failed, and never use the rpc
+    // again if metaserver not support it
+    EXPECT_CALL(*mockS3Client_,
+                Download(GenObjName(26, 0, 0, fsId, inodeId), _, _, _))
+        .Times(3)
+        .WillRepeatedly(Return(len));
+    ASSERT_EQ(len, fileCacheManager_->Read(inodeId, offset, len, buf));
+    ASSERT_EQ(len, fileCacheManager_->Read(inodeId, offset, len, buf));
+    ASSERT_EQ(len, fileCacheManager_->Read(inodeId, offset, len, buf));
+    ASSERT_EQ(0, s3ClientAdaptor_->GetRangeReadS3ChunkInfoThreshold());
+}
+
 }  // namespace client
 }  // namespace curvefs
 
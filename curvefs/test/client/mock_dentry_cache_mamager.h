@@ -38,8 +38,9 @@ class MockDentryCacheManager : public DentryCacheManager {
     MockDentryCacheManager() {}
     ~MockDentryCacheManager() {}
 
-    MOCK_METHOD2(Init, CURVEFS_ERROR(
-        uint64_t cacheSize, bool enableCacheMetrics));
+    MOCK_METHOD4(Init, CURVEFS_ERROR(
+        uint64_t cacheSize, bool enableCacheMetrics, uint32_t shardNum,
+        CacheEvictPolicy policy));
 
     MOCK_METHOD1(InsertOrReplaceCache, void(const Dentry& dentry));
 
@@ -58,6 +59,11 @@ class MockDentryCacheManager : public DentryCacheManager {
                                            std::list<Dentry> *dentryList,
                                            uint32_t limit,
                                            bool onlyDir));
+
+    MOCK_METHOD4(ListDentryPlus, CURVEFS_ERROR(uint64_t parent,
+                                               std::list<Dentry> *dentryList,
+                                               uint32_t limit,
+                                               std::list<InodeAttr> *attrs));
 };
 
 
@@ -67,6 +67,10 @@ class MockMetaServerClient : public MetaServerClient {
             const std::string &last, uint32_t count, bool onlyDir,
             std::list<Dentry> *dentryList));
 
+    MOCK_METHOD6(ListDentryPlus, MetaStatusCode(uint32_t fsId,
+            uint64_t inodeid, const std::string &last, uint32_t count,
+            std::list<Dentry> *dentryList, std::list<InodeAttr> *attrs));
+
     MOCK_METHOD1(CreateDentry, MetaStatusCode(const Dentry &dentry));
 
     MOCK_METHOD4(DeleteDentry, MetaStatusCode(
@@ -129,6 +133,10 @@ class MockMetaServerClient : public MetaServerClient {
             uint64_t, S3ChunkInfoList> &s3ChunkInfos,
         MetaServerClientDone *done));
 
+    MOCK_METHOD6(GetS3ChunkInfoRange, MetaStatusCode(
+        uint32_t fsId, uint64_t inodeId, uint64_t chunkIndex,
+        uint64_t offset, uint64_t len, S3ChunkInfoSlices *slices));
+
     MOCK_METHOD2(CreateInode, MetaStatusCode(
             const InodeParam &param, Inode *out));
 
@@ -35,6 +35,7 @@ class MockVolumeStorage : public VolumeStorage {
     MOCK_METHOD4(Read, ssize_t(uint64_t, off_t, size_t, char*));
     MOCK_METHOD4(Write, ssize_t(uint64_t, off_t, size_t, const char*));
     MOCK_METHOD1(Flush, bool(uint64_t));
+    MOCK_METHOD1(Release, bool(uint64_t));
     MOCK_METHOD0(Shutdown, bool());
 };
 
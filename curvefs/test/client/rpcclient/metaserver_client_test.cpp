@@ -1402,6 +1402,80 @@ TEST_F(MetaServerClientImplTest, TestGetVolumeExtent) {
     }
 }
 
+TEST_F(MetaServerClientImplTest, TestGetS3ChunkInfoRange) {
+    const uint32_t fsid = 1;
+    const uint64_t ino = 2;
+    const uint32_t partitionID = 200;
+    const uint64_t applyIndex = 10;
+    using Request = metaserver::GetS3ChunkInfoRangeRequest;
+    using Response = metaserver::GetS3ChunkInfoRangeResponse;
+    S3ChunkInfoSlices slices;
+
+    EXPECT_CALL(*mockMetacache_, GetTarget(_, _, _, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(target_),
+                              SetArgPointee<3>(applyIndex), Return(true)));
+    EXPECT_CALL(*mockMetacache_.get(), GetPartitionIdByInodeId(_, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<2>(partitionID), Return(true)));
+
+    // test0: rpc error
+    EXPECT_CALL(mockMetaServerService_, GetS3ChunkInfoRange(_, _, _, _))
+        .WillRepeatedly(
+            Invoke(SetRpcService<Request, Response, true>));
+    ASSERT_EQ(MetaStatusCode::RPC_ERROR,
+              metaserverCli_.GetS3ChunkInfoRange(fsid, ino, 0, 0, 4096,
+                                                 &slices));
+
+    // test1: ok
+    Response response;
+    response.set_statuscode(MetaStatusCode::OK);
+    response.set_appliedindex(applyIndex);
+    auto *slice = response.add_slices();
+    slice->set_offset(1024);
+    slice->set_len(1024);
+    auto *info = slice->mutable_chunkinfo();
+    info->set_chunkid(1);
+    info->set_compaction(0);
+    info->set_offset(0);
+    info->set_len(4096);
+    info->set_size(4096);
+    info->set_zero(false);
+    EXPECT_CALL(mockMetaServerService_, GetS3ChunkInfoRange(_, _, _, _))
+        .WillOnce(
+            DoAll(SetArgPointee<2>(response),
+                  Invoke(SetRpcService<Request, Response>)));
+    EXPECT_CALL(*mockMetacache_.get(), UpdateApplyIndex(_, _));
+
+    ASSERT_EQ(MetaStatusCode::OK,
+              metaserverCli_.GetS3ChunkInfoRange(fsid, ino, 0, 1024, 1024,
+                                                 &slices));
+    ASSERT_EQ(1, slices.size());
+    ASSERT_EQ(1024, slices[0].offset());
+    ASSERT_EQ(1, slices[0].chunkinfo().chunkid());
+
+    // test2: metaserver return error
+    response.set_statuscode(MetaStatusCode::NOT_FOUND);
+    EXPECT_CALL(mockMetaServerService_, GetS3ChunkInfoRange(_, _, _, _))
+        .WillOnce(
+            DoAll(SetArgPointee<2>(response),
+                  Invoke(SetRpcService<Request, Response>)));
+    ASSERT_EQ(MetaStatusCode::NOT_FOUND,
+              metaserverCli_.GetS3ChunkInfoRange(fsid, ino, 0, 0, 4096,
+                                                 &slices));
+
+    // test3: metaserver not support the rpc, no retry
+    EXPECT_CALL(mockMetaServerService_, GetS3ChunkInfoRange(_, _, _, _))
+        .WillOnce(Invoke([](google::protobuf::RpcController *cntl_base,
+                            const Request *, Response *,
+                            google::protobuf::Closure *done) {
+            brpc::ClosureGuard doneGuard(done);
+            static_cast<brpc::Controller *>(cntl_base)->SetFailed(
+                brpc::ENOMETHOD, "Fail to find method");
+        }));
+    ASSERT_EQ(MetaStatusCode::RPC_NOT_SUPPORTED,
+              metaserverCli_.GetS3ChunkInfoRange(fsid, ino, 0, 0, 4096,
+                                                 &slices));
+}
+
 }  // namespace rpcclient
 }  // namespace client
 }  // namespace curvefs
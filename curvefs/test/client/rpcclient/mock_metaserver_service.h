@@ -103,6 +103,12 @@ class MockMetaServerService : public curvefs::metaserver::MetaServerService {
              ::curvefs::metaserver::GetOrModifyS3ChunkInfoResponse *response,
              ::google::protobuf::Closure *done));
 
+    MOCK_METHOD4(GetS3ChunkInfoRange,
+        void(::google::protobuf::RpcController *controller,
+             const ::curvefs::metaserver::GetS3ChunkInfoRangeRequest *request,
+             ::curvefs::metaserver::GetS3ChunkInfoRangeResponse *response,
+             ::google::protobuf::Closure *done));
+
     MOCK_METHOD4(
         GetVolumeExtent,
         void(::google::protobuf::RpcController *controller,
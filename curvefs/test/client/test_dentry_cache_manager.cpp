@@ -56,7 +56,7 @@ class TestDentryCacheManager : public ::testing::Test {
         metaClient_ = std::make_shared<MockMetaServerClient>();
         dCacheManager_ = std::make_shared<DentryCacheManagerImpl>(metaClient_);
         dCacheManager_->SetFsId(fsId_);
-        dCacheManager_->Init(10, true);
+        dCacheManager_->Init(10, true, 1, CacheEvictPolicy::LRU);
     }
 
     virtual void TearDown() {
@@ -199,6 +199,32 @@ TEST_F(TestDentryCacheManager, ListDentryNomal) {
     ASSERT_EQ(2 * limit - 1, out.size());
 }
 
+TEST_F(TestDentryCacheManager, ListDentryPlus) {
+    uint64_t parent = 99;
+
+    std::list<Dentry> part1, part2;
+    uint32_t limit = 100;
+    part1.resize(limit);
+    part2.resize(limit - 1);
+    std::list<InodeAttr> attrs1, attrs2;
+    attrs1.resize(limit / 2);
+    attrs2.resize(limit - 1);
+
+    EXPECT_CALL(*metaClient_, ListDentryPlus(fsId_, parent, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(part1), SetArgPointee<5>(attrs1),
+                Return(MetaStatusCode::OK)))
+        .WillOnce(DoAll(SetArgPointee<4>(part2), SetArgPointee<5>(attrs2),
+                Return(MetaStatusCode::OK)));
+
+    std::list<Dentry> out;
+    std::list<InodeAttr> outAttrs;
+    CURVEFS_ERROR ret = dCacheManager_->ListDentryPlus(parent, &out, limit,
+                                                       &outAttrs);
+    ASSERT_EQ(CURVEFS_ERROR::OK, ret);
+    ASSERT_EQ(2 * limit - 1, out.size());
+    ASSERT_EQ(limit / 2 + limit - 1, outAttrs.size());
+}
+
 TEST_F(TestDentryCacheManager, ListDentryEmpty) {
     uint64_t parent = 99;
 
@@ -0,0 +1,239 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "curvefs/src/client/s3/disk_cache_slab.h"
+
+namespace curvefs {
+namespace client {
+
+const char kSlabDir[] = "./disk_cache_slab_test";
+const uint64_t kSegmentSize = 64 * 1024;
+
+// fail the pwrite of the next record, but not its skip header
+class FailRecordPosixWrapper : public PosixWrapper {
+ public:
+    ssize_t pwrite(int fd, const void *buf, size_t count,
+                   off_t offset) override {
+        if (failNext && count > 16) {
+            failNext = false;
+            errno = EIO;
+            return -1;
+        }
+        return PosixWrapper::pwrite(fd, buf, count, offset);
+    }
+
+    bool failNext = false;
+};
+
+class TestDiskCacheSlab : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        ::system((std::string("rm -rf ") + kSlabDir).c_str());
+        wrapper_ = std::make_shared<PosixWrapper>();
+        option_.segmentSize = kSegmentSize;
+        option_.compactRatio = 50;
+        slab_ = NewSlab();
+    }
+
+    void TearDown() override {
+        slab_ = nullptr;
+        ::system((std::string("rm -rf ") + kSlabDir).c_str());
+    }
+
+    std::shared_ptr<DiskCacheSlab> NewSlab() {
+        auto slab = std::make_shared<DiskCacheSlab>(wrapper_, kSlabDir,
+                                                    option_);
+        EXPECT_EQ(0, slab->Init());
+        return slab;
+    }
+
+    std::string Get(const std::shared_ptr<DiskCacheSlab> &slab,
+                    const std::string &name, uint64_t length) {
+        std::string buf(length, 0);
+        if (slab->Get(name, &buf[0], 0, length) != length) {
+            return "";
+        }
+        return buf;
+    }
+
+    void Put(const std::string &name, char c, uint64_t length) {
+        std::string data(length, c);
+        ASSERT_EQ(length, slab_->Put(name, data.data(), length));
+    }
+
+    std::shared_ptr<PosixWrapper> wrapper_;
+    DiskCacheSlabOption option_;
+    std::shared_ptr<DiskCacheSlab> slab_;
+};
+
+TEST_F(TestDiskCacheSlab, PutGetRemove) {
+    Put("obj1", 'a', 4096);
+    Put("obj2", 'b', 100);
+    ASSERT_TRUE(slab_->IsCached("obj1"));
+    ASSERT_EQ(std::string(4096, 'a'), Get(slab_, "obj1", 4096));
+    ASSERT_EQ(std::string(100, 'b'), Get(slab_, "obj2", 100));
+
+    // read a range of the object
+    char buf[10];
+    ASSERT_EQ(10, slab_->Get("obj1", buf, 4000, 10));
+    ASSERT_EQ(std::string(10, 'a'), std::string(buf, 10));
+    ASSERT_GT(0, slab_->Get("obj2", buf, 95, 10));
+
+    // overwrite
+    Put("obj2", 'c', 200);
+    ASSERT_EQ(std::string(200, 'c'), Get(slab_, "obj2", 200));
+
+    ASSERT_EQ(0, slab_->Remove("obj1"));
+    ASSERT_FALSE(slab_->IsCached("obj1"));
+    ASSERT_GT(0, slab_->Get("obj1", buf, 0, 10));
+    ASSERT_EQ(0, slab_->Remove("obj1"));
+    ASSERT_EQ(kSegmentSize, slab_->GetUsedBytes());
+
+    // too large for a segment
+    std::string large(kSegmentSize, 'x');
+    ASSERT_GT(0, slab_->Put("large", large.data(), large.size()));
+}
+
+TEST_F(TestDiskCacheSlab, Recover) {
+    Put("obj1", 'a', 4096);
+    Put("obj2", 'b', 4096);
+    ASSERT_EQ(0, slab_->Checkpoint());
+
+    // changes after the checkpoint are replayed
+    Put("obj3", 'c', 4096);
+    Put("obj1", 'd', 1024);
+    ASSERT_EQ(0, slab_->Remove("obj2"));
+    slab_ = nullptr;
+
+    slab_ = NewSlab();
+    ASSERT_EQ(std::string(1024, 'd'), Get(slab_, "obj1", 1024));
+    ASSERT_FALSE(slab_->IsCached("obj2"));
+    ASSERT_EQ(std::string(4096, 'c'), Get(slab_, "obj3", 4096));
+
+    // continue to append after recover
+    Put("obj4", 'e', 4096);
+    ASSERT_EQ(0, slab_->Close());
+    slab_ = NewSlab();
+    std::list<std::string> names;
+    slab_->ListObjects(&names);
+    ASSERT_EQ(3, names.size());
+    ASSERT_EQ(std::string(4096, 'e'), Get(slab_, "obj4", 4096));
+}
+
+TEST_F(TestDiskCacheSlab, RecoverBrokenRecord) {
+    Put("obj1", 'a', 4096);
+    Put("obj2", 'b', 4096);
+    slab_ = nullptr;
+
+    // the last record is partially written
+    std::string segment = std::string(kSlabDir) + "/segment_0";
+    int fd = ::open(segment.c_str(), O_RDWR);
+    ASSERT_LE(0, fd);
+    char garbage[16] = {1};
+    ASSERT_EQ(sizeof(garbage),
+              ::pwrite(fd, garbage, sizeof(garbage), 2 * 4096));
+    ::close(fd);
+
+    slab_ = NewSlab();
+    ASSERT_EQ(std::string(4096, 'a'), Get(slab_, "obj1", 4096));
+    ASSERT_FALSE(slab_->IsCached("obj2"));
+
+    // broken index is ignored
+    ASSERT_EQ(0, slab_->Close());
+    std::string index = std::string(kSlabDir) + "/index";
+    fd = ::open(index.c_str(), O_RDWR);
+    ASSERT_LE(0, fd);
+    ASSERT_EQ(sizeof(garbage), ::pwrite(fd, garbage, sizeof(garbage), 20));
+    ::close(fd);
+    slab_ = NewSlab();
+    ASSERT_EQ(std::string(4096, 'a'), Get(slab_, "obj1", 4096));
+}
+
+TEST_F(TestDiskCacheSlab, RecoverFailedWrite) {
+    auto wrapper = std::make_shared<FailRecordPosixWrapper>();
+    slab_ = nullptr;
+    wrapper_ = wrapper;
+    slab_ = NewSlab();
+
+    Put("obj1", 'a', 4096);
+    wrapper->failNext = true;
+    std::string data(4096, 'b');
+    ASSERT_GT(0, slab_->Put("obj2", data.data(), data.size()));
+    Put("obj3", 'c', 4096);
+    slab_ = nullptr;
+
+    // the reserved range of the failed record is skipped
+    slab_ = NewSlab();
+    ASSERT_EQ(std::string(4096, 'a'), Get(slab_, "obj1", 4096));
+    ASSERT_FALSE(slab_->IsCached("obj2"));
+    ASSERT_EQ(std::string(4096, 'c'), Get(slab_, "obj3", 4096));
+}
+
+TEST_F(TestDiskCacheSlab, EvictAndCompact) {
+    // fill three segments, 15 objects of 4KB each
+    for (int i = 0; i < 45; i++) {
+        Put("obj" + std::to_string(i), 'a' + i % 26, 4096);
+    }
+    ASSERT_EQ(3 * kSegmentSize, slab_->GetUsedBytes());
+
+    // the oldest segment can not be evicted if any object can not
+    std::list<std::string> evicted;
+    auto pinned = [](const std::string &name) { return name != "obj0"; };
+    ASSERT_EQ(kSegmentSize, slab_->EvictSegment(pinned, &evicted));
+    ASSERT_EQ(15, evicted.size());
+    ASSERT_TRUE(slab_->IsCached("obj0"));
+    ASSERT_FALSE(slab_->IsCached("obj15"));
+    ASSERT_FALSE(slab_->IsCached("obj29"));
+    ASSERT_EQ(2 * kSegmentSize, slab_->GetUsedBytes());
+    // the active segment is never evicted
+    evicted.clear();
+    ASSERT_EQ(0, slab_->EvictSegment(pinned, &evicted));
+
+    // compact the segment with little live data
+    ASSERT_EQ(0, slab_->Compact());
+    for (int i = 1; i < 15; i++) {
+        ASSERT_EQ(0, slab_->Remove("obj" + std::to_string(i)));
+    }
+    ASSERT_EQ(kSegmentSize, slab_->Compact());
+    ASSERT_EQ(std::string(4096, 'a'), Get(slab_, "obj0", 4096));
+    ASSERT_EQ(0, slab_->Compact());
+
+    // the evicted and compacted segments are not recovered
+    slab_ = nullptr;
+    slab_ = NewSlab();
+    ASSERT_EQ(2 * kSegmentSize, slab_->GetUsedBytes());
+    ASSERT_EQ(std::string(4096, 'a'), Get(slab_, "obj0", 4096));
+    ASSERT_FALSE(slab_->IsCached("obj1"));
+    ASSERT_FALSE(slab_->IsCached("obj15"));
+    ASSERT_EQ(std::string(4096, 'a' + 44 % 26), Get(slab_, "obj44", 4096));
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -787,11 +787,29 @@ TEST_F(TestFuseVolumeClient, FuseOpOpenAndFuseOpReadDir) {
     dentry.set_parentinodeid(ino);
     dentry.set_inodeid(2);
     dentryList.push_back(dentry);
+    dentry.set_name("yyy");
+    dentry.set_inodeid(3);
+    dentryList.push_back(dentry);
 
-    EXPECT_CALL(*dentryManager_, ListDentry(ino, _, listDentryLimit_, _))
-        .WillOnce(
-            DoAll(SetArgPointee<1>(dentryList), Return(CURVEFS_ERROR::OK)));
-    EXPECT_CALL(*inodeManager_, BatchGetInodeAttrAsync(ino, _, _))
+    // the attr of inode 2 is returned by list dentry
+    std::list<InodeAttr> attrs;
+    InodeAttr attr;
+    attr.set_fsid(fsId);
+    attr.set_inodeid(2);
+    attrs.push_back(attr);
+
+    EXPECT_CALL(*dentryManager_, ListDentryPlus(ino, _, listDentryLimit_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(dentryList), SetArgPointee<3>(attrs),
+                        Return(CURVEFS_ERROR::OK)));
+    // which is kept in the attr cache of the parent
+    EXPECT_CALL(*inodeManager_, AddInodeAttrs(ino, _))
+        .WillOnce(Invoke([](uint64_t parentId,
+                            const RepeatedPtrField<InodeAttr> &inodeAttrs) {
+            ASSERT_EQ(1, inodeAttrs.size());
+            ASSERT_EQ(2, inodeAttrs.Get(0).inodeid());
+        }));
+    EXPECT_CALL(*inodeManager_,
+                BatchGetInodeAttrAsync(ino, std::set<uint64_t>{3}, _))
         .Times(1)
         .WillOnce(Return(CURVEFS_ERROR::OK));
 
@@ -1640,6 +1658,8 @@ TEST_F(TestFuseVolumeClient, FuseOpRelease) {
     EXPECT_CALL(*metaClient_, UpdateInodeAttrWithOutNlink(
         _, InodeOpenStatusChange::CLOSE, _))
         .WillOnce(Return(MetaStatusCode::OK));
+    EXPECT_CALL(*volumeStorage_, Release(ino))
+        .WillOnce(Return(true));
     ASSERT_EQ(CURVEFS_ERROR::OK, client_->FuseOpRelease(req, ino, &fi));
 }
 
@@ -302,6 +302,55 @@ TEST_F(TestInodeCacheManager, BatchGetInodeAttr) {
     ASSERT_EQ(getAttrs.begin()->length(), fileLength);
 }
 
+TEST_F(TestInodeCacheManager, BatchGetInodeAttrAsyncWithPartialCache) {
+    uint64_t parentId = 1;
+    uint64_t inodeId1 = 100;
+    uint64_t inodeId2 = 200;
+
+    // the attr of inode1 is cached, e.g. returned by list dentry
+    InodeAttr attr;
+    attr.set_fsid(fsId_);
+    attr.set_inodeid(inodeId1);
+    RepeatedPtrField<InodeAttr> cachedAttrs;
+    *cachedAttrs.Add() = attr;
+    iCacheManager_->AddInodeAttrs(parentId, cachedAttrs);
+
+    // only inode2 is got from metaserver
+    std::vector<std::vector<uint64_t>> inodeGroups{{inodeId2}};
+    EXPECT_CALL(*metaClient_,
+                SplitRequestInodes(fsId_, std::set<uint64_t>{inodeId2}, _))
+        .WillOnce(DoAll(SetArgPointee<2>(inodeGroups), Return(true)));
+    EXPECT_CALL(*metaClient_,
+                BatchGetInodeAttrAsync(fsId_, inodeGroups[0], _))
+        .WillOnce(Invoke([&](uint32_t fsId,
+                             const std::vector<uint64_t> &inodeIds,
+                             MetaServerClientDone *done) {
+            RepeatedPtrField<InodeAttr> attrs;
+            attr.set_inodeid(inodeId2);
+            *attrs.Add() = attr;
+            auto *batchDone = static_cast<BatchGetInodeAttrDone *>(done);
+            batchDone->SetInodeAttrs(attrs);
+            batchDone->SetMetaStatusCode(MetaStatusCode::OK);
+            batchDone->Run();
+            return MetaStatusCode::OK;
+        }));
+
+    std::map<uint64_t, InodeAttr> getAttrs;
+    CURVEFS_ERROR ret = iCacheManager_->BatchGetInodeAttrAsync(
+        parentId, {inodeId1, inodeId2}, &getAttrs);
+    ASSERT_EQ(CURVEFS_ERROR::OK, ret);
+    ASSERT_EQ(2, getAttrs.size());
+    ASSERT_EQ(1, getAttrs.count(inodeId1));
+    ASSERT_EQ(1, getAttrs.count(inodeId2));
+
+    // all cached now
+    getAttrs.clear();
+    ret = iCacheManager_->BatchGetInodeAttrAsync(
+        parentId, {inodeId1, inodeId2}, &getAttrs);
+    ASSERT_EQ(CURVEFS_ERROR::OK, ret);
+    ASSERT_EQ(2, getAttrs.size());
+}
+
 TEST_F(TestInodeCacheManager, BatchGetXAttr) {
     uint64_t inodeId1 = 100;
     uint64_t inodeId2 = 200;
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "curvefs/src/client/volume/extent_cache.h"
+#include "curvefs/test/client/volume/common.h"
+
+namespace curvefs {
+namespace client {
+
+class ExtentCacheTrimUnwrittenTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        option_.preAllocSize = 64 * kKiB;
+        option_.sliceSize = 1 * kGiB;
+        option_.blockSize = 4 * kKiB;
+
+        ExtentCache::SetOption(option_);
+    }
+
+    void Merge(ExtentCache* cache, uint64_t loffset, uint64_t poffset,
+               uint64_t len) {
+        PExtent pext;
+        pext.pOffset = poffset;
+        pext.len = len;
+        pext.UnWritten = true;
+        cache->Merge(loffset, pext);
+    }
+
+ protected:
+    ExtentCacheOption option_;
+};
+
+// length          |
+// extents  |xxx-----|   |-----|
+TEST_F(ExtentCacheTrimUnwrittenTest, TrimPreallocated) {
+    ExtentCache cache;
+
+    Merge(&cache, 0, 100 * kMiB, 64 * kKiB);
+    Merge(&cache, 1 * kMiB, 200 * kMiB, 64 * kKiB);
+    cache.MarkWritten(0, 12 * kKiB);
+    cache.GetDirtyExtents();
+
+    // trim offset is aligned up to block size
+    std::vector<Extent> released;
+    cache.TrimUnwritten(10 * kKiB, &released);
+
+    ASSERT_EQ(2, released.size());
+    ASSERT_EQ(100 * kMiB + 12 * kKiB, released[0].offset);
+    ASSERT_EQ(52 * kKiB, released[0].len);
+    ASSERT_EQ(200 * kMiB, released[1].offset);
+    ASSERT_EQ(64 * kKiB, released[1].len);
+    ASSERT_TRUE(cache.HasDirtyExtents());
+
+    auto extents = cache.GetExtentsForTesting();
+    ASSERT_EQ(1, extents.size());
+    auto& range = extents[0];
+    ASSERT_EQ(1, range.size());
+    ASSERT_EQ(12 * kKiB, range[0].len);
+    ASSERT_EQ(100 * kMiB, range[0].pOffset);
+    ASSERT_FALSE(range[0].UnWritten);
+}
+
+// length          |
+// extents  |xxxxxxxxx|
+TEST_F(ExtentCacheTrimUnwrittenTest, WrittenExtentsAreKept) {
+    ExtentCache cache;
+
+    Merge(&cache, 0, 100 * kMiB, 64 * kKiB);
+    cache.MarkWritten(0, 64 * kKiB);
+    cache.GetDirtyExtents();
+
+    std::vector<Extent> released;
+    cache.TrimUnwritten(4 * kKiB, &released);
+
+    ASSERT_TRUE(released.empty());
+    ASSERT_FALSE(cache.HasDirtyExtents());
+
+    auto extents = cache.GetExtentsForTesting();
+    ASSERT_EQ(64 * kKiB, extents[0][0].len);
+}
+
+}  // namespace client
+}  // namespace curvefs
@@ -934,5 +934,78 @@ TEST_F(ExtentCacheWriteDivideTest, DivideCase19_UnalignedWrite3) {
     ASSERT_EQ(1228, part.length);
 }
 
+TEST_F(ExtentCacheWriteDivideTest, PreAllocSizeGrowsOnSequentialAppend) {
+    option_.maxPreAllocSize = 128 * kKiB;
+    ExtentCache::SetOption(option_);
+
+    ExtentCache cache;
+    std::unique_ptr<char[]> data(new char[4 * kKiB]);
+
+    // write and allocate like the volume storage, return the allocated length
+    auto write = [&](uint64_t offset) -> uint64_t {
+        std::vector<WritePart> allocated;
+        std::vector<AllocPart> needAlloc;
+        cache.DivideForWrite(offset, 4 * kKiB, data.get(), &allocated,
+                             &needAlloc);
+        uint64_t len = 0;
+        for (auto& alloc : needAlloc) {
+            PExtent pext;
+            pext.pOffset = 100 * kMiB + alloc.allocInfo.lOffset;
+            pext.len = alloc.allocInfo.len;
+            pext.UnWritten = true;
+            cache.Merge(alloc.allocInfo.lOffset, pext);
+            len += alloc.allocInfo.len;
+        }
+        cache.MarkWritten(offset, 4 * kKiB);
+        return len;
+    };
+
+    ASSERT_EQ(32 * kKiB, write(0));
+    for (uint64_t off = 4 * kKiB; off < 32 * kKiB; off += 4 * kKiB) {
+        ASSERT_EQ(0, write(off));
+    }
+
+    // doubles on every allocation until the max size
+    ASSERT_EQ(64 * kKiB, write(32 * kKiB));
+    for (uint64_t off = 36 * kKiB; off < 96 * kKiB; off += 4 * kKiB) {
+        ASSERT_EQ(0, write(off));
+    }
+    ASSERT_EQ(128 * kKiB, write(96 * kKiB));
+    for (uint64_t off = 100 * kKiB; off < 224 * kKiB; off += 4 * kKiB) {
+        ASSERT_EQ(0, write(off));
+    }
+    ASSERT_EQ(128 * kKiB, write(224 * kKiB));
+
+    // reset on random write
+    ASSERT_EQ(32 * kKiB, write(10 * kMiB));
+    ASSERT_EQ(32 * kKiB, write(20 * kMiB));
+    for (uint64_t off = 20 * kMiB + 4 * kKiB; off < 20 * kMiB + 32 * kKiB;
+         off += 4 * kKiB) {
+        ASSERT_EQ(0, write(off));
+    }
+    ASSERT_EQ(64 * kKiB, write(20 * kMiB + 32 * kKiB));
+}
+
+TEST_F(ExtentCacheWriteDivideTest, PreAllocSizeGrowsAfterWriteAtZero) {
+    option_.maxPreAllocSize = 128 * kKiB;
+    ExtentCache::SetOption(option_);
+
+    ExtentCache cache;
+    std::unique_ptr<char[]> data(new char[32 * kKiB]);
+    std::vector<WritePart> allocated;
+    std::vector<AllocPart> needAlloc;
+
+    cache.DivideForWrite(0, 32 * kKiB, data.get(), &allocated, &needAlloc);
+    ASSERT_EQ(1, needAlloc.size());
+    ASSERT_EQ(32 * kKiB, needAlloc[0].allocInfo.len);
+
+    // the append right after the write at offset 0 is sequential
+    needAlloc.clear();
+    cache.DivideForWrite(32 * kKiB, 4 * kKiB, data.get(), &allocated,
+                         &needAlloc);
+    ASSERT_EQ(1, needAlloc.size());
+    ASSERT_EQ(64 * kKiB, needAlloc[0].allocInfo.len);
+}
+
 }  // namespace client
 }  // namespace curvefs
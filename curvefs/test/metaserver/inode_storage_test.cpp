@@ -731,6 +731,78 @@ TEST_F(InodeStorageTest, GetAllS3ChunkInfoList) {
     ASSERT_EQ(size, 2);
 }
 
+TEST_F(InodeStorageTest, GetS3ChunkInfoSlices) {
+    uint32_t fsId = 1;
+    uint64_t inodeId = 1;
+    uint64_t chunkIndex = 1;
+    InodeStorage storage(kvStorage_, nameGenerator_, 0);
+    ASSERT_EQ(storage.Insert(GenInode(fsId, inodeId)), MetaStatusCode::OK);
+
+    auto genList = [](std::vector<std::vector<uint64_t>> infos) {
+        // chunkId, offset, len
+        S3ChunkInfoList list;
+        for (const auto& item : infos) {
+            S3ChunkInfo* info = list.add_s3chunks();
+            info->set_chunkid(item[0]);
+            info->set_compaction(0);
+            info->set_offset(item[1]);
+            info->set_len(item[2]);
+            info->set_size(item[2]);
+            info->set_zero(false);
+        }
+        return list;
+    };
+
+    auto modify = [&](const S3ChunkInfoList* list2add,
+                      const S3ChunkInfoList* list2del) {
+        ASSERT_EQ(MetaStatusCode::OK, storage.ModifyInodeS3ChunkInfoList(
+            fsId, inodeId, chunkIndex, list2add, list2del));
+    };
+
+    // chunkId, offset, len of every slice
+    auto check = [&](uint64_t offset, uint64_t len,
+                     std::vector<std::vector<uint64_t>> expect) {
+        S3ChunkInfoSlices slices;
+        ASSERT_EQ(MetaStatusCode::OK, storage.GetS3ChunkInfoSlices(
+            fsId, inodeId, chunkIndex, offset, len, &slices));
+        ASSERT_EQ(expect.size(), slices.size());
+        for (size_t i = 0; i < expect.size(); i++) {
+            ASSERT_EQ(expect[i][0], slices[i].chunkinfo().chunkid());
+            ASSERT_EQ(expect[i][1], slices[i].offset());
+            ASSERT_EQ(expect[i][2], slices[i].len());
+        }
+    };
+
+    // CASE 1: empty chunk
+    check(0, 100, {});
+
+    // CASE 2: build the index from storage
+    auto list1 = genList({{1, 0, 100}, {2, 20, 20}});
+    modify(&list1, nullptr);
+    check(0, 100, {{1, 0, 20}, {2, 20, 20}, {1, 40, 60}});
+
+    // CASE 3: the newer list is added to the cached index
+    auto list2 = genList({{3, 0, 30}});
+    modify(&list2, nullptr);
+    check(0, 100, {{3, 0, 30}, {2, 30, 10}, {1, 40, 60}});
+    check(35, 10, {{2, 35, 5}, {1, 40, 5}});
+
+    // CASE 4: the older list is ordered before others in storage
+    auto list3 = genList({{0, 50, 10}});
+    modify(&list3, nullptr);
+    check(0, 100, {{3, 0, 30}, {2, 30, 10}, {1, 40, 60}});
+
+    // CASE 5: compaction
+    auto list2del = genList({{0, 50, 10}, {2, 20, 20}});
+    auto list2add = genList({{2, 0, 100}});
+    modify(&list2add, &list2del);
+    check(0, 100, {{3, 0, 30}, {2, 30, 70}});
+
+    // CASE 6: clear
+    ASSERT_EQ(storage.Clear(), MetaStatusCode::OK);
+    check(0, 100, {});
+}
+
 TEST_F(InodeStorageTest, TestUpdateVolumeExtentSlice) {
     using storage::Status;
 
@@ -841,6 +841,29 @@ TEST_F(MetastoreTest, test_dentry) {
 
     ret = metastore.DeleteDentry(&deleteRequest, &deleteResponse);
     ASSERT_EQ(deleteResponse.statuscode(), MetaStatusCode::NOT_FOUND);
+
+    // list dentry with attr, only the existing inode is returned
+    ret = metastore.CreateInode(&createInodeRequest, &createInodeResponse);
+    ASSERT_EQ(createInodeResponse.statuscode(), MetaStatusCode::OK);
+    Dentry dentry4;
+    dentry4.set_fsid(fsId);
+    dentry4.set_inodeid(createInodeResponse.inode().inodeid());
+    dentry4.set_parentinodeid(parentId);
+    dentry4.set_name("dentry4");
+    dentry4.set_txid(0);
+    dentry4.set_type(FsFileType::TYPE_DIRECTORY);
+    createRequest.mutable_dentry()->CopyFrom(dentry4);
+    ret = metastore.CreateDentry(&createRequest, &createResponse);
+    ASSERT_EQ(createResponse.statuscode(), MetaStatusCode::OK);
+
+    listRequest.set_needattr(true);
+    listResponse.Clear();
+    ret = metastore.ListDentry(&listRequest, &listResponse);
+    ASSERT_EQ(listResponse.statuscode(), MetaStatusCode::OK);
+    ASSERT_EQ(listResponse.dentrys_size(), 3);
+    ASSERT_EQ(listResponse.attrs_size(), 1);
+    ASSERT_EQ(listResponse.attrs(0).inodeid(), dentry4.inodeid());
+    ASSERT_EQ(listResponse.attrs(0).uid(), uid);
 }
 
 TEST_F(MetastoreTest, persist_success) {
@@ -87,6 +87,10 @@ class MockMetaStore : public curvefs::metaserver::MetaStore {
         std::shared_ptr<StreamConnection> connection,
         std::shared_ptr<Iterator> iterator));
 
+    MOCK_METHOD2(GetS3ChunkInfoRange,
+                 MetaStatusCode(const GetS3ChunkInfoRangeRequest*,
+                                GetS3ChunkInfoRangeResponse*));
+
     MOCK_METHOD2(GetVolumeExtent,
                  MetaStatusCode(const GetVolumeExtentRequest*,
                                 GetVolumeExtentResponse*));
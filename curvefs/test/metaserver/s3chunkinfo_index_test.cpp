@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include "curvefs/src/metaserver/s3chunkinfo_index.h"
+
+namespace curvefs {
+namespace metaserver {
+
+class S3ChunkInfoIndexTest : public ::testing::Test {
+ protected:
+    S3ChunkInfo Info(uint64_t chunkId, uint64_t offset, uint64_t len) {
+        S3ChunkInfo info;
+        info.set_chunkid(chunkId);
+        info.set_compaction(0);
+        info.set_offset(offset);
+        info.set_len(len);
+        info.set_size(len);
+        info.set_zero(false);
+        return info;
+    }
+
+    void ExpectSlice(const S3ChunkInfoSlice& slice, uint64_t chunkId,
+                     uint64_t offset, uint64_t len) {
+        ASSERT_EQ(chunkId, slice.chunkinfo().chunkid());
+        ASSERT_EQ(offset, slice.offset());
+        ASSERT_EQ(len, slice.len());
+    }
+};
+
+TEST_F(S3ChunkInfoIndexTest, OverlapTest) {
+    S3ChunkInfoIndex index;
+    S3ChunkInfoSlices slices;
+
+    // empty index
+    index.Query(0, 100, &slices);
+    ASSERT_EQ(0, slices.size());
+
+    // chunk 1:  [0                   100)
+    // chunk 2:        [20   40)
+    // chunk 3:                 [50        120)
+    // chunk 4:  [0 10)
+    index.Add(Info(1, 0, 100));
+    index.Add(Info(2, 20, 20));
+    index.Add(Info(3, 50, 70));
+    index.Add(Info(4, 0, 10));
+    index.Add(Info(5, 200, 0));
+    ASSERT_EQ(5, index.Size());
+
+    index.Query(0, 200, &slices);
+    ASSERT_EQ(5, slices.size());
+    ExpectSlice(slices[0], 4, 0, 10);
+    ExpectSlice(slices[1], 1, 10, 10);
+    ExpectSlice(slices[2], 2, 20, 20);
+    ExpectSlice(slices[3], 1, 40, 10);
+    ExpectSlice(slices[4], 3, 50, 70);
+    // the original s3chunkinfo is returned
+    ASSERT_EQ(0, slices[1].chunkinfo().offset());
+    ASSERT_EQ(100, slices[1].chunkinfo().len());
+
+    // the slices are clipped to the range
+    slices.Clear();
+    index.Query(30, 25, &slices);
+    ASSERT_EQ(3, slices.size());
+    ExpectSlice(slices[0], 2, 30, 10);
+    ExpectSlice(slices[1], 1, 40, 10);
+    ExpectSlice(slices[2], 3, 50, 5);
+
+    // hole
+    slices.Clear();
+    index.Query(120, 80, &slices);
+    ASSERT_EQ(0, slices.size());
+}
+
+TEST_F(S3ChunkInfoIndexTest, CoverTest) {
+    S3ChunkInfoIndex index;
+    S3ChunkInfoSlices slices;
+
+    S3ChunkInfoList list;
+    for (uint64_t i = 0; i < 10; i++) {
+        *list.add_s3chunks() = Info(i + 1, i * 10, 15);
+    }
+    index.Add(list);
+    ASSERT_EQ(10, index.Size());
+
+    // cover all except the head and tail
+    index.Add(Info(11, 5, 90));
+    ASSERT_EQ(3, index.Size());
+    index.Query(0, 200, &slices);
+    ASSERT_EQ(3, slices.size());
+    ExpectSlice(slices[0], 1, 0, 5);
+    ExpectSlice(slices[1], 11, 5, 90);
+    ExpectSlice(slices[2], 10, 95, 10);
+
+    // the same range
+    index.Add(Info(12, 5, 90));
+    slices.Clear();
+    index.Query(5, 90, &slices);
+    ASSERT_EQ(1, slices.size());
+    ExpectSlice(slices[0], 12, 5, 90);
+}
+
+}  // namespace metaserver
+}  // namespace curvefs
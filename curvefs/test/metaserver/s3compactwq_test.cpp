@@ -23,6 +23,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <set>
+
+#include "curvefs/src/common/s3util.h"
 #include "curvefs/src/metaserver/s3compact_manager.h"
 #include "curvefs/src/metaserver/s3compact_wq_impl.h"
 #include "curvefs/src/metaserver/storage/rocksdb_storage.h"
@@ -47,6 +50,7 @@ using ::testing::SaveArg;
 using ::testing::SetArgPointee;
 using ::testing::StrEq;
 
+using ::curvefs::metaserver::storage::Key4S3ChunkInfoList;
 using ::curvefs::metaserver::storage::KVStorage;
 using ::curvefs::metaserver::storage::RandomStoragePath;
 using ::curvefs::metaserver::storage::RocksDBStorage;
@@ -70,6 +74,7 @@ class S3CompactWorkQueueImplTest : public ::testing::Test {
         opts_.maxChunksPerCompact = 10;
         opts_.s3ReadMaxRetry = 2;
         opts_.s3ReadRetryInterval = 1;
+        opts_.s3BandwidthLimitMB = 0;
         uint64_t s3adapterSize = 10;
         S3AdapterOption opts;
         s3adapterManager_ =
@@ -274,6 +279,72 @@ TEST_F(S3CompactWorkQueueImplTest, test_GetNeedCompact) {
               opts_.maxChunksPerCompact);
 }
 
+TEST_F(S3CompactWorkQueueImplTest, test_GetNeedCompactPlan) {
+    ::google::protobuf::Map<uint64_t, S3ChunkInfoList> s3chunkinfoMap;
+    auto add = [](S3ChunkInfoList* l, uint64_t id, uint64_t off,
+                  uint64_t len) {
+        auto ref = l->add_s3chunks();
+        ref->set_chunkid(id);
+        ref->set_offset(off);
+        ref->set_len(len);
+    };
+    // only the first two overlap
+    S3ChunkInfoList l0;
+    add(&l0, 0, 0, 4);
+    add(&l0, 1, 2, 4);
+    for (int i = 2; i < 22; i++) {
+        add(&l0, i, 8 + i, 1);
+    }
+    s3chunkinfoMap.insert({0, l0});
+    // the last three overlap
+    S3ChunkInfoList l1;
+    for (int i = 0; i < 20; i++) {
+        add(&l1, i, 64 + i, 1);
+    }
+    add(&l1, 20, 64 + 19, 1);
+    add(&l1, 21, 64 + 18, 2);
+    s3chunkinfoMap.insert({1, l1});
+    // beyond the file
+    S3ChunkInfoList l2;
+    add(&l2, 0, 64 * 2, 1);
+    s3chunkinfoMap.insert({2, l2});
+
+    auto plans = impl_->GetNeedCompact(s3chunkinfoMap, 64 * 2, 64);
+    ASSERT_EQ(3, plans.size());
+    ASSERT_EQ(2, plans[0].index);
+    ASSERT_TRUE(plans[0].truncated);
+    ASSERT_EQ(1, plans[0].mergeCount);
+    ASSERT_EQ(1, plans[1].index);
+    ASSERT_EQ(2, plans[1].overlapped);
+    ASSERT_EQ(3, plans[1].deadBytes);
+    ASSERT_EQ(22, plans[1].mergeCount);
+    ASSERT_EQ(0, plans[2].index);
+    ASSERT_EQ(1, plans[2].overlapped);
+    ASSERT_EQ(2, plans[2].deadBytes);
+    ASSERT_EQ(2, plans[2].mergeCount);
+
+    // merge to the end of the stored list
+    Inode inode;
+    inode.set_fsid(1);
+    inode.set_inodeid(2);
+    S3ChunkInfoList first;
+    S3ChunkInfoList second;
+    for (int i = 0; i < l0.s3chunks_size(); i++) {
+        *(i == 0 ? first : second).add_s3chunks() = l0.s3chunks(i);
+    }
+    ASSERT_EQ(MetaStatusCode::OK, inodeStorage_->ModifyInodeS3ChunkInfoList(
+                                      1, 2, 0, &first, nullptr));
+    ASSERT_EQ(MetaStatusCode::OK, inodeStorage_->ModifyInodeS3ChunkInfoList(
+                                      1, 2, 0, &second, nullptr));
+    inode.mutable_s3chunkinfomap()->insert({0, l0});
+    struct S3CompactWorkQueueImpl::S3CompactTask t {
+        inodeManager_, Key4Inode(1, 2), PartitionInfo(), mockCopysetNodeWrapper_
+    };
+    std::vector<struct S3CompactWorkQueueImpl::CompactPlan> toAlign{plans[2]};
+    impl_->AlignToStoredList(t, inode, &toAlign);
+    ASSERT_EQ(22, toAlign[0].mergeCount);
+}
+
 TEST_F(S3CompactWorkQueueImplTest, test_DeleteObjs) {
     std::vector<std::string> objs;
     objs.emplace_back("obj1");
@@ -697,5 +768,160 @@ TEST_F(S3CompactWorkQueueImplTest, test_CompactChunks) {
         .WillRepeatedly(Return(true));
     mockImpl_->CompactChunks(t);
 }
+
+TEST_F(S3CompactWorkQueueImplTest, test_CompactChunksPartialMerge) {
+    uint64_t blockSize = 4;
+    uint64_t chunkSize = 64;
+    // apply the update to the inode manager like the copyset does
+    ::google::protobuf::Map<uint64_t, S3ChunkInfoList> removed;
+    auto mock_updateinode =
+        [&](CopysetNode* copysetNode, const PartitionInfo& pinfo,
+            uint64_t inode,
+            ::google::protobuf::Map<uint64_t, S3ChunkInfoList> s3ChunkInfoAdd,
+            ::google::protobuf::Map<uint64_t, S3ChunkInfoList>
+                s3ChunkInfoRemove) {
+            removed = s3ChunkInfoRemove;
+            std::shared_ptr<Iterator> iterator;
+            return inodeManager_->GetOrModifyS3ChunkInfo(
+                1, inode, s3ChunkInfoAdd, s3ChunkInfoRemove, false, &iterator);
+        };
+    EXPECT_CALL(*mockImpl_, UpdateInode_rvr(_, _, _, _, _))
+        .WillOnce(testing::Invoke(mock_updateinode));
+    EXPECT_CALL(*s3adapter_, PutObject(_, _)).WillRepeatedly(Return(0));
+    std::set<std::string> deleted;
+    EXPECT_CALL(*s3adapter_, DeleteObject(_))
+        .WillRepeatedly(testing::Invoke([&](const Aws::String& key) {
+            deleted.emplace(key.c_str(), key.size());
+            return 0;
+        }));
+    EXPECT_CALL(*s3adapter_, GetObject(_, _))
+        .WillRepeatedly(
+            testing::Invoke([&](const Aws::String& key, std::string* data) {
+                data->assign(blockSize, '\0');
+                return 0;
+            }));
+    EXPECT_CALL(*mockCopysetNodeWrapper_, IsLeaderTerm())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mockCopysetNodeWrapper_, IsValid())
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*s3adapterManager_, GetS3Adapter())
+        .WillRepeatedly(Return(std::make_pair(0, s3adapter_.get())));
+    EXPECT_CALL(*s3adapterManager_, ReleaseS3Adapter(_))
+        .WillRepeatedly(Return());
+    EXPECT_CALL(*s3infoCache_, GetS3Info(_, _))
+        .WillRepeatedly(testing::Invoke([&](uint64_t fsid, S3Info* s3info) {
+            // the same as the s3adapter, no need to reinit
+            s3info->set_ak("1");
+            s3info->set_sk("1");
+            s3info->set_endpoint("1");
+            s3info->set_bucketname("1");
+            s3info->set_blocksize(blockSize);
+            s3info->set_chunksize(chunkSize);
+            return 0;
+        }));
+    std::string v = "1";
+    EXPECT_CALL(*s3adapter_, GetS3Ak()).WillRepeatedly(Return(v));
+    EXPECT_CALL(*s3adapter_, GetS3Sk()).WillRepeatedly(Return(v));
+    EXPECT_CALL(*s3adapter_, GetS3Endpoint()).WillRepeatedly(Return(v));
+    EXPECT_CALL(*s3adapter_, GetBucketName()).WillRepeatedly(Return(v));
+
+    Inode inode;
+    inode.set_fsid(1);
+    inode.set_inodeid(3);
+    inode.set_length(64);
+    inode.set_nlink(1);
+    inode.set_ctime(0);
+    inode.set_ctime_ns(0);
+    inode.set_mtime(0);
+    inode.set_mtime_ns(0);
+    inode.set_atime(0);
+    inode.set_atime_ns(0);
+    inode.set_uid(0);
+    inode.set_gid(0);
+    inode.set_mode(0);
+    inode.set_type(FsFileType::TYPE_FILE);
+    ASSERT_EQ(inodeStorage_->Insert(inode), MetaStatusCode::OK);
+
+    auto add = [](S3ChunkInfoList* l, uint64_t id, uint64_t off,
+                  uint64_t len) {
+        auto ref = l->add_s3chunks();
+        ref->set_chunkid(id);
+        ref->set_compaction(0);
+        ref->set_offset(off);
+        ref->set_len(len);
+        ref->set_size(len);
+        ref->set_zero(false);
+    };
+    // the first stored list overlaps itself
+    S3ChunkInfoList first;
+    add(&first, 0, 0, 8);
+    add(&first, 1, 4, 8);
+    add(&first, 2, 0, 4);
+    // the second stored list doesn't overlap, and is not more than
+    // fragmentThreshold
+    S3ChunkInfoList second;
+    for (int i = 3; i < 23; i++) {
+        add(&second, i, 12 + (i - 3) * 2, 2);
+    }
+    ASSERT_EQ(MetaStatusCode::OK, inodeStorage_->ModifyInodeS3ChunkInfoList(
+                                      1, 3, 0, &first, nullptr));
+    ASSERT_EQ(MetaStatusCode::OK, inodeStorage_->ModifyInodeS3ChunkInfoList(
+                                      1, 3, 0, &second, nullptr));
+    S3ChunkInfoSlices slices;
+    ASSERT_EQ(MetaStatusCode::OK,
+              inodeManager_->GetS3ChunkInfoRange(1, 3, 0, 0, 64, &slices));
+    ASSERT_EQ(22, slices.size());
+
+    struct S3CompactWorkQueueImpl::S3CompactTask t {
+        inodeManager_, Key4Inode(1, 3), PartitionInfo(), mockCopysetNodeWrapper_
+    };
+    mockImpl_->CompactChunks(t);
+
+    // only the first stored list is removed
+    ASSERT_EQ(1, removed.size());
+    ASSERT_EQ(3, removed.at(0).s3chunks_size());
+    std::set<std::string> expected;
+    for (const auto& obj : std::vector<std::pair<uint64_t, uint64_t>>{
+             {0, 0}, {0, 1}, {1, 1}, {1, 2}, {2, 0}}) {
+        expected.insert(curvefs::common::s3util::GenObjName(
+            obj.first, obj.second, 0, 1, 3));
+    }
+    ASSERT_EQ(expected, deleted);
+
+    // the merged list is put before the kept one
+    std::shared_ptr<Iterator> iterator;
+    ASSERT_EQ(MetaStatusCode::OK,
+              inodeManager_->GetOrModifyS3ChunkInfo(
+                  1, 3, S3ChunkInfoMap(), S3ChunkInfoMap(), true, &iterator));
+    std::vector<Key4S3ChunkInfoList> keys;
+    for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+        Key4S3ChunkInfoList key;
+        ASSERT_TRUE(key.ParseFromString(iterator->Key()));
+        keys.push_back(key);
+    }
+    ASSERT_EQ(2, keys.size());
+    ASSERT_EQ(2, keys[0].firstChunkId);
+    ASSERT_EQ(2, keys[0].lastChunkId);
+    ASSERT_EQ(1, keys[0].size);
+    ASSERT_EQ(3, keys[1].firstChunkId);
+    ASSERT_EQ(22, keys[1].lastChunkId);
+    ASSERT_EQ(20, keys[1].size);
+
+    // reads resolve to the merged s3chunkinfo and the kept ones
+    slices.Clear();
+    ASSERT_EQ(MetaStatusCode::OK,
+              inodeManager_->GetS3ChunkInfoRange(1, 3, 0, 0, 64, &slices));
+    ASSERT_EQ(21, slices.size());
+    ASSERT_EQ(2, slices[0].chunkinfo().chunkid());
+    ASSERT_EQ(1, slices[0].chunkinfo().compaction());
+    ASSERT_EQ(0, slices[0].offset());
+    ASSERT_EQ(12, slices[0].len());
+    for (int i = 1; i < 21; i++) {
+        ASSERT_EQ(i + 2, slices[i].chunkinfo().chunkid());
+        ASSERT_EQ(0, slices[i].chunkinfo().compaction());
+        ASSERT_EQ(12 + (i - 1) * 2, slices[i].offset());
+        ASSERT_EQ(2, slices[i].len());
+    }
+}
 }  // namespace metaserver
 }  // namespace curvefs
@@ -22,6 +22,7 @@
 
 #include "curvefs/src/metaserver/storage/rocksdb_storage.h"
 
+#include <gflags/gflags.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <gtest/gtest.h>
 #include <sys/stat.h>
@@ -30,6 +31,7 @@
 
 #include <memory>
 
+#include "curvefs/src/metaserver/storage/converter.h"
 #include "curvefs/src/metaserver/storage/storage.h"
 #include "curvefs/src/metaserver/storage/utils.h"
 #include "curvefs/test/metaserver/storage/storage_test.h"
@@ -40,6 +42,8 @@ namespace curvefs {
 namespace metaserver {
 namespace storage {
 
+DECLARE_bool(rocksdb_split_column_families);
+
 using ::curvefs::metaserver::storage::KVStorage;
 using ::curvefs::metaserver::storage::RocksDBStorage;
 using ::curvefs::metaserver::storage::StorageOptions;
@@ -73,10 +77,19 @@ class RocksDBStorageTest : public testing::Test {
 
     void TearDown() override {
         std::string ret;
+        FLAGS_rocksdb_split_column_families = false;
         ASSERT_TRUE(kvStorage_->Close());
         ASSERT_TRUE(ExecShell("rm -rf " + dirname_, &ret));
     }
 
+    // reopen a clean database with the given column family layout
+    void Reopen(bool split) {
+        ASSERT_TRUE(kvStorage_->Close());
+        FLAGS_rocksdb_split_column_families = split;
+        kvStorage_ = std::make_shared<RocksDBStorage>(options_);
+        ASSERT_TRUE(kvStorage_->Open());
+    }
+
     bool ExecShell(const std::string& cmd, std::string* ret) {
         std::array<char, 128> buffer;
         std::unique_ptr<FILE, decltype(&pclose)>
@@ -176,6 +189,59 @@ TEST_F(RocksDBStorageTest, HClearTestSMixOperator) {
 }
 TEST_F(RocksDBStorageTest, Transaction) { TestTransaction(kvStorage_); }
 
+TEST_F(RocksDBStorageTest, TestColumnFamilyPrefixSeek) {
+    Reopen(/*split*/ true);
+
+    NameGenerator nameGenerator(1);
+    std::string dentryTable = nameGenerator.GetDentryTableName();
+    std::string s3ChunkInfoTable = nameGenerator.GetS3ChunkInfoTableName();
+    Converter conv;
+
+    // parent 10 and 100 are in different prefixes of dentry column family
+    for (uint64_t parent : {10, 100}) {
+        for (int i = 0; i < 3; i++) {
+            std::string name = "file" + std::to_string(i);
+            Key4Dentry key(1, parent, name);
+            ASSERT_TRUE(kvStorage_->SSet(dentryTable,
+                                         conv.SerializeToString(key),
+                                         Value(name)).ok());
+        }
+    }
+    ASSERT_TRUE(kvStorage_->SSet(s3ChunkInfoTable, "key", Value("s3")).ok());
+
+    // list dentrys of the same parent
+    for (uint64_t parent : {10, 100}) {
+        Prefix4SameParentDentry prefix(1, parent);
+        auto iterator = kvStorage_->SSeek(dentryTable,
+                                          conv.SerializeToString(prefix));
+        ASSERT_EQ(iterator->Status(), 0);
+        size_t size = 0;
+        for (iterator->SeekToFirst(); iterator->Valid(); iterator->Next()) {
+            Key4Dentry key;
+            ASSERT_TRUE(key.ParseFromString(iterator->Key()));
+            ASSERT_EQ(parent, key.parentInodeId);
+            size++;
+        }
+        ASSERT_EQ(3, size);
+    }
+
+    // iterate the whole table in total order
+    ASSERT_EQ(6, kvStorage_->SSize(dentryTable));
+    ASSERT_EQ(1, kvStorage_->SSize(s3ChunkInfoTable));
+
+    // point lookup
+    Dentry dentry;
+    Key4Dentry key(1, 100, "file1");
+    ASSERT_TRUE(kvStorage_->SGet(dentryTable, conv.SerializeToString(key),
+                                 &dentry).ok());
+    ASSERT_EQ(Value("file1"), dentry);
+
+    // clear one table doesn't affect others
+    ASSERT_TRUE(kvStorage_->SClear(dentryTable).ok());
+    ASSERT_EQ(0, kvStorage_->SSize(dentryTable));
+    ASSERT_EQ(1, kvStorage_->SSize(s3ChunkInfoTable));
+}
+
 namespace {
 
 ino_t GetPathInodeId(const std::string& path) {
@@ -292,6 +358,53 @@ TEST_F(RocksDBStorageTest, TestCheckpointAndRecover) {
     EXPECT_EQ(Value("7"), dummyDentry);
 }
 
+TEST_F(RocksDBStorageTest, TestRecoverLegacyCheckpoint) {
+    NameGenerator nameGenerator(1);
+    std::string dentryTable = nameGenerator.GetDentryTableName();
+    std::string s3ChunkInfoTable = nameGenerator.GetS3ChunkInfoTableName();
+
+    // checkpoint in legacy layout
+    ASSERT_TRUE(kvStorage_->SSet(dentryTable, "key", Value("dentry")).ok());
+    ASSERT_TRUE(kvStorage_->SSet(s3ChunkInfoTable, "key", Value("s3")).ok());
+    ASSERT_TRUE(kvStorage_->HSet("1", "1", Value("1")).ok());
+    std::vector<std::string> files;
+    ASSERT_TRUE(kvStorage_->Checkpoint(dirname_, &files));
+
+    // recovered and migrated after upgraded
+    Reopen(/*split*/ true);
+    ASSERT_TRUE(kvStorage_->Recover(dirname_));
+
+    Dentry dentry;
+    ASSERT_TRUE(kvStorage_->SGet(dentryTable, "key", &dentry).ok());
+    ASSERT_EQ(Value("dentry"), dentry);
+    ASSERT_TRUE(kvStorage_->SGet(s3ChunkInfoTable, "key", &dentry).ok());
+    ASSERT_EQ(Value("s3"), dentry);
+    ASSERT_TRUE(kvStorage_->HGet("1", "1", &dentry).ok());
+    ASSERT_EQ(Value("1"), dentry);
+    ASSERT_EQ(1, kvStorage_->SSize(dentryTable));
+}
+
+TEST_F(RocksDBStorageTest, TestRefuseSplitCheckpoint) {
+    NameGenerator nameGenerator(1);
+    std::string dentryTable = nameGenerator.GetDentryTableName();
+
+    // checkpoint in split layout
+    Reopen(/*split*/ true);
+    ASSERT_TRUE(kvStorage_->SSet(dentryTable, "key", Value("dentry")).ok());
+    std::vector<std::string> files;
+    ASSERT_TRUE(kvStorage_->Checkpoint(dirname_, &files));
+
+    // metaserver not upgraded refuses the checkpoint,
+    // and current database is untouched
+    Reopen(/*split*/ false);
+    ASSERT_TRUE(kvStorage_->SSet(dentryTable, "key", Value("local")).ok());
+    ASSERT_FALSE(kvStorage_->Recover(dirname_));
+
+    Dentry dentry;
+    ASSERT_TRUE(kvStorage_->SGet(dentryTable, "key", &dentry).ok());
+    ASSERT_EQ(Value("local"), dentry);
+}
+
 }  // namespace storage
 }  // namespace metaserver
 }  // namespace curvefs
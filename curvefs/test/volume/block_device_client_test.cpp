@@ -23,6 +23,10 @@
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+
 #include "absl/memory/memory.h"
 
 #include "curvefs/src/volume/block_device_client.h"
@@ -38,6 +42,7 @@ using ::testing::Invoke;
 using ::testing::NiceMock;
 using ::curve::client::UserInfo;
 using ::curve::client::MockFileClient;
+using ::curve::client::UserDataType;
 using AlignRead = std::pair<off_t, size_t>;
 using AlignReads = std::vector<AlignRead>;
 
@@ -45,7 +50,6 @@ class BlockDeviceClientTest : public ::testing::Test {
  protected:
     void SetUp() override {
         options_.configPath = "/etc/curvefs/client.conf";
-        options_.threadnum = 10;
 
         fileClient_ = std::make_shared<MockFileClient>();
         client_ = absl::make_unique<BlockDeviceClientImpl>(fileClient_);
@@ -67,6 +71,23 @@ class BlockDeviceClientTest : public ::testing::Test {
         return length;
     }
 
+    static int AioReadCallback(int fd,
+                               CurveAioContext* aioctx,
+                               UserDataType type) {
+        memset(aioctx->buf, '1', aioctx->length);
+        aioctx->ret = aioctx->length;
+        aioctx->cb(aioctx);
+        return LIBCURVE_ERROR::OK;
+    }
+
+    static int AioWriteCallback(int fd,
+                                CurveAioContext* aioctx,
+                                UserDataType type) {
+        aioctx->ret = aioctx->length;
+        aioctx->cb(aioctx);
+        return LIBCURVE_ERROR::OK;
+    }
+
  protected:
     BlockDeviceClientOptions options_;
     std::unique_ptr<BlockDeviceClientImpl> client_;
@@ -370,9 +391,10 @@ TEST_F(BlockDeviceClientTest, ReadvTest_AllSuccess) {
     };
 
     EXPECT_CALL(*fileClient_, Read(_, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*fileClient_, AioRead(_, _, _))
         .Times(4)
-        .WillRepeatedly(
-            Invoke([](int, char*, off_t, size_t length) { return length; }));
+        .WillRepeatedly(Invoke(AioReadCallback));
 
     ASSERT_TRUE(client_->Open({}, {}));
     ASSERT_EQ(4 * (4 * kKiB), client_->Readv(iov));
@@ -391,10 +413,14 @@ TEST_F(BlockDeviceClientTest, ReadvTest_AllFailed) {
         {12 * kMiB, 4 * kKiB, data},
     };
 
-    EXPECT_CALL(*fileClient_, Read(_, _, _, _))
+    EXPECT_CALL(*fileClient_, AioRead(_, _, _))
         .Times(4)
-        .WillRepeatedly(
-            Invoke([](int, char*, off_t, size_t length) { return -1; }));
+        .WillRepeatedly(Invoke(
+            [](int, CurveAioContext* aioctx, UserDataType) {
+                aioctx->ret = -1;
+                aioctx->cb(aioctx);
+                return LIBCURVE_ERROR::OK;
+            }));
 
     ASSERT_TRUE(client_->Open({}, {}));
     ASSERT_GT(0, client_->Readv(iov));
@@ -417,22 +443,60 @@ TEST_F(BlockDeviceClientTest, ReadvTest_PartialFailed) {
     int count = rand_r(&seed) % (iov.size() - 1) + 1;
     std::atomic<int> counter(iov.size());
 
-    EXPECT_CALL(*fileClient_, Read(_, _, _, _))
+    // some requests fail to issue
+    EXPECT_CALL(*fileClient_, AioRead(_, _, _))
         .Times(4)
-        .WillRepeatedly(
-            Invoke([&count, &counter](int, char*, off_t, size_t length) -> int {
+        .WillRepeatedly(Invoke(
+            [&count, &counter](int fd, CurveAioContext* aioctx,
+                               UserDataType type) -> int {
                 auto c = counter.fetch_sub(1);
                 if (c <= count) {
-                    return -1;
+                    return -LIBCURVE_ERROR::FAILED;
                 }
 
-                return length;
+                return AioReadCallback(fd, aioctx, type);
             }));
 
     ASSERT_TRUE(client_->Open({}, {}));
     ASSERT_GT(0, client_->Readv(iov));
 }
 
+TEST_F(BlockDeviceClientTest, ReadvTest_UnAlignedSuccess) {
+    ON_CALL(*fileClient_, Open(_, _, _))
+        .WillByDefault(Return(1));
+
+    char data1[40960];
+    char data2[40960];
+    memset(data1, '0', sizeof(data1));
+    memset(data2, '0', sizeof(data2));
+
+    std::vector<ReadPart> iov{
+        {1000, 10000, data1},  // head, middle and tail
+        {8 * kMiB + 1, 4096, data2},  // two blocks without middle
+    };
+
+    AlignReads reads;
+    EXPECT_CALL(*fileClient_, AioRead(_, _, _))
+        .Times(4)
+        .WillRepeatedly(Invoke(
+            [&reads](int fd, CurveAioContext* aioctx, UserDataType type) {
+                reads.emplace_back(aioctx->offset, aioctx->length);
+                return AioReadCallback(fd, aioctx, type);
+            }));
+
+    ASSERT_TRUE(client_->Open({}, {}));
+    ASSERT_EQ(10000 + 4096, client_->Readv(iov));
+
+    std::sort(reads.begin(), reads.end());
+    ASSERT_EQ(reads, (AlignReads{AlignRead(0, 4096),
+                                 AlignRead(4096, 4096),
+                                 AlignRead(8192, 4096),
+                                 AlignRead(8 * kMiB, 8192)}));
+    for (auto i = 0; i < 40960; i++) {
+        ASSERT_EQ(data1[i], i < 10000 ? '1' : '0');
+        ASSERT_EQ(data2[i], i < 4096 ? '1' : '0');
+    }
+}
 
 TEST_F(BlockDeviceClientTest, WritevTest_AllSuccess) {
     ON_CALL(*fileClient_, Open(_, _, _))
@@ -448,9 +512,10 @@ TEST_F(BlockDeviceClientTest, WritevTest_AllSuccess) {
     };
 
     EXPECT_CALL(*fileClient_, Write(_, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*fileClient_, AioWrite(_, _, _))
         .Times(4)
-        .WillRepeatedly(Invoke(
-            [](int, const char*, off_t, size_t length) { return length; }));
+        .WillRepeatedly(Invoke(AioWriteCallback));
 
     ASSERT_TRUE(client_->Open({}, {}));
     ASSERT_EQ(4 * (4 * kKiB), client_->Writev(iov));
@@ -469,10 +534,14 @@ TEST_F(BlockDeviceClientTest, WritevTest_AllFailed) {
         {12 * kMiB, 4 * kKiB, data},
     };
 
-    EXPECT_CALL(*fileClient_, Write(_, _, _, _))
+    EXPECT_CALL(*fileClient_, AioWrite(_, _, _))
         .Times(4)
-        .WillRepeatedly(
-            Invoke([](int, const char*, off_t, size_t length) { return -1; }));
+        .WillRepeatedly(Invoke(
+            [](int, CurveAioContext* aioctx, UserDataType) {
+                aioctx->ret = -1;
+                aioctx->cb(aioctx);
+                return LIBCURVE_ERROR::OK;
+            }));
 
     ASSERT_TRUE(client_->Open({}, {}));
     ASSERT_GT(0, client_->Writev(iov));
@@ -495,16 +564,19 @@ TEST_F(BlockDeviceClientTest, WritevTest_PartialFailed) {
     int count = rand_r(&seed) % (iov.size() - 1) + 1;
     std::atomic<int> counter(iov.size());
 
-    EXPECT_CALL(*fileClient_, Write(_, _, _, _))
+    EXPECT_CALL(*fileClient_, AioWrite(_, _, _))
         .Times(4)
         .WillRepeatedly(Invoke(
-            [&count, &counter](int, const char*, off_t, size_t length) -> int {
+            [&count, &counter](int fd, CurveAioContext* aioctx,
+                               UserDataType type) -> int {
                 auto c = counter.fetch_sub(1);
                 if (c <= count) {
-                    return -1;
+                    aioctx->ret = 0;
+                    aioctx->cb(aioctx);
+                    return LIBCURVE_ERROR::OK;
                 }
 
-                return length;
+                return AioWriteCallback(fd, aioctx, type);
             }));
 
     ASSERT_TRUE(client_->Open({}, {}));
@@ -524,19 +596,62 @@ TEST_F(BlockDeviceClientTest, WritevTest_AllUnAlignedSuccess) {
         {12 * kMiB, 2 * kKiB, data},
     };
 
-    EXPECT_CALL(*fileClient_, Read(_, _, _, _))
+    EXPECT_CALL(*fileClient_, AioRead(_, _, _))
         .Times(4)
-        .WillRepeatedly(Invoke(
-            [](int, const char*, off_t, size_t length) { return length; }));
+        .WillRepeatedly(Invoke(AioReadCallback));
 
-    EXPECT_CALL(*fileClient_, Write(_, _, _, _))
+    EXPECT_CALL(*fileClient_, AioWrite(_, _, _))
         .Times(4)
-        .WillRepeatedly(Invoke(
-            [](int, const char*, off_t, size_t length) { return length; }));
+        .WillRepeatedly(Invoke(AioWriteCallback));
 
     ASSERT_TRUE(client_->Open({}, {}));
     ASSERT_EQ(4 * (2 * kKiB), client_->Writev(iov));
 }
 
+TEST_F(BlockDeviceClientTest, WritevTest_UnAlignedMerge) {
+    ON_CALL(*fileClient_, Open(_, _, _))
+        .WillByDefault(Return(1));
+
+    char data[40960];
+    char disk[40960];
+    memset(data, '2', sizeof(data));
+    memset(disk, '0', sizeof(disk));
+
+    std::vector<WritePart> iov{
+        {1000, 10000, data},   // head, middle and tail
+        {20000, 100, data},    // in one block
+    };
+
+    std::vector<std::string> ops;
+    EXPECT_CALL(*fileClient_, AioRead(_, _, _))
+        .Times(3)
+        .WillRepeatedly(Invoke(
+            [&ops](int fd, CurveAioContext* aioctx, UserDataType type) {
+                ops.push_back("read:" + std::to_string(aioctx->offset));
+                return AioReadCallback(fd, aioctx, type);
+            }));
+    EXPECT_CALL(*fileClient_, AioWrite(_, _, _))
+        .Times(4)
+        .WillRepeatedly(Invoke(
+            [&ops, &disk](int fd, CurveAioContext* aioctx, UserDataType type) {
+                ops.push_back("write:" + std::to_string(aioctx->offset));
+                memcpy(disk + aioctx->offset, aioctx->buf, aioctx->length);
+                return AioWriteCallback(fd, aioctx, type);
+            }));
+
+    ASSERT_TRUE(client_->Open({}, {}));
+    ASSERT_EQ(10000 + 100, client_->Writev(iov));
+
+    // the aligned middle is written before the padding is read
+    ASSERT_EQ(ops, (std::vector<std::string>{
+                       "write:4096", "read:0", "read:8192", "read:16384",
+                       "write:0", "write:8192", "write:16384"}));
+    for (auto i = 0; i < 24576; i++) {
+        bool written = (i >= 1000 && i < 11000) || (i >= 20000 && i < 20100);
+        bool padded = i < 12288 || (i >= 16384 && i < 20480);
+        ASSERT_EQ(disk[i], written ? '2' : (padded ? '1' : '0'));
+    }
+}
+
 }  // namespace volume
 }  // namespace curvefs
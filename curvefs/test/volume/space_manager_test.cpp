@@ -146,6 +146,44 @@ TEST_F(SpaceManagerImplTest, TestAlloc) {
               extents.size());
 }
 
+TEST_F(SpaceManagerImplTest, TestDeAlloc) {
+    mds::space::BlockGroup group;
+    group.set_offset(0);
+    group.set_size(kBlockGroupSize);
+    group.set_available(kBlockGroupSize);
+    group.set_bitmaplocation(curvefs::common::BitmapLocation::AtStart);
+
+    // the only block group is allocated once
+    EXPECT_CALL(*mdsClient_, AllocateVolumeBlockGroup(_, _, _, _))
+        .WillOnce(Invoke(MockAllocateBlockGroup{group}));
+
+    EXPECT_CALL(*devClient_, Read(_, _, _))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Invoke(MockRead));
+
+    EXPECT_CALL(*devClient_, Write(_, _, _))
+        .Times(AtLeast(1))
+        .WillRepeatedly(Invoke(MockWrite));
+
+    const uint64_t blocks = kBlockGroupSize / kBlockSize - 1;
+    std::vector<Extent> extents;
+    for (uint64_t i = 0; i < blocks; ++i) {
+        std::vector<Extent> ext;
+        ASSERT_TRUE(spaceManager_->Alloc(kBlockSize, {}, &ext));
+        extents.insert(extents.end(), ext.begin(), ext.end());
+    }
+
+    // released space can be allocated again
+    std::vector<Extent> released(extents.begin(), extents.begin() + 16);
+    ASSERT_TRUE(spaceManager_->DeAlloc(released));
+
+    std::vector<Extent> reallocated;
+    ASSERT_TRUE(spaceManager_->Alloc(16 * kBlockSize, {}, &reallocated));
+
+    // no allocator for the space
+    ASSERT_FALSE(spaceManager_->DeAlloc({Extent(kBlockGroupSize, kBlockSize)}));
+}
+
 TEST_F(SpaceManagerImplTest, TestMultiThreadAlloc) {
     mds::space::BlockGroup group;
     group.set_offset(0);
@@ -373,8 +373,10 @@ inline bool operator==(const UserInfo& lhs, const UserInfo& rhs) {
 
 struct OpenFlags {
     bool exclusive;
+    // like O_DIRECT, bypass the client side read cache
+    bool directIO;
 
-    OpenFlags() : exclusive(true) {}
+    OpenFlags() : exclusive(true), directIO(false) {}
 };
 
 class CurveClient {
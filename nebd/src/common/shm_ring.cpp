@@ -0,0 +1,366 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: nebd
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "nebd/src/common/shm_ring.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+namespace nebd {
+namespace common {
+
+namespace {
+
+constexpr uint64_t kShmRingMagic = 0x6e6562645f726e67ULL;  // "nebd_rng"
+constexpr uint32_t kShmRingVersion = 1;
+constexpr size_t kCacheLineSize = 64;
+constexpr size_t kPageSize = 4096;
+constexpr uint32_t kSpinYieldInterval = 64;
+
+size_t AlignUp(size_t size, size_t align) {
+    return (size + align - 1) / align * align;
+}
+
+uint64_t NowUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// 共享内存在不同进程中映射的地址不同，不能使用FUTEX_PRIVATE_FLAG
+void FutexWait(std::atomic<uint32_t>* addr, uint32_t expected,
+               uint32_t timeoutMs) {
+    timespec ts;
+    ts.tv_sec = timeoutMs / 1000;
+    ts.tv_nsec = (timeoutMs % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT,
+            expected, &ts, nullptr, 0);
+}
+
+void FutexWake(std::atomic<uint32_t>* addr) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, 1,
+            nullptr, nullptr, 0);
+}
+
+}  // namespace
+
+struct ShmRingHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t slotNum;
+    uint32_t bufSize;
+    int32_t ownerPid;
+    uint64_t totalSize;
+    alignas(kCacheLineSize) std::atomic<uint64_t> serverHeartbeatMs;
+    ShmQueueCtrl submit;
+    ShmQueueCtrl complete;
+};
+
+namespace {
+
+struct ShmRingLayout {
+    size_t submitOffset;
+    size_t completeOffset;
+    size_t slotOffset;
+    size_t bufferOffset;
+    size_t totalSize;
+
+    ShmRingLayout(uint32_t slotNum, uint32_t bufSize) {
+        submitOffset = AlignUp(sizeof(ShmRingHeader), kCacheLineSize);
+        completeOffset = AlignUp(submitOffset + slotNum * sizeof(uint32_t),
+                                 kCacheLineSize);
+        slotOffset = AlignUp(completeOffset + slotNum * sizeof(uint32_t),
+                             kCacheLineSize);
+        bufferOffset =
+            AlignUp(slotOffset + slotNum * sizeof(ShmSlot), kPageSize);
+        totalSize = bufferOffset + static_cast<size_t>(slotNum) * bufSize;
+    }
+};
+
+}  // namespace
+
+ShmRing::ShmRing(const std::string& name, void* addr, size_t size,
+                 uint32_t slotNum, uint32_t bufSize)
+    : name_(name), addr_(addr), size_(size), slotNum_(slotNum),
+      bufSize_(bufSize) {
+    char* base = static_cast<char*>(addr_);
+    header_ = reinterpret_cast<ShmRingHeader*>(base);
+    ShmRingLayout layout(slotNum_, bufSize_);
+    submitEntries_ = reinterpret_cast<uint32_t*>(base + layout.submitOffset);
+    completeEntries_ =
+        reinterpret_cast<uint32_t*>(base + layout.completeOffset);
+    slots_ = reinterpret_cast<ShmSlot*>(base + layout.slotOffset);
+    buffers_ = base + layout.bufferOffset;
+}
+
+ShmRing::~ShmRing() {
+    if (addr_ != nullptr) {
+        munmap(addr_, size_);
+    }
+}
+
+std::unique_ptr<ShmRing> ShmRing::Create(const std::string& name,
+                                         uint32_t slotNum,
+                                         uint32_t bufSize) {
+    if (slotNum == 0 || (slotNum & (slotNum - 1)) != 0 || bufSize == 0) {
+        LOG(ERROR) << "Invalid shm ring option, slotNum: " << slotNum
+                   << ", bufSize: " << bufSize;
+        return nullptr;
+    }
+
+    ShmRingLayout layout(slotNum, bufSize);
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        LOG(ERROR) << "Create shm failed, name: " << name
+                   << ", error: " << strerror(errno);
+        return nullptr;
+    }
+
+    if (ftruncate(fd, layout.totalSize) != 0) {
+        LOG(ERROR) << "Truncate shm failed, name: " << name
+                   << ", size: " << layout.totalSize
+                   << ", error: " << strerror(errno);
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    void* addr = mmap(nullptr, layout.totalSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        LOG(ERROR) << "Map shm failed, name: " << name
+                   << ", error: " << strerror(errno);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    ShmRingHeader* header = new (addr) ShmRingHeader();
+    header->version = kShmRingVersion;
+    header->slotNum = slotNum;
+    header->bufSize = bufSize;
+    header->ownerPid = getpid();
+    header->totalSize = layout.totalSize;
+    header->serverHeartbeatMs.store(0);
+    header->submit.head.store(0);
+    header->submit.tail.store(0);
+    header->submit.waiting.store(0);
+    header->complete.head.store(0);
+    header->complete.tail.store(0);
+    header->complete.waiting.store(0);
+    // magic最后写，attach时据此判断是否初始化完成
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = kShmRingMagic;
+
+    return std::unique_ptr<ShmRing>(
+        new ShmRing(name, addr, layout.totalSize, slotNum, bufSize));
+}
+
+std::unique_ptr<ShmRing> ShmRing::Attach(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        LOG(ERROR) << "Open shm failed, name: " << name
+                   << ", error: " << strerror(errno);
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(ShmRingHeader)) {
+        LOG(ERROR) << "Invalid shm size, name: " << name;
+        close(fd);
+        return nullptr;
+    }
+
+    void* addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        LOG(ERROR) << "Map shm failed, name: " << name
+                   << ", error: " << strerror(errno);
+        return nullptr;
+    }
+
+    // header可以被part1随时修改，只读取一次，检查和使用的都是本地的拷贝
+    const volatile ShmRingHeader* header =
+        static_cast<const volatile ShmRingHeader*>(addr);
+    uint64_t magic = header->magic;
+    uint32_t version = header->version;
+    uint32_t slotNum = header->slotNum;
+    uint32_t bufSize = header->bufSize;
+    bool valid = magic == kShmRingMagic && version == kShmRingVersion &&
+                 slotNum != 0 && (slotNum & (slotNum - 1)) == 0 &&
+                 bufSize != 0 &&
+                 ShmRingLayout(slotNum, bufSize).totalSize <=
+                     static_cast<size_t>(st.st_size);
+    if (!valid) {
+        LOG(ERROR) << "Invalid shm ring header, name: " << name
+                   << ", slotNum: " << slotNum << ", bufSize: " << bufSize
+                   << ", size: " << st.st_size;
+        munmap(addr, st.st_size);
+        return nullptr;
+    }
+
+    return std::unique_ptr<ShmRing>(
+        new ShmRing(name, addr, st.st_size, slotNum, bufSize));
+}
+
+void ShmRing::Unlink() {
+    if (shm_unlink(name_.c_str()) != 0 && errno != ENOENT) {
+        LOG(WARNING) << "Unlink shm failed, name: " << name_
+                     << ", error: " << strerror(errno);
+    }
+}
+
+uint32_t ShmRing::SlotNum() const {
+    return slotNum_;
+}
+
+uint32_t ShmRing::BufSize() const {
+    return bufSize_;
+}
+
+pid_t ShmRing::OwnerPid() const {
+    return header_->ownerPid;
+}
+
+ShmSlot* ShmRing::GetSlot(uint32_t index) {
+    return &slots_[index];
+}
+
+char* ShmRing::GetBuffer(uint32_t index) {
+    return buffers_ + static_cast<size_t>(index) * bufSize_;
+}
+
+void ShmRing::Submit(uint32_t index) {
+    Push(&header_->submit, submitEntries_, index);
+}
+
+bool ShmRing::PollSubmission(uint32_t* index) {
+    return Pop(&header_->submit, submitEntries_, index);
+}
+
+void ShmRing::WaitSubmission(uint32_t spinUs, uint32_t timeoutMs) {
+    Wait(&header_->submit, spinUs, timeoutMs);
+}
+
+void ShmRing::Complete(uint32_t index) {
+    Push(&header_->complete, completeEntries_, index);
+}
+
+bool ShmRing::PollCompletion(uint32_t* index) {
+    return Pop(&header_->complete, completeEntries_, index);
+}
+
+void ShmRing::WaitCompletion(uint32_t spinUs, uint32_t timeoutMs) {
+    Wait(&header_->complete, spinUs, timeoutMs);
+}
+
+void ShmRing::UpdateServerHeartbeat() {
+    header_->serverHeartbeatMs.store(NowMs(), std::memory_order_relaxed);
+}
+
+uint64_t ShmRing::GetServerHeartbeatMs() const {
+    return header_->serverHeartbeatMs.load(std::memory_order_relaxed);
+}
+
+uint64_t ShmRing::NowMs() {
+    return NowUs() / 1000;
+}
+
+void ShmRing::Push(ShmQueueCtrl* ctrl, uint32_t* entries, uint32_t index) {
+    // 同时在队列中的slot不会超过slotNum，队列不会满
+    uint32_t tail = ctrl->tail.load(std::memory_order_relaxed);
+    entries[tail & (slotNum_ - 1)] = index;
+    ctrl->tail.store(tail + 1, std::memory_order_seq_cst);
+
+    // 与Wait中先设置waiting再检查队列配合，保证不会丢失唤醒
+    if (ctrl->waiting.load(std::memory_order_seq_cst) != 0 &&
+        ctrl->waiting.exchange(0, std::memory_order_seq_cst) != 0) {
+        FutexWake(&ctrl->waiting);
+    }
+}
+
+bool ShmRing::Pop(ShmQueueCtrl* ctrl, uint32_t* entries, uint32_t* index) {
+    uint32_t head = ctrl->head.load(std::memory_order_relaxed);
+    if (head == ctrl->tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    uint32_t value = entries[head & (slotNum_ - 1)];
+    ctrl->head.store(head + 1, std::memory_order_release);
+    if (value >= slotNum_) {
+        LOG(ERROR) << "Invalid slot index " << value << " in shm ring "
+                   << name_;
+        return false;
+    }
+    *index = value;
+    return true;
+}
+
+void ShmRing::Wait(ShmQueueCtrl* ctrl, uint32_t spinUs, uint32_t timeoutMs) {
+    // 先忙等一小段时间，请求密集时避免睡眠和唤醒的系统调用
+    // 定期让出cpu，对端和自己在同一个核上时也能尽快处理
+    uint64_t deadline = NowUs() + spinUs;
+    for (uint32_t i = 1; ; ++i) {
+        if (ctrl->head.load(std::memory_order_relaxed) !=
+            ctrl->tail.load(std::memory_order_acquire)) {
+            return;
+        }
+        if (i % kSpinYieldInterval == 0) {
+            sched_yield();
+        } else {
+            CpuRelax();
+        }
+        if (NowUs() >= deadline) {
+            break;
+        }
+    }
+
+    ctrl->waiting.store(1, std::memory_order_seq_cst);
+    if (ctrl->head.load(std::memory_order_relaxed) !=
+        ctrl->tail.load(std::memory_order_seq_cst)) {
+        ctrl->waiting.store(0, std::memory_order_relaxed);
+        return;
+    }
+    FutexWait(&ctrl->waiting, 1, timeoutMs);
+    ctrl->waiting.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace common
+}  // namespace nebd
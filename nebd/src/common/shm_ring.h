@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: nebd
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef NEBD_SRC_COMMON_SHM_RING_H_
+#define NEBD_SRC_COMMON_SHM_RING_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace nebd {
+namespace common {
+
+// 跨进程使用的原子变量必须是lock free的
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "shm ring requires lock free atomics");
+
+enum class ShmOp : uint32_t {
+    kRead = 0,
+    kWrite = 1,
+};
+
+enum class ShmStatus : int32_t {
+    kOK = 0,
+    // io失败，返回给上层
+    kError = 1,
+    // part2不返回io错误，请求需要由part1走rpc重新下发
+    kRetry = 2,
+};
+
+// 请求描述符，与数据buffer一一对应，由part1填写请求，part2填写结果
+struct ShmSlot {
+    uint32_t op;
+    int32_t fd;
+    uint64_t offset;
+    uint64_t length;
+    int32_t status;
+    uint32_t reserved;
+};
+
+// 单生产者单消费者的slot下标队列的控制信息
+struct ShmQueueCtrl {
+    // 消费者的位置
+    alignas(64) std::atomic<uint32_t> head;
+    // 生产者的位置
+    alignas(64) std::atomic<uint32_t> tail;
+    // 消费者是否在等待，作为futex的等待地址
+    alignas(64) std::atomic<uint32_t> waiting;
+};
+
+struct ShmRingHeader;
+
+/**
+ * part1和part2之间基于共享内存的数据通道
+ * 共享内存由part1创建，通过rpc把名字告诉part2，part2 attach之后，
+ * 请求描述符通过提交队列从part1传给part2，处理完后再通过完成队列返回。
+ * 每个slot有一块预先分配的数据buffer，读写数据不再经过socket。
+ *
+ * 两个队列都是单生产者单消费者的，多线程提交或完成时需要调用者加锁。
+ * 消费者没有请求时睡眠在futex上，生产者只有在消费者睡眠时才需要唤醒，
+ * 因此在请求密集时提交和完成都不需要系统调用。
+ */
+class ShmRing {
+ public:
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    /**
+     * @brief 创建共享内存，由part1调用
+     * @param name: 共享内存的名字，以'/'开头
+     * @param slotNum: slot的数量，需要是2的幂
+     * @param bufSize: 每个slot数据buffer的大小
+     * @return 失败返回nullptr
+     */
+    static std::unique_ptr<ShmRing> Create(const std::string& name,
+                                           uint32_t slotNum,
+                                           uint32_t bufSize);
+
+    /**
+     * @brief attach已经创建的共享内存，由part2调用
+     * @return 失败返回nullptr
+     */
+    static std::unique_ptr<ShmRing> Attach(const std::string& name);
+
+    /**
+     * @brief 删除共享内存的名字，已经map的进程不受影响
+     */
+    void Unlink();
+
+    const std::string& Name() const { return name_; }
+    uint32_t SlotNum() const;
+    uint32_t BufSize() const;
+    pid_t OwnerPid() const;
+
+    ShmSlot* GetSlot(uint32_t index);
+    char* GetBuffer(uint32_t index);
+
+    // 提交队列，part1生产，part2消费
+    void Submit(uint32_t index);
+    bool PollSubmission(uint32_t* index);
+    void WaitSubmission(uint32_t spinUs, uint32_t timeoutMs);
+
+    // 完成队列，part2生产，part1消费
+    void Complete(uint32_t index);
+    bool PollCompletion(uint32_t* index);
+    void WaitCompletion(uint32_t spinUs, uint32_t timeoutMs);
+
+    // part2定期更新心跳，part1据此判断part2是否还在处理请求
+    void UpdateServerHeartbeat();
+    uint64_t GetServerHeartbeatMs() const;
+
+    // 单调时钟，不同进程之间可以比较
+    static uint64_t NowMs();
+
+ private:
+    ShmRing(const std::string& name, void* addr, size_t size,
+            uint32_t slotNum, uint32_t bufSize);
+
+    void Push(ShmQueueCtrl* ctrl, uint32_t* entries, uint32_t index);
+    bool Pop(ShmQueueCtrl* ctrl, uint32_t* entries, uint32_t* index);
+    void Wait(ShmQueueCtrl* ctrl, uint32_t spinUs, uint32_t timeoutMs);
+
+ private:
+    std::string name_;
+    void* addr_;
+    size_t size_;
+    // header中的slotNum和bufSize对端可以修改，只在创建或attach时读取并
+    // 检查一次，之后都使用这里的拷贝
+    uint32_t slotNum_;
+    uint32_t bufSize_;
+    ShmRingHeader* header_;
+    uint32_t* submitEntries_;
+    uint32_t* completeEntries_;
+    ShmSlot* slots_;
+    char* buffers_;
+};
+
+}  // namespace common
+}  // namespace nebd
+
+#endif  // NEBD_SRC_COMMON_SHM_RING_H_
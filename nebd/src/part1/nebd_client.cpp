@@ -120,6 +120,21 @@ int NebdClient::Init(const char* confpath) {
         }
     }
 
+    if (option_.shmRingOption.enable) {
+        shmTransport_.reset(new NebdShmTransport(
+            option_.shmRingOption,
+            [this](const std::string& name) { return RegisterShmRing(name); },
+            [this](int fd, NebdClientAioContext* aioctx) {
+                // 直接走rpc，共享内存可能仍然可用，不能再提交到共享内存
+                if (aioctx->op == LIBAIO_OP::LIBAIO_OP_READ) {
+                    AioReadByRpc(fd, aioctx);
+                } else {
+                    AioWriteByRpc(fd, aioctx);
+                }
+            }));
+        shmTransport_->Start();
+    }
+
     return 0;
 }
 
@@ -128,6 +143,10 @@ void NebdClient::Uninit() {
         heartbeatMgr_->Stop();
     }
 
+    if (shmTransport_ != nullptr) {
+        shmTransport_->Stop();
+    }
+
     // stop exec queue
     for (auto& q : rpcTaskQueues_) {
         bthread::execution_queue_stop(q);
@@ -340,6 +359,14 @@ int NebdClient::Discard(int fd, NebdClientAioContext* aioctx) {
 }
 
 int NebdClient::AioRead(int fd, NebdClientAioContext* aioctx) {
+    if (shmTransport_ != nullptr && shmTransport_->AioRead(fd, aioctx)) {
+        return 0;
+    }
+
+    return AioReadByRpc(fd, aioctx);
+}
+
+int NebdClient::AioReadByRpc(int fd, NebdClientAioContext* aioctx) {
     auto task = [this, fd, aioctx]() {
         nebd::client::NebdFileService_Stub stub(&channel_);
         nebd::client::ReadRequest request;
@@ -362,6 +389,14 @@ int NebdClient::AioRead(int fd, NebdClientAioContext* aioctx) {
 static void EmptyDeleter(void* m) {}
 
 int NebdClient::AioWrite(int fd, NebdClientAioContext* aioctx) {
+    if (shmTransport_ != nullptr && shmTransport_->AioWrite(fd, aioctx)) {
+        return 0;
+    }
+
+    return AioWriteByRpc(fd, aioctx);
+}
+
+int NebdClient::AioWriteByRpc(int fd, NebdClientAioContext* aioctx) {
     auto task = [this, fd, aioctx]() {
         nebd::client::NebdFileService_Stub stub(&channel_);
         nebd::client::WriteRequest request;
@@ -478,6 +513,39 @@ int NebdClient::InvalidCache(int fd) {
     return ret;
 }
 
+int NebdClient::RegisterShmRing(const std::string& name) {
+    nebd::client::NebdFileService_Stub stub(&channel_);
+    nebd::client::RegisterShmRingRequest request;
+    nebd::client::RegisterShmRingResponse response;
+    brpc::Controller cntl;
+
+    // 只尝试一次，失败后由NebdShmTransport定期重试
+    cntl.set_timeout_ms(option_.shmRingOption.serverTimeoutMs);
+    cntl.set_log_id(logId_.fetch_add(1, std::memory_order_relaxed));
+    request.set_name(name);
+    request.set_pid(getpid());
+    stub.RegisterShmRing(&cntl, &request, &response, nullptr);
+
+    if (cntl.Failed()) {
+        LOG(WARNING) << "RegisterShmRing rpc failed, error = "
+                     << cntl.ErrorText()
+                     << ", name = " << name
+                     << ", log id = " << cntl.log_id();
+        return -1;
+    }
+
+    if (response.retcode() != nebd::client::RetCode::kOK) {
+        LOG(WARNING) << "RegisterShmRing failed, "
+                     << "retcode = " << response.retcode()
+                     << ",  retmsg = " << response.retmsg()
+                     << ", name = " << name
+                     << ", log id = " << cntl.log_id();
+        return -1;
+    }
+
+    return 0;
+}
+
 int NebdClient::InitNebdClientOption(Configuration* conf) {
     bool ret = false;
     ret = conf->GetStringValue("nebdserver.serverAddress",
@@ -535,6 +603,28 @@ int NebdClient::InitNebdClientOption(Configuration* conf) {
     LOG_IF(ERROR, ret != true) << "Load log.path failed";
     RETURN_IF_FALSE(ret);
 
+    ShmRingOption* shmRingOption = &option_.shmRingOption;
+    LOG_IF(WARNING, !conf->GetBoolValue("shmRing.enable",
+                                        &shmRingOption->enable))
+        << "Load shmRing.enable failed, use default value "
+        << shmRingOption->enable;
+    LOG_IF(WARNING, !conf->GetUInt32Value("shmRing.slotNum",
+                                          &shmRingOption->slotNum))
+        << "Load shmRing.slotNum failed, use default value "
+        << shmRingOption->slotNum;
+    LOG_IF(WARNING, !conf->GetUInt32Value("shmRing.bufSize",
+                                          &shmRingOption->bufSize))
+        << "Load shmRing.bufSize failed, use default value "
+        << shmRingOption->bufSize;
+    LOG_IF(WARNING, !conf->GetUInt32Value("shmRing.pollSpinUs",
+                                          &shmRingOption->pollSpinUs))
+        << "Load shmRing.pollSpinUs failed, use default value "
+        << shmRingOption->pollSpinUs;
+    LOG_IF(WARNING, !conf->GetUInt32Value("shmRing.serverTimeoutMs",
+                                          &shmRingOption->serverTimeoutMs))
+        << "Load shmRing.serverTimeoutMs failed, use default value "
+        << shmRingOption->serverTimeoutMs;
+
     return 0;
 }
 
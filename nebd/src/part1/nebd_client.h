@@ -37,6 +37,7 @@
 #include "nebd/src/part1/libnebd.h"
 #include "nebd/src/part1/heartbeat_manager.h"
 #include "nebd/src/part1/nebd_metacache.h"
+#include "nebd/src/part1/shm_transport.h"
 
 #include "include/curve_compiler_specific.h"
 
@@ -154,6 +155,19 @@ class NebdClient {
 
     int InitChannel();
 
+    /**
+     * @brief 把part1创建的共享内存注册到part2
+     * @param name: 共享内存的名字
+     * @return 成功返回0，失败返回-1
+     */
+    int RegisterShmRing(const std::string& name);
+
+    /**
+     * @brief 通过rpc下发读写请求，不经过共享内存
+     */
+    int AioReadByRpc(int fd, NebdClientAioContext* aioctx);
+    int AioWriteByRpc(int fd, NebdClientAioContext* aioctx);
+
     void InitLogger(const LogOption& logOption);
 
     /**
@@ -169,6 +183,8 @@ class NebdClient {
     std::shared_ptr<HeartbeatManager> heartbeatMgr_;
     // 缓存模块
     std::shared_ptr<NebdClientMetaCache> metaCache_;
+    // 共享内存数据通道，未开启时为nullptr
+    std::unique_ptr<NebdShmTransport> shmTransport_;
 
     NebdClientOption option_;
 
@@ -49,6 +49,20 @@ struct LogOption {
     std::string logPath;
 };
 
+// 共享内存数据通道配置项
+struct ShmRingOption {
+    // 是否通过共享内存下发读写请求
+    bool enable = false;
+    // slot数量，即最多同时下发的请求数，需要是2的幂
+    uint32_t slotNum = 128;
+    // 每个slot的数据buffer大小，超过的请求走rpc
+    uint32_t bufSize = 256 * 1024;
+    // 等待请求完成时，睡眠前忙等的时间
+    uint32_t pollSpinUs = 50;
+    // part2心跳超时时间，超时后切回rpc并重建共享内存
+    uint32_t serverTimeoutMs = 3000;
+};
+
 // nebd client配置项
 struct NebdClientOption {
     // part2 socket file address
@@ -59,6 +73,8 @@ struct NebdClientOption {
     RequestOption requestOption;
     // 日志配置项
     LogOption logOption;
+    // 共享内存数据通道配置项
+    ShmRingOption shmRingOption;
 };
 
 // heartbeat配置项
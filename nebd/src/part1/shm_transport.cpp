@@ -0,0 +1,238 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: nebd
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "nebd/src/part1/shm_transport.h"
+
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <utility>
+
+#include "nebd/src/part1/async_request_closure.h"
+
+namespace nebd {
+namespace client {
+
+using nebd::common::ShmOp;
+using nebd::common::ShmRing;
+using nebd::common::ShmSlot;
+using nebd::common::ShmStatus;
+
+namespace {
+
+// 等待完成的超时时间，也是检查part2心跳的周期
+constexpr uint32_t kWaitCompletionTimeoutMs = 100;
+
+}  // namespace
+
+NebdShmTransport::NebdShmTransport(const ShmRingOption& option,
+                                   ShmRegisterFunc registerFunc,
+                                   ShmFallbackFunc fallbackFunc)
+    : option_(option),
+      registerFunc_(std::move(registerFunc)),
+      fallbackFunc_(std::move(fallbackFunc)),
+      ringSeq_(0),
+      running_(false) {}
+
+void NebdShmTransport::Start() {
+    if (!ResetRing()) {
+        LOG(WARNING) << "Init shm ring failed, use rpc until it's ready";
+    }
+
+    running_ = true;
+    thread_ = std::thread(&NebdShmTransport::CompletionThreadFunc, this);
+}
+
+void NebdShmTransport::Stop() {
+    if (running_ == true) {
+        running_ = false;
+        sleeper_.interrupt();
+        thread_.join();
+    }
+}
+
+bool NebdShmTransport::AioRead(int fd, NebdClientAioContext* aioctx) {
+    return Submit(fd, aioctx, ShmOp::kRead);
+}
+
+bool NebdShmTransport::AioWrite(int fd, NebdClientAioContext* aioctx) {
+    return Submit(fd, aioctx, ShmOp::kWrite);
+}
+
+bool NebdShmTransport::Submit(int fd, NebdClientAioContext* aioctx,
+                              ShmOp op) {
+    if (aioctx->length > option_.bufSize) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (ring_ == nullptr || freeSlots_.empty()) {
+        return false;
+    }
+
+    uint32_t index = freeSlots_.back();
+    freeSlots_.pop_back();
+
+    ShmSlot* slot = ring_->GetSlot(index);
+    slot->op = static_cast<uint32_t>(op);
+    slot->fd = fd;
+    slot->offset = aioctx->offset;
+    slot->length = aioctx->length;
+    slot->status = static_cast<int32_t>(ShmStatus::kOK);
+    if (op == ShmOp::kWrite) {
+        memcpy(ring_->GetBuffer(index), aioctx->buf, aioctx->length);
+    }
+
+    inflight_[index].fd = fd;
+    inflight_[index].aioctx = aioctx;
+    ring_->Submit(index);
+    return true;
+}
+
+bool NebdShmTransport::ResetRing() {
+    std::string name = "/nebd-shm-" + std::to_string(getpid()) + "-" +
+                       std::to_string(ringSeq_++);
+    std::unique_ptr<ShmRing> ring =
+        ShmRing::Create(name, option_.slotNum, option_.bufSize);
+    if (ring == nullptr) {
+        return false;
+    }
+
+    int ret = registerFunc_(name);
+    // part2已经attach或者注册失败，名字都不再需要了
+    ring->Unlink();
+    if (ret != 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    ring_ = std::move(ring);
+    inflight_.assign(option_.slotNum, InflightRequest());
+    freeSlots_.clear();
+    for (uint32_t i = 0; i < option_.slotNum; ++i) {
+        freeSlots_.push_back(option_.slotNum - 1 - i);
+    }
+
+    LOG(INFO) << "Register shm ring success, name = " << name
+              << ", slot num = " << option_.slotNum
+              << ", buf size = " << option_.bufSize;
+    return true;
+}
+
+void NebdShmTransport::CloseRing() {
+    std::vector<InflightRequest> pending;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        for (const auto& req : inflight_) {
+            if (req.aioctx != nullptr) {
+                pending.push_back(req);
+            }
+        }
+        inflight_.clear();
+        freeSlots_.clear();
+        ring_.reset();
+    }
+
+    LOG(WARNING) << "Shm ring closed, resend " << pending.size()
+                 << " requests by rpc";
+    for (const auto& req : pending) {
+        fallbackFunc_(req.fd, req.aioctx);
+    }
+}
+
+void NebdShmTransport::HandleCompletion(uint32_t index) {
+    InflightRequest req;
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        req = inflight_[index];
+        inflight_[index] = InflightRequest();
+    }
+
+    if (req.aioctx == nullptr) {
+        LOG(ERROR) << "Shm ring slot " << index << " is not inflight";
+        return;
+    }
+
+    NebdClientAioContext* aioctx = req.aioctx;
+    ShmSlot* slot = ring_->GetSlot(index);
+    ShmStatus status = static_cast<ShmStatus>(slot->status);
+    if (status == ShmStatus::kOK && aioctx->op == LIBAIO_OP::LIBAIO_OP_READ) {
+        memcpy(aioctx->buf, ring_->GetBuffer(index), aioctx->length);
+    }
+
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        freeSlots_.push_back(index);
+    }
+
+    // part2暂时无法处理该请求，改走rpc，由rpc的重试逻辑保证请求最终完成
+    if (status == ShmStatus::kRetry) {
+        fallbackFunc_(req.fd, aioctx);
+        return;
+    }
+
+    if (status == ShmStatus::kOK) {
+        aioctx->ret = 0;
+    } else {
+        LOG(ERROR) << OpTypeToString(aioctx->op) << " failed, fd = "
+                   << req.fd << ", offset = " << aioctx->offset
+                   << ", length = " << aioctx->length;
+        aioctx->ret = -1;
+    }
+    aioctx->cb(aioctx);
+}
+
+void NebdShmTransport::CompletionThreadFunc() {
+    LOG(INFO) << "Shm ring completion thread started";
+
+    while (running_) {
+        if (ring_ == nullptr) {
+            sleeper_.wait_for(
+                std::chrono::milliseconds(option_.serverTimeoutMs));
+            if (running_) {
+                ResetRing();
+            }
+            continue;
+        }
+
+        uint32_t index;
+        while (ring_->PollCompletion(&index)) {
+            HandleCompletion(index);
+        }
+
+        uint64_t heartbeat = ring_->GetServerHeartbeatMs();
+        if (heartbeat + option_.serverTimeoutMs < ShmRing::NowMs()) {
+            LOG(WARNING) << "Nebd server heartbeat timeout, last heartbeat "
+                         << heartbeat << " ms";
+            CloseRing();
+            continue;
+        }
+
+        ring_->WaitCompletion(option_.pollSpinUs, kWaitCompletionTimeoutMs);
+    }
+
+    LOG(INFO) << "Shm ring completion thread stopped";
+}
+
+}  // namespace client
+}  // namespace nebd
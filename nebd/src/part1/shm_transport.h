@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: nebd
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef NEBD_SRC_PART1_SHM_TRANSPORT_H_
+#define NEBD_SRC_PART1_SHM_TRANSPORT_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "nebd/src/common/interrupt_sleep.h"
+#include "nebd/src/common/shm_ring.h"
+#include "nebd/src/part1/libnebd.h"
+#include "nebd/src/part1/nebd_common.h"
+
+namespace nebd {
+namespace client {
+
+// 通过rpc把共享内存的名字注册到part2，成功返回0
+using ShmRegisterFunc = std::function<int(const std::string& name)>;
+// 共享内存不可用或part2要求重试时，把请求改为通过rpc下发，
+// 不能再提交到共享内存
+using ShmFallbackFunc = std::function<void(int fd,
+                                           NebdClientAioContext* aioctx)>;
+
+/**
+ * part1通过共享内存下发读写请求
+ * 写请求的数据拷贝到slot的buffer中，读请求完成后从slot的buffer拷贝给上层，
+ * 请求和结果通过ShmRing的两个队列传递，不再经过socket和IOBuf。
+ *
+ * 请求大于slot的buffer、slot用完或者共享内存不可用时，AioRead/AioWrite
+ * 返回false，由调用者走rpc。part2心跳超时后，已下发的请求全部改走rpc，
+ * 之后定期重建共享内存并重新注册。
+ */
+class NebdShmTransport {
+ public:
+    NebdShmTransport(const ShmRingOption& option,
+                     ShmRegisterFunc registerFunc,
+                     ShmFallbackFunc fallbackFunc);
+
+    ~NebdShmTransport() {
+        Stop();
+    }
+
+    /**
+     * @brief 创建共享内存并启动完成线程，创建或注册失败时会在后台重试
+     */
+    void Start();
+
+    void Stop();
+
+    /**
+     * @brief 通过共享内存下发读写请求
+     * @return 成功下发返回true，返回false时需要调用者通过rpc下发
+     */
+    bool AioRead(int fd, NebdClientAioContext* aioctx);
+    bool AioWrite(int fd, NebdClientAioContext* aioctx);
+
+ private:
+    struct InflightRequest {
+        int fd = -1;
+        NebdClientAioContext* aioctx = nullptr;
+    };
+
+    bool Submit(int fd, NebdClientAioContext* aioctx,
+                nebd::common::ShmOp op);
+
+    /**
+     * @brief 创建新的共享内存并注册到part2
+     */
+    bool ResetRing();
+
+    /**
+     * @brief 释放当前的共享内存，未完成的请求改走rpc
+     */
+    void CloseRing();
+
+    void HandleCompletion(uint32_t index);
+
+    void CompletionThreadFunc();
+
+ private:
+    ShmRingOption option_;
+    ShmRegisterFunc registerFunc_;
+    ShmFallbackFunc fallbackFunc_;
+
+    // 保护ring_、freeSlots_和inflight_
+    // ring_只会在完成线程中修改，完成线程访问时不需要加锁
+    std::mutex mtx_;
+    std::unique_ptr<nebd::common::ShmRing> ring_;
+    std::vector<uint32_t> freeSlots_;
+    std::vector<InflightRequest> inflight_;
+
+    uint64_t ringSeq_;
+    std::atomic<bool> running_;
+    std::thread thread_;
+    nebd::common::InterruptibleSleeper sleeper_;
+};
+
+}  // namespace client
+}  // namespace nebd
+
+#endif  // NEBD_SRC_PART1_SHM_TRANSPORT_H_
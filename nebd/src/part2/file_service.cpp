@@ -358,5 +358,29 @@ void NebdFileServiceImpl::InvalidateCache(
     }
 }
 
+void NebdFileServiceImpl::RegisterShmRing(
+    google::protobuf::RpcController* cntl_base,
+    const nebd::client::RegisterShmRingRequest* request,
+    nebd::client::RegisterShmRingResponse* response,
+    google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    response->set_retcode(RetCode::kNoOK);
+
+    if (shmRingServer_ == nullptr) {
+        response->set_retmsg("shm ring is not supported");
+        return;
+    }
+
+    int rc = shmRingServer_->Register(request->name(), request->pid());
+    if (rc < 0) {
+        LOG(ERROR) << "Register shm ring failed. "
+                   << "name: " << request->name()
+                   << ", pid: " << request->pid()
+                   << ", return code: " << rc;
+    } else {
+        response->set_retcode(RetCode::kOK);
+    }
+}
+
 }  // namespace server
 }  // namespace nebd
@@ -31,6 +31,7 @@
 
 #include "nebd/proto/client.pb.h"
 #include "nebd/src/part2/file_manager.h"
+#include "nebd/src/part2/shm_ring_server.h"
 
 namespace nebd {
 namespace server {
@@ -40,9 +41,12 @@ void NebdFileServiceCallback(NebdServerAioContext* context);
 class NebdFileServiceImpl : public nebd::client::NebdFileService {
  public:
     explicit NebdFileServiceImpl(std::shared_ptr<NebdFileManager> fileManager,
-                                 const bool returnRpcWhenIoError)
+                                 const bool returnRpcWhenIoError,
+                                 std::shared_ptr<NebdShmRingServer>
+                                     shmRingServer = nullptr)
                                  : fileManager_(fileManager),
-                                 returnRpcWhenIoError_(returnRpcWhenIoError) {}
+                                 returnRpcWhenIoError_(returnRpcWhenIoError),
+                                 shmRingServer_(shmRingServer) {}
 
     virtual ~NebdFileServiceImpl() {}
 
@@ -91,9 +95,16 @@ class NebdFileServiceImpl : public nebd::client::NebdFileService {
                             nebd::client::InvalidateCacheResponse* response,
                             google::protobuf::Closure* done);
 
+    virtual void RegisterShmRing(google::protobuf::RpcController* cntl_base,
+                            const nebd::client::RegisterShmRingRequest* request,
+                            nebd::client::RegisterShmRingResponse* response,
+                            google::protobuf::Closure* done);
+
  private:
     std::shared_ptr<NebdFileManager> fileManager_;
     const bool returnRpcWhenIoError_;
+    // 共享内存数据通道，为nullptr时不支持
+    std::shared_ptr<NebdShmRingServer> shmRingServer_;
 };
 
 }  // namespace server
@@ -95,6 +95,10 @@ int NebdServer::Fini() {
         brpc::AskToQuit();
     }
 
+    if (shmRingServer_ != nullptr) {
+        shmRingServer_->Fini();
+    }
+
     if (fileManager_ != nullptr) {
         fileManager_->Fini();
     }
@@ -219,7 +223,10 @@ bool NebdServer::StartServer() {
         return false;
     }
 
-    NebdFileServiceImpl fileService(fileManager_, returnRpcWhenIoError);
+    shmRingServer_ = std::make_shared<NebdShmRingServer>(
+        fileManager_, returnRpcWhenIoError);
+    NebdFileServiceImpl fileService(fileManager_, returnRpcWhenIoError,
+                                    shmRingServer_);
     int addFileServiceRes = server_.AddService(
         &fileService, brpc::SERVER_DOESNT_OWN_SERVICE);
     if (0 != addFileServiceRes) {
@@ -30,6 +30,7 @@
 #include "nebd/src/part2/file_manager.h"
 #include "nebd/src/part2/heartbeat_manager.h"
 #include "nebd/src/part2/request_executor_curve.h"
+#include "nebd/src/part2/shm_ring_server.h"
 
 namespace nebd {
 namespace server {
@@ -109,6 +110,8 @@ class NebdServer {
     std::shared_ptr<NebdFileManager> fileManager_;
     // 负责文件心跳超时处理
     std::shared_ptr<HeartbeatManager> heartbeatManager_;
+    // 处理part1通过共享内存下发的请求
+    std::shared_ptr<NebdShmRingServer> shmRingServer_;
     // curveclient
     std::shared_ptr<CurveClient> curveClient_;
 };
@@ -0,0 +1,251 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: nebd
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "nebd/src/part2/shm_ring_server.h"
+
+#include <brpc/closure_guard.h>
+#include <butil/iobuf.h>
+#include <glog/logging.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <new>
+#include <utility>
+
+#include "nebd/src/part2/util.h"
+
+namespace nebd {
+namespace server {
+
+using nebd::common::ShmOp;
+using nebd::common::ShmRing;
+using nebd::common::ShmSlot;
+using nebd::common::ShmStatus;
+
+namespace {
+
+// 睡眠前忙等的时间
+constexpr uint32_t kPollSpinUs = 50;
+// 等待请求的超时时间，part2至少以这个频率更新心跳
+constexpr uint32_t kWaitSubmissionTimeoutMs = 100;
+// 检查part1进程是否存在的周期
+constexpr uint64_t kOwnerCheckIntervalMs = 1000;
+
+void TrivialDeleter(void*) {}
+
+}  // namespace
+
+int NebdShmRingServer::Register(const std::string& name, pid_t pid) {
+    std::unique_ptr<ShmRing> ring = ShmRing::Attach(name);
+    if (ring == nullptr) {
+        LOG(ERROR) << "Attach shm ring failed, name: " << name
+                   << ", pid: " << pid;
+        return -1;
+    }
+
+    if (ring->OwnerPid() != pid) {
+        LOG(ERROR) << "Shm ring owner mismatch, name: " << name
+                   << ", pid: " << pid << ", owner: " << ring->OwnerPid();
+        return -1;
+    }
+
+    // part1确认注册成功之前就可能检查心跳
+    ring->UpdateServerHeartbeat();
+
+    std::unique_ptr<ShmRingChannel> channel(new ShmRingChannel());
+    channel->ring = std::move(ring);
+    channel->pid = pid;
+
+    std::lock_guard<std::mutex> lk(mtx_);
+    ReapChannels();
+    // part1重建了共享内存，之前的不会再有新请求
+    for (auto& c : channels_) {
+        if (c->pid == pid) {
+            c->running = false;
+        }
+    }
+
+    channel->thread = std::thread(&NebdShmRingServer::PollThreadFunc, this,
+                                  channel.get());
+    channels_.emplace_back(std::move(channel));
+
+    LOG(INFO) << "Register shm ring success, name: " << name
+              << ", pid: " << pid;
+    return 0;
+}
+
+void NebdShmRingServer::Fini() {
+    std::lock_guard<std::mutex> lk(mtx_);
+    for (auto& c : channels_) {
+        c->running = false;
+    }
+    for (auto& c : channels_) {
+        c->thread.join();
+    }
+    channels_.clear();
+}
+
+void NebdShmRingServer::ReapChannels() {
+    for (auto it = channels_.begin(); it != channels_.end();) {
+        if ((*it)->exited) {
+            (*it)->thread.join();
+            it = channels_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void NebdShmRingServer::PollThreadFunc(ShmRingChannel* channel) {
+    ShmRing* ring = channel->ring.get();
+    uint64_t lastCheckMs = ShmRing::NowMs();
+
+    while (channel->running) {
+        ring->UpdateServerHeartbeat();
+
+        uint32_t index;
+        while (ring->PollSubmission(&index)) {
+            Dispatch(channel, index);
+        }
+
+        uint64_t now = ShmRing::NowMs();
+        if (now - lastCheckMs >= kOwnerCheckIntervalMs) {
+            lastCheckMs = now;
+            if (kill(channel->pid, 0) != 0 && errno == ESRCH) {
+                LOG(INFO) << "Shm ring owner exited, name: " << ring->Name()
+                          << ", pid: " << channel->pid;
+                break;
+            }
+        }
+
+        ring->WaitSubmission(kPollSpinUs, kWaitSubmissionTimeoutMs);
+    }
+
+    // 等已经下发的请求返回之后才能释放共享内存
+    while (channel->inflight.load() != 0) {
+        usleep(1000);
+    }
+    channel->exited = true;
+}
+
+void NebdShmRingServer::Dispatch(ShmRingChannel* channel, uint32_t index) {
+    ShmRing* ring = channel->ring.get();
+    // slot在part1可写的共享内存中，只读取一次到本地，之后的检查和使用都基于
+    // 本地的拷贝，避免检查之后被part1修改
+    const volatile ShmSlot* shared = ring->GetSlot(index);
+    ShmSlot slot;
+    slot.op = shared->op;
+    slot.fd = shared->fd;
+    slot.offset = shared->offset;
+    slot.length = shared->length;
+
+    ShmOp op = static_cast<ShmOp>(slot.op);
+    if ((op != ShmOp::kRead && op != ShmOp::kWrite) ||
+        slot.length > ring->BufSize()) {
+        LOG(ERROR) << "Invalid shm ring request, name: " << ring->Name()
+                   << ", op: " << slot.op << ", length: " << slot.length;
+        CompleteRequest(channel, index, ShmStatus::kError);
+        return;
+    }
+
+    ShmAioContext* aioContext = new (std::nothrow) ShmAioContext();
+    if (aioContext == nullptr) {
+        LOG(ERROR) << "Allocate aio context failed, name: " << ring->Name()
+                   << ", index: " << index;
+        CompleteRequest(channel, index, ShmStatus::kError);
+        return;
+    }
+    aioContext->offset = slot.offset;
+    aioContext->size = slot.length;
+    aioContext->op = op == ShmOp::kRead ? LIBAIO_OP::LIBAIO_OP_READ
+                                        : LIBAIO_OP::LIBAIO_OP_WRITE;
+    aioContext->cb = &NebdShmRingServer::ShmRingCallback;
+    aioContext->returnRpcWhenIoError = returnRpcWhenIoError_;
+    aioContext->channel = channel;
+    aioContext->index = index;
+
+    // 写请求直接引用共享内存中的数据，请求返回之前part1不会复用这个slot
+    std::unique_ptr<butil::IOBuf> buf(new butil::IOBuf());
+    if (op == ShmOp::kWrite) {
+        buf->append_user_data(ring->GetBuffer(index), slot.length,
+                              TrivialDeleter);
+    }
+    aioContext->buf = buf.get();
+
+    channel->inflight.fetch_add(1);
+    int rc = op == ShmOp::kRead
+                 ? fileManager_->AioRead(slot.fd, aioContext)
+                 : fileManager_->AioWrite(slot.fd, aioContext);
+    if (rc < 0) {
+        LOG(ERROR) << Op2Str(aioContext->op) << " file failed. "
+                   << "fd: " << slot.fd
+                   << ", offset: " << slot.offset
+                   << ", size: " << slot.length
+                   << ", return code: " << rc;
+        delete aioContext;
+        CompleteRequest(channel, index, ShmStatus::kError);
+        channel->inflight.fetch_sub(1);
+    } else {
+        buf.release();
+    }
+}
+
+void NebdShmRingServer::ShmRingCallback(NebdServerAioContext* context) {
+    CHECK(context != nullptr);
+    ShmAioContext* shmContext = static_cast<ShmAioContext*>(context);
+    ShmRingChannel* channel = shmContext->channel;
+    uint32_t index = shmContext->index;
+
+    {
+        std::unique_ptr<ShmAioContext> contextGuard(shmContext);
+        std::unique_ptr<butil::IOBuf> iobufGuard(
+            reinterpret_cast<butil::IOBuf*>(context->buf));
+        // 释放file entity的读锁
+        brpc::ClosureGuard doneGuard(context->done);
+
+        ShmStatus status = ShmStatus::kOK;
+        if (context->ret < 0) {
+            LOG(ERROR) << *context;
+            // 和rpc一样，不返回io错误时由part1重新下发
+            status = context->returnRpcWhenIoError ? ShmStatus::kError
+                                                   : ShmStatus::kRetry;
+        } else if (context->op == LIBAIO_OP::LIBAIO_OP_READ) {
+            iobufGuard->copy_to(channel->ring->GetBuffer(index),
+                                context->size);
+        }
+        CompleteRequest(channel, index, status);
+    }
+
+    // 最后再减少计数，之后channel可能被释放
+    channel->inflight.fetch_sub(1);
+}
+
+void NebdShmRingServer::CompleteRequest(ShmRingChannel* channel,
+                                        uint32_t index, ShmStatus status) {
+    channel->ring->GetSlot(index)->status = static_cast<int32_t>(status);
+    std::lock_guard<std::mutex> lk(channel->completeMtx);
+    channel->ring->Complete(index);
+}
+
+}  // namespace server
+}  // namespace nebd
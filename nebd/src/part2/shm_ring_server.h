@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: nebd
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef NEBD_SRC_PART2_SHM_RING_SERVER_H_
+#define NEBD_SRC_PART2_SHM_RING_SERVER_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+
+#include "nebd/src/common/shm_ring.h"
+#include "nebd/src/part2/file_manager.h"
+
+namespace nebd {
+namespace server {
+
+// 一个part1进程注册的共享内存，由单独的线程处理其中的请求
+struct ShmRingChannel {
+    std::unique_ptr<nebd::common::ShmRing> ring;
+    // 创建共享内存的part1进程
+    pid_t pid = 0;
+    std::atomic<bool> running{true};
+    // 线程退出并且请求都已经返回，可以释放
+    std::atomic<bool> exited{false};
+    // 已经下发到file manager还未返回的请求数
+    std::atomic<uint32_t> inflight{0};
+    // 完成队列是单生产者的，回调可能在多个线程中执行
+    std::mutex completeMtx;
+    std::thread thread;
+};
+
+// 通过共享内存下发的请求的上下文
+struct ShmAioContext : public NebdServerAioContext {
+    ShmRingChannel* channel = nullptr;
+    uint32_t index = 0;
+};
+
+/**
+ * 处理part1通过共享内存下发的读写请求
+ * part1通过RegisterShmRing rpc注册共享内存后，启动一个线程轮询提交队列，
+ * 把请求转换成NebdServerAioContext交给NebdFileManager，请求返回后在回调
+ * 中写入结果并放入完成队列。
+ * 写请求直接引用共享内存中的数据，读请求的数据在回调中拷贝到共享内存。
+ */
+class NebdShmRingServer {
+ public:
+    NebdShmRingServer(std::shared_ptr<NebdFileManager> fileManager,
+                      bool returnRpcWhenIoError)
+        : fileManager_(fileManager),
+          returnRpcWhenIoError_(returnRpcWhenIoError) {}
+
+    ~NebdShmRingServer() {
+        Fini();
+    }
+
+    /**
+     * @brief attach part1创建的共享内存并开始处理其中的请求
+     *        同一个进程之前注册的共享内存不再处理
+     * @param name: 共享内存的名字
+     * @param pid: part1的进程号
+     * @return 成功返回0，失败返回-1
+     */
+    int Register(const std::string& name, pid_t pid);
+
+    /**
+     * @brief 停止所有线程，等待已经下发的请求返回
+     */
+    void Fini();
+
+ private:
+    void PollThreadFunc(ShmRingChannel* channel);
+
+    void Dispatch(ShmRingChannel* channel, uint32_t index);
+
+    /**
+     * @brief 回收已经退出的channel
+     */
+    void ReapChannels();
+
+    static void ShmRingCallback(NebdServerAioContext* context);
+
+    static void CompleteRequest(ShmRingChannel* channel, uint32_t index,
+                                nebd::common::ShmStatus status);
+
+ private:
+    std::shared_ptr<NebdFileManager> fileManager_;
+    bool returnRpcWhenIoError_;
+
+    std::mutex mtx_;
+    std::list<std::unique_ptr<ShmRingChannel>> channels_;
+};
+
+}  // namespace server
+}  // namespace nebd
+
+#endif  // NEBD_SRC_PART2_SHM_RING_SERVER_H_
@@ -0,0 +1,230 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: nebd
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+#include "nebd/src/common/shm_ring.h"
+
+namespace nebd {
+namespace common {
+
+namespace {
+
+std::string RingName(const std::string& suffix) {
+    return "/nebd-shm-test-" + std::to_string(getpid()) + "-" + suffix;
+}
+
+}  // namespace
+
+TEST(ShmRingTest, CreateAndAttach) {
+    std::string name = RingName("attach");
+    ASSERT_EQ(nullptr, ShmRing::Create(name, 3, 4096));
+    ASSERT_EQ(nullptr, ShmRing::Create(name, 4, 0));
+    ASSERT_EQ(nullptr, ShmRing::Attach(name));
+
+    auto ring = ShmRing::Create(name, 4, 4096);
+    ASSERT_NE(nullptr, ring);
+    // 同名的共享内存不能重复创建
+    ASSERT_EQ(nullptr, ShmRing::Create(name, 4, 4096));
+
+    auto peer = ShmRing::Attach(name);
+    ASSERT_NE(nullptr, peer);
+    ASSERT_EQ(4, peer->SlotNum());
+    ASSERT_EQ(4096, peer->BufSize());
+    ASSERT_EQ(getpid(), peer->OwnerPid());
+
+    // 数据buffer按页对齐，两边看到的是同一块内存
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(ring->GetBuffer(0)) % 4096);
+    memset(ring->GetBuffer(3), 'x', 4096);
+    ASSERT_EQ('x', peer->GetBuffer(3)[4095]);
+
+    ring->Unlink();
+    ASSERT_EQ(nullptr, ShmRing::Attach(name));
+    // unlink之后已经map的进程仍然可以使用
+    peer->UpdateServerHeartbeat();
+    ASSERT_NE(0, ring->GetServerHeartbeatMs());
+}
+
+TEST(ShmRingTest, AttachIgnoresHeaderChange) {
+    std::string name = RingName("header");
+    auto ring = ShmRing::Create(name, 4, 4096);
+    ASSERT_NE(nullptr, ring);
+    auto peer = ShmRing::Attach(name);
+    ASSERT_NE(nullptr, peer);
+
+    // 模拟part1在attach之后修改header中的slotNum和bufSize，
+    // 偏移与ShmRingHeader的布局一致
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    ASSERT_LE(0, fd);
+    void* addr = mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, 0);
+    close(fd);
+    ASSERT_NE(MAP_FAILED, addr);
+    uint32_t* slotNum = reinterpret_cast<uint32_t*>(
+        static_cast<char*>(addr) + 12);
+    uint32_t* bufSize = reinterpret_cast<uint32_t*>(
+        static_cast<char*>(addr) + 16);
+    ASSERT_EQ(4, *slotNum);
+    ASSERT_EQ(4096, *bufSize);
+    *slotNum = 1 << 20;
+    *bufSize = 1 << 30;
+
+    // 已经attach的一方继续使用attach时的值
+    ASSERT_EQ(4, peer->SlotNum());
+    ASSERT_EQ(4096, peer->BufSize());
+    ASSERT_EQ(peer->GetBuffer(0) + 3 * 4096, peer->GetBuffer(3));
+
+    // 超出共享内存大小的header不能attach
+    ASSERT_EQ(nullptr, ShmRing::Attach(name));
+    *slotNum = 3;
+    *bufSize = 4096;
+    ASSERT_EQ(nullptr, ShmRing::Attach(name));
+
+    munmap(addr, 4096);
+    ring->Unlink();
+}
+
+TEST(ShmRingTest, SubmitAndComplete) {
+    std::string name = RingName("queue");
+    auto ring = ShmRing::Create(name, 8, 4096);
+    ASSERT_NE(nullptr, ring);
+    auto peer = ShmRing::Attach(name);
+    ASSERT_NE(nullptr, peer);
+    ring->Unlink();
+
+    uint32_t index = 0;
+    ASSERT_FALSE(peer->PollSubmission(&index));
+    ASSERT_FALSE(ring->PollCompletion(&index));
+
+    // 多轮提交，覆盖队列下标回绕
+    for (int round = 0; round < 10; ++round) {
+        for (uint32_t i = 0; i < 8; ++i) {
+            ShmSlot* slot = ring->GetSlot(i);
+            slot->op = static_cast<uint32_t>(ShmOp::kWrite);
+            slot->offset = round * 8 + i;
+            ring->Submit(i);
+        }
+        for (uint32_t i = 0; i < 8; ++i) {
+            ASSERT_TRUE(peer->PollSubmission(&index));
+            ASSERT_EQ(i, index);
+            ASSERT_EQ(round * 8 + i, peer->GetSlot(index)->offset);
+            peer->GetSlot(index)->status =
+                static_cast<int32_t>(ShmStatus::kOK);
+            peer->Complete(index);
+        }
+        ASSERT_FALSE(peer->PollSubmission(&index));
+        for (uint32_t i = 0; i < 8; ++i) {
+            ASSERT_TRUE(ring->PollCompletion(&index));
+            ASSERT_EQ(i, index);
+        }
+        ASSERT_FALSE(ring->PollCompletion(&index));
+    }
+}
+
+TEST(ShmRingTest, WaitTimeout) {
+    std::string name = RingName("timeout");
+    auto ring = ShmRing::Create(name, 4, 4096);
+    ASSERT_NE(nullptr, ring);
+    ring->Unlink();
+
+    uint64_t start = ShmRing::NowMs();
+    ring->WaitCompletion(10, 50);
+    ASSERT_GE(ShmRing::NowMs() - start, 40);
+}
+
+TEST(ShmRingTest, CrossProcessRoundTrip) {
+    const uint32_t kSlotNum = 16;
+    const int kRequestNum = 10000;
+    std::string name = RingName("process");
+    auto ring = ShmRing::Create(name, kSlotNum, 4096);
+    ASSERT_NE(nullptr, ring);
+
+    pid_t pid = fork();
+    ASSERT_LE(0, pid);
+    if (pid == 0) {
+        // 子进程模拟part2，把写入的数据加1后返回
+        auto server = ShmRing::Attach(name);
+        if (server == nullptr) {
+            _exit(1);
+        }
+        int handled = 0;
+        while (handled < kRequestNum) {
+            uint32_t index;
+            if (!server->PollSubmission(&index)) {
+                // 不忙等，保证走到futex的睡眠和唤醒
+                server->WaitSubmission(0, 1000);
+                continue;
+            }
+            uint64_t* data =
+                reinterpret_cast<uint64_t*>(server->GetBuffer(index));
+            *data += 1;
+            server->GetSlot(index)->status =
+                static_cast<int32_t>(ShmStatus::kOK);
+            server->Complete(index);
+            ++handled;
+        }
+        _exit(0);
+    }
+
+    uint32_t free = kSlotNum;
+    int submitted = 0;
+    int completed = 0;
+    while (completed < kRequestNum) {
+        while (free > 0 && submitted < kRequestNum) {
+            uint32_t index = submitted % kSlotNum;
+            *reinterpret_cast<uint64_t*>(ring->GetBuffer(index)) = submitted;
+            ring->GetSlot(index)->offset = submitted;
+            ring->Submit(index);
+            ++submitted;
+            --free;
+        }
+
+        uint32_t index;
+        if (!ring->PollCompletion(&index)) {
+            ASSERT_EQ(0, waitpid(pid, nullptr, WNOHANG));
+            ring->WaitCompletion(0, 1000);
+            continue;
+        }
+        ShmSlot* slot = ring->GetSlot(index);
+        ASSERT_EQ(static_cast<int32_t>(ShmStatus::kOK), slot->status);
+        ASSERT_EQ(slot->offset + 1,
+                  *reinterpret_cast<uint64_t*>(ring->GetBuffer(index)));
+        ++completed;
+        ++free;
+    }
+
+    ring->Unlink();
+    int status = 0;
+    ASSERT_EQ(pid, waitpid(pid, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status));
+    ASSERT_EQ(0, WEXITSTATUS(status));
+}
+
+}  // namespace common
+}  // namespace nebd
@@ -51,6 +51,10 @@ using ::curve::fs::FileSystemType;
 using ::curve::chunkserver::concurrent::ConcurrentApplyModule;
 using ::curve::common::UriParser;
 
+namespace braft {
+DECLARE_bool(raft_enable_leader_lease);
+}  // namespace braft
+
 DEFINE_string(conf, "ChunkServer.conf", "Path of configuration file");
 DEFINE_string(chunkServerIp, "127.0.0.1", "chunkserver ip");
 DEFINE_bool(enableExternalServer, false, "start external server or not");
@@ -128,11 +132,30 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to initialize concurrentapply module!";
 
     // 初始化本地文件系统
-    std::shared_ptr<LocalFileSystem> fs(
-        LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));
+    bool enableIOUring = false;
+    LOG_IF(WARNING, !conf.GetBoolValue("fs.enable_io_uring", &enableIOUring))
+        << "config no fs.enable_io_uring info, use default: false";
+    std::shared_ptr<LocalFileSystem> fs(LocalFsFactory::CreateFs(
+        enableIOUring ? FileSystemType::IO_URING : FileSystemType::EXT4, ""));
     LocalFileSystemOption lfsOption;
     LOG_IF(FATAL, !conf.GetBoolValue(
         "fs.enable_renameat2", &lfsOption.enableRenameat2));
+    if (enableIOUring) {
+        LOG_IF(WARNING, !conf.GetUInt32Value("fs.io_uring_queue_depth",
+                                             &lfsOption.ioUringQueueDepth))
+            << "config no fs.io_uring_queue_depth info, use default: "
+            << lfsOption.ioUringQueueDepth;
+        LOG_IF(WARNING, !conf.GetUInt32Value(
+            "fs.io_uring_fixed_buffer_count",
+            &lfsOption.ioUringFixedBufferCount))
+            << "config no fs.io_uring_fixed_buffer_count info, use default: "
+            << lfsOption.ioUringFixedBufferCount;
+        LOG_IF(WARNING, !conf.GetUInt32Value(
+            "fs.io_uring_fixed_buffer_size",
+            &lfsOption.ioUringFixedBufferSize))
+            << "config no fs.io_uring_fixed_buffer_size info, use default: "
+            << lfsOption.ioUringFixedBufferSize;
+    }
     LOG_IF(FATAL, 0 != fs->Init(lfsOption))
         << "Failed to initialize local filesystem module!";
 
@@ -210,6 +233,21 @@ int ChunkServer::Run(int argc, char** argv) {
             << "Failed to register to MDS.";
     }
 
+    // 初始化按盘合并sync的调度器
+    bool enableSyncScheduler = false;
+    LOG_IF(WARNING, !conf.GetBoolValue("syncscheduler.enable",
+                                       &enableSyncScheduler))
+        << "config no syncscheduler.enable info, use default: false";
+    if (enableSyncScheduler) {
+        SyncSchedulerOptions syncSchedulerOptions;
+        InitSyncSchedulerOptions(&conf, &syncSchedulerOptions);
+        syncSchedulerOptions.syncfsPath =
+            UriParser::GetPathFromUri(registerOptions.chunserverStoreUri);
+        LOG_IF(FATAL, SyncScheduler::GetInstance().Init(
+            syncSchedulerOptions) != 0)
+            << "Failed to init sync scheduler.";
+    }
+
     // trash模块初始化
     TrashOptions trashOptions;
     InitTrashOptions(&conf, &trashOptions);
@@ -437,6 +475,7 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to shutdown heartbeat manager.";
     LOG_IF(ERROR, copysetNodeManager_->Fini() != 0)
         << "Failed to shutdown CopysetNodeManager.";
+    SyncScheduler::GetInstance().Fini();
     LOG_IF(ERROR, cloneManager_.Fini() != 0)
         << "Failed to shutdown clone manager.";
     LOG_IF(ERROR, copyer->Fini() != 0)
@@ -511,6 +550,26 @@ void ChunkServer::InitConcurrentApplyOptions(common::Configuration *conf,
         "wconcurrentapply.queuedepth", &concurrentApplyOptions->wqueuedepth));
 }
 
+void ChunkServer::InitSyncSchedulerOptions(
+    common::Configuration *conf, SyncSchedulerOptions *syncSchedulerOptions) {
+    LOG_IF(WARNING, !conf->GetUInt32Value("syncscheduler.max_batch_size",
+        &syncSchedulerOptions->maxBatchSize))
+        << "config no syncscheduler.max_batch_size info, use default: "
+        << syncSchedulerOptions->maxBatchSize;
+    LOG_IF(WARNING, !conf->GetUInt32Value("syncscheduler.max_delay_us",
+        &syncSchedulerOptions->maxDelayUs))
+        << "config no syncscheduler.max_delay_us info, use default: "
+        << syncSchedulerOptions->maxDelayUs;
+    LOG_IF(WARNING, !conf->GetUInt32Value("syncscheduler.syncfs_threshold",
+        &syncSchedulerOptions->syncfsThreshold))
+        << "config no syncscheduler.syncfs_threshold info, use default: "
+        << syncSchedulerOptions->syncfsThreshold;
+    LOG_IF(WARNING, !conf->GetUInt32Value("syncscheduler.sync_concurrency",
+        &syncSchedulerOptions->syncConcurrency))
+        << "config no syncscheduler.sync_concurrency info, use default: "
+        << syncSchedulerOptions->syncConcurrency;
+}
+
 void ChunkServer::InitWalFilePoolOptions(
     common::Configuration *conf, FilePoolOptions *walPoolOptions) {
     LOG_IF(FATAL, !conf->GetUInt32Value("walfilepool.segment_size",
@@ -589,6 +648,52 @@ void ChunkServer::InitCopysetNodeOptions(
         LOG_IF(FATAL, !conf->GetUInt32Value("copyset.check_syncing_interval_ms",
             &copysetNodeOptions->checkSyncingIntervalMs));
     }
+
+    LOG_IF(WARNING, !conf->GetBoolValue("copyset.enable_lease_read",
+        &copysetNodeOptions->enableLeaseRead))
+        << "config no copyset.enable_lease_read, use default: "
+        << copysetNodeOptions->enableLeaseRead;
+    LOG_IF(WARNING, !conf->GetBoolValue("copyset.enable_follower_read",
+        &copysetNodeOptions->enableFollowerRead))
+        << "config no copyset.enable_follower_read, use default: "
+        << copysetNodeOptions->enableFollowerRead;
+    LOG_IF(WARNING, !conf->GetUInt32Value("copyset.follower_read_wait_ms",
+        &copysetNodeOptions->followerReadWaitMs))
+        << "config no copyset.follower_read_wait_ms, use default: "
+        << copysetNodeOptions->followerReadWaitMs;
+    LOG_IF(WARNING, !conf->GetBoolValue("copyset.enable_page_crc",
+        &copysetNodeOptions->enablePageCrc))
+        << "config no copyset.enable_page_crc, use default: "
+        << copysetNodeOptions->enablePageCrc;
+    LOG_IF(WARNING, !conf->GetBoolValue("copyset.verify_page_crc_on_read",
+        &copysetNodeOptions->verifyPageCrcOnRead))
+        << "config no copyset.verify_page_crc_on_read, use default: "
+        << copysetNodeOptions->verifyPageCrcOnRead;
+    LOG_IF(WARNING, !conf->GetBoolValue("copyset.enable_deferred_write",
+        &copysetNodeOptions->enableDeferredWrite))
+        << "config no copyset.enable_deferred_write, use default: "
+        << copysetNodeOptions->enableDeferredWrite;
+    LOG_IF(WARNING, !conf->GetUInt32Value("copyset.deferred_write_min_size",
+        &copysetNodeOptions->deferredWriteMinSize))
+        << "config no copyset.deferred_write_min_size, use default: "
+        << copysetNodeOptions->deferredWriteMinSize;
+    LOG_IF(WARNING, !conf->GetUInt64Value("copyset.deferred_write_max_bytes",
+        &copysetNodeOptions->deferredWriteMaxBytes))
+        << "config no copyset.deferred_write_max_bytes, use default: "
+        << copysetNodeOptions->deferredWriteMaxBytes;
+    // deferred writes read the data back from the curve raft log storage
+    if (copysetNodeOptions->enableDeferredWrite &&
+        UriParser::GetProtocolFromUri(copysetNodeOptions->logUri)
+            != kProtocalCurve) {
+        LOG(WARNING) << "deferred write needs curve raft log storage, "
+                     << "disable it, raft log uri: "
+                     << copysetNodeOptions->logUri;
+        copysetNodeOptions->enableDeferredWrite = false;
+    }
+    // lease read depends on braft leader lease
+    if (copysetNodeOptions->enableLeaseRead) {
+        braft::FLAGS_raft_enable_leader_lease = true;
+    }
 }
 
 void ChunkServer::InitCopyerOptions(
@@ -609,6 +714,14 @@ void ChunkServer::InitCopyerOptions(
         &disableS3Adapter));
     LOG_IF(FATAL, !conf->GetUInt64Value("curve.curve_file_timeout_s",
         &copyerOptions->curveFileTimeoutSec));
+    LOG_IF(WARNING, !conf->GetUInt32Value("clone.origin_fetch_unit",
+        &copyerOptions->fetchUnit))
+        << "config no clone.origin_fetch_unit, use default: "
+        << copyerOptions->fetchUnit;
+    LOG_IF(WARNING, !conf->GetUInt64Value("clone.origin_cache_bytes",
+        &copyerOptions->cacheBytes))
+        << "config no clone.origin_cache_bytes, use default: "
+        << copyerOptions->cacheBytes;
 
     if (disableCurveClient) {
         copyerOptions->curveClient = nullptr;
@@ -660,6 +773,10 @@ void ChunkServer::InitHeartbeatOptions(
         &heartbeatOptions->intervalSec));
     LOG_IF(FATAL, !conf->GetUInt32Value("mds.heartbeat_timeout",
         &heartbeatOptions->timeout));
+    LOG_IF(WARNING, !conf->GetUInt32Value("mds.full_heartbeat_interval",
+        &heartbeatOptions->fullIntervalSec))
+        << "config no mds.full_heartbeat_interval info, use default: "
+        << heartbeatOptions->fullIntervalSec;
 }
 
 void ChunkServer::InitRegisterOptions(
@@ -35,6 +35,7 @@
 #include "src/chunkserver/chunkserver_metrics.h"
 #include "src/chunkserver/concurrent_apply/concurrent_apply.h"
 #include "src/chunkserver/scan_service.h"
+#include "src/chunkserver/datastore/sync_scheduler.h"
 
 using ::curve::chunkserver::concurrent::ConcurrentApplyOption;
 
@@ -67,6 +68,9 @@ class ChunkServer {
     void InitConcurrentApplyOptions(common::Configuration *conf,
         ConcurrentApplyOption *concurrentApplyOption);
 
+    void InitSyncSchedulerOptions(common::Configuration *conf,
+        SyncSchedulerOptions *syncSchedulerOptions);
+
     void InitCopysetNodeOptions(common::Configuration *conf,
         CopysetNodeOptions *copysetNodeOptions);
 
@@ -225,6 +225,9 @@ void CSCopysetMetric::MonitorCurveSegmentLogStorage(
 ChunkServerMetric::ChunkServerMetric()
     : hasInited_(false)
     , leaderCount_(nullptr)
+    , leaseReadCount_(nullptr)
+    , followerReadCount_(nullptr)
+    , raftReadCount_(nullptr)
     , chunkLeft_(nullptr)
     , walSegmentLeft_(nullptr)
     , chunkTrashed_(nullptr)
@@ -268,6 +271,13 @@ int ChunkServerMetric::Init(const ChunkServerMetricOptions& option) {
     std::string leaderCountPrefix = Prefix() + "_leader_count";
     leaderCount_ = std::make_shared<bvar::Adder<uint32_t>>(leaderCountPrefix);
 
+    leaseReadCount_ = std::make_shared<bvar::Adder<uint64_t>>(
+        Prefix() + "_lease_read_count");
+    followerReadCount_ = std::make_shared<bvar::Adder<uint64_t>>(
+        Prefix() + "_follower_read_count");
+    raftReadCount_ = std::make_shared<bvar::Adder<uint64_t>>(
+        Prefix() + "_raft_read_count");
+
     std::string chunkCountPrefix = Prefix() + "_chunk_count";
     chunkCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         chunkCountPrefix, GetTotalChunkCountFunc, this);
@@ -293,6 +303,9 @@ int ChunkServerMetric::Fini() {
     // 释放资源，从而将暴露的metric从全局的map中移除
     ioMetrics_.Fini();
     leaderCount_ = nullptr;
+    leaseReadCount_ = nullptr;
+    followerReadCount_ = nullptr;
+    raftReadCount_ = nullptr;
     chunkLeft_ = nullptr;
     walSegmentLeft_ = nullptr;
     chunkTrashed_ = nullptr;
@@ -430,6 +443,30 @@ void ChunkServerMetric::DecreaseLeaderCount() {
     *leaderCount_ << -1;
 }
 
+void ChunkServerMetric::IncreaseLeaseReadCount() {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    *leaseReadCount_ << 1;
+}
+
+void ChunkServerMetric::IncreaseFollowerReadCount() {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    *followerReadCount_ << 1;
+}
+
+void ChunkServerMetric::IncreaseRaftReadCount() {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    *raftReadCount_ << 1;
+}
+
 void ChunkServerMetric::ExposeConfigMetric(common::Configuration* conf) {
     if (!option_.collectMetric) {
         return;
@@ -466,6 +466,21 @@ class ChunkServerMetric : public Uncopyable {
      */
     void DecreaseLeaderCount();
 
+    /**
+     * 增加leader通过lease直接读的计数
+     */
+    void IncreaseLeaseReadCount();
+
+    /**
+     * 增加follower直接读的计数
+     */
+    void IncreaseFollowerReadCount();
+
+    /**
+     * 增加通过raft propose读的计数
+     */
+    void IncreaseRaftReadCount();
+
     /**
      * 更新配置项数据
      * @param conf: 配置内容
@@ -551,6 +566,12 @@ class ChunkServerMetric : public Uncopyable {
     ChunkServerMetricOptions option_;
     // leader 的数量
     AdderPtr<uint32_t> leaderCount_;
+    // leader lease有效时不走raft的读请求数量
+    AdderPtr<uint64_t> leaseReadCount_;
+    // follower处理的读请求数量
+    AdderPtr<uint64_t> followerReadCount_;
+    // 通过raft propose的读请求数量
+    AdderPtr<uint64_t> raftReadCount_;
     // chunkfilepool  中剩余的 chunk 的数量
     PassiveStatusPtr<uint32_t> chunkLeft_;
     // walfilepool  中剩余的 wal segment 的数量
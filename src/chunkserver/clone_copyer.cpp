@@ -20,6 +20,9 @@
  * Author: yangyaokai
  */
 
+#include <atomic>
+#include <vector>
+
 #include "src/chunkserver/clone_copyer.h"
 #include "src/chunkserver/clone_core.h"
 #include "src/common/timeutility.h"
@@ -35,8 +38,70 @@ std::ostream& operator<<(std::ostream& out, const AsyncDownloadContext& rhs) {
     return out;
 }
 
-struct CurveAioCombineContext {
+OriginFetchMetric::OriginFetchMetric(const std::string& prefix)
+    : requestBytes(prefix, "request_bytes"),
+      fetchBytes(prefix, "fetch_bytes"),
+      fetchCount(prefix, "fetch_count"),
+      cacheHitBytes(prefix, "cache_hit_bytes"),
+      mergedCount(prefix, "merged_count"),
+      amplification(prefix, "amplification", GetAmplification, this) {}
+
+double OriginFetchMetric::GetAmplification(void* arg) {
+    OriginFetchMetric* metric = static_cast<OriginFetchMetric*>(arg);
+    uint64_t request = metric->requestBytes.get_value();
+    if (request == 0) {
+        return 0;
+    }
+    return static_cast<double>(metric->fetchBytes.get_value()) / request;
+}
+
+// 用户的一次下载请求，可能跨越多个读取单位
+struct OriginRead {
+    off_t offset;
+    size_t size;
+    char* buf;
     DownloadClosure* done;
+    // 尚未完成的读取单位个数
+    std::atomic<uint32_t> pending;
+    std::atomic<bool> failed;
+
+    void Finish(bool success) {
+        if (!success) {
+            failed = true;
+        }
+        if (pending.fetch_sub(1) == 1) {
+            brpc::ClosureGuard doneGuard(done);
+            if (failed) {
+                done->SetFailed();
+            }
+        }
+    }
+};
+
+// 对齐到读取单位的一次源端下载，完成前到达的相同单位的请求都等待该下载
+struct OriginFetch {
+    OriginType type;
+    // s3的对象名或者curve的文件名
+    std::string path;
+    std::string key;
+    off_t offset;
+    std::shared_ptr<std::string> data;
+    std::vector<std::shared_ptr<OriginRead>> waiters;
+};
+
+namespace {
+
+std::string OriginExtentKey(OriginType type, const string& path,
+                            uint64_t unitIndex) {
+    return (type == OriginType::CurveOrigin ? "cs:" : "s3:") + path + ":" +
+           std::to_string(unitIndex);
+}
+
+}  // namespace
+
+struct CurveAioCombineContext {
+    // 使用指针保持结构体为standard-layout，以便使用offsetof
+    OriginReadCallback* cb;
     CurveAioContext curveCtx;
 };
 
@@ -44,13 +109,11 @@ void CurveAioCallback(struct CurveAioContext* context) {
     auto curveCombineCtx = reinterpret_cast<CurveAioCombineContext *>(
         reinterpret_cast<char *>(context) -
         offsetof(CurveAioCombineContext, curveCtx));
-    DownloadClosure* done = curveCombineCtx->done;
-    if (context->ret < 0) {
-        done->SetFailed();
-    }
+    std::unique_ptr<OriginReadCallback> cb(curveCombineCtx->cb);
+    bool success = context->ret >= 0;
     delete curveCombineCtx;
 
-    brpc::ClosureGuard doneGuard(done);
+    (*cb)(success);
 }
 
 void OriginCopyer::DeleteExpiredCurveCache(void* arg) {
@@ -84,10 +147,28 @@ void OriginCopyer::DeleteExpiredCurveCache(void* arg) {
 
 OriginCopyer::OriginCopyer()
     : curveClient_(nullptr)
-    , s3Client_(nullptr) {}
+    , s3Client_(nullptr)
+    , fetchUnit_(0) {}
 
 int OriginCopyer::Init(const CopyerOptions& options) {
     curveFileTimeoutSec_ = options.curveFileTimeoutSec;
+    fetchUnit_ = options.fetchUnit;
+    if (fetchUnit_ != 0 && (fetchUnit_ & (fetchUnit_ - 1)) != 0) {
+        LOG(WARNING) << "Fetch unit " << fetchUnit_
+                     << " is not power of 2, disable aligned fetch.";
+        fetchUnit_ = 0;
+    }
+    if (fetchUnit_ != 0) {
+        metric_.reset(new OriginFetchMetric("chunkserver_clone_origin"));
+        if (options.cacheBytes >= fetchUnit_) {
+            cache_.reset(new OriginExtentCache(
+                options.cacheBytes / fetchUnit_,
+                std::make_shared<CacheMetrics>(
+                    "chunkserver_clone_origin_cache")));
+        }
+        LOG(INFO) << "Origin fetch unit: " << fetchUnit_
+                  << ", cache bytes: " << options.cacheBytes;
+    }
     curveClient_ = options.curveClient;
     s3Client_ = options.s3Client;
     if (curveClient_ != nullptr) {
@@ -143,6 +224,12 @@ void OriginCopyer::DownloadAsync(DownloadClosure* done) {
     std::string originPath;
     OriginType type =
         LocationOperator::ParseLocation(context->location, &originPath);
+    OriginReadCallback cb = [done](bool success) {
+        brpc::ClosureGuard doneGuard(done);
+        if (!success) {
+            done->SetFailed();
+        }
+    };
     if (type == OriginType::CurveOrigin) {
         off_t chunkOffset;
         std::string fileName;
@@ -154,15 +241,23 @@ void OriginCopyer::DownloadAsync(DownloadClosure* done) {
             done->SetFailed();
             return;
         }
-        DownloadFromCurve(fileName, chunkOffset + context->offset,
-                          context->size, context->buf,
-                          done);
         doneGuard.release();
+        if (fetchUnit_ != 0) {
+            DownloadByUnit(type, fileName, chunkOffset + context->offset,
+                           context->size, context->buf, done);
+        } else {
+            DownloadFromCurve(fileName, chunkOffset + context->offset,
+                              context->size, context->buf, cb);
+        }
     } else if (type == OriginType::S3Origin) {
-        DownloadFromS3(originPath, context->offset,
-                       context->size, context->buf,
-                       done);
         doneGuard.release();
+        if (fetchUnit_ != 0) {
+            DownloadByUnit(type, originPath, context->offset,
+                           context->size, context->buf, done);
+        } else {
+            DownloadFromS3(originPath, context->offset,
+                           context->size, context->buf, cb);
+        }
     } else {
         LOG(ERROR) << "Unknown origin location."
                    << "location: " << context->location;
@@ -174,22 +269,18 @@ void OriginCopyer::DownloadFromS3(const string& objectName,
                                  off_t off,
                                  size_t size,
                                  char* buf,
-                                 DownloadClosure* done) {
-    brpc::ClosureGuard doneGuard(done);
+                                 const OriginReadCallback& cb) {
     if (s3Client_ == nullptr) {
         LOG(ERROR) << "Failed to get s3 object."
                    << "s3 adapter is disabled";
-        done->SetFailed();
+        cb(false);
         return;
     }
 
-    GetObjectAsyncCallBack cb =
-        [=] (const S3Adapter* adapter,
-             const std::shared_ptr<GetObjectAsyncContext>& context) {
-            brpc::ClosureGuard doneGuard(done);
-            if (context->retCode != 0) {
-                done->SetFailed();
-            }
+    GetObjectAsyncCallBack s3cb =
+        [cb] (const S3Adapter* adapter,
+              const std::shared_ptr<GetObjectAsyncContext>& context) {
+            cb(context->retCode == 0);
         };
 
     auto context = std::make_shared<GetObjectAsyncContext>();
@@ -197,22 +288,20 @@ void OriginCopyer::DownloadFromS3(const string& objectName,
     context->buf = buf;
     context->offset = off;
     context->len = size;
-    context->cb = cb;
+    context->cb = s3cb;
 
     s3Client_->GetObjectAsync(context);
-    doneGuard.release();
 }
 
 void OriginCopyer::DownloadFromCurve(const string& fileName,
                                     off_t off,
                                     size_t size,
                                     char* buf,
-                                    DownloadClosure* done) {
-    brpc::ClosureGuard doneGuard(done);
+                                    const OriginReadCallback& cb) {
     if (curveClient_ == nullptr) {
         LOG(ERROR) << "Failed to read curve file."
                    << "curve client is disabled";
-        done->SetFailed();
+        cb(false);
         return;
     }
 
@@ -239,7 +328,7 @@ void OriginCopyer::DownloadFromCurve(const string& fileName,
                 LOG(ERROR) << "Open curve file failed."
                         << "file name: " << fileName
                         << " ,return code: " << fd;
-                done->SetFailed();
+                cb(false);
                 return;
             }
             fdMap_[fileName] = fd;
@@ -255,7 +344,7 @@ void OriginCopyer::DownloadFromCurve(const string& fileName,
     }
 
     CurveAioCombineContext *curveCombineCtx = new CurveAioCombineContext();
-    curveCombineCtx->done = done;
+    curveCombineCtx->cb = new OriginReadCallback(cb);
     curveCombineCtx->curveCtx.offset = off;
     curveCombineCtx->curveCtx.length = size;
     curveCombineCtx->curveCtx.buf = buf;
@@ -267,12 +356,117 @@ void OriginCopyer::DownloadFromCurve(const string& fileName,
         LOG(ERROR) << "Read curve file failed."
                    << "file name: " << fileName
                    << " ,error code: " << ret;
+        delete curveCombineCtx->cb;
         delete curveCombineCtx;
-        done->SetFailed();
+        cb(false);
+    }
+}
+
+void OriginCopyer::DownloadByUnit(OriginType type,
+                                  const string& path,
+                                  off_t off,
+                                  size_t size,
+                                  char* buf,
+                                  DownloadClosure* done) {
+    if (size == 0) {
+        brpc::ClosureGuard doneGuard(done);
+        return;
+    }
+    uint64_t beginUnit = off / fetchUnit_;
+    uint64_t endUnit = (off + size - 1) / fetchUnit_;
+    auto read = std::make_shared<OriginRead>();
+    read->offset = off;
+    read->size = size;
+    read->buf = buf;
+    read->done = done;
+    read->failed = false;
+    // 多计一个，保证所有单位处理完之前不会执行done
+    read->pending = endUnit - beginUnit + 2;
+    metric_->requestBytes << size;
+
+    std::vector<std::shared_ptr<OriginFetch>> toStart;
+    for (uint64_t unit = beginUnit; unit <= endUnit; ++unit) {
+        std::string key = OriginExtentKey(type, path, unit);
+        off_t unitOff = unit * fetchUnit_;
+        std::shared_ptr<std::string> extent;
+        if (cache_ != nullptr && cache_->Get(key, &extent)) {
+            metric_->cacheHitBytes << CopyFromExtent(read, unitOff, *extent);
+            read->Finish(true);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(fetchMtx_);
+        auto iter = inflightFetches_.find(key);
+        if (iter != inflightFetches_.end()) {
+            iter->second->waiters.push_back(read);
+            metric_->mergedCount << 1;
+            continue;
+        }
+        auto fetch = std::make_shared<OriginFetch>();
+        fetch->type = type;
+        fetch->path = path;
+        fetch->key = key;
+        fetch->offset = unitOff;
+        fetch->data = std::make_shared<std::string>(fetchUnit_, 0);
+        fetch->waiters.push_back(read);
+        inflightFetches_.emplace(key, fetch);
+        toStart.push_back(fetch);
+    }
+
+    for (auto& fetch : toStart) {
+        StartFetch(fetch);
+    }
+    read->Finish(true);
+}
+
+void OriginCopyer::StartFetch(const std::shared_ptr<OriginFetch>& fetch) {
+    metric_->fetchBytes << fetchUnit_;
+    metric_->fetchCount << 1;
+    OriginReadCallback cb = [this, fetch](bool success) {
+        OnFetchDone(fetch, success);
+    };
+    // 源端对象按chunk划分，对齐后的读取单位不会超出对象的范围，
+    // s3对象的末尾可能不足一个单位，多出的部分不会被请求读取
+    if (fetch->type == OriginType::CurveOrigin) {
+        DownloadFromCurve(fetch->path, fetch->offset, fetchUnit_,
+                          &(*fetch->data)[0], cb);
     } else {
-        doneGuard.release();
+        DownloadFromS3(fetch->path, fetch->offset, fetchUnit_,
+                       &(*fetch->data)[0], cb);
     }
 }
 
+void OriginCopyer::OnFetchDone(const std::shared_ptr<OriginFetch>& fetch,
+                               bool success) {
+    std::vector<std::shared_ptr<OriginRead>> waiters;
+    {
+        std::lock_guard<std::mutex> lock(fetchMtx_);
+        // 先放入缓存再移出inflightFetches_，避免之间到达的请求重复下载
+        if (success && cache_ != nullptr) {
+            cache_->Put(fetch->key, fetch->data);
+        }
+        inflightFetches_.erase(fetch->key);
+        waiters.swap(fetch->waiters);
+    }
+
+    for (auto& read : waiters) {
+        if (success) {
+            CopyFromExtent(read, fetch->offset, *fetch->data);
+        }
+        read->Finish(success);
+    }
+}
+
+size_t OriginCopyer::CopyFromExtent(const std::shared_ptr<OriginRead>& read,
+                                    off_t extentOff,
+                                    const std::string& extent) {
+    off_t begin = std::max(read->offset, extentOff);
+    off_t end = std::min<off_t>(read->offset + read->size,
+                                extentOff + extent.size());
+    memcpy(read->buf + (begin - read->offset),
+           extent.data() + (begin - extentOff), end - begin);
+    return end - begin;
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -24,6 +24,8 @@
 #define SRC_CHUNKSERVER_CLONE_COPYER_H_
 
 #include <glog/logging.h>
+#include <bvar/bvar.h>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <string>
@@ -36,6 +38,7 @@
 #include "src/client/client_common.h"
 #include "include/client/libcurve.h"
 #include "src/common/s3_adapter.h"
+#include "src/common/lru_cache.h"
 
 namespace curve {
 namespace chunkserver {
@@ -47,6 +50,9 @@ using curve::common::LocationOperator;
 using curve::common::OriginType;
 using curve::common::GetObjectAsyncCallBack;
 using curve::common::GetObjectAsyncContext;
+using curve::common::LRUCache;
+using curve::common::CacheMetrics;
+using curve::common::CacheTraits;
 using std::string;
 
 class DownloadClosure;
@@ -64,6 +70,11 @@ struct CopyerOptions {
     std::shared_ptr<S3Adapter> s3Client;
     // curve file's time to live
     uint64_t curveFileTimeoutSec;
+    // 向源端读取数据的单位，请求会对齐扩展到该单位，相同单位的并发读取
+    // 会合并为一次；必须是2的幂且不超过chunk大小，0表示直接读取请求的范围
+    uint32_t fetchUnit = 0;
+    // 缓存最近下载的源端数据的最大字节数，0表示不缓存
+    uint64_t cacheBytes = 0;
 };
 
 struct AsyncDownloadContext {
@@ -92,6 +103,42 @@ struct CurveOpenTimestamp {
 
 std::ostream& operator<<(std::ostream& out, const AsyncDownloadContext& rhs);
 
+struct OriginFetchMetric {
+    explicit OriginFetchMetric(const std::string& prefix);
+
+    static double GetAmplification(void* arg);
+
+    // 请求下载的字节数
+    bvar::Adder<uint64_t> requestBytes;
+    // 实际从源端下载的字节数
+    bvar::Adder<uint64_t> fetchBytes;
+    // 从源端下载的次数
+    bvar::Adder<uint64_t> fetchCount;
+    // 从缓存中读取的字节数
+    bvar::Adder<uint64_t> cacheHitBytes;
+    // 合并到其他正在进行的下载的次数
+    bvar::Adder<uint64_t> mergedCount;
+    // 下载放大倍数，即fetchBytes / requestBytes
+    bvar::PassiveStatus<double> amplification;
+};
+
+struct OriginExtentTraits {
+    static uint64_t CountBytes(const std::shared_ptr<std::string>& v) {
+        return v->size();
+    }
+};
+
+// 源端数据的缓存，key为对象名加上读取单位的序号
+using OriginExtentCache = LRUCache<std::string, std::shared_ptr<std::string>,
+                                   CacheTraits<std::string>,
+                                   OriginExtentTraits>;
+
+// 源端读取完成后的回调，参数表示是否读取成功
+using OriginReadCallback = std::function<void(bool)>;
+
+struct OriginFetch;
+struct OriginRead;
+
 class OriginCopyer {
  public:
     OriginCopyer();
@@ -122,12 +169,34 @@ class OriginCopyer {
                        off_t off,
                        size_t size,
                        char* buf,
-                       DownloadClosure* done);
+                       const OriginReadCallback& cb);
     void DownloadFromCurve(const string& fileName,
                           off_t off,
                           size_t size,
                           char* buf,
-                          DownloadClosure* done);
+                          const OriginReadCallback& cb);
+    /**
+     * 按fetchUnit_对齐读取源端数据，优先从缓存中读取，
+     * 未命中的单位合并到正在进行的下载或者发起新的下载
+     * @param type: 源端类型
+     * @param path: s3的对象名或者curve的文件名
+     * @param off: 数据在对象或文件中的偏移
+     * @param size: 数据的长度
+     * @param buf: 存放数据的缓冲区
+     * @param done: 读取完成后执行的回调
+     */
+    void DownloadByUnit(OriginType type,
+                        const string& path,
+                        off_t off,
+                        size_t size,
+                        char* buf,
+                        DownloadClosure* done);
+    void StartFetch(const std::shared_ptr<OriginFetch>& fetch);
+    void OnFetchDone(const std::shared_ptr<OriginFetch>& fetch, bool success);
+    // 将读取单位中与请求重叠的部分拷贝到请求的缓冲区，返回拷贝的字节数
+    static size_t CopyFromExtent(const std::shared_ptr<OriginRead>& read,
+                                 off_t extentOff,
+                                 const std::string& extent);
     static void DeleteExpiredCurveCache(void* arg);
 
  private:
@@ -151,6 +220,16 @@ class OriginCopyer {
     bthread::TimerThread timer_;
     // timer's task id
     bthread::TimerThread::TaskId timerId_;
+    // 向源端读取数据的单位，0表示不对齐
+    uint32_t fetchUnit_;
+    // 保护inflightFetches_的互斥锁
+    std::mutex fetchMtx_;
+    // 正在进行的下载，key同cache_
+    std::unordered_map<std::string, std::shared_ptr<OriginFetch>>
+        inflightFetches_;
+    // 最近下载的源端数据
+    std::unique_ptr<OriginExtentCache> cache_;
+    std::unique_ptr<OriginFetchMetric> metric_;
 };
 
 }  // namespace chunkserver
@@ -32,12 +32,12 @@
 #include <utility>
 #include <condition_variable>    // NOLINT
 
-#include "src/common/concurrent/task_queue.h"
+#include "src/common/concurrent/mpsc_queue.h"
 #include "src/common/concurrent/count_down_event.h"
 #include "proto/chunk.pb.h"
 #include "include/curve_compiler_specific.h"
 
-using curve::common::TaskQueue;
+using curve::common::MPSCTaskQueue;
 using curve::common::CountDownEvent;
 using curve::chunkserver::CHUNK_OP_TYPE;
 
@@ -82,13 +82,43 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
      */
     template<class F, class... Args>
     bool Push(uint64_t key, CHUNK_OP_TYPE optype, F&& f, Args&&... args) {
-        auto task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
         switch (Schedule(optype)) {
             case ThreadPoolType::READ:
-                rapplyMap_[Hash(key, rconcurrentsize_)]->tq.Push(task);
+                rapplyMap_[Hash(key, rconcurrentsize_)]->tq.Push(
+                    std::forward<F>(f), std::forward<Args>(args)...);
                 break;
             case ThreadPoolType::WRITE:
-                wapplyMap_[Hash(key, wconcurrentsize_)]->tq.Push(task);
+                wapplyMap_[Hash(key, wconcurrentsize_)]->tq.Push(
+                    std::forward<F>(f), std::forward<Args>(args)...);
+                break;
+        }
+
+        return true;
+    }
+
+    /**
+     * PushAfterWrite: like Push, but a read task is only handed to the read
+     * thread after the tasks already queued in the write thread of the same
+     * key have finished, so that the read sees the data of those writes
+     * @param[in] key: used to hash task to specified queue
+     * @param[in] optype: operation type defined in proto
+     * @param[in] f: task
+     * @param[in] args: param to excute task
+     */
+    template<class F, class... Args>
+    bool PushAfterWrite(uint64_t key, CHUNK_OP_TYPE optype,
+                        F&& f, Args&&... args) {
+        MPSCTaskQueue::Task task(
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        MPSCTaskQueue *wq = &wapplyMap_[Hash(key, wconcurrentsize_)]->tq;
+        switch (Schedule(optype)) {
+            case ThreadPoolType::READ:
+                wq->Push(ForwardTask(
+                    &rapplyMap_[Hash(key, rconcurrentsize_)]->tq,
+                    std::move(task)));
+                break;
+            case ThreadPoolType::WRITE:
+                wq->Push(std::move(task));
                 break;
         }
 
@@ -116,10 +146,22 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
     }
 
  private:
+    // run in a write thread, push the task to the read thread
+    struct ForwardTask {
+        ForwardTask(MPSCTaskQueue *q, MPSCTaskQueue::Task &&t)
+            : queue(q), task(std::move(t)) {}
+        void operator()() {
+            queue->Push(std::move(task));
+        }
+
+        MPSCTaskQueue *queue;
+        MPSCTaskQueue::Task task;
+    };
+
     typedef uint8_t threadIndex;
     typedef struct taskthread {
         std::thread th;
-        TaskQueue tq;
+        MPSCTaskQueue tq;
         taskthread(size_t capacity):tq(capacity) {}
         ~taskthread() = default;
     } taskthread_t;
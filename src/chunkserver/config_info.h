@@ -128,6 +128,29 @@ struct CopysetNodeOptions {
     // check syncing interval
     uint32_t checkSyncingIntervalMs = 500u;
 
+    // leader with a valid lease serves reads locally without raft propose
+    bool enableLeaseRead = false;
+    // follower serves reads, either the applied index carried by request or
+    // the read index got from leader has been applied locally
+    bool enableFollowerRead = false;
+    // max time follower waits for local apply to catch up the read index
+    uint32_t followerReadWaitMs = 100u;
+
+    // record the crc of every page, the scan only reads the pages written
+    // since last scan
+    bool enablePageCrc = false;
+    // verify the data read with the recorded page crc
+    bool verifyPageCrcOnRead = false;
+
+    // large aligned overwrites only record the raft log index of the data
+    // and are written into chunk files later, overwritten data is never
+    // written, needs the curve raft log storage
+    bool enableDeferredWrite = false;
+    // min size of the write to defer
+    uint32_t deferredWriteMinSize = 128 * 1024;
+    // max bytes of deferred writes of a copyset before merging
+    uint64_t deferredWriteMaxBytes = 32 * 1024 * 1024;
+
     CopysetNodeOptions();
 };
 
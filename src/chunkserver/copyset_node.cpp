@@ -28,6 +28,8 @@
 #include <braft/closure_helper.h>
 #include <braft/snapshot.h>
 #include <braft/protobuf_file.h>
+#include <bthread/bthread.h>
+#include <bthread/countdown_event.h>
 #include <utility>
 #include <memory>
 #include <algorithm>
@@ -43,14 +45,17 @@
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/datastore/define.h"
 #include "src/chunkserver/datastore/datastore_file_helper.h"
+#include "src/chunkserver/datastore/sync_scheduler.h"
 #include "src/common/uri_parser.h"
 #include "src/common/crc32.h"
 #include "src/common/fs_util.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace chunkserver {
 
 using curve::fs::FileSystemInfo;
+using curve::common::TimeUtility;
 
 const char *kCurveConfEpochFilename = "conf.epoch";
 
@@ -124,6 +129,16 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
     dsOptions.locationLimit = options.locationLimit;
     dsOptions.enableOdsyncWhenOpenChunkFile =
         options.enableOdsyncWhenOpenChunkFile;
+    dsOptions.enablePageCrc = options.enablePageCrc;
+    dsOptions.verifyPageCrcOnRead = options.verifyPageCrcOnRead;
+    if (options.enableDeferredWrite) {
+        dsOptions.deferredWriteMinSize = options.deferredWriteMinSize;
+        dsOptions.deferredWriteMaxBytes = options.deferredWriteMaxBytes;
+        dsOptions.deferredWriteReader = [this](uint64_t index,
+                                               butil::IOBuf *data) {
+            return ReadWriteDataFromLog(index, data);
+        };
+    }
     dataStore_ = std::make_shared<CSDataStore>(options.localFileSystem,
                                                options.chunkFilePool,
                                                dsOptions);
@@ -183,6 +198,9 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
     syncTimerIntervalMs_ = options.syncTimerIntervalMs;
     checkSyncingIntervalMs_ = options.checkSyncingIntervalMs;
     enableOdsyncWhenOpenChunkFile_ = options.enableOdsyncWhenOpenChunkFile;
+    enableLeaseRead_ = options.enableLeaseRead;
+    enableFollowerRead_ = options.enableFollowerRead;
+    followerReadWaitMs_ = options.followerReadWaitMs;
 
     return 0;
 }
@@ -287,7 +305,7 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
                                   iter.index(),
                                   doneGuard.release());
             concurrentapply_->Push(
-                opRequest->ChunkId(), opRequest->OpType(), task);
+                opRequest->ChunkId(), opRequest->OpType(), std::move(task));
         } else {
             // 获取log entry
             butil::IOBuf log = iter.data();
@@ -302,12 +320,13 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
             auto opReq = ChunkOpRequest::Decode(log, &request, &data,
                                                 iter.index(), GetLeaderId());
             auto chunkId = request.chunkid();
+            auto optype = request.optype();
             auto task = std::bind(&ChunkOpRequest::OnApplyFromLog,
                                   opReq,
                                   dataStore_,
                                   std::move(request),
                                   data);
-            concurrentapply_->Push(chunkId, request.optype(), task);
+            concurrentapply_->Push(chunkId, optype, std::move(task));
         }
     }
 }
@@ -339,10 +358,24 @@ void CopysetNode::save_snapshot_background(::braft::SnapshotWriter *writer,
      */
     concurrentapply_->Flush();
 
+    // 延迟写的数据只在raft log中，快照后log会被删除，需要先写入chunk文件
+    CSErrorCode errorCode = dataStore_->FlushDeferredWrites();
+    if (errorCode != CSErrorCode::Success) {
+        done->status().set_error(EIO, "flush deferred writes failed: %d",
+                                 static_cast<int>(errorCode));
+        LOG(ERROR) << "Flush deferred writes failed. "
+                   << "Copyset: " << GroupIdString()
+                   << ", error code: " << errorCode;
+        return;
+    }
+
     if (!enableOdsyncWhenOpenChunkFile_) {
         ForceSyncAllChunks();
     }
 
+    // 持久化page crc，重启后快照之后的写会通过回放raft log重新记录
+    dataStore_->PersistPageCrcs();
+
     /**
      * 2.保存配置版本: conf.epoch，注意conf.epoch是存放在data目录下
      */
@@ -369,6 +402,10 @@ void CopysetNode::save_snapshot_background(::braft::SnapshotWriter *writer,
             if (isSnapshot) {
                 continue;
             }
+            // page crc只在本地使用，安装快照的副本重新扫描生成
+            if (DatastoreFileHelper::IsPageCrcFile(fileName)) {
+                continue;
+            }
             std::string chunkApath;
             // 通过绝对路径，算出相对于快照目录的路径
             chunkApath.append(chunkDataApath_);
@@ -934,8 +971,8 @@ bool CopysetNode::GetLeaderStatus(NodeStatus *leaderStaus) {
     // get committed index from remote leader
     brpc::Controller cntl;
     cntl.set_timeout_ms(500);
-    brpc::Channel channel;
-    if (channel.Init(status.leader_id.addr, nullptr) !=0) {
+    auto channel = GetLeaderChannel(status.leader_id.addr);
+    if (channel == nullptr) {
         LOG(WARNING) << "can not create channel to "
                      << status.leader_id.addr
                      << ", copyset " << GroupIdString();
@@ -951,7 +988,7 @@ bool CopysetNode::GetLeaderStatus(NodeStatus *leaderStaus) {
     request.set_allocated_peer(peer);
     request.set_queryhash(false);
 
-    CopysetService_Stub stub(&channel);
+    CopysetService_Stub stub(channel.get());
     stub.GetCopysetStatus(&cntl, &request, &response, nullptr);
     if (cntl.Failed()) {
         LOG(WARNING) << "get leader status failed: "
@@ -984,6 +1021,123 @@ bool CopysetNode::GetLeaderStatus(NodeStatus *leaderStaus) {
     return true;
 }
 
+std::shared_ptr<brpc::Channel> CopysetNode::GetLeaderChannel(
+    const butil::EndPoint &addr) {
+    curve::common::LockGuard lg(leaderChannelLock_);
+    if (leaderChannel_ != nullptr && leaderChannelAddr_ == addr) {
+        return leaderChannel_;
+    }
+
+    auto channel = std::make_shared<brpc::Channel>();
+    if (channel->Init(addr, nullptr) != 0) {
+        return nullptr;
+    }
+    leaderChannel_ = channel;
+    leaderChannelAddr_ = addr;
+    return channel;
+}
+
+void CopysetNode::GetLeaderLeaseStatus(braft::LeaderLeaseStatus *status) {
+    raftNode_->get_leader_lease_status(status);
+}
+
+bool CopysetNode::IsLeaseLeader(
+    const braft::LeaderLeaseStatus &status) const {
+    int64_t term = leaderTerm_.load(std::memory_order_acquire);
+    // on_leader_start may not be called yet, or lease belongs to old term
+    return term > 0 && status.state == braft::LEASE_VALID &&
+           status.term == term;
+}
+
+bool CopysetNode::IsLeaseReadEnabled() const {
+    return enableLeaseRead_;
+}
+
+bool CopysetNode::IsFollowerReadEnabled() const {
+    return enableFollowerRead_;
+}
+
+bool CopysetNode::GetReadIndex(uint64_t deadlineMs, int64_t *readIndex) {
+    std::unique_lock<bthread::Mutex> lk(readIndexMtx_);
+    uint64_t round = readIndexStartedRound_ + 1;
+    while (readIndexDoneRound_ < round) {
+        if (!readIndexInflight_) {
+            // no rpc inflight, start the round and share it with the others
+            readIndexInflight_ = true;
+            readIndexStartedRound_ = round;
+            lk.unlock();
+            NodeStatus leaderStatus;
+            bool ok = GetLeaderStatus(&leaderStatus);
+            lk.lock();
+            readIndexInflight_ = false;
+            readIndexDoneRound_ = round;
+            readIndexOk_ = ok;
+            readIndex_ = leaderStatus.committed_index;
+            readIndexCond_.notify_all();
+            break;
+        }
+
+        uint64_t now = TimeUtility::GetTimeofDayMs();
+        if (now >= deadlineMs) {
+            return false;
+        }
+        readIndexCond_.wait_for(lk, (deadlineMs - now) * 1000);
+    }
+
+    *readIndex = readIndex_;
+    return readIndexOk_;
+}
+
+bool CopysetNode::WaitReadIndex() {
+    uint64_t deadline = TimeUtility::GetTimeofDayMs() + followerReadWaitMs_;
+    int64_t readIndex = 0;
+    if (!GetReadIndex(deadline, &readIndex)) {
+        return false;
+    }
+
+    NodeStatus status;
+    while (true) {
+        raftNode_->get_status(&status);
+        if (status.known_applied_index >= readIndex) {
+            return true;
+        }
+        if (TimeUtility::GetTimeofDayMs() >= deadline) {
+            LOG(INFO) << "Copyset: " << GroupIdString()
+                      << " wait read index timeout, read index: " << readIndex
+                      << ", known applied index: "
+                      << status.known_applied_index;
+            return false;
+        }
+        bthread_usleep(1000);
+    }
+}
+
+bool CopysetNode::ReadWriteDataFromLog(uint64_t index, butil::IOBuf *data) {
+    if (logStorage_ == nullptr) {
+        LOG(ERROR) << "Copyset: " << GroupIdString()
+                   << " has no curve log storage to read index " << index;
+        return false;
+    }
+    braft::LogEntry *entry = logStorage_->get_entry(index);
+    if (entry == nullptr) {
+        LOG(ERROR) << "Copyset: " << GroupIdString()
+                   << " get log entry failed, index: " << index;
+        return false;
+    }
+    bool isWrite = false;
+    if (entry->type == braft::ENTRY_TYPE_DATA) {
+        ChunkRequest request;
+        auto opReq = ChunkOpRequest::Decode(entry->data, &request, data,
+                                            index, PeerId());
+        isWrite = opReq != nullptr
+            && request.optype() == CHUNK_OP_TYPE::CHUNK_OP_WRITE;
+    }
+    entry->Release();
+    LOG_IF(ERROR, !isWrite) << "Copyset: " << GroupIdString()
+                            << " log entry is not a write, index: " << index;
+    return isWrite;
+}
+
 void CopysetNode::HandleSyncTimerOut() {
     if (isSyncing_.exchange(true)) {
         return;
@@ -1007,11 +1161,36 @@ void CopysetNode::SyncAllChunks() {
         curve::common::LockGuard lg(chunkIdsLock_);
         temp.swap(chunkIdsToSync_);
     }
+    // 合并延迟写时写入的chunk
+    std::vector<ChunkID> merged;
+    dataStore_->TakeMergedChunks(&merged);
     size_t total = temp.size();
     std::set<ChunkID> chunkIds;
     for (auto chunkId : temp) {
         chunkIds.insert(chunkId);
     }
+    chunkIds.insert(merged.begin(), merged.end());
+    SyncScheduler& scheduler = SyncScheduler::GetInstance();
+    if (scheduler.IsRunning()) {
+        // 交给按盘合并的sync调度器，与其他copyset的sync请求一起完成
+        bthread::CountdownEvent event(chunkIds.size());
+        for (ChunkID chunk : chunkIds) {
+            scheduler.Submit(dataStore_.get(), chunk,
+                [this, chunk]() {
+                    CSErrorCode r = dataStore_->SyncChunk(chunk);
+                    return r == CSErrorCode::Success ? 0 : -1;
+                },
+                [this, chunk, &event](int ret) {
+                    LOG_IF(FATAL, ret != 0) << "Sync Chunk failed in Copyset: "
+                                            << GroupIdString()
+                                            << ", chunkid: " << chunk
+                                            << ", ret: " << ret;
+                    event.signal();
+                });
+        }
+        event.wait();
+        return;
+    }
     for (ChunkID chunk : chunkIds) {
         CSErrorCode r = dataStore_->SyncChunk(chunk);
         if (r != CSErrorCode::Success) {
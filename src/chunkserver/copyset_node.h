@@ -25,6 +25,9 @@
 
 #include <butil/memory/ref_counted.h>
 #include <braft/repeated_timer_task.h>
+#include <brpc/channel.h>
+#include <bthread/condition_variable.h>
+#include <bthread/mutex.h>
 
 #include <string>
 #include <vector>
@@ -274,6 +277,39 @@ class CopysetNode : public braft::StateMachine,
      */
     virtual bool GetLeaderStatus(NodeStatus *leaderStaus);
 
+    /**
+     * @brief: get the leader lease status of the raft node
+     * @param status[out]: leader lease status
+     */
+    virtual void GetLeaderLeaseStatus(braft::LeaderLeaseStatus *status);
+
+    /**
+     * @brief: whether this peer is leader and holds a valid lease in the
+     *         current term, if so reads can be served without propose
+     * @param status: leader lease status got by GetLeaderLeaseStatus
+     * @return true if lease is valid
+     */
+    virtual bool IsLeaseLeader(const braft::LeaderLeaseStatus &status) const;
+
+    /**
+     * @brief: whether leader serves reads by lease instead of raft log
+     */
+    virtual bool IsLeaseReadEnabled() const;
+
+    /**
+     * @brief: whether follower is allowed to serve reads
+     */
+    virtual bool IsFollowerReadEnabled() const;
+
+    /**
+     * @brief: read index for follower read, get committed index from leader
+     *         and wait until all logs before it have been dispatched to the
+     *         concurrent apply module, the read must then be queued after
+     *         the writes of its chunk by ConcurrentApplyModule::PushAfterWrite
+     * @return true if local apply catches up within followerReadWaitMs
+     */
+    virtual bool WaitReadIndex();
+
     /**
      * 返回data store指针
      * @return
@@ -446,6 +482,32 @@ class CopysetNode : public braft::StateMachine,
         return ToGroupIdString(logicPoolId_, copysetId_);
     }
 
+    /**
+     * @brief: get the cached channel to leader, rebuild it if leader changed
+     * @return nullptr if failed to init the channel
+     */
+    std::shared_ptr<brpc::Channel> GetLeaderChannel(
+        const butil::EndPoint &addr);
+
+    /**
+     * @brief: get the committed index of leader as read index, the callers
+     *         coming during an inflight rpc share the next one, because the
+     *         inflight one may miss the writes finished before they came
+     * @param deadlineMs: give up waiting for the rpc after it
+     * @param readIndex[out]: read index
+     * @return true if success
+     */
+    bool GetReadIndex(uint64_t deadlineMs, int64_t *readIndex);
+
+    /**
+     * @brief: read the data of the write chunk request in the raft log entry
+     *         at index, used to merge the deferred writes of datastore
+     * @param index: the index of the log entry
+     * @param data[out]: the data of the write
+     * @return true if success
+     */
+    bool ReadWriteDataFromLog(uint64_t index, butil::IOBuf *data);
+
  private:
     // 逻辑池 id
     LogicPoolID logicPoolId_;
@@ -474,7 +536,7 @@ class CopysetNode : public braft::StateMachine,
     // Chunk持久化操作接口
     std::shared_ptr<CSDataStore> dataStore_;
     // The log storage for braft
-    CurveSegmentLogStorage* logStorage_;
+    CurveSegmentLogStorage* logStorage_ = nullptr;
     // 并发模块
     ConcurrentApplyModule *concurrentapply_;
     // 配置版本持久化工具接口
@@ -515,6 +577,25 @@ class CopysetNode : public braft::StateMachine,
     uint32_t checkSyncingIntervalMs_;
     // async snapshot future object
     std::future<void> snapshotFuture_;
+    // serve reads on leader with a valid lease without propose
+    bool enableLeaseRead_ = false;
+    // serve reads on follower
+    bool enableFollowerRead_ = false;
+    // max time waiting for local apply to catch up the read index
+    uint32_t followerReadWaitMs_ = 0;
+    // cached channel to leader and its address
+    std::shared_ptr<brpc::Channel> leaderChannel_;
+    butil::EndPoint leaderChannelAddr_;
+    curve::common::Mutex leaderChannelLock_;
+    // batch read index requests, at most one rpc is inflight, rounds are
+    // numbered from 1 and a round starts after the previous one is done
+    bthread::Mutex readIndexMtx_;
+    bthread::ConditionVariable readIndexCond_;
+    bool readIndexInflight_ = false;
+    uint64_t readIndexStartedRound_ = 0;
+    uint64_t readIndexDoneRound_ = 0;
+    bool readIndexOk_ = false;
+    int64_t readIndex_ = 0;
 };
 
 }  // namespace chunkserver
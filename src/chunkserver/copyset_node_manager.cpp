@@ -25,6 +25,8 @@
 #include <glog/logging.h>
 #include <braft/file_service.h>
 #include <braft/node_manager.h>
+#include <braft/protobuf_file.h>
+#include <braft/local_storage.pb.h>
 
 #include <vector>
 #include <string>
@@ -32,6 +34,7 @@
 
 #include "src/common/string_util.h"
 #include "src/common/timeutility.h"
+#include "src/common/concurrent/count_down_event.h"
 #include "src/chunkserver/chunk_service.h"
 #include "src/chunkserver/op_request.h"
 #include "src/chunkserver/copyset_service.h"
@@ -39,12 +42,14 @@
 #include "src/chunkserver/braft_cli_service2.h"
 #include "src/common/uri_parser.h"
 #include "src/chunkserver/raftsnapshot/curve_file_service.h"
+#include "src/chunkserver/raftsnapshot/define.h"
 
 
 namespace curve {
 namespace chunkserver {
 
 using curve::common::TimeUtility;
+using curve::common::CountDownEvent;
 
 std::once_flag addServiceFlag;
 
@@ -123,6 +128,9 @@ int CopysetNodeManager::ReloadCopysets() {
         return -1;
     }
 
+    uint64_t beginTime = TimeUtility::GetTimeofDayMs();
+    std::vector<uint64_t> groupIds;
+    std::vector<uint64_t> leaderLikelyIds;
     vector<std::string>::iterator it = items.begin();
     for (; it != items.end(); ++it) {
         LOG(INFO) << "Found copyset dir " << *it;
@@ -132,6 +140,22 @@ int CopysetNodeManager::ReloadCopysets() {
             LOG(ERROR) << "parse " << *it << " to graoupId err";
             return -1;
         }
+        // 重启前可能是leader的copyset优先加载，尽快选出leader恢复服务
+        if (IsLeaderLikely(*it)) {
+            leaderLikelyIds.push_back(groupId);
+        } else {
+            groupIds.push_back(groupId);
+        }
+    }
+    reloadLeaderLikely_.set_value(leaderLikelyIds.size());
+    groupIds.insert(groupIds.begin(),
+                    leaderLikelyIds.begin(), leaderLikelyIds.end());
+    reloadListMs_.set_value(TimeUtility::GetTimeofDayMs() - beginTime);
+    LOG(INFO) << "Found " << groupIds.size() << " copysets, "
+              << leaderLikelyIds.size() << " of them may be leader";
+
+    CountDownEvent loadDone(groupIds.size());
+    for (uint64_t groupId : groupIds) {
         uint64_t poolId = GetPoolID(groupId);
         uint64_t copysetId = GetCopysetID(groupId);
         LOG(INFO) << "Parsed groupid " << groupId
@@ -139,30 +163,54 @@ int CopysetNodeManager::ReloadCopysets() {
 
         if (copysetLoader_ == nullptr) {
             LoadCopyset(poolId, copysetId, false);
+            loadDone.Signal();
         } else {
-            copysetLoader_->Enqueue(
-                std::bind(&CopysetNodeManager::LoadCopyset,
-                          this,
-                          poolId,
-                          copysetId,
-                          true));
+            copysetLoader_->Enqueue([this, poolId, copysetId, &loadDone]() {
+                LoadCopyset(poolId, copysetId, true);
+                loadDone.Signal();
+            });
         }
     }
 
-    // 如果加载成功，则等待所有copyset加载完成，关闭线程池
+    // 等待所有copyset加载完成，关闭线程池
+    loadDone.Wait();
     if (copysetLoader_ != nullptr) {
-        while (copysetLoader_->QueueSize() != 0) {
-            ::sleep(1);
-        }
-        // queue size为0，但是线程池中的线程仍然可能还在执行
-        // stop内部会去join thread，以此保证所有任务执行完以后再退出
         copysetLoader_->Stop();
         copysetLoader_ = nullptr;
     }
+    reloadTotalMs_.set_value(TimeUtility::GetTimeofDayMs() - beginTime);
+    LOG(INFO) << "Reload " << groupIds.size() << " copysets, time used (ms): "
+              << reloadTotalMs_.get_value();
 
     return 0;
 }
 
+bool CopysetNodeManager::IsLeaderLikely(const std::string &groupId) {
+    std::string path = curve::common::UriParser::GetPathFromUri(
+        copysetNodeOptions_.raftMetaUri);
+    path.append("/").append(groupId)
+        .append("/").append(RAFT_META_DIR)
+        .append("/").append(RAFT_META_FILE);
+    if (!copysetNodeOptions_.localFileSystem->FileExists(path)) {
+        return false;
+    }
+
+    braft::ProtoBufFile pbFile(path);
+    braft::StablePBMeta meta;
+    if (pbFile.load(&meta) != 0) {
+        LOG(WARNING) << "Failed to load raft meta " << path;
+        return false;
+    }
+    braft::PeerId votedFor;
+    butil::EndPoint self;
+    if (votedFor.parse(meta.votedfor()) != 0 ||
+        butil::str2endpoint(copysetNodeOptions_.ip.c_str(),
+                            copysetNodeOptions_.port, &self) != 0) {
+        return false;
+    }
+    return votedFor.addr == self;
+}
+
 bool CopysetNodeManager::LoadFinished() {
     return loadFinished_.load(std::memory_order_acquire);
 }
@@ -191,10 +239,14 @@ void CopysetNodeManager::LoadCopyset(const LogicPoolID &logicPoolId,
                    << ToGroupIdString(logicPoolId, copysetId);
         return;
     }
+    uint64_t loadTime = TimeUtility::GetTimeofDayMs();
+    copysetLoadLatency_ << loadTime - beginTime;
     if (needCheckLoadFinished) {
         std::shared_ptr<CopysetNode> node =
             GetCopysetNode(logicPoolId, copysetId);
-        CheckCopysetUntilLoadFinished(node);
+        if (CheckCopysetUntilLoadFinished(node)) {
+            copysetCatchupLatency_ << TimeUtility::GetTimeofDayMs() - loadTime;
+        }
     }
     LOG(INFO) << "Load copyset " << ToGroupIdString(logicPoolId, copysetId)
               << " end, time used (ms): "
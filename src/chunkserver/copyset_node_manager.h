@@ -27,6 +27,9 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <string>
+
+#include <bvar/bvar.h>
 
 #include "src/chunkserver/copyset_node.h"
 #include "src/common/concurrent/rw_lock.h"
@@ -185,7 +188,12 @@ class CopysetNodeManager : public curve::common::Uncopyable {
     CopysetNodeManager()
         : copysetLoader_(nullptr)
         , running_(false)
-        , loadFinished_(false) {}
+        , loadFinished_(false)
+        , reloadListMs_("chunkserver_reload_copysets_list_ms", 0)
+        , reloadTotalMs_("chunkserver_reload_copysets_total_ms", 0)
+        , reloadLeaderLikely_("chunkserver_reload_copysets_leader_likely", 0)
+        , copysetLoadLatency_("chunkserver_reload_copyset_load")
+        , copysetCatchupLatency_("chunkserver_reload_copyset_catchup") {}
 
  private:
     /**
@@ -212,6 +220,14 @@ class CopysetNodeManager : public curve::common::Uncopyable {
         const CopysetID &copysetId,
         const Configuration &conf);
 
+    /**
+     * 根据raft meta判断copyset重启前是否可能是leader，即最后一个term
+     * 投票给了自己，这些copyset优先加载，以尽快恢复对外服务
+     * @param groupId: 复制组id
+     * @return true表示可能是leader
+     */
+    bool IsLeaderLikely(const std::string &groupId);
+
  private:
     using CopysetNodeMap = std::unordered_map<GroupId,
                                               std::shared_ptr<CopysetNode>>;
@@ -227,6 +243,17 @@ class CopysetNodeManager : public curve::common::Uncopyable {
     Atomic<bool> running_;
     // 表示copyset node manager当前是否已经完成加载
     Atomic<bool> loadFinished_;
+    // 启动加载copyset各阶段的耗时
+    // 扫描copyset目录并排序的耗时(ms)
+    bvar::Status<int64_t> reloadListMs_;
+    // 加载所有copyset的总耗时(ms)
+    bvar::Status<int64_t> reloadTotalMs_;
+    // 优先加载的可能是leader的copyset数量
+    bvar::Status<uint32_t> reloadLeaderLikely_;
+    // 单个copyset创建并初始化的耗时(ms)，包括加载快照和raft日志
+    bvar::LatencyRecorder copysetLoadLatency_;
+    // 单个copyset回放日志并追上leader的耗时(ms)
+    bvar::LatencyRecorder copysetCatchupLatency_;
 };
 
 }  // namespace chunkserver
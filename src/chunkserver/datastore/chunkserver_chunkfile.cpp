@@ -155,7 +155,9 @@ CSChunkFile::CSChunkFile(std::shared_ptr<LocalFileSystem> lfs,
       chunkFilePool_(chunkFilePool),
       lfs_(lfs),
       metric_(options.metric),
-      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile) {
+      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile),
+      enablePageCrc_(options.enablePageCrc),
+      verifyPageCrcOnRead_(options.verifyPageCrcOnRead) {
     CHECK(!baseDir_.empty()) << "Create chunk file failed";
     CHECK(lfs_ != nullptr) << "Create chunk file failed";
     metaPage_.sn = options.sn;
@@ -197,9 +199,11 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
     // The existence of chunk files may be caused by two situations:
     // 1. getchunk succeeded, but failed in stat or load metapage last time;
     // 2. Two write requests concurrently create new chunk files
+    bool newFile = false;
     if (createFile
         && !lfs_->FileExists(chunkFilePath)
         && metaPage_.sn > 0) {
+        newFile = true;
         std::unique_ptr<char[]> buf(new char[pageSize_]);
         memset(buf.get(), 0, pageSize_);
         metaPage_.version = FORMAT_VERSION_V2;
@@ -254,9 +258,53 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
         }
         isCloneChunk_ = true;
     }
+    if (errCode == CSErrorCode::Success) {
+        loadPageCrc(newFile);
+    }
     return errCode;
 }
 
+void CSChunkFile::loadPageCrc(bool newFile) {
+    if (!enablePageCrc_) {
+        return;
+    }
+    pageCrc_.reset(new ChunkPageCrc(size_, pageSize_));
+    string crcPath = pageCrcPath();
+    if (!lfs_->FileExists(crcPath)) {
+        return;
+    }
+    // Left by the deleted chunk with the same id
+    if (newFile) {
+        if (lfs_->Delete(crcPath) < 0) {
+            LOG(WARNING) << "Delete stale page crc failed."
+                         << " filepath = " << crcPath;
+        }
+        return;
+    }
+
+    int fd = lfs_->Open(crcPath, O_RDONLY);
+    if (fd < 0) {
+        LOG(WARNING) << "Open page crc failed, all pages will be scanned."
+                     << " filepath = " << crcPath;
+        return;
+    }
+    struct stat fileInfo;
+    std::string content;
+    if (lfs_->Fstat(fd, &fileInfo) == 0) {
+        content.resize(fileInfo.st_size);
+        int rc = lfs_->Read(fd, &content[0], 0, content.size());
+        if (rc != static_cast<int>(content.size())) {
+            content.clear();
+        }
+    }
+    lfs_->Close(fd);
+    if (!pageCrc_->Decode(content)) {
+        LOG(WARNING) << "Load page crc failed, all pages will be scanned."
+                     << " filepath = " << crcPath;
+        pageCrc_.reset(new ChunkPageCrc(size_, pageSize_));
+    }
+}
+
 CSErrorCode CSChunkFile::LoadSnapshot(SequenceNum sn) {
     WriteLockGuard writeGuard(rwLock_);
     if (snapshot_ != nullptr) {
@@ -408,6 +456,9 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
                    << ",chunk sn: " << metaPage_.sn;
         return CSErrorCode::InternalError;
     }
+    if (pageCrc_ != nullptr) {
+        pageCrc_->Update(buf, offset, length);
+    }
     // If it is a clone chunk, the bitmap will be updated
     CSErrorCode errorCode = flush();
     if (errorCode != CSErrorCode::Success) {
@@ -474,6 +525,9 @@ CSErrorCode CSChunkFile::Paste(const char * buf, off_t offset, size_t length) {
                        << ", length: " << length;
             return CSErrorCode::InternalError;
         }
+        if (pageCrc_ != nullptr) {
+            pageCrc_->Update(buf + (pasteOff - offset), pasteOff, pasteSize);
+        }
     }
 
     // Update bitmap
@@ -528,6 +582,126 @@ CSErrorCode CSChunkFile::Read(char * buf, off_t offset, size_t length) {
                    << ",chunk sn: " << metaPage_.sn;
         return CSErrorCode::InternalError;
     }
+    if (verifyPageCrcOnRead_ && pageCrc_ != nullptr
+        && !verifyPageCrc(buf, offset, length)) {
+        LOG(ERROR) << "Read chunk file failed, page crc mismatch."
+                   << "ChunkID: " << chunkId_
+                   << ", offset: " << offset
+                   << ", length: " << length;
+        return CSErrorCode::CrcCheckError;
+    }
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSChunkFile::ScanPageCrc(off_t offset,
+                                     size_t length,
+                                     uint32_t* crc) {
+    // Only the page crc is modified, so the writes of the chunk are blocked
+    // only by the read of the range as Read
+    ReadLockGuard readGuard(rwLock_);
+    if (!CheckOffsetAndLength(offset, length, pageSize_) || length == 0) {
+        LOG(ERROR) << "Scan chunk failed, invalid offset or length."
+                   << "ChunkID: " << chunkId_
+                   << ", offset: " << offset
+                   << ", length: " << length
+                   << ", page size: " << pageSize_
+                   << ", chunk size: " << size_;
+        return CSErrorCode::InvalidArgError;
+    }
+    uint32_t beginIndex = offset / pageSize_;
+    uint32_t endIndex = (offset + length - 1) / pageSize_;
+    if (isCloneChunk_
+        && metaPage_.bitmap->NextClearBit(beginIndex, endIndex)
+           != Bitmap::NO_POS) {
+        LOG(ERROR) << "Scan chunk failed, has page never written."
+                   << "ChunkID: " << chunkId_
+                   << ", offset: " << offset
+                   << ", length: " << length;
+        return CSErrorCode::PageNerverWrittenError;
+    }
+
+    // Read the whole range without page crc
+    std::vector<BitRange> ranges;
+    if (pageCrc_ != nullptr) {
+        ReadLockGuard crcGuard(pageCrcLock_);
+        pageCrc_->GetUnscannedRanges(beginIndex, endIndex, &ranges);
+    } else {
+        ranges.push_back(BitRange{beginIndex, endIndex});
+    }
+
+    std::unique_ptr<char[]> buf;
+    if (!ranges.empty()) {
+        buf.reset(new char[length]);
+    }
+    for (auto& range : ranges) {
+        off_t readOff = range.beginIndex * pageSize_;
+        size_t readSize = (range.endIndex - range.beginIndex + 1) * pageSize_;
+        int rc = readData(buf.get(), readOff, readSize);
+        if (rc < 0) {
+            LOG(ERROR) << "Scan chunk failed, read data failed."
+                       << "ChunkID: " << chunkId_
+                       << ", offset: " << readOff
+                       << ", length: " << readSize;
+            return CSErrorCode::InternalError;
+        }
+        if (pageCrc_ == nullptr) {
+            // Same as the crc combined from the page crc
+            *crc = ::curve::common::CRC32(buf.get(), readSize);
+            return CSErrorCode::Success;
+        }
+        uint32_t mismatch;
+        {
+            WriteLockGuard crcGuard(pageCrcLock_);
+            mismatch = pageCrc_->Scan(buf.get(),
+                                      range.beginIndex,
+                                      range.endIndex - range.beginIndex + 1);
+        }
+        if (mismatch > 0) {
+            LOG(ERROR) << "Found pages changed on disk."
+                       << "ChunkID: " << chunkId_
+                       << ", offset: " << readOff
+                       << ", length: " << readSize
+                       << ", pages: " << mismatch;
+        }
+    }
+    ReadLockGuard crcGuard(pageCrcLock_);
+    *crc = pageCrc_->RangeCrc(beginIndex, endIndex);
+    return CSErrorCode::Success;
+}
+
+bool CSChunkFile::verifyPageCrc(const char* buf,
+                                off_t offset,
+                                size_t length) {
+    ReadLockGuard crcGuard(pageCrcLock_);
+    return pageCrc_->Verify(buf, offset, length);
+}
+
+CSErrorCode CSChunkFile::PersistPageCrc() {
+    ReadLockGuard readGuard(rwLock_);
+    // A scan between Encode and MarkPersisted would be lost
+    WriteLockGuard crcGuard(pageCrcLock_);
+    if (pageCrc_ == nullptr || !pageCrc_->Dirty() || fd_ < 0) {
+        return CSErrorCode::Success;
+    }
+    std::string content;
+    pageCrc_->Encode(&content);
+    // The content is verified by crc when loading, so it is not synced
+    // and written in place
+    string crcPath = pageCrcPath();
+    int fd = lfs_->Open(crcPath, O_RDWR|O_CREAT|O_TRUNC);
+    if (fd < 0) {
+        LOG(ERROR) << "Open page crc failed."
+                   << " filepath = " << crcPath;
+        return CSErrorCode::InternalError;
+    }
+    int rc = lfs_->Write(fd, content.data(), 0, content.size());
+    lfs_->Close(fd);
+    if (rc != static_cast<int>(content.size())) {
+        LOG(ERROR) << "Write page crc failed."
+                   << " filepath = " << crcPath;
+        return CSErrorCode::InternalError;
+    }
+    pageCrc_->MarkPersisted();
     return CSErrorCode::Success;
 }
 
@@ -600,19 +774,22 @@ CSErrorCode CSChunkFile::ReadSpecifiedChunk(SequenceNum sn,
     CSErrorCode errorCode = CSErrorCode::Success;
     off_t readOff;
     size_t readSize;
-    // For uncopied extents, read chunk data
+    // For uncopied extents, read chunk data, all extents are submitted
+    // in one batch so that they can be in flight at the same time
+    std::vector<AioRequest> requests;
+    requests.reserve(uncopiedRange.size());
     for (auto& range : uncopiedRange) {
         readOff = range.beginIndex * pageSize_;
         readSize = (range.endIndex - range.beginIndex + 1) * pageSize_;
-        int rc = readData(buf + (readOff - offset),
-                          readOff,
-                          readSize);
-        if (rc < 0) {
-            LOG(ERROR) << "Read chunk file failed. "
-                       << "ChunkID: " << chunkId_
-                       << ", chunk sn: " << metaPage_.sn;
-            return CSErrorCode::InternalError;
-        }
+        requests.emplace_back(AioOpType::READ, fd_,
+                              buf + (readOff - offset),
+                              readOff + pageSize_, readSize);
+    }
+    if (lfs_->SubmitBatch(&requests) < 0) {
+        LOG(ERROR) << "Read chunk file failed. "
+                   << "ChunkID: " << chunkId_
+                   << ", chunk sn: " << metaPage_.sn;
+        return CSErrorCode::InternalError;
     }
     // For the copied range, read the snapshot data
     for (auto& range : copiedRange) {
@@ -664,6 +841,14 @@ CSErrorCode CSChunkFile::Delete(SequenceNum sn)  {
         lfs_->Close(fd_);
         fd_ = -1;
     }
+    // Delete the page crc first, otherwise it may be left to a new chunk
+    if (pageCrc_ != nullptr && lfs_->FileExists(pageCrcPath())) {
+        if (lfs_->Delete(pageCrcPath()) < 0) {
+            LOG(ERROR) << "Delete page crc failed."
+                       << "ChunkID: " << chunkId_;
+            return CSErrorCode::InternalError;
+        }
+    }
     int ret = chunkFilePool_->RecycleFile(path());
     if (ret < 0)
         return CSErrorCode::InternalError;
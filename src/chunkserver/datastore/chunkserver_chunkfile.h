@@ -37,6 +37,7 @@
 #include "src/common/crc32.h"
 #include "src/fs/local_filesystem.h"
 #include "src/chunkserver/datastore/filename_operator.h"
+#include "src/chunkserver/datastore/chunkserver_page_crc.h"
 #include "src/chunkserver/datastore/chunkserver_snapshot.h"
 #include "src/chunkserver/datastore/define.h"
 #include "src/chunkserver/datastore/file_pool.h"
@@ -47,6 +48,8 @@ namespace curve {
 namespace chunkserver {
 
 using curve::fs::LocalFileSystem;
+using curve::fs::AioRequest;
+using curve::fs::AioOpType;
 using curve::common::RWLock;
 using curve::common::WriteLockGuard;
 using curve::common::ReadLockGuard;
@@ -109,6 +112,10 @@ struct ChunkOptions {
     PageSizeType    pageSize;
     // enable O_DSYNC When Open ChunkFile
     bool enableOdsyncWhenOpenChunkFile;
+    // record the crc of every page
+    bool enablePageCrc;
+    // verify the data read with the recorded page crc
+    bool verifyPageCrcOnRead;
     // datastore internal statistical metric
     std::shared_ptr<DataStoreMetric> metric;
 
@@ -119,6 +126,9 @@ struct ChunkOptions {
                    , location("")
                    , chunkSize(0)
                    , pageSize(0)
+                   , enableOdsyncWhenOpenChunkFile(false)
+                   , enablePageCrc(false)
+                   , verifyPageCrcOnRead(false)
                    , metric(nullptr) {}
 };
 
@@ -192,6 +202,26 @@ class CSChunkFile {
      */
     CSErrorCode Read(char * buf, off_t offset, size_t length);
 
+    /**
+     * Calculate the crc of the range for the consistency scan, which is the
+     * crc32c of the data, combined from the crc of every page. With page crc
+     * enabled, only the pages written since last scan are read to verify
+     * the recorded crc
+     * Add read lock, the page crc is modified under pageCrcLock_
+     * @param offset: the starting offset of the range, page aligned
+     * @param length: the length of the range, page aligned
+     * @param crc[out]: the crc of the range
+     * @return: return error code
+     */
+    CSErrorCode ScanPageCrc(off_t offset, size_t length, uint32_t* crc);
+
+    /**
+     * Persist the page crc if modified, the writes after it are recovered
+     * by replaying the raft log
+     * @return: return error code
+     */
+    CSErrorCode PersistPageCrc();
+
     /**
      * Read chunk meta data
      * There may be concurrency, add read lock
@@ -301,12 +331,29 @@ class CSChunkFile {
      * to a normal chunk
      */
     CSErrorCode flush();
+    /**
+     * Verify the data read with the page crc, called with the read lock
+     */
+    bool verifyPageCrc(const char* buf, off_t offset, size_t length);
 
     inline string path() {
         return baseDir_ + "/" +
                     FileNameOperator::GenerateChunkFileName(chunkId_);
     }
 
+    inline string pageCrcPath() {
+        return baseDir_ + "/" +
+                    FileNameOperator::GeneratePageCrcFileName(chunkId_);
+    }
+
+    /**
+     * Load the persisted page crc, if it doesn't exist or is broken,
+     * all pages are unknown and read by the next scan
+     * @param newFile: the chunk file is just created, the page crc left
+     *                 is stale
+     */
+    void loadPageCrc(bool newFile);
+
     inline uint32_t fileSize() {
         return pageSize_ + size_;
     }
@@ -407,6 +454,15 @@ class CSChunkFile {
     std::shared_ptr<DataStoreMetric> metric_;
     // enable O_DSYNC When Open ChunkFile
     bool enableOdsyncWhenOpenChunkFile_;
+    // record the crc of every page
+    bool enablePageCrc_;
+    // verify the data read with the recorded page crc
+    bool verifyPageCrcOnRead_;
+    // nullptr if page crc is disabled
+    std::unique_ptr<ChunkPageCrc> pageCrc_;
+    // protect the page crc among the holders of the read lock of rwLock_,
+    // the holder of the write lock can modify it without this lock
+    RWLock pageCrcLock_;
 };
 }  // namespace chunkserver
 }  // namespace curve
@@ -43,10 +43,17 @@ CSDataStore::CSDataStore(std::shared_ptr<LocalFileSystem> lfs,
       locationLimit_(options.locationLimit),
       chunkFilePool_(chunkFilePool),
       lfs_(lfs),
-      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile) {
+      enableOdsyncWhenOpenChunkFile_(options.enableOdsyncWhenOpenChunkFile),
+      enablePageCrc_(options.enablePageCrc),
+      verifyPageCrcOnRead_(options.verifyPageCrcOnRead),
+      deferredWriteMinSize_(options.deferredWriteMinSize),
+      deferredWriteMaxBytes_(options.deferredWriteMaxBytes),
+      deferredWriteReader_(options.deferredWriteReader) {
     CHECK(!baseDir_.empty()) << "Create datastore failed";
     CHECK(lfs_ != nullptr) << "Create datastore failed";
     CHECK(chunkFilePool_ != nullptr) << "Create datastore failed";
+    CHECK(deferredWriteMinSize_ == 0 || deferredWriteReader_)
+        << "Create datastore failed";
 }
 
 CSDataStore::~CSDataStore() {
@@ -71,6 +78,14 @@ bool CSDataStore::Initialize() {
 
     // If loaded before, reload here
     metaCache_.Clear();
+    {
+        // deferred writes are before the loaded snapshot or will be
+        // recorded again by replaying the raft log
+        std::lock_guard<std::mutex> lk(deferredMtx_);
+        deferredChunks_.clear();
+        deferredBytes_ = 0;
+        mergedChunks_.clear();
+    }
     metric_ = std::make_shared<DataStoreMetric>();
     for (size_t i = 0; i < files.size(); ++i) {
         FileNameOperator::FileInfo info =
@@ -105,6 +120,15 @@ bool CSDataStore::Initialize() {
                 LOG(ERROR) << "Load snapshot failed.";
                 return false;
             }
+        } else if (info.type == FileNameOperator::FileType::PAGE_CRC) {
+            // Loaded with the chunk file. The page crc is not updated while
+            // disabled, and the one without chunk is left by deleting chunk
+            string chunkFilePath = baseDir_ + "/" +
+                        FileNameOperator::GenerateChunkFileName(info.id);
+            if (!enablePageCrc_ || !lfs_->FileExists(chunkFilePath)) {
+                LOG(INFO) << "Delete stale page crc: " << files[i];
+                lfs_->Delete(baseDir_ + "/" + files[i]);
+            }
         } else {
             LOG(WARNING) << "Unknown file: " << files[i];
         }
@@ -114,9 +138,13 @@ bool CSDataStore::Initialize() {
 }
 
 CSErrorCode CSDataStore::DeleteChunk(ChunkID id, SequenceNum sn) {
+    CSErrorCode errorCode = MergeDeferredWrites(id);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
     auto chunkFile = metaCache_.Get(id);
     if (chunkFile != nullptr) {
-        CSErrorCode errorCode = chunkFile->Delete(sn);
+        errorCode = chunkFile->Delete(sn);
         if (errorCode != CSErrorCode::Success) {
             LOG(WARNING) << "Delete chunk file failed."
                          << "ChunkID = " << id;
@@ -129,9 +157,13 @@ CSErrorCode CSDataStore::DeleteChunk(ChunkID id, SequenceNum sn) {
 
 CSErrorCode CSDataStore::DeleteSnapshotChunkOrCorrectSn(
     ChunkID id, SequenceNum correctedSn) {
+    CSErrorCode errorCode = MergeDeferredWrites(id);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
     auto chunkFile = metaCache_.Get(id);
     if (chunkFile != nullptr) {
-        CSErrorCode errorCode = chunkFile->DeleteSnapshotOrCorrectSn(correctedSn);  // NOLINT
+        errorCode = chunkFile->DeleteSnapshotOrCorrectSn(correctedSn);
         if (errorCode != CSErrorCode::Success) {
             LOG(WARNING) << "Delete snapshot chunk or correct sn failed."
                          << "ChunkID = " << id
@@ -147,12 +179,16 @@ CSErrorCode CSDataStore::ReadChunk(ChunkID id,
                                    char * buf,
                                    off_t offset,
                                    size_t length) {
+    CSErrorCode errorCode = MergeDeferredWrites(id);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
     auto chunkFile = metaCache_.Get(id);
     if (chunkFile == nullptr) {
         return CSErrorCode::ChunkNotExistError;
     }
 
-    CSErrorCode errorCode = chunkFile->Read(buf, offset, length);
+    errorCode = chunkFile->Read(buf, offset, length);
     if (errorCode != CSErrorCode::Success) {
         LOG(WARNING) << "Read chunk file failed."
                      << "ChunkID = " << id;
@@ -182,12 +218,15 @@ CSErrorCode CSDataStore::ReadSnapshotChunk(ChunkID id,
                                            char * buf,
                                            off_t offset,
                                            size_t length) {
+    CSErrorCode errorCode = MergeDeferredWrites(id);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
     auto chunkFile = metaCache_.Get(id);
     if (chunkFile == nullptr) {
         return CSErrorCode::ChunkNotExistError;
     }
-    CSErrorCode errorCode =
-        chunkFile->ReadSpecifiedChunk(sn, buf, offset, length);
+    errorCode = chunkFile->ReadSpecifiedChunk(sn, buf, offset, length);
     if (errorCode != CSErrorCode::Success) {
         LOG(WARNING) << "Read snapshot chunk failed."
                      << "ChunkID = " << id;
@@ -251,17 +290,24 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
         options.pageSize = pageSize_;
         options.metric = metric_;
         options.enableOdsyncWhenOpenChunkFile = enableOdsyncWhenOpenChunkFile_;
+        options.enablePageCrc = enablePageCrc_;
+        options.verifyPageCrcOnRead = verifyPageCrcOnRead_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
             return errorCode;
         }
     }
+    // Keep the order with the deferred writes of this chunk
+    CSErrorCode errorCode = MergeDeferredWrites(id);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
     // write chunk file
-    CSErrorCode errorCode = chunkFile->Write(sn,
-                                             buf,
-                                             offset,
-                                             length,
-                                             cost);
+    errorCode = chunkFile->Write(sn,
+                                 buf,
+                                 offset,
+                                 length,
+                                 cost);
     if (errorCode != CSErrorCode::Success) {
         LOG(WARNING) << "Write chunk file failed."
                      << "ChunkID = " << id;
@@ -270,6 +316,187 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
     return CSErrorCode::Success;
 }
 
+CSErrorCode CSDataStore::WriteLoggedChunk(
+    ChunkID id, SequenceNum sn, const butil::IOBuf& buf, off_t offset,
+    size_t length, uint64_t index, uint32_t* cost,
+    const std::string& cloneSourceLocation) {
+    if (deferredWriteMinSize_ > 0 && sn != kInvalidSeq) {
+        auto chunkFile = metaCache_.Get(id);
+        if (chunkFile != nullptr &&
+            CanDeferWrite(chunkFile, sn, offset, length,
+                          cloneSourceLocation)) {
+            // The data is already persisted in the raft log, write it into
+            // the chunk file later, or never if it is overwritten before that
+            if (DeferWrite(id, sn, offset, length, index)) {
+                return FlushDeferredWrites();
+            }
+            return CSErrorCode::Success;
+        }
+    }
+    return WriteChunk(id, sn, buf, offset, length, cost, cloneSourceLocation);
+}
+
+bool CSDataStore::CanDeferWrite(const CSChunkFilePtr& chunkFile,
+                                SequenceNum sn,
+                                off_t offset,
+                                size_t length,
+                                const std::string& cloneSourceLocation) {
+    if (length < deferredWriteMinSize_) {
+        return false;
+    }
+    if (!cloneSourceLocation.empty()
+        || offset < 0
+        || offset % pageSize_ != 0
+        || length % pageSize_ != 0
+        || offset + length > chunkSize_) {
+        return false;
+    }
+    // Writes that create snapshot, copy on write, update sn or bitmap of
+    // the chunk go through the chunk file directly
+    CSChunkInfo info;
+    chunkFile->GetInfo(&info);
+    return !info.isClone
+        && info.snapSn == 0
+        && sn == info.curSn
+        && sn >= info.correctedSn;
+}
+
+bool CSDataStore::DeferWrite(ChunkID id,
+                             SequenceNum sn,
+                             off_t offset,
+                             size_t length,
+                             uint64_t index) {
+    std::lock_guard<std::mutex> lk(deferredMtx_);
+    auto& chunk = deferredChunks_[id];
+    if (chunk == nullptr) {
+        chunk = std::make_shared<DeferredChunk>();
+    }
+    chunk->sn = sn;
+    // The writes covered by this one will never reach the chunk file
+    for (auto it = chunk->writes.begin(); it != chunk->writes.end();) {
+        if (it->offset >= offset
+            && it->offset + it->length <= offset + length) {
+            deferredBytes_ -= it->length;
+            it = chunk->writes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    chunk->writes.push_back({offset, length, index});
+    deferredBytes_ += length;
+    return deferredWriteMaxBytes_ > 0
+        && deferredBytes_ > deferredWriteMaxBytes_;
+}
+
+CSErrorCode CSDataStore::MergeDeferredWrites(ChunkID id) {
+    if (deferredWriteMinSize_ == 0) {
+        return CSErrorCode::Success;
+    }
+    std::shared_ptr<DeferredChunk> chunk;
+    {
+        std::lock_guard<std::mutex> lk(deferredMtx_);
+        auto iter = deferredChunks_.find(id);
+        if (iter == deferredChunks_.end()) {
+            return CSErrorCode::Success;
+        }
+        chunk = iter->second;
+    }
+
+    std::lock_guard<std::mutex> mergeLk(chunk->mergeMtx);
+    std::list<DeferredWrite> writes;
+    SequenceNum sn;
+    {
+        std::lock_guard<std::mutex> lk(deferredMtx_);
+        writes.swap(chunk->writes);
+        sn = chunk->sn;
+    }
+
+    CSErrorCode errorCode = CSErrorCode::Success;
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile == nullptr) {
+        LOG(ERROR) << "Merge deferred writes failed, chunk not exists."
+                   << "ChunkID = " << id;
+        errorCode = CSErrorCode::ChunkNotExistError;
+    }
+    auto iter = writes.begin();
+    while (errorCode == CSErrorCode::Success && iter != writes.end()) {
+        // coalesce the adjacent writes into one
+        off_t offset = iter->offset;
+        size_t length = 0;
+        butil::IOBuf data;
+        auto end = iter;
+        for (; end != writes.end()
+             && end->offset == static_cast<off_t>(offset + length); ++end) {
+            butil::IOBuf piece;
+            if (!deferredWriteReader_(end->index, &piece)
+                || piece.length() != end->length) {
+                LOG(ERROR) << "Read deferred write from raft log failed."
+                           << "ChunkID = " << id
+                           << ", index = " << end->index;
+                errorCode = CSErrorCode::InternalError;
+                break;
+            }
+            data.append(piece);
+            length += end->length;
+        }
+        if (errorCode == CSErrorCode::Success) {
+            errorCode = chunkFile->Write(sn, data, offset, length, nullptr);
+        }
+        if (errorCode != CSErrorCode::Success) {
+            LOG(ERROR) << "Merge deferred writes failed."
+                       << "ChunkID = " << id
+                       << ", offset = " << offset
+                       << ", length = " << length;
+            break;
+        }
+        iter = end;
+    }
+
+    bool merged = iter != writes.begin();
+    std::lock_guard<std::mutex> lk(deferredMtx_);
+    for (auto it = writes.begin(); it != iter; ++it) {
+        deferredBytes_ -= it->length;
+    }
+    // The failed writes are kept in order before the ones deferred meanwhile
+    chunk->writes.splice(chunk->writes.begin(), writes, iter, writes.end());
+    auto it = deferredChunks_.find(id);
+    if (it != deferredChunks_.end() && it->second == chunk
+        && chunk->writes.empty()) {
+        deferredChunks_.erase(it);
+    }
+    if (merged && !enableOdsyncWhenOpenChunkFile_) {
+        mergedChunks_.push_back(id);
+    }
+    return errorCode;
+}
+
+CSErrorCode CSDataStore::FlushDeferredWrites() {
+    if (deferredWriteMinSize_ == 0) {
+        return CSErrorCode::Success;
+    }
+    std::vector<ChunkID> chunks;
+    {
+        std::lock_guard<std::mutex> lk(deferredMtx_);
+        chunks.reserve(deferredChunks_.size());
+        for (const auto& chunk : deferredChunks_) {
+            chunks.push_back(chunk.first);
+        }
+    }
+    for (ChunkID id : chunks) {
+        CSErrorCode errorCode = MergeDeferredWrites(id);
+        if (errorCode != CSErrorCode::Success) {
+            return errorCode;
+        }
+    }
+    return CSErrorCode::Success;
+}
+
+void CSDataStore::TakeMergedChunks(std::vector<ChunkID>* chunks) {
+    std::lock_guard<std::mutex> lk(deferredMtx_);
+    chunks->insert(chunks->end(), mergedChunks_.begin(), mergedChunks_.end());
+    mergedChunks_.clear();
+}
+
 CSErrorCode CSDataStore::SyncChunk(ChunkID id) {
     auto chunkFile = metaCache_.Get(id);
     if (chunkFile == nullptr) {
@@ -314,6 +541,8 @@ CSErrorCode CSDataStore::CreateCloneChunk(ChunkID id,
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
         options.metric = metric_;
+        options.enablePageCrc = enablePageCrc_;
+        options.verifyPageCrcOnRead = verifyPageCrcOnRead_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
             return errorCode;
@@ -347,6 +576,10 @@ CSErrorCode CSDataStore::PasteChunk(ChunkID id,
                                     const char * buf,
                                     off_t offset,
                                     size_t length) {
+    CSErrorCode errorCode = MergeDeferredWrites(id);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
     auto chunkFile = metaCache_.Get(id);
     // Paste Chunk requires Chunk must exist
     if (chunkFile == nullptr) {
@@ -379,6 +612,10 @@ CSErrorCode CSDataStore::GetChunkHash(ChunkID id,
                                       off_t offset,
                                       size_t length,
                                       std::string* hash) {
+    CSErrorCode errorCode = MergeDeferredWrites(id);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
     auto chunkFile = metaCache_.Get(id);
     if (chunkFile == nullptr) {
         LOG(INFO) << "Get ChunkHash failed, Chunk not exists."
@@ -388,6 +625,40 @@ CSErrorCode CSDataStore::GetChunkHash(ChunkID id,
     return chunkFile->GetHash(offset, length, hash);
 }
 
+CSErrorCode CSDataStore::ScanChunk(ChunkID id,
+                                   off_t offset,
+                                   size_t length,
+                                   uint32_t* crc) {
+    CSErrorCode errorCode = MergeDeferredWrites(id);
+    if (errorCode != CSErrorCode::Success) {
+        return errorCode;
+    }
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile == nullptr) {
+        return CSErrorCode::ChunkNotExistError;
+    }
+    errorCode = chunkFile->ScanPageCrc(offset, length, crc);
+    if (errorCode != CSErrorCode::Success) {
+        LOG(WARNING) << "Scan chunk file failed."
+                     << "ChunkID = " << id;
+    }
+    return errorCode;
+}
+
+void CSDataStore::PersistPageCrcs() {
+    if (!enablePageCrc_) {
+        return;
+    }
+    ChunkMap chunkMap = metaCache_.GetMap();
+    for (auto& chunk : chunkMap) {
+        CSErrorCode errorCode = chunk.second->PersistPageCrc();
+        // The pages are scanned again if it is not persisted
+        LOG_IF(WARNING, errorCode != CSErrorCode::Success)
+            << "Persist page crc failed."
+            << "ChunkID = " << chunk.first;
+    }
+}
+
 DataStoreStatus CSDataStore::GetStatus() {
     DataStoreStatus status;
     status.chunkFileCount = metric_->chunkFileCount.get_value();
@@ -406,6 +677,8 @@ CSErrorCode CSDataStore::loadChunkFile(ChunkID id) {
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
         options.metric = metric_;
+        options.enablePageCrc = enablePageCrc_;
+        options.verifyPageCrcOnRead = verifyPageCrcOnRead_;
         CSChunkFilePtr chunkFilePtr =
             std::make_shared<CSChunkFile>(lfs_,
                                           chunkFilePool_,
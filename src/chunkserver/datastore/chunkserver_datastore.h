@@ -26,6 +26,9 @@
 #include <bvar/bvar.h>
 #include <glog/logging.h>
 #include <butil/iobuf.h>
+#include <functional>
+#include <list>
+#include <mutex>  // NOLINT
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -48,11 +51,28 @@ using CSChunkFilePtr = std::shared_ptr<CSChunkFile>;
 
 inline void TrivialDeleter(void* ptr) {}
 
+/**
+ * Read the data of a deferred write back from the raft log
+ * @param index: the index of the log entry holding the write
+ * @param data[out]: the data of the write
+ * @return: return true on success
+ */
+using DeferredWriteReader =
+    std::function<bool(uint64_t index, butil::IOBuf* data)>;
+
 /**
  * DataStore configuration parameters
  * baseDir: Directory path managed by DataStore
  * chunkSize: The size of the chunk file or snapshot file in the DataStore
  * pageSize: the size of the smallest read-write unit
+ * enablePageCrc: record the crc of every page to make the scan incremental
+ * verifyPageCrcOnRead: verify the data read with the recorded page crc
+ * deferredWriteMinSize: page aligned overwrites not smaller than this only
+ *                       record the index of the raft log entry holding the
+ *                       data and are merged into the chunk file later,
+ *                       0 means disabled
+ * deferredWriteMaxBytes: merge all deferred writes when exceeding this
+ * deferredWriteReader: read the data of deferred writes from the raft log
  */
 struct DataStoreOptions {
     std::string                         baseDir;
@@ -60,6 +80,11 @@ struct DataStoreOptions {
     PageSizeType                        pageSize;
     uint32_t                            locationLimit;
     bool                                enableOdsyncWhenOpenChunkFile;
+    bool                                enablePageCrc = false;
+    bool                                verifyPageCrcOnRead = false;
+    uint32_t                            deferredWriteMinSize = 0;
+    uint64_t                            deferredWriteMaxBytes = 0;
+    DeferredWriteReader                 deferredWriteReader;
 };
 
 /**
@@ -237,9 +262,57 @@ class CSDataStore {
                                 uint32_t* cost,
                                 const std::string & cloneSourceLocation = "");
 
+    /**
+     * Write data which is already persisted in the raft log entry at index.
+     * A large page aligned overwrite of an existing chunk only records the
+     * index, the data is read back from the raft log and written into the
+     * chunk file later, and never if it is overwritten before that. The
+     * other writes are the same as WriteChunk
+     * @param index: the index of the raft log entry holding the write
+     * other params are the same as WriteChunk
+     * @return: return error code
+     */
+    virtual CSErrorCode WriteLoggedChunk(
+        ChunkID id, SequenceNum sn, const butil::IOBuf& buf, off_t offset,
+        size_t length, uint64_t index, uint32_t* cost,
+        const std::string& cloneSourceLocation = "");
 
     virtual CSErrorCode SyncChunk(ChunkID id);
 
+    /**
+     * Merge all deferred writes into chunk files, called before the raft
+     * snapshot, after which the log entries holding the data are truncated
+     * @return: return error code
+     */
+    virtual CSErrorCode FlushDeferredWrites();
+
+    /**
+     * Get the chunks written by merging deferred writes since last call,
+     * they need to be synced like the chunks written directly
+     * @param chunks[out]: the merged chunk ids
+     */
+    virtual void TakeMergedChunks(std::vector<ChunkID>* chunks);
+
+    /**
+     * Calculate the crc of the chunk range for the consistency scan,
+     * see CSChunkFile::ScanPageCrc
+     * @param id: the chunk id to be scanned
+     * @param offset: the starting offset of the range, page aligned
+     * @param length: the length of the range, page aligned
+     * @param crc[out]: the crc of the range
+     * @return: return error code
+     */
+    virtual CSErrorCode ScanChunk(ChunkID id,
+                                  off_t offset,
+                                  size_t length,
+                                  uint32_t* crc);
+
+    /**
+     * Persist the modified page crc of all chunks, called at raft snapshot,
+     * the writes after it are recorded again by replaying the raft log
+     */
+    virtual void PersistPageCrcs();
+
 
     // Deprecated, only use for unit & integration test
     virtual CSErrorCode WriteChunk(
@@ -316,6 +389,44 @@ class CSDataStore {
     CSErrorCode CreateChunkFile(const ChunkOptions & ops,
                                 CSChunkFilePtr* chunkFile);
 
+    // A write whose data is only in the raft log entry at index
+    struct DeferredWrite {
+        off_t offset;
+        size_t length;
+        uint64_t index;
+    };
+
+    struct DeferredChunk {
+        // serialize the merges of the chunk to keep the write order
+        std::mutex mergeMtx;
+        // all deferred writes of a chunk have the same sn, writes that
+        // change the sn of chunk are not deferred
+        SequenceNum sn = 0;
+        // protected by deferredMtx_, in apply order
+        std::list<DeferredWrite> writes;
+    };
+
+    /**
+     * Whether the write can be deferred, only the plain overwrite of an
+     * existing chunk is deferred, which doesn't change the chunk metadata
+     */
+    bool CanDeferWrite(const CSChunkFilePtr& chunkFile, SequenceNum sn,
+                       off_t offset, size_t length,
+                       const std::string& cloneSourceLocation);
+
+    /**
+     * Record the write without writing the chunk file
+     * @return: true if deferred writes exceed the limit and need to merge
+     */
+    bool DeferWrite(ChunkID id, SequenceNum sn, off_t offset, size_t length,
+                    uint64_t index);
+
+    /**
+     * Write the deferred writes of the chunk into the chunk file, must be
+     * called before any other operation on the chunk
+     */
+    CSErrorCode MergeDeferredWrites(ChunkID id);
+
  private:
     // The size of each chunk
     ChunkSizeType chunkSize_;
@@ -336,6 +447,21 @@ class CSDataStore {
     DataStoreMetricPtr metric_;
     // enable O_DSYNC When Open ChunkFile
     bool enableOdsyncWhenOpenChunkFile_;
+    // record the crc of every page
+    bool enablePageCrc_ = false;
+    // verify the data read with the recorded page crc
+    bool verifyPageCrcOnRead_ = false;
+    // 0 means write deferring is disabled
+    uint32_t deferredWriteMinSize_ = 0;
+    uint64_t deferredWriteMaxBytes_ = 0;
+    DeferredWriteReader deferredWriteReader_;
+    // Only the log index of deferred writes is kept, if chunkserver restarts
+    // before merging, they are recorded again by replaying the raft log
+    std::mutex deferredMtx_;
+    std::unordered_map<ChunkID, std::shared_ptr<DeferredChunk>>
+        deferredChunks_;
+    uint64_t deferredBytes_ = 0;
+    std::vector<ChunkID> mergedChunks_;
 };
 
 }  // namespace chunkserver
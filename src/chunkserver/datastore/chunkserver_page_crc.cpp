@@ -0,0 +1,282 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "src/chunkserver/datastore/chunkserver_page_crc.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "src/common/crc32.h"
+
+namespace curve {
+namespace chunkserver {
+
+namespace {
+
+const uint32_t kPageCrcMagic = 0x50435243;  // "PCRC"
+const uint8_t kPageCrcVersion = 1;
+const size_t kPageCrcHeaderSize = 16;
+// reversed polynomial of crc32c
+const uint32_t kCrc32cPoly = 0x82F63B78;
+
+// Multiply the vector by the GF(2) matrix, as crc32_combine of zlib
+uint32_t Gf2MatrixTimes(const uint32_t* mat, uint32_t vec) {
+    uint32_t sum = 0;
+    while (vec) {
+        if (vec & 1) {
+            sum ^= *mat;
+        }
+        vec >>= 1;
+        mat++;
+    }
+    return sum;
+}
+
+void Gf2MatrixSquare(uint32_t* square, const uint32_t* mat) {
+    for (int n = 0; n < 32; n++) {
+        square[n] = Gf2MatrixTimes(mat, mat[n]);
+    }
+}
+
+// The operator appending len zero bytes to the data of a crc
+void Crc32cShiftOperator(size_t len, uint32_t* op) {
+    uint32_t odd[32];
+    uint32_t even[32];
+    // operator for one zero bit
+    odd[0] = kCrc32cPoly;
+    uint32_t row = 1;
+    for (int n = 1; n < 32; n++) {
+        odd[n] = row;
+        row <<= 1;
+    }
+    // two and four zero bits
+    Gf2MatrixSquare(even, odd);
+    Gf2MatrixSquare(odd, even);
+    // identity
+    for (int n = 0; n < 32; n++) {
+        op[n] = 1u << n;
+    }
+    // apply the operators of one zero byte, two, four ... by the bits of len
+    uint32_t tmp[32];
+    while (len > 0) {
+        Gf2MatrixSquare(even, odd);
+        if (len & 1) {
+            for (int n = 0; n < 32; n++) {
+                tmp[n] = Gf2MatrixTimes(even, op[n]);
+            }
+            memcpy(op, tmp, sizeof(tmp));
+        }
+        len >>= 1;
+        if (len == 0) {
+            break;
+        }
+        Gf2MatrixSquare(odd, even);
+        if (len & 1) {
+            for (int n = 0; n < 32; n++) {
+                tmp[n] = Gf2MatrixTimes(odd, op[n]);
+            }
+            memcpy(op, tmp, sizeof(tmp));
+        }
+        len >>= 1;
+    }
+}
+
+}  // namespace
+
+ChunkPageCrc::ChunkPageCrc(ChunkSizeType chunkSize, PageSizeType pageSize)
+    : pageSize_(pageSize),
+      pageCount_(chunkSize / pageSize),
+      crcs_(pageCount_, 0),
+      valid_(pageCount_),
+      scanned_(pageCount_),
+      dirty_(true) {
+    Crc32cShiftOperator(pageSize_, pageShift_);
+}
+
+void ChunkPageCrc::Invalidate(uint32_t index) {
+    valid_.Clear(index);
+    scanned_.Clear(index);
+}
+
+void ChunkPageCrc::UpdateBlock(const char* buf, size_t length, off_t offset,
+                               off_t* pos, uint32_t* crc) {
+    while (length > 0) {
+        size_t step = std::min<size_t>(length, pageSize_ - *pos % pageSize_);
+        *crc = ::curve::common::CRC32(*crc, buf, step);
+        buf += step;
+        length -= step;
+        *pos += step;
+        if (*pos % pageSize_ == 0) {
+            uint32_t index = (*pos - 1) / pageSize_;
+            // the head page is partially written
+            if (*pos - pageSize_ >= offset) {
+                crcs_[index] = *crc;
+                valid_.Set(index);
+                scanned_.Clear(index);
+            } else {
+                Invalidate(index);
+            }
+            *crc = 0;
+        }
+    }
+}
+
+void ChunkPageCrc::Update(const butil::IOBuf& buf,
+                          off_t offset,
+                          size_t length) {
+    off_t pos = offset;
+    uint32_t crc = 0;
+    size_t left = length;
+    for (size_t i = 0; i < buf.backing_block_num() && left > 0; ++i) {
+        butil::StringPiece block = buf.backing_block(i);
+        size_t n = std::min(block.size(), left);
+        UpdateBlock(block.data(), n, offset, &pos, &crc);
+        left -= n;
+    }
+    // the tail page is partially written
+    if (pos % pageSize_ != 0) {
+        Invalidate(pos / pageSize_);
+    }
+    dirty_ = true;
+}
+
+void ChunkPageCrc::Update(const char* buf, off_t offset, size_t length) {
+    off_t pos = offset;
+    uint32_t crc = 0;
+    UpdateBlock(buf, length, offset, &pos, &crc);
+    if (pos % pageSize_ != 0) {
+        Invalidate(pos / pageSize_);
+    }
+    dirty_ = true;
+}
+
+bool ChunkPageCrc::Verify(const char* buf, off_t offset, size_t length) const {
+    uint32_t beginIndex = (offset + pageSize_ - 1) / pageSize_;
+    uint32_t endIndex = (offset + length) / pageSize_;
+    for (uint32_t i = beginIndex; i < endIndex; ++i) {
+        if (!valid_.Test(i)) {
+            continue;
+        }
+        const char* page = buf + (static_cast<off_t>(i) * pageSize_ - offset);
+        if (::curve::common::CRC32(page, pageSize_) != crcs_[i]) {
+            LOG(ERROR) << "Page crc mismatch, page index: " << i;
+            return false;
+        }
+    }
+    return true;
+}
+
+void ChunkPageCrc::GetUnscannedRanges(uint32_t beginIndex,
+                                      uint32_t endIndex,
+                                      std::vector<BitRange>* ranges) const {
+    scanned_.Divide(beginIndex, endIndex, ranges, nullptr);
+}
+
+uint32_t ChunkPageCrc::Scan(const char* buf,
+                            uint32_t beginIndex,
+                            uint32_t count) {
+    uint32_t mismatch = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t index = beginIndex + i;
+        uint32_t crc = ::curve::common::CRC32(buf + i * pageSize_, pageSize_);
+        if (valid_.Test(index) && crcs_[index] != crc) {
+            LOG(ERROR) << "Page crc mismatch, page index: " << index
+                       << ", recorded crc: " << crcs_[index]
+                       << ", crc on disk: " << crc;
+            ++mismatch;
+        }
+        // record what is on disk, so that the mismatch is reported
+        // by the scan of the replicas
+        crcs_[index] = crc;
+        valid_.Set(index);
+        scanned_.Set(index);
+    }
+    dirty_ = true;
+    return mismatch;
+}
+
+uint32_t ChunkPageCrc::RangeCrc(uint32_t beginIndex,
+                                uint32_t endIndex) const {
+    uint32_t crc = crcs_[beginIndex];
+    for (uint32_t i = beginIndex + 1; i <= endIndex; ++i) {
+        crc = Gf2MatrixTimes(pageShift_, crc) ^ crcs_[i];
+    }
+    return crc;
+}
+
+void ChunkPageCrc::Encode(std::string* out) const {
+    size_t bitmapBytes = (pageCount_ + 8 - 1) >> 3;
+    size_t crcBytes = pageCount_ * sizeof(uint32_t);
+    out->assign(kPageCrcHeaderSize + crcBytes + 2 * bitmapBytes, 0);
+    char* buf = &(*out)[0];
+
+    char* body = buf + kPageCrcHeaderSize;
+    memcpy(body, crcs_.data(), crcBytes);
+    memcpy(body + crcBytes, valid_.GetBitmap(), bitmapBytes);
+    memcpy(body + crcBytes + bitmapBytes, scanned_.GetBitmap(), bitmapBytes);
+    uint32_t crc = ::curve::common::CRC32(body, out->size() -
+                                                kPageCrcHeaderSize);
+
+    memcpy(buf, &kPageCrcMagic, sizeof(kPageCrcMagic));
+    memcpy(buf + 4, &kPageCrcVersion, sizeof(kPageCrcVersion));
+    memcpy(buf + 8, &pageCount_, sizeof(pageCount_));
+    memcpy(buf + 12, &crc, sizeof(crc));
+}
+
+bool ChunkPageCrc::Decode(const std::string& in) {
+    size_t bitmapBytes = (pageCount_ + 8 - 1) >> 3;
+    size_t crcBytes = pageCount_ * sizeof(uint32_t);
+    if (in.size() != kPageCrcHeaderSize + crcBytes + 2 * bitmapBytes) {
+        LOG(WARNING) << "Invalid page crc size: " << in.size();
+        return false;
+    }
+    const char* buf = in.data();
+    uint32_t magic;
+    uint8_t version;
+    uint32_t pageCount;
+    uint32_t recordCrc;
+    memcpy(&magic, buf, sizeof(magic));
+    memcpy(&version, buf + 4, sizeof(version));
+    memcpy(&pageCount, buf + 8, sizeof(pageCount));
+    memcpy(&recordCrc, buf + 12, sizeof(recordCrc));
+    const char* body = buf + kPageCrcHeaderSize;
+    if (magic != kPageCrcMagic || version != kPageCrcVersion
+        || pageCount != pageCount_
+        || ::curve::common::CRC32(body, in.size() - kPageCrcHeaderSize)
+           != recordCrc) {
+        LOG(WARNING) << "Invalid page crc, magic: " << magic
+                     << ", version: " << static_cast<int>(version)
+                     << ", page count: " << pageCount;
+        return false;
+    }
+
+    memcpy(crcs_.data(), body, crcBytes);
+    valid_ = Bitmap(pageCount_, body + crcBytes);
+    scanned_ = Bitmap(pageCount_, body + crcBytes + bitmapBytes);
+    dirty_ = false;
+    return true;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
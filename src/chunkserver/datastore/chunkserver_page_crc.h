@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef SRC_CHUNKSERVER_DATASTORE_CHUNKSERVER_PAGE_CRC_H_
+#define SRC_CHUNKSERVER_DATASTORE_CHUNKSERVER_PAGE_CRC_H_
+
+#include <butil/iobuf.h>
+
+#include <string>
+#include <vector>
+
+#include "include/chunkserver/chunkserver_common.h"
+#include "src/common/bitmap.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::Bitmap;
+using curve::common::BitRange;
+
+/**
+ * The crc32c of every page of a chunk file, updated when the page is
+ * written, so that the scan only needs to read the pages written since the
+ * last scan to verify them, other pages are compared by the recorded crc.
+ *
+ * Every page is in one of the following states:
+ * unknown: the crc is not recorded, e.g. never written
+ * written: the crc is recorded when written, not verified with the disk
+ * scanned: the crc is verified with the data on disk
+ *
+ * Persisted format:
+ * magic: 4 bytes
+ * version: 1 byte
+ * padding: 3 bytes
+ * pageCount: 4 bytes
+ * crc: 4 bytes, the crc of the following content
+ * crcs: pageCount * 4 bytes
+ * valid bitmap: (pageCount + 7) / 8 bytes, the crc is recorded
+ * scanned bitmap: (pageCount + 7) / 8 bytes, the crc is verified
+ */
+class ChunkPageCrc {
+ public:
+    ChunkPageCrc(ChunkSizeType chunkSize, PageSizeType pageSize);
+
+    /**
+     * Record the crc of the pages fully covered by the written data, the
+     * pages partially covered become unknown
+     */
+    void Update(const butil::IOBuf& buf, off_t offset, size_t length);
+    void Update(const char* buf, off_t offset, size_t length);
+
+    /**
+     * Verify the data read with the recorded crc of the pages fully covered
+     * @return: false if any page doesn't match
+     */
+    bool Verify(const char* buf, off_t offset, size_t length) const;
+
+    /**
+     * Get the pages need to be read by scan, which are unknown or written
+     * after last scan
+     */
+    void GetUnscannedRanges(uint32_t beginIndex,
+                            uint32_t endIndex,
+                            std::vector<BitRange>* ranges) const;
+
+    /**
+     * Record the crc of the pages read by scan
+     * @return: the number of pages whose data on disk doesn't match the
+     *          crc recorded when written
+     */
+    uint32_t Scan(const char* buf, uint32_t beginIndex, uint32_t count);
+
+    /**
+     * The crc32c of the data of the range, combined from the crc of every
+     * page, so it is the same as the crc of the replica reading the whole
+     * range. All pages of the range must be scanned
+     */
+    uint32_t RangeCrc(uint32_t beginIndex, uint32_t endIndex) const;
+
+    void Encode(std::string* out) const;
+    bool Decode(const std::string& in);
+
+    // modified since last persisted
+    bool Dirty() const {
+        return dirty_;
+    }
+
+    void MarkPersisted() {
+        dirty_ = false;
+    }
+
+ private:
+    void UpdateBlock(const char* buf, size_t length, off_t offset,
+                     off_t* pos, uint32_t* crc);
+    void Invalidate(uint32_t index);
+
+ private:
+    // appending a page to the data maps its crc through this operator,
+    // crc(A + B) = shift(crc(A)) ^ crc(B), B is one page
+    uint32_t pageShift_[32];
+    PageSizeType pageSize_;
+    uint32_t pageCount_;
+    std::vector<uint32_t> crcs_;
+    Bitmap valid_;
+    Bitmap scanned_;
+    bool dirty_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_DATASTORE_CHUNKSERVER_PAGE_CRC_H_
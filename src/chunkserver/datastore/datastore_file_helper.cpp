@@ -49,6 +49,8 @@ int DatastoreFileHelper::ListFiles(const string& baseDir,
             if (snapFiles != nullptr) {
                 snapFiles->emplace_back(file);
             }
+        } else if (info.type == FileNameOperator::FileType::PAGE_CRC) {
+            continue;
         } else {
             LOG(WARNING) << "Unknown file: " << file;
         }
@@ -62,6 +64,12 @@ bool DatastoreFileHelper::IsSnapshotFile(const string& fileName) {
     return info.type == FileNameOperator::FileType::SNAPSHOT;
 }
 
+bool DatastoreFileHelper::IsPageCrcFile(const string& fileName) {
+    FileNameOperator::FileInfo info =
+            FileNameOperator::ParseFileName(fileName);
+    return info.type == FileNameOperator::FileType::PAGE_CRC;
+}
+
 bool DatastoreFileHelper::IsChunkFile(const string& fileName) {
     FileNameOperator::FileInfo info =
             FileNameOperator::ParseFileName(fileName);
@@ -71,6 +71,13 @@ class DatastoreFileHelper {
      */
     static bool IsSnapshotFile(const string& fileName);
 
+    /**
+     * Determine whether the file records the page crc of a chunk
+     * @param fileName: file name
+     * @return true-is a page crc file, false-not a page crc file
+     */
+    static bool IsPageCrcFile(const string& fileName);
+
     /**
      * Determine whether the file is a chunk file
      * @param fileName: file name
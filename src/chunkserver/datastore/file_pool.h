@@ -185,6 +185,13 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
      */
     virtual void UnInitialize();
 
+    /**
+     * Get the local filesystem used by the pool
+     */
+    virtual std::shared_ptr<LocalFileSystem> GetLocalFileSystem() {
+        return fsptr_;
+    }
+
     /**
      * Test use
      */
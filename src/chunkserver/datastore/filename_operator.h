@@ -40,6 +40,7 @@ class FileNameOperator {
     enum class FileType {
         CHUNK,
         SNAPSHOT,
+        PAGE_CRC,
         UNKNOWN,
     };
 
@@ -61,6 +62,10 @@ class FileNameOperator {
                 + "_snap_" + std::to_string(sn);
     }
 
+    static inline string GeneratePageCrcFileName(ChunkID id) {
+        return GenerateChunkFileName(id) + "_crc";
+    }
+
     static inline FileInfo ParseFileName(const string& fileName) {
         vector<string> elements;
         ::curve::common::SplitString(fileName, "_", &elements);
@@ -69,6 +74,7 @@ class FileNameOperator {
 
         // The format of the chunk file name is chunk_id
         // The format of snapshot file name is chunk_id_snap_sn
+        // The format of page crc file name is chunk_id_crc
         // Separate file names with "_" and parse file information
         // If the above format is not met, the file type is UNKNOWN
         if (elements.size() == 2
@@ -81,6 +87,11 @@ class FileNameOperator {
             info.id = std::stoull(elements[1]);
             info.sn = std::stoull(elements[3]);
             info.type = FileType::SNAPSHOT;
+        } else if (elements.size() == 3
+                   && elements[0].compare("chunk") == 0
+                   && elements[2].compare("crc") == 0) {
+            info.id = std::stoull(elements[1]);
+            info.type = FileType::PAGE_CRC;
         }
 
         return info;
@@ -0,0 +1,250 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <bthread/countdown_event.h>
+#include <fcntl.h>
+#include <string.h>
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <map>
+#include <utility>
+
+#include "src/chunkserver/datastore/sync_scheduler.h"
+#include "src/common/concurrent/count_down_event.h"
+#include "src/common/timeutility.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::CountDownEvent;
+using curve::common::TimeUtility;
+
+SyncScheduler::SyncScheduler()
+    : running_(false)
+    , syncfsFd_(-1)
+    , syncPoolSize_(0) {}
+
+SyncScheduler::~SyncScheduler() {
+    Fini();
+}
+
+int SyncScheduler::Init(const SyncSchedulerOptions& options) {
+    if (IsRunning()) {
+        return 0;
+    }
+    options_ = options;
+    if (options_.maxBatchSize == 0) {
+        options_.maxBatchSize = 1;
+    }
+
+    if (!options_.syncfsPath.empty() && options_.syncfsThreshold > 0) {
+        syncfsFd_ = ::open(options_.syncfsPath.c_str(),
+                           O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (syncfsFd_ < 0) {
+            LOG(ERROR) << "Open " << options_.syncfsPath
+                       << " for syncfs failed: " << strerror(errno);
+            return -1;
+        }
+    }
+
+    // 后台线程自己也会sync文件，线程池只需要补足剩下的并发度
+    syncPoolSize_ = options_.syncConcurrency > 1 ?
+                    options_.syncConcurrency - 1 : 0;
+    if (syncPoolSize_ > 0 && syncPool_.Start(syncPoolSize_) != 0) {
+        LOG(ERROR) << "Start sync thread pool failed, size: "
+                   << syncPoolSize_;
+        if (syncfsFd_ >= 0) {
+            ::close(syncfsFd_);
+            syncfsFd_ = -1;
+        }
+        return -1;
+    }
+
+    const std::string prefix = "chunkserver_sync_scheduler";
+    syncLatency_.expose(prefix, "lat");
+    batchSize_.expose(prefix, "batch_size");
+    batchFiles_.expose(prefix, "batch_files");
+    syncfsCount_.expose_as(prefix, "syncfs_count");
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&SyncScheduler::Run, this);
+    LOG(INFO) << "Sync scheduler started, max batch size: "
+              << options_.maxBatchSize
+              << ", max delay us: " << options_.maxDelayUs
+              << ", syncfs threshold: " << options_.syncfsThreshold
+              << ", syncfs path: " << options_.syncfsPath
+              << ", sync concurrency: " << options_.syncConcurrency;
+    return 0;
+}
+
+void SyncScheduler::Fini() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+        cond_.notify_all();
+    }
+    thread_.join();
+    syncPool_.Stop();
+    if (syncfsFd_ >= 0) {
+        ::close(syncfsFd_);
+        syncfsFd_ = -1;
+    }
+    LOG(INFO) << "Sync scheduler stopped.";
+}
+
+void SyncScheduler::Submit(const void* owner, uint64_t id,
+                           SyncFunc sync, DoneFunc done) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (IsRunning()) {
+            queue_.push_back(Request{owner, id, std::move(sync),
+                                     std::move(done)});
+            if (queue_.size() == 1 ||
+                queue_.size() >= options_.maxBatchSize) {
+                cond_.notify_one();
+            }
+            return;
+        }
+    }
+    // 调度器没有运行时直接同步执行
+    done(sync());
+}
+
+int SyncScheduler::SyncAndWait(const void* owner, uint64_t id,
+                               SyncFunc sync) {
+    bthread::CountdownEvent event(1);
+    int result = 0;
+    Submit(owner, id, std::move(sync), [&event, &result](int ret) {
+        result = ret;
+        event.signal();
+    });
+    event.wait();
+    return result;
+}
+
+void SyncScheduler::Run() {
+    std::vector<Request> batch;
+    batch.reserve(options_.maxBatchSize);
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk(mtx_);
+            cond_.wait(lk, [this]() {
+                return !queue_.empty() || !IsRunning();
+            });
+            if (queue_.empty()) {
+                // 已经停止且请求都已处理完
+                break;
+            }
+            // 在时延预算内等待更多的请求加入这一批
+            if (queue_.size() < options_.maxBatchSize &&
+                options_.maxDelayUs > 0 && IsRunning()) {
+                cond_.wait_for(lk,
+                    std::chrono::microseconds(options_.maxDelayUs),
+                    [this]() {
+                        return queue_.size() >= options_.maxBatchSize ||
+                               !IsRunning();
+                    });
+            }
+            while (!queue_.empty() && batch.size() < options_.maxBatchSize) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+        ProcessBatch(&batch);
+        batch.clear();
+    }
+}
+
+void SyncScheduler::ProcessBatch(std::vector<Request>* batch) {
+    // 合并同一个文件的请求
+    std::map<std::pair<const void*, uint64_t>, size_t> files;
+    for (size_t i = 0; i < batch->size(); ++i) {
+        const Request& req = (*batch)[i];
+        files.emplace(std::make_pair(req.owner, req.id), i);
+    }
+
+    uint64_t start = TimeUtility::GetTimeofDayUs();
+    std::map<std::pair<const void*, uint64_t>, int> results;
+    if (syncfsFd_ >= 0 && files.size() >= options_.syncfsThreshold) {
+        int ret = ::syncfs(syncfsFd_);
+        if (ret < 0) {
+            ret = -errno;
+            LOG(ERROR) << "syncfs " << options_.syncfsPath << " failed: "
+                       << strerror(-ret);
+        }
+        syncfsCount_ << 1;
+        for (auto& file : files) {
+            results[file.first] = ret;
+        }
+    } else {
+        std::vector<size_t> reqs;
+        reqs.reserve(files.size());
+        for (auto& file : files) {
+            reqs.push_back(file.second);
+        }
+        std::vector<int> rets(reqs.size(), 0);
+        SyncFiles(*batch, reqs, &rets);
+        size_t i = 0;
+        for (auto& file : files) {
+            results[file.first] = rets[i++];
+        }
+    }
+    syncLatency_ << TimeUtility::GetTimeofDayUs() - start;
+    batchSize_ << batch->size();
+    batchFiles_ << files.size();
+
+    for (auto& req : *batch) {
+        req.done(results[std::make_pair(req.owner, req.id)]);
+    }
+}
+
+void SyncScheduler::SyncFiles(const std::vector<Request>& batch,
+                              const std::vector<size_t>& files,
+                              std::vector<int>* results) {
+    std::atomic<size_t> next(0);
+    auto worker = [&batch, &files, results, &next]() {
+        size_t i;
+        while ((i = next.fetch_add(1)) < files.size()) {
+            (*results)[i] = batch[files[i]].sync();
+        }
+    };
+
+    // fdatasync在等待磁盘完成时不占用cpu，同时下发可以让磁盘并行处理
+    int helpers = std::min<size_t>(syncPoolSize_, files.size() - 1);
+    CountDownEvent event(helpers);
+    for (int i = 0; i < helpers; ++i) {
+        syncPool_.Enqueue([&worker, &event]() {
+            worker();
+            event.Signal();
+        });
+    }
+    worker();
+    event.Wait();
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef SRC_CHUNKSERVER_DATASTORE_SYNC_SCHEDULER_H_
+#define SRC_CHUNKSERVER_DATASTORE_SYNC_SCHEDULER_H_
+
+#include <bvar/bvar.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/task_thread_pool.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace chunkserver {
+
+struct SyncSchedulerOptions {
+    // 数据盘上的任意路径，用于syncfs，为空表示不使用syncfs
+    std::string syncfsPath;
+    // 一批最多合并的sync请求数
+    uint32_t maxBatchSize;
+    // 第一个请求到达后最多等待多久再发起sync，用于凑批
+    uint32_t maxDelayUs;
+    // 一批中需要sync的文件数达到该值时，使用一次syncfs代替逐个fdatasync
+    // 为0表示不使用syncfs
+    uint32_t syncfsThreshold;
+    // 不使用syncfs时，同一批中最多同时sync的文件数
+    uint32_t syncConcurrency;
+
+    SyncSchedulerOptions()
+        : maxBatchSize(256)
+        , maxDelayUs(200)
+        , syncfsThreshold(32)
+        , syncConcurrency(8) {}
+};
+
+/**
+ * 按盘进行group commit的sync调度器
+ * 所有copyset的chunk文件和WAL文件的sync请求都提交到这里，
+ * 后台线程在时延预算内把请求攒成一批，同一个文件的请求只sync一次，
+ * 需要sync的文件较多时直接对整个文件系统做一次syncfs，
+ * 然后一起回调这一批请求
+ */
+class SyncScheduler : public curve::common::Uncopyable {
+ public:
+    // 单独sync一个文件的方法，返回0表示成功，失败返回负的错误码
+    using SyncFunc = std::function<int()>;
+    // sync完成后的回调，参数为sync的结果
+    using DoneFunc = std::function<void(int)>;
+
+    static SyncScheduler& GetInstance() {
+        static SyncScheduler instance;
+        return instance;
+    }
+
+    SyncScheduler();
+    ~SyncScheduler();
+
+    /**
+     * 初始化并启动后台sync线程
+     * @return 成功返回0，失败返回-1
+     */
+    int Init(const SyncSchedulerOptions& options);
+
+    /**
+     * 停止后台线程，停止前已经提交的请求都会被处理
+     */
+    void Fini();
+
+    bool IsRunning() const {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * 异步提交一个sync请求
+     * @param owner, id: 共同标识一个文件，同一批次中相同文件的请求只sync一次
+     * @param sync: 单独sync该文件的方法
+     * @param done: sync完成后的回调，在后台线程中执行
+     */
+    void Submit(const void* owner, uint64_t id,
+                SyncFunc sync, DoneFunc done);
+
+    /**
+     * 提交一个sync请求并等待完成，可以在bthread中调用
+     * @return sync的结果
+     */
+    int SyncAndWait(const void* owner, uint64_t id, SyncFunc sync);
+
+ private:
+    struct Request {
+        const void* owner;
+        uint64_t id;
+        SyncFunc sync;
+        DoneFunc done;
+    };
+
+    void Run();
+
+    void ProcessBatch(std::vector<Request>* batch);
+
+    // 逐个sync文件，由后台线程和syncPool_中的线程同时执行
+    void SyncFiles(const std::vector<Request>& batch,
+                   const std::vector<size_t>& files,
+                   std::vector<int>* results);
+
+ private:
+    SyncSchedulerOptions options_;
+    std::atomic<bool> running_;
+    int syncfsFd_;
+
+    std::mutex mtx_;
+    std::condition_variable cond_;
+    std::deque<Request> queue_;
+    std::thread thread_;
+    // 帮助后台线程并发sync文件的线程池
+    curve::common::TaskThreadPool<> syncPool_;
+    int syncPoolSize_;
+
+    // 每批sync的耗时
+    bvar::LatencyRecorder syncLatency_;
+    // 每批合并的请求数，复用LatencyRecorder统计分布
+    bvar::LatencyRecorder batchSize_;
+    // 每批实际需要sync的文件数
+    bvar::LatencyRecorder batchFiles_;
+    // 使用syncfs的次数
+    bvar::Adder<uint64_t> syncfsCount_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_DATASTORE_SYNC_SCHEDULER_H_
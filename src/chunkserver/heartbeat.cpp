@@ -95,6 +95,10 @@ int Heartbeat::Init(const HeartbeatOptions &options) {
 
     // init scanManager
     scanMan_ = options.scanManager;
+
+    lastReported_.clear();
+    incrementalAccepted_ = false;
+    lastFullHeartbeatSec_ = 0;
     return 0;
 }
 
@@ -222,7 +226,8 @@ int Heartbeat::BuildCopysetInfo(curve::mds::heartbeat::CopySetInfo* info,
     return 0;
 }
 
-int Heartbeat::BuildRequest(HeartbeatRequest* req) {
+int Heartbeat::BuildRequest(HeartbeatRequest* req,
+                            std::map<GroupNid, std::string>* reported) {
     int ret;
 
     req->set_chunkserverid(options_.chunkserverId);
@@ -285,7 +290,9 @@ int Heartbeat::BuildRequest(HeartbeatRequest* req) {
 
     req->set_copysetcount(copysets.size());
     int leaders = 0;
+    bool buildFailed = false;
 
+    reported->clear();
     for (CopysetNodePtr copyset : copysets) {
         curve::mds::heartbeat::CopySetInfo* info = req->add_copysetinfos();
 
@@ -294,23 +301,65 @@ int Heartbeat::BuildRequest(HeartbeatRequest* req) {
             LOG(ERROR) << "Failed to build heartbeat information of copyset "
                        << ToGroupIdStr(copyset->GetLogicPoolId(),
                                      copyset->GetCopysetId());
+            buildFailed = true;
             continue;
         }
         if (copyset->IsLeaderTerm()) {
             ++leaders;
         }
+        info->SerializeToString(&(*reported)[ToGroupNid(
+            copyset->GetLogicPoolId(), copyset->GetCopysetId())]);
     }
     req->set_leadercount(leaders);
 
+    // 有copyset信息构建失败时发送全量心跳, 由mds判断是否完整
+    if (buildFailed) {
+        reported->clear();
+    } else {
+        ToIncrementalRequest(req, *reported);
+    }
+
     return 0;
 }
 
+void Heartbeat::ToIncrementalRequest(
+    HeartbeatRequest* req, const std::map<GroupNid, std::string>& reported) {
+    uint64_t now = ::curve::common::TimeUtility::GetTimeofDaySec();
+    if (options_.fullIntervalSec == 0 || !incrementalAccepted_ ||
+        now - lastFullHeartbeatSec_ >= options_.fullIntervalSec) {
+        return;
+    }
+
+    // copyset有创建或删除时发送全量心跳
+    if (reported.size() != lastReported_.size()) {
+        return;
+    }
+    auto last = lastReported_.begin();
+    for (auto it = reported.begin(); it != reported.end(); ++it, ++last) {
+        if (it->first != last->first) {
+            return;
+        }
+    }
+
+    google::protobuf::RepeatedPtrField<curve::mds::heartbeat::CopySetInfo>
+        changed;
+    for (auto& info : *req->mutable_copysetinfos()) {
+        GroupNid id = ToGroupNid(info.logicalpoolid(), info.copysetid());
+        if (reported.at(id) != lastReported_.at(id)) {
+            changed.Add()->Swap(&info);
+        }
+    }
+    req->mutable_copysetinfos()->Swap(&changed);
+    req->set_incremental(true);
+}
+
 void Heartbeat::DumpHeartbeatRequest(const HeartbeatRequest& request) {
     DVLOG(6) << "Heartbeat request: Chunkserver ID: "
              << request.chunkserverid()
              << ", IP: " << request.ip() << ", port: " << request.port()
              << ", copyset count: " << request.copysetcount()
-             << ", leader count: " << request.leadercount();
+             << ", leader count: " << request.leadercount()
+             << ", incremental: " << request.incremental();
     for (int i = 0; i < request.copysetinfos_size(); i ++) {
         const curve::mds::heartbeat::CopySetInfo& info =
             request.copysetinfos(i);
@@ -574,9 +623,10 @@ void Heartbeat::HeartbeatWorker() {
     while (!toStop_.load(std::memory_order_acquire)) {
         HeartbeatRequest req;
         HeartbeatResponse resp;
+        std::map<GroupNid, std::string> reported;
 
         LOG(INFO) << "building heartbeat info";
-        ret = BuildRequest(&req);
+        ret = BuildRequest(&req, &reported);
         if (ret != 0) {
             LOG(ERROR) << "Failed to build heartbeat request";
             ::sleep(errorIntervalSec);
@@ -587,10 +637,22 @@ void Heartbeat::HeartbeatWorker() {
         ret = SendHeartbeat(req, &resp);
         if (ret != 0) {
             LOG(WARNING) << "Failed to send heartbeat to MDS";
+            // 不确定mds是否处理了本次心跳, 下次发送全量心跳
+            incrementalAccepted_ = false;
             ::sleep(errorIntervalSec);
             continue;
         }
 
+        // 增量心跳以mds确认收到的心跳为基准
+        lastReported_.swap(reported);
+        // mds分析copyset失败时, 下次发送全量心跳重新上报
+        incrementalAccepted_ = resp.acceptincremental() &&
+            resp.statuscode() != curve::mds::heartbeat::hbAnalyseCopysetError;
+        if (!req.incremental()) {
+            lastFullHeartbeatSec_ =
+                ::curve::common::TimeUtility::GetTimeofDaySec();
+        }
+
         LOG(INFO) << "executing heartbeat info";
         ret = ExecTask(resp);
         if (ret != 0) {
@@ -67,6 +67,8 @@ struct HeartbeatOptions {
     uint32_t                port;
     uint32_t                intervalSec;
     uint32_t                timeout;
+    // 发送全量心跳的间隔, 期间只发送发生变化的copyset, 0表示总是发送全量心跳
+    uint32_t                fullIntervalSec = 0;
     CopysetNodeManager*     copysetNodeManager;
     ScanManager*            scanManager;
 
@@ -125,8 +127,17 @@ class Heartbeat {
 
     /*
      * 构建心跳请求
+     * @param[out] reported 每个copyset的信息, 心跳发送成功后用于构建增量心跳
      */
-    int BuildRequest(HeartbeatRequest* request);
+    int BuildRequest(HeartbeatRequest* request,
+                     std::map<GroupNid, std::string>* reported);
+
+    /*
+     * 将心跳请求转换为增量心跳, 只保留与上次心跳相比发生变化的copyset
+     * @param[in] reported 本次心跳中每个copyset的信息
+     */
+    void ToIncrementalRequest(HeartbeatRequest* request,
+                              const std::map<GroupNid, std::string>& reported);
 
     /*
      * 发送心跳消息
@@ -186,6 +197,15 @@ class Heartbeat {
     uint64_t startUpTime_;
 
     ScanManager *scanMan_;
+
+    // 上次发送成功的心跳中每个copyset的信息
+    std::map<GroupNid, std::string> lastReported_;
+
+    // mds在上次心跳的回应中是否接受增量心跳
+    bool incrementalAccepted_;
+
+    // 上次发送全量心跳的时间, unix时间
+    uint64_t lastFullHeartbeatSec_;
 };
 
 }  // namespace chunkserver
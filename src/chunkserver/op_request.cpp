@@ -34,6 +34,7 @@
 #include "src/chunkserver/chunk_closure.h"
 #include "src/chunkserver/clone_manager.h"
 #include "src/chunkserver/clone_task.h"
+#include "src/chunkserver/chunkserver_metrics.h"
 
 namespace curve {
 namespace chunkserver {
@@ -155,7 +156,7 @@ std::shared_ptr<ChunkOpRequest> ChunkOpRequest::Decode(butil::IOBuf log,
         case CHUNK_OP_TYPE::CHUNK_OP_RECOVER:
             return std::make_shared<ReadChunkRequest>();
         case CHUNK_OP_TYPE::CHUNK_OP_WRITE:
-            return std::make_shared<WriteChunkRequest>();
+            return std::make_shared<WriteChunkRequest>(index);
         case CHUNK_OP_TYPE::CHUNK_OP_DELETE:
             return std::make_shared<DeleteChunkRequest>();
         case CHUNK_OP_TYPE::CHUNK_OP_READ_SNAP:
@@ -242,6 +243,17 @@ void ReadChunkRequest::Process() {
     brpc::ClosureGuard doneGuard(done_);
 
     if (!node_->IsLeaderTerm()) {
+        /**
+         * follower read，只处理普通的read请求，recover需要paste数据，
+         * 必须由leader处理
+         */
+        if (request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_READ
+            && node_->IsFollowerReadEnabled()
+            && FollowerCanRead()) {
+            ChunkServerMetric::GetInstance()->IncreaseFollowerReadCount();
+            ApplyLocally(doneGuard.release(), true);
+            return;
+        }
         RedirectChunkRequest();
         return;
     }
@@ -254,49 +266,90 @@ void ReadChunkRequest::Process() {
     if ((request_->has_appliedindex()
         && node_->GetAppliedIndex() >= request_->appliedindex())
         || request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_RECOVER) {
-        /**
-         * 构造shared_ptr<ReadChunkRequest>，因为在ChunkOpRequest只指定了
-         * std::enable_shared_from_this<ChunkOpRequest>，所以
-         * shared_from_this()返回的是shared_ptr<ChunkOpRequest>
-         */
-        auto thisPtr
-            = std::dynamic_pointer_cast<ReadChunkRequest>(shared_from_this());
-        /*
-         * 将read扔给并发层出于两个原因：
-         *  (1). 将read I/O操作和write等其它I/O操作都放在并发层处理，以便隔离
-         *  disk I/O和其他逻辑
-         *  (2). 为了保证线性一致性read的语义。因为当前apply是并发的，所以applied
-         *  index更新也是并发的，尽管applied index更新能够保证单调的，但是可能会存
-         *  在更新跳跃的情况，例如，index=6,7的2个op同时进入并发模块，并且都执行成
-         *  功返回了，这个时候leader挂了，new leader选出来，new leader上面有
-         *  index=6,7两个op的日志，但是没有apply，那么new leader必然需要回放这两
-         *  条日志，因为是并发的，所以index=7的op log可能先于index=6的被apply，然后
-         *  new leader的applied index会被更新为7，这个时候client来了一个想读index=6
-         *  的op写下的数据，携带的是applied index=7，这个时候ChunkServer比较携带的
-         *  applied index和Chunkserver的applied index，那么会判定通过走直接读，但是
-         *  ChunkServer实际上index=6的数据还没落盘。那么就会出现stale read。解决方法
-         *  就是read也进并发层排队，那么需要read index=6的read request，必定会排在
-         *  index=6的op的后面，也就是它们操作的是同一个chunk，并发层会将它们放在同一个
-         *  队列中，这样就能保证index=6的op apply之后，read才会被执行，这样就不会出现
-         *  stale read，保证了read的线性一致性
-         */
-        auto task = std::bind(&ReadChunkRequest::OnApply,
-                              thisPtr,
-                              node_->GetAppliedIndex(),
-                              doneGuard.release());
-        concurrentApplyModule_->Push(
-            request_->chunkid(), request_->optype(), task);
+        ApplyLocally(doneGuard.release(), false);
         return;
     }
 
+    /**
+     * leader lease有效期内，不会有其他的leader产生，所有已经返回给client的
+     * 写请求都已经在本节点apply，所以可以不走raft直接读
+     */
+    if (node_->IsLeaseReadEnabled()) {
+        braft::LeaderLeaseStatus leaseStatus;
+        node_->GetLeaderLeaseStatus(&leaseStatus);
+        if (node_->IsLeaseLeader(leaseStatus)) {
+            ChunkServerMetric::GetInstance()->IncreaseLeaseReadCount();
+            ApplyLocally(doneGuard.release(), false);
+            return;
+        }
+    }
+
     /**
      * 如果没有携带applied index，那么走raft一致性协议read
      */
+    ChunkServerMetric::GetInstance()->IncreaseRaftReadCount();
     if (0 == Propose(request_, nullptr)) {
         doneGuard.release();
     }
 }
 
+bool ReadChunkRequest::FollowerCanRead() {
+    // client携带的applied index已经在本节点apply，可以直接读
+    if (request_->has_appliedindex()
+        && node_->GetAppliedIndex() >= request_->appliedindex()) {
+        return true;
+    }
+
+    // 否则从leader获取read index，等待本节点apply到该位置
+    return node_->WaitReadIndex();
+}
+
+void ReadChunkRequest::ApplyLocally(::google::protobuf::Closure *done,
+                                    bool afterWrite) {
+    /**
+     * 构造shared_ptr<ReadChunkRequest>，因为在ChunkOpRequest只指定了
+     * std::enable_shared_from_this<ChunkOpRequest>，所以
+     * shared_from_this()返回的是shared_ptr<ChunkOpRequest>
+     */
+    auto thisPtr
+        = std::dynamic_pointer_cast<ReadChunkRequest>(shared_from_this());
+    /*
+     * 将read扔给并发层出于两个原因：
+     *  (1). 将read I/O操作和write等其它I/O操作都放在并发层处理，以便隔离
+     *  disk I/O和其他逻辑
+     *  (2). 为了保证线性一致性read的语义。因为当前apply是并发的，所以applied
+     *  index更新也是并发的，尽管applied index更新能够保证单调的，但是可能会存
+     *  在更新跳跃的情况，例如，index=6,7的2个op同时进入并发模块，并且都执行成
+     *  功返回了，这个时候leader挂了，new leader选出来，new leader上面有
+     *  index=6,7两个op的日志，但是没有apply，那么new leader必然需要回放这两
+     *  条日志，因为是并发的，所以index=7的op log可能先于index=6的被apply，然后
+     *  new leader的applied index会被更新为7，这个时候client来了一个想读index=6
+     *  的op写下的数据，携带的是applied index=7，这个时候ChunkServer比较携带的
+     *  applied index和Chunkserver的applied index，那么会判定通过走直接读，但是
+     *  ChunkServer实际上index=6的数据还没落盘。那么就会出现stale read。解决方法
+     *  就是read也进并发层排队，那么需要read index=6的read request，必定会排在
+     *  index=6的op的后面，也就是它们操作的是同一个chunk，并发层会将它们放在同一个
+     *  队列中，这样就能保证index=6的op apply之后，read才会被执行，这样就不会出现
+     *  stale read，保证了read的线性一致性
+     */
+    auto task = std::bind(&ReadChunkRequest::OnApply,
+                          thisPtr,
+                          node_->GetAppliedIndex(),
+                          done);
+    /**
+     * follower上applied index只说明日志已经交给了并发层的写线程，写操作可能
+     * 还没有落盘，而读是在单独的读线程中执行的，所以要等写线程中同一个chunk
+     * 已经排队的写操作执行完，再把读交给读线程
+     */
+    if (afterWrite) {
+        concurrentApplyModule_->PushAfterWrite(
+            request_->chunkid(), request_->optype(), std::move(task));
+        return;
+    }
+    concurrentApplyModule_->Push(
+        request_->chunkid(), request_->optype(), std::move(task));
+}
+
 void ReadChunkRequest::OnApply(uint64_t index,
                                ::google::protobuf::Closure *done) {
     // 先清除response中的status，以保证CheckForward后的判断的正确性
@@ -448,13 +501,14 @@ void WriteChunkRequest::OnApply(uint64_t index,
                             request_->clonefileoffset());
     }
 
-    auto ret = datastore_->WriteChunk(request_->chunkid(),
-                                      request_->sn(),
-                                      cntl_->request_attachment(),
-                                      request_->offset(),
-                                      request_->size(),
-                                      &cost,
-                                      cloneSourceLocation);
+    auto ret = datastore_->WriteLoggedChunk(request_->chunkid(),
+                                            request_->sn(),
+                                            cntl_->request_attachment(),
+                                            request_->offset(),
+                                            request_->size(),
+                                            index,
+                                            &cost,
+                                            cloneSourceLocation);
 
     if (CSErrorCode::Success == ret) {
         response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
@@ -513,13 +567,14 @@ void WriteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
     }
 
 
-    auto ret = datastore->WriteChunk(request.chunkid(),
-                                     request.sn(),
-                                     data,
-                                     request.offset(),
-                                     request.size(),
-                                     &cost,
-                                     cloneSourceLocation);
+    auto ret = datastore->WriteLoggedChunk(request.chunkid(),
+                                           request.sn(),
+                                           data,
+                                           request.offset(),
+                                           request.size(),
+                                           index_,
+                                           &cost,
+                                           cloneSourceLocation);
      if (CSErrorCode::Success == ret) {
          return;
      } else if (CSErrorCode::BackwardRequestError == ret) {
@@ -874,25 +929,9 @@ void ScanChunkRequest::OnApply(uint64_t index,
     // read and calculate crc, build scanmap
     uint32_t crc = 0;
     size_t size = request_->size();
-    std::unique_ptr<char[]> readBuffer(new(std::nothrow)char[size]);
-    CHECK(nullptr != readBuffer)
-        << "new readBuffer failed " << strerror(errno);
-    // scan chunk metapage or user data
-    auto ret = 0;
-    if (request_->has_readmetapage() && request_->readmetapage()) {
-        ret = datastore_->ReadChunkMetaPage(request_->chunkid(),
-                                            request_->sn(),
-                                            readBuffer.get());
-    } else {
-        ret = datastore_->ReadChunk(request_->chunkid(),
-                                    request_->sn(),
-                                    readBuffer.get(),
-                                    request_->offset(),
-                                    size);
-    }
+    auto ret = ScanChunk(datastore_, *request_, &crc);
 
     if (CSErrorCode::Success == ret) {
-        crc = ::curve::common::CRC32(readBuffer.get(), size);
         // build scanmap
         ScanMap scanMap;
         scanMap.set_logicalpoolid(request_->logicpoolid());
@@ -929,26 +968,9 @@ void ScanChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,  /
                                                const butil::IOBuf &data) {
     uint32_t crc = 0;
     size_t size = request.size();
-    std::unique_ptr<char[]> readBuffer(new(std::nothrow)char[size]);
-    CHECK(nullptr != readBuffer)
-        << "new readBuffer failed " << strerror(errno);
-
-    // scan chunk metapage or user data
-    auto ret = 0;
-    if (request.has_readmetapage() && request.readmetapage()) {
-        ret = datastore->ReadChunkMetaPage(request.chunkid(),
-                                            request.sn(),
-                                            readBuffer.get());
-    } else {
-        ret = datastore->ReadChunk(request.chunkid(),
-                                    request.sn(),
-                                    readBuffer.get(),
-                                    request.offset(),
-                                    size);
-    }
+    auto ret = ScanChunk(datastore, request, &crc);
 
     if (CSErrorCode::Success == ret) {
-        crc = ::curve::common::CRC32(readBuffer.get(), size);
         BuildAndSendScanMap(request, index_, crc);
     } else if (CSErrorCode::ChunkNotExistError == ret) {
         LOG(ERROR) << "scan failed: chunk not exist, "
@@ -977,6 +999,42 @@ void ScanChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,  /
     }
 }
 
+CSErrorCode ScanChunkRequest::ScanChunk(
+    const std::shared_ptr<CSDataStore>& datastore,
+    const ChunkRequest &request, uint32_t* crc) {
+    // crc from the recorded page crc, only the pages changed since
+    // last scan are read
+    if (request.pagecrc() && !request.readmetapage()) {
+        return datastore->ScanChunk(request.chunkid(),
+                                    request.offset(),
+                                    request.size(),
+                                    crc);
+    }
+
+    size_t size = request.size();
+    std::unique_ptr<char[]> readBuffer(new(std::nothrow)char[size]);
+    CHECK(nullptr != readBuffer)
+        << "new readBuffer failed " << strerror(errno);
+
+    // scan chunk metapage or user data
+    CSErrorCode ret;
+    if (request.has_readmetapage() && request.readmetapage()) {
+        ret = datastore->ReadChunkMetaPage(request.chunkid(),
+                                           request.sn(),
+                                           readBuffer.get());
+    } else {
+        ret = datastore->ReadChunk(request.chunkid(),
+                                   request.sn(),
+                                   readBuffer.get(),
+                                   request.offset(),
+                                   size);
+    }
+    if (CSErrorCode::Success == ret) {
+        *crc = ::curve::common::CRC32(readBuffer.get(), size);
+    }
+    return ret;
+}
+
 void ScanChunkRequest::BuildAndSendScanMap(const ChunkRequest &request,
                                            uint64_t index, uint32_t crc) {
     // send rpc to leader
@@ -234,6 +234,11 @@ class ReadChunkRequest : public ChunkOpRequest {
     bool NeedClone(const CSChunkInfo& chunkInfo);
     // 从chunk文件中读数据
     void ReadChunk();
+    // follower是否可以直接处理该读请求
+    bool FollowerCanRead();
+    // 不走raft，将读请求直接交给并发层处理，afterWrite表示需要等同一个
+    // chunk已经排队的写操作执行完之后再读
+    void ApplyLocally(::google::protobuf::Closure *done, bool afterWrite);
 
  private:
     CloneManager* cloneMgr_;
@@ -246,7 +251,9 @@ class ReadChunkRequest : public ChunkOpRequest {
 class WriteChunkRequest : public ChunkOpRequest {
  public:
     WriteChunkRequest() :
-        ChunkOpRequest() {}
+        ChunkOpRequest(), index_(0) {}
+    explicit WriteChunkRequest(uint64_t index) :
+        ChunkOpRequest(), index_(index) {}
     WriteChunkRequest(std::shared_ptr<CopysetNode> nodePtr,
                       RpcController *cntl,
                       const ChunkRequest *request,
@@ -256,13 +263,17 @@ class WriteChunkRequest : public ChunkOpRequest {
                        cntl,
                        request,
                        response,
-                       done) {}
+                       done), index_(0) {}
     virtual ~WriteChunkRequest() = default;
 
     void OnApply(uint64_t index, ::google::protobuf::Closure *done);
     void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
                         const ChunkRequest &request,
                         const butil::IOBuf &data) override;
+
+ private:
+    // 从log entry反序列化时的index，延迟写通过它从raft log读回数据
+    uint64_t index_;
 };
 
 class ReadSnapshotRequest : public ChunkOpRequest {
@@ -384,6 +395,9 @@ class ScanChunkRequest : public ChunkOpRequest {
                         const butil::IOBuf &data) override;
 
  private:
+    // read chunk metapage or user data and calculate the crc
+    static CSErrorCode ScanChunk(const std::shared_ptr<CSDataStore>& datastore,
+                                 const ChunkRequest &request, uint32_t* crc);
     void BuildAndSendScanMap(const ChunkRequest &request, uint64_t index,
                              uint32_t crc);
     ScanManager* scanManager_;
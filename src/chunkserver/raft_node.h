@@ -107,6 +107,10 @@ class RaftNode {
         node_->get_status(status);
     }
 
+    virtual void get_leader_lease_status(braft::LeaderLeaseStatus* status) {
+        node_->get_leader_lease_status(status);
+    }
+
  private:
     std::shared_ptr<Node> node_;
 };
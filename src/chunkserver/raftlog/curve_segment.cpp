@@ -45,6 +45,7 @@
 #include <braft/fsync.h>
 #include "src/chunkserver/raftlog/curve_segment.h"
 #include "src/chunkserver/raftlog/define.h"
+#include "src/chunkserver/datastore/sync_scheduler.h"
 
 namespace curve {
 namespace chunkserver {
@@ -52,6 +53,9 @@ namespace chunkserver {
 DEFINE_bool(raftSyncSegments, true, "call fsync when a segment is closed");
 DEFINE_bool(enableWalDirectWrite, true, "enable wal direct write or not");
 DEFINE_uint32(walAlignSize, 4096, "wal align size to write");
+DEFINE_uint32(walMaxPendingWrites, 64, "max wal entries buffered before "
+              "they are submitted in one batch, only take effect when "
+              "the local filesystem supports async io");
 
 int CurveSegment::create() {
     if (!_is_open) {
@@ -414,10 +418,7 @@ int CurveSegment::append(const braft::LogEntry* entry) {
     CHECK_LE(data.length(), 1ul << 56ul);
     char* write_buf = nullptr;
     if (FLAGS_enableWalDirectWrite) {
-        int ret = posix_memalign(reinterpret_cast<void **>(&write_buf),
-                                 FLAGS_walAlignSize, to_write);
-        LOG_IF(FATAL, ret < 0 || write_buf == nullptr)
-        << "posix_memalign WAL write buffer failed " << strerror(ret);
+        write_buf = _alloc_write_buf(to_write);
     } else {
         write_buf = new char[kEntryHeaderSize];
     }
@@ -433,11 +434,17 @@ int CurveSegment::append(const braft::LogEntry* entry) {
                   _checksum_type, write_buf, kEntryHeaderSize - 4));
     if (FLAGS_enableWalDirectWrite) {
         data.copy_to(write_buf + kEntryHeaderSize, real_length);
-        int ret = ::pwrite(_direct_fd, write_buf, to_write, _meta.bytes);
-        free(write_buf);
-        if (ret != to_write) {
-            LOG(ERROR) << "Fail to write directly to fd=" << _direct_fd;
-            return -1;
+        if (_batch_append_enabled()) {
+            _pending_writes.emplace_back(curve::fs::AioOpType::WRITE,
+                                         _direct_fd, write_buf, _meta.bytes,
+                                         to_write);
+        } else {
+            int ret = ::pwrite(_direct_fd, write_buf, to_write, _meta.bytes);
+            _free_write_buf(write_buf);
+            if (ret != to_write) {
+                LOG(ERROR) << "Fail to write directly to fd=" << _direct_fd;
+                return -1;
+            }
         }
     } else {
         butil::IOBuf header;
@@ -465,23 +472,89 @@ int CurveSegment::append(const braft::LogEntry* entry) {
         _last_index.fetch_add(1, butil::memory_order_relaxed);
         _meta.bytes += to_write;
     }
+    if (!_pending_writes.empty()) {
+        if (_pending_writes.size() >= FLAGS_walMaxPendingWrites) {
+            return _flush_pending_writes();
+        }
+        return 0;
+    }
     return _update_meta_page();
 }
 
+char* CurveSegment::_alloc_write_buf(size_t size) {
+    char* buf = nullptr;
+    if (_batch_append_enabled()) {
+        // 尽量使用注册到内核的固定buffer
+        buf = _lfs->AllocIOBuffer(size);
+        LOG_IF(FATAL, buf == nullptr) << "Alloc WAL write buffer failed";
+        return buf;
+    }
+    int ret = posix_memalign(reinterpret_cast<void **>(&buf),
+                             FLAGS_walAlignSize, size);
+    LOG_IF(FATAL, ret < 0 || buf == nullptr)
+        << "posix_memalign WAL write buffer failed " << strerror(ret);
+    return buf;
+}
+
+void CurveSegment::_free_write_buf(char* buf) {
+    if (_batch_append_enabled()) {
+        _lfs->FreeIOBuffer(buf);
+    } else {
+        free(buf);
+    }
+}
+
+int CurveSegment::_flush_pending_writes() {
+    if (_pending_writes.empty()) {
+        return 0;
+    }
+    int ret = _lfs->SubmitBatch(&_pending_writes);
+    for (auto& req : _pending_writes) {
+        if (ret == 0 && req.result != req.length) {
+            ret = -1;
+        }
+    }
+    if (ret != 0) {
+        LOG(ERROR) << "Fail to write " << _pending_writes.size()
+                   << " entries directly to fd=" << _direct_fd
+                   << ", path: " << _path << ", ret: " << ret;
+        _release_pending_writes();
+        return -1;
+    }
+    _release_pending_writes();
+    // 数据全部落盘之后才能更新meta page，保证meta page中记录的长度有效
+    return _update_meta_page();
+}
+
+void CurveSegment::_release_pending_writes() {
+    for (auto& req : _pending_writes) {
+        _lfs->FreeIOBuffer(req.buf);
+    }
+    _pending_writes.clear();
+}
+
+int CurveSegment::_sync_fd() {
+    SyncScheduler& scheduler = SyncScheduler::GetInstance();
+    if (!scheduler.IsRunning()) {
+        return braft::raft_fsync(_fd);
+    }
+    // 与其他copyset的WAL和chunk文件一起合并sync
+    return scheduler.SyncAndWait(this, _fd, [this]() {
+        return braft::raft_fsync(_fd);
+    });
+}
+
 int CurveSegment::_update_meta_page() {
-    char* metaPage = nullptr;
-    int ret = posix_memalign(reinterpret_cast<void **>(&metaPage),
-                            FLAGS_walAlignSize, _meta_page_size);
-    LOG_IF(FATAL, ret < 0 || metaPage == nullptr)
-        << "posix_memalign WAL meta page failed " << strerror(ret);
+    char* metaPage = _alloc_write_buf(_meta_page_size);
     memset(metaPage, 0, _meta_page_size);
     memcpy(metaPage, &_meta.bytes, sizeof(_meta.bytes));
+    int ret = 0;
     if (FLAGS_enableWalDirectWrite) {
         ret = ::pwrite(_direct_fd, metaPage, _meta_page_size, 0);
     } else {
         ret = ::pwrite(_fd, metaPage, _meta_page_size, 0);
     }
-    free(metaPage);
+    _free_write_buf(metaPage);
     if (ret != _meta_page_size) {
         LOG(ERROR) << "Fail to write meta page into fd="
                    << (FLAGS_enableWalDirectWrite ? _direct_fd : _fd)
@@ -600,11 +673,14 @@ int CurveSegment::close(bool will_sync) {
               << " raft_sync_segments: " << FLAGS_raftSyncSegments
               << " will_sync: " << will_sync
               << " path: " << new_path;
-    int ret = 0;
+    int ret = _flush_pending_writes();
+    if (ret != 0) {
+        return ret;
+    }
     if (_last_index > _first_index) {
         if (FLAGS_raftSyncSegments && will_sync &&
                                 !FLAGS_enableWalDirectWrite) {
-            ret = braft::raft_fsync(_fd);
+            ret = _sync_fd();
         }
     }
     if (ret == 0) {
@@ -621,11 +697,14 @@ int CurveSegment::close(bool will_sync) {
 }
 
 int CurveSegment::sync(bool will_sync) {
+    if (_flush_pending_writes() != 0) {
+        return -1;
+    }
     if (_last_index > _first_index) {
         // CHECK(_is_open);
         if (!FLAGS_enableWalDirectWrite && braft::FLAGS_raft_sync
                                             && will_sync) {
-            return braft::raft_fsync(_fd);
+            return _sync_fd();
         } else {
             return 0;
         }
@@ -656,6 +735,9 @@ int CurveSegment::unlink() {
 int CurveSegment::truncate(const int64_t last_index_kept) {
     int64_t truncate_size = 0;
     int64_t first_truncate_in_offset = 0;
+    if (_flush_pending_writes() != 0) {
+        return -1;
+    }
     std::unique_lock<braft::raft_mutex_t> lck(_mutex);
     if (last_index_kept >= _last_index) {
         return 0;
@@ -60,6 +60,10 @@ namespace curve {
 namespace chunkserver {
 
 DECLARE_bool(enableWalDirectWrite);
+DECLARE_uint32(walMaxPendingWrites);
+
+using curve::fs::AioRequest;
+using curve::fs::LocalFileSystem;
 
 struct CurveSegmentMeta {
     CurveSegmentMeta() : bytes(0) {}
@@ -76,7 +80,8 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
         _first_index(first_index), _last_index(first_index - 1),
         _checksum_type(checksum_type),
         _walFilePool(walFilePool),
-        _meta_page_size(walFilePool->GetFilePoolOpt().metaPageSize) {
+        _meta_page_size(walFilePool->GetFilePoolOpt().metaPageSize),
+        _lfs(walFilePool->GetLocalFileSystem()) {
     }
     CurveSegment(const std::string& path, const int64_t first_index,
                  const int64_t last_index, int checksum_type,
@@ -86,9 +91,11 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
         _first_index(first_index), _last_index(last_index),
         _checksum_type(checksum_type),
         _walFilePool(walFilePool),
-        _meta_page_size(walFilePool->GetFilePoolOpt().metaPageSize) {
+        _meta_page_size(walFilePool->GetFilePoolOpt().metaPageSize),
+        _lfs(walFilePool->GetLocalFileSystem()) {
     }
     ~CurveSegment() {
+        _release_pending_writes();
         if (_fd >= 0) {
             ::close(_fd);
             _fd = -1;
@@ -162,6 +169,26 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
 
     int _update_meta_page();
 
+    // fdatasync当前segment，调度器运行时与其他文件合并sync
+    int _sync_fd();
+
+    // 本地文件系统支持异步IO时，direct write模式下append的数据不会立即写入，
+    // 而是在sync/close/truncate或者积攒到一定数量后通过一次批量提交写入，
+    // 之后再更新meta page。append_entries返回前一定会sync，而braft在日志
+    // 落盘之前只会从内存中读取，所以未提交的日志不会被get读到
+    bool _batch_append_enabled() const {
+        return FLAGS_enableWalDirectWrite && _lfs != nullptr &&
+               _lfs->SupportAsyncIO();
+    }
+
+    char* _alloc_write_buf(size_t size);
+
+    void _free_write_buf(char* buf);
+
+    int _flush_pending_writes();
+
+    void _release_pending_writes();
+
     std::string _path;
     CurveSegmentMeta _meta;
     mutable braft::raft_mutex_t _mutex;
@@ -174,6 +201,8 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
     std::vector<std::pair<int64_t, int64_t> > _offset_and_term;
     std::shared_ptr<FilePool> _walFilePool;
     uint32_t _meta_page_size;
+    std::shared_ptr<LocalFileSystem> _lfs;
+    std::vector<AioRequest> _pending_writes;
 };
 
 }  // namespace chunkserver
@@ -40,13 +40,47 @@
 
 #include <braft/protobuf_file.h>
 #include <braft/local_storage.pb.h>
+#include <bvar/bvar.h>
+#include <butil/time.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
 #include "src/chunkserver/datastore/file_pool.h"
 #include "src/chunkserver/raftlog/define.h"
 
+DEFINE_uint32(walSegmentLoadConcurrency, 4,
+              "max threads to load the closed segments of a log storage");
+
 namespace curve {
 namespace chunkserver {
 
+static bvar::LatencyRecorder g_load_segments_latency(
+                                "curve_segment_log_storage_load_segments");
+
+// Add the configurations loaded from segment [first_index, last_index]
+// into |from| to |to|, braft::ConfigurationManager has no iterator, so
+// walk back from the last one by get()
+static void merge_configurations(braft::ConfigurationManager* from,
+                                 int64_t first_index,
+                                 int64_t last_index,
+                                 braft::ConfigurationManager* to) {
+    std::vector<braft::ConfigurationEntry> entries;
+    int64_t index = last_index;
+    while (index >= first_index) {
+        braft::ConfigurationEntry entry;
+        from->get(index, &entry);
+        if (entry.id.index < first_index) {
+            break;
+        }
+        entries.push_back(entry);
+        index = entry.id.index - 1;
+    }
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        to->add(*it);
+    }
+}
+
 LogStorageOptions StoreOptForCurveSegmentLogStorage(
     LogStorageOptions options) {
     static LogStorageOptions options_;
@@ -292,19 +326,50 @@ int CurveSegmentLogStorage::list_segments(bool is_empty) {
 int CurveSegmentLogStorage::load_segments(
                 braft::ConfigurationManager* configuration_manager) {
     int ret = 0;
+    butil::Timer timer;
+    timer.start();
 
-    // closed segments
-    SegmentMap::iterator it;
-    for (it = _segments.begin(); it != _segments.end(); ++it) {
-        Segment* segment = it->second.get();
-        LOG(INFO) << "load closed segment, path: " << _path
-            << " first_index: " << segment->first_index()
-            << " last_index: " << segment->last_index();
-        ret = segment->load(configuration_manager);
-        if (ret != 0) {
-            return ret;
+    // closed segments are loaded concurrently, every segment collects the
+    // configurations into its own manager, which are merged in index order
+    // afterwards, because braft::ConfigurationManager is not thread safe
+    // and requires the configurations added in increasing order
+    std::vector<Segment*> segments;
+    for (auto it = _segments.begin(); it != _segments.end(); ++it) {
+        segments.push_back(it->second.get());
+    }
+    std::vector<braft::ConfigurationManager> managers(segments.size());
+    std::vector<int> results(segments.size(), 0);
+    std::atomic<size_t> next(0);
+    auto loader = [&]() {
+        for (size_t i = next.fetch_add(1); i < segments.size();
+             i = next.fetch_add(1)) {
+            Segment* segment = segments[i];
+            LOG(INFO) << "load closed segment, path: " << _path
+                << " first_index: " << segment->first_index()
+                << " last_index: " << segment->last_index();
+            results[i] = segment->load(&managers[i]);
+        }
+    };
+    size_t threadNum = std::min<size_t>(
+        std::max<uint32_t>(FLAGS_walSegmentLoadConcurrency, 1),
+        segments.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadNum; ++i) {
+        threads.emplace_back(loader);
+    }
+    loader();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (results[i] != 0) {
+            return results[i];
         }
-        _last_log_index.store(segment->last_index(),
+        merge_configurations(&managers[i], segments[i]->first_index(),
+                             segments[i]->last_index(),
+                             configuration_manager);
+        _last_log_index.store(segments[i]->last_index(),
                                     butil::memory_order_release);
     }
 
@@ -348,6 +413,8 @@ int CurveSegmentLogStorage::load_segments(
     if (_last_log_index == 0) {
         _last_log_index = _first_log_index - 1;
     }
+    timer.stop();
+    g_load_segments_latency << timer.u_elapsed();
     return 0;
 }
 
@@ -432,24 +499,34 @@ int CurveSegmentLogStorage::append_entries(
                    << " _last_log_index path: " << _path;
         return -1;
     }
+    const int64_t last_index =
+                _last_log_index.load(butil::memory_order_relaxed);
     scoped_refptr<Segment> last_segment = NULL;
-    for (size_t i = 0; i < entries.size(); i++) {
-        braft::LogEntry* entry = entries[i];
+    size_t appended = 0;
+    for (; appended < entries.size(); appended++) {
+        braft::LogEntry* entry = entries[appended];
 
         scoped_refptr<Segment> segment =
                     open_segment(entry->data.size() + kEntryHeaderSize);
         if (NULL == segment) {
-            return i;
+            break;
         }
         int ret = segment->append(entry);
         if (0 != ret) {
-            return i;
+            break;
         }
+        // open_segment依据_last_log_index决定新segment的起始index
         _last_log_index.fetch_add(1, butil::memory_order_release);
         last_segment = segment;
     }
-    last_segment->sync(_enable_sync);
-    return entries.size();
+    // 批量写入模式下，数据在sync时才真正提交，失败时回退_last_log_index，
+    // 避免未落盘的日志被读到，并通知上层
+    if (last_segment != NULL && last_segment->sync(_enable_sync) != 0) {
+        LOG(ERROR) << "Fail to sync segment, path: " << _path;
+        _last_log_index.store(last_index, butil::memory_order_release);
+        return -1;
+    }
+    return appended;
 }
 
 int CurveSegmentLogStorage::truncate_prefix(const int64_t first_index_kept) {
@@ -57,6 +57,8 @@
 #include "src/chunkserver/raftlog/curve_segment.h"
 #include "src/chunkserver/raftlog/braft_segment.h"
 
+DECLARE_uint32(walSegmentLoadConcurrency);
+
 namespace curve {
 namespace chunkserver {
 
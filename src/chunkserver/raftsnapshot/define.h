@@ -28,6 +28,8 @@ namespace chunkserver {
 
 const char RAFT_DATA_DIR[] = "data";
 const char RAFT_META_DIR[] = "raft_meta";
+// braft保存term和votedfor的文件
+const char RAFT_META_FILE[] = "stable_meta";
 
 // TODO(all:fix it): RAFT_SNAP_DIR注意当前这个目录地址不能修改
 // 与当前外部依赖curve-braft代码强耦合（两边硬编码耦合）
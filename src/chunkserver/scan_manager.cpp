@@ -40,6 +40,8 @@ int ScanManager::Init(const ScanManagerOptions &options) {
     scanTaskWaitInterval_.Init(options.timeoutMs);
     copysetNodeManager_ = options.copysetNodeManager;
     chunkSize_ = copysetNodeManager_->GetCopysetNodeOptions().maxChunkSize;
+    scanByPageCrc_ =
+        copysetNodeManager_->GetCopysetNodeOptions().enablePageCrc;
     if (scanSize_ > chunkSize_ || scanSize_ <= 0 ||
         chunkSize_ % scanSize_ != 0) {
         LOG(ERROR) << "Init scan manager failed, "
@@ -271,6 +273,7 @@ int ScanManager::ScanJobProcess(const std::shared_ptr<ScanJob> job) {
                     request->set_size(chunkMetaPageSize_);
                 } else {
                     request->set_size(scanSize_);
+                    request->set_pagecrc(scanByPageCrc_);
                 }
                 ScanChunkClosure *done = new ScanChunkClosure(request,
                                                               response);
@@ -247,6 +247,8 @@ class ScanManager {
     uint32_t chunkSize_;
     uint32_t chunkMetaPageSize_;
     uint64_t scanSize_;
+    // scan by the recorded page crc
+    bool scanByPageCrc_;
     uint64_t timeoutMs_;
     uint32_t retry_;
     uint64_t retryIntervalUs_;
@@ -159,6 +159,18 @@ int ClientConfig::Init(const std::string& configpath) {
     LOG_IF(ERROR, ret == false) << "config no schedule.threadpoolSize info";
     RETURN_IF_FALSE(ret);
 
+    ret = conf_.GetUInt32Value("schedule.writeCoalesceMaxBytes",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.writeCoalesceMaxBytes);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.writeCoalesceMaxBytes info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.writeCoalesceMaxBytes;
+
+    ret = conf_.GetUInt32Value("schedule.writeCoalesceWindowUs",
+        &fileServiceOption_.ioOpt.reqSchdulerOpt.writeCoalesceWindowUs);
+    LOG_IF(WARNING, ret == false)
+        << "config no schedule.writeCoalesceWindowUs info, using default value "
+        << fileServiceOption_.ioOpt.reqSchdulerOpt.writeCoalesceWindowUs;
+
     ret = conf_.GetUInt32Value("mds.refreshTimesPerLease",
         &fileServiceOption_.leaseOpt.mdsRefreshTimesPerLease);
     LOG_IF(ERROR, ret == false) << "config no mds.refreshTimesPerLease info";
@@ -256,6 +268,27 @@ int ClientConfig::Init(const std::string& configpath) {
         << "config no throttle.enable info, using default value "
         << fileServiceOption_.ioOpt.throttleOption.enable;
 
+    ret = conf_.GetBoolValue(
+        "readCache.enable",
+        &fileServiceOption_.ioOpt.readCacheOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.enable info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.enable;
+
+    ret = conf_.GetUInt64Value(
+        "readCache.capacityMB",
+        &fileServiceOption_.ioOpt.readCacheOpt.capacityMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.capacityMB info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.capacityMB;
+
+    ret = conf_.GetUInt32Value(
+        "readCache.blockSize",
+        &fileServiceOption_.ioOpt.readCacheOpt.blockSize);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.blockSize info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.blockSize;
+
     ret = conf_.GetBoolValue("discard.enable",
                              &fileServiceOption_.ioOpt.discardOption.enable);
     LOG_IF(ERROR, ret == false) << "config no discard.enable info";
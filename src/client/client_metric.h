@@ -102,6 +102,57 @@ struct DiscardMetric {
     bvar::Adder<int64_t> pending;
 };
 
+// 读缓存命中情况统计，按用户请求拆分后的子请求计数
+struct ReadCacheMetric {
+    explicit ReadCacheMetric(const std::string& prefix)
+        : hit(prefix, "read_cache_hit"),
+          miss(prefix, "read_cache_miss"),
+          hitBytes(prefix, "read_cache_hit_bytes"),
+          invalidate(prefix, "read_cache_invalidate"),
+          hitRatio(prefix, "read_cache_hit_ratio", GetHitRatio, this) {}
+
+    static double GetHitRatio(void* arg) {
+        auto* metric = static_cast<ReadCacheMetric*>(arg);
+        uint64_t hit = metric->hit.get_value();
+        uint64_t total = hit + metric->miss.get_value();
+        return total == 0 ? 0 : static_cast<double>(hit) / total;
+    }
+
+    bvar::Adder<uint64_t> hit;
+    bvar::Adder<uint64_t> miss;
+    bvar::Adder<uint64_t> hitBytes;
+    // 因为写而失效的次数
+    bvar::Adder<uint64_t> invalidate;
+    bvar::PassiveStatus<double> hitRatio;
+};
+
+// 调度层写请求合并统计
+struct WriteCoalesceMetric {
+    explicit WriteCoalesceMetric(const std::string& prefix)
+        : requests(prefix, "write_coalesce_requests"),
+          rpcs(prefix, "write_coalesce_rpcs"),
+          mergeRatio(prefix, "write_coalesce_merge_ratio",
+                     GetMergeRatio, this),
+          addedLatency(prefix, "write_coalesce_added_latency") {}
+
+    static double GetMergeRatio(void* arg) {
+        auto* metric = static_cast<WriteCoalesceMetric*>(arg);
+        uint64_t rpcs = metric->rpcs.get_value();
+        return rpcs == 0 ? 0
+                         : static_cast<double>(metric->requests.get_value()) /
+                               rpcs;
+    }
+
+    // 经过合并阶段的写请求数
+    bvar::Adder<uint64_t> requests;
+    // 合并后发出的写rpc数
+    bvar::Adder<uint64_t> rpcs;
+    // 平均每个rpc包含的写请求数
+    bvar::PassiveStatus<double> mergeRatio;
+    // 等待合并引入的时延(us)
+    bvar::LatencyRecorder addedLatency;
+};
+
 // 文件级别metric信息统计
 struct FileMetric {
     const std::string prefix = "curve_client";
@@ -136,6 +187,10 @@ struct FileMetric {
 
     DiscardMetric discardMetric;
 
+    ReadCacheMetric readCacheMetric;
+
+    WriteCoalesceMetric writeCoalesceMetric;
+
     explicit FileMetric(const std::string& name)
         : filename(name),
           inflightRPCNum(prefix, filename + "_inflight_rpc_num"),
@@ -149,7 +204,9 @@ struct FileMetric {
           userDiscard(prefix, filename + "_discard"),
           getLeaderRetryQPS(prefix, filename + "_get_leader_retry_rpc"),
           suspendRPCMetric(prefix, filename + "_suspend_io_num"),
-          discardMetric(prefix + filename) {}
+          discardMetric(prefix + filename),
+          readCacheMetric(prefix + filename),
+          writeCoalesceMetric(prefix + filename) {}
 };
 
 // 用于全局mds接口统计信息调用信息统计
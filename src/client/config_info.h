@@ -171,10 +171,15 @@ struct IOSenderOption {
  * 线程池，线程池中的线程各自配置一个队列
  * @scheduleQueueCapacity: schedule模块配置的队列深度
  * @scheduleThreadpoolSize: schedule模块线程池大小
+ * @writeCoalesceMaxBytes: 同一chunk上连续的写请求合并为一个rpc的最大字节数，
+ *                         0表示不合并
+ * @writeCoalesceWindowUs: 队列为空时等待后续可合并写请求的最长时间
  */
 struct RequestScheduleOption {
     uint32_t scheduleQueueCapacity = 1024;
     uint32_t scheduleThreadpoolSize = 2;
+    uint32_t writeCoalesceMaxBytes = 0;
+    uint32_t writeCoalesceWindowUs = 0;
     IOSenderOption ioSenderOpt;
 };
 
@@ -258,6 +263,18 @@ struct ThrottleOption {
     bool enable = false;
 };
 
+/**
+ * client端读缓存配置
+ * @enable: 是否开启读缓存
+ * @capacityMB: 每个文件读缓存的内存上限
+ * @blockSize: 缓存的粒度，只有完整读到的block才会被缓存
+ */
+struct ReadCacheOption {
+    bool enable = false;
+    uint64_t capacityMB = 256;
+    uint32_t blockSize = 4096;
+};
+
 /**
  * IOOption存储了当前io 操作所需要的所有配置信息
  */
@@ -270,6 +287,7 @@ struct IOOption {
     CloseFdThreadOption closeFdThreadOption;
     ThrottleOption throttleOption;
     DiscardOption discardOption;
+    ReadCacheOption readCacheOpt;
 };
 
 /**
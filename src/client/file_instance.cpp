@@ -81,6 +81,10 @@ bool FileInstance::Initialize(const std::string& filename,
 
         iomanager4file_.UpdateFileInfo(finfo_);
 
+        if (openflags.directIO) {
+            iomanager4file_.DisableReadCache();
+        }
+
         leaseExecutor_.reset(new (std::nothrow) LeaseExecutor(
             fileopt_.leaseOpt, finfo_.userinfo, mdsclient_.get(),
             &iomanager4file_));
@@ -35,6 +35,7 @@
 #include "src/client/source_reader.h"
 #include "src/client/metacache_struct.h"
 #include "src/client/discard_task.h"
+#include "src/client/read_cache.h"
 
 namespace curve {
 namespace client {
@@ -49,7 +50,8 @@ IOTracker::IOTracker(IOManager* iomanager,
                      RequestScheduler* scheduler,
                      FileMetric* clientMetric,
                      bool disableStripe)
-    : mc_(mc),
+    : readCache_(nullptr),
+      mc_(mc),
       iomanager_(iomanager),
       scheduler_(scheduler),
       fileMetric_(clientMetric),
@@ -110,10 +112,13 @@ void IOTracker::DoRead(MDSClient* mdsclient, const FInfo_t* fileInfo,
                                         length_, mdsclient, fileInfo);
     if (ret == 0) {
         PrepareReadIOBuffers(reqlist_.size());
+        readCacheVersions_.assign(reqlist_.size(), ReadCache::kNoFill);
         uint32_t subIoIndex = 0;
         std::vector<RequestContext*> originReadVec;
+        std::vector<RequestContext*> cachedReadVec;
 
         std::for_each(reqlist_.begin(), reqlist_.end(), [&](RequestContext* r) {
+            r->subIoIndex_ = subIoIndex++;
             // fake subrequest
             if (!r->idinfo_.chunkExist) {
                 // the clone source is empty
@@ -125,17 +130,36 @@ void IOTracker::DoRead(MDSClient* mdsclient, const FInfo_t* fileInfo,
                     // read from original volume
                     originReadVec.emplace_back(r);
                 }
+            } else if (ReadFromCache(r)) {
+                cachedReadVec.emplace_back(r);
             }
 
             r->done_->SetFileMetric(fileMetric_);
             r->done_->SetIOManager(iomanager_);
-            r->subIoIndex_ = subIoIndex++;
         });
 
         reqcount_.store(reqlist_.size(), std::memory_order_release);
-        if (scheduler_->ScheduleRequest(reqlist_) == 0 &&
+        int scheduleRet = 0;
+        if (cachedReadVec.empty()) {
+            scheduleRet = scheduler_->ScheduleRequest(reqlist_);
+        } else if (cachedReadVec.size() < reqlist_.size()) {
+            std::vector<RequestContext*> uncachedReadVec;
+            for (auto r : reqlist_) {
+                if (std::find(cachedReadVec.begin(), cachedReadVec.end(), r) ==
+                    cachedReadVec.end()) {
+                    uncachedReadVec.emplace_back(r);
+                }
+            }
+            scheduleRet = scheduler_->ScheduleRequest(uncachedReadVec);
+        }
+        if (scheduleRet == 0 &&
             ReadFromSource(originReadVec, fileInfo->userinfo, mdsclient) == 0) {
-            ret = 0;
+            // the tracker may be released after the last request returned,
+            // so don't touch any member from now on
+            for (auto r : cachedReadVec) {
+                r->done_->Run();
+            }
+            return;
         } else {
             ret = -1;
         }
@@ -160,6 +184,31 @@ int IOTracker::ReadFromSource(const std::vector<RequestContext*>& reqCtxVec,
     return SourceReader::GetInstance().Read(reqCtxVec, userInfo, mdsClient);
 }
 
+bool IOTracker::ReadFromCache(RequestContext* req) {
+    if (readCache_ == nullptr) {
+        return false;
+    }
+
+    const ChunkID chunkId = req->idinfo_.cid_;
+    if (readCache_->Read(chunkId, req->offset_, req->rawlength_,
+                         &req->readData_)) {
+        req->done_->SetFailed(LIBCURVE_ERROR::OK);
+        return true;
+    }
+
+    // remember the version before sending the request, the data read
+    // will be dropped if there are writes on this chunk in the meantime
+    readCacheVersions_[req->subIoIndex_] = readCache_->GetVersion(chunkId);
+    return false;
+}
+
+void IOTracker::InvalidateReadCache(const RequestContext* req) {
+    if (readCache_ != nullptr) {
+        readCache_->Invalidate(req->idinfo_.cid_, req->offset_,
+                               req->rawlength_);
+    }
+}
+
 void IOTracker::StartWrite(const void* buf, off_t offset, size_t length,
                            MDSClient* mdsclient, const FInfo_t* fileInfo,
                            Throttle* throttle) {
@@ -218,6 +267,7 @@ void IOTracker::DoWrite(MDSClient* mdsclient, const FInfo_t* fileInfo,
             r->done_->SetFileMetric(fileMetric_);
             r->done_->SetIOManager(iomanager_);
             r->subIoIndex_ = subIoIndex++;
+            InvalidateReadCache(r);
         });
         ret = scheduler_->ScheduleRequest(reqlist_);
     } else {
@@ -446,6 +496,18 @@ void IOTracker::HandleResponse(RequestContext* reqctx) {
         SetReadData(reqctx->subIoIndex_, reqctx->readData_);
     }
 
+    if (readCache_ != nullptr) {
+        if (OpType::READ == type_ && errorcode == 0) {
+            readCache_->Fill(reqctx->idinfo_.cid_, reqctx->offset_,
+                             reqctx->readData_,
+                             readCacheVersions_[reqctx->subIoIndex_]);
+        } else if (OpType::WRITE == type_) {
+            // invalidate again, in case that a read sent before this write
+            // filled the cache with old data
+            InvalidateReadCache(reqctx);
+        }
+    }
+
     if (1 == reqcount_.fetch_sub(1, std::memory_order_acq_rel)) {
         Done();
     }
@@ -48,6 +48,7 @@ using curve::common::Throttle;
 class IOManager;
 class FileSegment;
 class DiscardTaskManager;
+class ReadCache;
 
 // IOTracker用于跟踪一个用户IO，因为一个用户IO可能会跨chunkserver，
 // 因此在真正下发的时候会被拆分成多个小IO并发的向下发送，因此我们需要
@@ -223,6 +224,13 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
         return disableStripe_;
     }
 
+    /**
+     * @brief set the read cache of the file, nullptr means no cache
+     */
+    void SetReadCache(ReadCache* readCache) {
+        readCache_ = readCache;
+    }
+
     static void InitDiscardOption(const DiscardOption& opt);
 
  private:
@@ -278,6 +286,17 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
     int ReadFromSource(const std::vector<RequestContext*>& reqCtxVec,
                        const UserInfo_t& userInfo, MDSClient* mdsClient);
 
+    /**
+     * @brief try to serve the read request from read cache
+     * @return true if all data of the request is cached
+     */
+    bool ReadFromCache(RequestContext* req);
+
+    /**
+     * @brief invalidate read cache of the write request
+     */
+    void InvalidateReadCache(const RequestContext* req);
+
     // perform write operation
     void DoWrite(MDSClient* mdsclient, const FInfo_t* fileInfo,
                  Throttle* throttle);
@@ -311,6 +330,13 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
     // save read data
     std::vector<butil::IOBuf> readDatas_;
 
+    // file level read cache, nullptr if disabled
+    ReadCache* readCache_;
+
+    // read cache version of each sub read request before it was sent,
+    // ReadCache::kNoFill if the data shouldn't be filled into cache
+    std::vector<uint64_t> readCacheVersions_;
+
     // 当用户下发的是同步IO的时候，其需要在上层进行等待，因为client的
     // IO发送流程全部是异步的，因此这里需要用条件变量等待，待异步IO返回
     // 之后才将这个等待的条件变量唤醒，然后向上返回。
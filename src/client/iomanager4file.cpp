@@ -87,6 +87,11 @@ bool IOManager4File::Initialize(const std::string& filename,
     discardTaskManager_.reset(
         new DiscardTaskManager(&(fileMetric_->discardMetric)));
 
+    if (ioopt_.readCacheOpt.enable) {
+        readCache_.reset(new ReadCache(ioopt_.readCacheOpt,
+                                       &fileMetric_->readCacheMetric));
+    }
+
     LOG(INFO) << "iomanager init success, conf info: "
               << "isolationTaskThreadPoolSize = "
               << ioopt_.taskThreadOpt.isolationTaskThreadPoolSize
@@ -134,6 +139,7 @@ void IOManager4File::UnInitialize() {
         exit_ = true;
 
         delete scheduler_;
+        readCache_.reset();
         delete fileMetric_;
         scheduler_ = nullptr;
         fileMetric_ = nullptr;
@@ -149,6 +155,7 @@ int IOManager4File::Read(char* buf, off_t offset,
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_, disableStripe_);
     temp.SetUserDataType(UserDataType::IOBuffer);
+    temp.SetReadCache(readCache_.get());
     temp.StartRead(&data, offset, length, mdsclient, this->GetFileInfo(),
                    throttle_.get());
 
@@ -174,6 +181,7 @@ int IOManager4File::Write(const char* buf,
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_, disableStripe_);
     temp.SetUserDataType(UserDataType::IOBuffer);
+    temp.SetReadCache(readCache_.get());
     temp.StartWrite(&data, offset, length, mdsclient, this->GetFileInfo(),
                     throttle_.get());
 
@@ -195,6 +203,7 @@ int IOManager4File::AioRead(CurveAioContext* ctx, MDSClient* mdsclient,
     }
 
     temp->SetUserDataType(dataType);
+    temp->SetReadCache(readCache_.get());
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
         temp->StartAioRead(ctx, mdsclient, this->GetFileInfo(),
@@ -219,6 +228,7 @@ int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient,
     }
 
     temp->SetUserDataType(dataType);
+    temp->SetReadCache(readCache_.get());
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
         temp->StartAioWrite(ctx, mdsclient, this->GetFileInfo(),
@@ -288,6 +298,10 @@ void IOManager4File::SetDisableStripe() {
     disableStripe_ = true;
 }
 
+void IOManager4File::DisableReadCache() {
+    readCache_.reset();
+}
+
 void IOManager4File::HandleAsyncIOResponse(IOTracker* iotracker) {
     inflightCntl_.DecremInflightNum();
     delete iotracker;
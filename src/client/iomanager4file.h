@@ -43,6 +43,7 @@
 #include "src/common/concurrent/task_thread_pool.h"
 #include "src/common/throttle.h"
 #include "src/client/discard_task.h"
+#include "src/client/read_cache.h"
 
 namespace curve {
 namespace client {
@@ -208,6 +209,18 @@ class IOManager4File : public IOManager {
 
     void SetDisableStripe();
 
+    /**
+     * @brief disable read cache, used for files opened with directIO
+     */
+    void DisableReadCache();
+
+    /**
+     * 获取读缓存，测试使用
+     */
+    ReadCache* GetReadCache() {
+        return readCache_.get();
+    }
+
  private:
     friend class LeaseExecutor;
     friend class FlightIOGuard;
@@ -298,6 +311,9 @@ class IOManager4File : public IOManager {
     bool disableStripe_;
 
     std::unique_ptr<DiscardTaskManager> discardTaskManager_;
+
+    // read cache of this file, nullptr if disabled
+    std::unique_ptr<ReadCache> readCache_;
 };
 
 }  // namespace client
@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "src/client/read_cache.h"
+
+#include <glog/logging.h>
+
+namespace curve {
+namespace client {
+
+using curve::common::CacheEvictPolicy;
+using curve::common::CacheTraits;
+using curve::common::ShardedLRUCache;
+
+constexpr uint64_t ReadCache::kNoFill;
+constexpr uint32_t ReadCache::kStripeNum;
+constexpr uint32_t ReadCache::kShardNum;
+
+ReadCache::ReadCache(const ReadCacheOption& option, ReadCacheMetric* metric)
+    : blockSize_(option.blockSize == 0 ? 4096 : option.blockSize),
+      metric_(metric) {
+    uint64_t capacity = option.capacityMB * 1024 * 1024 / blockSize_;
+    if (capacity == 0) {
+        capacity = 1;
+    }
+    cache_.reset(new ShardedLRUCache<ReadCacheKey, butil::IOBuf,
+                                     CacheTraits<ReadCacheKey>,
+                                     ReadCacheValueTraits>(
+        capacity, kShardNum, CacheEvictPolicy::CLOCK));
+    LOG(INFO) << "read cache init, capacity = " << option.capacityMB
+              << "MB, block size = " << blockSize_;
+}
+
+uint64_t ReadCache::GetVersion(ChunkID chunkId) {
+    std::lock_guard<std::mutex> lk(StripeLock(chunkId));
+    return StripeVersion(chunkId);
+}
+
+bool ReadCache::Read(ChunkID chunkId, uint64_t offset, uint64_t length,
+                     butil::IOBuf* data) {
+    if (length == 0) {
+        return false;
+    }
+
+    uint64_t first = offset / blockSize_;
+    uint64_t last = (offset + length - 1) / blockSize_;
+    butil::IOBuf blocks;
+    butil::IOBuf block;
+    for (uint64_t index = first; index <= last; ++index) {
+        if (!cache_->Get(ReadCacheKey{chunkId, index}, &block)) {
+            if (metric_ != nullptr) {
+                metric_->miss << 1;
+            }
+            return false;
+        }
+        blocks.append(block);
+    }
+
+    blocks.append_to(data, length, offset - first * blockSize_);
+    if (metric_ != nullptr) {
+        metric_->hit << 1;
+        metric_->hitBytes << length;
+    }
+    return true;
+}
+
+void ReadCache::Fill(ChunkID chunkId, uint64_t offset,
+                     const butil::IOBuf& data, uint64_t version) {
+    if (version == kNoFill) {
+        return;
+    }
+
+    // 只缓存完整落在data中的block
+    uint64_t first = (offset + blockSize_ - 1) / blockSize_;
+    uint64_t end = (offset + data.size()) / blockSize_;
+    if (first >= end) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lk(StripeLock(chunkId));
+    if (StripeVersion(chunkId) != version) {
+        // 读的过程中有写，读到的可能是旧数据
+        return;
+    }
+    for (uint64_t index = first; index < end; ++index) {
+        butil::IOBuf block;
+        data.append_to(&block, blockSize_, index * blockSize_ - offset);
+        cache_->Put(ReadCacheKey{chunkId, index}, block);
+    }
+}
+
+void ReadCache::Invalidate(ChunkID chunkId, uint64_t offset,
+                           uint64_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    uint64_t first = offset / blockSize_;
+    uint64_t last = (offset + length - 1) / blockSize_;
+    std::lock_guard<std::mutex> lk(StripeLock(chunkId));
+    ++StripeVersion(chunkId);
+    for (uint64_t index = first; index <= last; ++index) {
+        cache_->Remove(ReadCacheKey{chunkId, index});
+    }
+    if (metric_ != nullptr) {
+        metric_->invalidate << 1;
+    }
+}
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,146 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef SRC_CLIENT_READ_CACHE_H_
+#define SRC_CLIENT_READ_CACHE_H_
+
+#include <butil/iobuf.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+
+#include "src/client/client_common.h"
+#include "src/client/client_metric.h"
+#include "src/client/config_info.h"
+#include "src/common/lru_cache.h"
+
+namespace curve {
+namespace client {
+
+// 缓存的key，chunk内的第index个block
+struct ReadCacheKey {
+    ChunkID chunkId;
+    uint64_t index;
+
+    bool operator==(const ReadCacheKey& other) const {
+        return chunkId == other.chunkId && index == other.index;
+    }
+};
+
+}  // namespace client
+}  // namespace curve
+
+namespace std {
+template <>
+struct hash<curve::client::ReadCacheKey> {
+    size_t operator()(const curve::client::ReadCacheKey& key) const {
+        // chunkId占高位，同一个chunk的block分散到不同的分片
+        return std::hash<uint64_t>()(key.chunkId * 0x9E3779B97F4A7C15ULL
+                                     + key.index);
+    }
+};
+}  // namespace std
+
+namespace curve {
+namespace client {
+
+struct ReadCacheValueTraits {
+    static uint64_t CountBytes(const butil::IOBuf& value) {
+        return value.size();
+    }
+};
+
+/**
+ * 文件级别的读缓存，以(chunkid, block)为单位缓存从chunkserver读到的数据
+ * 只缓存chunk存在时从chunkserver读到的数据，克隆卷从源卷读的数据不缓存
+ * 当前client的写会让对应的block失效，因此只适用于单client写或者只读的文件
+ */
+class ReadCache {
+ public:
+    static constexpr uint64_t kNoFill = UINT64_MAX;
+
+    ReadCache(const ReadCacheOption& option, ReadCacheMetric* metric);
+
+    /**
+     * 获取chunk当前的版本，发起读请求前调用，读请求返回后传给Fill
+     * 期间如果有写让这个chunk的缓存失效，读到的数据就不会被缓存
+     */
+    uint64_t GetVersion(ChunkID chunkId);
+
+    /**
+     * 从缓存中读取chunk内[offset, offset + length)的数据
+     * @return 全部命中返回true，否则返回false并且不修改data
+     */
+    bool Read(ChunkID chunkId, uint64_t offset, uint64_t length,
+              butil::IOBuf* data);
+
+    /**
+     * 缓存从chunkserver读到的数据，只有完整的block才会被缓存
+     * @param offset: data在chunk内的偏移
+     * @param version: 发起读请求前通过GetVersion获取的版本
+     */
+    void Fill(ChunkID chunkId, uint64_t offset, const butil::IOBuf& data,
+              uint64_t version);
+
+    /**
+     * 让chunk内与[offset, offset + length)重叠的block失效
+     * 写请求下发前和返回后都需要调用
+     */
+    void Invalidate(ChunkID chunkId, uint64_t offset, uint64_t length);
+
+    uint64_t Size() {
+        return cache_->Size();
+    }
+
+ private:
+    std::mutex& StripeLock(ChunkID chunkId) {
+        return stripes_[chunkId % kStripeNum].lock;
+    }
+
+    uint64_t& StripeVersion(ChunkID chunkId) {
+        return stripes_[chunkId % kStripeNum].version;
+    }
+
+ private:
+    static constexpr uint32_t kStripeNum = 64;
+    static constexpr uint32_t kShardNum = 16;
+
+    struct Stripe {
+        std::mutex lock;
+        // 每次失效都会增加版本号
+        uint64_t version = 0;
+    };
+
+    uint32_t blockSize_;
+    ReadCacheMetric* metric_;
+    Stripe stripes_[kStripeNum];
+    std::unique_ptr<curve::common::ShardedLRUCache<
+        ReadCacheKey, butil::IOBuf, curve::common::CacheTraits<ReadCacheKey>,
+        ReadCacheValueTraits>> cache_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_READ_CACHE_H_
@@ -23,6 +23,8 @@
 #include "src/client/request_closure.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "src/client/io_tracker.h"
 #include "src/client/iomanager.h"
@@ -183,5 +185,52 @@ void PaddingReadClosure::HandleError(int errCode) {
                << ", error: " << errCode;
 }
 
+CoalescedWriteClosure::CoalescedWriteClosure(
+    std::vector<RequestContext*> requests)
+    : RequestClosure(requests.front()),
+      requests_(std::move(requests)),
+      coalescedCtx_(new RequestContext()) {
+    RequestClosure* first = reqCtx_->done_;
+    tracker_ = first->GetIOTracker();
+    SetFileMetric(first->GetMetric());
+    SetIOManager(first->GetIOManager());
+
+    coalescedCtx_->optype_ = OpType::WRITE;
+    coalescedCtx_->padding.aligned = true;
+    coalescedCtx_->idinfo_ = reqCtx_->idinfo_;
+    coalescedCtx_->offset_ = reqCtx_->offset_;
+    coalescedCtx_->rawlength_ = 0;
+    coalescedCtx_->done_ = this;
+    coalescedCtx_->seq_ = reqCtx_->seq_;
+    coalescedCtx_->sourceInfo_ = reqCtx_->sourceInfo_;
+    for (auto* req : requests_) {
+        // only reference the data blocks, no copy
+        coalescedCtx_->writeData_.append(req->writeData_);
+        coalescedCtx_->rawlength_ += req->rawlength_;
+    }
+}
+
+void CoalescedWriteClosure::Run() {
+    std::unique_ptr<CoalescedWriteClosure> selfGuard(this);
+    std::unique_ptr<RequestContext> ctxGuard(coalescedCtx_);
+
+    ReleaseInflightRPCToken();
+    if (IsSuspendRPC()) {
+        MetricHelper::DecremIOSuspendNum(GetMetric());
+    }
+
+    const int errCode = GetErrorCode();
+    if (errCode != 0) {
+        LOG(ERROR) << "Coalesced write request failed, request: "
+                   << *coalescedCtx_ << ", count: " << requests_.size()
+                   << ", error: " << errCode;
+    }
+
+    for (auto* req : requests_) {
+        req->done_->SetFailed(errCode);
+        req->done_->Run();
+    }
+}
+
 }  // namespace client
 }  // namespace curve
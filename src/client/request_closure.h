@@ -26,6 +26,8 @@
 // for Closure
 #include <google/protobuf/stubs/callback.h>
 
+#include <vector>
+
 #include "include/curve_compiler_specific.h"
 #include "src/client/client_common.h"
 
@@ -98,6 +100,10 @@ class CURVE_CACHELINE_ALIGNMENT RequestClosure
         ioManager_ = ioManager;
     }
 
+    IOManager* GetIOManager() const {
+        return ioManager_;
+    }
+
     /**
      * @brief 设置当前closure重试次数
      */
@@ -222,6 +228,30 @@ class PaddingReadClosure : public RequestClosure {
     RequestScheduler* scheduler_;
 };
 
+// CoalescedWriteClosure is used to send contiguous write requests of the
+// same chunk in one rpc, and complete every original request when it returns
+class CoalescedWriteClosure : public RequestClosure {
+ public:
+    explicit CoalescedWriteClosure(std::vector<RequestContext*> requests);
+
+    void Run() override;
+
+    RequestContext* GetReqCtx() override {
+        return coalescedCtx_;
+    }
+
+    RequestContext* CoalescedRequest() const {
+        return coalescedCtx_;
+    }
+
+ private:
+    // original write requests, sorted by offset
+    std::vector<RequestContext*> requests_;
+
+    // the write request sent to chunkserver
+    RequestContext* coalescedCtx_;
+};
+
 }  // namespace client
 }  // namespace curve
 
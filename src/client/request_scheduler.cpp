@@ -25,13 +25,19 @@
 #include <brpc/closure_guard.h>
 #include <glog/logging.h>
 
+#include <utility>
+
+#include "src/client/client_metric.h"
 #include "src/client/request_context.h"
 #include "src/client/request_closure.h"
 #include "src/client/chunk_closure.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace client {
 
+using curve::common::TimeUtility;
+
 RequestScheduler::~RequestScheduler() {}
 
 int RequestScheduler::Init(const RequestScheduleOption& reqSchdulerOpt,
@@ -39,6 +45,7 @@ int RequestScheduler::Init(const RequestScheduleOption& reqSchdulerOpt,
                            FileMetric* fm) {
     blockIO_.store(false);
     reqschopt_ = reqSchdulerOpt;
+    fileMetric_ = fm;
 
     int rc = 0;
     rc = queue_.Init(reqschopt_.scheduleQueueCapacity);
@@ -61,7 +68,11 @@ int RequestScheduler::Init(const RequestScheduleOption& reqSchdulerOpt,
               << "scheduleQueueCapacity = "
               << reqschopt_.scheduleQueueCapacity
               << ", scheduleThreadpoolSize = "
-              << reqschopt_.scheduleThreadpoolSize;
+              << reqschopt_.scheduleThreadpoolSize
+              << ", writeCoalesceMaxBytes = "
+              << reqschopt_.writeCoalesceMaxBytes
+              << ", writeCoalesceWindowUs = "
+              << reqschopt_.writeCoalesceWindowUs;
     return 0;
 }
 
@@ -148,7 +159,10 @@ void RequestScheduler::Process() {
         BBQItem<RequestContext*> item = queue_.TakeFront();
         if (!item.IsStop()) {
             RequestContext* req = item.Item();
-            if (req->padding.aligned) {
+            if (req->padding.aligned && req->optype_ == OpType::WRITE &&
+                reqschopt_.writeCoalesceMaxBytes > 0) {
+                ProcessCoalescedWrite(req);
+            } else if (req->padding.aligned) {
                 ProcessAligned(req);
             } else {
                 ProcessUnaligned(req);
@@ -206,6 +220,64 @@ void RequestScheduler::ProcessAligned(RequestContext* ctx) {
     }
 }
 
+void RequestScheduler::ProcessCoalescedWrite(RequestContext* ctx) {
+    // 克隆卷的写请求需要携带源文件信息，不参与合并
+    if (ctx->sourceInfo_.IsValid()) {
+        ProcessAligned(ctx);
+        return;
+    }
+
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
+    uint64_t deadlineUs = startUs + reqschopt_.writeCoalesceWindowUs;
+    std::vector<RequestContext*> requests{ctx};
+    uint64_t nextOffset = ctx->offset_ + ctx->rawlength_;
+    uint64_t bytes = ctx->rawlength_;
+
+    auto coalescable = [&](BBQItem<RequestContext*>& item) {
+        if (item.IsStop()) {
+            return false;
+        }
+        RequestContext* next = item.Item();
+        return next->padding.aligned && next->optype_ == OpType::WRITE &&
+               !next->sourceInfo_.IsValid() &&
+               next->idinfo_.cid_ == ctx->idinfo_.cid_ &&
+               next->idinfo_.cpid_ == ctx->idinfo_.cpid_ &&
+               next->idinfo_.lpid_ == ctx->idinfo_.lpid_ &&
+               next->seq_ == ctx->seq_ &&
+               static_cast<uint64_t>(next->offset_) == nextOffset &&
+               bytes + next->rawlength_ <= reqschopt_.writeCoalesceMaxBytes;
+    };
+
+    while (bytes < reqschopt_.writeCoalesceMaxBytes) {
+        uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+        uint64_t waitUs = nowUs < deadlineUs ? deadlineUs - nowUs : 0;
+        BBQItem<RequestContext*> item(nullptr);
+        if (!queue_.TakeFrontIf(coalescable, waitUs, &item)) {
+            break;
+        }
+        RequestContext* next = item.Item();
+        requests.push_back(next);
+        nextOffset += next->rawlength_;
+        bytes += next->rawlength_;
+    }
+
+    if (fileMetric_ != nullptr) {
+        auto& metric = fileMetric_->writeCoalesceMetric;
+        metric.requests << requests.size();
+        metric.rpcs << 1;
+        metric.addedLatency << TimeUtility::GetTimeofDayUs() - startUs;
+    }
+
+    if (requests.size() == 1) {
+        ProcessAligned(ctx);
+        return;
+    }
+
+    CoalescedWriteClosure* done =
+        new CoalescedWriteClosure(std::move(requests));
+    ProcessAligned(done->CoalescedRequest());
+}
+
 void RequestScheduler::ProcessUnaligned(RequestContext* ctx) {
     brpc::ClosureGuard doneGuard(ctx->done_);
     if (ctx->optype_ != OpType::READ && ctx->optype_ != OpType::WRITE) {
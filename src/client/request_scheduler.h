@@ -52,7 +52,8 @@ class RequestScheduler : public Uncopyable {
         : running_(false),
           stop_(true),
           client_(),
-          blockingQueue_(true) {}
+          blockingQueue_(true),
+          fileMetric_(nullptr) {}
     virtual ~RequestScheduler();
 
     /**
@@ -142,6 +143,11 @@ class RequestScheduler : public Uncopyable {
 
     void ProcessUnaligned(RequestContext* ctx);
 
+    /**
+     * 将队列中紧随其后的同一chunk上地址连续的写请求与ctx合并为一个rpc发送
+     */
+    void ProcessCoalescedWrite(RequestContext* ctx);
+
     void WaitValidSession() {
         // lease续约失败的时候需要阻塞IO直到续约成功
         if (blockIO_.load(std::memory_order_acquire) && blockingQueue_) {
@@ -176,6 +182,8 @@ class RequestScheduler : public Uncopyable {
     std::condition_variable leaseRefreshcv_;
     // 阻塞队列
     bool blockingQueue_;
+    // 文件的metric信息
+    FileMetric* fileMetric_;
 };
 
 }   // namespace client
@@ -20,8 +20,12 @@
  * Author: yangyaokai
  */
 
+#include <endian.h>
 #include <glog/logging.h>
 #include <memory.h>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 #include <utility>
 #include <string>
 #include "src/common/bitmap.h"
@@ -42,6 +46,107 @@ std::string BitRangeVecToString(const std::vector<BitRange> &ranges) {
 
 const uint32_t Bitmap::NO_POS = 0xFFFFFFFF;
 
+namespace {
+
+const uint32_t kWordBits = 64;
+const uint32_t kWordBytes = 8;
+const uint64_t kAllOnes = ~0ULL;
+
+// 按小端序读取第wordIndex个64位字，bitmap末尾不足8字节的部分补0
+inline uint64_t LoadWord(const char* bitmap, uint32_t bytes,
+                         uint32_t wordIndex) {
+    uint64_t word = 0;
+    uint32_t offset = wordIndex * kWordBytes;
+    uint32_t len = bytes - offset < kWordBytes ? bytes - offset : kWordBytes;
+    memcpy(&word, bitmap + offset, len);
+    return le64toh(word);
+}
+
+#if defined(__x86_64__)
+// 以32字节为单位跳过[wordIndex, lastWord)中全0（找1时）或全1（找0时）的字，
+// 返回第一个不能整块跳过的字的索引
+__attribute__((target("avx2")))
+uint32_t SkipWordsAVX2(const char* bitmap, uint32_t wordIndex,
+                       uint32_t lastWord, bool set) {
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    while (wordIndex + 4 <= lastWord) {
+        __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(bitmap + wordIndex * kWordBytes));
+        bool skip = set ? _mm256_testz_si256(v, v)
+                        : _mm256_testc_si256(v, ones);
+        if (!skip)
+            break;
+        wordIndex += 4;
+    }
+    return wordIndex;
+}
+
+bool CpuSupportsAVX2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+inline uint32_t SkipWords(const char* bitmap, uint32_t wordIndex,
+                          uint32_t lastWord, bool set) {
+#if defined(__x86_64__)
+    if (CpuSupportsAVX2())
+        return SkipWordsAVX2(bitmap, wordIndex, lastWord, set);
+#endif
+    // 没有AVX2时由调用方逐个字扫描
+    return wordIndex;
+}
+
+// 在[startIndex, endIndex]中查找第一个值为set的位，调用方保证范围合法
+uint32_t FindFirst(const char* bitmap, uint32_t bytes, uint32_t startIndex,
+                   uint32_t endIndex, bool set) {
+    // 找0时先取反，统一成找1
+    const uint64_t flip = set ? 0 : kAllOnes;
+    uint32_t wordIndex = startIndex / kWordBits;
+    const uint32_t lastWord = endIndex / kWordBits;
+    uint64_t word = (LoadWord(bitmap, bytes, wordIndex) ^ flip)
+                  & (kAllOnes << (startIndex % kWordBits));
+    while (wordIndex < lastWord) {
+        if (word != 0)
+            return wordIndex * kWordBits + __builtin_ctzll(word);
+        wordIndex = SkipWords(bitmap, wordIndex + 1, lastWord, set);
+        word = LoadWord(bitmap, bytes, wordIndex) ^ flip;
+    }
+    word &= kAllOnes >> (kWordBits - 1 - endIndex % kWordBits);
+    if (word == 0)
+        return Bitmap::NO_POS;
+    return wordIndex * kWordBits + __builtin_ctzll(word);
+}
+
+// 将[startIndex, endIndex]置为set，首尾不完整的字节单独处理，中间整字节memset
+void FillRange(char* bitmap, uint32_t startIndex, uint32_t endIndex,
+               bool set) {
+    uint32_t firstByte = startIndex >> ALIGN_FACTOR;
+    uint32_t lastByte = endIndex >> ALIGN_FACTOR;
+    unsigned char headMask = 0xff << (startIndex % BITMAP_UNIT_SIZE);
+    unsigned char tailMask =
+        0xff >> (BITMAP_UNIT_SIZE - 1 - endIndex % BITMAP_UNIT_SIZE);
+    auto apply = [bitmap, set](uint32_t byte, unsigned char mask) {
+        if (set)
+            bitmap[byte] |= mask;
+        else
+            bitmap[byte] &= ~mask;
+    };
+
+    if (firstByte == lastByte) {
+        apply(firstByte, headMask & tailMask);
+        return;
+    }
+    apply(firstByte, headMask);
+    if (lastByte > firstByte + 1) {
+        memset(bitmap + firstByte + 1, set ? 0xff : 0,
+               lastByte - firstByte - 1);
+    }
+    apply(lastByte, tailMask);
+}
+
+}  // namespace
+
 Bitmap::Bitmap(uint32_t bits) : bits_(bits) {
     int count = unitCount();
     bitmap_ = new(std::nothrow) char[count];
@@ -121,10 +226,11 @@ void Bitmap::Set(uint32_t index) {
 }
 
 void Bitmap::Set(uint32_t startIndex, uint32_t endIndex) {
-    // TODO(wuhanqing): implement fast algorithm if one byte is all set
-    for (uint32_t index = startIndex; index <= endIndex; ++index) {
-        Set(index);
-    }
+    if (startIndex > endIndex || startIndex >= bits_)
+        return;
+    if (endIndex >= bits_)
+        endIndex = bits_ - 1;
+    FillRange(bitmap_, startIndex, endIndex, true);
 }
 
 void Bitmap::Clear() {
@@ -137,10 +243,11 @@ void Bitmap::Clear(uint32_t index) {
 }
 
 void Bitmap::Clear(uint32_t startIndex, uint32_t endIndex) {
-    // TODO(wuhanqing): implement fast algorithm if one byte is all clear
-    for (uint32_t index = startIndex; index <= endIndex; ++index) {
-        Clear(index);
-    }
+    if (startIndex > endIndex || startIndex >= bits_)
+        return;
+    if (endIndex >= bits_)
+        endIndex = bits_ - 1;
+    FillRange(bitmap_, startIndex, endIndex, false);
 }
 
 bool Bitmap::Test(uint32_t index) const {
@@ -151,54 +258,57 @@ bool Bitmap::Test(uint32_t index) const {
 }
 
 uint32_t Bitmap::NextSetBit(uint32_t index) const {
-    for (; index < bits_; ++index) {
-        if (Test(index))
-            break;
-    }
     if (index >= bits_)
-        index = NO_POS;
-    return index;
+        return NO_POS;
+    return FindFirst(bitmap_, unitCount(), index, bits_ - 1, true);
 }
 
 uint32_t Bitmap::NextSetBit(uint32_t startIndex, uint32_t endIndex) const {
-    uint32_t index = startIndex;
     // bitmap中最后一个bit的index值
     uint32_t lastIndex = bits_ - 1;
     // endIndex值不能超过lastIndex
     if (endIndex > lastIndex)
         endIndex = lastIndex;
-    for (; index <= endIndex; ++index) {
-        if (Test(index))
-            break;
-    }
-    if (index > endIndex)
-        index = NO_POS;
-    return index;
+    if (bits_ == 0 || startIndex > endIndex)
+        return NO_POS;
+    return FindFirst(bitmap_, unitCount(), startIndex, endIndex, true);
 }
 
 uint32_t Bitmap::NextClearBit(uint32_t index) const {
-    for (; index < bits_; ++index) {
-        if (!Test(index))
-            break;
-    }
     if (index >= bits_)
-        index = NO_POS;
-    return index;
+        return NO_POS;
+    return FindFirst(bitmap_, unitCount(), index, bits_ - 1, false);
 }
 
 uint32_t Bitmap::NextClearBit(uint32_t startIndex, uint32_t endIndex) const {
-    uint32_t index = startIndex;
     uint32_t lastIndex = bits_ - 1;
     // endIndex值不能超过lastIndex
     if (endIndex > lastIndex)
         endIndex = lastIndex;
-    for (; index <= endIndex; ++index) {
-        if (!Test(index))
-            break;
+    if (bits_ == 0 || startIndex > endIndex)
+        return NO_POS;
+    return FindFirst(bitmap_, unitCount(), startIndex, endIndex, false);
+}
+
+uint32_t Bitmap::Count(uint32_t startIndex, uint32_t endIndex) const {
+    uint32_t lastIndex = bits_ - 1;
+    if (endIndex > lastIndex)
+        endIndex = lastIndex;
+    if (bits_ == 0 || startIndex > endIndex)
+        return 0;
+
+    const uint32_t bytes = unitCount();
+    uint32_t wordIndex = startIndex / kWordBits;
+    const uint32_t lastWord = endIndex / kWordBits;
+    uint64_t word = LoadWord(bitmap_, bytes, wordIndex)
+                  & (kAllOnes << (startIndex % kWordBits));
+    uint32_t count = 0;
+    while (wordIndex < lastWord) {
+        count += __builtin_popcountll(word);
+        word = LoadWord(bitmap_, bytes, ++wordIndex);
     }
-    if (index > endIndex)
-        index = NO_POS;
-    return index;
+    word &= kAllOnes >> (kWordBits - 1 - endIndex % kWordBits);
+    return count + __builtin_popcountll(word);
 }
 
 void Bitmap::Divide(uint32_t startIndex,
@@ -153,6 +153,13 @@ class Bitmap {
      * @return: 首个位为0的位置，如果指定范围内不存在则返回NO_POS
      */
     uint32_t NextClearBit(uint32_t startIndex, uint32_t endIndex) const;
+    /**
+     * 统计指定起始位置到结束位置之间位为1的个数
+     * @param startIndex: 起始位置，包含此位置
+     * @param endIndex: 结束位置，包含此位置，超过bitmap范围的部分会被忽略
+     * @return: 指定范围内位为1的个数
+     */
+    uint32_t Count(uint32_t startIndex, uint32_t endIndex) const;
     /**
      * 将bitmap的指定区域分割成若干连续区域，划分依据为位状态，连续区域内的位状态一致
      * 例如：00011100会被划分为三个区域，[0,2]、[3,5]、[6,7]
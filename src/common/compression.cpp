@@ -0,0 +1,298 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "src/common/compression.h"
+
+#include <glog/logging.h>
+#include <lz4.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "src/common/crc32.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+constexpr uint32_t kFrameMagic = 0x43505a31;  // "CPZ1"
+constexpr uint8_t kFrameVersion = 1;
+
+// how the payload of a frame is encoded
+enum class FrameCodec : uint8_t {
+    kStored = 0,
+    kLZ4 = 1,
+    kZlib = 2,
+    kZero = 3,
+};
+
+struct FrameHeader {
+    uint8_t version;
+    FrameCodec codec;
+    uint32_t rawSize;
+    uint32_t payloadSize;
+    uint32_t crc;
+};
+
+void EncodeFixed32(char* buf, uint32_t value) {
+    buf[0] = static_cast<char>(value & 0xff);
+    buf[1] = static_cast<char>((value >> 8) & 0xff);
+    buf[2] = static_cast<char>((value >> 16) & 0xff);
+    buf[3] = static_cast<char>((value >> 24) & 0xff);
+}
+
+uint32_t DecodeFixed32(const char* buf) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(buf);
+    return static_cast<uint32_t>(p[0]) |
+           (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void EncodeHeader(const FrameHeader& header, char* buf) {
+    EncodeFixed32(buf, kFrameMagic);
+    buf[4] = static_cast<char>(header.version);
+    buf[5] = static_cast<char>(header.codec);
+    buf[6] = 0;
+    buf[7] = 0;
+    EncodeFixed32(buf + 8, header.rawSize);
+    EncodeFixed32(buf + 12, header.payloadSize);
+    EncodeFixed32(buf + 16, header.crc);
+}
+
+bool DecodeHeader(const char* buf, FrameHeader* header) {
+    if (DecodeFixed32(buf) != kFrameMagic) {
+        LOG(ERROR) << "Invalid compression frame magic";
+        return false;
+    }
+    header->version = static_cast<uint8_t>(buf[4]);
+    header->codec = static_cast<FrameCodec>(buf[5]);
+    header->rawSize = DecodeFixed32(buf + 8);
+    header->payloadSize = DecodeFixed32(buf + 12);
+    header->crc = DecodeFixed32(buf + 16);
+    if (header->version != kFrameVersion) {
+        LOG(ERROR) << "Unsupported compression frame version: "
+                   << static_cast<int>(header->version);
+        return false;
+    }
+    return true;
+}
+
+// compress one frame into `dst`, return the payload size,
+// or 0 if the codec fails or the data doesn't shrink
+size_t CompressFrame(CompressionType type, const char* data, size_t len,
+                     char* dst, size_t capacity) {
+    switch (type) {
+        case CompressionType::kLZ4: {
+            int ret = LZ4_compress_default(data, dst, static_cast<int>(len),
+                                           static_cast<int>(capacity));
+            return ret > 0 && static_cast<size_t>(ret) < len ? ret : 0;
+        }
+        case CompressionType::kZlib: {
+            uLongf dstLen = capacity;
+            int ret = compress2(reinterpret_cast<Bytef*>(dst), &dstLen,
+                                reinterpret_cast<const Bytef*>(data), len,
+                                Z_BEST_SPEED);
+            return ret == Z_OK && dstLen < len ? dstLen : 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+size_t CompressBound(CompressionType type, size_t len) {
+    switch (type) {
+        case CompressionType::kLZ4:
+            return LZ4_compressBound(static_cast<int>(len));
+        case CompressionType::kZlib:
+            return compressBound(len);
+        default:
+            return len;
+    }
+}
+
+bool DecompressFrame(const FrameHeader& header, const char* payload,
+                     char* dst) {
+    switch (header.codec) {
+        case FrameCodec::kStored:
+            if (header.payloadSize != header.rawSize) {
+                return false;
+            }
+            memcpy(dst, payload, header.rawSize);
+            return true;
+        case FrameCodec::kZero:
+            memset(dst, 0, header.rawSize);
+            return header.payloadSize == 0;
+        case FrameCodec::kLZ4: {
+            int ret = LZ4_decompress_safe(
+                payload, dst, static_cast<int>(header.payloadSize),
+                static_cast<int>(header.rawSize));
+            return ret >= 0 && static_cast<uint32_t>(ret) == header.rawSize;
+        }
+        case FrameCodec::kZlib: {
+            uLongf dstLen = header.rawSize;
+            int ret = uncompress(reinterpret_cast<Bytef*>(dst), &dstLen,
+                                 reinterpret_cast<const Bytef*>(payload),
+                                 header.payloadSize);
+            return ret == Z_OK && dstLen == header.rawSize;
+        }
+        default:
+            LOG(ERROR) << "Unknown compression frame codec: "
+                       << static_cast<int>(header.codec);
+            return false;
+    }
+}
+
+}  // namespace
+
+bool StringToCompressionType(const std::string& str, CompressionType* type) {
+    if (str == "none" || str.empty()) {
+        *type = CompressionType::kNone;
+    } else if (str == "lz4") {
+        *type = CompressionType::kLZ4;
+    } else if (str == "zlib") {
+        *type = CompressionType::kZlib;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* CompressionTypeToString(CompressionType type) {
+    switch (type) {
+        case CompressionType::kNone:
+            return "none";
+        case CompressionType::kLZ4:
+            return "lz4";
+        case CompressionType::kZlib:
+            return "zlib";
+        default:
+            return "unknown";
+    }
+}
+
+bool IsAllZero(const char* data, size_t len) {
+    // compare word by word, the tail byte by byte
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        if (word != 0) {
+            return false;
+        }
+    }
+    for (; i < len; ++i) {
+        if (data[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CompressData(CompressionType type, const char* data, size_t len,
+                  std::string* out) {
+    size_t offset = 0;
+    do {
+        size_t frameLen = std::min(len - offset, kCompressionFrameSize);
+        const char* frame = data + offset;
+
+        FrameHeader header;
+        header.version = kFrameVersion;
+        header.rawSize = frameLen;
+        header.crc = CRC32(frame, frameLen);
+
+        size_t headerPos = out->size();
+        if (IsAllZero(frame, frameLen)) {
+            header.codec = FrameCodec::kZero;
+            header.payloadSize = 0;
+            out->resize(headerPos + kCompressionFrameHeaderSize);
+        } else {
+            size_t bound = CompressBound(type, frameLen);
+            out->resize(headerPos + kCompressionFrameHeaderSize + bound);
+            char* payload = &(*out)[headerPos + kCompressionFrameHeaderSize];
+            size_t payloadSize =
+                CompressFrame(type, frame, frameLen, payload, bound);
+            if (payloadSize != 0) {
+                header.codec = type == CompressionType::kLZ4
+                                   ? FrameCodec::kLZ4
+                                   : FrameCodec::kZlib;
+            } else {
+                header.codec = FrameCodec::kStored;
+                payloadSize = frameLen;
+                out->resize(headerPos + kCompressionFrameHeaderSize +
+                            frameLen);
+                payload = &(*out)[headerPos + kCompressionFrameHeaderSize];
+                memcpy(payload, frame, frameLen);
+            }
+            header.payloadSize = payloadSize;
+            out->resize(headerPos + kCompressionFrameHeaderSize +
+                        payloadSize);
+        }
+        EncodeHeader(header, &(*out)[headerPos]);
+        offset += frameLen;
+    } while (offset < len);
+}
+
+bool DecompressData(const char* data, size_t len, std::string* out) {
+    size_t offset = 0;
+    while (offset < len) {
+        FrameHeader header;
+        if (len - offset < kCompressionFrameHeaderSize ||
+            !DecodeHeader(data + offset, &header)) {
+            LOG(ERROR) << "Decode compression frame header failed, offset: "
+                       << offset << ", len: " << len;
+            return false;
+        }
+        offset += kCompressionFrameHeaderSize;
+        if (len - offset < header.payloadSize ||
+            header.rawSize > kCompressionFrameSize) {
+            LOG(ERROR) << "Compression frame truncated, offset: " << offset
+                       << ", payload size: " << header.payloadSize
+                       << ", raw size: " << header.rawSize
+                       << ", len: " << len;
+            return false;
+        }
+
+        size_t rawPos = out->size();
+        out->resize(rawPos + header.rawSize);
+        char* raw = header.rawSize == 0 ? nullptr : &(*out)[rawPos];
+        if (header.rawSize != 0 &&
+            !DecompressFrame(header, data + offset, raw)) {
+            LOG(ERROR) << "Decompress frame failed, codec: "
+                       << static_cast<int>(header.codec)
+                       << ", offset: " << offset;
+            return false;
+        }
+        if (CRC32(raw, header.rawSize) != header.crc) {
+            LOG(ERROR) << "Compression frame crc mismatch, offset: "
+                       << offset;
+            return false;
+        }
+        offset += header.payloadSize;
+    }
+    return true;
+}
+
+}  // namespace common
+}  // namespace curve
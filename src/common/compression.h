@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef SRC_COMMON_COMPRESSION_H_
+#define SRC_COMMON_COMPRESSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace curve {
+namespace common {
+
+enum class CompressionType : uint8_t {
+    kNone = 0,
+    kLZ4 = 1,
+    kZlib = 2,
+};
+
+/**
+ * @brief parse compression type from config, e.g. "none", "lz4", "zlib"
+ * @return false if the type is unknown
+ */
+bool StringToCompressionType(const std::string& str, CompressionType* type);
+
+const char* CompressionTypeToString(CompressionType type);
+
+/**
+ * @brief check whether all bytes of the buffer are zero
+ */
+bool IsAllZero(const char* data, size_t len);
+
+/**
+ * Compressed data is a sequence of frames, every frame has a small header
+ * that describes how to restore it:
+ *
+ *   | magic | version | codec | reserved | raw size | payload size | crc |
+ *   |   4   |    1    |   1   |    2     |    4     |      4       |  4  |
+ *
+ * - the input is split into frames of at most `kCompressionFrameSize` bytes
+ * - an all-zero frame has no payload
+ * - a frame that doesn't become smaller is stored as is
+ * - crc is the crc32c of the raw data, checked after decompression
+ *
+ * Since frames are self-describing, the output of several calls can be
+ * concatenated (e.g. the parts of a multipart upload) and decompressed
+ * at once.
+ */
+constexpr size_t kCompressionFrameSize = 1024 * 1024;
+constexpr size_t kCompressionFrameHeaderSize = 20;
+
+/**
+ * @brief compress `data` and append the frames to `out`
+ */
+void CompressData(CompressionType type, const char* data, size_t len,
+                  std::string* out);
+
+/**
+ * @brief decompress frames produced by CompressData and append the raw
+ *        data to `out`
+ * @return false if the data is corrupted
+ */
+bool DecompressData(const char* data, size_t len, std::string* out);
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_COMPRESSION_H_
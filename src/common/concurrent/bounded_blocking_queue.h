@@ -25,6 +25,8 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstdint>
+#include <chrono>               //NOLINT
 #include <condition_variable>   //NOLINT
 #include <deque>
 #include <mutex>                //NOLINT
@@ -131,6 +133,29 @@ class BoundedBlockingDeque : public Uncopyable {
         return back;
     }
 
+    /**
+     * 队首元素满足pred时将其取出，队列为空时最多等待timeoutUs
+     * @param pred: 判断队首元素是否可以取出
+     * @param timeoutUs: 队列为空时的最长等待时间，0表示不等待
+     * @param[out] out: 取出的元素
+     * @return 取出返回true，否则返回false
+     */
+    template<typename Predicate>
+    bool TakeFrontIf(const Predicate &pred, uint64_t timeoutUs, T *out) {
+        std::unique_lock<std::mutex> guard(mutex_);
+        if (deque_.empty() && timeoutUs > 0) {
+            notEmpty_.wait_for(guard, std::chrono::microseconds(timeoutUs),
+                               [this]() { return !deque_.empty(); });
+        }
+        if (deque_.empty() || !pred(deque_.front())) {
+            return false;
+        }
+        *out = std::move(deque_.front());
+        deque_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
     bool Empty() const {
         std::lock_guard<std::mutex> guard(mutex_);
         return deque_.empty();
@@ -0,0 +1,426 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_COMMON_CONCURRENT_MPSC_QUEUE_H_
+#define SRC_COMMON_CONCURRENT_MPSC_QUEUE_H_
+
+#include <atomic>
+#include <condition_variable>   // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>                // NOLINT
+#include <new>
+#include <thread>               // NOLINT
+#include <type_traits>
+#include <utility>
+
+#include "include/curve_compiler_specific.h"
+
+namespace curve {
+namespace common {
+
+/**
+ * Move-only type-erased `void()` callable.
+ *
+ * Callables that fit in `kInlineSize` bytes and are nothrow move
+ * constructible are stored inline, so pushing a bound member function
+ * (object pointer / shared_ptr + a couple of scalars) doesn't allocate.
+ * Larger callables fall back to a single heap allocation.
+ */
+class InlineTask {
+ public:
+    static constexpr size_t kInlineSize = 48;
+
+    InlineTask() noexcept : ops_(nullptr) {}
+
+    template <typename F,
+              typename = typename std::enable_if<!std::is_same<
+                  typename std::decay<F>::type, InlineTask>::value>::type>
+    InlineTask(F&& f) : ops_(nullptr) {  // NOLINT
+        Assign(std::forward<F>(f));
+    }
+
+    InlineTask(InlineTask&& other) noexcept : ops_(other.ops_) {
+        if (ops_ != nullptr) {
+            ops_->move(&storage_, &other.storage_);
+            other.ops_ = nullptr;
+        }
+    }
+
+    InlineTask& operator=(InlineTask&& other) noexcept {
+        if (this != &other) {
+            Reset();
+            ops_ = other.ops_;
+            if (ops_ != nullptr) {
+                ops_->move(&storage_, &other.storage_);
+                other.ops_ = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    InlineTask(const InlineTask&) = delete;
+    InlineTask& operator=(const InlineTask&) = delete;
+
+    ~InlineTask() {
+        Reset();
+    }
+
+    void operator()() {
+        ops_->invoke(&storage_);
+    }
+
+    explicit operator bool() const noexcept {
+        return ops_ != nullptr;
+    }
+
+    void Reset() noexcept {
+        if (ops_ != nullptr) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+ private:
+    using Storage = typename std::aligned_storage<kInlineSize>::type;
+
+    struct Ops {
+        void (*invoke)(Storage*);
+        void (*move)(Storage* dst, Storage* src);
+        void (*destroy)(Storage*);
+    };
+
+    template <typename T>
+    struct InlineOps {
+        static T* Get(Storage* s) {
+            return reinterpret_cast<T*>(s);
+        }
+        static void Invoke(Storage* s) {
+            (*Get(s))();
+        }
+        static void Move(Storage* dst, Storage* src) {
+            new (dst) T(std::move(*Get(src)));
+            Get(src)->~T();
+        }
+        static void Destroy(Storage* s) {
+            Get(s)->~T();
+        }
+        static const Ops* Table() {
+            static const Ops ops = {&Invoke, &Move, &Destroy};
+            return &ops;
+        }
+    };
+
+    template <typename T>
+    struct HeapOps {
+        static T*& Get(Storage* s) {
+            return *reinterpret_cast<T**>(s);
+        }
+        static void Invoke(Storage* s) {
+            (*Get(s))();
+        }
+        static void Move(Storage* dst, Storage* src) {
+            new (dst) T*(Get(src));
+        }
+        static void Destroy(Storage* s) {
+            delete Get(s);
+        }
+        static const Ops* Table() {
+            static const Ops ops = {&Invoke, &Move, &Destroy};
+            return &ops;
+        }
+    };
+
+    template <typename F>
+    void Assign(F&& f) {
+        using T = typename std::decay<F>::type;
+        using FitsInline = std::integral_constant<bool,
+            sizeof(T) <= kInlineSize &&
+            alignof(T) <= alignof(Storage) &&
+            std::is_nothrow_move_constructible<T>::value>;
+        Emplace<T>(std::forward<F>(f), FitsInline());
+    }
+
+    template <typename T, typename F>
+    void Emplace(F&& f, std::true_type) {
+        new (&storage_) T(std::forward<F>(f));
+        ops_ = InlineOps<T>::Table();
+    }
+
+    template <typename T, typename F>
+    void Emplace(F&& f, std::false_type) {
+        new (&storage_) T*(new T(std::forward<F>(f)));
+        ops_ = HeapOps<T>::Table();
+    }
+
+ private:
+    Storage storage_;
+    const Ops* ops_;
+};
+
+/**
+ * Bounded lock-free multi-producer/single-consumer task queue.
+ *
+ * Slots are a ring of cells tagged with a sequence number (Vyukov's
+ * bounded queue), so producers only contend on one CAS of the enqueue
+ * cursor and the consumer never takes a lock on the fast path.
+ *
+ * When the queue is empty the consumer spins for a while, then yields,
+ * and finally parks on a condition variable; producers only touch the
+ * mutex if they observe a parked consumer. Producers that find the queue
+ * full are throttled the same way.
+ *
+ * Capacity is rounded up to a power of two, and is at least 2: with a
+ * single cell the sequence number of a full ring equals the one of an
+ * empty ring, so producers would overwrite the pending task.
+ *
+ * This is a drop-in replacement of TaskQueue: only one thread may call
+ * Pop()/TryPop() at a time.
+ */
+class MPSCTaskQueue {
+ public:
+    using Task = InlineTask;
+
+    explicit MPSCTaskQueue(size_t capacity)
+        : capacity_(RoundUpPowerOfTwo(capacity)),
+          mask_(capacity_ - 1),
+          cells_(new Cell[capacity_]),
+          enqueuePos_(0),
+          dequeuePos_(0),
+          consumerParked_(false),
+          parkedProducers_(0) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MPSCTaskQueue() = default;
+
+    MPSCTaskQueue(const MPSCTaskQueue&) = delete;
+    MPSCTaskQueue& operator=(const MPSCTaskQueue&) = delete;
+
+    /**
+     * Push a task, block if the queue is full.
+     * `Push(f, args...)` binds the arguments once and stores the result
+     * without going through std::function.
+     */
+    template <class F, class... Args>
+    void Push(F&& f, Args&&... args) {
+        Task task(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        PushTask(std::move(task));
+    }
+
+    template <class F>
+    void Push(F&& f) {
+        PushTask(Task(std::forward<F>(f)));
+    }
+
+    /**
+     * Try to push a task without blocking.
+     * @return false if the queue is full, and `task` is left untouched
+     */
+    bool TryPush(Task* task) {
+        if (!Enqueue(task)) {
+            return false;
+        }
+
+        if (consumerParked_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lk(mtx_);
+            notEmpty_.notify_one();
+        }
+        return true;
+    }
+
+    /**
+     * Pop a task, block if the queue is empty.
+     */
+    Task Pop() {
+        Task task;
+        for (uint32_t i = 0; i < kSpinCount; ++i) {
+            if (TryPop(&task)) {
+                return task;
+            }
+            CpuRelax();
+        }
+
+        for (uint32_t i = 0; i < kYieldCount; ++i) {
+            if (TryPop(&task)) {
+                return task;
+            }
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lk(mtx_);
+        consumerParked_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!Dequeue(&task)) {
+            notEmpty_.wait(lk);
+        }
+        consumerParked_.store(false, std::memory_order_relaxed);
+
+        if (parkedProducers_.load(std::memory_order_relaxed) > 0) {
+            notFull_.notify_one();
+        }
+        return task;
+    }
+
+    /**
+     * Try to pop a task without blocking.
+     * @return false if the queue is empty
+     */
+    bool TryPop(Task* task) {
+        if (!Dequeue(task)) {
+            return false;
+        }
+
+        if (parkedProducers_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lk(mtx_);
+            notFull_.notify_one();
+        }
+        return true;
+    }
+
+    size_t Size() const {
+        size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    size_t Capacity() const {
+        return capacity_;
+    }
+
+ private:
+    static constexpr uint32_t kSpinCount = 128;
+    static constexpr uint32_t kYieldCount = 16;
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        Task task;
+    };
+
+    static size_t RoundUpPowerOfTwo(size_t n) {
+        size_t cap = 2;
+        while (cap < n) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    static void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield" ::: "memory");
+#endif
+    }
+
+    void PushTask(Task task) {
+        for (uint32_t i = 0; i < kSpinCount; ++i) {
+            if (TryPush(&task)) {
+                return;
+            }
+            CpuRelax();
+        }
+
+        std::unique_lock<std::mutex> lk(mtx_);
+        parkedProducers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!Enqueue(&task)) {
+            notFull_.wait(lk);
+        }
+        parkedProducers_.fetch_sub(1, std::memory_order_relaxed);
+
+        // `mtx_` is already held, wake up the consumer directly
+        if (consumerParked_.load(std::memory_order_relaxed)) {
+            notEmpty_.notify_one();
+        }
+    }
+
+    // Publish `task` into the next free cell. Ends with a full fence so that
+    // the following load of `consumerParked_` can't be reordered before the
+    // publication, which pairs with the fence in Pop().
+    bool Enqueue(Task* task) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t diff =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return false;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->task = std::move(*task);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return true;
+    }
+
+    // Take the task at the head of the ring, only called by the consumer.
+    // Ends with a full fence which pairs with the fence in PushTask().
+    bool Dequeue(Task* task) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Cell* cell = &cells_[pos & mask_];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        if (seq != pos + 1) {
+            return false;
+        }
+
+        *task = std::move(cell->task);
+        cell->seq.store(pos + capacity_, std::memory_order_release);
+        dequeuePos_.store(pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return true;
+    }
+
+ private:
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    CURVE_CACHELINE_ALIGNMENT std::atomic<size_t> enqueuePos_;
+    CURVE_CACHELINE_ALIGNMENT std::atomic<size_t> dequeuePos_;
+
+    CURVE_CACHELINE_ALIGNMENT std::atomic<bool> consumerParked_;
+    std::atomic<uint32_t> parkedProducers_;
+    std::mutex mtx_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_CONCURRENT_MPSC_QUEUE_H_
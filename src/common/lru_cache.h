@@ -26,10 +26,14 @@
 #include <bvar/bvar.h>
 
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <list>
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include "src/common/concurrent/concurrent.h"
 
 namespace curve {
@@ -92,6 +96,8 @@ struct CacheTraits<std::string> {
 template <typename K,  typename V>
 class LRUCacheInterface {
  public:
+    virtual ~LRUCacheInterface() = default;
+
     /**
      * @brief Store key-value to the cache
      *
@@ -450,6 +456,296 @@ std::shared_ptr<CacheMetrics>
     return  cacheMetrics_;
 }
 
+/*
+ * @brief ClockCache is a CLOCK (second chance) approximation of LRU.
+ *        A hit only sets the reference bit of the item under the read lock
+ *        instead of moving it in a list, so concurrent hits don't serialize
+ *        on each other. On eviction the clock hand sweeps the slots, gives
+ *        every referenced item a second chance and evicts the first one
+ *        which has not been referenced since the last sweep.
+ */
+template <typename K,  typename V,
+    typename KeyTraits = CacheTraits<K>,
+    typename ValueTraits = CacheTraits<V>>
+class ClockCache : public LRUCacheInterface<K, V> {
+ public:
+    explicit ClockCache(uint64_t maxCount,
+        std::shared_ptr<CacheMetrics> cacheMetrics = nullptr)
+      : maxCount_(maxCount),
+        hand_(0),
+        cacheMetrics_(cacheMetrics) {}
+
+    void Put(const K &key, const V &value) override;
+
+    bool Put(const K &key, const V &value, V *eliminated) override;
+
+    bool Get(const K &key, V *value) override;
+
+    void Remove(const K &key) override;
+
+    uint64_t Size() override;
+
+    std::shared_ptr<CacheMetrics> GetCacheMetrics() const {
+        return cacheMetrics_;
+    }
+
+ private:
+    struct Slot {
+        K key;
+        V value;
+        // set on hit, cleared when the clock hand passes by
+        std::atomic<bool> referenced;
+        bool used;
+
+        Slot() : referenced(false), used(false) {}
+    };
+
+    bool PutLocked(const K &key, const V &value, V *eliminated);
+
+    /*
+    * @brief EvictLocked Sweep the clock hand and evict one item
+    *
+    * @param[out] eliminated The value eliminated by the cache
+    */
+    void EvictLocked(V *eliminated);
+
+    void RemoveSlotLocked(size_t pos);
+
+ private:
+    ::curve::common::RWLock lock_;
+
+    // the maximum number of items. 0 indicates unlimited
+    uint64_t maxCount_;
+    // slots never move, so the index in cache_ stays valid
+    std::deque<Slot> slots_;
+    // unused slots which can be reused by Put
+    std::vector<size_t> freeSlots_;
+    // the position of the clock hand in slots_
+    size_t hand_;
+    // record the slot of the item corresponding to the key
+    std::unordered_map<K, size_t> cache_;
+
+    // cache related metric data
+    std::shared_ptr<CacheMetrics> cacheMetrics_;
+};
+
+template <typename K,  typename V, typename KeyTraits, typename ValueTraits>
+uint64_t ClockCache<K, V, KeyTraits, ValueTraits>::Size() {
+    ::curve::common::ReadLockGuard guard(lock_);
+    return cache_.size();
+}
+
+template <typename K,  typename V, typename KeyTraits, typename ValueTraits>
+void ClockCache<K, V, KeyTraits, ValueTraits>::Put(
+    const K &key, const V &value) {
+    V eliminated;
+    ::curve::common::WriteLockGuard guard(lock_);
+    PutLocked(key, value, &eliminated);
+}
+
+template <typename K,  typename V, typename KeyTraits, typename ValueTraits>
+bool ClockCache<K, V, KeyTraits, ValueTraits>::Put(
+    const K &key, const V &value, V *eliminated) {
+    ::curve::common::WriteLockGuard guard(lock_);
+    return PutLocked(key, value, eliminated);
+}
+
+template <typename K,  typename V, typename KeyTraits, typename ValueTraits>
+bool ClockCache<K, V, KeyTraits, ValueTraits>::Get(const K &key, V *value) {
+    ::curve::common::ReadLockGuard guard(lock_);
+    auto iter = cache_.find(key);
+    if (iter == cache_.end()) {
+        if (cacheMetrics_ != nullptr) {
+            cacheMetrics_->OnCacheMiss();
+        }
+        return false;
+    }
+
+    if (cacheMetrics_ != nullptr) {
+        cacheMetrics_->OnCacheHit();
+    }
+
+    Slot &slot = slots_[iter->second];
+    // avoid dirtying the cache line if the bit is already set
+    if (!slot.referenced.load(std::memory_order_relaxed)) {
+        slot.referenced.store(true, std::memory_order_relaxed);
+    }
+    *value = slot.value;
+    return true;
+}
+
+template <typename K,  typename V, typename KeyTraits, typename ValueTraits>
+void ClockCache<K, V, KeyTraits, ValueTraits>::Remove(const K &key) {
+    ::curve::common::WriteLockGuard guard(lock_);
+    auto iter = cache_.find(key);
+    if (iter != cache_.end()) {
+        RemoveSlotLocked(iter->second);
+    }
+}
+
+template <typename K,  typename V, typename KeyTraits, typename ValueTraits>
+bool ClockCache<K, V, KeyTraits, ValueTraits>::PutLocked(
+    const K &key, const V &value, V *eliminated) {
+    // delete the old value if already exist
+    auto iter = cache_.find(key);
+    if (iter != cache_.end()) {
+        RemoveSlotLocked(iter->second);
+    }
+
+    bool evicted = false;
+    if (maxCount_ != 0 && cache_.size() >= maxCount_) {
+        EvictLocked(eliminated);
+        evicted = true;
+    }
+
+    size_t pos;
+    if (!freeSlots_.empty()) {
+        pos = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        pos = slots_.size();
+        slots_.emplace_back();
+    }
+    Slot &slot = slots_[pos];
+    slot.key = key;
+    slot.value = value;
+    slot.referenced.store(false, std::memory_order_relaxed);
+    slot.used = true;
+    cache_[key] = pos;
+    if (cacheMetrics_ != nullptr) {
+        cacheMetrics_->UpdateAddToCacheCount();
+        cacheMetrics_->UpdateAddToCacheBytes(
+           KeyTraits::CountBytes(key)  + ValueTraits::CountBytes(value));
+    }
+    return evicted;
+}
+
+template <typename K,  typename V, typename KeyTraits, typename ValueTraits>
+void ClockCache<K, V, KeyTraits, ValueTraits>::EvictLocked(V *eliminated) {
+    // terminates within two rounds, the first one clears all reference bits
+    while (true) {
+        if (hand_ >= slots_.size()) {
+            hand_ = 0;
+        }
+        size_t pos = hand_++;
+        Slot &slot = slots_[pos];
+        if (!slot.used) {
+            continue;
+        }
+        if (slot.referenced.load(std::memory_order_relaxed)) {
+            slot.referenced.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        *eliminated = slot.value;
+        RemoveSlotLocked(pos);
+        return;
+    }
+}
+
+template <typename K,  typename V, typename KeyTraits, typename ValueTraits>
+void ClockCache<K, V, KeyTraits, ValueTraits>::RemoveSlotLocked(size_t pos) {
+    Slot &slot = slots_[pos];
+    if (cacheMetrics_ != nullptr) {
+        cacheMetrics_->UpdateRemoveFromCacheCount();
+        cacheMetrics_->UpdateRemoveFromCacheBytes(
+            KeyTraits::CountBytes(slot.key) +
+            ValueTraits::CountBytes(slot.value));
+    }
+    cache_.erase(slot.key);
+    // release the memory held by the item
+    slot.key = K();
+    slot.value = V();
+    slot.used = false;
+    freeSlots_.push_back(pos);
+}
+
+enum class CacheEvictPolicy {
+    LRU,
+    CLOCK,
+};
+
+/*
+ * @brief ShardedLRUCache splits the keys into shards by hash, each shard is
+ *        an independent LRUCache or ClockCache with its own lock. So requests
+ *        on different shards don't contend. The capacity is divided evenly
+ *        among the shards, so the eviction order is only LRU within a shard.
+ */
+template <typename K,  typename V,
+    typename KeyTraits = CacheTraits<K>,
+    typename ValueTraits = CacheTraits<V>>
+class ShardedLRUCache : public LRUCacheInterface<K, V> {
+ public:
+    /*
+    * @param[in] maxCount The total capacity of all shards, 0 means unlimited
+    * @param[in] shardNum The number of shards
+    * @param[in] policy The eviction policy of each shard
+    * @param[in] cacheMetrics Metrics shared by all shards
+    */
+    ShardedLRUCache(uint64_t maxCount, uint32_t shardNum,
+        CacheEvictPolicy policy = CacheEvictPolicy::LRU,
+        std::shared_ptr<CacheMetrics> cacheMetrics = nullptr)
+      : cacheMetrics_(cacheMetrics) {
+        if (shardNum == 0) {
+            shardNum = 1;
+        }
+        uint64_t shardCount = (maxCount + shardNum - 1) / shardNum;
+        shards_.reserve(shardNum);
+        for (uint32_t i = 0; i < shardNum; ++i) {
+            if (policy == CacheEvictPolicy::CLOCK) {
+                shards_.emplace_back(
+                    new ClockCache<K, V, KeyTraits, ValueTraits>(
+                        shardCount, cacheMetrics));
+            } else {
+                shards_.emplace_back(
+                    new LRUCache<K, V, KeyTraits, ValueTraits>(
+                        shardCount, cacheMetrics));
+            }
+        }
+    }
+
+    void Put(const K &key, const V &value) override {
+        GetShard(key)->Put(key, value);
+    }
+
+    bool Put(const K &key, const V &value, V *eliminated) override {
+        return GetShard(key)->Put(key, value, eliminated);
+    }
+
+    bool Get(const K &key, V *value) override {
+        return GetShard(key)->Get(key, value);
+    }
+
+    void Remove(const K &key) override {
+        GetShard(key)->Remove(key);
+    }
+
+    uint64_t Size() override {
+        uint64_t size = 0;
+        for (auto &shard : shards_) {
+            size += shard->Size();
+        }
+        return size;
+    }
+
+    uint32_t ShardNum() const {
+        return shards_.size();
+    }
+
+    std::shared_ptr<CacheMetrics> GetCacheMetrics() const {
+        return cacheMetrics_;
+    }
+
+ private:
+    LRUCacheInterface<K, V> *GetShard(const K &key) {
+        return shards_[hasher_(key) % shards_.size()].get();
+    }
+
+ private:
+    std::vector<std::unique_ptr<LRUCacheInterface<K, V>>> shards_;
+    std::hash<K> hasher_;
+    std::shared_ptr<CacheMetrics> cacheMetrics_;
+};
+
 template <typename K>
 class SglLRUCacheInterface {
  public:
@@ -22,9 +22,11 @@
 
 #include "src/common/s3_adapter.h"
 
+#include <aws/core/http/HttpResponse.h>
 #include <aws/core/utils/stream/PreallocatedStreamBuf.h>
 #include <glog/logging.h>
 
+#include <cstring>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -66,6 +68,21 @@ Aws::String GetObjectRequestRange(uint64_t offset, uint64_t len) {
     return {range.data(), range.size()};
 }
 
+// objects uploaded with compression carry this metadata
+const char kCompressionMetaKey[] = "curve-compression";
+
+bool IsCompressedObject(const Aws::Map<Aws::String, Aws::String> &meta) {
+    return meta.find(kCompressionMetaKey) != meta.end();
+}
+
+// a ranged read past the compressed size of an object uploaded with
+// compression fails with 416, although the decompressed object covers it
+bool IsRangeNotSatisfiable(const Aws::S3::Model::GetObjectOutcome &outcome) {
+    return !outcome.IsSuccess() &&
+           outcome.GetError().GetResponseCode() ==
+               Aws::Http::HttpResponseCode::REQUESTED_RANGE_NOT_SATISFIABLE;
+}
+
 }  // namespace
 
 void InitS3AdaptorOption(Configuration* conf, S3AdapterOption* s3Opt) {
@@ -110,6 +127,28 @@ void InitS3AdaptorOptionExceptS3InfoOption(Configuration* conf,
         LOG(WARNING) << "Not found s3.max_async_request_inflight_bytes in conf";
         s3Opt->maxAsyncRequestInflightBytes = 0;
     }
+
+    InitS3AdaptorCompressionOption(conf, s3Opt);
+}
+
+void InitS3AdaptorCompressionOption(Configuration* conf,
+                                    S3AdapterOption* s3Opt) {
+    std::string compression;
+    if (!conf->GetStringValue("s3.compression", &compression)) {
+        LOG(WARNING) << "Not found s3.compression in conf, use default value "
+                     << CompressionTypeToString(s3Opt->compression);
+    } else {
+        LOG_IF(FATAL,
+               !StringToCompressionType(compression, &s3Opt->compression))
+            << "Invalid s3.compression: " << compression;
+    }
+
+    if (!conf->GetUInt64Value("s3.compression_cache_object_num",
+                              &s3Opt->compressionCacheObjectNum)) {
+        LOG(WARNING) << "Not found s3.compression_cache_object_num in conf, "
+                     << "use default value "
+                     << s3Opt->compressionCacheObjectNum;
+    }
 }
 
 void S3Adapter::Init(const std::string& path) {
@@ -180,6 +219,15 @@ void S3Adapter::Init(const S3AdapterOption &option) {
         option.maxAsyncRequestInflightBytes == 0
             ? UINT64_MAX
             : option.maxAsyncRequestInflightBytes));
+
+    compression_ = option.compression;
+    if (option.compressionCacheObjectNum != 0) {
+        decompressedCache_.reset(
+            new LRUCache<std::string, std::shared_ptr<std::string>>(
+                option.compressionCacheObjectNum));
+    }
+    LOG(INFO) << "S3Adapter init compression = "
+              << CompressionTypeToString(compression_);
 }
 
 void S3Adapter::Deinit() {
@@ -188,6 +236,7 @@ void S3Adapter::Deinit() {
     Aws::Delete<Aws::S3::S3Client>(s3Client_);
     delete throttle_;
     inflightBytesThrottle_.release();
+    decompressedCache_.reset();
 }
 
 void S3Adapter::Shutdown() {
@@ -273,14 +322,26 @@ int S3Adapter::PutObject(const Aws::String &key, const char *buffer,
     request.SetBucket(bucketName_);
     request.SetKey(key);
 
+    const char *body = buffer;
+    size_t bodySize = bufferSize;
+    std::string compressed;
+    if (compression_ != CompressionType::kNone) {
+        CompressData(compression_, buffer, bufferSize, &compressed);
+        body = compressed.data();
+        bodySize = compressed.size();
+        request.AddMetadata(kCompressionMetaKey,
+                            CompressionTypeToString(compression_));
+    }
+
     request.SetBody(Aws::MakeShared<PreallocatedIOStream>(AWS_ALLOCATE_TAG,
-                                                          buffer, bufferSize));
+                                                          body, bodySize));
 
     if (throttle_) {
-        throttle_->Add(false, bufferSize);
+        throttle_->Add(false, bodySize);
     }
 
     auto response = s3Client_->PutObject(request);
+    InvalidateDecompressedObject(key);
     if (response.IsSuccess()) {
         return 0;
     } else {
@@ -326,8 +387,20 @@ void S3Adapter::PutObjectAsync(std::shared_ptr<PutObjectAsyncContext> context) {
     request.SetBucket(bucketName_);
     request.SetKey(Aws::String{context->key.c_str(), context->key.size()});
 
-    request.SetBody(Aws::MakeShared<PreallocatedIOStream>(
-        AWS_ALLOCATE_TAG, context->buffer, context->bufferSize));
+    // the compressed data is released after the request is done
+    std::shared_ptr<std::string> compressed;
+    if (compression_ != CompressionType::kNone) {
+        compressed = std::make_shared<std::string>();
+        CompressData(compression_, context->buffer, context->bufferSize,
+                     compressed.get());
+        request.AddMetadata(kCompressionMetaKey,
+                            CompressionTypeToString(compression_));
+        request.SetBody(Aws::MakeShared<PreallocatedIOStream>(
+            AWS_ALLOCATE_TAG, compressed->data(), compressed->size()));
+    } else {
+        request.SetBody(Aws::MakeShared<PreallocatedIOStream>(
+            AWS_ALLOCATE_TAG, context->buffer, context->bufferSize));
+    }
 
     auto originCallback = context->cb;
     auto wrapperCallback =
@@ -339,7 +412,7 @@ void S3Adapter::PutObjectAsync(std::shared_ptr<PutObjectAsyncContext> context) {
         };
 
     Aws::S3::PutObjectResponseReceivedHandler handler =
-        [context](
+        [this, compressed](
             const Aws::S3::S3Client * /*client*/,
             const Aws::S3::Model::PutObjectRequest & /*request*/,
             const Aws::S3::Model::PutObjectOutcome &response,
@@ -356,12 +429,15 @@ void S3Adapter::PutObjectAsync(std::shared_ptr<PutObjectAsyncContext> context) {
                 << "message: " << response.GetError().GetMessage()
                 << "resend: " << ctx->key;
 
+            InvalidateDecompressedObject(
+                Aws::String{ctx->key.c_str(), ctx->key.size()});
             ctx->retCode = (response.IsSuccess() ? 0 : -1);
             ctx->cb(ctx);
         };
 
     if (throttle_) {
-        throttle_->Add(false, context->bufferSize);
+        throttle_->Add(false, compressed != nullptr ? compressed->size()
+                                                    : context->bufferSize);
     }
 
     inflightBytesThrottle_->OnStart(context->bufferSize);
@@ -381,7 +457,16 @@ int S3Adapter::GetObject(const Aws::String &key,
     auto response = s3Client_->GetObject(request);
     if (response.IsSuccess()) {
         ss << response.GetResult().GetBody().rdbuf();
-        *data = ss.str();
+        if (!IsCompressedObject(response.GetResult().GetMetadata())) {
+            *data = ss.str();
+            return 0;
+        }
+        std::string compressed = ss.str();
+        data->clear();
+        if (!DecompressData(compressed.data(), compressed.size(), data)) {
+            LOG(ERROR) << "GetObject decompress error, key: " << key;
+            return -1;
+        }
         return 0;
     } else {
         LOG(ERROR) << "GetObject error: "
@@ -395,6 +480,14 @@ int S3Adapter::GetObject(const std::string &key,
                          char *buf,
                          off_t offset,
                          size_t len) {
+    // 开启压缩后大部分对象都是压缩过的，直接读取整个对象
+    if (compression_ != CompressionType::kNone) {
+        if (throttle_) {
+            throttle_->Add(true, len);
+        }
+        return GetCompressedObjectRange(key, buf, offset, len);
+    }
+
     Aws::S3::Model::GetObjectRequest request;
     request.SetBucket(bucketName_);
     request.SetKey(Aws::String{key.c_str(), key.size()});
@@ -409,7 +502,13 @@ int S3Adapter::GetObject(const std::string &key,
     }
     auto response = s3Client_->GetObject(request);
     if (response.IsSuccess()) {
+        // 关闭压缩之前上传的对象
+        if (IsCompressedObject(response.GetResult().GetMetadata())) {
+            return GetCompressedObjectRange(key, buf, offset, len);
+        }
         return 0;
+    } else if (IsRangeNotSatisfiable(response)) {
+        return GetCompressedObjectRange(key, buf, offset, len);
     } else {
         LOG(ERROR) << "GetObject error: "
                 << response.GetError().GetExceptionName()
@@ -419,6 +518,21 @@ int S3Adapter::GetObject(const std::string &key,
 }
 
 void S3Adapter::GetObjectAsync(std::shared_ptr<GetObjectAsyncContext> context) {
+    if (compression_ != CompressionType::kNone) {
+        if (throttle_) {
+            throttle_->Add(true, context->len);
+        }
+        // 需要读取并解压整个对象，放到sdk的线程池中执行
+        inflightBytesThrottle_->OnStart(context->len);
+        clientCfg_->executor->Submit([this, context]() {
+            context->retCode = GetCompressedObjectRange(
+                context->key, context->buf, context->offset, context->len);
+            inflightBytesThrottle_->OnComplete(context->len);
+            context->cb(this, context);
+        });
+        return;
+    }
+
     Aws::S3::Model::GetObjectRequest request;
     request.SetBucket(bucketName_);
     request.SetKey(Aws::String{context->key.c_str(), context->key.size()});
@@ -450,12 +564,20 @@ void S3Adapter::GetObjectAsync(std::shared_ptr<GetObjectAsyncContext> context) {
                     std::dynamic_pointer_cast<const GetObjectAsyncContext>(
                         awsCtx));
 
-            LOG_IF(ERROR, !response.IsSuccess())
+            bool rangeNotSatisfiable = IsRangeNotSatisfiable(response);
+            LOG_IF(ERROR, !response.IsSuccess() && !rangeNotSatisfiable)
                 << "GetObjectAsync error: "
                 << response.GetError().GetExceptionName()
                 << response.GetError().GetMessage();
 
-            ctx->retCode = (response.IsSuccess() ? 0 : -1);
+            if (rangeNotSatisfiable ||
+                (response.IsSuccess() &&
+                 IsCompressedObject(response.GetResult().GetMetadata()))) {
+                ctx->retCode = GetCompressedObjectRange(ctx->key, ctx->buf,
+                                                        ctx->offset, ctx->len);
+            } else {
+                ctx->retCode = (response.IsSuccess() ? 0 : -1);
+            }
             ctx->cb(this, ctx);
         };
 
@@ -491,6 +613,7 @@ int S3Adapter::DeleteObject(const Aws::String &key) {
     Aws::S3::Model::DeleteObjectRequest request;
     request.SetBucket(bucketName_);
     request.SetKey(key);
+    InvalidateDecompressedObject(key);
     auto response = s3Client_->DeleteObject(request);
     if (response.IsSuccess()) {
         return 0;
@@ -510,6 +633,7 @@ int S3Adapter::DeleteObjects(const std::list<Aws::String>& keyList) {
     Aws::S3::Model::DeleteObjectsRequest deleteObjectsRequest;
     Aws::S3::Model::Delete deleteObjects;
     for (const auto& key : keyList) {
+        InvalidateDecompressedObject(key);
         Aws::S3::Model::ObjectIdentifier ObjIdent;
         ObjIdent.SetKey(key);
         deleteObjects.AddObjects(ObjIdent);
@@ -584,6 +708,11 @@ int S3Adapter::GetObjectMeta(const Aws::String &key,
 Aws::String S3Adapter::MultiUploadInit(const Aws::String &key) {
     Aws::S3::Model::CreateMultipartUploadRequest request;
     request.WithBucket(bucketName_).WithKey(key);
+    // 每个分片单独压缩，解压时依次解压各个分片
+    if (compression_ != CompressionType::kNone) {
+        request.AddMetadata(kCompressionMetaKey,
+                            CompressionTypeToString(compression_));
+    }
     auto response = s3Client_->CreateMultipartUpload(request);
     if (response.IsSuccess()) {
         return response.GetResult().GetUploadId();
@@ -605,13 +734,22 @@ Aws::S3::Model::CompletedPart S3Adapter::UploadOnePart(
     request.SetKey(key);
     request.SetUploadId(uploadId);
     request.SetPartNumber(partNum);
-    request.SetContentLength(partSize);
 
-    request.SetBody(
-        Aws::MakeShared<PreallocatedIOStream>(AWS_ALLOCATE_TAG, buf, partSize));
+    const char *body = buf;
+    size_t bodySize = partSize;
+    std::string compressed;
+    if (compression_ != CompressionType::kNone) {
+        CompressData(compression_, buf, partSize, &compressed);
+        body = compressed.data();
+        bodySize = compressed.size();
+    }
+    request.SetContentLength(bodySize);
+
+    request.SetBody(Aws::MakeShared<PreallocatedIOStream>(AWS_ALLOCATE_TAG,
+                                                          body, bodySize));
 
     if (throttle_) {
-        throttle_->Add(false, partSize);
+        throttle_->Add(false, bodySize);
     }
     auto result = s3Client_->UploadPart(request);
     if (result.IsSuccess()) {
@@ -633,6 +771,7 @@ int S3Adapter::CompleteMultiUpload(const Aws::String &key,
     request.SetMultipartUpload(
         Aws::S3::Model::CompletedMultipartUpload().WithParts(cp_v));
     auto response = s3Client_->CompleteMultipartUpload(request);
+    InvalidateDecompressedObject(key);
     if (response.IsSuccess()) {
         return 0;
     } else {
@@ -659,6 +798,68 @@ int S3Adapter::AbortMultiUpload(const Aws::String &key,
     }
 }
 
+std::shared_ptr<std::string> S3Adapter::GetDecompressedObject(
+    const std::string &key) {
+    std::shared_ptr<std::string> object;
+    if (decompressedCache_ != nullptr &&
+        decompressedCache_->Get(key, &object)) {
+        return object;
+    }
+
+    Aws::S3::Model::GetObjectRequest request;
+    request.SetBucket(bucketName_);
+    request.SetKey(Aws::String{key.c_str(), key.size()});
+    auto response = s3Client_->GetObject(request);
+    if (!response.IsSuccess()) {
+        LOG(ERROR) << "GetObject error: "
+                << response.GetError().GetExceptionName()
+                << response.GetError().GetMessage();
+        return nullptr;
+    }
+
+    std::stringstream ss;
+    ss << response.GetResult().GetBody().rdbuf();
+    object = std::make_shared<std::string>();
+    if (!IsCompressedObject(response.GetResult().GetMetadata())) {
+        *object = ss.str();
+    } else {
+        std::string compressed = ss.str();
+        if (!DecompressData(compressed.data(), compressed.size(),
+                            object.get())) {
+            LOG(ERROR) << "GetObject decompress error, key: " << key;
+            return nullptr;
+        }
+    }
+
+    if (decompressedCache_ != nullptr) {
+        decompressedCache_->Put(key, object);
+    }
+    return object;
+}
+
+int S3Adapter::GetCompressedObjectRange(const std::string &key, char *buf,
+                                        off_t offset, size_t len) {
+    std::shared_ptr<std::string> object = GetDecompressedObject(key);
+    if (object == nullptr) {
+        return -1;
+    }
+    if (offset < 0 || static_cast<size_t>(offset) >= object->size() ||
+        len > object->size() - static_cast<size_t>(offset)) {
+        LOG(ERROR) << "GetObject range error, key: " << key
+                   << ", offset: " << offset << ", len: " << len
+                   << ", object size: " << object->size();
+        return -1;
+    }
+    memcpy(buf, object->data() + offset, len);
+    return 0;
+}
+
+void S3Adapter::InvalidateDecompressedObject(const Aws::String &key) {
+    if (decompressedCache_ != nullptr) {
+        decompressedCache_->Remove(std::string(key.c_str(), key.size()));
+    }
+}
+
 void S3Adapter::AsyncRequestInflightBytesThrottle::OnStart(uint64_t len) {
     std::unique_lock<std::mutex> lock(mtx_);
     while (inflightBytes_ + len > maxInflightBytes_) {
@@ -55,7 +55,9 @@
 #include <aws/s3/model/BucketLocationConstraint.h>        //NOLINT
 #include <aws/s3/model/CreateBucketConfiguration.h>       //NOLINT
 #include <aws/core/utils/threading/Executor.h>            // NOLINT
+#include "src/common/compression.h"
 #include "src/common/configuration.h"
+#include "src/common/lru_cache.h"
 #include "src/common/throttle.h"
 
 namespace curve {
@@ -86,6 +88,11 @@ struct S3AdapterOption {
     uint64_t bpsReadMB;
     uint64_t bpsWriteMB;
     bool useVirtualAddressing;
+    // compress objects before upload, objects are decompressed on read
+    // whatever this option is
+    CompressionType compression = CompressionType::kNone;
+    // number of decompressed objects cached for range reads
+    uint64_t compressionCacheObjectNum = 16;
 };
 
 struct S3InfoOption {
@@ -103,6 +110,9 @@ void InitS3AdaptorOptionExceptS3InfoOption(Configuration *conf,
 
 void InitS3AdaptorOption(Configuration *conf, S3AdapterOption *s3Opt);
 
+void InitS3AdaptorCompressionOption(Configuration *conf,
+                                    S3AdapterOption *s3Opt);
+
 typedef std::function<void(const S3Adapter *,
                            const std::shared_ptr<GetObjectAsyncContext> &)>
     GetObjectAsyncCallBack;
@@ -324,6 +334,22 @@ class S3Adapter {
         std::condition_variable cond_;
     };
 
+ private:
+    /**
+     * @brief 读取压缩对象的一段数据
+     *        需要读取并解压整个对象，解压后的对象放入缓存供后续读取
+     * @return 0 成功/ -1 失败
+     */
+    int GetCompressedObjectRange(const std::string &key, char *buf,
+                                 off_t offset, size_t len);
+
+    /**
+     * @brief 读取并解压整个对象
+     */
+    std::shared_ptr<std::string> GetDecompressedObject(const std::string &key);
+
+    void InvalidateDecompressedObject(const Aws::String &key);
+
  private:
     // S3服务器地址
     Aws::String s3Address_;
@@ -340,6 +366,12 @@ class S3Adapter {
     Throttle *throttle_;
 
     std::unique_ptr<AsyncRequestInflightBytesThrottle> inflightBytesThrottle_;
+
+    // 上传对象使用的压缩算法
+    CompressionType compression_ = CompressionType::kNone;
+    // 解压后的对象，key为对象名
+    std::unique_ptr<LRUCache<std::string, std::shared_ptr<std::string>>>
+        decompressedCache_;
 };
 
 class FakeS3Adapter : public S3Adapter {
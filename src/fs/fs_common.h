@@ -29,6 +29,8 @@ namespace fs {
 enum class FileSystemType {
     // SFS,
     EXT4,
+    // ext4 on top of io_uring for data I/O
+    IO_URING,
 };
 
 struct FileSystemInfo {
@@ -0,0 +1,242 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-17
+ * Author: curve
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "src/fs/io_uring.h"
+
+// 老版本glibc的头文件中没有io_uring的系统调用号，各架构上的值都相同
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register 427
+#endif
+
+namespace curve {
+namespace fs {
+
+namespace {
+
+inline unsigned LoadAcquire(const unsigned* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline void StoreRelease(unsigned* p, unsigned v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+template <typename T>
+inline T* Offset(void* base, uint32_t off) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + off);
+}
+
+}  // namespace
+
+IOUring::IOUring()
+    : ringFd_(-1),
+      sqRing_(nullptr), sqRingSize_(0),
+      sqHead_(nullptr), sqTail_(nullptr), sqMask_(nullptr),
+      sqArray_(nullptr), sqes_(nullptr), sqesSize_(0), sqEntries_(0),
+      sqeHead_(0), sqeTail_(0),
+      cqRing_(nullptr), cqRingSize_(0),
+      cqHead_(nullptr), cqTail_(nullptr), cqMask_(nullptr),
+      cqes_(nullptr) {}
+
+IOUring::~IOUring() {
+    Fini();
+}
+
+int IOUring::Init(uint32_t entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        int err = errno;
+        LOG(WARNING) << "io_uring_setup failed: " << strerror(err)
+                     << ", entries: " << entries;
+        return -err;
+    }
+    ringFd_ = fd;
+    sqEntries_ = params.sq_entries;
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes +
+                  params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+
+    sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED) {
+        int err = errno;
+        sqRing_ = nullptr;
+        LOG(ERROR) << "mmap io_uring sq ring failed: " << strerror(err);
+        Fini();
+        return -err;
+    }
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+            int err = errno;
+            cqRing_ = nullptr;
+            LOG(ERROR) << "mmap io_uring cq ring failed: " << strerror(err);
+            Fini();
+            return -err;
+        }
+    }
+
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        int err = errno;
+        LOG(ERROR) << "mmap io_uring sqes failed: " << strerror(err);
+        Fini();
+        return -err;
+    }
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    sqHead_ = Offset<unsigned>(sqRing_, params.sq_off.head);
+    sqTail_ = Offset<unsigned>(sqRing_, params.sq_off.tail);
+    sqMask_ = Offset<unsigned>(sqRing_, params.sq_off.ring_mask);
+    sqArray_ = Offset<unsigned>(sqRing_, params.sq_off.array);
+    cqHead_ = Offset<unsigned>(cqRing_, params.cq_off.head);
+    cqTail_ = Offset<unsigned>(cqRing_, params.cq_off.tail);
+    cqMask_ = Offset<unsigned>(cqRing_, params.cq_off.ring_mask);
+    cqes_ = Offset<struct io_uring_cqe>(cqRing_, params.cq_off.cqes);
+    sqeHead_ = sqeTail_ = *sqTail_;
+    return 0;
+}
+
+void IOUring::Fini() {
+    if (sqes_ != nullptr) {
+        munmap(sqes_, sqesSize_);
+        sqes_ = nullptr;
+    }
+    if (cqRing_ != nullptr && cqRing_ != sqRing_) {
+        munmap(cqRing_, cqRingSize_);
+    }
+    cqRing_ = nullptr;
+    if (sqRing_ != nullptr) {
+        munmap(sqRing_, sqRingSize_);
+        sqRing_ = nullptr;
+    }
+    if (ringFd_ >= 0) {
+        ::close(ringFd_);
+        ringFd_ = -1;
+    }
+}
+
+int IOUring::RegisterBuffers(const struct iovec* iovs, unsigned count) {
+    int ret = syscall(__NR_io_uring_register, ringFd_,
+                      IORING_REGISTER_BUFFERS, iovs, count);
+    if (ret < 0) {
+        int err = errno;
+        LOG(WARNING) << "io_uring register buffers failed: "
+                     << strerror(err) << ", count: " << count;
+        return -err;
+    }
+    return 0;
+}
+
+struct io_uring_sqe* IOUring::GetSqe() {
+    unsigned head = LoadAcquire(sqHead_);
+    if (sqeTail_ - head >= sqEntries_) {
+        return nullptr;
+    }
+    struct io_uring_sqe* sqe = &sqes_[sqeTail_ & *sqMask_];
+    ++sqeTail_;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int IOUring::Submit(unsigned waitNr) {
+    unsigned toSubmit = sqeTail_ - sqeHead_;
+    if (toSubmit > 0) {
+        unsigned tail = *sqTail_;
+        const unsigned mask = *sqMask_;
+        for (; sqeHead_ != sqeTail_; ++sqeHead_, ++tail) {
+            sqArray_[tail & mask] = sqeHead_ & mask;
+        }
+        // 保证sqe的内容对内核可见之后再更新tail
+        StoreRelease(sqTail_, tail);
+    }
+    if (toSubmit == 0 && waitNr == 0) {
+        return 0;
+    }
+    return Enter(toSubmit, waitNr,
+                 waitNr > 0 ? IORING_ENTER_GETEVENTS : 0);
+}
+
+int IOUring::WaitCqe() {
+    int ret = Enter(0, 1, IORING_ENTER_GETEVENTS);
+    return ret < 0 ? ret : 0;
+}
+
+int IOUring::Enter(unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    int ret = 0;
+    do {
+        ret = syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete,
+                      flags, nullptr, 0);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) {
+        int err = errno;
+        LOG(ERROR) << "io_uring_enter failed: " << strerror(err);
+        return -err;
+    }
+    return ret;
+}
+
+unsigned IOUring::PeekCqes(struct io_uring_cqe** cqes, unsigned max) {
+    unsigned head = *cqHead_;
+    unsigned tail = LoadAcquire(cqTail_);
+    unsigned count = std::min(tail - head, max);
+    const unsigned mask = *cqMask_;
+    for (unsigned i = 0; i < count; ++i) {
+        cqes[i] = &cqes_[(head + i) & mask];
+    }
+    return count;
+}
+
+void IOUring::CqeAdvance(unsigned n) {
+    // 保证cqe的内容被读取之后，内核才能复用这些位置
+    StoreRelease(cqHead_, *cqHead_ + n);
+}
+
+}  // namespace fs
+}  // namespace curve
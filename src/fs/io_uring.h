@@ -0,0 +1,128 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_FS_IO_URING_H_
+#define SRC_FS_IO_URING_H_
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <stdint.h>
+
+namespace curve {
+namespace fs {
+
+/**
+ * io_uring系统调用的简单封装，不依赖liburing
+ * 负责ring的创建、映射、sqe的申请/提交以及cqe的收割
+ * 非线程安全：提交端(GetSqe/Submit)与收割端(PeekCqe/CqeAdvance)
+ * 需要各自由调用者保证串行，两端之间可以并发
+ */
+class IOUring {
+ public:
+    IOUring();
+    ~IOUring();
+
+    /**
+     * 创建ring并映射提交/完成队列
+     * @param entries: 提交队列深度
+     * @return 成功返回0，失败返回-errno
+     */
+    int Init(uint32_t entries);
+
+    void Fini();
+
+    bool Inited() const {
+        return ringFd_ >= 0;
+    }
+
+    /**
+     * 注册固定buffer，之后可以使用READ_FIXED/WRITE_FIXED操作
+     * @return 成功返回0，失败返回-errno
+     */
+    int RegisterBuffers(const struct iovec* iovs, unsigned count);
+
+    /**
+     * 获取一个空闲的sqe，队列已满时返回nullptr
+     */
+    struct io_uring_sqe* GetSqe();
+
+    /**
+     * 将已填充的sqe一次性提交给内核
+     * @param waitNr: 需要等待完成的请求个数，为0表示不等待
+     * @return 返回提交的请求个数，失败返回-errno
+     */
+    int Submit(unsigned waitNr = 0);
+
+    /**
+     * 阻塞等待至少一个请求完成
+     * @return 成功返回0，失败返回-errno
+     */
+    int WaitCqe();
+
+    /**
+     * 获取已完成队列中的cqe，最多max个，不阻塞
+     * @return 获取到的cqe个数
+     */
+    unsigned PeekCqes(struct io_uring_cqe** cqes, unsigned max);
+
+    /**
+     * 标记n个cqe已经被处理
+     */
+    void CqeAdvance(unsigned n);
+
+    uint32_t SqEntries() const {
+        return sqEntries_;
+    }
+
+ private:
+    int Enter(unsigned toSubmit, unsigned minComplete, unsigned flags);
+
+ private:
+    int ringFd_;
+
+    // 提交队列
+    void* sqRing_;
+    size_t sqRingSize_;
+    unsigned* sqHead_;
+    unsigned* sqTail_;
+    unsigned* sqMask_;
+    unsigned* sqArray_;
+    struct io_uring_sqe* sqes_;
+    size_t sqesSize_;
+    uint32_t sqEntries_;
+    // 已经被GetSqe分配出去、但还没有提交的sqe区间为[sqeHead_, sqeTail_)
+    unsigned sqeHead_;
+    unsigned sqeTail_;
+
+    // 完成队列
+    void* cqRing_;
+    size_t cqRingSize_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned* cqMask_;
+    struct io_uring_cqe* cqes_;
+};
+
+}  // namespace fs
+}  // namespace curve
+
+#endif  // SRC_FS_IO_URING_H_
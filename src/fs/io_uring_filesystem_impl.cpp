@@ -0,0 +1,422 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-17
+ * Author: curve
+ */
+
+#include <glog/logging.h>
+
+#include "src/common/concurrent/count_down_event.h"
+#include "src/fs/ext4_filesystem_impl.h"
+#include "src/fs/io_uring_filesystem_impl.h"
+
+namespace curve {
+namespace fs {
+
+using curve::common::CountDownEvent;
+
+namespace {
+// 收割线程每次最多处理的完成事件数
+const unsigned kReapBatchSize = 64;
+}  // namespace
+
+struct IOUringFileSystemImpl::IOContext {
+    AioRequest* request;
+    CountDownEvent* done;
+    struct iovec iov;
+};
+
+std::shared_ptr<IOUringFileSystemImpl> IOUringFileSystemImpl::self_ = nullptr;
+std::mutex IOUringFileSystemImpl::mutex_;
+
+IOUringFileSystemImpl::IOUringFileSystemImpl(
+    std::shared_ptr<LocalFileSystem> base)
+    : base_(base)
+    , running_(false)
+    , inflight_(0)
+    , queueDepth_(0)
+    , fixedBuffers_(nullptr)
+    , fixedBufferCount_(0)
+    , fixedBufferSize_(0) {
+    CHECK(base_ != nullptr) << "base local fs is null";
+}
+
+IOUringFileSystemImpl::~IOUringFileSystemImpl() {
+    Uninit();
+}
+
+std::shared_ptr<IOUringFileSystemImpl> IOUringFileSystemImpl::getInstance() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (self_ == nullptr) {
+        self_ = std::make_shared<IOUringFileSystemImpl>(
+            Ext4FileSystemImpl::getInstance());
+    }
+    return self_;
+}
+
+int IOUringFileSystemImpl::Init(const LocalFileSystemOption& option) {
+    int ret = base_->Init(option);
+    if (ret != 0) {
+        return ret;
+    }
+    if (running_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    ret = ring_.Init(option.ioUringQueueDepth);
+    if (ret != 0) {
+        LOG(WARNING) << "io_uring is not available, fall back to "
+                     << "synchronous I/O: " << strerror(-ret);
+        return 0;
+    }
+    queueDepth_ = ring_.SqEntries();
+    InitFixedBuffers(option.ioUringFixedBufferCount,
+                     option.ioUringFixedBufferSize);
+
+    running_.store(true, std::memory_order_release);
+    reaper_ = std::thread(&IOUringFileSystemImpl::ReapLoop, this);
+    LOG(INFO) << "io_uring local fs inited, queue depth: " << queueDepth_
+              << ", fixed buffer count: " << fixedBufferCount_
+              << ", fixed buffer size: " << fixedBufferSize_;
+    return 0;
+}
+
+void IOUringFileSystemImpl::InitFixedBuffers(uint32_t count, uint32_t size) {
+    if (count == 0 || size == 0) {
+        return;
+    }
+    size = (size + kIOBufferAlignment - 1) / kIOBufferAlignment *
+           kIOBufferAlignment;
+    void* region = nullptr;
+    if (posix_memalign(&region, kIOBufferAlignment,
+                       static_cast<size_t>(count) * size) != 0) {
+        LOG(WARNING) << "Alloc io_uring fixed buffers failed, count: "
+                     << count << ", size: " << size;
+        return;
+    }
+
+    std::vector<struct iovec> iovs(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        iovs[i].iov_base = static_cast<char*>(region) +
+                           static_cast<size_t>(i) * size;
+        iovs[i].iov_len = size;
+    }
+    if (ring_.RegisterBuffers(iovs.data(), count) != 0) {
+        free(region);
+        return;
+    }
+
+    fixedBuffers_ = static_cast<char*>(region);
+    fixedBufferCount_ = count;
+    fixedBufferSize_ = size;
+    freeFixedBuffers_.reserve(count);
+    for (uint32_t i = count; i > 0; --i) {
+        freeFixedBuffers_.push_back(i - 1);
+    }
+}
+
+void IOUringFileSystemImpl::Uninit() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // 提交一个空请求唤醒收割线程
+    {
+        std::lock_guard<std::mutex> lock(submitMutex_);
+        AcquireInflight();
+        struct io_uring_sqe* sqe = ring_.GetSqe();
+        CHECK(sqe != nullptr);
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = 0;
+        ring_.Submit();
+    }
+    reaper_.join();
+    ring_.Fini();
+
+    std::lock_guard<std::mutex> lock(bufferMutex_);
+    if (fixedBuffers_ != nullptr) {
+        CHECK_EQ(fixedBufferCount_, freeFixedBuffers_.size())
+            << "io_uring fixed buffers still in use";
+        free(fixedBuffers_);
+        fixedBuffers_ = nullptr;
+        fixedBufferCount_ = 0;
+        fixedBufferSize_ = 0;
+        freeFixedBuffers_.clear();
+    }
+}
+
+bool IOUringFileSystemImpl::SupportAsyncIO() const {
+    return running_.load(std::memory_order_acquire);
+}
+
+char* IOUringFileSystemImpl::AllocIOBuffer(size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex_);
+        if (size <= fixedBufferSize_ && !freeFixedBuffers_.empty()) {
+            uint32_t index = freeFixedBuffers_.back();
+            freeFixedBuffers_.pop_back();
+            return fixedBuffers_ + static_cast<size_t>(index) *
+                                   fixedBufferSize_;
+        }
+    }
+    return LocalFileSystem::AllocIOBuffer(size);
+}
+
+void IOUringFileSystemImpl::FreeIOBuffer(char* buf) {
+    int index = FixedBufferIndex(buf, 0);
+    if (index < 0) {
+        LocalFileSystem::FreeIOBuffer(buf);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(bufferMutex_);
+    freeFixedBuffers_.push_back(index);
+}
+
+int IOUringFileSystemImpl::FixedBufferIndex(const char* buf,
+                                            int length) const {
+    if (fixedBuffers_ == nullptr || buf < fixedBuffers_) {
+        return -1;
+    }
+    size_t offset = buf - fixedBuffers_;
+    if (offset >= static_cast<size_t>(fixedBufferCount_) * fixedBufferSize_) {
+        return -1;
+    }
+    uint32_t index = offset / fixedBufferSize_;
+    // 跨越了固定buffer的边界，只能当作普通内存处理
+    if (offset % fixedBufferSize_ + length > fixedBufferSize_) {
+        return -1;
+    }
+    return index;
+}
+
+void IOUringFileSystemImpl::AcquireInflight() {
+    std::unique_lock<std::mutex> lock(inflightMutex_);
+    if (inflight_ >= queueDepth_) {
+        // 先把已经准备好的sqe提交出去，否则可能永远等不到完成事件
+        lock.unlock();
+        ring_.Submit();
+        lock.lock();
+        inflightCond_.wait(lock, [this]() {
+            return inflight_ < queueDepth_;
+        });
+    }
+    ++inflight_;
+}
+
+void IOUringFileSystemImpl::PrepareSqe(IOContext* ctx,
+                                       struct io_uring_sqe* sqe) {
+    AioRequest* req = ctx->request;
+    sqe->fd = req->fd;
+    sqe->user_data = reinterpret_cast<uint64_t>(ctx);
+    if (req->op == AioOpType::SYNC) {
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        // 与Sync语义保持一致，需要等之前提交的写请求完成之后再执行
+        sqe->flags |= IOSQE_IO_DRAIN;
+        return;
+    }
+
+    bool isRead = req->op == AioOpType::READ;
+    sqe->off = req->offset;
+    int index = FixedBufferIndex(req->buf, req->length);
+    if (index >= 0) {
+        sqe->opcode = isRead ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+        sqe->addr = reinterpret_cast<uint64_t>(req->buf);
+        sqe->len = req->length;
+        sqe->buf_index = index;
+    } else {
+        ctx->iov.iov_base = req->buf;
+        ctx->iov.iov_len = req->length;
+        sqe->opcode = isRead ? IORING_OP_READV : IORING_OP_WRITEV;
+        sqe->addr = reinterpret_cast<uint64_t>(&ctx->iov);
+        sqe->len = 1;
+    }
+}
+
+int IOUringFileSystemImpl::SubmitBatch(std::vector<AioRequest>* requests) {
+    if (requests->empty()) {
+        return 0;
+    }
+    if (!running_.load(std::memory_order_acquire)) {
+        return LocalFileSystem::SubmitBatch(requests);
+    }
+
+    std::vector<IOContext> contexts(requests->size());
+    CountDownEvent done(requests->size());
+    {
+        std::lock_guard<std::mutex> lock(submitMutex_);
+        for (size_t i = 0; i < requests->size(); ++i) {
+            IOContext* ctx = &contexts[i];
+            ctx->request = &(*requests)[i];
+            ctx->done = &done;
+            AcquireInflight();
+            struct io_uring_sqe* sqe = ring_.GetSqe();
+            CHECK(sqe != nullptr) << "io_uring submission queue is full";
+            PrepareSqe(ctx, sqe);
+        }
+        // 整批请求通过一次系统调用提交
+        int ret = ring_.Submit();
+        if (ret < 0) {
+            LOG(FATAL) << "Submit io_uring requests failed: "
+                       << strerror(-ret);
+        }
+    }
+    done.Wait();
+
+    int ret = 0;
+    for (auto& req : *requests) {
+        if (req.result >= 0) {
+            CompleteShortIO(&req);
+        } else {
+            LOG(ERROR) << "io_uring request failed: " << strerror(-req.result)
+                       << ", op: " << static_cast<int>(req.op)
+                       << ", fd: " << req.fd
+                       << ", offset: " << req.offset
+                       << ", length: " << req.length;
+        }
+        if (req.result < 0 && ret == 0) {
+            ret = req.result;
+        }
+    }
+    return ret;
+}
+
+void IOUringFileSystemImpl::CompleteShortIO(AioRequest* req) {
+    if (req->op == AioOpType::SYNC || req->result >= req->length) {
+        return;
+    }
+    int done = req->result;
+    int ret = 0;
+    if (req->op == AioOpType::READ) {
+        ret = base_->Read(req->fd, req->buf + done,
+                          req->offset + done, req->length - done);
+    } else {
+        ret = base_->Write(req->fd, req->buf + done,
+                           req->offset + done, req->length - done);
+    }
+    req->result = ret < 0 ? ret : done + ret;
+}
+
+void IOUringFileSystemImpl::ReapLoop() {
+    struct io_uring_cqe* cqes[kReapBatchSize];
+    bool stopping = false;
+    while (true) {
+        int ret = ring_.WaitCqe();
+        if (ret < 0 && ret != -EAGAIN && ret != -EBUSY) {
+            LOG(FATAL) << "Wait io_uring completion failed: "
+                       << strerror(-ret);
+        }
+        unsigned count = ring_.PeekCqes(cqes, kReapBatchSize);
+        for (unsigned i = 0; i < count; ++i) {
+            IOContext* ctx = reinterpret_cast<IOContext*>(cqes[i]->user_data);
+            if (ctx == nullptr) {
+                stopping = true;
+                continue;
+            }
+            ctx->request->result = cqes[i]->res;
+            ctx->done->Signal();
+        }
+        ring_.CqeAdvance(count);
+
+        std::lock_guard<std::mutex> lock(inflightMutex_);
+        inflight_ -= count;
+        inflightCond_.notify_all();
+        if (stopping && inflight_ == 0) {
+            break;
+        }
+    }
+}
+
+int IOUringFileSystemImpl::Statfs(const string& path,
+                                  struct FileSystemInfo* info) {
+    return base_->Statfs(path, info);
+}
+
+int IOUringFileSystemImpl::Open(const string& path, int flags) {
+    return base_->Open(path, flags);
+}
+
+int IOUringFileSystemImpl::Close(int fd) {
+    return base_->Close(fd);
+}
+
+int IOUringFileSystemImpl::Delete(const string& path) {
+    return base_->Delete(path);
+}
+
+int IOUringFileSystemImpl::Mkdir(const string& dirPath) {
+    return base_->Mkdir(dirPath);
+}
+
+bool IOUringFileSystemImpl::DirExists(const string& dirPath) {
+    return base_->DirExists(dirPath);
+}
+
+bool IOUringFileSystemImpl::FileExists(const string& filePath) {
+    return base_->FileExists(filePath);
+}
+
+int IOUringFileSystemImpl::DoRename(const string& oldPath,
+                                    const string& newPath,
+                                    unsigned int flags) {
+    return base_->Rename(oldPath, newPath, flags);
+}
+
+int IOUringFileSystemImpl::List(const string& dirPath,
+                                vector<std::string>* names) {
+    return base_->List(dirPath, names);
+}
+
+int IOUringFileSystemImpl::Read(int fd, char* buf,
+                                uint64_t offset, int length) {
+    return base_->Read(fd, buf, offset, length);
+}
+
+int IOUringFileSystemImpl::Write(int fd, const char* buf,
+                                 uint64_t offset, int length) {
+    return base_->Write(fd, buf, offset, length);
+}
+
+int IOUringFileSystemImpl::Write(int fd, butil::IOBuf buf,
+                                 uint64_t offset, int length) {
+    return base_->Write(fd, buf, offset, length);
+}
+
+int IOUringFileSystemImpl::Sync(int fd) {
+    return base_->Sync(fd);
+}
+
+int IOUringFileSystemImpl::Append(int fd, const char* buf, int length) {
+    return base_->Append(fd, buf, length);
+}
+
+int IOUringFileSystemImpl::Fallocate(int fd, int op,
+                                     uint64_t offset, int length) {
+    return base_->Fallocate(fd, op, offset, length);
+}
+
+int IOUringFileSystemImpl::Fstat(int fd, struct stat* info) {
+    return base_->Fstat(fd, info);
+}
+
+int IOUringFileSystemImpl::Fsync(int fd) {
+    return base_->Fsync(fd);
+}
+
+}  // namespace fs
+}  // namespace curve
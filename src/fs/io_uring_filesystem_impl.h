@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_FS_IO_URING_FILESYSTEM_IMPL_H_
+#define SRC_FS_IO_URING_FILESYSTEM_IMPL_H_
+
+#include <butil/iobuf.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/fs/io_uring.h"
+#include "src/fs/local_filesystem.h"
+
+namespace curve {
+namespace fs {
+
+/**
+ * 基于io_uring的本地文件系统实现
+ * 元数据操作以及单个的同步读写直接交给底层文件系统(ext4)处理，
+ * 通过SubmitBatch提交的请求会一次性放入ring中，由后台线程批量收割完成事件，
+ * 从而让一个线程可以同时有多个IO在途
+ * 如果内核不支持io_uring，Init时会退化为底层文件系统的同步实现
+ */
+class IOUringFileSystemImpl : public LocalFileSystem {
+ public:
+    explicit IOUringFileSystemImpl(std::shared_ptr<LocalFileSystem> base);
+    virtual ~IOUringFileSystemImpl();
+    static std::shared_ptr<IOUringFileSystemImpl> getInstance();
+
+    int Init(const LocalFileSystemOption& option) override;
+    /**
+     * 停止后台收割线程并释放ring，之后SubmitBatch退化为同步实现
+     */
+    void Uninit();
+
+    int Statfs(const string& path, struct FileSystemInfo* info) override;
+    int Open(const string& path, int flags) override;
+    int Close(int fd) override;
+    int Delete(const string& path) override;
+    int Mkdir(const string& dirPath) override;
+    bool DirExists(const string& dirPath) override;
+    bool FileExists(const string& filePath) override;
+    int List(const string& dirPath, vector<std::string>* names) override;
+    int Read(int fd, char* buf, uint64_t offset, int length) override;
+    int Write(int fd, const char* buf, uint64_t offset, int length) override;
+    int Write(int fd, butil::IOBuf buf, uint64_t offset, int length) override;
+    int Sync(int fd) override;
+    int Append(int fd, const char* buf, int length) override;
+    int Fallocate(int fd, int op, uint64_t offset,
+                  int length) override;
+    int Fstat(int fd, struct stat* info) override;
+    int Fsync(int fd) override;
+
+    int SubmitBatch(std::vector<AioRequest>* requests) override;
+    bool SupportAsyncIO() const override;
+    char* AllocIOBuffer(size_t size) override;
+    void FreeIOBuffer(char* buf) override;
+
+ private:
+    struct IOContext;
+
+    int DoRename(const string& oldPath,
+                 const string& newPath,
+                 unsigned int flags) override;
+
+    void InitFixedBuffers(uint32_t count, uint32_t size);
+    // 返回buf所在的固定buffer下标，不在固定buffer中返回-1
+    int FixedBufferIndex(const char* buf, int length) const;
+    void PrepareSqe(IOContext* ctx, struct io_uring_sqe* sqe);
+    // 占用一个在途名额，ring已满时先提交已准备好的sqe然后等待
+    void AcquireInflight();
+    void ReapLoop();
+    // 读写长度不足时用底层文件系统补齐剩余部分
+    void CompleteShortIO(AioRequest* req);
+
+ private:
+    static std::shared_ptr<IOUringFileSystemImpl> self_;
+    static std::mutex mutex_;
+
+    std::shared_ptr<LocalFileSystem> base_;
+    IOUring ring_;
+    std::atomic<bool> running_;
+    std::thread reaper_;
+
+    // 保护ring提交端
+    std::mutex submitMutex_;
+    // 在途的请求数，不能超过ring的深度，避免完成队列溢出
+    std::mutex inflightMutex_;
+    std::condition_variable inflightCond_;
+    uint32_t inflight_;
+    uint32_t queueDepth_;
+
+    // 注册到内核的固定buffer，连续分配后均分为fixedBufferCount_份
+    char* fixedBuffers_;
+    uint32_t fixedBufferCount_;
+    uint32_t fixedBufferSize_;
+    std::mutex bufferMutex_;
+    std::vector<uint32_t> freeFixedBuffers_;
+};
+
+}  // namespace fs
+}  // namespace curve
+
+#endif  // SRC_FS_IO_URING_FILESYSTEM_IMPL_H_
@@ -31,6 +31,7 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <cstdlib>
 #include <cstring>
 #include <mutex>  // NOLINT
 
@@ -45,7 +46,43 @@ namespace fs {
 
 struct LocalFileSystemOption {
     bool enableRenameat2;
-    LocalFileSystemOption() : enableRenameat2(false) {}
+    // io_uring提交队列深度，即单个ring上最多同时在途的IO数
+    uint32_t ioUringQueueDepth;
+    // 注册到内核的固定buffer个数及每个buffer的大小，为0表示不注册
+    uint32_t ioUringFixedBufferCount;
+    uint32_t ioUringFixedBufferSize;
+    LocalFileSystemOption()
+        : enableRenameat2(false)
+        , ioUringQueueDepth(128)
+        , ioUringFixedBufferCount(0)
+        , ioUringFixedBufferSize(0) {}
+};
+
+enum class AioOpType {
+    READ,
+    WRITE,
+    SYNC,
+};
+
+/**
+ * 批量提交接口中的单个IO请求
+ * op为SYNC时只使用fd，会在同一批次中排在它之前的请求完成之后再执行
+ * result为请求完成后的返回值，语义与Read/Write/Sync的返回值一致
+ */
+struct AioRequest {
+    AioOpType op;
+    int fd;
+    char* buf;
+    uint64_t offset;
+    int length;
+    int result;
+
+    AioRequest()
+        : op(AioOpType::READ), fd(-1), buf(nullptr),
+          offset(0), length(0), result(0) {}
+    AioRequest(AioOpType op, int fd, char* buf, uint64_t offset, int length)
+        : op(op), fd(fd), buf(buf), offset(offset), length(length),
+          result(0) {}
 };
 
 class LocalFileSystem {
@@ -215,6 +252,61 @@ class LocalFileSystem {
      */
     virtual int Fsync(int fd) = 0;
 
+    /**
+     * 批量提交一组IO请求，等待全部完成后返回
+     * 默认实现按顺序逐个同步执行，支持异步IO的实现会一次性提交整批请求
+     * @param requests: 待提交的请求，每个请求的结果写入其result字段
+     * @return 全部成功返回0，否则返回第一个失败请求的错误码
+     */
+    virtual int SubmitBatch(std::vector<AioRequest>* requests) {
+        int ret = 0;
+        for (auto& req : *requests) {
+            switch (req.op) {
+            case AioOpType::READ:
+                req.result = Read(req.fd, req.buf, req.offset, req.length);
+                break;
+            case AioOpType::WRITE:
+                req.result = Write(req.fd, req.buf, req.offset, req.length);
+                break;
+            case AioOpType::SYNC:
+                req.result = Sync(req.fd);
+                break;
+            }
+            if (req.result < 0 && ret == 0) {
+                ret = req.result;
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * 是否真正支持异步批量提交，为false时SubmitBatch只是同步执行的封装
+     */
+    virtual bool SupportAsyncIO() const {
+        return false;
+    }
+
+    /**
+     * 申请/释放用于IO的对齐内存
+     * 支持注册buffer的实现会优先从已注册到内核的固定buffer中分配，
+     * 通过SubmitBatch提交时可以省去内核每次IO对用户页的映射
+     * @param size: 申请的内存大小
+     * @return 成功返回4KB对齐的内存地址，失败返回nullptr
+     */
+    virtual char* AllocIOBuffer(size_t size) {
+        void* buf = nullptr;
+        if (posix_memalign(&buf, kIOBufferAlignment, size) != 0) {
+            return nullptr;
+        }
+        return static_cast<char*>(buf);
+    }
+
+    virtual void FreeIOBuffer(char* buf) {
+        free(buf);
+    }
+
+    static constexpr size_t kIOBufferAlignment = 4096;
+
  private:
     virtual int DoRename(const string& /* oldPath */,
                          const string& /* newPath */,
@@ -37,6 +37,7 @@ using ::curve::mds::topology::ChunkServerStatus;
 using ::curve::mds::topology::ChunkServerStat;
 using ::curve::mds::topology::CopysetStat;
 using ::curve::mds::topology::SplitPeerId;
+using ::curve::common::LockGuard;
 
 namespace curve {
 namespace mds {
@@ -46,7 +47,8 @@ HeartbeatManager::HeartbeatManager(HeartbeatOption option,
     std::shared_ptr<TopologyStat> topologyStat,
     std::shared_ptr<Coordinator> coordinator)
     : topology_(topology),
-      topologyStat_(topologyStat) {
+      topologyStat_(topologyStat),
+      coordinator_(coordinator) {
     healthyChecker_ =
         std::make_shared<ChunkserverHealthyChecker>(option, topology);
 
@@ -119,8 +121,49 @@ void HeartbeatManager::UpdateChunkServerDiskStatus(
     }
 }
 
+CopysetStat HeartbeatManager::GetCopysetStat(
+    const ChunkServerHeartbeatRequest &request,
+    const ::curve::mds::heartbeat::CopySetInfo &info) {
+    CopysetStat cstat;
+    cstat.logicalPoolId = info.logicalpoolid();
+    cstat.copysetId = info.copysetid();
+
+    // TODO(xuchaojie): use id instead when new protocol supported
+    std::string leaderPeer = info.leaderpeer().address();
+    std::string leaderIp;
+    uint32_t leaderPort;
+    if (SplitPeerId(leaderPeer, &leaderIp, &leaderPort)) {
+        cstat.leader =
+            topology_->FindChunkServerNotRetired(
+            leaderIp, leaderPort);
+        if (UNINTIALIZE_ID == cstat.leader) {
+            LOG(INFO) << "hearbeat receive from chunkserver(id:"
+                << request.chunkserverid()
+                << ",ip:"<< request.ip() << ",port:" << request.port()
+                << "), in which copyset(" << cstat.logicalPoolId
+                << "," << cstat.copysetId << ") dose not have leader.";
+        }
+    } else {
+        LOG(ERROR) << "hearbeat failed on SplitPeerId, "
+                   << "peerId string = " << leaderPeer;
+    }
+    if (info.has_stats()) {
+        cstat.readRate = info.stats().readrate();
+        cstat.writeRate = info.stats().writerate();
+        cstat.readIOPS = info.stats().readiops();
+        cstat.writeIOPS = info.stats().writeiops();
+    } else {
+        LOG(WARNING) << "hearbeat manager receive request "
+                     << "copyset {" << cstat.logicalPoolId
+                     << ", " << cstat.copysetId << "} "
+                     << "do not have CopysetStatistics";
+    }
+    return cstat;
+}
+
 void HeartbeatManager::UpdateChunkServerStatistics(
-    const ChunkServerHeartbeatRequest &request) {
+    const ChunkServerHeartbeatRequest &request,
+    const ChunkServerReport &report) {
     ChunkServerStat stat;
     stat.leaderCount = request.leadercount();
     stat.copysetCount = request.copysetcount();
@@ -134,45 +177,9 @@ void HeartbeatManager::UpdateChunkServerStatistics(
         stat.chunkSizeLeftBytes = request.stats().chunksizeleftbytes();
         stat.chunkSizeTrashedBytes = request.stats().chunksizetrashedbytes();
 
-        for (int i = 0; i < request.copysetinfos_size(); i++) {
-            CopysetStat cstat;
-            cstat.logicalPoolId = request.copysetinfos(i).logicalpoolid();
-            cstat.copysetId = request.copysetinfos(i).copysetid();
-
-            // TODO(xuchaojie): use id instead when new protocol supported
-            std::string leaderPeer =
-                request.copysetinfos(i).leaderpeer().address();
-            std::string leaderIp;
-            uint32_t leaderPort;
-            if (SplitPeerId(leaderPeer, &leaderIp, &leaderPort)) {
-                cstat.leader =
-                    topology_->FindChunkServerNotRetired(
-                    leaderIp, leaderPort);
-                if (UNINTIALIZE_ID == cstat.leader) {
-                    LOG(INFO) << "hearbeat receive from chunkserver(id:"
-                        << request.chunkserverid()
-                        << ",ip:"<< request.ip() << ",port:" << request.port()
-                        << "), in which copyset(" << cstat.logicalPoolId
-                        << "," << cstat.copysetId << ") dose not have leader.";
-                }
-            } else {
-                LOG(ERROR) << "hearbeat failed on SplitPeerId, "
-                           << "peerId string = " << leaderPeer;
-            }
-            if (request.copysetinfos(i).has_stats()) {
-                cstat.readRate = request.copysetinfos(i).stats().readrate();
-                cstat.writeRate = request.copysetinfos(i).stats().writerate();
-                cstat.readIOPS = request.copysetinfos(i).stats().readiops();
-                cstat.writeIOPS = request.copysetinfos(i).stats().writeiops();
-            } else {
-                LOG(WARNING) << "hearbeat manager receive request "
-                             << "copyset {" << cstat.logicalPoolId
-                             << ", " << cstat.copysetId << "} "
-                             << "do not have CopysetStatistics";
-            }
-            stat.copysetStats.push_back(cstat);
+        for (const auto &item : report.copysets) {
+            stat.copysetStats.push_back(item.second.stat);
         }
-
     } else {
         LOG(WARNING) << "hearbeat manager receive request "
                      << "do not have ChunkServerStatisticInfo";
@@ -180,6 +187,57 @@ void HeartbeatManager::UpdateChunkServerStatistics(
     topologyStat_->UpdateChunkServerStat(request.chunkserverid(), stat);
 }
 
+std::shared_ptr<HeartbeatManager::ChunkServerReport>
+HeartbeatManager::GetChunkServerReport(ChunkServerIdType id) {
+    LockGuard guard(reportsMutex_);
+    auto &report = reports_[id];
+    if (report == nullptr) {
+        report = std::make_shared<ChunkServerReport>();
+    }
+    return report;
+}
+
+void HeartbeatManager::RemoveChunkServerReport(ChunkServerIdType id) {
+    LockGuard guard(reportsMutex_);
+    reports_.erase(id);
+}
+
+bool HeartbeatManager::MergeChunkServerReport(
+    const ChunkServerHeartbeatRequest &request,
+    ChunkServerReport *report) {
+    bool complete = true;
+    if (!request.incremental()) {
+        report->copysets.clear();
+    } else if (!report->complete) {
+        // mds restarted or the last heartbeat failed, the copysets not
+        // changed are unknown, wait for the next full heartbeat
+        LOG(INFO) << "heartbeatManager receive incremental heartbeat from "
+                  << "chunkserver " << request.chunkserverid()
+                  << " without previous full one, request full heartbeat";
+        complete = false;
+    }
+
+    for (const auto &value : request.copysetinfos()) {
+        CopySetKey key(value.logicalpoolid(), value.copysetid());
+        if (request.incremental() &&
+            report->copysets.find(key) == report->copysets.end()) {
+            // the chunkserver sends full heartbeat when copysets are
+            // created or removed, so this should not happen
+            complete = false;
+        }
+        ReportedCopySet &item = report->copysets[key];
+        item.report = value;
+        item.changed = true;
+        item.converted = false;
+        if (request.has_stats()) {
+            item.stat = GetCopysetStat(request, value);
+        }
+    }
+
+    return complete &&
+        report->copysets.size() == request.copysetcount();
+}
+
 void HeartbeatManager::ChunkServerHeartbeat(
     const ChunkServerHeartbeatRequest &request,
     ChunkServerHeartbeatResponse *response) {
@@ -189,6 +247,10 @@ void HeartbeatManager::ChunkServerHeartbeat(
     if (ret != HeartbeatStatusCode::hbOK) {
         LOG(ERROR) << "heartbeatManager get error request";
         response->set_statuscode(ret);
+        if (ret == HeartbeatStatusCode::hbChunkserverUnknown ||
+            ret == HeartbeatStatusCode::hbChunkserverRetired) {
+            RemoveChunkServerReport(request.chunkserverid());
+        }
         return;
     }
 
@@ -204,13 +266,31 @@ void HeartbeatManager::ChunkServerHeartbeat(
 
     UpdateChunkServerDiskStatus(request);
 
-    UpdateChunkServerStatistics(request);
+    // the heartbeats of a chunkserver are sent one by one, so the lock is
+    // not contended, but it protects against the retried heartbeats
+    auto report = GetChunkServerReport(request.chunkserverid());
+    LockGuard guard(report->mutex);
+    bool complete = MergeChunkServerReport(request, report.get());
+
+    UpdateChunkServerStatistics(request, *report);
     // no copyset info in the request
-    if (request.copysetinfos_size() == 0) {
+    if (report->copysets.empty()) {
         response->set_statuscode(HeartbeatStatusCode::hbRequestNoCopyset);
     }
-    // dealing with copysets included in the heartbeat request
-    for (auto &value : request.copysetinfos()) {
+    // dealing with copysets included in the heartbeat request. For
+    // incremental heartbeat, the unchanged copysets have been dealt with by
+    // the previous heartbeats, and the topology has their info, only those
+    // with operator of the scheduler to dispatch are dealt with again.
+    // Followers not in the copyset are cleaned at the next full heartbeat
+    for (auto &pair : report->copysets) {
+        ReportedCopySet &item = pair.second;
+        bool changed = item.changed;
+        item.changed = false;
+        if (request.incremental() && !changed &&
+            !coordinator_->CopySetHasOperator(pair.first)) {
+            continue;
+        }
+        const ::curve::mds::heartbeat::CopySetInfo &value = item.report;
         // discard copysets of invalid logical pool
         ::curve::mds::topology::LogicalPool lPool;
         if (topology_->GetLogicalPool(value.logicalpoolid(), &lPool)) {
@@ -219,21 +299,27 @@ void HeartbeatManager::ChunkServerHeartbeat(
             }
         }
         // convert copysetInfo from heartbeat format to topology format
-        ::curve::mds::topology::CopySetInfo reportCopySetInfo;
-        if (!FromHeartbeatCopySetInfoToTopologyOne(value,
-                &reportCopySetInfo)) {
-            LOG(ERROR) << "heartbeatManager receive copyset("
-                       << value.logicalpoolid() << ","
-                       << value.copysetid()
-                       << ") information, but can not transfer to topology one";
-            response->set_statuscode(
-                            HeartbeatStatusCode::hbAnalyseCopysetError);
-            continue;
+        if (!item.converted) {
+            if (!FromHeartbeatCopySetInfoToTopologyOne(value, &item.info)) {
+                LOG(ERROR) << "heartbeatManager receive copyset("
+                           << value.logicalpoolid() << ","
+                           << value.copysetid()
+                           << ") information, but can not transfer to "
+                           << "topology one";
+                response->set_statuscode(
+                                HeartbeatStatusCode::hbAnalyseCopysetError);
+                // the chunkserver will not report the copyset again until
+                // it changes, request a full heartbeat to retry it
+                complete = false;
+                continue;
+            }
+            item.converted = true;
         }
+        const ::curve::mds::topology::CopySetInfo &reportCopySetInfo =
+            item.info;
 
         // forward reported copyset info to CopysetConfGenerator
         CopySetConf conf;
-        ConfigChangeInfo configChInfo;
         if (copysetConfGenerator_->GenCopysetConf(
                 request.chunkserverid(), reportCopySetInfo,
                 value.configchangeinfo(), &conf)) {
@@ -247,6 +333,9 @@ void HeartbeatManager::ChunkServerHeartbeat(
             topoUpdater_->UpdateTopo(reportCopySetInfo);
         }
     }
+
+    report->complete = complete;
+    response->set_acceptincremental(complete);
 }
 
 HeartbeatStatusCode HeartbeatManager::CheckRequest(
@@ -45,11 +45,14 @@ using ::curve::mds::topology::PoolIdType;
 using ::curve::mds::topology::CopySetIdType;
 using ::curve::mds::topology::Topology;
 using ::curve::mds::topology::TopologyStat;
+using ::curve::mds::topology::CopySetKey;
+using ::curve::mds::topology::CopysetStat;
 using ::curve::mds::schedule::Coordinator;
 
 using ::curve::common::Thread;
 using ::curve::common::Atomic;
 using ::curve::common::RWLock;
+using ::curve::common::Mutex;
 using ::curve::common::InterruptibleSleeper;
 
 namespace curve {
@@ -119,14 +122,59 @@ class HeartbeatManager {
     void UpdateChunkServerDiskStatus(
         const ChunkServerHeartbeatRequest &request);
 
+    // copyset reported by the heartbeat, with its conversion cached so
+    // that it needn't be converted again until it changes
+    struct ReportedCopySet {
+        ::curve::mds::heartbeat::CopySetInfo report;
+        // carried by the heartbeat being processed
+        bool changed = false;
+        bool converted = false;
+        ::curve::mds::topology::CopySetInfo info;
+        CopysetStat stat;
+    };
+
+    // all the copysets the chunkserver reported, an incremental heartbeat
+    // only carries the changed ones and the others are taken from here
+    struct ChunkServerReport {
+        Mutex mutex;
+        // whether copysets contains all the copysets on the chunkserver
+        bool complete = false;
+        std::map<CopySetKey, ReportedCopySet> copysets;
+    };
+
+    /**
+     * @brief Get the copysets last reported by the chunkserver,
+     *        create an empty one if not exist
+     */
+    std::shared_ptr<ChunkServerReport> GetChunkServerReport(
+        ChunkServerIdType id);
+
+    void RemoveChunkServerReport(ChunkServerIdType id);
+
+    /**
+     * @brief Merge the copysets of the heartbeat into the report of the
+     *        chunkserver, all the copysets are replaced by a full heartbeat
+     *
+     * @return true if the report has all the copysets after merging
+     */
+    bool MergeChunkServerReport(const ChunkServerHeartbeatRequest &request,
+                                ChunkServerReport *report);
+
     /**
      * @brief Update statistical data of chunkserver
      *
      * @param request Heartbeat request
-     * @param response response of heartbeat request
+     * @param report copysets reported by the chunkserver
      */
     void UpdateChunkServerStatistics(
-        const ChunkServerHeartbeatRequest &request);
+        const ChunkServerHeartbeatRequest &request,
+        const ChunkServerReport &report);
+
+    /**
+     * @brief Get the statistical data of the copyset reported
+     */
+    CopysetStat GetCopysetStat(const ChunkServerHeartbeatRequest &request,
+        const ::curve::mds::heartbeat::CopySetInfo &info);
 
     /**
      * @brief Background thread for heartbeat timeout inspection
@@ -189,6 +237,10 @@ class HeartbeatManager {
     Atomic<bool> isStop_;
     InterruptibleSleeper sleeper_;
     int chunkserverHealthyCheckerRunInter_;
+
+    // copysets reported by every chunkserver
+    Mutex reportsMutex_;
+    std::map<ChunkServerIdType, std::shared_ptr<ChunkServerReport>> reports_;
 };
 
 }  // namespace heartbeat
@@ -322,6 +322,11 @@ bool Coordinator::ChunkserverGoingToAdd(
     return false;
 }
 
+bool Coordinator::CopySetHasOperator(CopySetKey key) {
+    Operator op;
+    return opController_->GetOperatorById(key, &op);
+}
+
 bool Coordinator::ScheduleNeedRun(SchedulerType type) {
     switch (type) {
         case SchedulerType::CopySetSchedulerType:
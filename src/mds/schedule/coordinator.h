@@ -84,6 +84,13 @@ class Coordinator {
      */
     virtual bool ChunkserverGoingToAdd(ChunkServerIdType csId, CopySetKey key);
 
+    /**
+     * @brief determine whether there's operator on specified copyset
+     *
+     * @param[in] key Copyset specified
+     */
+    virtual bool CopySetHasOperator(CopySetKey key);
+
     /**
      * @brief Initialize the scheduler according to the configuration
      *
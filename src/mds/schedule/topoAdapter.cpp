@@ -27,6 +27,7 @@
 #include <memory>
 #include "src/mds/schedule/topoAdapter.h"
 #include "src/mds/common/mds_define.h"
+#include "src/mds/topology/topology_snapshot.h"
 #include "proto/topology.pb.h"
 
 using ::curve::mds::heartbeat::CandidateError;
@@ -155,20 +156,22 @@ bool TopoAdapterImpl::GetLogicalPool(
     return topo_->GetLogicalPool(id, lpool);
 }
 
-bool TopoAdapterImpl::GetCopySetInfo(const CopySetKey &id, CopySetInfo *info) {
+template <typename Topo>
+bool TopoAdapterImpl::GetCopySetInfo(const Topo &topo, const CopySetKey &id,
+                                     CopySetInfo *info) {
     ::curve::mds::topology::CopySetInfo csInfo;
     // cannot get copyset info
-    if (!topo_->GetCopySet(id, &csInfo)) {
+    if (!topo.GetCopySet(id, &csInfo)) {
         return false;
     }
 
     // cannot get logical pool
     ::curve::mds::topology::LogicalPool lpool;
-    if (!topo_->GetLogicalPool(csInfo.GetLogicalPoolId(), &lpool)) {
+    if (!topo.GetLogicalPool(csInfo.GetLogicalPoolId(), &lpool)) {
         return false;
     }
 
-    if (!CopySetFromTopoToSchedule(csInfo, info)) {
+    if (!CopySetFromTopoToSchedule(topo, csInfo, info)) {
         return false;
     }
 
@@ -176,11 +179,16 @@ bool TopoAdapterImpl::GetCopySetInfo(const CopySetKey &id, CopySetInfo *info) {
     return true;
 }
 
-std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfos() {
+bool TopoAdapterImpl::GetCopySetInfo(const CopySetKey &id, CopySetInfo *info) {
+    return GetCopySetInfo(*topo_, id, info);
+}
+
+template <typename Topo>
+std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfos(const Topo &topo) {
     std::vector<CopySetInfo> infos;
-    for (auto copySetKey : topo_->GetCopySetsInCluster()) {
+    for (auto copySetKey : topo.GetCopySetsInCluster()) {
         CopySetInfo copySetInfo;
-        if (GetCopySetInfo(copySetKey, &copySetInfo)) {
+        if (GetCopySetInfo(topo, copySetKey, &copySetInfo)) {
             if (copySetInfo.logicalPoolWork) {
                 infos.push_back(copySetInfo);
             }
@@ -189,14 +197,23 @@ std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfos() {
     return infos;
 }
 
+std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfos() {
+    auto snapshot = topo_->GetSnapshot();
+    if (snapshot != nullptr) {
+        return GetCopySetInfos(*snapshot);
+    }
+    return GetCopySetInfos(*topo_);
+}
+
+template <typename Topo>
 std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInChunkServer(
-    ChunkServerIdType id) {
-    std::vector<CopySetKey> keys = topo_->GetCopySetsInChunkServer(id);
+    const Topo &topo, ChunkServerIdType id) {
+    std::vector<CopySetKey> keys = topo.GetCopySetsInChunkServer(id);
 
     std::vector<CopySetInfo> out;
     for (auto key : keys) {
         CopySetInfo info;
-        if (GetCopySetInfo(key, &info)) {
+        if (GetCopySetInfo(topo, key, &info)) {
             if (info.logicalPoolWork) {
                 out.emplace_back(info);
             }
@@ -205,12 +222,22 @@ std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInChunkServer(
     return out;
 }
 
+std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInChunkServer(
+    ChunkServerIdType id) {
+    auto snapshot = topo_->GetSnapshot();
+    if (snapshot != nullptr) {
+        return GetCopySetInfosInChunkServer(*snapshot, id);
+    }
+    return GetCopySetInfosInChunkServer(*topo_, id);
+}
+
+template <typename Topo>
 std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInLogicalPool(
-    PoolIdType lid) {
+    const Topo &topo, PoolIdType lid) {
     std::vector<CopySetInfo> infos;
-    for (auto &copysetInfo : topo_->GetCopySetInfosInLogicalPool(lid)) {
+    for (auto &copysetInfo : topo.GetCopySetInfosInLogicalPool(lid)) {
         ::curve::mds::schedule::CopySetInfo out;
-        if (CopySetFromTopoToSchedule(copysetInfo, &out)) {
+        if (CopySetFromTopoToSchedule(topo, copysetInfo, &out)) {
             infos.emplace_back(out);
         }
     }
@@ -218,26 +245,44 @@ std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInLogicalPool(
     return infos;
 }
 
-bool TopoAdapterImpl::GetChunkServerInfo(ChunkServerIdType id,
+std::vector<CopySetInfo> TopoAdapterImpl::GetCopySetInfosInLogicalPool(
+    PoolIdType lid) {
+    auto snapshot = topo_->GetSnapshot();
+    if (snapshot != nullptr) {
+        return GetCopySetInfosInLogicalPool(*snapshot, lid);
+    }
+    return GetCopySetInfosInLogicalPool(*topo_, lid);
+}
+
+template <typename Topo>
+bool TopoAdapterImpl::GetChunkServerInfo(const Topo &topo,
+                                         ChunkServerIdType id,
                                          ChunkServerInfo *out) {
     assert(out != nullptr);
 
     ::curve::mds::topology::ChunkServer cs;
-    if (!topo_->GetChunkServer(id, &cs)) {
+    if (!topo.GetChunkServer(id, &cs)) {
         LOG(ERROR) << "can not get chunkServer:" << id << " from topology";
         return false;
     }
-    return ChunkServerFromTopoToSchedule(cs, out);
+    return ChunkServerFromTopoToSchedule(topo, cs, out);
 }
 
-std::vector<ChunkServerInfo> TopoAdapterImpl::GetChunkServerInfos() {
+bool TopoAdapterImpl::GetChunkServerInfo(ChunkServerIdType id,
+                                         ChunkServerInfo *out) {
+    return GetChunkServerInfo(*topo_, id, out);
+}
+
+template <typename Topo>
+std::vector<ChunkServerInfo> TopoAdapterImpl::GetChunkServerInfos(
+    const Topo &topo) {
     std::vector<ChunkServerInfo> infos;
-    for (auto chunkServerId : topo_->GetChunkServerInCluster(
+    for (auto chunkServerId : topo.GetChunkServerInCluster(
         [] (const ChunkServer &cs) {
             return cs.GetStatus() != ChunkServerStatus::RETIRED;
         })) {
         ChunkServerInfo info;
-        if (GetChunkServerInfo(chunkServerId, &info)) {
+        if (GetChunkServerInfo(topo, chunkServerId, &info)) {
             infos.push_back(info);
         }
     }
@@ -245,22 +290,40 @@ std::vector<ChunkServerInfo> TopoAdapterImpl::GetChunkServerInfos() {
     return infos;
 }
 
+std::vector<ChunkServerInfo> TopoAdapterImpl::GetChunkServerInfos() {
+    auto snapshot = topo_->GetSnapshot();
+    if (snapshot != nullptr) {
+        return GetChunkServerInfos(*snapshot);
+    }
+    return GetChunkServerInfos(*topo_);
+}
+
+template <typename Topo>
 std::vector<ChunkServerInfo> TopoAdapterImpl::GetChunkServersInLogicalPool(
-    PoolIdType lid) {
+    const Topo &topo, PoolIdType lid) {
     std::vector<ChunkServerInfo> infos;
-    auto ids = topo_->GetChunkServerInLogicalPool(lid,
+    auto ids = topo.GetChunkServerInLogicalPool(lid,
         [](const ChunkServer &chunkserver) {
             return chunkserver.GetStatus() != ChunkServerStatus::RETIRED;
         });
     for (auto id : ids) {
         ChunkServerInfo out;
-        if (GetChunkServerInfo(id, &out)) {
+        if (GetChunkServerInfo(topo, id, &out)) {
             infos.emplace_back(out);
         }
     }
     return infos;
 }
 
+std::vector<ChunkServerInfo> TopoAdapterImpl::GetChunkServersInLogicalPool(
+    PoolIdType lid) {
+    auto snapshot = topo_->GetSnapshot();
+    if (snapshot != nullptr) {
+        return GetChunkServersInLogicalPool(*snapshot, lid);
+    }
+    return GetChunkServersInLogicalPool(*topo_, lid);
+}
+
 int TopoAdapterImpl::GetStandardZoneNumInLogicalPool(PoolIdType id) {
     ::curve::mds::topology::LogicalPool logicalPool;
     if (topo_->GetLogicalPool(id, &logicalPool)) {
@@ -304,13 +367,15 @@ int TopoAdapterImpl::GetAvgScatterWidthInLogicalPool(PoolIdType id) {
     return 0;
 }
 
-bool TopoAdapterImpl::GetPeerInfo(ChunkServerIdType id, PeerInfo *peerInfo) {
+template <typename Topo>
+bool TopoAdapterImpl::GetPeerInfo(const Topo &topo, ChunkServerIdType id,
+                                  PeerInfo *peerInfo) {
     ::curve::mds::topology::ChunkServer cs;
     ::curve::mds::topology::Server server;
 
     bool canGetChunkServer, canGetServer;
-    if ((canGetChunkServer = topo_->GetChunkServer(id, &cs)) &&
-        (canGetServer = topo_->GetServer(cs.GetServerId(), &server))) {
+    if ((canGetChunkServer = topo.GetChunkServer(id, &cs)) &&
+        (canGetServer = topo.GetServer(cs.GetServerId(), &server))) {
         *peerInfo = PeerInfo(
             cs.GetId(), server.GetZoneId(), server.GetId(),
             cs.GetHostIp(), cs.GetPort());
@@ -323,7 +388,13 @@ bool TopoAdapterImpl::GetPeerInfo(ChunkServerIdType id, PeerInfo *peerInfo) {
     return true;
 }
 
+bool TopoAdapterImpl::GetPeerInfo(ChunkServerIdType id, PeerInfo *peerInfo) {
+    return GetPeerInfo(*topo_, id, peerInfo);
+}
+
+template <typename Topo>
 bool TopoAdapterImpl::CopySetFromTopoToSchedule(
+    const Topo &topo,
     const ::curve::mds::topology::CopySetInfo &origin,
     ::curve::mds::schedule::CopySetInfo *out) {
     assert(out != nullptr);
@@ -337,7 +408,7 @@ bool TopoAdapterImpl::CopySetFromTopoToSchedule(
 
     for (auto id : origin.GetCopySetMembers()) {
         PeerInfo peerInfo;
-        if (GetPeerInfo(id, &peerInfo)) {
+        if (GetPeerInfo(topo, id, &peerInfo)) {
             out->peers.emplace_back(peerInfo);
         } else {
             return false;
@@ -346,7 +417,7 @@ bool TopoAdapterImpl::CopySetFromTopoToSchedule(
 
     if (origin.HasCandidate()) {
         PeerInfo peerInfo;
-        if (GetPeerInfo(origin.GetCandidate(), &peerInfo)) {
+        if (GetPeerInfo(topo, origin.GetCandidate(), &peerInfo)) {
             out->candidatePeerInfo = peerInfo;
         } else {
             return false;
@@ -355,13 +426,21 @@ bool TopoAdapterImpl::CopySetFromTopoToSchedule(
     return true;
 }
 
+bool TopoAdapterImpl::CopySetFromTopoToSchedule(
+    const ::curve::mds::topology::CopySetInfo &origin,
+    ::curve::mds::schedule::CopySetInfo *out) {
+    return CopySetFromTopoToSchedule(*topo_, origin, out);
+}
+
+template <typename Topo>
 bool TopoAdapterImpl::ChunkServerFromTopoToSchedule(
+    const Topo &topo,
     const ::curve::mds::topology::ChunkServer &origin,
     ::curve::mds::schedule::ChunkServerInfo *out) {
     assert(out != nullptr);
 
     ::curve::mds::topology::Server server;
-    if (topo_->GetServer(origin.GetServerId(), &server)) {
+    if (topo.GetServer(origin.GetServerId(), &server)) {
         out->info = PeerInfo{origin.GetId(), server.GetZoneId(), server.GetId(),
                              origin.GetHostIp(), origin.GetPort()};
     } else {
@@ -387,6 +466,12 @@ bool TopoAdapterImpl::ChunkServerFromTopoToSchedule(
     return true;
 }
 
+bool TopoAdapterImpl::ChunkServerFromTopoToSchedule(
+    const ::curve::mds::topology::ChunkServer &origin,
+    ::curve::mds::schedule::ChunkServerInfo *out) {
+    return ChunkServerFromTopoToSchedule(*topo_, origin, out);
+}
+
 bool TopoAdapterImpl::CreateCopySetAtChunkServer(CopySetKey id,
                                                  ChunkServerIdType csID) {
     ::curve::mds::topology::CopySetInfo info(id.first, id.second);
@@ -395,14 +480,15 @@ bool TopoAdapterImpl::CreateCopySetAtChunkServer(CopySetKey id,
     return topoServiceManager_->CreateCopysetNodeOnChunkServer(csID, infos);
 }
 
-void TopoAdapterImpl::GetChunkServerScatterMap(
+template <typename Topo>
+void TopoAdapterImpl::GetChunkServerScatterMap(const Topo &topo,
     const ChunkServerIdType &cs, std::map<ChunkServerIdType, int> *out) {
     assert(out != nullptr);
 
-    std::vector<CopySetKey> copySetsInCS = topo_->GetCopySetsInChunkServer(cs);
+    std::vector<CopySetKey> copySetsInCS = topo.GetCopySetsInChunkServer(cs);
     for (auto key : copySetsInCS) {
         ::curve::mds::topology::CopySetInfo copySetInfo;
-        if (!topo_->GetCopySet(key, &copySetInfo)) {
+        if (!topo.GetCopySet(key, &copySetInfo)) {
             LOG(WARNING) << "topoAdapter find can not get copySet ("
                          << key.first << "," << key.second << ")"
                          << " from topology" << std::endl;
@@ -415,7 +501,7 @@ void TopoAdapterImpl::GetChunkServerScatterMap(
                 continue;
             }
 
-            if (!topo_->GetChunkServer(peerId, &chunkServer)) {
+            if (!topo.GetChunkServer(peerId, &chunkServer)) {
                 continue;
             }
 
@@ -431,6 +517,16 @@ void TopoAdapterImpl::GetChunkServerScatterMap(
         }
     }
 }
+
+void TopoAdapterImpl::GetChunkServerScatterMap(
+    const ChunkServerIdType &cs, std::map<ChunkServerIdType, int> *out) {
+    auto snapshot = topo_->GetSnapshot();
+    if (snapshot != nullptr) {
+        GetChunkServerScatterMap(*snapshot, cs, out);
+    } else {
+        GetChunkServerScatterMap(*topo_, cs, out);
+    }
+}
 }  // namespace schedule
 }  // namespace mds
 }  // namespace curve
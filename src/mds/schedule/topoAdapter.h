@@ -396,6 +396,55 @@ class TopoAdapterImpl : public TopoAdapter {
  private:
     bool GetPeerInfo(ChunkServerIdType id, PeerInfo *peerInfo);
 
+    // the helpers below read either the topology or its snapshot, which
+    // have the same query interface. The bulk queries prefer the snapshot
+    // so that scheduling doesn't contend with heartbeat updates
+    template <typename Topo>
+    bool GetPeerInfo(const Topo &topo, ChunkServerIdType id,
+                     PeerInfo *peerInfo);
+
+    template <typename Topo>
+    bool GetCopySetInfo(const Topo &topo, const CopySetKey &id,
+                        CopySetInfo *info);
+
+    template <typename Topo>
+    bool GetChunkServerInfo(const Topo &topo, ChunkServerIdType id,
+                            ChunkServerInfo *info);
+
+    template <typename Topo>
+    bool CopySetFromTopoToSchedule(
+        const Topo &topo,
+        const ::curve::mds::topology::CopySetInfo &origin,
+        ::curve::mds::schedule::CopySetInfo *out);
+
+    template <typename Topo>
+    bool ChunkServerFromTopoToSchedule(
+        const Topo &topo,
+        const ::curve::mds::topology::ChunkServer &origin,
+        ::curve::mds::schedule::ChunkServerInfo *out);
+
+    template <typename Topo>
+    std::vector<CopySetInfo> GetCopySetInfos(const Topo &topo);
+
+    template <typename Topo>
+    std::vector<CopySetInfo> GetCopySetInfosInChunkServer(
+        const Topo &topo, ChunkServerIdType id);
+
+    template <typename Topo>
+    std::vector<CopySetInfo> GetCopySetInfosInLogicalPool(
+        const Topo &topo, PoolIdType lid);
+
+    template <typename Topo>
+    std::vector<ChunkServerInfo> GetChunkServerInfos(const Topo &topo);
+
+    template <typename Topo>
+    std::vector<ChunkServerInfo> GetChunkServersInLogicalPool(
+        const Topo &topo, PoolIdType lid);
+
+    template <typename Topo>
+    void GetChunkServerScatterMap(const Topo &topo,
+        const ChunkServerIdType &cs, std::map<ChunkServerIdType, int> *out);
+
  private:
     std::shared_ptr<Topology> topo_;
     std::shared_ptr<TopologyServiceManager> topoServiceManager_;
@@ -32,7 +32,9 @@ using ::curve::mds::topology::TopologyStorageCodec;
 namespace curve {
 namespace mds {
 
-using LRUCache = ::curve::common::LRUCache<std::string, std::string>;
+using ShardedLRUCache =
+    ::curve::common::ShardedLRUCache<std::string, std::string>;
+using ::curve::common::CacheEvictPolicy;
 using CacheMetrics = ::curve::common::CacheMetrics;
 
 MDS::~MDS() {
@@ -64,6 +66,16 @@ void MDS::InitMdsOptions(std::shared_ptr<Configuration> conf) {
 
     // cache size of namestorage
     conf_->GetValueFatalIfFail("mds.cache.count", &options_.mdsCacheCount);
+    options_.mdsCacheShardNum = 1;
+    LOG_IF(WARNING, !conf_->GetUInt32Value("mds.cache.shardNum",
+                                           &options_.mdsCacheShardNum))
+        << "config no mds.cache.shardNum info, use default: "
+        << options_.mdsCacheShardNum;
+    options_.mdsCacheEvictPolicy = "lru";
+    LOG_IF(WARNING, !conf_->GetStringValue("mds.cache.evictPolicy",
+                                           &options_.mdsCacheEvictPolicy))
+        << "config no mds.cache.evictPolicy info, use default: "
+        << options_.mdsCacheEvictPolicy;
 
     conf_->GetValueFatalIfFail("mds.listen.addr", &options_.mdsListenAddr);
 
@@ -120,7 +132,8 @@ void MDS::StartCompaginLeader() {
 void MDS::Init() {
     InitSegmentAllocStatistic(options_.retryInterTimes,
                               options_.periodicPersistInterMs);
-    InitNameServerStorage(options_.mdsCacheCount);
+    InitNameServerStorage(options_.mdsCacheCount, options_.mdsCacheShardNum,
+                          options_.mdsCacheEvictPolicy);
     InitTopology(options_.topologyOption);
     InitTopologyStat();
     InitTopologyChunkAllocator(options_.topologyOption);
@@ -311,6 +324,11 @@ void MDS::InitTopologyOption(TopologyOption *topologyOption) {
     conf_->GetValueFatalIfFail(
         "mds.topology.enableLogicalPoolStatus",
         &topologyOption->enableLogicalPoolStatus);
+    LOG_IF(WARNING, !conf_->GetUInt32Value(
+        "mds.topology.SnapshotPublishIntervalMs",
+        &topologyOption->SnapshotPublishIntervalMs))
+        << "config no mds.topology.SnapshotPublishIntervalMs info, "
+        << "use default: " << topologyOption->SnapshotPublishIntervalMs;
 }
 
 void MDS::InitTopology(const TopologyOption& option) {
@@ -391,12 +409,21 @@ void MDS::InitTopologyChunkAllocator(const TopologyOption& option) {
     LOG(INFO) << "init topologyChunkAllocator success.";
 }
 
-void MDS::InitNameServerStorage(int mdsCacheCount) {
-    // init LRUCache
-
-    auto cache = std::make_shared<LRUCache>(mdsCacheCount,
+void MDS::InitNameServerStorage(int mdsCacheCount, uint32_t cacheShardNum,
+                                const std::string& cacheEvictPolicy) {
+    // init namestorage cache
+    CacheEvictPolicy policy = CacheEvictPolicy::LRU;
+    if (cacheEvictPolicy == "clock") {
+        policy = CacheEvictPolicy::CLOCK;
+    } else if (cacheEvictPolicy != "lru") {
+        LOG(WARNING) << "unknown cache evict policy " << cacheEvictPolicy
+                     << ", use lru";
+    }
+    auto cache = std::make_shared<ShardedLRUCache>(mdsCacheCount,
+        cacheShardNum, policy,
         std::make_shared<CacheMetrics>("mds_nameserver_cache_metric"));
-    LOG(INFO) << "init LRUCache success.";
+    LOG(INFO) << "init namestorage cache success, shard num: " << cacheShardNum
+              << ", evict policy: " << cacheEvictPolicy;
 
     // init NameServerStorage
     nameServerStorage_ = std::make_shared<NameServerStorageImp>(etcdClient_,
@@ -96,6 +96,9 @@ struct MDSOptions {
     uint64_t periodicPersistInterMs;
     // cache size of namestorage
     int mdsCacheCount;
+    // shard number and evict policy(lru/clock) of namestorage cache
+    uint32_t mdsCacheShardNum;
+    std::string mdsCacheEvictPolicy;
     int mdsFilelockBucketNum;
 
     FileRecordOptions fileRecordOptions;
@@ -179,7 +182,8 @@ class MDS {
     void InitSegmentAllocStatistic(uint64_t retryInterTimes,
                                    uint64_t periodicPersistInterMs);
 
-    void InitNameServerStorage(int mdsCacheCount);
+    void InitNameServerStorage(int mdsCacheCount, uint32_t cacheShardNum,
+                               const std::string& cacheEvictPolicy);
 
     void StartServer();
 
@@ -23,8 +23,10 @@
 #include <glog/logging.h>
 #include "src/common/timeutility.h"
 #include "src/common/uuid.h"
+#include "src/mds/topology/topology_snapshot.h"
 
 #include <chrono>  //NOLINT
+#include <utility>
 
 using ::curve::common::UUIDGenerator;
 
@@ -32,6 +34,24 @@ namespace curve {
 namespace mds {
 namespace topology {
 
+namespace {
+
+// bump the change version when the modification returns, i.e. after it is
+// applied and the locks are released, so the next publish will include it
+class ChangeVersionGuard {
+ public:
+    explicit ChangeVersionGuard(std::atomic<uint64_t> *version)
+        : version_(version) {}
+    ~ChangeVersionGuard() {
+        version_->fetch_add(1, std::memory_order_release);
+    }
+
+ private:
+    std::atomic<uint64_t> *version_;
+};
+
+}  // namespace
+
 PoolIdType TopologyImpl::AllocateLogicalPoolId() {
     return idGenerator_->GenLogicalPoolId();
 }
@@ -57,6 +77,7 @@ std::string TopologyImpl::AllocateToken() {
 }
 
 int TopologyImpl::AddLogicalPool(const LogicalPool &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     ReadLockGuard rlockPhysicalPool(physicalPoolMutex_);
     WriteLockGuard wlockLogicalPool(logicalPoolMutex_);
     auto it = physicalPoolMap_.find(data.GetPhysicalPoolId());
@@ -76,6 +97,7 @@ int TopologyImpl::AddLogicalPool(const LogicalPool &data) {
 }
 
 int TopologyImpl::AddPhysicalPool(const PhysicalPool &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockPhysicalPool(physicalPoolMutex_);
     if (physicalPoolMap_.find(data.GetId()) == physicalPoolMap_.end()) {
         if (!storage_->StoragePhysicalPool(data)) {
@@ -89,6 +111,7 @@ int TopologyImpl::AddPhysicalPool(const PhysicalPool &data) {
 }
 
 int TopologyImpl::AddZone(const Zone &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     ReadLockGuard rlockPhysicalPool(physicalPoolMutex_);
     WriteLockGuard wlockZone(zoneMutex_);
     auto it = physicalPoolMap_.find(data.GetPhysicalPoolId());
@@ -109,6 +132,7 @@ int TopologyImpl::AddZone(const Zone &data) {
 }
 
 int TopologyImpl::AddServer(const Server &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     ReadLockGuard rlockZone(zoneMutex_);
     WriteLockGuard wlockServer(serverMutex_);
     auto it = zoneMap_.find(data.GetZoneId());
@@ -129,6 +153,7 @@ int TopologyImpl::AddServer(const Server &data) {
 }
 
 int TopologyImpl::AddChunkServer(const ChunkServer &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     // find the physical pool that the chunkserver belongs to
     PoolIdType belongPhysicalPoolId = UNINTIALIZE_ID;
     int ret = GetBelongPhysicalPoolIdByServerId(
@@ -171,6 +196,7 @@ int TopologyImpl::AddChunkServer(const ChunkServer &data) {
 }
 
 int TopologyImpl::RemoveLogicalPool(PoolIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockLogicalPool(logicalPoolMutex_);
     auto it = logicalPoolMap_.find(id);
     if (it != logicalPoolMap_.end()) {
@@ -185,6 +211,7 @@ int TopologyImpl::RemoveLogicalPool(PoolIdType id) {
 }
 
 int TopologyImpl::RemovePhysicalPool(PoolIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockPhysicalPool(physicalPoolMutex_);
     auto it = physicalPoolMap_.find(id);
     if (it != physicalPoolMap_.end()) {
@@ -202,6 +229,7 @@ int TopologyImpl::RemovePhysicalPool(PoolIdType id) {
 }
 
 int TopologyImpl::RemoveZone(ZoneIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockPhysicalPool(physicalPoolMutex_);
     WriteLockGuard wlockZone(zoneMutex_);
     auto it = zoneMap_.find(id);
@@ -224,6 +252,7 @@ int TopologyImpl::RemoveZone(ZoneIdType id) {
 }
 
 int TopologyImpl::RemoveServer(ServerIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockZone(zoneMutex_);
     WriteLockGuard wlockServer(serverMutex_);
     auto it = serverMap_.find(id);
@@ -246,6 +275,7 @@ int TopologyImpl::RemoveServer(ServerIdType id) {
 }
 
 int TopologyImpl::RemoveChunkServer(ChunkServerIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockServer(serverMutex_);
     WriteLockGuard wlockChunkServer(chunkServerMutex_);
     auto it = chunkServerMap_.find(id);
@@ -268,6 +298,7 @@ int TopologyImpl::RemoveChunkServer(ChunkServerIdType id) {
 }
 
 int TopologyImpl::UpdateLogicalPool(const LogicalPool &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockLogicalPool(logicalPoolMutex_);
     auto it = logicalPoolMap_.find(data.GetId());
     if (it != logicalPoolMap_.end()) {
@@ -283,6 +314,7 @@ int TopologyImpl::UpdateLogicalPool(const LogicalPool &data) {
 
 int TopologyImpl::UpdateLogicalPoolAllocateStatus(const AllocateStatus &status,
                                     PoolIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockLogicalPool(logicalPoolMutex_);
     auto it = logicalPoolMap_.find(id);
     if (it != logicalPoolMap_.end()) {
@@ -299,6 +331,7 @@ int TopologyImpl::UpdateLogicalPoolAllocateStatus(const AllocateStatus &status,
 }
 
 int TopologyImpl::UpdateLogicalPoolScanState(PoolIdType lpid, bool scanEnable) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockLogicalPool(logicalPoolMutex_);
 
     auto iter = logicalPoolMap_.find(lpid);
@@ -317,6 +350,7 @@ int TopologyImpl::UpdateLogicalPoolScanState(PoolIdType lpid, bool scanEnable) {
 }
 
 int TopologyImpl::UpdatePhysicalPool(const PhysicalPool &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockPhysicalPool(physicalPoolMutex_);
     auto it = physicalPoolMap_.find(data.GetId());
     if (it != physicalPoolMap_.end()) {
@@ -331,6 +365,7 @@ int TopologyImpl::UpdatePhysicalPool(const PhysicalPool &data) {
 }
 
 int TopologyImpl::UpdateZone(const Zone &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockZone(zoneMutex_);
     auto it = zoneMap_.find(data.GetId());
     if (it != zoneMap_.end()) {
@@ -345,6 +380,7 @@ int TopologyImpl::UpdateZone(const Zone &data) {
 }
 
 int TopologyImpl::UpdateServer(const Server &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     WriteLockGuard wlockServer(serverMutex_);
     auto it = serverMap_.find(data.GetId());
     if (it != serverMap_.end()) {
@@ -359,6 +395,7 @@ int TopologyImpl::UpdateServer(const Server &data) {
 }
 
 int TopologyImpl::UpdateChunkServerTopo(const ChunkServer &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     ReadLockGuard rlockChunkServerMap(chunkServerMutex_);
     auto it = chunkServerMap_.find(data.GetId());
     if (it != chunkServerMap_.end()) {
@@ -381,6 +418,7 @@ int TopologyImpl::UpdateChunkServerTopo(const ChunkServer &data) {
 
 int TopologyImpl::UpdateChunkServerRwState(const ChunkServerStatus &rwState,
                               ChunkServerIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     // find physical pool that it belongs to
     PoolIdType belongPhysicalPoolId = UNINTIALIZE_ID;
     int ret = GetBelongPhysicalPoolId(id, &belongPhysicalPoolId);
@@ -480,6 +518,7 @@ int TopologyImpl::GetBelongPhysicalPoolId(ChunkServerIdType csId,
 
 int TopologyImpl::UpdateChunkServerOnlineState(const OnlineState &onlineState,
                                     ChunkServerIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     ReadLockGuard rlockChunkServerMap(chunkServerMutex_);
     auto it = chunkServerMap_.find(id);
     if (it != chunkServerMap_.end()) {
@@ -494,6 +533,7 @@ int TopologyImpl::UpdateChunkServerOnlineState(const OnlineState &onlineState,
 
 int TopologyImpl::UpdateChunkServerDiskStatus(const ChunkServerState &state,
                                    ChunkServerIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     // find physical pool it belongs to
     PoolIdType belongPhysicalPoolId = UNINTIALIZE_ID;
     int ret = GetBelongPhysicalPoolId(id, &belongPhysicalPoolId);
@@ -533,6 +573,7 @@ int TopologyImpl::UpdateChunkServerDiskStatus(const ChunkServerState &state,
 
 int TopologyImpl::UpdateChunkServerStartUpTime(uint64_t time,
                      ChunkServerIdType id) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
     ReadLockGuard rlockChunkServerMap(chunkServerMutex_);
     auto it = chunkServerMap_.find(id);
     if (it != chunkServerMap_.end()) {
@@ -1052,6 +1093,8 @@ CopySetIdType TopologyImpl::AllocateCopySetId(PoolIdType logicalPoolId) {
 }
 
 int TopologyImpl::AddCopySet(const CopySetInfo &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
+    ChangeVersionGuard copySetVersionGuard(&copySetVersion_);
     ReadLockGuard rlockLogicalPool(logicalPoolMutex_);
     WriteLockGuard wlockCopySetMap(copySetMutex_);
     auto it = logicalPoolMap_.find(data.GetLogicalPoolId());
@@ -1072,6 +1115,8 @@ int TopologyImpl::AddCopySet(const CopySetInfo &data) {
 }
 
 int TopologyImpl::RemoveCopySet(CopySetKey key) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
+    ChangeVersionGuard copySetVersionGuard(&copySetVersion_);
     WriteLockGuard wlockCopySetMap(copySetMutex_);
     auto it = copySetMap_.find(key);
     if (it != copySetMap_.end()) {
@@ -1086,6 +1131,8 @@ int TopologyImpl::RemoveCopySet(CopySetKey key) {
 }
 
 int TopologyImpl::UpdateCopySetTopo(const CopySetInfo &data) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
+    ChangeVersionGuard copySetVersionGuard(&copySetVersion_);
     ReadLockGuard rlockCopySetMap(copySetMutex_);
     CopySetKey key(data.GetLogicalPoolId(), data.GetId());
     auto it = copySetMap_.find(key);
@@ -1120,6 +1167,8 @@ int TopologyImpl::UpdateCopySetTopo(const CopySetInfo &data) {
 }
 
 int TopologyImpl::SetCopySetAvalFlag(const CopySetKey &key, bool aval) {
+    ChangeVersionGuard versionGuard(&changeVersion_);
+    ChangeVersionGuard copySetVersionGuard(&copySetVersion_);
     ReadLockGuard rlockCopySetMap(copySetMutex_);
     auto it = copySetMap_.find(key);
     if (it != copySetMap_.end()) {
@@ -1208,6 +1257,11 @@ int TopologyImpl::Run() {
     if (isStop_.exchange(false)) {
         backEndThread_ = curve::common::Thread(
             &TopologyImpl::BackEndFunc, this);
+        if (option_.SnapshotPublishIntervalMs > 0) {
+            PublishSnapshot();
+            snapshotThread_ = curve::common::Thread(
+                &TopologyImpl::SnapshotFunc, this);
+        }
     }
     return 0;
 }
@@ -1217,6 +1271,9 @@ int TopologyImpl::Stop() {
         LOG(INFO) << "stop TopologyImpl...";
         sleeper_.interrupt();
         backEndThread_.join();
+        if (snapshotThread_.joinable()) {
+            snapshotThread_.join();
+        }
         LOG(INFO) << "stop TopologyImpl ok.";
     }
     return 0;
@@ -1230,6 +1287,85 @@ void TopologyImpl::BackEndFunc() {
     }
 }
 
+void TopologyImpl::SnapshotFunc() {
+    while (sleeper_.wait_for(
+        std::chrono::milliseconds(option_.SnapshotPublishIntervalMs))) {
+        auto snapshot = GetSnapshot();
+        if (snapshot == nullptr || snapshot->GetVersion() !=
+                changeVersion_.load(std::memory_order_acquire)) {
+            PublishSnapshot();
+        }
+    }
+}
+
+std::shared_ptr<const TopologySnapshot> TopologyImpl::GetSnapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+void TopologyImpl::PublishSnapshot() {
+    // the modifications finished after loading the version are published
+    // next time, even if some of them are already included in this snapshot
+    uint64_t version = changeVersion_.load(std::memory_order_acquire);
+    uint64_t copySetVersion = copySetVersion_.load(std::memory_order_acquire);
+
+    TopologySnapshot::LogicalPoolMap logicalPools;
+    TopologySnapshot::PhysicalPoolMap physicalPools;
+    TopologySnapshot::ZoneMap zones;
+    TopologySnapshot::ServerMap servers;
+    TopologySnapshot::ChunkServerMap chunkServers;
+    std::shared_ptr<const TopologySnapshot::CopySets> copySets;
+    {
+        ReadLockGuard rlockLogicalPool(logicalPoolMutex_);
+        logicalPools = logicalPoolMap_;
+    }
+    {
+        ReadLockGuard rlockPhysicalPool(physicalPoolMutex_);
+        physicalPools = physicalPoolMap_;
+    }
+    {
+        ReadLockGuard rlockZone(zoneMutex_);
+        zones = zoneMap_;
+    }
+    {
+        ReadLockGuard rlockServer(serverMutex_);
+        servers = serverMap_;
+    }
+    {
+        ReadLockGuard rlockChunkServerMap(chunkServerMutex_);
+        chunkServers.reserve(chunkServerMap_.size());
+        for (const auto &it : chunkServerMap_) {
+            ReadLockGuard rlockChunkServer(it.second.GetRWLockRef());
+            chunkServers[it.first] = it.second;
+        }
+    }
+    // the heartbeats update the chunkservers frequently, but rarely the
+    // copysets, so the copysets are copied only when they are modified
+    auto last = GetSnapshot();
+    if (last != nullptr &&
+            last->GetCopySets()->version == copySetVersion) {
+        copySets = last->GetCopySets();
+    } else {
+        TopologySnapshot::CopySetMap copySetMap;
+        {
+            ReadLockGuard rlockCopySetMap(copySetMutex_);
+            for (const auto &it : copySetMap_) {
+                ReadLockGuard rlockCopySet(it.second.GetRWLockRef());
+                copySetMap.emplace_hint(copySetMap.end(), it.first,
+                                        it.second);
+            }
+        }
+        copySets = std::make_shared<TopologySnapshot::CopySets>(
+            copySetVersion, std::move(copySetMap));
+    }
+
+    std::shared_ptr<const TopologySnapshot> snapshot =
+        std::make_shared<TopologySnapshot>(
+            version, std::move(logicalPools), std::move(physicalPools),
+            std::move(zones), std::move(servers), std::move(chunkServers),
+            std::move(copySets));
+    std::atomic_store(&snapshot_, snapshot);
+}
+
 void TopologyImpl::FlushCopySetToStorage() {
     std::vector<PoolIdType> pools = GetLogicalPoolInCluster();
     for (const auto poolId : pools) {
@@ -22,6 +22,7 @@
 #ifndef SRC_MDS_TOPOLOGY_TOPOLOGY_H_
 #define SRC_MDS_TOPOLOGY_TOPOLOGY_H_
 
+#include <atomic>
 #include <unordered_map>
 #include <string>
 #include <list>
@@ -55,6 +56,8 @@ using PhysicalPoolFilter = std::function<bool (const PhysicalPool&)>;
 using LogicalPoolFilter = std::function<bool(const LogicalPool&)>;
 using CopySetFilter = std::function<bool (const CopySetInfo&)>;
 
+class TopologySnapshot;
+
 class Topology {
  public:
     Topology() {}
@@ -328,6 +331,14 @@ class Topology {
             return true;}) const = 0;
 
     virtual std::string GetHostNameAndPortById(ChunkServerIdType csId) = 0;
+
+    /**
+     * @brief get the latest published snapshot of the topology, which can
+     *        be read without locking, but may lag behind the topology
+     *
+     * @return the snapshot, nullptr if snapshot is not enabled
+     */
+    virtual std::shared_ptr<const TopologySnapshot> GetSnapshot() const = 0;
 };
 
 class TopologyImpl : public Topology {
@@ -338,6 +349,8 @@ class TopologyImpl : public Topology {
         : idGenerator_(idGenerator),
           tokenGenerator_(tokenGenerator),
           storage_(storage),
+          changeVersion_(0),
+          copySetVersion_(0),
           isStop_(true) {
     }
 
@@ -571,6 +584,14 @@ class TopologyImpl : public Topology {
 
     std::string GetHostNameAndPortById(ChunkServerIdType csId) override;
 
+    std::shared_ptr<const TopologySnapshot> GetSnapshot() const override;
+
+    /**
+     * @brief build a snapshot of the current topology and publish it,
+     *        called by the background thread regularly when modified
+     */
+    void PublishSnapshot();
+
  private:
     int LoadClusterInfo();
 
@@ -578,6 +599,8 @@ class TopologyImpl : public Topology {
 
     void BackEndFunc();
 
+    void SnapshotFunc();
+
     void FlushCopySetToStorage();
 
     void FlushChunkServerToStorage();
@@ -608,8 +631,17 @@ class TopologyImpl : public Topology {
     mutable curve::common::RWLock chunkServerMutex_;
     mutable curve::common::RWLock copySetMutex_;
 
+    // bumped after every modification of the topology
+    std::atomic<uint64_t> changeVersion_;
+    // bumped before changeVersion_ after every modification of the copysets,
+    // the copysets of the last snapshot are reused if it is not changed
+    std::atomic<uint64_t> copySetVersion_;
+    // the latest published snapshot, accessed by std::atomic_load/store
+    std::shared_ptr<const TopologySnapshot> snapshot_;
+
     TopologyOption option_;
     curve::common::Thread backEndThread_;
+    curve::common::Thread snapshotThread_;
     curve::common::Atomic<bool> isStop_;
     InterruptibleSleeper sleeper_;
 };
@@ -30,6 +30,8 @@
 #include <list>
 #include <random>
 
+#include "src/mds/topology/topology_snapshot.h"
+
 
 namespace curve {
 namespace mds {
@@ -54,11 +56,8 @@ bool TopologyChunkAllocatorImpl::AllocateChunkRandomInSingleLogicalPool(
         return false;
     }
 
-    CopySetFilter filter = [](const CopySetInfo& copyset) {
-            return copyset.IsAvailable();
-    };
     std::vector<CopySetIdType> copySetIds =
-        topology_->GetCopySetsInLogicalPool(logicalPoolChosenId, filter);
+        GetAvailableCopySets(logicalPoolChosenId);
 
     if (0 == copySetIds.size()) {
         LOG(ERROR) << "[AllocateChunkRandomInSingleLogicalPool]:"
@@ -91,11 +90,8 @@ bool TopologyChunkAllocatorImpl::AllocateChunkRoundRobinInSingleLogicalPool(
         return false;
     }
 
-    CopySetFilter filter = [](const CopySetInfo& copyset) {
-            return copyset.IsAvailable();
-    };
     std::vector<CopySetIdType> copySetIds =
-        topology_->GetCopySetsInLogicalPool(logicalPoolChosenId, filter);
+        GetAvailableCopySets(logicalPoolChosenId);
 
     if (0 == copySetIds.size()) {
         LOG(ERROR) << "[AllocateChunkRoundRobinInSingleLogicalPool]:"
@@ -131,6 +127,25 @@ bool TopologyChunkAllocatorImpl::AllocateChunkRoundRobinInSingleLogicalPool(
     return ret;
 }
 
+std::vector<CopySetIdType> TopologyChunkAllocatorImpl::GetAvailableCopySets(
+    PoolIdType logicalPoolId) {
+    CopySetFilter filter = [](const CopySetInfo& copyset) {
+            return copyset.IsAvailable();
+    };
+    // the snapshot keeps the copysets indexed by logical pool, and reading it
+    // doesn't contend with the copyset updates by heartbeat. A logical pool
+    // created after the latest snapshot is read from the topology
+    auto snapshot = topology_->GetSnapshot();
+    if (snapshot != nullptr) {
+        std::vector<CopySetIdType> copySetIds =
+            snapshot->GetCopySetsInLogicalPool(logicalPoolId, filter);
+        if (!copySetIds.empty()) {
+            return copySetIds;
+        }
+    }
+    return topology_->GetCopySetsInLogicalPool(logicalPoolId, filter);
+}
+
 bool TopologyChunkAllocatorImpl::ChooseSingleLogicalPool(
     curve::mds::FileType fileType,
     PoolIdType *poolOut) {
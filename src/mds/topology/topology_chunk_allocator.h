@@ -123,6 +123,16 @@ class TopologyChunkAllocatorImpl : public TopologyChunkAllocator {
     bool ChooseSingleLogicalPool(curve::mds::FileType fileType,
         PoolIdType *poolOut);
 
+    /**
+     * @brief get the available copysets in the logical pool, from the
+     *        topology snapshot if it is enabled
+     *
+     * @param logicalPoolId logical pool id
+     *
+     * @return copyset id list
+     */
+    std::vector<CopySetIdType> GetAvailableCopySets(PoolIdType logicalPoolId);
+
  private:
     std::shared_ptr<Topology> topology_;
 
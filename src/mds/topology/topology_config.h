@@ -46,6 +46,9 @@ struct TopologyOption {
     int choosePoolPolicy;
     // enable LogicalPool ALLOW/DENY status
     bool enableLogicalPoolStatus;
+    // time interval of publishing topology snapshot for lock-free readers
+    // (in ms), 0 means disabled
+    uint32_t SnapshotPublishIntervalMs;
 
     TopologyOption()
         : TopologyUpdateToRepoSec(0),
@@ -55,7 +58,8 @@ struct TopologyOption {
           UpdateMetricIntervalSec(0),
           PoolUsagePercentLimit(100),
           choosePoolPolicy(0),
-          enableLogicalPoolStatus(false) {}
+          enableLogicalPoolStatus(false),
+          SnapshotPublishIntervalMs(0) {}
 };
 
 }  // namespace topology
@@ -0,0 +1,217 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include "src/mds/topology/topology_snapshot.h"
+
+#include <utility>
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+namespace {
+
+template <typename Map, typename Key, typename Value>
+bool FindInMap(const Map &map, const Key &key, Value *out) {
+    auto it = map.find(key);
+    if (it == map.end()) {
+        return false;
+    }
+    *out = it->second;
+    return true;
+}
+
+}  // namespace
+
+TopologySnapshot::CopySets::CopySets(uint64_t version,
+                                     CopySetMap copySetMap)
+    : version(version),
+      copySetMap(std::move(copySetMap)) {
+    for (const auto &it : this->copySetMap) {
+        inLogicalPool[it.first.first].push_back(&it.second);
+        for (ChunkServerIdType id : it.second.GetCopySetMembers()) {
+            inChunkServer[id].push_back(&it.second);
+        }
+    }
+}
+
+TopologySnapshot::TopologySnapshot(uint64_t version,
+                                   LogicalPoolMap logicalPools,
+                                   PhysicalPoolMap physicalPools,
+                                   ZoneMap zones,
+                                   ServerMap servers,
+                                   ChunkServerMap chunkServers,
+                                   std::shared_ptr<const CopySets> copySets)
+    : version_(version),
+      logicalPools_(std::move(logicalPools)),
+      physicalPools_(std::move(physicalPools)),
+      zones_(std::move(zones)),
+      servers_(std::move(servers)),
+      chunkServers_(std::move(chunkServers)),
+      copySets_(std::move(copySets)) {}
+
+bool TopologySnapshot::GetLogicalPool(PoolIdType poolId,
+                                      LogicalPool *out) const {
+    return FindInMap(logicalPools_, poolId, out);
+}
+
+bool TopologySnapshot::GetPhysicalPool(PoolIdType poolId,
+                                       PhysicalPool *out) const {
+    return FindInMap(physicalPools_, poolId, out);
+}
+
+bool TopologySnapshot::GetZone(ZoneIdType zoneId, Zone *out) const {
+    return FindInMap(zones_, zoneId, out);
+}
+
+bool TopologySnapshot::GetServer(ServerIdType serverId, Server *out) const {
+    return FindInMap(servers_, serverId, out);
+}
+
+bool TopologySnapshot::GetChunkServer(ChunkServerIdType chunkserverId,
+                                      ChunkServer *out) const {
+    return FindInMap(chunkServers_, chunkserverId, out);
+}
+
+bool TopologySnapshot::GetCopySet(CopySetKey key, CopySetInfo *out) const {
+    return FindInMap(copySets_->copySetMap, key, out);
+}
+
+std::vector<PoolIdType> TopologySnapshot::GetLogicalPoolInCluster(
+    LogicalPoolFilter filter) const {
+    std::vector<PoolIdType> ret;
+    for (const auto &it : logicalPools_) {
+        if (filter(it.second)) {
+            ret.push_back(it.first);
+        }
+    }
+    return ret;
+}
+
+std::vector<ChunkServerIdType> TopologySnapshot::GetChunkServerInCluster(
+    ChunkServerFilter filter) const {
+    std::vector<ChunkServerIdType> ret;
+    for (const auto &it : chunkServers_) {
+        if (filter(it.second)) {
+            ret.push_back(it.first);
+        }
+    }
+    return ret;
+}
+
+std::vector<CopySetKey> TopologySnapshot::GetCopySetsInCluster(
+    CopySetFilter filter) const {
+    std::vector<CopySetKey> ret;
+    for (const auto &it : copySets_->copySetMap) {
+        if (filter(it.second)) {
+            ret.push_back(it.first);
+        }
+    }
+    return ret;
+}
+
+std::list<ChunkServerIdType> TopologySnapshot::GetChunkServerInLogicalPool(
+    PoolIdType id,
+    ChunkServerFilter filter) const {
+    std::list<ChunkServerIdType> ret;
+    auto lpIt = logicalPools_.find(id);
+    if (lpIt == logicalPools_.end()) {
+        return ret;
+    }
+    auto ppIt = physicalPools_.find(lpIt->second.GetPhysicalPoolId());
+    if (ppIt == physicalPools_.end()) {
+        return ret;
+    }
+    for (ZoneIdType zoneId : ppIt->second.GetZoneList()) {
+        auto zoneIt = zones_.find(zoneId);
+        if (zoneIt == zones_.end()) {
+            continue;
+        }
+        for (ServerIdType serverId : zoneIt->second.GetServerList()) {
+            auto serverIt = servers_.find(serverId);
+            if (serverIt == servers_.end()) {
+                continue;
+            }
+            for (ChunkServerIdType csId :
+                 serverIt->second.GetChunkServerList()) {
+                auto csIt = chunkServers_.find(csId);
+                if (csIt != chunkServers_.end() && filter(csIt->second)) {
+                    ret.push_back(csId);
+                }
+            }
+        }
+    }
+    return ret;
+}
+
+std::vector<CopySetIdType> TopologySnapshot::GetCopySetsInLogicalPool(
+    PoolIdType logicalPoolId,
+    CopySetFilter filter) const {
+    std::vector<CopySetIdType> ret;
+    auto it = copySets_->inLogicalPool.find(logicalPoolId);
+    if (it == copySets_->inLogicalPool.end()) {
+        return ret;
+    }
+    ret.reserve(it->second.size());
+    for (const CopySetInfo *copyset : it->second) {
+        if (filter(*copyset)) {
+            ret.push_back(copyset->GetId());
+        }
+    }
+    return ret;
+}
+
+std::vector<CopySetInfo> TopologySnapshot::GetCopySetInfosInLogicalPool(
+    PoolIdType logicalPoolId,
+    CopySetFilter filter) const {
+    std::vector<CopySetInfo> ret;
+    auto it = copySets_->inLogicalPool.find(logicalPoolId);
+    if (it == copySets_->inLogicalPool.end()) {
+        return ret;
+    }
+    for (const CopySetInfo *copyset : it->second) {
+        if (filter(*copyset)) {
+            ret.push_back(*copyset);
+        }
+    }
+    return ret;
+}
+
+std::vector<CopySetKey> TopologySnapshot::GetCopySetsInChunkServer(
+    ChunkServerIdType id,
+    CopySetFilter filter) const {
+    std::vector<CopySetKey> ret;
+    auto it = copySets_->inChunkServer.find(id);
+    if (it == copySets_->inChunkServer.end()) {
+        return ret;
+    }
+    for (const CopySetInfo *copyset : it->second) {
+        if (filter(*copyset)) {
+            ret.push_back(copyset->GetCopySetKey());
+        }
+    }
+    return ret;
+}
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#ifndef SRC_MDS_TOPOLOGY_TOPOLOGY_SNAPSHOT_H_
+#define SRC_MDS_TOPOLOGY_TOPOLOGY_SNAPSHOT_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "src/mds/topology/topology.h"
+#include "src/mds/topology/topology_item.h"
+
+namespace curve {
+namespace mds {
+namespace topology {
+
+/**
+ * An immutable copy of the topology at some version, published by the
+ * topology regularly when it is modified. Readers hold the snapshot by
+ * shared_ptr, so they never block or are blocked by the topology updates,
+ * at the cost of seeing the data of up to one publish interval ago.
+ * The copysets, which are the most part of the topology, are shared by the
+ * snapshots until they are modified, so the frequent updates of the
+ * chunkservers by heartbeat only copy the other small parts.
+ *
+ * The query interfaces are the same as those of Topology.
+ */
+class TopologySnapshot {
+ public:
+    using LogicalPoolMap = std::unordered_map<PoolIdType, LogicalPool>;
+    using PhysicalPoolMap = std::unordered_map<PoolIdType, PhysicalPool>;
+    using ZoneMap = std::unordered_map<ZoneIdType, Zone>;
+    using ServerMap = std::unordered_map<ServerIdType, Server>;
+    using ChunkServerMap = std::unordered_map<ChunkServerIdType, ChunkServer>;
+    using CopySetMap = std::map<CopySetKey, CopySetInfo>;
+
+    // the copysets with their indexes, immutable after construction
+    struct CopySets {
+        CopySets(uint64_t version, CopySetMap copySetMap);
+
+        CopySets(const CopySets &) = delete;
+        CopySets &operator=(const CopySets &) = delete;
+
+        // the copyset version of the topology they are taken at
+        uint64_t version;
+        CopySetMap copySetMap;
+        // point to the elements of copySetMap
+        std::unordered_map<PoolIdType, std::vector<const CopySetInfo *>>
+            inLogicalPool;
+        std::unordered_map<ChunkServerIdType,
+                           std::vector<const CopySetInfo *>> inChunkServer;
+    };
+
+    TopologySnapshot(uint64_t version,
+                     LogicalPoolMap logicalPools,
+                     PhysicalPoolMap physicalPools,
+                     ZoneMap zones,
+                     ServerMap servers,
+                     ChunkServerMap chunkServers,
+                     std::shared_ptr<const CopySets> copySets);
+
+    TopologySnapshot(const TopologySnapshot &) = delete;
+    TopologySnapshot &operator=(const TopologySnapshot &) = delete;
+
+    // the change version of the topology this snapshot is taken at
+    uint64_t GetVersion() const {
+        return version_;
+    }
+
+    // reused by the next snapshot if the copysets are not modified
+    std::shared_ptr<const CopySets> GetCopySets() const {
+        return copySets_;
+    }
+
+    bool GetLogicalPool(PoolIdType poolId, LogicalPool *out) const;
+    bool GetPhysicalPool(PoolIdType poolId, PhysicalPool *out) const;
+    bool GetZone(ZoneIdType zoneId, Zone *out) const;
+    bool GetServer(ServerIdType serverId, Server *out) const;
+    bool GetChunkServer(ChunkServerIdType chunkserverId,
+                        ChunkServer *out) const;
+    bool GetCopySet(CopySetKey key, CopySetInfo *out) const;
+
+    std::vector<PoolIdType> GetLogicalPoolInCluster(
+        LogicalPoolFilter filter = [](const LogicalPool&) {
+            return true;}) const;
+
+    std::vector<ChunkServerIdType> GetChunkServerInCluster(
+        ChunkServerFilter filter = [](const ChunkServer&) {
+            return true;}) const;
+
+    std::vector<CopySetKey> GetCopySetsInCluster(
+        CopySetFilter filter = [](const CopySetInfo&) {
+            return true;}) const;
+
+    std::list<ChunkServerIdType> GetChunkServerInLogicalPool(
+        PoolIdType id,
+        ChunkServerFilter filter = [](const ChunkServer&) {
+            return true;}) const;
+
+    std::vector<CopySetIdType> GetCopySetsInLogicalPool(
+        PoolIdType logicalPoolId,
+        CopySetFilter filter = [](const CopySetInfo&) {
+            return true;}) const;
+
+    std::vector<CopySetInfo> GetCopySetInfosInLogicalPool(
+        PoolIdType logicalPoolId,
+        CopySetFilter filter = [](const CopySetInfo&) {
+            return true;}) const;
+
+    std::vector<CopySetKey> GetCopySetsInChunkServer(
+        ChunkServerIdType id,
+        CopySetFilter filter = [](const CopySetInfo&) {
+            return true;}) const;
+
+ private:
+    uint64_t version_;
+
+    LogicalPoolMap logicalPools_;
+    PhysicalPoolMap physicalPools_;
+    ZoneMap zones_;
+    ServerMap servers_;
+    ChunkServerMap chunkServers_;
+    std::shared_ptr<const CopySets> copySets_;
+};
+
+}  // namespace topology
+}  // namespace mds
+}  // namespace curve
+
+#endif  // SRC_MDS_TOPOLOGY_TOPOLOGY_SNAPSHOT_H_
@@ -24,6 +24,9 @@
 #include <gmock/gmock.h>
 #include <glog/logging.h>
 
+#include <cstring>
+#include <vector>
+
 #include "include/client/libcurve.h"
 #include "src/chunkserver/clone_copyer.h"
 #include "src/chunkserver/clone_core.h"
@@ -364,5 +367,140 @@ TEST_F(CloneCopyerTest, ExpiredTest) {
     ASSERT_EQ(0, copyer.Fini());
 }
 
+TEST_F(CloneCopyerTest, FetchUnitTest) {
+    const uint32_t kFetchUnit = 64 * 1024;
+    OriginCopyer copyer;
+    CopyerOptions options;
+    options.curveConf = CURVE_CONF;
+    options.s3Conf = S3_CONF;
+    options.curveUser.owner = ROOT_OWNER;
+    options.curveUser.password = ROOT_PWD;
+    options.curveClient = nullptr;
+    options.s3Client = s3Client_;
+    options.curveFileTimeoutSec = EXPIRED_USE;
+    options.fetchUnit = kFetchUnit;
+    options.cacheBytes = 2 * kFetchUnit;
+    ASSERT_EQ(0, copyer.Init(options));
+
+    // 对象的内容为偏移对251取模
+    auto fillObject = [](const std::shared_ptr<GetObjectAsyncContext>& ctx) {
+        for (size_t i = 0; i < ctx->len; ++i) {
+            ctx->buf[i] = static_cast<char>((ctx->offset + i) % 251);
+        }
+    };
+    auto checkData = [](const AsyncDownloadContext& context) {
+        for (size_t i = 0; i < context.size; ++i) {
+            if (context.buf[i] !=
+                static_cast<char>((context.offset + i) % 251)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<std::shared_ptr<GetObjectAsyncContext>> fetches;
+    auto saveFetch = [&](std::shared_ptr<GetObjectAsyncContext> ctx) {
+        fetches.push_back(ctx);
+    };
+
+    char buf1[4096];
+    AsyncDownloadContext context1;
+    context1.location = "test@s3";
+    context1.offset = 4096;
+    context1.size = 4096;
+    context1.buf = buf1;
+    MockDownloadClosure closure1(&context1);
+
+    char buf2[8192];
+    AsyncDownloadContext context2;
+    context2.location = "test@s3";
+    context2.offset = 16384;
+    context2.size = 8192;
+    context2.buf = buf2;
+    MockDownloadClosure closure2(&context2);
+
+    /* 用例:并发读取同一个单位内的数据
+     * 预期:只对齐下载一次，完成后两个请求都返回
+     */
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillOnce(Invoke(saveFetch));
+    copyer.DownloadAsync(&closure1);
+    copyer.DownloadAsync(&closure2);
+    ASSERT_FALSE(closure1.IsRun());
+    ASSERT_FALSE(closure2.IsRun());
+    ASSERT_EQ(1, fetches.size());
+    ASSERT_EQ("test", fetches[0]->key);
+    ASSERT_EQ(0, fetches[0]->offset);
+    ASSERT_EQ(kFetchUnit, fetches[0]->len);
+    fillObject(fetches[0]);
+    fetches[0]->retCode = 0;
+    fetches[0]->cb(s3Client_.get(), fetches[0]);
+    ASSERT_TRUE(closure1.IsRun());
+    ASSERT_FALSE(closure1.IsFailed());
+    ASSERT_TRUE(checkData(context1));
+    ASSERT_TRUE(closure2.IsRun());
+    ASSERT_FALSE(closure2.IsFailed());
+    ASSERT_TRUE(checkData(context2));
+    closure1.Reset();
+    closure2.Reset();
+    fetches.clear();
+
+    /* 用例:再次读取该单位内的数据
+     * 预期:从缓存中读取
+     */
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .Times(0);
+    memset(buf1, 0, sizeof(buf1));
+    copyer.DownloadAsync(&closure1);
+    ASSERT_TRUE(closure1.IsRun());
+    ASSERT_FALSE(closure1.IsFailed());
+    ASSERT_TRUE(checkData(context1));
+    closure1.Reset();
+
+    /* 用例:读取跨越两个单位的数据
+     * 预期:只下载未缓存的单位
+     */
+    context2.offset = kFetchUnit - 4096;
+    memset(buf2, 0, sizeof(buf2));
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .WillOnce(Invoke(saveFetch));
+    copyer.DownloadAsync(&closure2);
+    ASSERT_FALSE(closure2.IsRun());
+    ASSERT_EQ(1, fetches.size());
+    ASSERT_EQ(kFetchUnit, fetches[0]->offset);
+    fillObject(fetches[0]);
+    fetches[0]->retCode = 0;
+    fetches[0]->cb(s3Client_.get(), fetches[0]);
+    ASSERT_TRUE(closure2.IsRun());
+    ASSERT_FALSE(closure2.IsFailed());
+    ASSERT_TRUE(checkData(context2));
+    closure2.Reset();
+    fetches.clear();
+
+    /* 用例:下载失败
+     * 预期:请求返回失败，数据不会被缓存
+     */
+    context1.location = "test2@s3";
+    EXPECT_CALL(*s3Client_, GetObjectAsync(_))
+        .Times(2)
+        .WillRepeatedly(Invoke(
+            [&] (const std::shared_ptr<GetObjectAsyncContext>& context) {
+                context->retCode = -1;
+                context->cb(s3Client_.get(), context);
+            }));
+    copyer.DownloadAsync(&closure1);
+    ASSERT_TRUE(closure1.IsRun());
+    ASSERT_TRUE(closure1.IsFailed());
+    closure1.Reset();
+    copyer.DownloadAsync(&closure1);
+    ASSERT_TRUE(closure1.IsRun());
+    ASSERT_TRUE(closure1.IsFailed());
+    closure1.Reset();
+
+    EXPECT_CALL(*s3Client_, Deinit())
+        .Times(1);
+    ASSERT_EQ(0, copyer.Fini());
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -645,6 +645,113 @@ TEST_F(OpRequestTest, ReadChunkTest) {
     info.chunkSize = CHUNK_SIZE;
     info.bitmap = std::make_shared<Bitmap>(CHUNK_SIZE / PAGE_SIZE);
 
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == true,
+     *       请求的 apply index 大于 node的 apply index，但leader lease有效
+     * 预期： 不会走一致性协议，请求提交给concurrentApplyModule_处理
+     */
+    {
+        closure->Reset();
+
+        EXPECT_CALL(*node_, IsLeaderTerm())
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*node_, IsLeaseReadEnabled())
+            .WillOnce(Return(true));
+        EXPECT_CALL(*node_, GetLeaderLeaseStatus(_))
+            .Times(1);
+        EXPECT_CALL(*node_, IsLeaseLeader(_))
+            .WillOnce(Return(true));
+        EXPECT_CALL(*node_, Propose(_))
+            .Times(0);
+
+        info.isClone = false;
+        EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+            .WillOnce(
+                DoAll(SetArgPointee<1>(info), Return(CSErrorCode::Success)));
+        char chunkData[length];  // NOLINT
+        memset(chunkData, 'a', length);
+        EXPECT_CALL(*datastore_, ReadChunk(_, _, _, offset, length))
+            .WillOnce(DoAll(SetArrayArgument<2>(chunkData, chunkData + length),
+                            Return(CSErrorCode::Success)));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_)).Times(1);
+
+        opReq->Process();
+
+        int retry = 10;
+        while (retry-- > 0 && !closure->isDone_) {
+            ::sleep(1);
+        }
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  closure->response_->status());
+    }
+
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == false, 开启follower read，
+     *       本节点已经apply到leader的read index
+     * 预期： 不会转发请求，请求提交给concurrentApplyModule_处理
+     */
+    {
+        closure->Reset();
+
+        EXPECT_CALL(*node_, IsLeaderTerm())
+            .WillRepeatedly(Return(false));
+        EXPECT_CALL(*node_, IsFollowerReadEnabled())
+            .WillOnce(Return(true));
+        EXPECT_CALL(*node_, WaitReadIndex())
+            .WillOnce(Return(true));
+        EXPECT_CALL(*node_, Propose(_))
+            .Times(0);
+
+        info.isClone = false;
+        EXPECT_CALL(*datastore_, GetChunkInfo(_, _))
+            .WillOnce(
+                DoAll(SetArgPointee<1>(info), Return(CSErrorCode::Success)));
+        char chunkData[length];  // NOLINT
+        memset(chunkData, 'a', length);
+        EXPECT_CALL(*datastore_, ReadChunk(_, _, _, offset, length))
+            .WillOnce(DoAll(SetArrayArgument<2>(chunkData, chunkData + length),
+                            Return(CSErrorCode::Success)));
+        EXPECT_CALL(*node_, UpdateAppliedIndex(_)).Times(1);
+
+        opReq->Process();
+
+        int retry = 10;
+        while (retry-- > 0 && !closure->isDone_) {
+            ::sleep(1);
+        }
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  closure->response_->status());
+    }
+
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == false, 开启follower read，
+     *       等待read index超时
+     * 预期： 会要求转发请求，返回CHUNK_OP_STATUS_REDIRECTED
+     */
+    {
+        closure->Reset();
+
+        EXPECT_CALL(*node_, IsLeaderTerm())
+            .WillRepeatedly(Return(false));
+        EXPECT_CALL(*node_, IsFollowerReadEnabled())
+            .WillOnce(Return(true));
+        EXPECT_CALL(*node_, WaitReadIndex())
+            .WillOnce(Return(false));
+        EXPECT_CALL(*node_, Propose(_))
+            .Times(0);
+
+        opReq->Process();
+
+        ASSERT_TRUE(closure->isDone_);
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_REDIRECTED,
+                  closure->response_->status());
+    }
+
     /**
      * 测试Process
      * 用例： node_->IsLeaderTerm() == true,
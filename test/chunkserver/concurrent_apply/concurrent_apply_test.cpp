@@ -32,6 +32,7 @@
 using curve::chunkserver::concurrent::ConcurrentApplyModule;
 using curve::chunkserver::concurrent::ConcurrentApplyOption;
 using curve::chunkserver::CHUNK_OP_TYPE;
+using curve::common::CountDownEvent;
 
 TEST(ConcurrentApplyModule, InitTest) {
     ConcurrentApplyModule concurrentapply;
@@ -166,3 +167,31 @@ TEST(ConcurrentApplyModule, ConcurrentTest) {
     concurrentapply.Stop();
 }
 
+
+TEST(ConcurrentApplyModule, PushAfterWriteTest) {
+    ConcurrentApplyModule concurrentapply;
+    ConcurrentApplyOption opt{1, 1, 1, 1};
+    ASSERT_TRUE(concurrentapply.Init(opt));
+
+    std::atomic<int> testw(0);
+    auto wtask = [&testw]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        testw++;
+    };
+
+    CountDownEvent event(1);
+    int readw = -1;
+    auto rtask = [&testw, &readw, &event]() {
+        readw = testw.load();
+        event.Signal();
+    };
+
+    // the read is not executed until the queued write is done
+    ASSERT_TRUE(concurrentapply.Push(1, CHUNK_OP_TYPE::CHUNK_OP_WRITE, wtask));
+    ASSERT_TRUE(
+        concurrentapply.PushAfterWrite(1, CHUNK_OP_TYPE::CHUNK_OP_READ, rtask));
+    event.Wait();
+    ASSERT_EQ(1, readw);
+
+    concurrentapply.Stop();
+}
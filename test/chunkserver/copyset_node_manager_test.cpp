@@ -23,13 +23,17 @@
 #include <gtest/gtest.h>
 #include <unistd.h>
 #include <brpc/server.h>
+#include <braft/protobuf_file.h>
+#include <braft/local_storage.pb.h>
 
 #include <cstdio>
 #include <cstdlib>
+#include <string>
 
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/copyset_node.h"
 #include "test/chunkserver/mock_copyset_node.h"
+#include "src/chunkserver/raftsnapshot/define.h"
 
 namespace curve {
 namespace chunkserver {
@@ -332,6 +336,27 @@ TEST_F(CopysetNodeManagerTest, ReloadTest) {
     copysetNodes.clear();
     copysetNodeManager->GetAllCopysetNodes(&copysetNodes);
     ASSERT_EQ(0, copysetNodes.size());
+
+    // 投票给自己的copyset被认为可能是leader，优先加载
+    std::string metaPath = std::string("./node_manager_test/") +
+        ToGroupId(logicPoolId, copysetId + 1) + "/" + RAFT_META_DIR +
+        "/" + RAFT_META_FILE;
+    braft::StablePBMeta meta;
+    meta.set_term(1);
+    meta.set_votedfor("127.0.0.1:" + std::to_string(port) + ":0");
+    braft::ProtoBufFile pbFile(metaPath);
+    ASSERT_EQ(0, pbFile.save(&meta, false));
+    defaultOptions_.loadConcurrency = 3;
+    ASSERT_EQ(0, copysetNodeManager->Init(defaultOptions_));
+    ASSERT_EQ(0, copysetNodeManager->Run());
+    copysetNodes.clear();
+    copysetNodeManager->GetAllCopysetNodes(&copysetNodes);
+    ASSERT_EQ(5, copysetNodes.size());
+    std::string value;
+    ASSERT_EQ(0, bvar::Variable::describe_exposed(
+        "chunkserver_reload_copysets_leader_likely", &value));
+    ASSERT_EQ("1", value);
+    ASSERT_EQ(0, copysetNodeManager->Fini());
 }
 
 }  // namespace chunkserver
@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/datastore/chunkserver_page_crc.h"
+#include "src/common/crc32.h"
+
+namespace curve {
+namespace chunkserver {
+
+const ChunkSizeType kChunkSize = 64 * 1024;
+const PageSizeType kPageSize = 4096;
+
+class PageCrcTest : public testing::Test {
+ protected:
+    void SetUp() override {
+        chunk_.assign(kChunkSize, 0);
+        for (size_t i = 0; i < chunk_.size(); ++i) {
+            chunk_[i] = static_cast<char>(i * 7 + i / kPageSize);
+        }
+    }
+
+    void Write(ChunkPageCrc* pageCrc, char c, off_t offset, size_t length) {
+        std::string data(length, c);
+        chunk_.replace(offset, length, data);
+        pageCrc->Update(data.data(), offset, length);
+    }
+
+    // scan the range like the chunk file does
+    uint32_t Scan(ChunkPageCrc* pageCrc, uint32_t begin, uint32_t end,
+                  uint32_t* pagesRead, uint32_t* mismatch) {
+        std::vector<BitRange> ranges;
+        pageCrc->GetUnscannedRanges(begin, end, &ranges);
+        *pagesRead = 0;
+        *mismatch = 0;
+        for (auto& range : ranges) {
+            uint32_t count = range.endIndex - range.beginIndex + 1;
+            *mismatch += pageCrc->Scan(
+                chunk_.data() + range.beginIndex * kPageSize,
+                range.beginIndex, count);
+            *pagesRead += count;
+        }
+        return pageCrc->RangeCrc(begin, end);
+    }
+
+    uint32_t ExpectCrc(uint32_t begin, uint32_t end) {
+        return ::curve::common::CRC32(chunk_.data() + begin * kPageSize,
+                                      (end - begin + 1) * kPageSize);
+    }
+
+    std::string chunk_;
+};
+
+TEST_F(PageCrcTest, IncrementalScanTest) {
+    ChunkPageCrc pageCrc(kChunkSize, kPageSize);
+    uint32_t pagesRead;
+    uint32_t mismatch;
+
+    // all pages are unknown at first
+    ASSERT_EQ(ExpectCrc(0, 15), Scan(&pageCrc, 0, 15, &pagesRead, &mismatch));
+    ASSERT_EQ(16, pagesRead);
+    ASSERT_EQ(0, mismatch);
+
+    // nothing changed
+    ASSERT_EQ(ExpectCrc(0, 15), Scan(&pageCrc, 0, 15, &pagesRead, &mismatch));
+    ASSERT_EQ(0, pagesRead);
+
+    // only the written pages are read
+    Write(&pageCrc, 'a', 2 * kPageSize, 3 * kPageSize);
+    ASSERT_EQ(ExpectCrc(0, 7), Scan(&pageCrc, 0, 7, &pagesRead, &mismatch));
+    ASSERT_EQ(3, pagesRead);
+    ASSERT_EQ(0, mismatch);
+
+    // partially written pages become unknown
+    Write(&pageCrc, 'b', kPageSize + 512, kPageSize);
+    ASSERT_EQ(ExpectCrc(0, 7), Scan(&pageCrc, 0, 7, &pagesRead, &mismatch));
+    ASSERT_EQ(2, pagesRead);
+    ASSERT_EQ(0, mismatch);
+}
+
+TEST_F(PageCrcTest, IOBufUpdateTest) {
+    ChunkPageCrc pageCrc1(kChunkSize, kPageSize);
+    ChunkPageCrc pageCrc2(kChunkSize, kPageSize);
+
+    // the data spans several blocks of iobuf
+    std::string data(5 * kPageSize, 0);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i % 251);
+    }
+    butil::IOBuf buf;
+    for (size_t off = 0; off < data.size(); off += 1000) {
+        buf.append(data.data() + off, std::min<size_t>(1000,
+                                                       data.size() - off));
+    }
+    pageCrc1.Update(data.data(), 512, data.size());
+    pageCrc2.Update(buf, 512, data.size());
+
+    std::string encoded1;
+    std::string encoded2;
+    pageCrc1.Encode(&encoded1);
+    pageCrc2.Encode(&encoded2);
+    ASSERT_EQ(encoded1, encoded2);
+}
+
+TEST_F(PageCrcTest, VerifyTest) {
+    ChunkPageCrc pageCrc(kChunkSize, kPageSize);
+    Write(&pageCrc, 'a', 0, 4 * kPageSize);
+
+    ASSERT_TRUE(pageCrc.Verify(chunk_.data(), 0, 4 * kPageSize));
+    // pages partially read are not verified
+    ASSERT_TRUE(pageCrc.Verify(chunk_.data() + 512, 512, kPageSize));
+    // unknown pages are not verified
+    ASSERT_TRUE(pageCrc.Verify(chunk_.data(), 0, 8 * kPageSize));
+
+    // data changed on disk
+    chunk_[kPageSize + 10] = 'x';
+    ASSERT_FALSE(pageCrc.Verify(chunk_.data(), 0, 4 * kPageSize));
+    ASSERT_FALSE(pageCrc.Verify(chunk_.data() + kPageSize,
+                                kPageSize, kPageSize));
+
+    // scan finds the mismatch and records the data on disk
+    uint32_t pagesRead;
+    uint32_t mismatch;
+    ASSERT_EQ(ExpectCrc(0, 3), Scan(&pageCrc, 0, 3, &pagesRead, &mismatch));
+    ASSERT_EQ(4, pagesRead);
+    ASSERT_EQ(1, mismatch);
+}
+
+TEST_F(PageCrcTest, EncodeDecodeTest) {
+    ChunkPageCrc pageCrc(kChunkSize, kPageSize);
+    ASSERT_TRUE(pageCrc.Dirty());
+    uint32_t pagesRead;
+    uint32_t mismatch;
+    Scan(&pageCrc, 0, 7, &pagesRead, &mismatch);
+    Write(&pageCrc, 'a', 8 * kPageSize, kPageSize);
+
+    std::string encoded;
+    pageCrc.Encode(&encoded);
+    pageCrc.MarkPersisted();
+    ASSERT_FALSE(pageCrc.Dirty());
+
+    ChunkPageCrc loaded(kChunkSize, kPageSize);
+    ASSERT_TRUE(loaded.Decode(encoded));
+    ASSERT_FALSE(loaded.Dirty());
+    // the scanned and written state are kept
+    ASSERT_EQ(ExpectCrc(0, 8), Scan(&loaded, 0, 8, &pagesRead, &mismatch));
+    ASSERT_EQ(1, pagesRead);
+    ASSERT_EQ(0, mismatch);
+
+    // broken content
+    std::string broken = encoded;
+    broken[broken.size() - 1] ^= 0x01;
+    ChunkPageCrc brokenCrc(kChunkSize, kPageSize);
+    ASSERT_FALSE(brokenCrc.Decode(broken));
+    ASSERT_FALSE(brokenCrc.Decode(encoded.substr(1)));
+    ASSERT_FALSE(brokenCrc.Decode(""));
+
+    // page count mismatch
+    ChunkPageCrc other(2 * kChunkSize, kPageSize);
+    ASSERT_FALSE(other.Decode(encoded));
+}
+
+}  // namespace chunkserver
+}  // namespace curve
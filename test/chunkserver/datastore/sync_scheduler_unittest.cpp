@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/chunkserver/datastore/sync_scheduler.h"
+#include "src/common/timeutility.h"
+
+namespace curve {
+namespace chunkserver {
+
+TEST(SyncSchedulerTest, SyncWithoutStart) {
+    SyncScheduler scheduler;
+    int called = 0;
+    ASSERT_EQ(-5, scheduler.SyncAndWait(nullptr, 1, [&called]() {
+        ++called;
+        return -5;
+    }));
+    ASSERT_EQ(1, called);
+}
+
+TEST(SyncSchedulerTest, MergeSameFile) {
+    SyncScheduler scheduler;
+    SyncSchedulerOptions options;
+    options.maxBatchSize = 64;
+    // big enough so that all requests fall into one batch
+    options.maxDelayUs = 200 * 1000;
+    options.syncfsThreshold = 0;
+    ASSERT_EQ(0, scheduler.Init(options));
+
+    std::atomic<int> syncCount(0);
+    std::atomic<int> doneCount(0);
+    int owner;
+    // 32 requests on 4 files
+    for (int i = 0; i < 32; ++i) {
+        scheduler.Submit(&owner, i % 4, [&syncCount]() {
+            syncCount.fetch_add(1);
+            return 0;
+        }, [&doneCount](int ret) {
+            ASSERT_EQ(0, ret);
+            doneCount.fetch_add(1);
+        });
+    }
+    scheduler.Fini();
+    ASSERT_EQ(32, doneCount.load());
+    ASSERT_EQ(4, syncCount.load());
+}
+
+TEST(SyncSchedulerTest, UseSyncfsForLargeBatch) {
+    SyncScheduler scheduler;
+    SyncSchedulerOptions options;
+    options.syncfsPath = ".";
+    options.maxBatchSize = 16;
+    options.maxDelayUs = 200 * 1000;
+    options.syncfsThreshold = 4;
+    ASSERT_EQ(0, scheduler.Init(options));
+
+    // 16 distinct files reach the threshold, sync funcs are not called
+    std::atomic<int> syncCount(0);
+    std::vector<std::thread> threads;
+    std::atomic<int> succeeded(0);
+    for (int i = 0; i < 16; ++i) {
+        threads.emplace_back([&, i]() {
+            int ret = scheduler.SyncAndWait(&scheduler, i, [&syncCount]() {
+                syncCount.fetch_add(1);
+                return 0;
+            });
+            if (ret == 0) {
+                succeeded.fetch_add(1);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_EQ(16, succeeded.load());
+    ASSERT_EQ(0, syncCount.load());
+    scheduler.Fini();
+}
+
+TEST(SyncSchedulerTest, ConcurrentSyncBelowThreshold) {
+    SyncScheduler scheduler;
+    SyncSchedulerOptions options;
+    options.syncfsPath = ".";
+    options.maxBatchSize = 16;
+    options.maxDelayUs = 200 * 1000;
+    // 8 distinct files don't reach the threshold
+    options.syncfsThreshold = 32;
+    options.syncConcurrency = 8;
+    ASSERT_EQ(0, scheduler.Init(options));
+
+    // each sync takes 100ms, syncing them one by one costs 800ms
+    std::atomic<int> syncCount(0);
+    std::atomic<int> doneCount(0);
+    uint64_t start = curve::common::TimeUtility::GetTimeofDayMs();
+    for (int i = 0; i < 8; ++i) {
+        scheduler.Submit(&scheduler, i, [&syncCount]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            syncCount.fetch_add(1);
+            return 0;
+        }, [&doneCount](int ret) {
+            ASSERT_EQ(0, ret);
+            doneCount.fetch_add(1);
+        });
+    }
+    scheduler.Fini();
+    uint64_t cost = curve::common::TimeUtility::GetTimeofDayMs() - start;
+    ASSERT_EQ(8, syncCount.load());
+    ASSERT_EQ(8, doneCount.load());
+    // 200ms batching delay + about 100ms concurrent sync
+    ASSERT_LT(cost, 600);
+}
+
+TEST(SyncSchedulerTest, InitFailed) {
+    SyncScheduler scheduler;
+    SyncSchedulerOptions options;
+    options.syncfsPath = "./sync_scheduler_not_exist_dir";
+    ASSERT_EQ(-1, scheduler.Init(options));
+    ASSERT_FALSE(scheduler.IsRunning());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
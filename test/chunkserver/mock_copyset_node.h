@@ -52,6 +52,11 @@ class MockCopysetNode : public CopysetNode {
     MOCK_METHOD1(GetHash, int(std::string*));
     MOCK_METHOD1(GetStatus, void(NodeStatus*));
     MOCK_METHOD1(GetLeaderStatus, bool(NodeStatus*));
+    MOCK_METHOD1(GetLeaderLeaseStatus, void(braft::LeaderLeaseStatus*));
+    MOCK_CONST_METHOD1(IsLeaseLeader, bool(const braft::LeaderLeaseStatus&));
+    MOCK_CONST_METHOD0(IsLeaseReadEnabled, bool());
+    MOCK_CONST_METHOD0(IsFollowerReadEnabled, bool());
+    MOCK_METHOD0(WaitReadIndex, bool());
     MOCK_CONST_METHOD0(GetDataStore, std::shared_ptr<CSDataStore>());
     MOCK_CONST_METHOD0(GetConcurrentApplyModule, ConcurrentApplyModule*());
     MOCK_METHOD0(GetFailedScanMap, std::vector<ScanMap>&());
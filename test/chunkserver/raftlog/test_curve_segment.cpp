@@ -32,6 +32,8 @@
 #include <memory>
 #include "src/chunkserver/raftlog/curve_segment.h"
 #include "src/chunkserver/raftlog/define.h"
+#include "src/fs/ext4_filesystem_impl.h"
+#include "src/fs/io_uring_filesystem_impl.h"
 #include "test/fs/mock_local_filesystem.h"
 #include "test/chunkserver/datastore/mock_file_pool.h"
 #include "test/chunkserver/raftlog/common.h"
@@ -40,6 +42,9 @@ namespace curve {
 namespace chunkserver {
 
 using curve::fs::MockLocalFileSystem;
+using curve::fs::Ext4FileSystemImpl;
+using curve::fs::IOUringFileSystemImpl;
+using curve::fs::LocalFileSystemOption;
 using ::testing::Return;
 using ::testing::_;
 
@@ -234,5 +239,54 @@ TEST_F(CurveSegmentTest, closed_segment) {
     delete configuration_manager;
 }
 
+TEST_F(CurveSegmentTest, batch_append) {
+    auto uringFs = std::make_shared<IOUringFileSystemImpl>(
+        Ext4FileSystemImpl::getInstance());
+    LocalFileSystemOption option;
+    option.ioUringFixedBufferCount = 4;
+    option.ioUringFixedBufferSize = kPageSize;
+    ASSERT_EQ(0, uringFs->Init(option));
+    file_pool = std::make_shared<MockFilePool>(uringFs);
+
+    EXPECT_CALL(*file_pool, GetFilePoolOpt())
+        .WillRepeatedly(Return(fp_option));
+    EXPECT_CALL(*file_pool, GetFileImpl(_, _))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*file_pool, RecycleFile(_))
+        .WillOnce(Return(0));
+    scoped_refptr<CurveSegment> seg1 =
+                new CurveSegment(kRaftLogDataDir, 1, 0, file_pool);
+
+    std::string path = kRaftLogDataDir;
+    butil::string_appendf(&path, "/" CURVE_SEGMENT_OPEN_PATTERN, 1);
+    ASSERT_EQ(0, prepare_segment(path));
+    ASSERT_EQ(0, seg1->create());
+
+    // entries are written out in one batch on sync
+    append_entries_curve_segment(seg1);
+    ASSERT_EQ(0, seg1->sync(true));
+    read_entries_curve_segment(seg1);
+
+    braft::ConfigurationManager* configuration_manager =
+                                new braft::ConfigurationManager;
+    scoped_refptr<CurveSegment> seg2 =
+                        new CurveSegment(kRaftLogDataDir, 1, 0, file_pool);
+    ASSERT_EQ(0, seg2->load(configuration_manager));
+    ASSERT_EQ(10, seg2->last_index());
+    read_entries_curve_segment(seg2);
+
+    // pending entries are flushed before truncate and close
+    append_entries_curve_segment(seg1, "hello, world: %d", 10, 15);
+    ASSERT_EQ(0, seg1->truncate(12));
+    append_entries_curve_segment(seg1, "HELLO, WORLD: %d", 12, 20);
+    ASSERT_EQ(0, seg1->close());
+    read_entries_curve_segment(seg1, "hello, world: %d", 0, 12);
+    read_entries_curve_segment(seg1, "HELLO, WORLD: %d", 12, 20);
+    ASSERT_EQ(0, seg1->unlink());
+
+    delete configuration_manager;
+    uringFs->Uninit();
+}
+
 }  // namespace chunkserver
 }  // namespace curve
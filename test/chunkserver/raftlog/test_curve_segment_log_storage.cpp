@@ -31,9 +31,12 @@
 #include <fcntl.h>
 
 #include <cstdio>
+#include <map>
 #include <memory>
 #include <string>
 #include <array>
+#include <utility>
+#include <vector>
 
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
 #include "src/chunkserver/raftlog/define.h"
@@ -337,6 +340,77 @@ TEST_F(CurveSegmentLogStorageTest, append_close_load_append) {
     delete configuration_manager;
 }
 
+TEST_F(CurveSegmentLogStorageTest, parallel_load_segments) {
+    auto storage = std::make_shared<CurveSegmentLogStorage>(kRaftLogDataDir,
+            true, file_pool);
+    braft::ConfigurationManager* configuration_manager =
+                                new braft::ConfigurationManager;
+    ASSERT_EQ(0, storage->init(configuration_manager));
+
+    std::string path = kRaftLogDataDir;
+    butil::string_appendf(&path, "/" CURVE_SEGMENT_OPEN_PATTERN, 1);
+    ASSERT_EQ(0,  prepare_segment(path));
+    path = kRaftLogDataDir;
+    butil::string_appendf(&path, "/" CURVE_SEGMENT_OPEN_PATTERN, 2049);
+    ASSERT_EQ(0,  prepare_segment(path));
+    path = kRaftLogDataDir;
+    butil::string_appendf(&path, "/" CURVE_SEGMENT_OPEN_PATTERN, 4097);
+    ASSERT_EQ(0,  prepare_segment(path));
+
+    // configurations in the first two closed segments and the open segment
+    std::map<int64_t, std::string> confs = {
+        {100, "127.0.0.1:8200:0"},
+        {1000, "127.0.0.1:8201:0"},
+        {3000, "127.0.0.1:8202:0"},
+        {4500, "127.0.0.1:8203:0"},
+    };
+    for (int64_t index = 1; index <= 5000; index++) {
+        braft::LogEntry* entry = new braft::LogEntry();
+        entry->id.term = 1;
+        entry->id.index = index;
+        auto it = confs.find(index);
+        if (it != confs.end()) {
+            entry->type = braft::ENTRY_TYPE_CONFIGURATION;
+            entry->peers = new std::vector<braft::PeerId>;
+            entry->peers->push_back(braft::PeerId(it->second));
+        } else {
+            entry->type = braft::ENTRY_TYPE_DATA;
+            entry->data.append("hello, world");
+        }
+        ASSERT_EQ(0, storage->append_entry(entry));
+        entry->Release();
+    }
+    storage = nullptr;
+    delete configuration_manager;
+
+    // reinit, closed segments are loaded concurrently
+    uint32_t concurrency = FLAGS_walSegmentLoadConcurrency;
+    FLAGS_walSegmentLoadConcurrency = 4;
+    storage = std::make_shared<CurveSegmentLogStorage>(kRaftLogDataDir,
+            true, file_pool);
+    configuration_manager = new braft::ConfigurationManager;
+    ASSERT_EQ(0, storage->init(configuration_manager));
+    FLAGS_walSegmentLoadConcurrency = concurrency;
+    ASSERT_EQ(1, storage->first_log_index());
+    ASSERT_EQ(5000, storage->last_log_index());
+
+    // configurations are added in order
+    std::vector<std::pair<int64_t, int64_t>> expects = {
+        {99, 0}, {100, 100}, {999, 100}, {1000, 1000}, {2999, 1000},
+        {3000, 3000}, {4499, 3000}, {5000, 4500},
+    };
+    for (auto& expect : expects) {
+        braft::ConfigurationEntry entry;
+        configuration_manager->get(expect.first, &entry);
+        ASSERT_EQ(expect.second, entry.id.index);
+        if (expect.second != 0) {
+            ASSERT_TRUE(entry.conf.contains(
+                braft::PeerId(confs[expect.second])));
+        }
+    }
+    delete configuration_manager;
+}
+
 TEST_F(CurveSegmentLogStorageTest, data_lost) {
     auto storage = std::make_shared<CurveSegmentLogStorage>(kRaftLogDataDir,
             true, file_pool);
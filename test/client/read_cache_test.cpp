@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/client/read_cache.h"
+
+namespace curve {
+namespace client {
+
+namespace {
+
+constexpr uint32_t kBlockSize = 4096;
+
+butil::IOBuf MakeData(uint64_t length, char c) {
+    butil::IOBuf buf;
+    buf.append(std::string(length, c));
+    return buf;
+}
+
+}  // namespace
+
+class ReadCacheTest : public ::testing::Test {
+ protected:
+    void SetUp() override {
+        ReadCacheOption option;
+        option.enable = true;
+        option.capacityMB = 1;
+        option.blockSize = kBlockSize;
+        metric_.reset(new ReadCacheMetric("read_cache_test_"));
+        cache_.reset(new ReadCache(option, metric_.get()));
+    }
+
+    std::unique_ptr<ReadCacheMetric> metric_;
+    std::unique_ptr<ReadCache> cache_;
+};
+
+TEST_F(ReadCacheTest, FillAndRead) {
+    butil::IOBuf data;
+    ASSERT_FALSE(cache_->Read(1, 0, kBlockSize, &data));
+    ASSERT_EQ(0, data.size());
+    ASSERT_EQ(1, metric_->miss.get_value());
+
+    cache_->Fill(1, 0, MakeData(2 * kBlockSize, 'a'), cache_->GetVersion(1));
+    ASSERT_EQ(2, cache_->Size());
+
+    // 读取跨block的部分数据
+    ASSERT_TRUE(cache_->Read(1, 100, kBlockSize, &data));
+    ASSERT_EQ(std::string(kBlockSize, 'a'), data.to_string());
+    ASSERT_EQ(1, metric_->hit.get_value());
+    ASSERT_EQ(kBlockSize, metric_->hitBytes.get_value());
+
+    // 其他chunk不受影响
+    data.clear();
+    ASSERT_FALSE(cache_->Read(2, 0, kBlockSize, &data));
+
+    // 有一个block不在缓存中
+    ASSERT_FALSE(cache_->Read(1, kBlockSize, 2 * kBlockSize, &data));
+    ASSERT_EQ(0, data.size());
+}
+
+TEST_F(ReadCacheTest, OnlyFillFullBlocks) {
+    // [512, 3 * 4096 + 512)只包含两个完整的block
+    cache_->Fill(1, 512, MakeData(3 * kBlockSize, 'b'),
+                 cache_->GetVersion(1));
+    ASSERT_EQ(2, cache_->Size());
+
+    butil::IOBuf data;
+    ASSERT_FALSE(cache_->Read(1, 0, kBlockSize, &data));
+    ASSERT_TRUE(cache_->Read(1, kBlockSize, 2 * kBlockSize, &data));
+    ASSERT_EQ(std::string(2 * kBlockSize, 'b'), data.to_string());
+    data.clear();
+    ASSERT_FALSE(cache_->Read(1, 3 * kBlockSize, kBlockSize, &data));
+
+    // 不足一个block的数据不缓存
+    cache_->Fill(2, 0, MakeData(kBlockSize - 1, 'c'), cache_->GetVersion(2));
+    ASSERT_EQ(2, cache_->Size());
+
+    // 不需要缓存
+    cache_->Fill(3, 0, MakeData(kBlockSize, 'd'), ReadCache::kNoFill);
+    ASSERT_EQ(2, cache_->Size());
+}
+
+TEST_F(ReadCacheTest, Invalidate) {
+    cache_->Fill(1, 0, MakeData(4 * kBlockSize, 'a'), cache_->GetVersion(1));
+    ASSERT_EQ(4, cache_->Size());
+
+    // 只失效与写重叠的block
+    cache_->Invalidate(1, kBlockSize + 1, kBlockSize);
+    ASSERT_EQ(2, cache_->Size());
+    ASSERT_EQ(1, metric_->invalidate.get_value());
+
+    butil::IOBuf data;
+    ASSERT_TRUE(cache_->Read(1, 0, kBlockSize, &data));
+    data.clear();
+    ASSERT_FALSE(cache_->Read(1, kBlockSize, kBlockSize, &data));
+    ASSERT_FALSE(cache_->Read(1, 2 * kBlockSize, kBlockSize, &data));
+    ASSERT_TRUE(cache_->Read(1, 3 * kBlockSize, kBlockSize, &data));
+}
+
+TEST_F(ReadCacheTest, StaleFillIsDropped) {
+    // 读请求下发之后，返回之前有写
+    uint64_t version = cache_->GetVersion(1);
+    cache_->Invalidate(1, 0, kBlockSize);
+    cache_->Fill(1, 0, MakeData(kBlockSize, 'a'), version);
+    ASSERT_EQ(0, cache_->Size());
+
+    butil::IOBuf data;
+    ASSERT_FALSE(cache_->Read(1, 0, kBlockSize, &data));
+
+    // 写完成之后再读可以缓存
+    cache_->Fill(1, 0, MakeData(kBlockSize, 'b'), cache_->GetVersion(1));
+    ASSERT_TRUE(cache_->Read(1, 0, kBlockSize, &data));
+    ASSERT_EQ(std::string(kBlockSize, 'b'), data.to_string());
+}
+
+TEST_F(ReadCacheTest, CapacityLimit) {
+    // 1MB的容量，最多缓存256个4KB的block
+    for (ChunkID id = 0; id < 512; ++id) {
+        cache_->Fill(id, 0, MakeData(kBlockSize, 'a'), cache_->GetVersion(id));
+    }
+    ASSERT_LE(cache_->Size(), 256);
+    ASSERT_GT(cache_->Size(), 0);
+}
+
+}  // namespace client
+}  // namespace curve
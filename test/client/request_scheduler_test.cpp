@@ -567,6 +567,103 @@ TEST(RequestSchedulerTest, fake_server_test) {
     ASSERT_EQ(0, server.Join());
 }
 
+TEST(RequestSchedulerTest, WriteCoalesceTest) {
+    const uint64_t len = 16;
+    const uint64_t kWriteNum = 6;
+
+    RequestScheduleOption opt;
+    opt.scheduleQueueCapacity = 4096;
+    opt.scheduleThreadpoolSize = 1;
+    opt.writeCoalesceMaxBytes = 4 * len;
+    opt.writeCoalesceWindowUs = 200 * 1000;
+    opt.ioSenderOpt.failRequestOpt.chunkserverRPCTimeoutMS = 200;
+    opt.ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry = 5;
+    opt.ioSenderOpt.failRequestOpt.chunkserverOPRetryIntervalUS = 5000;
+    opt.ioSenderOpt.chunkserverEnableAppliedIndexRead = 1;
+
+    brpc::Server server;
+    std::string listenAddr = "127.0.0.1:9109";
+    FakeChunkServiceImpl fakeChunkService;
+    ASSERT_EQ(server.AddService(&fakeChunkService,
+                                brpc::SERVER_DOESNT_OWN_SERVICE), 0);
+    brpc::ServerOptions option;
+    option.idle_timeout_sec = -1;
+    ASSERT_EQ(server.Start(listenAddr.c_str(), &option), 0);
+
+    RequestScheduler requestScheduler;
+    MockMetaCache mockMetaCache;
+    mockMetaCache.DelegateToFake();
+    EXPECT_CALL(mockMetaCache, GetLeader(_, _, _, _, _, _)).Times(AnyNumber());
+
+    FileMetric fm("coalesce_test");
+    IOTracker iot(nullptr, nullptr, nullptr, &fm);
+    ASSERT_EQ(0, requestScheduler.Init(opt, &mockMetaCache, &fm));
+    ASSERT_EQ(0, requestScheduler.Run());
+
+    ChunkIDInfo idinfo(1, 1, 100001);
+    std::string expect;
+
+    // contiguous writes are merged up to writeCoalesceMaxBytes
+    {
+        curve::common::CountDownEvent cond(kWriteNum);
+        std::vector<RequestContext *> reqCtxs;
+        std::vector<RequestClosure *> reqDones;
+        for (uint64_t i = 0; i < kWriteNum; ++i) {
+            RequestContext *reqCtx = new FakeRequestContext();
+            reqCtx->optype_ = OpType::WRITE;
+            reqCtx->idinfo_ = idinfo;
+            std::string data(len, 'a' + i);
+            expect += data;
+            reqCtx->writeData_.append(data);
+            reqCtx->offset_ = i * len;
+            reqCtx->rawlength_ = len;
+
+            RequestClosure *reqDone = new FakeRequestClosure(&cond, reqCtx);
+            reqDone->SetFileMetric(&fm);
+            reqDone->SetIOTracker(&iot);
+            reqCtx->done_ = reqDone;
+            reqCtxs.push_back(reqCtx);
+            reqDones.push_back(reqDone);
+        }
+        ASSERT_EQ(0, requestScheduler.ScheduleRequest(reqCtxs));
+        cond.Wait();
+
+        for (uint64_t i = 0; i < kWriteNum; ++i) {
+            ASSERT_EQ(0, reqDones[i]->GetErrorCode());
+            delete reqDones[i];
+            delete reqCtxs[i];
+        }
+        ASSERT_EQ(kWriteNum, fm.writeCoalesceMetric.requests.get_value());
+        ASSERT_EQ(2u, fm.writeCoalesceMetric.rpcs.get_value());
+        ASSERT_DOUBLE_EQ(3.0, fm.writeCoalesceMetric.mergeRatio.get_value());
+    }
+
+    // merged data is written in order
+    {
+        RequestContext *reqCtx = new FakeRequestContext();
+        reqCtx->optype_ = OpType::READ;
+        reqCtx->idinfo_ = idinfo;
+        reqCtx->offset_ = 0;
+        reqCtx->rawlength_ = kWriteNum * len;
+
+        curve::common::CountDownEvent cond(1);
+        RequestClosure *reqDone = new FakeRequestClosure(&cond, reqCtx);
+        reqDone->SetFileMetric(&fm);
+        reqDone->SetIOTracker(&iot);
+        reqCtx->done_ = reqDone;
+        ASSERT_EQ(0, requestScheduler.ScheduleRequest(reqCtx));
+        cond.Wait();
+        ASSERT_EQ(0, reqDone->GetErrorCode());
+        ASSERT_EQ(expect, reqCtx->readData_.to_string());
+        delete reqDone;
+        delete reqCtx;
+    }
+
+    requestScheduler.Fini();
+    ASSERT_EQ(0, server.Stop(0));
+    ASSERT_EQ(0, server.Join());
+}
+
 TEST(RequestSchedulerTest, CommonTest) {
     RequestScheduleOption opt;
     opt.scheduleQueueCapacity = 4096;
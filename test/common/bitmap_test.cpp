@@ -22,6 +22,9 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+#include <vector>
+
 #include "src/common/bitmap.h"
 
 namespace curve {
@@ -415,5 +418,93 @@ TEST(BitmapTEST, divide_test) {
     }
 }
 
+TEST(BitmapTEST, count_test) {
+    Bitmap bitmap(200);
+    ASSERT_EQ(0, bitmap.Count(0, 199));
+
+    bitmap.Set(3, 70);
+    bitmap.Set(130);
+    ASSERT_EQ(69, bitmap.Count(0, 199));
+    ASSERT_EQ(68, bitmap.Count(4, 130));
+    ASSERT_EQ(1, bitmap.Count(64, 64));
+    ASSERT_EQ(0, bitmap.Count(71, 129));
+    // 超过范围的部分会被忽略
+    ASSERT_EQ(1, bitmap.Count(100, 1000));
+    ASSERT_EQ(0, bitmap.Count(300, 1000));
+    ASSERT_EQ(0, bitmap.Count(10, 5));
+
+    bitmap.Set();
+    ASSERT_EQ(200, bitmap.Count(0, Bitmap::NO_POS));
+}
+
+// 与逐位实现对比，覆盖跨字节、跨字以及跨32字节块的各种边界
+TEST(BitmapTEST, word_scan_compare_test) {
+    const uint32_t bits = 64 * 1024 + 37;
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<uint32_t> dist(0, bits - 1);
+
+    Bitmap bitmap(bits);
+    std::vector<bool> expect(bits, false);
+    for (int round = 0; round < 2000; ++round) {
+        uint32_t start = dist(rng);
+        // 大部分是短区间，偶尔出现很长的区间
+        uint32_t len = round % 10 == 0 ? dist(rng) : dist(rng) % 300;
+        uint32_t end = start + len;
+        bool set = rng() % 2;
+        if (set) {
+            bitmap.Set(start, end);
+        } else {
+            bitmap.Clear(start, end);
+        }
+        for (uint32_t i = start; i <= end && i < bits; ++i) {
+            expect[i] = set;
+        }
+
+        uint32_t from = dist(rng);
+        uint32_t to = from + dist(rng) % 4096;
+        uint32_t last = to < bits ? to : bits - 1;
+        uint32_t nextSet = Bitmap::NO_POS;
+        uint32_t nextClear = Bitmap::NO_POS;
+        uint32_t count = 0;
+        for (uint32_t i = from; i <= last; ++i) {
+            if (expect[i]) {
+                ++count;
+                if (nextSet == Bitmap::NO_POS)
+                    nextSet = i;
+            } else if (nextClear == Bitmap::NO_POS) {
+                nextClear = i;
+            }
+        }
+        ASSERT_EQ(nextSet, bitmap.NextSetBit(from, to));
+        ASSERT_EQ(nextClear, bitmap.NextClearBit(from, to));
+        ASSERT_EQ(count, bitmap.Count(from, to));
+    }
+
+    for (uint32_t i = 0; i < bits; ++i) {
+        ASSERT_EQ(expect[i], bitmap.Test(i));
+    }
+    uint32_t firstSet = Bitmap::NO_POS;
+    uint32_t firstClear = Bitmap::NO_POS;
+    for (uint32_t i = 0; i < bits; ++i) {
+        if (expect[i] && firstSet == Bitmap::NO_POS)
+            firstSet = i;
+        if (!expect[i] && firstClear == Bitmap::NO_POS)
+            firstClear = i;
+    }
+    ASSERT_EQ(firstSet, bitmap.NextSetBit(0));
+    ASSERT_EQ(firstClear, bitmap.NextClearBit(0));
+
+    // 长距离扫描
+    bitmap.Clear();
+    bitmap.Set(bits - 1);
+    ASSERT_EQ(bits - 1, bitmap.NextSetBit(1));
+    ASSERT_EQ(Bitmap::NO_POS, bitmap.NextSetBit(0, bits - 2));
+    bitmap.Set();
+    bitmap.Clear(bits - 1);
+    ASSERT_EQ(bits - 1, bitmap.NextClearBit(1));
+    ASSERT_EQ(Bitmap::NO_POS, bitmap.NextClearBit(0, bits - 2));
+    ASSERT_EQ(Bitmap::NO_POS, bitmap.NextClearBit(bits));
+}
+
 }  // namespace common
 }  // namespace curve
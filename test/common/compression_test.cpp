@@ -0,0 +1,180 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <string>
+
+#include "src/common/compression.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+std::string CompressibleData(size_t len) {
+    std::string data;
+    data.reserve(len);
+    while (data.size() < len) {
+        data.append("curve chunk data ");
+        data.append(std::to_string(data.size() % 97));
+    }
+    data.resize(len);
+    return data;
+}
+
+std::string RandomData(size_t len) {
+    std::string data(len, 0);
+    unsigned int seed = 1;
+    for (auto& c : data) {
+        c = static_cast<char>(rand_r(&seed));
+    }
+    return data;
+}
+
+}  // namespace
+
+TEST(CompressionTest, TypeStringTest) {
+    CompressionType type;
+    ASSERT_TRUE(StringToCompressionType("none", &type));
+    ASSERT_EQ(CompressionType::kNone, type);
+    ASSERT_TRUE(StringToCompressionType("lz4", &type));
+    ASSERT_EQ(CompressionType::kLZ4, type);
+    ASSERT_TRUE(StringToCompressionType("zlib", &type));
+    ASSERT_EQ(CompressionType::kZlib, type);
+    ASSERT_FALSE(StringToCompressionType("snappy", &type));
+
+    ASSERT_STREQ("lz4", CompressionTypeToString(CompressionType::kLZ4));
+    ASSERT_STREQ("zlib", CompressionTypeToString(CompressionType::kZlib));
+}
+
+TEST(CompressionTest, IsAllZeroTest) {
+    std::string data(4099, 0);
+    ASSERT_TRUE(IsAllZero(data.data(), data.size()));
+    ASSERT_TRUE(IsAllZero(data.data(), 0));
+    data[4098] = 1;
+    ASSERT_FALSE(IsAllZero(data.data(), data.size()));
+    data[4098] = 0;
+    data[8] = 1;
+    ASSERT_FALSE(IsAllZero(data.data(), data.size()));
+}
+
+TEST(CompressionTest, RoundTripTest) {
+    const CompressionType types[] = {CompressionType::kNone,
+                                     CompressionType::kLZ4,
+                                     CompressionType::kZlib};
+    // cover empty data, a partial frame and multiple frames
+    const size_t sizes[] = {0, 1, 4096, kCompressionFrameSize + 100,
+                            3 * kCompressionFrameSize};
+
+    for (auto type : types) {
+        for (auto size : sizes) {
+            std::string data = CompressibleData(size);
+            std::string compressed;
+            CompressData(type, data.data(), data.size(), &compressed);
+            if (type != CompressionType::kNone && size >= 4096) {
+                ASSERT_LT(compressed.size(), data.size());
+            }
+
+            std::string out;
+            ASSERT_TRUE(
+                DecompressData(compressed.data(), compressed.size(), &out));
+            ASSERT_EQ(data, out);
+        }
+    }
+}
+
+TEST(CompressionTest, IncompressibleTest) {
+    std::string data = RandomData(64 * 1024);
+    std::string compressed;
+    CompressData(CompressionType::kLZ4, data.data(), data.size(),
+                 &compressed);
+    // stored as is
+    ASSERT_EQ(data.size() + kCompressionFrameHeaderSize, compressed.size());
+
+    std::string out;
+    ASSERT_TRUE(DecompressData(compressed.data(), compressed.size(), &out));
+    ASSERT_EQ(data, out);
+}
+
+TEST(CompressionTest, ZeroFrameTest) {
+    std::string data(2 * kCompressionFrameSize, 0);
+    data.append(CompressibleData(4096));
+    std::string compressed;
+    CompressData(CompressionType::kZlib, data.data(), data.size(),
+                 &compressed);
+    // zero frames only have a header
+    ASSERT_LT(compressed.size(), 3 * kCompressionFrameHeaderSize + 4096);
+
+    std::string out;
+    ASSERT_TRUE(DecompressData(compressed.data(), compressed.size(), &out));
+    ASSERT_EQ(data, out);
+}
+
+TEST(CompressionTest, ConcatenateTest) {
+    // parts of a multipart upload are compressed separately
+    std::string part1 = CompressibleData(8192);
+    std::string part2 = RandomData(4096);
+    std::string compressed;
+    CompressData(CompressionType::kLZ4, part1.data(), part1.size(),
+                 &compressed);
+    CompressData(CompressionType::kZlib, part2.data(), part2.size(),
+                 &compressed);
+
+    std::string out;
+    ASSERT_TRUE(DecompressData(compressed.data(), compressed.size(), &out));
+    ASSERT_EQ(part1 + part2, out);
+}
+
+TEST(CompressionTest, CorruptedTest) {
+    std::string data = CompressibleData(8192);
+    std::string compressed;
+    CompressData(CompressionType::kLZ4, data.data(), data.size(),
+                 &compressed);
+
+    std::string out;
+    // truncated
+    ASSERT_FALSE(
+        DecompressData(compressed.data(), compressed.size() - 1, &out));
+    ASSERT_FALSE(DecompressData(compressed.data(),
+                                kCompressionFrameHeaderSize - 1, &out));
+
+    // bad magic
+    std::string badMagic = compressed;
+    badMagic[0] ^= 0xff;
+    out.clear();
+    ASSERT_FALSE(DecompressData(badMagic.data(), badMagic.size(), &out));
+
+    // payload bit flip is caught by decoder or crc
+    std::string badPayload = compressed;
+    badPayload[badPayload.size() - 1] ^= 0x01;
+    out.clear();
+    ASSERT_FALSE(DecompressData(badPayload.data(), badPayload.size(), &out));
+
+    // not compressed at all
+    out.clear();
+    ASSERT_FALSE(DecompressData(data.data(), data.size(), &out));
+}
+
+}  // namespace common
+}  // namespace curve
@@ -23,6 +23,9 @@
 #include <gtest/gtest.h>
 #include <glog/logging.h>
 
+#include <thread>  // NOLINT
+#include <vector>
+
 #include "src/common/lru_cache.h"
 #include "src/common/timeutility.h"
 
@@ -301,6 +304,131 @@ TEST(SglCaCheTest, TestCacheHitAndMissMetric) {
     ASSERT_EQ(10, cache->GetCacheMetrics()->cacheMiss.get_value());
 }
 
+TEST(ClockCacheTest, test_cache_with_capacity_limit) {
+    int maxCount = 5;
+    auto cache = std::make_shared<ClockCache<std::string, std::string>>(
+        maxCount, std::make_shared<CacheMetrics>("ClockCache"));
+
+    std::string eliminated;
+    std::string res;
+    for (int i = 1; i <= maxCount; i++) {
+        ASSERT_FALSE(cache->Put(std::to_string(i), std::to_string(i),
+                                &eliminated));
+    }
+    ASSERT_EQ(maxCount, cache->Size());
+    ASSERT_EQ(maxCount, cache->GetCacheMetrics()->cacheCount.get_value());
+
+    // 1、3被访问过，有第二次机会，淘汰未被访问的2
+    ASSERT_TRUE(cache->Get("1", &res));
+    ASSERT_TRUE(cache->Get("3", &res));
+    ASSERT_TRUE(cache->Put("6", "6", &eliminated));
+    ASSERT_EQ("2", eliminated);
+    ASSERT_FALSE(cache->Get("2", &res));
+    ASSERT_TRUE(cache->Get("1", &res));
+    ASSERT_EQ("1", res);
+
+    // 下一个被淘汰的是4
+    ASSERT_TRUE(cache->Put("7", "7", &eliminated));
+    ASSERT_EQ("4", eliminated);
+    ASSERT_EQ(maxCount, cache->Size());
+
+    // 重复put和删除
+    cache->Put("6", "hello");
+    ASSERT_TRUE(cache->Get("6", &res));
+    ASSERT_EQ("hello", res);
+    ASSERT_EQ(maxCount, cache->Size());
+    cache->Remove("6");
+    ASSERT_FALSE(cache->Get("6", &res));
+    ASSERT_EQ(maxCount - 1, cache->Size());
+    ASSERT_EQ(maxCount - 1,
+              cache->GetCacheMetrics()->cacheCount.get_value());
+    ASSERT_FALSE(cache->Put("8", "8", &eliminated));
+    ASSERT_EQ(maxCount, cache->Size());
+
+    // 所有元素都被访问过时，淘汰一轮之后的第一个元素
+    for (auto key : {"1", "3", "5", "7", "8"}) {
+        ASSERT_TRUE(cache->Get(key, &res));
+    }
+    ASSERT_TRUE(cache->Put("9", "9", &eliminated));
+    ASSERT_EQ(maxCount, cache->Size());
+    ASSERT_EQ(maxCount, cache->GetCacheMetrics()->cacheCount.get_value());
+}
+
+TEST(ClockCacheTest, test_cache_with_capacity_no_limit) {
+    auto cache = std::make_shared<ClockCache<int, int>>(0);
+    int res;
+    int eliminated;
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_FALSE(cache->Put(i, i, &eliminated));
+    }
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(cache->Get(i, &res));
+        ASSERT_EQ(i, res);
+    }
+    ASSERT_EQ(1000, cache->Size());
+}
+
+TEST(ShardedLRUCacheTest, test_basic) {
+    for (auto policy : {CacheEvictPolicy::LRU, CacheEvictPolicy::CLOCK}) {
+        auto metric = std::make_shared<CacheMetrics>("ShardedLRUCache");
+        ShardedLRUCache<uint64_t, std::string> cache(64, 8, policy, metric);
+        ASSERT_EQ(8, cache.ShardNum());
+
+        std::string res;
+        std::string eliminated;
+        int eliminatedCount = 0;
+        for (uint64_t i = 0; i < 128; i++) {
+            if (cache.Put(i, std::to_string(i), &eliminated)) {
+                eliminatedCount++;
+            }
+        }
+        // 每个shard容量为8，总容量不超过64
+        ASSERT_EQ(64, cache.Size());
+        ASSERT_EQ(64, eliminatedCount);
+        ASSERT_EQ(64, metric->cacheCount.get_value());
+        ASSERT_TRUE(cache.Get(127, &res));
+        ASSERT_EQ("127", res);
+
+        cache.Remove(127);
+        ASSERT_FALSE(cache.Get(127, &res));
+        ASSERT_EQ(63, cache.Size());
+    }
+
+    // 容量为0表示不限制
+    ShardedLRUCache<std::string, int> cache(0, 4);
+    for (int i = 0; i < 100; i++) {
+        cache.Put(std::to_string(i), i);
+    }
+    ASSERT_EQ(100, cache.Size());
+}
+
+TEST(ShardedLRUCacheTest, test_concurrent) {
+    for (auto policy : {CacheEvictPolicy::LRU, CacheEvictPolicy::CLOCK}) {
+        ShardedLRUCache<uint64_t, uint64_t> cache(1000, 16, policy);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; t++) {
+            threads.emplace_back([&cache, t]() {
+                uint64_t res;
+                for (uint64_t i = 0; i < 10000; i++) {
+                    uint64_t key = (i * 7 + t) % 2000;
+                    if (cache.Get(key, &res)) {
+                        ASSERT_EQ(key, res);
+                    } else {
+                        cache.Put(key, key);
+                    }
+                    if (i % 100 == 0) {
+                        cache.Remove(key);
+                    }
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+        ASSERT_LE(cache.Size(), 1008);
+    }
+}
+
 }  // namespace common
 }  // namespace curve
 
@@ -0,0 +1,166 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/mpsc_queue.h"
+
+namespace curve {
+namespace common {
+
+TEST(InlineTaskTest, InlineAndHeapStorage) {
+    int counter = 0;
+
+    InlineTask small([&counter]() { counter += 1; });
+    ASSERT_TRUE(static_cast<bool>(small));
+    small();
+    ASSERT_EQ(1, counter);
+
+    // capture more than kInlineSize bytes to force heap storage
+    struct Big {
+        char pad[InlineTask::kInlineSize * 2];
+    } big;
+    InlineTask large([&counter, big]() { counter += 10; });
+    large();
+    ASSERT_EQ(11, counter);
+
+    InlineTask moved(std::move(large));
+    ASSERT_FALSE(static_cast<bool>(large));
+    moved();
+    ASSERT_EQ(21, counter);
+
+    auto ptr = std::make_shared<int>(0);
+    {
+        InlineTask holder([ptr]() { ++*ptr; });
+        ASSERT_EQ(2, ptr.use_count());
+        holder = InlineTask();
+        ASSERT_EQ(1, ptr.use_count());
+    }
+}
+
+TEST(MPSCTaskQueueTest, CapacityRoundUp) {
+    MPSCTaskQueue q1(1);
+    ASSERT_EQ(2, q1.Capacity());
+    MPSCTaskQueue::Task t1([]() {});
+    MPSCTaskQueue::Task t2([]() {});
+    MPSCTaskQueue::Task t3([]() {});
+    ASSERT_TRUE(q1.TryPush(&t1));
+    ASSERT_TRUE(q1.TryPush(&t2));
+    ASSERT_FALSE(q1.TryPush(&t3));
+    MPSCTaskQueue q2(5);
+    ASSERT_EQ(8, q2.Capacity());
+    MPSCTaskQueue q3(64);
+    ASSERT_EQ(64, q3.Capacity());
+}
+
+TEST(MPSCTaskQueueTest, TryPushTryPop) {
+    MPSCTaskQueue queue(4);
+    int value = 0;
+
+    for (int i = 0; i < 4; ++i) {
+        MPSCTaskQueue::Task task([&value, i]() { value = value * 10 + i; });
+        ASSERT_TRUE(queue.TryPush(&task));
+    }
+    ASSERT_EQ(4, queue.Size());
+
+    MPSCTaskQueue::Task extra([]() {});
+    ASSERT_FALSE(queue.TryPush(&extra));
+    ASSERT_TRUE(static_cast<bool>(extra));
+
+    MPSCTaskQueue::Task task;
+    while (queue.TryPop(&task)) {
+        task();
+    }
+    ASSERT_EQ(123, value);
+    ASSERT_EQ(0, queue.Size());
+    ASSERT_FALSE(queue.TryPop(&task));
+}
+
+TEST(MPSCTaskQueueTest, PushWithArgs) {
+    MPSCTaskQueue queue(2);
+    int result = 0;
+    auto add = [&result](int a, int b) { result = a + b; };
+    queue.Push(add, 1, 2);
+    queue.Pop()();
+    ASSERT_EQ(3, result);
+}
+
+TEST(MPSCTaskQueueTest, MultiProducer) {
+    const int kProducers = 8;
+    const int kTasksPerProducer = 100000;
+    MPSCTaskQueue queue(16);
+
+    std::atomic<uint64_t> sum(0);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, &sum, kTasksPerProducer]() {
+            for (int i = 1; i <= kTasksPerProducer; ++i) {
+                queue.Push([&sum, i]() { sum.fetch_add(i); });
+            }
+        });
+    }
+
+    for (int i = 0; i < kProducers * kTasksPerProducer; ++i) {
+        queue.Pop()();
+        // let the consumer park from time to time
+        if (i % 50000 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    for (auto& t : producers) {
+        t.join();
+    }
+
+    uint64_t expected = static_cast<uint64_t>(kTasksPerProducer) *
+                        (kTasksPerProducer + 1) / 2 * kProducers;
+    ASSERT_EQ(expected, sum.load());
+    ASSERT_EQ(0, queue.Size());
+}
+
+TEST(MPSCTaskQueueTest, ConsumerParkAndWakeup) {
+    MPSCTaskQueue queue(4);
+    std::atomic<int> done(0);
+
+    std::thread consumer([&queue, &done]() {
+        for (int i = 0; i < 10; ++i) {
+            queue.Pop()();
+        }
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        // make sure consumer goes to the parking path
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        queue.Push([&done]() { done.fetch_add(1); });
+    }
+
+    consumer.join();
+    ASSERT_EQ(10, done.load());
+}
+
+}  // namespace common
+}  // namespace curve
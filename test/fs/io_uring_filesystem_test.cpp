@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-17
+ * Author: curve
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/fs/ext4_filesystem_impl.h"
+#include "src/fs/io_uring_filesystem_impl.h"
+#include "src/fs/wrap_posix.h"
+
+namespace curve {
+namespace fs {
+
+const char kTestFile[] = "./io_uring_filesystem_test.data";
+const int kBlockSize = 4096;
+const int kBlockCount = 16;
+
+class IOUringFileSystemTest : public testing::Test {
+ public:
+    void SetUp() {
+        // other cases in this binary may leave a mock wrapper in the ext4 fs
+        base = Ext4FileSystemImpl::getInstance();
+        base->SetPosixWrapper(std::make_shared<PosixWrapper>());
+        lfs = std::make_shared<IOUringFileSystemImpl>(base);
+
+        LocalFileSystemOption option;
+        option.ioUringQueueDepth = 8;
+        option.ioUringFixedBufferCount = 4;
+        option.ioUringFixedBufferSize = kBlockSize;
+        ASSERT_EQ(0, lfs->Init(option));
+
+        fd = lfs->Open(kTestFile, O_RDWR | O_CREAT);
+        ASSERT_GE(fd, 0);
+    }
+
+    void TearDown() {
+        lfs->Close(fd);
+        lfs->Delete(kTestFile);
+        lfs->Uninit();
+    }
+
+ protected:
+    std::shared_ptr<Ext4FileSystemImpl> base;
+    std::shared_ptr<IOUringFileSystemImpl> lfs;
+    int fd;
+};
+
+TEST_F(IOUringFileSystemTest, BatchWriteAndRead) {
+    // mix registered buffers and ordinary memory, and exceed the queue depth
+    std::vector<char*> bufs;
+    std::vector<AioRequest> writes;
+    for (int i = 0; i < kBlockCount; ++i) {
+        char* buf = lfs->AllocIOBuffer(kBlockSize);
+        ASSERT_NE(nullptr, buf);
+        memset(buf, 'a' + i, kBlockSize);
+        bufs.push_back(buf);
+        writes.emplace_back(AioOpType::WRITE, fd, buf,
+                            static_cast<uint64_t>(i) * kBlockSize, kBlockSize);
+    }
+    writes.emplace_back(AioOpType::SYNC, fd, nullptr, 0, 0);
+    ASSERT_EQ(0, lfs->SubmitBatch(&writes));
+    for (auto& req : writes) {
+        ASSERT_EQ(req.length, req.result);
+    }
+
+    std::vector<AioRequest> reads;
+    for (int i = 0; i < kBlockCount; ++i) {
+        memset(bufs[i], 0, kBlockSize);
+        reads.emplace_back(AioOpType::READ, fd, bufs[i],
+                           static_cast<uint64_t>(i) * kBlockSize, kBlockSize);
+    }
+    ASSERT_EQ(0, lfs->SubmitBatch(&reads));
+    for (int i = 0; i < kBlockCount; ++i) {
+        ASSERT_EQ(kBlockSize, reads[i].result);
+        ASSERT_EQ(std::string(kBlockSize, 'a' + i),
+                  std::string(bufs[i], kBlockSize));
+    }
+
+    // data written in batch is visible to the synchronous path
+    char block[kBlockSize];
+    ASSERT_EQ(kBlockSize, lfs->Read(fd, block, 3 * kBlockSize, kBlockSize));
+    ASSERT_EQ(std::string(kBlockSize, 'd'), std::string(block, kBlockSize));
+
+    for (auto buf : bufs) {
+        lfs->FreeIOBuffer(buf);
+    }
+}
+
+TEST_F(IOUringFileSystemTest, ShortReadAndError) {
+    char buf[kBlockSize];
+    memset(buf, 'x', kBlockSize);
+    ASSERT_EQ(kBlockSize, lfs->Write(fd, buf, 0, kBlockSize));
+
+    std::vector<AioRequest> reqs;
+    // read beyond the end of file returns what's available
+    reqs.emplace_back(AioOpType::READ, fd, buf, kBlockSize / 2, kBlockSize);
+    reqs.emplace_back(AioOpType::READ, -1, buf, 0, kBlockSize);
+    ASSERT_EQ(-EBADF, lfs->SubmitBatch(&reqs));
+    ASSERT_EQ(kBlockSize / 2, reqs[0].result);
+    ASSERT_EQ(-EBADF, reqs[1].result);
+}
+
+TEST_F(IOUringFileSystemTest, FallbackAfterUninit) {
+    lfs->Uninit();
+    ASSERT_FALSE(lfs->SupportAsyncIO());
+
+    char buf[kBlockSize];
+    memset(buf, 'y', kBlockSize);
+    std::vector<AioRequest> reqs;
+    reqs.emplace_back(AioOpType::WRITE, fd, buf, 0, kBlockSize);
+    reqs.emplace_back(AioOpType::SYNC, fd, nullptr, 0, 0);
+    ASSERT_EQ(0, lfs->SubmitBatch(&reqs));
+    ASSERT_EQ(kBlockSize, reqs[0].result);
+    ASSERT_EQ(0, reqs[1].result);
+}
+
+}  // namespace fs
+}  // namespace curve
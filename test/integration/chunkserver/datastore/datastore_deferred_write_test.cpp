@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2022 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2022-10-18
+ * Author: curve
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "test/integration/chunkserver/datastore/datastore_integration_base.h"
+
+namespace curve {
+namespace chunkserver {
+
+const string baseDir = "./data_int_defer";    // NOLINT
+const string poolDir = "./chunkfilepool_int_defer";  // NOLINT
+const string poolMetaPath = "./chunkfilepool_int_defer.meta";  // NOLINT
+
+const uint32_t kDeferredWriteMinSize = 16 * PAGE_SIZE;
+
+class DeferredWriteTestSuit : public DatastoreIntegrationBase {
+ public:
+    DeferredWriteTestSuit() {}
+    ~DeferredWriteTestSuit() {}
+
+    void SetUp() override {
+        DatastoreIntegrationBase::SetUp();
+        DataStoreOptions options;
+        options.baseDir = baseDir;
+        options.chunkSize = CHUNK_SIZE;
+        options.pageSize = PAGE_SIZE;
+        options.deferredWriteMinSize = kDeferredWriteMinSize;
+        options.deferredWriteMaxBytes = 64 * kDeferredWriteMinSize;
+        // the raft log holding the data of the writes
+        options.deferredWriteReader = [this](uint64_t index,
+                                             butil::IOBuf* data) {
+            auto iter = log_.find(index);
+            if (iter == log_.end()) {
+                return false;
+            }
+            *data = iter->second;
+            return true;
+        };
+        dataStore_ = std::make_shared<CSDataStore>(lfs_,
+                                                   filePool_,
+                                                   options);
+        ASSERT_TRUE(dataStore_->Initialize());
+    }
+
+    CSErrorCode Write(ChunkID id, SequenceNum sn, char c,
+                      off_t offset, size_t length) {
+        butil::IOBuf data;
+        data.resize(length, c);
+        log_[++lastIndex_] = data;
+        return dataStore_->WriteLoggedChunk(id, sn, data, offset, length,
+                                            lastIndex_, nullptr);
+    }
+
+    // read the chunk file directly, bypass the deferred writes
+    std::string ReadFile(ChunkID id, off_t offset, size_t length) {
+        std::string chunkPath = baseDir + "/" +
+            FileNameOperator::GenerateChunkFileName(id);
+        std::string buf(length, 0);
+        int fd = lfs_->Open(chunkPath, O_RDWR);
+        EXPECT_GE(fd, 0);
+        EXPECT_EQ(length,
+                  lfs_->Read(fd, &buf[0], PAGE_SIZE + offset, length));
+        lfs_->Close(fd);
+        return buf;
+    }
+
+    std::string ReadChunk(ChunkID id, SequenceNum sn,
+                          off_t offset, size_t length) {
+        std::string buf(length, 0);
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore_->ReadChunk(id, sn, &buf[0], offset, length));
+        return buf;
+    }
+
+ protected:
+    std::map<uint64_t, butil::IOBuf> log_;
+    uint64_t lastIndex_ = 0;
+};
+
+TEST_F(DeferredWriteTestSuit, DeferAndMergeTest) {
+    ChunkID id = 1;
+    SequenceNum sn = 1;
+    size_t length = kDeferredWriteMinSize;
+
+    // the write creating the chunk is not deferred
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'a', 0, length));
+    ASSERT_EQ(std::string(length, 'a'), ReadFile(id, 0, length));
+
+    // small or unaligned writes are not deferred
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'b', 0, PAGE_SIZE));
+    ASSERT_EQ(std::string(PAGE_SIZE, 'b'), ReadFile(id, 0, PAGE_SIZE));
+
+    // large aligned overwrite is deferred, only its log index is kept
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'c', 0, length));
+    ASSERT_EQ(std::string(PAGE_SIZE, 'b'), ReadFile(id, 0, PAGE_SIZE));
+
+    // read merges the deferred writes first
+    ASSERT_EQ(std::string(length, 'c'), ReadChunk(id, sn, 0, length));
+    ASSERT_EQ(std::string(length, 'c'), ReadFile(id, 0, length));
+
+    // merged chunk needs to be synced
+    std::vector<ChunkID> merged;
+    dataStore_->TakeMergedChunks(&merged);
+    ASSERT_EQ(std::vector<ChunkID>{id}, merged);
+    merged.clear();
+    dataStore_->TakeMergedChunks(&merged);
+    ASSERT_TRUE(merged.empty());
+
+    // flush merges all chunks
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'd', length, length));
+    ASSERT_EQ(CSErrorCode::Success, dataStore_->FlushDeferredWrites());
+    ASSERT_EQ(std::string(length, 'd'), ReadFile(id, length, length));
+}
+
+TEST_F(DeferredWriteTestSuit, OverwriteTest) {
+    ChunkID id = 1;
+    SequenceNum sn = 1;
+    size_t length = kDeferredWriteMinSize;
+
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'a', 0, PAGE_SIZE));
+
+    // the later write covers the former one, which is never read back
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'b', 0, length));
+    log_.erase(lastIndex_);
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'c', 0, 2 * length));
+    // partial overlap keeps the order
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'd', length, 2 * length));
+    // adjacent write
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'e', 3 * length, length));
+
+    std::string expect = std::string(length, 'c') +
+                         std::string(2 * length, 'd') +
+                         std::string(length, 'e');
+    ASSERT_EQ(expect, ReadChunk(id, sn, 0, 4 * length));
+    ASSERT_EQ(expect, ReadFile(id, 0, 4 * length));
+}
+
+TEST_F(DeferredWriteTestSuit, SnapshotTest) {
+    ChunkID id = 1;
+    size_t length = kDeferredWriteMinSize;
+
+    ASSERT_EQ(CSErrorCode::Success, Write(id, 1, 'a', 0, PAGE_SIZE));
+    ASSERT_EQ(CSErrorCode::Success, Write(id, 1, 'b', 0, length));
+
+    // write with a new sn merges the deferred writes and creates snapshot
+    ASSERT_EQ(CSErrorCode::Success, Write(id, 2, 'c', 0, PAGE_SIZE));
+    // not deferred while the snapshot exists
+    ASSERT_EQ(CSErrorCode::Success, Write(id, 2, 'd', 0, length));
+    ASSERT_EQ(std::string(length, 'd'), ReadFile(id, 0, length));
+
+    std::string buf(length, 0);
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->ReadSnapshotChunk(id, 1, &buf[0], 0, length));
+    ASSERT_EQ(std::string(length, 'b'), buf);
+
+    // deferred again after the snapshot is deleted
+    ASSERT_EQ(CSErrorCode::Success,
+              dataStore_->DeleteSnapshotChunkOrCorrectSn(id, 2));
+    ASSERT_EQ(CSErrorCode::Success, Write(id, 2, 'e', 0, length));
+    ASSERT_EQ(std::string(length, 'd'), ReadFile(id, 0, length));
+    ASSERT_EQ(std::string(length, 'e'), ReadChunk(id, 2, 0, length));
+}
+
+TEST_F(DeferredWriteTestSuit, RestartTest) {
+    ChunkID id = 1;
+    SequenceNum sn = 1;
+    size_t length = kDeferredWriteMinSize;
+
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'a', 0, length));
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'b', 0, length));
+
+    // deferred writes are dropped, they are applied again from raft log
+    ASSERT_TRUE(dataStore_->Initialize());
+    ASSERT_EQ(std::string(length, 'a'), ReadChunk(id, sn, 0, length));
+    std::vector<ChunkID> merged;
+    dataStore_->TakeMergedChunks(&merged);
+    ASSERT_TRUE(merged.empty());
+}
+
+TEST_F(DeferredWriteTestSuit, ReadLogFailTest) {
+    ChunkID id = 1;
+    SequenceNum sn = 1;
+    size_t length = kDeferredWriteMinSize;
+
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'a', 0, PAGE_SIZE));
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'b', 0, length));
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'c', length, length));
+
+    // the writes are kept if the data can't be read from the log
+    butil::IOBuf data = log_[lastIndex_];
+    log_.erase(lastIndex_);
+    std::string buf(2 * length, 0);
+    ASSERT_EQ(CSErrorCode::InternalError,
+              dataStore_->ReadChunk(id, sn, &buf[0], 0, 2 * length));
+    ASSERT_EQ(CSErrorCode::InternalError, dataStore_->FlushDeferredWrites());
+
+    log_[lastIndex_] = data;
+    ASSERT_EQ(std::string(length, 'b') + std::string(length, 'c'),
+              ReadChunk(id, sn, 0, 2 * length));
+}
+
+TEST_F(DeferredWriteTestSuit, MaxBytesTest) {
+    ChunkID id = 1;
+    SequenceNum sn = 1;
+    size_t length = kDeferredWriteMinSize;
+
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'a', 0, PAGE_SIZE));
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'b', i * length, length));
+    }
+    ASSERT_NE(std::string(length, 'b'), ReadFile(id, 63 * length, length));
+    // exceed the limit and merge all
+    ASSERT_EQ(CSErrorCode::Success, Write(id, sn, 'c', 64 * length, length));
+    ASSERT_EQ(std::string(length, 'b'), ReadFile(id, 0, length));
+    ASSERT_EQ(std::string(length, 'c'), ReadFile(id, 64 * length, length));
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -934,6 +934,128 @@ TEST_F(TestHeartbeatManager, test_patrol_copySetInfo_return_order) {
     ASSERT_EQ(TRANSFER_LEADER, response.needupdatecopysets(0).type());
     ASSERT_EQ(3, response.needupdatecopysets(0).peers_size());
 }
+
+TEST_F(TestHeartbeatManager, test_incremental_heartbeat) {
+    auto request = GetChunkServerHeartbeatRequestForTest();
+    request.set_copysetcount(1);
+    ChunkServerHeartbeatResponse response;
+    ::curve::mds::topology::ChunkServer chunkServer1(
+        1, "hello", "", 1, "192.168.10.1", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    ::curve::mds::topology::ChunkServer chunkServer2(
+        2, "hello", "", 1, "192.168.10.2", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    ::curve::mds::topology::ChunkServer chunkServer3(
+        3, "hello", "", 1, "192.168.10.3", 9000, "",
+        ::curve::mds::topology::ChunkServerStatus::READWRITE);
+    ::curve::mds::topology::CopySetInfo copySetInfo;
+    copySetInfo.SetEpoch(10);
+    copySetInfo.SetLeader(1);
+
+    // 1. incremental heartbeat before the full one is not accepted
+    request.set_incremental(true);
+    request.clear_copysetinfos();
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_FALSE(response.acceptincremental());
+
+    // 2. full heartbeat with all copysets is accepted
+    request = GetChunkServerHeartbeatRequestForTest();
+    request.set_copysetcount(1);
+    response.Clear();
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer1), Return(true)))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer2), Return(true)))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer3), Return(true)));
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillOnce(Return(false));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_TRUE(response.acceptincremental());
+    ASSERT_EQ(HeartbeatStatusCode::hbOK, response.statuscode());
+
+    // 3. incremental heartbeat without changed copysets, the copyset
+    //    reported before is skipped
+    request.set_incremental(true);
+    request.clear_copysetinfos();
+    response.Clear();
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired(_, _, _))
+        .Times(0);
+    EXPECT_CALL(*coordinator_, CopySetHasOperator(_))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .Times(0);
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .Times(0);
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_TRUE(response.acceptincremental());
+    ASSERT_EQ(HeartbeatStatusCode::hbOK, response.statuscode());
+
+    // 4. the unchanged copyset with operator is dispatched again, but not
+    //    converted again
+    response.Clear();
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired(_, _, _))
+        .Times(0);
+    EXPECT_CALL(*coordinator_, CopySetHasOperator(_))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillOnce(Return(false));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_TRUE(response.acceptincremental());
+    ASSERT_EQ(HeartbeatStatusCode::hbOK, response.statuscode());
+
+    // 5. incremental heartbeat with unknown copyset is not accepted, only
+    //    the copyset in the heartbeat is dealt with
+    auto info = request.add_copysetinfos();
+    *info = GetChunkServerHeartbeatRequestForTest().copysetinfos(0);
+    info->set_copysetid(2);
+    response.Clear();
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired(_, _, _))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer1), Return(true)))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer2), Return(true)))
+        .WillOnce(DoAll(SetArgPointee<2>(chunkServer3), Return(true)));
+    EXPECT_CALL(*coordinator_, CopySetHasOperator(_))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<1>(copySetInfo), Return(true)));
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .WillOnce(Return(false));
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_FALSE(response.acceptincremental());
+
+    // 6. full heartbeat with copyset failed to analyse is not accepted,
+    //    so the copyset is reported again by the next full heartbeat
+    request = GetChunkServerHeartbeatRequestForTest();
+    request.set_copysetcount(1);
+    response.Clear();
+    EXPECT_CALL(*topology_, GetChunkServer(1, _))
+        .WillOnce(DoAll(SetArgPointee<1>(chunkServer1), Return(true)));
+    EXPECT_CALL(*topology_, GetChunkServerNotRetired(_, _, _))
+        .WillOnce(Return(false));
+    EXPECT_CALL(*topology_, GetCopySet(_, _))
+        .Times(0);
+    EXPECT_CALL(*coordinator_, CopySetHeartbeat(_, _, _))
+        .Times(0);
+    heartbeatManager_->ChunkServerHeartbeat(request, &response);
+    ASSERT_EQ(HeartbeatStatusCode::hbAnalyseCopysetError,
+              response.statuscode());
+    ASSERT_FALSE(response.acceptincremental());
+}
 }  // namespace heartbeat
 }  // namespace mds
 }  // namespace curve
@@ -260,6 +260,9 @@ class MockTopology : public Topology {
 
     MOCK_METHOD1(GetHostNameAndPortById,
         std::string(ChunkServerIdType csId));
+
+    MOCK_CONST_METHOD0(GetSnapshot,
+        std::shared_ptr<const TopologySnapshot>());
 };
 
 class MockTopologyStat : public TopologyStat {
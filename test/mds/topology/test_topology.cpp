@@ -24,6 +24,7 @@
 
 #include "test/mds/topology/mock_topology.h"
 #include "src/mds/topology/topology.h"
+#include "src/mds/topology/topology_snapshot.h"
 #include "src/mds/topology/topology_item.h"
 #include "src/common/configuration.h"
 
@@ -2787,6 +2788,77 @@ TEST_F(TestTopology, GetCopySetsInChunkServer_success) {
     ASSERT_EQ(1, csList.size());
 }
 
+TEST_F(TestTopology, PublishSnapshot_success) {
+    PoolIdType logicalPoolId = 0x01;
+    PoolIdType physicalPoolId = 0x11;
+    CopySetIdType copysetId = 0x51;
+
+    // snapshot is not published before Run()
+    ASSERT_EQ(nullptr, topology_->GetSnapshot());
+
+    PrepareAddPhysicalPool(physicalPoolId);
+    PrepareAddZone(0x21, "zone1", physicalPoolId);
+    PrepareAddServer(
+        0x31, "server1", "127.0.0.1" , 0, "127.0.0.1" , 0, 0x21, 0x11);
+    PrepareAddChunkServer(0x41, "token1", "nvme", 0x31, "127.0.0.1", 8200);
+    PrepareAddChunkServer(0x42, "token2", "nvme", 0x31, "127.0.0.1", 8201);
+    PrepareAddLogicalPool(logicalPoolId, "logicalPool1", physicalPoolId);
+    std::set<ChunkServerIdType> replicas;
+    replicas.insert(0x41);
+    replicas.insert(0x42);
+    PrepareAddCopySet(copysetId, logicalPoolId, replicas);
+
+    topology_->PublishSnapshot();
+    auto snapshot = topology_->GetSnapshot();
+    ASSERT_NE(nullptr, snapshot);
+
+    ChunkServer cs;
+    ASSERT_TRUE(snapshot->GetChunkServer(0x41, &cs));
+    ASSERT_EQ("token1", cs.GetToken());
+    ASSERT_FALSE(snapshot->GetChunkServer(0x43, &cs));
+    ASSERT_EQ(2, snapshot->GetChunkServerInCluster().size());
+    ASSERT_EQ(2, snapshot->GetChunkServerInLogicalPool(logicalPoolId).size());
+    ASSERT_EQ(1, snapshot->GetCopySetsInCluster().size());
+    ASSERT_EQ(1, snapshot->GetCopySetsInLogicalPool(logicalPoolId).size());
+    ASSERT_EQ(1, snapshot->GetCopySetsInChunkServer(0x42).size());
+    ASSERT_EQ(0, snapshot->GetCopySetsInChunkServer(0x43).size());
+
+    // the published snapshot is not affected by later updates
+    uint64_t version = snapshot->GetVersion();
+    PrepareAddChunkServer(0x43, "token3", "nvme", 0x31, "127.0.0.1", 8202);
+    ASSERT_FALSE(snapshot->GetChunkServer(0x43, &cs));
+    ASSERT_EQ(snapshot, topology_->GetSnapshot());
+
+    topology_->PublishSnapshot();
+    auto newSnapshot = topology_->GetSnapshot();
+    ASSERT_LT(version, newSnapshot->GetVersion());
+    ASSERT_TRUE(newSnapshot->GetChunkServer(0x43, &cs));
+
+    // the copysets are shared if only the chunkservers are updated
+    ChunkServerState csState;
+    csState.SetDiskCapacity(100);
+    ASSERT_EQ(kTopoErrCodeSuccess,
+              topology_->UpdateChunkServerDiskStatus(csState, 0x41));
+    topology_->PublishSnapshot();
+    snapshot = topology_->GetSnapshot();
+    ASSERT_TRUE(snapshot->GetChunkServer(0x41, &cs));
+    ASSERT_EQ(100, cs.GetChunkServerState().GetDiskCapacity());
+    ASSERT_EQ(newSnapshot->GetCopySets(), snapshot->GetCopySets());
+
+    // and copied again after the copysets are modified
+    CopySetInfo csInfo(logicalPoolId, copysetId);
+    csInfo.SetLeader(0x41);
+    csInfo.SetCopySetMembers(replicas);
+    ASSERT_EQ(kTopoErrCodeSuccess, topology_->UpdateCopySetTopo(csInfo));
+    topology_->PublishSnapshot();
+    newSnapshot = topology_->GetSnapshot();
+    ASSERT_NE(snapshot->GetCopySets(), newSnapshot->GetCopySets());
+    CopySetInfo info;
+    ASSERT_TRUE(newSnapshot->GetCopySet(
+        CopySetKey(logicalPoolId, copysetId), &info));
+    ASSERT_EQ(0x41, info.GetLeader());
+}
+
 }  // namespace topology
 }  // namespace mds
 }  // namespace curve